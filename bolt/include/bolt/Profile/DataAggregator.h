@@ -128,6 +128,17 @@ private:
     uint64_t MispredCount{0};
   };
 
+  /// Traces and branches aggregated from a share of the LBR samples. Shares
+  /// of a batch of samples are aggregated concurrently, and the shards are
+  /// merged into BranchLBRs and FallthroughLBRs once all samples are parsed.
+  struct LBRShard {
+    std::unordered_map<Trace, TakenBranchInfo, TraceHash> BranchLBRs;
+    std::unordered_map<Trace, FTInfo, TraceHash> FallthroughLBRs;
+    uint64_t NumTraces{0};
+    uint64_t NumInvalidTraces{0};
+    uint64_t NumLongRangeTraces{0};
+  };
+
   /// Intermediate storage for profile data. We save the results of parsing
   /// and use them later for processing and assigning profile.
   std::unordered_map<Trace, TakenBranchInfo, TraceHash> BranchLBRs;
@@ -321,8 +332,15 @@ private:
   /// Parse a single LBR entry as output by perf script -Fbrstack
   ErrorOr<LBREntry> parseLBREntry();
 
-  /// Parse LBR sample, returns the number of traces.
-  uint64_t parseLBRSample(const PerfBranchSample &Sample, bool NeedsSkylakeFix);
+  /// Aggregate the traces and branches of an LBR sample into \p Shard. Only
+  /// reads the aggregator state, so that samples can be aggregated into
+  /// different shards concurrently.
+  void parseLBRSample(const PerfBranchSample &Sample, bool NeedsSkylakeFix,
+                      LBRShard &Shard) const;
+
+  /// Merge the traces, branches and statistics of \p Shard into the
+  /// aggregator.
+  void mergeLBRShard(LBRShard &Shard);
 
   /// Parse and pre-aggregate branch events.
   std::error_code parseBranchEvents();
@@ -11,8 +11,10 @@
 //===----------------------------------------------------------------------===//
 
 #include "bolt/Passes/ReorderFunctions.h"
+#include "bolt/Core/ParallelUtilities.h"
 #include "bolt/Passes/HFSort.h"
 #include "bolt/Utils/Utils.h"
+#include "llvm/ADT/IntEqClasses.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Transforms/Utils/CodeLayout.h"
@@ -99,6 +101,12 @@ static cl::opt<bool> CgIgnoreRecursiveCalls(
     cl::desc("ignore recursive calls when constructing the call graph"),
     cl::init(true), cl::cat(BoltOptCategory));
 
+static cl::opt<bool> CDSortParallel(
+    "cdsort-parallel",
+    cl::desc("with -reorder-functions=cdsort, sort the connected components of "
+             "the call graph in parallel and order them by density"),
+    cl::init(false), cl::cat(BoltOptCategory));
+
 static cl::opt<bool> CgUseSplitHotSize(
     "cg-use-split-hot-size",
     cl::desc("use hot/cold data on basic blocks to determine hot sizes for "
@@ -114,6 +122,68 @@ using NodeId = CallGraph::NodeId;
 using Arc = CallGraph::Arc;
 using Node = CallGraph::Node;
 
+/// Run cache-directed sort separately on each weakly connected component of
+/// the call graph and return one cluster per component, in the decreasing
+/// order of density. The sort only merges chains of functions along calls, so
+/// the functions of a component are laid out as in a single run over the whole
+/// graph; only chains of different components are no longer interleaved.
+static std::vector<Cluster> cdSortComponents(const CallGraph &Cg) {
+  IntEqClasses Components(Cg.numNodes());
+  for (NodeId F = 0; F < Cg.numNodes(); ++F)
+    for (NodeId Succ : Cg.successors(F))
+      Components.join(F, Succ);
+  Components.compress();
+
+  // Number the functions of each component in the order of their ids, so that
+  // the sort breaks ties the same way as it does for the whole graph.
+  std::vector<std::vector<NodeId>> ComponentNodes(Components.getNumClasses());
+  std::vector<uint64_t> LocalIds(Cg.numNodes());
+  for (NodeId F = 0; F < Cg.numNodes(); ++F) {
+    std::vector<NodeId> &Nodes = ComponentNodes[Components[F]];
+    LocalIds[F] = Nodes.size();
+    Nodes.push_back(F);
+  }
+
+  auto sortComponent = [&](std::vector<NodeId> &Nodes) {
+    std::vector<uint64_t> FuncSizes;
+    std::vector<uint64_t> FuncCounts;
+    std::vector<codelayout::EdgeCount> CallCounts;
+    std::vector<uint64_t> CallOffsets;
+    for (NodeId F : Nodes) {
+      FuncSizes.push_back(Cg.size(F));
+      FuncCounts.push_back(Cg.samples(F));
+      for (NodeId Succ : Cg.successors(F)) {
+        const Arc &Arc = *Cg.findArc(F, Succ);
+        CallCounts.push_back(
+            {LocalIds[F], LocalIds[Succ], uint64_t(Arc.weight())});
+        CallOffsets.push_back(uint64_t(Arc.avgCallOffset()));
+      }
+    }
+
+    std::vector<uint64_t> Result = codelayout::computeCacheDirectedLayout(
+        FuncSizes, FuncCounts, CallCounts, CallOffsets);
+    std::vector<NodeId> Order;
+    Order.reserve(Result.size());
+    for (uint64_t LocalId : Result)
+      Order.push_back(Nodes[LocalId]);
+    Nodes = std::move(Order);
+  };
+
+  // Functions without calls are left alone.
+  ThreadPoolInterface &Pool = ParallelUtilities::getThreadPool();
+  for (std::vector<NodeId> &Nodes : ComponentNodes)
+    if (Nodes.size() > 1)
+      Pool.async(sortComponent, std::ref(Nodes));
+  Pool.wait();
+
+  std::vector<Cluster> Clusters;
+  Clusters.reserve(ComponentNodes.size());
+  for (const std::vector<NodeId> &Nodes : ComponentNodes)
+    Clusters.emplace_back(Nodes, Cg);
+  llvm::stable_sort(Clusters, compareClustersDensity);
+  return Clusters;
+}
+
 void ReorderFunctions::reorder(BinaryContext &BC,
                                std::vector<Cluster> &&Clusters,
                                std::map<uint64_t, BinaryFunction> &BFs) {
@@ -337,6 +407,11 @@ Error ReorderFunctions::runOnFunctions(BinaryContext &BC) {
     // obeys the property before running the algorithm.
     Cg.adjustArcWeights();
 
+    if (opts::CDSortParallel) {
+      Clusters = cdSortComponents(Cg);
+      break;
+    }
+
     // Initialize CFG nodes and their data
     std::vector<uint64_t> FuncSizes;
     std::vector<uint64_t> FuncCounts;
@@ -14,6 +14,7 @@
 #include "bolt/Profile/DataAggregator.h"
 #include "bolt/Core/BinaryContext.h"
 #include "bolt/Core/BinaryFunction.h"
+#include "bolt/Core/ParallelUtilities.h"
 #include "bolt/Passes/BinaryPasses.h"
 #include "bolt/Profile/BoltAddressTranslation.h"
 #include "bolt/Profile/Heatmap.h"
@@ -27,6 +28,7 @@
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MathExtras.h"
 #include "llvm/Support/Process.h"
 #include "llvm/Support/Program.h"
 #include "llvm/Support/Regex.h"
@@ -1404,9 +1406,9 @@ std::error_code DataAggregator::printLBRHeatMap() {
   return std::error_code();
 }
 
-uint64_t DataAggregator::parseLBRSample(const PerfBranchSample &Sample,
-                                        bool NeedsSkylakeFix) {
-  uint64_t NumTraces{0};
+void DataAggregator::parseLBRSample(const PerfBranchSample &Sample,
+                                    bool NeedsSkylakeFix,
+                                    LBRShard &Shard) const {
   // LBRs are stored in reverse execution order. NextPC refers to the next
   // recorded executed PC.
   uint64_t NextPC = opts::UseEventPC ? Sample.PC : 0;
@@ -1428,7 +1430,7 @@ uint64_t DataAggregator::parseLBRSample(const PerfBranchSample &Sample,
       const BinaryFunction *TraceBF =
           getBinaryFunctionContainingAddress(TraceFrom);
       if (TraceBF && TraceBF->containsAddress(TraceTo)) {
-        FTInfo &Info = FallthroughLBRs[Trace(TraceFrom, TraceTo)];
+        FTInfo &Info = Shard.FallthroughLBRs[Trace(TraceFrom, TraceTo)];
         if (TraceBF->containsAddress(LBR.From))
           ++Info.InternCount;
         else
@@ -1442,7 +1444,7 @@ uint64_t DataAggregator::parseLBRSample(const PerfBranchSample &Sample,
                    << formatv(" @ {0:x}", TraceFrom - TraceBF->getAddress())
                    << formatv(" and ending @ {0:x}\n", TraceTo);
           });
-          ++NumInvalidTraces;
+          ++Shard.NumInvalidTraces;
         } else {
           LLVM_DEBUG({
             dbgs() << "Out of range trace starting in "
@@ -1454,10 +1456,10 @@ uint64_t DataAggregator::parseLBRSample(const PerfBranchSample &Sample,
                    << formatv(" @ {0:x}\n",
                               TraceTo - (ToFunc ? ToFunc->getAddress() : 0));
           });
-          ++NumLongRangeTraces;
+          ++Shard.NumLongRangeTraces;
         }
       }
-      ++NumTraces;
+      ++Shard.NumTraces;
     }
     NextPC = LBR.From;
 
@@ -1465,11 +1467,32 @@ uint64_t DataAggregator::parseLBRSample(const PerfBranchSample &Sample,
     uint64_t To = getBinaryFunctionContainingAddress(LBR.To) ? LBR.To : 0;
     if (!From && !To)
       continue;
-    TakenBranchInfo &Info = BranchLBRs[Trace(From, To)];
+    TakenBranchInfo &Info = Shard.BranchLBRs[Trace(From, To)];
     ++Info.TakenCount;
     Info.MispredCount += LBR.Mispred;
   }
-  return NumTraces;
+}
+
+void DataAggregator::mergeLBRShard(LBRShard &Shard) {
+  if (BranchLBRs.empty() && FallthroughLBRs.empty()) {
+    BranchLBRs = std::move(Shard.BranchLBRs);
+    FallthroughLBRs = std::move(Shard.FallthroughLBRs);
+  } else {
+    for (const auto &[Trace, Info] : Shard.BranchLBRs) {
+      TakenBranchInfo &Merged = BranchLBRs[Trace];
+      Merged.TakenCount += Info.TakenCount;
+      Merged.MispredCount += Info.MispredCount;
+    }
+    for (const auto &[Trace, Info] : Shard.FallthroughLBRs) {
+      FTInfo &Merged = FallthroughLBRs[Trace];
+      Merged.InternCount += Info.InternCount;
+      Merged.ExternCount += Info.ExternCount;
+    }
+  }
+  NumInvalidTraces += Shard.NumInvalidTraces;
+  NumLongRangeTraces += Shard.NumLongRangeTraces;
+  clear(Shard.BranchLBRs);
+  clear(Shard.FallthroughLBRs);
 }
 
 std::error_code DataAggregator::parseBranchEvents() {
@@ -1484,6 +1507,43 @@ std::error_code DataAggregator::parseBranchEvents() {
   uint64_t NumTraces = 0;
   bool NeedsSkylakeFix = false;
 
+  // Parsing is sequential, but aggregating a sample's traces is dominated by
+  // function lookups that only read the BinaryContext. Samples are parsed in
+  // batches, and each batch is aggregated by the thread pool into one shard
+  // per thread while the next batch is parsed.
+  using BranchSampleBatch = std::vector<std::pair<PerfBranchSample, bool>>;
+  constexpr size_t SamplesPerBatch = 16 * 1024;
+  const unsigned NumShards = opts::NoThreads ? 1 : opts::ThreadCount;
+  std::vector<LBRShard> Shards(std::max(NumShards, 1u));
+  BranchSampleBatch Parsed, Aggregating;
+  Parsed.reserve(SamplesPerBatch);
+  // With -no-threads, each batch is aggregated on this thread instead.
+  std::optional<ThreadPoolTaskGroup> Group;
+  if (!opts::NoThreads)
+    Group.emplace(ParallelUtilities::getThreadPool());
+  auto waitForBatch = [&] {
+    if (Group)
+      Group->wait();
+  };
+
+  auto aggregateBatch = [&](const BranchSampleBatch &Batch) {
+    const size_t ShardSize = divideCeil(Batch.size(), Shards.size());
+    for (size_t I = 0, E = Shards.size(); I != E; ++I) {
+      const size_t Begin = std::min(I * ShardSize, Batch.size());
+      const size_t End = std::min(Begin + ShardSize, Batch.size());
+      if (Begin == End)
+        break;
+      auto aggregateShard = [&, I, Begin, End] {
+        for (size_t J = Begin; J != End; ++J)
+          parseLBRSample(Batch[J].first, Batch[J].second, Shards[I]);
+      };
+      if (Group)
+        Group->async(aggregateShard);
+      else
+        aggregateShard();
+    }
+  };
+
   while (hasData() && NumTotalSamples < opts::MaxSamples) {
     ++NumTotalSamples;
 
@@ -1510,7 +1570,21 @@ std::error_code DataAggregator::parseBranchEvents() {
       NeedsSkylakeFix = true;
     }
 
-    NumTraces += parseLBRSample(Sample, NeedsSkylakeFix);
+    Parsed.emplace_back(std::move(Sample), NeedsSkylakeFix);
+    if (Parsed.size() == SamplesPerBatch) {
+      waitForBatch();
+      std::swap(Parsed, Aggregating);
+      Parsed.clear();
+      aggregateBatch(Aggregating);
+    }
+  }
+  waitForBatch();
+  aggregateBatch(Parsed);
+  waitForBatch();
+
+  for (LBRShard &Shard : Shards) {
+    NumTraces += Shard.NumTraces;
+    mergeLBRShard(Shard);
   }
 
   for (const Trace &Trace : llvm::make_first_range(BranchLBRs))
@@ -9,10 +9,12 @@
 #include "bolt/Profile/YAMLProfileReader.h"
 #include "bolt/Core/BinaryBasicBlock.h"
 #include "bolt/Core/BinaryFunction.h"
+#include "bolt/Core/ParallelUtilities.h"
 #include "bolt/Passes/MCF.h"
 #include "bolt/Profile/ProfileYAMLMapping.h"
 #include "bolt/Utils/NameResolver.h"
 #include "bolt/Utils/Utils.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/edit_distance.h"
 #include "llvm/Demangle/Demangle.h"
@@ -709,17 +711,24 @@ Error YAMLProfileReader::readProfile(BinaryContext &BC) {
   }
   YamlProfileToFunction.resize(YamlBP.Functions.size() + 1);
 
-  // Computes hash for binary functions.
-  if (opts::MatchProfileWithFunctionHash) {
-    for (auto &[_, BF] : BC.getBinaryFunctions()) {
+  // Computes hash for binary functions. Hashing only reads the function and
+  // the binary context, so functions are hashed in parallel.
+  if (opts::MatchProfileWithFunctionHash || !opts::IgnoreHash) {
+    DenseSet<const BinaryFunction *> HashedBFs;
+    if (!opts::MatchProfileWithFunctionHash)
+      for (const BinaryFunction *BF : ProfileBFs)
+        if (BF)
+          HashedBFs.insert(BF);
+
+    ParallelUtilities::WorkFuncTy WorkFun = [&](BinaryFunction &BF) {
       BF.computeHash(YamlBP.Header.IsDFSOrder, YamlBP.Header.HashFunction);
-    }
-  } else if (!opts::IgnoreHash) {
-    for (BinaryFunction *BF : ProfileBFs) {
-      if (!BF)
-        continue;
-      BF->computeHash(YamlBP.Header.IsDFSOrder, YamlBP.Header.HashFunction);
-    }
+    };
+    ParallelUtilities::PredicateTy SkipFunc = [&](const BinaryFunction &BF) {
+      return !opts::MatchProfileWithFunctionHash && !HashedBFs.contains(&BF);
+    };
+    ParallelUtilities::runOnEachFunction(
+        BC, ParallelUtilities::SchedulingPolicy::SP_BB_LINEAR, WorkFun,
+        SkipFunc, "computeHash");
   }
 
   // Map profiled function ids to names.
@@ -770,6 +770,12 @@ void DWARFRewriter::updateDebugInfo() {
       processMainBinaryCU(*CU, DIEBlder);
     finalizeCompileUnits(DIEBlder, *Streamer, OffsetMap,
                          DIEBlder.getProcessedCUs(), *FinalAddrWriter);
+    // The input DIEs of the batch have been cloned and emitted. Release them
+    // so that only one batch of CUs is expanded in memory at a time. A later
+    // reference into one of these CUs extracts its DIEs again.
+    for (DWARFUnit *CU : DIEBlder.getProcessedCUs())
+      if (!CU->isTypeUnit())
+        CU->clearDIEs(/*KeepCUDie=*/true);
   }
 
   DebugNamesTable.emitAccelTable();
@@ -38,10 +38,12 @@ import argparse
 import asyncio
 from dataclasses import dataclass
 import glob
+import hashlib
 import json
 import multiprocessing
 import os
 import re
+import shlex
 import shutil
 import subprocess
 import sys
@@ -49,7 +51,7 @@ import tempfile
 import time
 import traceback
 from types import ModuleType
-from typing import Any, Awaitable, Callable, List, Optional, TypeVar
+from typing import Any, Awaitable, Callable, Dict, List, Optional, TypeVar
 
 
 yaml: Optional[ModuleType] = None
@@ -231,6 +233,136 @@ class ClangTidyResult:
     stdout: str
     stderr: str
     elapsed: float
+    cached: bool = False
+
+
+# Arguments that make the compiler write files, which we don't want while
+# listing the dependencies of a compile command. The ones in the first list
+# take a value, either attached or as the next argument.
+OUTPUT_ARGS_WITH_VALUE = ["-o", "-MF", "-MT", "-MQ"]
+OUTPUT_ARGS = ["-M", "-MM", "-MD", "-MMD", "-MP", "-MG"]
+
+
+def get_dependency_invocation(
+    entry: Dict[str, Any], extra_arg: List[str], extra_arg_before: List[str]
+) -> List[str]:
+    """Gets a command line that prints the dependencies of a compile command
+    in Makefile format."""
+    if "arguments" in entry:
+        command = list(entry["arguments"])
+    else:
+        command = shlex.split(entry["command"])
+    invocation = command[:1] + extra_arg_before
+    skip_next = False
+    for arg in command[1:]:
+        if skip_next:
+            skip_next = False
+        elif arg in OUTPUT_ARGS_WITH_VALUE:
+            skip_next = True
+        elif arg not in OUTPUT_ARGS and not any(
+            arg.startswith(a) for a in OUTPUT_ARGS_WITH_VALUE
+        ):
+            invocation.append(arg)
+    return invocation + extra_arg + ["-M", "-w"]
+
+
+def parse_dependencies(output: str) -> List[str]:
+    """Returns the prerequisites from the output of the compiler's -M flag."""
+    output = output.replace("\\\n", " ")
+    # Skip the target, which ends in an unescaped colon followed by a space.
+    match = re.search(r"(?<!\\):\s", output)
+    if match:
+        output = output[match.end() :]
+    deps = []
+    for dep in re.split(r"(?<!\\)\s+", output.strip()):
+        if dep:
+            deps.append(dep.replace("\\ ", " ").replace("$$", "$"))
+    return deps
+
+
+def hash_file(h: Any, path: str) -> None:
+    h.update(path.encode("utf-8") + b"\0")
+    with open(path, "rb") as f:
+        h.update(hashlib.sha256(f.read()).digest())
+
+
+async def get_cache_key(
+    args: argparse.Namespace,
+    name: str,
+    entries: List[Dict[str, Any]],
+    clang_tidy_binary: str,
+    build_path: str,
+    export_fixes: bool,
+) -> Optional[str]:
+    """
+    Computes a hash of everything the result of clang-tidy on a file depends
+    on: the clang-tidy binary, plugins and options, whether fixes are
+    exported, the configuration files, and the contents of all files included
+    by the file's compile commands.
+    Returns None if the dependencies cannot be determined.
+    """
+    invocation = get_tidy_invocation(
+        name,
+        clang_tidy_binary,
+        args.checks,
+        None,
+        build_path,
+        args.header_filter,
+        args.allow_enabling_alpha_checkers,
+        args.extra_arg,
+        args.extra_arg_before,
+        args.quiet,
+        args.config_file,
+        args.config,
+        args.line_filter,
+        args.use_color,
+        args.plugins,
+        args.warnings_as_errors,
+        args.exclude_header_filter,
+        args.allow_no_checks,
+    )
+    h = hashlib.sha256()
+    h.update(json.dumps(invocation).encode("utf-8"))
+    # Results of runs without -fix or -export-fixes have no fixes to replay.
+    h.update(b"export-fixes\0" if export_fixes else b"no-fixes\0")
+    try:
+        binaries = [shutil.which(clang_tidy_binary) or clang_tidy_binary]
+        for binary in binaries + args.plugins:
+            st = os.stat(binary)
+            h.update(f"{binary}:{st.st_size}:{st.st_mtime_ns}\0".encode("utf-8"))
+        if args.config_file:
+            hash_file(h, args.config_file)
+        elif args.config is None:
+            # clang-tidy uses the closest configuration file, and the ones it
+            # inherits from, so hash all of them.
+            directory = os.path.dirname(name)
+            while True:
+                for config in [".clang-tidy", "_clang-tidy"]:
+                    path = os.path.join(directory, config)
+                    if os.path.isfile(path):
+                        hash_file(h, path)
+                parent = os.path.dirname(directory)
+                if parent == directory:
+                    break
+                directory = parent
+        for entry in entries:
+            h.update(json.dumps(entry, sort_keys=True).encode("utf-8"))
+            process = await asyncio.create_subprocess_exec(
+                *get_dependency_invocation(
+                    entry, args.extra_arg, args.extra_arg_before
+                ),
+                cwd=entry["directory"],
+                stdout=subprocess.PIPE,
+                stderr=subprocess.DEVNULL,
+            )
+            stdout, _ = await process.communicate()
+            if process.returncode != 0:
+                return None
+            for dep in parse_dependencies(stdout.decode("UTF-8")):
+                hash_file(h, os.path.join(entry["directory"], dep))
+    except OSError:
+        return None
+    return h.hexdigest()
 
 
 async def run_tidy(
@@ -239,10 +371,41 @@ async def run_tidy(
     clang_tidy_binary: str,
     tmpdir: str,
     build_path: str,
+    entries: List[Dict[str, Any]],
 ) -> ClangTidyResult:
     """
     Runs clang-tidy on a single file and returns the result.
+    With -cache-dir, returns the result of an earlier run if nothing it depends
+    on has changed since.
     """
+    cache_path = None
+    if args.cache_dir:
+        key = await get_cache_key(
+            args, name, entries, clang_tidy_binary, build_path, tmpdir is not None
+        )
+        if key:
+            cache_path = os.path.join(args.cache_dir, key + ".json")
+        cached = None
+        if cache_path and os.path.isfile(cache_path):
+            with open(cache_path) as f:
+                cached = json.load(f)
+        # An entry without fixes cannot serve a run that needs them.
+        if cached and (tmpdir is None or cached["fixes"] is not None):
+            invocation = cached["invocation"]
+            if tmpdir is not None and cached["fixes"]:
+                (handle, fixes_file) = tempfile.mkstemp(suffix=".yaml", dir=tmpdir)
+                with os.fdopen(handle, "w") as f:
+                    f.write(cached["fixes"])
+            return ClangTidyResult(
+                name,
+                invocation,
+                cached["returncode"],
+                cached["stdout"],
+                cached["stderr"],
+                0.0,
+                cached=True,
+            )
+
     invocation = get_tidy_invocation(
         name,
         clang_tidy_binary,
@@ -277,7 +440,7 @@ async def run_tidy(
         raise
 
     assert process.returncode is not None
-    return ClangTidyResult(
+    result = ClangTidyResult(
         name,
         invocation,
         process.returncode,
@@ -285,6 +448,28 @@ async def run_tidy(
         stderr.decode("UTF-8"),
         end - start,
     )
+    # Results of crashed or interrupted runs are not reproducible.
+    if cache_path and process.returncode >= 0:
+        fixes = None
+        if tmpdir is not None:
+            with open(invocation[invocation.index("-export-fixes") + 1]) as f:
+                fixes = f.read()
+        # Write to a temporary file first, so that concurrent runs never read
+        # a partial result.
+        (handle, tmp_cache_path) = tempfile.mkstemp(dir=args.cache_dir)
+        with os.fdopen(handle, "w") as f:
+            json.dump(
+                {
+                    "invocation": invocation,
+                    "returncode": result.returncode,
+                    "stdout": result.stdout,
+                    "stderr": result.stderr,
+                    "fixes": fixes,
+                },
+                f,
+            )
+        os.replace(tmp_cache_path, cache_path)
+    return result
 
 
 async def main() -> None:
@@ -446,6 +631,16 @@ async def main() -> None:
         action="store_true",
         help="Allow empty enabled checks.",
     )
+    parser.add_argument(
+        "-cache-dir",
+        metavar="directory",
+        default=None,
+        help="A directory to cache the results of clang-tidy in. Files whose "
+        "compile commands, included files, configuration and clang-tidy "
+        "options did not change since an earlier run with the same directory "
+        "are not analyzed again. Listing the included files runs the compiler "
+        "from the compilation database with -M.",
+    )
     args = parser.parse_args()
 
     db_path = "compile_commands.json"
@@ -519,10 +714,18 @@ async def main() -> None:
         print("Unable to run clang-tidy.", file=sys.stderr)
         sys.exit(1)
 
+    if args.cache_dir:
+        os.makedirs(args.cache_dir, exist_ok=True)
+
     # Load the database and extract all files.
     with open(os.path.join(build_path, db_path)) as f:
         database = json.load(f)
-    files = {os.path.abspath(os.path.join(e["directory"], e["file"])) for e in database}
+    entries: Dict[str, List[Dict[str, Any]]] = {}
+    for e in database:
+        entries.setdefault(
+            os.path.abspath(os.path.join(e["directory"], e["file"])), []
+        ).append(e)
+    files = set(entries)
     number_files_in_database = len(files)
 
     # Filter source files from compilation database.
@@ -566,6 +769,7 @@ async def main() -> None:
                 clang_tidy_binary,
                 export_fixes_dir,
                 build_path,
+                entries[f],
             )
         )
         for f in files
@@ -579,7 +783,7 @@ async def main() -> None:
                 if result.returncode < 0:
                     result.stderr += f"{result.filename}: terminated by signal {-result.returncode}\n"
             progress = f"[{i + 1: >{len(f'{len(files)}')}}/{len(files)}]"
-            runtime = f"[{result.elapsed:.1f}s]"
+            runtime = "[cached]" if result.cached else f"[{result.elapsed:.1f}s]"
             print(f"{progress}{runtime} {' '.join(result.invocation)}")
             if result.stdout:
                 print(result.stdout, end=("" if result.stderr else "\n"))
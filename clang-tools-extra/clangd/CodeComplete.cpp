@@ -1923,15 +1923,23 @@ private:
       C.SemaResult = SemaResult;
       C.IndexResult = IndexResult;
       C.IdentifierResult = IdentifierResult;
-      if (C.IndexResult) {
+      if (C.IndexResult)
         C.Name = IndexResult->Name;
-        C.RankedIncludeHeaders = getRankedIncludes(*C.IndexResult);
-      } else if (C.SemaResult) {
+      else if (C.SemaResult)
         C.Name = Recorder->getName(*SemaResult);
-      } else {
+      else {
         assert(IdentifierResult);
         C.Name = IdentifierResult->Name;
       }
+      // Drop candidates that addCandidate() would reject anyway before
+      // computing their headers, which can be expensive. Sema doesn't filter
+      // its results, so in large scopes most of them don't match. Bundles
+      // only group functions with the same name, so they're all kept or
+      // dropped together.
+      if (!fuzzyScore(C))
+        return;
+      if (C.IndexResult)
+        C.RankedIncludeHeaders = getRankedIncludes(*C.IndexResult);
       if (auto OverloadSet = C.overloadSet(
               Opts, FileName, Inserter ? &*Inserter : nullptr, CCContextKind)) {
         auto Ret = BundleLookup.try_emplace(OverloadSet, Bundles.size());
@@ -157,6 +157,7 @@ static llvm::StringRef filenameWithoutExtension(llvm::StringRef Path) {
 
 BackgroundQueue::Task BackgroundIndex::indexFileTask(std::string Path) {
   std::string Tag = filenameWithoutExtension(Path).str();
+  std::string Group = llvm::sys::path::parent_path(Path).str();
   uint64_t Key = llvm::xxh3_64bits(Path);
   BackgroundQueue::Task T([this, Path(std::move(Path))] {
     std::optional<WithContext> WithProvidedContext;
@@ -171,6 +172,7 @@ BackgroundQueue::Task BackgroundIndex::indexFileTask(std::string Path) {
   T.QueuePri = IndexFile;
   T.ThreadPri = IndexingPriority;
   T.Tag = std::move(Tag);
+  T.Group = std::move(Group);
   T.Key = Key;
   return T;
 }
@@ -178,6 +180,10 @@ BackgroundQueue::Task BackgroundIndex::indexFileTask(std::string Path) {
 void BackgroundIndex::boostRelated(llvm::StringRef Path) {
   if (isHeaderFile(Path))
     Queue.boost(filenameWithoutExtension(Path), IndexBoostedFile);
+  // Files next to the one being edited are likely to be edited or navigated
+  // to next, so index them before the rest of the project.
+  if (llvm::StringRef Dir = llvm::sys::path::parent_path(Path); !Dir.empty())
+    Queue.boostGroup(Dir, IndexNearbyFile);
 }
 
 /// Given index results from a TU, only update symbols coming from files that
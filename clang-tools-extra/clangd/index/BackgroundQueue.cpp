@@ -83,6 +83,8 @@ bool BackgroundQueue::adjust(Task &T) {
   if (T.Key && !SeenKeys.insert(T.Key).second)
     return false;
   T.QueuePri = std::max(T.QueuePri, Boosts.lookup(T.Tag));
+  if (!T.Group.empty())
+    T.QueuePri = std::max(T.QueuePri, GroupBoosts.lookup(T.Group));
   return true;
 }
 
@@ -133,6 +135,25 @@ void BackgroundQueue::boost(llvm::StringRef Tag, unsigned NewPriority) {
   // No need to signal, only rearranged items in the queue.
 }
 
+void BackgroundQueue::boostGroup(llvm::StringRef Group, unsigned NewPriority) {
+  assert(!Group.empty() && "tasks without a group can't be boosted");
+  std::lock_guard<std::mutex> Lock(Mu);
+  unsigned &Boost = GroupBoosts[Group];
+  bool Increase = NewPriority > Boost;
+  Boost = NewPriority;
+  if (!Increase)
+    return; // existing tasks unaffected
+
+  unsigned Changes = 0;
+  for (Task &T : Queue)
+    if (Group == T.Group && NewPriority > T.QueuePri) {
+      T.QueuePri = NewPriority;
+      ++Changes;
+    }
+  if (Changes)
+    std::make_heap(Queue.begin(), Queue.end());
+}
+
 bool BackgroundQueue::blockUntilIdleForTest(
     std::optional<double> TimeoutSeconds) {
   std::unique_lock<std::mutex> Lock(Mu);
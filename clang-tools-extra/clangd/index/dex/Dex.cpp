@@ -147,6 +147,8 @@ void Dex::buildIndex() {
   for (DocID SymbolRank = 0; SymbolRank < Symbols.size(); ++SymbolRank)
     Builder.add(*Symbols[SymbolRank], SymbolRank);
   InvertedIndex = std::move(Builder).build();
+
+  llvm::sort(Relations);
 }
 
 std::unique_ptr<Iterator> Dex::iterator(const Token &Tok) const {
@@ -321,15 +323,15 @@ void Dex::relations(
   uint32_t Remaining = Req.Limit.value_or(std::numeric_limits<uint32_t>::max());
   for (const SymbolID &Subject : Req.Subjects) {
     LookupRequest LookupReq;
-    auto It = Relations.find(
-        std::make_pair(Subject, static_cast<uint8_t>(Req.Predicate)));
-    if (It != Relations.end()) {
-      for (const auto &Object : It->second) {
-        if (Remaining > 0) {
-          --Remaining;
-          LookupReq.IDs.insert(Object);
-        }
-      }
+    auto It = llvm::partition_point(Relations, [&](const Relation &R) {
+      return std::tie(R.Subject, R.Predicate) <
+             std::tie(Subject, Req.Predicate);
+    });
+    for (; It != Relations.end() && It->Subject == Subject &&
+           It->Predicate == Req.Predicate && Remaining > 0;
+         ++It) {
+      --Remaining;
+      LookupReq.IDs.insert(It->Object);
     }
     lookup(LookupReq, [&](const Symbol &Object) { Callback(Subject, Object); });
   }
@@ -350,7 +352,7 @@ size_t Dex::estimateMemoryUsage() const {
   for (const auto &TokenToPostingList : InvertedIndex)
     Bytes += TokenToPostingList.second.bytes();
   Bytes += Refs.getMemorySize();
-  Bytes += Relations.getMemorySize();
+  Bytes += Relations.capacity() * sizeof(Relation);
   return Bytes + BackingDataSize;
 }
 
@@ -42,10 +42,7 @@ public:
       this->Symbols.push_back(&Sym);
     for (auto &&Ref : Refs)
       this->Refs.try_emplace(Ref.first, Ref.second);
-    for (auto &&Rel : Relations)
-      this->Relations[std::make_pair(Rel.Subject,
-                                     static_cast<uint8_t>(Rel.Predicate))]
-          .push_back(Rel.Object);
+    llvm::append_range(this->Relations, Relations);
     buildIndex();
   }
   // Symbols and Refs are owned by BackingData, Index takes ownership.
@@ -116,9 +113,10 @@ private:
   llvm::DenseMap<Token, PostingList> InvertedIndex;
   dex::Corpus Corpus;
   llvm::DenseMap<SymbolID, llvm::ArrayRef<Ref>> Refs;
-  static_assert(sizeof(RelationKind) == sizeof(uint8_t),
-                "RelationKind should be of same size as a uint8_t");
-  llvm::DenseMap<std::pair<SymbolID, uint8_t>, std::vector<SymbolID>> Relations;
+  /// Sorted in SPO order, so the objects of a subject and predicate are
+  /// adjacent. Unlike a map to vectors of objects, this needs no allocation
+  /// per subject.
+  std::vector<Relation> Relations;
   std::shared_ptr<void> KeepAlive; // poor man's move-only std::any
   // Set of files which were used during this index build.
   llvm::StringSet<> Files;
@@ -22,6 +22,7 @@
 #include "support/ThreadsafeFS.h"
 #include "support/Trace.h"
 #include "llvm/ADT/IntrusiveRefCntPtr.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/Chrono.h"
 #include "llvm/Support/CommandLine.h"
@@ -32,14 +33,18 @@
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/VirtualFileSystem.h"
 
+#include <atomic>
 #include <chrono>
 #include <grpc++/grpc++.h>
 #include <grpc++/health_check_service_interface.h>
+#include <list>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <thread>
 #include <utility>
+#include <vector>
 
 #if ENABLE_GRPC_REFLECTION
 #include <grpc++/ext/proto_server_reflection_plugin.h>
@@ -111,12 +116,91 @@ llvm::cl::opt<size_t> LimitResults(
                    "single request. Limit is to keep the server from being "
                    "DOS'd. Defaults to 10000."));
 
+llvm::cl::opt<size_t> FuzzyFindCacheSize(
+    "fuzzy-find-cache-size", llvm::cl::init(0),
+    llvm::cl::desc("Number of recent FuzzyFind responses to keep in memory "
+                   "and serve to identical requests until the index is "
+                   "reloaded. Defaults to 0 (disabled)."));
+
+llvm::cl::opt<bool> CompressResponses(
+    "compress-responses", llvm::cl::init(false),
+    llvm::cl::desc("Compress responses with gzip for clients that accept it. "
+                   "Trades server CPU time for bandwidth."));
+
 static Key<grpc::ServerContext *> CurrentRequest;
 
+// A least recently used cache of the responses to FuzzyFind requests, keyed by
+// the serialized request. Code completion sends the same few prefixes for
+// common scopes from many clients, and the responses only change when the
+// index is reloaded.
+class FuzzyFindCache {
+public:
+  using Response = std::vector<FuzzyFindReply>;
+
+  FuzzyFindCache(size_t Capacity) : Capacity(Capacity) {}
+
+  bool enabled() const { return Capacity != 0; }
+
+  // Returns the cached response to \p Request, or null if there is none.
+  // Also returns the generation to pass to insert() on a miss.
+  std::shared_ptr<const Response> lookup(llvm::StringRef Request,
+                                         unsigned &Generation) {
+    std::lock_guard<std::mutex> Lock(Mu);
+    Generation = CurrentGeneration;
+    auto It = Entries.find(Request);
+    if (It == Entries.end()) {
+      ++Misses;
+      return nullptr;
+    }
+    ++Hits;
+    LRU.splice(LRU.begin(), LRU, It->second);
+    return It->second->second;
+  }
+
+  // Caches \p R as the response to \p Request, unless the index was reloaded
+  // since the lookup() that returned \p Generation.
+  void insert(llvm::StringRef Request, unsigned Generation,
+              std::shared_ptr<const Response> R) {
+    std::lock_guard<std::mutex> Lock(Mu);
+    if (Generation != CurrentGeneration || Entries.count(Request))
+      return;
+    LRU.emplace_front(Request.str(), std::move(R));
+    Entries[Request] = LRU.begin();
+    if (LRU.size() > Capacity) {
+      Entries.erase(LRU.back().first);
+      LRU.pop_back();
+    }
+  }
+
+  // Drops all responses, e.g. after the index was reloaded.
+  void clear() {
+    std::lock_guard<std::mutex> Lock(Mu);
+    ++CurrentGeneration;
+    Entries.clear();
+    LRU.clear();
+  }
+
+  uint64_t hits() const { return Hits; }
+  uint64_t misses() const { return Misses; }
+
+private:
+  using Entry = std::pair<std::string, std::shared_ptr<const Response>>;
+
+  const size_t Capacity;
+  std::mutex Mu;
+  // Most recently used first.
+  std::list<Entry> LRU;
+  llvm::StringMap<std::list<Entry>::iterator> Entries;
+  unsigned CurrentGeneration = 0;
+  std::atomic<uint64_t> Hits = {0};
+  std::atomic<uint64_t> Misses = {0};
+};
+
 class RemoteIndexServer final : public v1::SymbolIndex::Service {
 public:
-  RemoteIndexServer(clangd::SymbolIndex &Index, llvm::StringRef IndexRoot)
-      : Index(Index) {
+  RemoteIndexServer(clangd::SymbolIndex &Index, llvm::StringRef IndexRoot,
+                    FuzzyFindCache &Cache)
+      : Index(Index), Cache(Cache) {
     llvm::SmallString<256> NativePath = IndexRoot;
     llvm::sys::path::native(NativePath);
     ProtobufMarshaller = std::unique_ptr<Marshaller>(new Marshaller(
@@ -190,6 +274,22 @@ private:
           Req->Limit, LimitResults);
       Req->Limit = LimitResults;
     }
+    std::string CacheKey;
+    unsigned CacheGeneration = 0;
+    std::shared_ptr<FuzzyFindCache::Response> Responses;
+    if (Cache.enabled()) {
+      CacheKey = Request->SerializeAsString();
+      if (auto Cached = Cache.lookup(CacheKey, CacheGeneration)) {
+        for (const FuzzyFindReply &Message : *Cached) {
+          logResponse(Message);
+          Reply->Write(Message);
+        }
+        SPAN_ATTACH(Tracer, "Cached", true);
+        logRequestSummary("v1/FuzzyFind", Cached->size() - 1, StartTime);
+        return grpc::Status::OK;
+      }
+      Responses = std::make_shared<FuzzyFindCache::Response>();
+    }
     unsigned Sent = 0;
     unsigned FailedToSend = 0;
     bool HasMore = Index.fuzzyFind(*Req, [&](const clangd::Symbol &Item) {
@@ -204,12 +304,19 @@ private:
       *NextMessage.mutable_stream_result() = *SerializedItem;
       logResponse(NextMessage);
       Reply->Write(NextMessage);
+      if (Responses)
+        Responses->push_back(std::move(NextMessage));
       ++Sent;
     });
     FuzzyFindReply LastMessage;
     LastMessage.mutable_final_result()->set_has_more(HasMore);
     logResponse(LastMessage);
     Reply->Write(LastMessage);
+    // Don't cache partial responses.
+    if (Responses && !FailedToSend) {
+      Responses->push_back(std::move(LastMessage));
+      Cache.insert(CacheKey, CacheGeneration, std::move(Responses));
+    }
     SPAN_ATTACH(Tracer, "Sent", Sent);
     SPAN_ATTACH(Tracer, "Failed to send", FailedToSend);
     logRequestSummary("v1/FuzzyFind", Sent, StartTime);
@@ -330,12 +437,14 @@ private:
 
   std::unique_ptr<Marshaller> ProtobufMarshaller;
   clangd::SymbolIndex &Index;
+  FuzzyFindCache &Cache;
 };
 
 class Monitor final : public v1::Monitor::Service {
 public:
-  Monitor(llvm::sys::TimePoint<> IndexAge)
-      : StartTime(std::chrono::system_clock::now()), IndexBuildTime(IndexAge) {}
+  Monitor(llvm::sys::TimePoint<> IndexAge, const FuzzyFindCache &Cache)
+      : StartTime(std::chrono::system_clock::now()), IndexBuildTime(IndexAge),
+        Cache(Cache) {}
 
   void updateIndex(llvm::sys::TimePoint<> UpdateTime) {
     IndexBuildTime.exchange(UpdateTime);
@@ -359,11 +468,16 @@ private:
         std::chrono::duration_cast<std::chrono::seconds>(
             std::chrono::system_clock::now() - IndexBuildTime.load())
             .count());
+    if (Cache.enabled()) {
+      Reply->set_fuzzy_find_cache_hits(Cache.hits());
+      Reply->set_fuzzy_find_cache_misses(Cache.misses());
+    }
     return grpc::Status::OK;
   }
 
   const llvm::sys::TimePoint<> StartTime;
   std::atomic<llvm::sys::TimePoint<>> IndexBuildTime;
+  const FuzzyFindCache &Cache;
 };
 
 void maybeTrimMemory() {
@@ -377,7 +491,7 @@ void maybeTrimMemory() {
 void hotReload(clangd::SwapIndex &Index, llvm::StringRef IndexPath,
                llvm::vfs::Status &LastStatus,
                llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> &FS,
-               Monitor &Monitor) {
+               Monitor &Monitor, FuzzyFindCache &Cache) {
   // glibc malloc doesn't shrink an arena if there are items living at the end,
   // which might happen since we destroy the old index after building new one.
   // Trim more aggresively to keep memory usage of the server low.
@@ -402,14 +516,16 @@ void hotReload(clangd::SwapIndex &Index, llvm::StringRef IndexPath,
     return;
   }
   Index.reset(std::move(NewIndex));
+  Cache.clear();
   Monitor.updateIndex(Status->getLastModificationTime());
   log("New index version loaded. Last modification time: {0}, size: {1} bytes.",
       Status->getLastModificationTime(), Status->getSize());
 }
 
 void runServerAndWait(clangd::SymbolIndex &Index, llvm::StringRef ServerAddress,
-                      llvm::StringRef IndexPath, Monitor &Monitor) {
-  RemoteIndexServer Service(Index, IndexRoot);
+                      llvm::StringRef IndexPath, Monitor &Monitor,
+                      FuzzyFindCache &Cache) {
+  RemoteIndexServer Service(Index, IndexRoot, Cache);
 
   grpc::EnableDefaultHealthCheckService(true);
 #if ENABLE_GRPC_REFLECTION
@@ -420,6 +536,8 @@ void runServerAndWait(clangd::SymbolIndex &Index, llvm::StringRef ServerAddress,
                            grpc::InsecureServerCredentials());
   Builder.AddChannelArgument(GRPC_ARG_MAX_CONNECTION_IDLE_MS,
                              IdleTimeoutSeconds * 1000);
+  if (CompressResponses)
+    Builder.SetDefaultCompressionAlgorithm(GRPC_COMPRESS_GZIP);
   Builder.RegisterService(&Service);
   Builder.RegisterService(&Monitor);
   std::unique_ptr<grpc::Server> Server(Builder.BuildAndStart());
@@ -540,18 +658,20 @@ int main(int argc, char *argv[]) {
   }
   clang::clangd::SwapIndex Index(std::move(SymIndex));
 
-  Monitor Monitor(Status->getLastModificationTime());
+  FuzzyFindCache Cache(FuzzyFindCacheSize);
+  Monitor Monitor(Status->getLastModificationTime(), Cache);
 
-  std::thread HotReloadThread([&Index, &Status, &FS, &Monitor]() {
+  std::thread HotReloadThread([&Index, &Status, &FS, &Monitor, &Cache]() {
     llvm::vfs::Status LastStatus = *Status;
     static constexpr auto RefreshFrequency = std::chrono::seconds(30);
     while (!clang::clangd::shutdownRequested()) {
-      hotReload(Index, llvm::StringRef(IndexPath), LastStatus, FS, Monitor);
+      hotReload(Index, llvm::StringRef(IndexPath), LastStatus, FS, Monitor,
+                Cache);
       std::this_thread::sleep_for(RefreshFrequency);
     }
   });
 
-  runServerAndWait(Index, ServerAddress, IndexPath, Monitor);
+  runServerAndWait(Index, ServerAddress, IndexPath, Monitor, Cache);
 
   HotReloadThread.join();
 }
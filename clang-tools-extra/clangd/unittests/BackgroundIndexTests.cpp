@@ -824,6 +824,38 @@ TEST(BackgroundQueueTest, Boost) {
   }
 }
 
+TEST(BackgroundQueueTest, BoostGroup) {
+  std::string Sequence;
+
+  BackgroundQueue::Task A([&] { Sequence.push_back('A'); });
+  A.Group = "/near";
+  A.QueuePri = 1;
+
+  BackgroundQueue::Task B([&] { Sequence.push_back('B'); });
+  B.Group = "/far";
+  B.QueuePri = 2;
+
+  BackgroundQueue::Task C([&] { Sequence.push_back('C'); });
+  C.QueuePri = 3;
+
+  {
+    BackgroundQueue Q;
+    Q.boostGroup("/near", 4);
+    Q.append({A, B, C});
+    Q.work([&] { Q.stop(); });
+    EXPECT_EQ("ACB", Sequence) << "group was boosted before enqueueing";
+  }
+  Sequence.clear();
+  {
+    BackgroundQueue Q;
+    Q.append({A, B, C});
+    Q.boostGroup("/near", 4);
+    Q.boost("/near", 5); // Tags and groups are matched separately.
+    Q.work([&] { Q.stop(); });
+    EXPECT_EQ("ACB", Sequence) << "group was boosted after enqueueing";
+  }
+}
+
 TEST(BackgroundQueueTest, Duplicates) {
   std::string Sequence;
   BackgroundQueue::Task A([&] { Sequence.push_back('A'); });
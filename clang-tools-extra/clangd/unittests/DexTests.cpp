@@ -748,8 +748,11 @@ TEST(DexTests, Relations) {
 
   std::vector<Symbol> Symbols{Parent, Child1, Child2};
 
-  std::vector<Relation> Relations{{Parent.ID, RelationKind::BaseOf, Child1.ID},
-                                  {Parent.ID, RelationKind::BaseOf, Child2.ID}};
+  std::vector<Relation> Relations{
+      {Child1.ID, RelationKind::OverriddenBy, Child2.ID},
+      {Parent.ID, RelationKind::BaseOf, Child2.ID},
+      {Child1.ID, RelationKind::BaseOf, Child2.ID},
+      {Parent.ID, RelationKind::BaseOf, Child1.ID}};
 
   Dex I{Symbols, RefSlab(), Relations};
 
@@ -761,6 +764,21 @@ TEST(DexTests, Relations) {
     Results.push_back(Object.ID);
   });
   EXPECT_THAT(Results, UnorderedElementsAre(Child1.ID, Child2.ID));
+
+  Results.clear();
+  Req.Subjects = {Child1.ID};
+  I.relations(Req, [&](const SymbolID &Subject, const Symbol &Object) {
+    EXPECT_EQ(Subject, Child1.ID);
+    Results.push_back(Object.ID);
+  });
+  EXPECT_THAT(Results, ElementsAre(Child2.ID));
+
+  Results.clear();
+  Req.Subjects = {Child2.ID};
+  I.relations(Req, [&](const SymbolID &Subject, const Symbol &Object) {
+    Results.push_back(Object.ID);
+  });
+  EXPECT_THAT(Results, ElementsAre());
 }
 
 TEST(DexIndex, IndexedFiles) {
@@ -13181,6 +13181,43 @@ public:
 
   friend class ArgumentPackSubstitutionRAII;
 
+  /// The cost of the instantiations of one template, collected when
+  /// \c CollectStats is set.
+  struct TemplateInstantiationStats {
+    unsigned NumInstantiations = 0;
+    /// Time and AST memory spent instantiating, excluding the nested
+    /// instantiations of other templates.
+    uint64_t ExclusiveNanoseconds = 0;
+    size_t ExclusiveBytes = 0;
+  };
+
+  /// The instantiation cost of each template pattern, keyed by its canonical
+  /// declaration.
+  llvm::DenseMap<const Decl *, TemplateInstantiationStats> InstantiationStats;
+
+  /// RAII object that attributes the cost of a class or function
+  /// instantiation to the pattern it is instantiated from, when
+  /// \c CollectStats is set.
+  class TemplateInstantiationStatsRAII {
+    Sema &Self;
+    const Decl *Pattern;
+    TemplateInstantiationStatsRAII *Parent;
+    uint64_t StartNanoseconds = 0;
+    size_t StartBytes = 0;
+    uint64_t NestedNanoseconds = 0;
+    size_t NestedBytes = 0;
+
+  public:
+    TemplateInstantiationStatsRAII(Sema &Self, const Decl *Pattern);
+    ~TemplateInstantiationStatsRAII();
+  };
+
+  /// The innermost active instantiation whose cost is being collected.
+  TemplateInstantiationStatsRAII *CurrentInstantiationStats = nullptr;
+
+  /// Print the templates that took the most time to instantiate.
+  void PrintInstantiationStats() const;
+
   void pushCodeSynthesisContext(CodeSynthesisContext Ctx);
   void popCodeSynthesisContext();
 
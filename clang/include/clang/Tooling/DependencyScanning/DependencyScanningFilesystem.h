@@ -220,6 +220,24 @@ public:
   CacheShard &getShardForFilename(StringRef Filename) const;
   CacheShard &getShardForUID(llvm::sys::fs::UniqueID UID) const;
 
+  /// A cached entry whose 'stat' result no longer matches the underlying
+  /// file system.
+  struct OutOfDateEntry {
+    /// The path the entry is cached for. It lives as long as the cache.
+    StringRef Path;
+    /// Whether the path was cached as missing but exists now, as opposed to
+    /// a cached file or directory that was removed, or a cached file whose
+    /// size or modification time changed.
+    bool WasNegativelyCached;
+  };
+
+  /// Returns the entries that are out of date with respect to \p UnderlyingFS.
+  ///
+  /// A service that keeps this cache across scans can use this to decide
+  /// whether the cache has to be discarded before the next scan.
+  std::vector<OutOfDateEntry>
+  getOutOfDateEntries(llvm::vfs::FileSystem &UnderlyingFS) const;
+
 private:
   std::unique_ptr<CacheShard[]> CacheShards;
   unsigned NumShards;
@@ -17,10 +17,18 @@
 #include "Program.h"
 #include "clang/AST/Expr.h"
 #include "clang/Basic/TargetInfo.h"
+#include "llvm/ADT/Statistic.h"
 
 using namespace clang;
 using namespace clang::interp;
 
+#define DEBUG_TYPE "bytecode-interp"
+
+ALWAYS_ENABLED_STATISTIC(NumEvaluations,
+                         "Number of expressions and initializers evaluated");
+ALWAYS_ENABLED_STATISTIC(NumFunctionsCompiled,
+                         "Number of functions compiled to bytecode");
+
 Context::Context(ASTContext &Ctx) : Ctx(Ctx), P(new Program(*this)) {}
 
 Context::~Context() {}
@@ -43,6 +51,7 @@ bool Context::isPotentialConstantExpr(State &Parent, const FunctionDecl *FD) {
 
 bool Context::evaluateAsRValue(State &Parent, const Expr *E, APValue &Result) {
   ++EvalID;
+  ++NumEvaluations;
   bool Recursing = !Stk.empty();
   size_t StackSizeBefore = Stk.size();
   Compiler<EvalEmitter> C(*this, *P, Parent, Stk);
@@ -73,6 +82,7 @@ bool Context::evaluateAsRValue(State &Parent, const Expr *E, APValue &Result) {
 bool Context::evaluate(State &Parent, const Expr *E, APValue &Result,
                        ConstantExprKind Kind) {
   ++EvalID;
+  ++NumEvaluations;
   bool Recursing = !Stk.empty();
   size_t StackSizeBefore = Stk.size();
   Compiler<EvalEmitter> C(*this, *P, Parent, Stk);
@@ -103,6 +113,7 @@ bool Context::evaluate(State &Parent, const Expr *E, APValue &Result,
 bool Context::evaluateAsInitializer(State &Parent, const VarDecl *VD,
                                     APValue &Result) {
   ++EvalID;
+  ++NumEvaluations;
   bool Recursing = !Stk.empty();
   size_t StackSizeBefore = Stk.size();
   Compiler<EvalEmitter> C(*this, *P, Parent, Stk);
@@ -281,8 +292,10 @@ const Function *Context::getOrCreateFunction(const FunctionDecl *FD) {
     return Func;
 
   if (!Func || WasNotDefined) {
-    if (auto F = Compiler<ByteCodeEmitter>(*this, *P).compileFunc(FD))
+    if (auto F = Compiler<ByteCodeEmitter>(*this, *P).compileFunc(FD)) {
       Func = F;
+      ++NumFunctionsCompiled;
+    }
   }
 
   return Func;
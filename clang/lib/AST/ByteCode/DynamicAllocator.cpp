@@ -9,10 +9,19 @@
 #include "DynamicAllocator.h"
 #include "InterpBlock.h"
 #include "InterpState.h"
+#include "llvm/ADT/Statistic.h"
 
 using namespace clang;
 using namespace clang::interp;
 
+#define DEBUG_TYPE "bytecode-interp"
+
+ALWAYS_ENABLED_STATISTIC(NumDynamicAllocations,
+                         "Number of dynamic allocations during evaluation");
+ALWAYS_ENABLED_STATISTIC(NumDynamicAllocationBytes,
+                         "Number of bytes dynamically allocated during "
+                         "evaluation");
+
 DynamicAllocator::~DynamicAllocator() { cleanup(); }
 
 void DynamicAllocator::cleanup() {
@@ -69,6 +78,8 @@ Block *DynamicAllocator::allocate(const Descriptor *D, unsigned EvalID,
 
   auto Memory =
       std::make_unique<std::byte[]>(sizeof(Block) + D->getAllocSize());
+  ++NumDynamicAllocations;
+  NumDynamicAllocationBytes += sizeof(Block) + D->getAllocSize();
   auto *B = new (Memory.get()) Block(EvalID, D, /*isStatic=*/false);
   B->invokeCtor();
 
@@ -22,6 +22,7 @@
 #include "clang/AST/Expr.h"
 #include "clang/AST/ExprCXX.h"
 #include "llvm/ADT/APSInt.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/StringExtras.h"
 #include <limits>
 #include <vector>
@@ -29,6 +30,13 @@
 using namespace clang;
 using namespace clang::interp;
 
+#define DEBUG_TYPE "bytecode-interp"
+
+// Counting ops is on the hottest path of the interpreter, so unlike the other
+// interpreter statistics, only count them when statistics are enabled at
+// build time.
+STATISTIC(NumOpsExecuted, "Number of bytecode ops executed");
+
 static bool RetValue(InterpState &S, CodePtr &Pt, APValue &Result) {
   llvm::report_fatal_error("Interpreter cannot return values");
 }
@@ -1422,6 +1430,7 @@ bool Interpret(InterpState &S, APValue &Result) {
   for (;;) {
     auto Op = PC.read<Opcode>();
     CodePtr OpPC = PC;
+    ++NumOpsExecuted;
 
     switch (Op) {
 #define GET_INTERP
@@ -1048,16 +1048,24 @@ private:
     const bool EnableCheckProfiling = Options.CheckProfiling.has_value();
     TimeBucketRegion Timer;
     auto &Matchers = this->Matchers->DeclOrStmt;
+    // Only expressions can be skipped by a traversal kind, and only by
+    // TK_IgnoreUnlessSpelledInSource. Find out whether this node is skipped
+    // once, rather than once per matcher.
+    const auto *E = DynNode.get<Expr>();
+    const TraversalKind DefaultTK =
+        getASTContext().getParentMapContext().getTraversalKind();
+    std::optional<bool> IsNotSpelledInSource;
     for (unsigned short I : Filter) {
       auto &MP = Matchers[I];
       if (EnableCheckProfiling)
         Timer.setBucket(&TimeByBucket[MP.second->getID()]);
       BoundNodesTreeBuilder Builder;
 
-      {
-        TraversalKindScope RAII(getASTContext(), MP.first.getTraversalKind());
-        if (getASTContext().getParentMapContext().traverseIgnored(DynNode) !=
-            DynNode)
+      if (E && MP.first.getTraversalKind().value_or(DefaultTK) ==
+                   TK_IgnoreUnlessSpelledInSource) {
+        if (!IsNotSpelledInSource)
+          IsNotSpelledInSource = E->IgnoreUnlessSpelledInSource() != E;
+        if (*IsNotSpelledInSource)
           continue;
       }
 
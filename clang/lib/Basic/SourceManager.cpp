@@ -43,6 +43,10 @@
 #include <utility>
 #include <vector>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 using namespace clang;
 using namespace SrcMgr;
 using llvm::MemoryBuffer;
@@ -1220,6 +1224,31 @@ LineOffsetMapping LineOffsetMapping::get(llvm::MemoryBufferRef Buffer,
   const unsigned char *End = (const unsigned char *)Buffer.getBufferEnd();
   const unsigned char *Buf = Start;
 
+#ifdef __SSE2__
+  // Find all the newline characters of 16 bytes at a time. One byte past the
+  // chunk must be readable to recognize a \r\n that straddles two chunks.
+  const __m128i LFs = _mm_set1_epi8('\n');
+  const __m128i CRs = _mm_set1_epi8('\r');
+  while (End - Buf > 16) {
+    __m128i Chunk = _mm_loadu_si128((const __m128i *)Buf);
+    unsigned Mask = _mm_movemask_epi8(
+        _mm_or_si128(_mm_cmpeq_epi8(Chunk, LFs), _mm_cmpeq_epi8(Chunk, CRs)));
+    const unsigned char *Next = Buf + 16;
+    while (Mask) {
+      unsigned N = llvm::countr_zero(Mask);
+      Mask &= Mask - 1;
+      // If this is \r\n, skip both characters.
+      if (Buf[N] == '\r' && Buf[N + 1] == '\n') {
+        ++N;
+        Mask &= ~(1u << N);
+        if (N == 16)
+          Next = Buf + 17;
+      }
+      LineOffsets.push_back(Buf - Start + N + 1);
+    }
+    Buf = Next;
+  }
+#else
   uint64_t Word;
 
   // scan sizeof(Word) bytes at a time for new lines.
@@ -1254,6 +1283,7 @@ LineOffsetMapping LineOffsetMapping::get(llvm::MemoryBufferRef Buffer,
       };
     } while (Buf < End - sizeof(Word) - 1);
   }
+#endif
 
   // Handle tail using a regular check.
   while (Buf < End) {
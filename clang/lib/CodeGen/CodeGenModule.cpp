@@ -850,7 +850,12 @@ void CodeGenModule::Release() {
   Module *Primary = getContext().getCurrentNamedModule();
   if (CXX20ModuleInits && Primary && !Primary->isHeaderLikeModule())
     EmitModuleInitializers(Primary);
-  EmitDeferred();
+  {
+    // Emitting the deferred definitions after the end of the TU can take a
+    // large part of the frontend time, so make it visible in time traces.
+    llvm::TimeTraceScope TimeScope("CodeGen Deferred");
+    EmitDeferred();
+  }
   DeferredDecls.insert(EmittedDeferredDecls.begin(),
                        EmittedDeferredDecls.end());
   EmittedDeferredDecls.clear();
@@ -4185,6 +4185,11 @@ static bool RenderModulesOptions(Compilation &C, const Driver &D,
                       options::OPT_fmodules_validate_once_per_build_session);
     }
 
+    if (!Args.hasFlag(options::OPT_fmodules_force_validate_user_headers,
+                      options::OPT_fno_modules_force_validate_user_headers,
+                      true))
+      CmdArgs.push_back("-fno-modules-force-validate-user-headers");
+
     if (Args.hasFlag(options::OPT_fmodules_validate_system_headers,
                      options::OPT_fno_modules_validate_system_headers,
                      ImplicitModules))
@@ -4196,6 +4201,8 @@ static bool RenderModulesOptions(Compilation &C, const Driver &D,
     Args.ClaimAllArgs(options::OPT_fbuild_session_timestamp);
     Args.ClaimAllArgs(options::OPT_fbuild_session_file);
     Args.ClaimAllArgs(options::OPT_fmodules_validate_once_per_build_session);
+    Args.ClaimAllArgs(options::OPT_fmodules_force_validate_user_headers);
+    Args.ClaimAllArgs(options::OPT_fno_modules_force_validate_user_headers);
     Args.ClaimAllArgs(options::OPT_fmodules_validate_system_headers);
     Args.ClaimAllArgs(options::OPT_fno_modules_validate_system_headers);
     Args.ClaimAllArgs(options::OPT_fmodules_disable_diagnostic_validation);
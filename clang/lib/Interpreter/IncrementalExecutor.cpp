@@ -80,11 +80,12 @@ llvm::Error IncrementalExecutor::addModule(PartialTranslationUnit &PTU) {
 
 llvm::Error IncrementalExecutor::removeModule(PartialTranslationUnit &PTU) {
 
-  llvm::orc::ResourceTrackerSP RT = std::move(ResourceTrackers[&PTU]);
-  if (!RT)
+  auto It = ResourceTrackers.find(&PTU);
+  if (It == ResourceTrackers.end())
     return llvm::Error::success();
 
-  ResourceTrackers.erase(&PTU);
+  llvm::orc::ResourceTrackerSP RT = std::move(It->second);
+  ResourceTrackers.erase(It);
   if (llvm::Error Err = RT->remove())
     return Err;
   return llvm::Error::success();
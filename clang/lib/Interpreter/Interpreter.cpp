@@ -613,6 +613,13 @@ llvm::Error Interpreter::CreateExecutor() {
 
 void Interpreter::ResetExecutor() { IncrExecutor.reset(); }
 
+/// \returns true if \p M has nothing the JIT would need to link or run, for
+/// example because its PTU only declared things.
+static bool isEmptyModule(const llvm::Module &M) {
+  return M.empty() && M.global_empty() && M.alias_empty() && M.ifunc_empty() &&
+         M.getModuleInlineAsm().empty();
+}
+
 llvm::Error Interpreter::Execute(PartialTranslationUnit &T) {
   assert(T.TheModule);
   if (!IncrExecutor) {
@@ -620,6 +627,12 @@ llvm::Error Interpreter::Execute(PartialTranslationUnit &T) {
     if (Err)
       return Err;
   }
+  // Compiling and linking an empty module is a large part of the time spent
+  // on inputs that only contain declarations, so skip them. The executor is
+  // still created above, so that the symbols they declare can be looked up.
+  // Undo handles PTUs that have not been added to the executor.
+  if (isEmptyModule(*T.TheModule))
+    return llvm::Error::success();
   // FIXME: Add a callback to retain the llvm::Module once the JIT is done.
   if (auto Err = IncrExecutor->addModule(T))
     return Err;
@@ -51,6 +51,13 @@
 #include <nmmintrin.h>
 #endif
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#elif __ALTIVEC__
+#include <altivec.h>
+#undef bool
+#endif
+
 using namespace clang;
 
 //===----------------------------------------------------------------------===//
@@ -2588,8 +2595,35 @@ bool Lexer::SkipLineComment(Token &Result, const char *CurPtr,
   // emiting to many diagnostics (see http://unicode.org/review/pr-121.html).
   bool UnicodeDecodingAlreadyDiagnosed = false;
 
+#ifdef __SSE2__
+  __m128i Newlines = _mm_set1_epi8('\n');
+  __m128i CarriageReturns = _mm_set1_epi8('\r');
+  __m128i Zeros = _mm_setzero_si128();
+#endif
+
   char C;
   while (true) {
+#ifdef __SSE2__
+    // Skip 16 bytes at a time until one of them is a newline, a potential EOF
+    // or not ASCII; the scalar loop below then handles that byte.
+    while (BufferEnd - CurPtr >= 16) {
+      __m128i Chars = _mm_loadu_si128((const __m128i *)CurPtr);
+      __m128i Stop = _mm_or_si128(
+          _mm_or_si128(_mm_cmpeq_epi8(Chars, Newlines),
+                       _mm_cmpeq_epi8(Chars, CarriageReturns)),
+          _mm_cmpeq_epi8(Chars, Zeros));
+      unsigned Mask = _mm_movemask_epi8(Stop) | _mm_movemask_epi8(Chars);
+      if (Mask != 0) {
+        unsigned N = llvm::countr_zero<unsigned>(Mask);
+        if (N != 0)
+          UnicodeDecodingAlreadyDiagnosed = false;
+        CurPtr += N;
+        break;
+      }
+      CurPtr += 16;
+      UnicodeDecodingAlreadyDiagnosed = false;
+    }
+#endif
     C = *CurPtr;
     // Skip over characters in the fast loop.
     while (isASCII(C) && C != 0 &&   // Potentially EOF.
@@ -2828,13 +2862,6 @@ static bool isEndOfBlockCommentWithEscapedNewLine(const char *CurPtr, Lexer *L,
   return true;
 }
 
-#ifdef __SSE2__
-#include <emmintrin.h>
-#elif __ALTIVEC__
-#include <altivec.h>
-#undef bool
-#endif
-
 /// We have just read from input the / and * characters that started a comment.
 /// Read until we find the * and / characters that terminate the comment.
 /// Note that we don't bother decoding trigraphs or escaped newlines in block
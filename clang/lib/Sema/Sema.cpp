@@ -617,6 +617,8 @@ void Sema::addExternalSource(ExternalSemaSource *E) {
 void Sema::PrintStats() const {
   llvm::errs() << "\n*** Semantic Analysis Stats:\n";
   llvm::errs() << NumSFINAEErrors << " SFINAE diagnostics trapped.\n";
+  if (!InstantiationStats.empty())
+    PrintInstantiationStats();
 
   BumpAlloc.PrintStats();
   AnalysisWarnings.PrintStats();
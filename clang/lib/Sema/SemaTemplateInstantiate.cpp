@@ -40,8 +40,10 @@
 #include "llvm/ADT/STLForwardCompat.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/SaveAndRestore.h"
 #include "llvm/Support/TimeProfiler.h"
+#include <chrono>
 #include <optional>
 
 using namespace clang;
@@ -904,6 +906,66 @@ bool Sema::InstantiatingTemplate::CheckInstantiationDepth(
   return true;
 }
 
+static uint64_t getNanoseconds() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+Sema::TemplateInstantiationStatsRAII::TemplateInstantiationStatsRAII(
+    Sema &Self, const Decl *Pattern)
+    : Self(Self),
+      Pattern(Self.CollectStats && Pattern ? Pattern->getCanonicalDecl()
+                                           : nullptr),
+      Parent(nullptr) {
+  if (!this->Pattern)
+    return;
+  Parent = Self.CurrentInstantiationStats;
+  Self.CurrentInstantiationStats = this;
+  StartBytes = Self.Context.getAllocator().getBytesAllocated();
+  StartNanoseconds = getNanoseconds();
+}
+
+Sema::TemplateInstantiationStatsRAII::~TemplateInstantiationStatsRAII() {
+  if (!Pattern)
+    return;
+  uint64_t Nanoseconds = getNanoseconds() - StartNanoseconds;
+  size_t Bytes = Self.Context.getAllocator().getBytesAllocated() - StartBytes;
+  TemplateInstantiationStats &Stats = Self.InstantiationStats[Pattern];
+  ++Stats.NumInstantiations;
+  Stats.ExclusiveNanoseconds += Nanoseconds - NestedNanoseconds;
+  Stats.ExclusiveBytes += Bytes - NestedBytes;
+  if (Parent) {
+    Parent->NestedNanoseconds += Nanoseconds;
+    Parent->NestedBytes += Bytes;
+  }
+  Self.CurrentInstantiationStats = Parent;
+}
+
+void Sema::PrintInstantiationStats() const {
+  // Only print the most expensive templates; there can be many thousands.
+  const unsigned MaxTemplates = 20;
+  SmallVector<std::pair<const Decl *, TemplateInstantiationStats>, 0> Sorted(
+      InstantiationStats.begin(), InstantiationStats.end());
+  llvm::sort(Sorted, [](const auto &A, const auto &B) {
+    return A.second.ExclusiveNanoseconds > B.second.ExclusiveNanoseconds;
+  });
+
+  llvm::errs() << "\n*** Template Instantiation Stats:\n";
+  llvm::errs() << InstantiationStats.size() << " templates instantiated.\n";
+  llvm::errs() << "  Time (ms)  Count        Bytes  Template\n";
+  for (const auto &[D, Stats] : ArrayRef(Sorted).take_front(MaxTemplates)) {
+    llvm::errs() << llvm::format("%11.3f %6u %12zu  ",
+                                 Stats.ExclusiveNanoseconds / 1e6,
+                                 Stats.NumInstantiations, Stats.ExclusiveBytes);
+    if (const auto *ND = dyn_cast<NamedDecl>(D))
+      ND->printQualifiedName(llvm::errs());
+    else
+      llvm::errs() << D->getDeclKindName();
+    llvm::errs() << '\n';
+  }
+}
+
 void Sema::PrintInstantiationStack() {
   // Determine which template instantiations to skip, if any.
   unsigned SkipStart = CodeSynthesisContexts.size(), SkipEnd = SkipStart;
@@ -3631,6 +3693,7 @@ Sema::InstantiateClass(SourceLocation PointOfInstantiation,
     }
     return M;
   });
+  TemplateInstantiationStatsRAII InstantiationStatsScope(*this, Pattern);
 
   Pattern = PatternDef;
 
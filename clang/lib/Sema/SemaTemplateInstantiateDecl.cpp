@@ -5022,6 +5022,7 @@ void Sema::InstantiateFunctionDefinition(SourceLocation PointOfInstantiation,
     }
     return M;
   });
+  TemplateInstantiationStatsRAII InstantiationStatsScope(*this, PatternDecl);
 
   // If we're performing recursive template instantiation, create our own
   // queue of pending implicit instantiations that we will instantiate later,
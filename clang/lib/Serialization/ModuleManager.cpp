@@ -198,13 +198,16 @@ ModuleManager::addModule(StringRef FileName, ModuleKind Type,
     return OutOfDate;
   } else {
     // Get a buffer of the file and close the file descriptor when done.
-    // The file is volatile because in a parallel build we expect multiple
-    // compiler processes to use the same module file rebuilding it if needed.
+    // An implicitly-built module file is volatile because in a parallel build
+    // we expect multiple compiler processes to use the same module file
+    // rebuilding it if needed. Explicit and prebuilt module files are owned
+    // by the build system and don't change under us, so they can be mmapped
+    // and their pages shared between the compiler instances that load them.
     //
     // RequiresNullTerminator is false because module files don't need it, and
     // this allows the file to still be mmapped.
-    auto Buf = FileMgr.getBufferForFile(NewModule->File,
-                                        /*IsVolatile=*/true,
+    bool IsVolatile = Type != MK_ExplicitModule && Type != MK_PrebuiltModule;
+    auto Buf = FileMgr.getBufferForFile(NewModule->File, IsVolatile,
                                         /*RequiresNullTerminator=*/false);
 
     if (!Buf) {
@@ -108,6 +108,45 @@ DependencyScanningFilesystemSharedCache::getShardForUID(
   return CacheShards[Hash % NumShards];
 }
 
+std::vector<DependencyScanningFilesystemSharedCache::OutOfDateEntry>
+DependencyScanningFilesystemSharedCache::getOutOfDateEntries(
+    llvm::vfs::FileSystem &UnderlyingFS) const {
+  std::vector<OutOfDateEntry> OutOfDateEntries;
+  for (unsigned I = 0; I < NumShards; ++I) {
+    CacheShard &Shard = CacheShards[I];
+    std::lock_guard<std::mutex> LockGuard(Shard.CacheLock);
+    for (const auto &[Path, CachedPair] : Shard.CacheByFilename) {
+      const CachedFileSystemEntry *Entry = CachedPair.first;
+      if (!Entry)
+        continue;
+
+      llvm::ErrorOr<llvm::vfs::Status> Status = UnderlyingFS.status(Path);
+      if (!Status) {
+        // A path cached as missing that is still missing is up to date.
+        if (!Entry->isError())
+          OutOfDateEntries.push_back({Path, /*WasNegativelyCached=*/false});
+        continue;
+      }
+
+      if (Entry->isError()) {
+        OutOfDateEntries.push_back({Path, /*WasNegativelyCached=*/true});
+        continue;
+      }
+
+      // Directories are only cached for their existence.
+      if (Entry->isDirectory())
+        continue;
+
+      llvm::vfs::Status CachedStatus = Entry->getStatus();
+      if (CachedStatus.getSize() != Status->getSize() ||
+          CachedStatus.getLastModificationTime() !=
+              Status->getLastModificationTime())
+        OutOfDateEntries.push_back({Path, /*WasNegativelyCached=*/false});
+    }
+  }
+  return OutOfDateEntries;
+}
+
 const CachedFileSystemEntry *
 DependencyScanningFilesystemSharedCache::CacheShard::findEntryByFilename(
     StringRef Filename) const {
@@ -0,0 +1,17 @@
+// RUN: %clang_cc1 -fsyntax-only -print-stats %s 2>&1 | FileCheck %s
+
+template <typename T> struct S {
+  T get() { return T(); }
+};
+
+template <typename T> T f(T t) { return S<T>().get() + t; }
+
+int i = f(0);
+long l = f(0L);
+
+// CHECK: *** Template Instantiation Stats:
+// CHECK-NEXT: 3 templates instantiated.
+// CHECK-NEXT: Time (ms)  Count        Bytes  Template
+// CHECK-DAG: {{^ +[0-9.]+ +2 +[0-9]+  f$}}
+// CHECK-DAG: {{^ +[0-9.]+ +2 +[0-9]+  S$}}
+// CHECK-DAG: {{^ +[0-9.]+ +2 +[0-9]+  S::get$}}
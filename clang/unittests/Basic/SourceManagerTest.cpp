@@ -405,6 +405,17 @@ TEST_F(SourceManagerTest, getLineNumber) {
   ASSERT_NO_FATAL_FAILURE(SourceMgr.getLineNumber(mainFileID, 1, nullptr));
 }
 
+TEST_F(SourceManagerTest, lineOffsetMapping) {
+  // Mix the newline forms, with a \r\n that straddles a 16-byte boundary.
+  StringRef Source = "0123456789abcde\r\nx\ny\rz\r\r\n"
+                     "0123456789abcdef0123456789\n\n";
+  llvm::BumpPtrAllocator Alloc;
+  auto Lines = SrcMgr::LineOffsetMapping::get(
+      llvm::MemoryBufferRef(Source, "lines"), Alloc);
+  std::vector<unsigned> Expected = {0, 17, 19, 21, 23, 25, 52, 53};
+  EXPECT_EQ(Lines.getLines(), ArrayRef<unsigned>(Expected));
+}
+
 struct FakeExternalSLocEntrySource : ExternalSLocEntrySource {
   bool ReadSLocEntry(int ID) override { return {}; }
   int getSLocEntryID(SourceLocation::UIntTy SLocOffset) override { return 0; }
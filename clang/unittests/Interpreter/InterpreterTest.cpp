@@ -221,6 +221,26 @@ TEST_F(InterpreterTest, FindMangledNameSymbol) {
 #endif // _WIN32
 }
 
+TEST_F(InterpreterTest, FindSymbolDeclaredByEmptyModule) {
+  std::unique_ptr<Interpreter> Interp = createInterpreter();
+
+  // The module of this input is empty and is not added to the JIT, but the
+  // symbols it declares can still be looked up.
+  if (llvm::Error Err = Interp->ParseAndExecute(
+          "extern \"C\" int printf(const char*, ...);")) {
+    // We cannot execute on the platform.
+    consumeError(std::move(Err));
+    return;
+  }
+  auto Addr = Interp->getSymbolAddress("printf");
+  EXPECT_FALSE(!Addr);
+
+  // FIXME: Re-enable when we investigate the way we handle dllimports on Win.
+#ifndef _WIN32
+  EXPECT_EQ((uintptr_t)&printf, Addr->getValue());
+#endif // _WIN32
+}
+
 static Value AllocateObject(TypeDecl *TD, Interpreter &Interp) {
   std::string Name = TD->getQualifiedNameAsString();
   Value Addr;
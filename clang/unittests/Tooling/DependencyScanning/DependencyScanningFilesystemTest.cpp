@@ -7,6 +7,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "clang/Tooling/DependencyScanning/DependencyScanningFilesystem.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/Support/VirtualFileSystem.h"
 #include "gtest/gtest.h"
@@ -178,3 +179,39 @@ TEST(DependencyScanningFilesystem, CacheStatFailures) {
   DepFS.exists("/cache/a.pcm");
   EXPECT_EQ(InstrumentingFS->NumStatusCalls, 5u);
 }
+
+TEST(DependencyScanningFilesystem, OutOfDateEntries) {
+  auto InMemoryFS = llvm::makeIntrusiveRefCnt<llvm::vfs::InMemoryFileSystem>();
+  InMemoryFS->setCurrentWorkingDirectory("/");
+  InMemoryFS->addFile("/same.h", 0, llvm::MemoryBuffer::getMemBuffer("a"));
+  InMemoryFS->addFile("/changed.h", 0, llvm::MemoryBuffer::getMemBuffer("b"));
+  InMemoryFS->addFile("/removed.h", 0, llvm::MemoryBuffer::getMemBuffer("c"));
+
+  DependencyScanningFilesystemSharedCache SharedCache;
+  DependencyScanningWorkerFilesystem DepFS(SharedCache, InMemoryFS);
+
+  DepFS.status("/same.h");
+  DepFS.status("/changed.h");
+  DepFS.status("/missing.h");
+  DepFS.status("/removed.h");
+  EXPECT_TRUE(SharedCache.getOutOfDateEntries(*InMemoryFS).empty());
+
+  // Simulate edits by comparing against a newer snapshot of the file system.
+  auto NewFS = llvm::makeIntrusiveRefCnt<llvm::vfs::InMemoryFileSystem>();
+  NewFS->setCurrentWorkingDirectory("/");
+  NewFS->addFile("/same.h", 0, llvm::MemoryBuffer::getMemBuffer("a"));
+  NewFS->addFile("/changed.h", 0, llvm::MemoryBuffer::getMemBuffer("bb"));
+  NewFS->addFile("/missing.h", 0, llvm::MemoryBuffer::getMemBuffer(""));
+
+  auto OutOfDate = SharedCache.getOutOfDateEntries(*NewFS);
+  ASSERT_EQ(OutOfDate.size(), 3u);
+  llvm::sort(OutOfDate, [](const auto &A, const auto &B) {
+    return A.Path < B.Path;
+  });
+  EXPECT_EQ(OutOfDate[0].Path, "/changed.h");
+  EXPECT_FALSE(OutOfDate[0].WasNegativelyCached);
+  EXPECT_EQ(OutOfDate[1].Path, "/missing.h");
+  EXPECT_TRUE(OutOfDate[1].WasNegativelyCached);
+  EXPECT_EQ(OutOfDate[2].Path, "/removed.h");
+  EXPECT_FALSE(OutOfDate[2].WasNegativelyCached);
+}
@@ -11,8 +11,10 @@
 // Code for MemProf stack trace.
 //===----------------------------------------------------------------------===//
 #include "memprof_stack.h"
+#include "memprof_flags.h"
 #include "memprof_internal.h"
 #include "sanitizer_common/sanitizer_atomic.h"
+#include "sanitizer_common/sanitizer_sampler.h"
 
 namespace __memprof {
 
@@ -26,6 +28,21 @@ u32 GetMallocContextSize() {
   return atomic_load(&malloc_context_size, memory_order_acquire);
 }
 
+// Decides which allocations of the thread are sampled.
+static THREADLOCAL RandomIntervalSampler allocation_sampler;
+
+bool IsAllocationSamplingEnabled() {
+  return flags()->allocation_sampling_period > 1;
+}
+
+bool SampleAllocation() {
+  if (LIKELY(!IsAllocationSamplingEnabled()))
+    return true;
+  return allocation_sampler.Sample(
+      flags()->allocation_sampling_period,
+      static_cast<u32>(reinterpret_cast<uptr>(&allocation_sampler) >> 4));
+}
+
 } // namespace __memprof
 
 void __sanitizer::BufferedStackTrace::UnwindImpl(uptr pc, uptr bp,
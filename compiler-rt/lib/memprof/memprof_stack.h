@@ -26,6 +26,11 @@ static const u32 kDefaultMallocContextSize = 30;
 void SetMallocContextSize(u32 size);
 u32 GetMallocContextSize();
 
+// Returns whether the next allocation of this thread is to be profiled, as
+// decided by the allocation_sampling_period flag.
+bool SampleAllocation();
+bool IsAllocationSamplingEnabled();
+
 } // namespace __memprof
 
 // NOTE: A Rule of thumb is to retrieve stack trace in the interceptors
@@ -52,10 +57,15 @@ u32 GetMallocContextSize();
 
 #define GET_STACK_TRACE_THREAD GET_STACK_TRACE(kStackTraceMax, true)
 
+// The stack of allocations that are not sampled is left empty, which tells
+// the allocator not to profile them.
 #define GET_STACK_TRACE_MALLOC                                                 \
-  GET_STACK_TRACE(GetMallocContextSize(), common_flags()->fast_unwind_on_malloc)
+  const u32 malloc_stack_size =                                                \
+      SampleAllocation() ? GetMallocContextSize() : 0;                         \
+  GET_STACK_TRACE(malloc_stack_size, common_flags()->fast_unwind_on_malloc)
 
-#define GET_STACK_TRACE_FREE GET_STACK_TRACE_MALLOC
+#define GET_STACK_TRACE_FREE                                                   \
+  GET_STACK_TRACE(GetMallocContextSize(), common_flags()->fast_unwind_on_malloc)
 
 #define PRINT_CURRENT_STACK()                                                  \
   {                                                                            \
@@ -559,14 +559,25 @@ public:
   void *getInstance(const char *ThreadData);
 
 private:
+  // Accesses tend to repeat for the same variable (e.g. in loops), so the most
+  // recently returned instance is checked before the maps.
+  const char *LastThreadData = nullptr;
+  char *LastInstance = nullptr;
+
   std::unordered_map<const char *, char *> Instances;
   std::unordered_map<const char *, std::unique_ptr<char[]>> AllocatedSections;
 };
 
 void *ELFNixPlatformRuntimeTLVManager::getInstance(const char *ThreadData) {
+  if (ThreadData == LastThreadData)
+    return LastInstance;
+
   auto I = Instances.find(ThreadData);
-  if (I != Instances.end())
+  if (I != Instances.end()) {
+    LastThreadData = ThreadData;
+    LastInstance = I->second;
     return I->second;
+  }
   auto TDS =
       ELFNixPlatformRuntimeState::get().getThreadDataSectionFor(ThreadData);
   if (!TDS) {
@@ -584,6 +595,8 @@ void *ELFNixPlatformRuntimeTLVManager::getInstance(const char *ThreadData) {
 
   char *Instance = Allocated.get() + ThreadDataDelta;
   Instances[ThreadData] = Instance;
+  LastThreadData = ThreadData;
+  LastInstance = Instance;
   return Instance;
 }
 
@@ -699,11 +712,12 @@ __orc_rt_elfnix_deregister_object_sections(char *ArgData, size_t ArgSize) {
 ORC_RT_INTERFACE void *__orc_rt_elfnix_tls_get_addr_impl(TLSInfoEntry *D) {
   auto *TLVMgr = static_cast<ELFNixPlatformRuntimeTLVManager *>(
       pthread_getspecific(D->Key));
-  if (!TLVMgr)
+  if (!TLVMgr) {
     TLVMgr = new ELFNixPlatformRuntimeTLVManager();
-  if (pthread_setspecific(D->Key, TLVMgr)) {
-    __orc_rt_log_error("Call to pthread_setspecific failed");
-    return nullptr;
+    if (pthread_setspecific(D->Key, TLVMgr)) {
+      __orc_rt_log_error("Call to pthread_setspecific failed");
+      return nullptr;
+    }
   }
 
   return TLVMgr->getInstance(
@@ -1296,14 +1296,25 @@ public:
   void *getInstance(const char *ThreadData);
 
 private:
+  // Accesses tend to repeat for the same variable (e.g. in loops), so the most
+  // recently returned instance is checked before the maps.
+  const char *LastThreadData = nullptr;
+  char *LastInstance = nullptr;
+
   std::unordered_map<const char *, char *> Instances;
   std::unordered_map<const char *, std::unique_ptr<char[]>> AllocatedSections;
 };
 
 void *MachOPlatformRuntimeTLVManager::getInstance(const char *ThreadData) {
+  if (ThreadData == LastThreadData)
+    return LastInstance;
+
   auto I = Instances.find(ThreadData);
-  if (I != Instances.end())
+  if (I != Instances.end()) {
+    LastThreadData = ThreadData;
+    LastInstance = I->second;
     return I->second;
+  }
 
   auto TDS =
       MachOPlatformRuntimeState::get().getThreadDataSectionFor(ThreadData);
@@ -1323,6 +1334,8 @@ void *MachOPlatformRuntimeTLVManager::getInstance(const char *ThreadData) {
 
   char *Instance = Allocated.get() + ThreadDataDelta;
   Instances[ThreadData] = Instance;
+  LastThreadData = ThreadData;
+  LastInstance = Instance;
   return Instance;
 }
 
@@ -49,6 +49,47 @@ COMPILER_RT_VISIBILITY uint64_t __llvm_profile_get_version(void) {
   return INSTR_PROF_RAW_VERSION_VAR;
 }
 
+#if defined(__ELF__)
+#define PROF_SHRD_START INSTR_PROF_SECT_START(INSTR_PROF_SHRD_COMMON)
+#define PROF_SHRD_STOP INSTR_PROF_SECT_STOP(INSTR_PROF_SHRD_COMMON)
+
+/* The compiler emits a record into this section for each function with
+ * sharded counters. */
+extern __llvm_profile_counter_shards PROF_SHRD_START COMPILER_RT_VISIBILITY
+    COMPILER_RT_WEAK;
+extern __llvm_profile_counter_shards PROF_SHRD_STOP COMPILER_RT_VISIBILITY
+    COMPILER_RT_WEAK;
+#endif
+
+COMPILER_RT_VISIBILITY void lprofFoldCounterShards(void) {
+#if defined(__ELF__)
+  if (__llvm_profile_get_version() & VARIANT_MASK_BYTE_COVERAGE)
+    return;
+
+  /* The runtime writes timestamps to the first shard only. */
+  uint32_t First =
+      (__llvm_profile_get_version() & VARIANT_MASK_TEMPORAL_PROF) ? 1 : 0;
+  const __llvm_profile_counter_shards *SI;
+  for (SI = &PROF_SHRD_START; SI < &PROF_SHRD_STOP; ++SI) {
+    const __llvm_profile_data *DI =
+        (const __llvm_profile_data *)((uintptr_t)SI + SI->DataPtr);
+    uint64_t *Counters = (uint64_t *)((uintptr_t)DI + DI->CounterPtr);
+    uint32_t ShardSize = (DI->NumCounters + INSTR_PROF_COUNTER_SHARD_ALIGNMENT -
+                          1) / INSTR_PROF_COUNTER_SHARD_ALIGNMENT *
+                         INSTR_PROF_COUNTER_SHARD_ALIGNMENT;
+    uint64_t S;
+    uint32_t I;
+    for (S = 1; S < SI->NumShards; ++S) {
+      uint64_t *Shard = Counters + S * ShardSize;
+      for (I = First; I < DI->NumCounters; ++I) {
+        Counters[I] += Shard[I];
+        Shard[I] = 0;
+      }
+    }
+  }
+#endif
+}
+
 COMPILER_RT_VISIBILITY void __llvm_profile_reset_counters(void) {
   if (__llvm_profile_get_version() & VARIANT_MASK_TEMPORAL_PROF)
     __llvm_profile_global_timestamp = 1;
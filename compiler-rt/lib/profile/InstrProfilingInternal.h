@@ -148,6 +148,11 @@ typedef struct VPDataReaderType {
                                         uint32_t N);
 } VPDataReaderType;
 
+/* Add the counters of all shards into the first shard, which is the one
+ * described by the profile data, and zero the others. This does nothing
+ * unless the compiler sharded the counters. */
+void lprofFoldCounterShards(void);
+
 /* Write profile data to destination. If SkipNameDataWrite is set to 1,
    the name data is already in destination, we just skip over it. */
 int lprofWriteData(ProfDataWriter *Writer, VPDataReaderType *VPDataReader,
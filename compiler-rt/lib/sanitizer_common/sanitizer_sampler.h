@@ -0,0 +1,51 @@
+//===-- sanitizer_sampler.h -------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Random sampling of one in N events with a cheap check per event.
+//
+//===----------------------------------------------------------------------===//
+#ifndef SANITIZER_SAMPLER_H
+#define SANITIZER_SAMPLER_H
+
+#include "sanitizer_internal_defs.h"
+
+namespace __sanitizer {
+
+// Samples one in `period` events on average. The distance between two sampled
+// events is uniformly distributed in [1, 2 * period - 1], so that events with
+// a period of their own do not alias with the sampling, and all but the
+// sampled events only decrement a counter. The first event is never sampled.
+//
+// A zero-initialized object is ready to use, so that it can be thread-local.
+// It is not thread-safe.
+struct RandomIntervalSampler {
+  // Returns whether the next event is sampled. `seed` seeds the random number
+  // generator the first time it is needed, and is ignored after that.
+  bool Sample(u32 period, u32 seed) {
+    if (events_until_sample > 1) {
+      --events_until_sample;
+      return false;
+    }
+    if (UNLIKELY(rand_state == 0))
+      rand_state = seed | 1;
+    // xorshift32, which is enough to avoid aliasing with periodic events.
+    rand_state ^= rand_state << 13;
+    rand_state ^= rand_state >> 17;
+    rand_state ^= rand_state << 5;
+    bool first = events_until_sample == 0;
+    events_until_sample = 1 + rand_state % (2 * period - 1);
+    return !first;
+  }
+
+  u32 events_until_sample;
+  u32 rand_state;
+};
+
+}  // namespace __sanitizer
+
+#endif  // SANITIZER_SAMPLER_H
@@ -203,12 +203,57 @@ StackDepotNode::args_type StackDepotNode::load(u32 id) const {
   return stackStore.Load(store_id);
 }
 
+// Most stacks are put from a few call sites, so each thread caches the ids of
+// the stacks it put last. A hit skips the hash table and node lookups, which
+// are likely cache misses once the depot is large. The depot tells stacks
+// apart by their hash only, so a hit returns the id that the depot would.
+#if SANITIZER_LINUX && !SANITIZER_ANDROID && !SANITIZER_GO
+#  define SANITIZER_STACK_DEPOT_PUT_CACHE 1
+#else
+#  define SANITIZER_STACK_DEPOT_PUT_CACHE 0
+#endif
+
+#if SANITIZER_STACK_DEPOT_PUT_CACHE
+namespace {
+struct PutCacheEntry {
+  StackDepotNode::hash_type hash;
+  u32 id;
+  // Entries of older generations predate a TestOnlyUnmap.
+  u32 generation;
+};
+}  // namespace
+
+static constexpr uptr kPutCacheSize = 64;
+static atomic_uint32_t put_cache_generation;
+// Allocations in the __tls_get_addr interceptor put stacks, so this cannot use
+// the global-dynamic TLS model.
+__attribute__((tls_model("initial-exec"))) static THREADLOCAL PutCacheEntry
+    put_cache[kPutCacheSize];
+#endif
+
+static u32 PutCached(StackTrace stack) {
+#if SANITIZER_STACK_DEPOT_PUT_CACHE
+  if (!StackDepotNode::is_valid(stack))
+    return 0;
+  StackDepotNode::hash_type hash = StackDepotNode::hash(stack);
+  u32 generation = atomic_load_relaxed(&put_cache_generation);
+  PutCacheEntry &entry = put_cache[hash % kPutCacheSize];
+  if (entry.id && entry.hash == hash && entry.generation == generation)
+    return entry.id;
+  u32 id = theDepot.PutWithHash(stack, hash);
+  entry = {hash, id, generation};
+  return id;
+#else
+  return theDepot.Put(stack);
+#endif
+}
+
 StackDepotStats StackDepotGetStats() { return theDepot.GetStats(); }
 
-u32 StackDepotPut(StackTrace stack) { return theDepot.Put(stack); }
+u32 StackDepotPut(StackTrace stack) { return PutCached(stack); }
 
 StackDepotHandle StackDepotPut_WithHandle(StackTrace stack) {
-  return StackDepotNode::get_handle(theDepot.Put(stack));
+  return StackDepotNode::get_handle(PutCached(stack));
 }
 
 StackTrace StackDepotGet(u32 id) {
@@ -242,6 +287,9 @@ StackDepotHandle StackDepotNode::get_handle(u32 id) {
 void StackDepotTestOnlyUnmap() {
   theDepot.TestOnlyUnmap();
   stackStore.TestOnlyUnmap();
+#if SANITIZER_STACK_DEPOT_PUT_CACHE
+  atomic_fetch_add(&put_cache_generation, 1, memory_order_relaxed);
+#endif
 }
 
 } // namespace __sanitizer
@@ -42,6 +42,8 @@ class StackDepotBase {
 
   // Maps stack trace to an unique id.
   u32 Put(args_type args, bool *inserted = nullptr);
+  // Same as Put, for a valid stack trace whose hash is already computed.
+  u32 PutWithHash(args_type args, hash_type hash, bool *inserted = nullptr);
   // Retrieves a stored stack trace by the id.
   args_type Get(u32 id);
 
@@ -114,11 +116,19 @@ void StackDepotBase<Node, kReservedBits, kTabSizeLog>::unlock(
 template <class Node, int kReservedBits, int kTabSizeLog>
 u32 StackDepotBase<Node, kReservedBits, kTabSizeLog>::Put(args_type args,
                                                           bool *inserted) {
+  if (!LIKELY(Node::is_valid(args))) {
+    if (inserted)
+      *inserted = false;
+    return 0;
+  }
+  return PutWithHash(args, Node::hash(args), inserted);
+}
+
+template <class Node, int kReservedBits, int kTabSizeLog>
+u32 StackDepotBase<Node, kReservedBits, kTabSizeLog>::PutWithHash(
+    args_type args, hash_type h, bool *inserted) {
   if (inserted)
     *inserted = false;
-  if (!LIKELY(Node::is_valid(args)))
-    return 0;
-  hash_type h = Node::hash(args);
   atomic_uint32_t *p = &tab[h % kTabSize];
   u32 v = atomic_load(p, memory_order_consume);
   u32 s = v & kUnlockMask;
@@ -0,0 +1,46 @@
+//===-- sanitizer_sampler_test.cpp ----------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file is a part of *Sanitizer runtime.
+//
+//===----------------------------------------------------------------------===//
+#include "sanitizer_common/sanitizer_sampler.h"
+
+#include "gtest/gtest.h"
+
+namespace __sanitizer {
+
+TEST(SanitizerCommon, RandomIntervalSampler) {
+  const u32 kPeriod = 10;
+  const u32 kEvents = 100000;
+  RandomIntervalSampler sampler = {};
+  EXPECT_FALSE(sampler.Sample(kPeriod, 42));
+
+  u32 num_sampled = 0;
+  u32 distance = 0;
+  for (u32 i = 0; i < kEvents; ++i) {
+    ++distance;
+    if (!sampler.Sample(kPeriod, 42))
+      continue;
+    EXPECT_LE(distance, 2 * kPeriod - 1);
+    distance = 0;
+    ++num_sampled;
+  }
+  // One in kPeriod events is sampled on average.
+  EXPECT_GT(num_sampled, kEvents / kPeriod * 9 / 10);
+  EXPECT_LT(num_sampled, kEvents / kPeriod * 11 / 10);
+}
+
+TEST(SanitizerCommon, RandomIntervalSamplerPeriodOne) {
+  RandomIntervalSampler sampler = {};
+  EXPECT_FALSE(sampler.Sample(1, 0));
+  for (int i = 0; i < 100; ++i)
+    EXPECT_TRUE(sampler.Sample(1, 0));
+}
+
+}  // namespace __sanitizer
@@ -74,6 +74,25 @@ TEST_F(StackDepotTest, Same) {
   EXPECT_EQ(0, internal_memcmp(stack.trace, array, sizeof(array)));
 }
 
+TEST_F(StackDepotTest, SameAfterUnmap) {
+  uptr array[] = {1, 2, 3, 4, 10};
+  StackTrace s1(array, ARRAY_SIZE(array));
+  uptr other[] = {1, 2, 3, 4, 11};
+  StackTrace s2(other, ARRAY_SIZE(other));
+  StackDepotPut(s2);
+  StackDepotPut(s1);
+  StackDepotTestOnlyUnmap();
+
+  // The id of s1 and s2 may be cached, but it is stale after the unmap.
+  u32 i1 = StackDepotPut(s1);
+  EXPECT_EQ(i1, StackDepotPut(s1));
+  StackTrace stack = StackDepotGet(i1);
+  EXPECT_NE(stack.trace, (uptr*)0);
+  EXPECT_EQ(ARRAY_SIZE(array), stack.size);
+  EXPECT_EQ(0, internal_memcmp(stack.trace, array, sizeof(array)));
+  EXPECT_NE(i1, StackDepotPut(s2));
+}
+
 TEST_F(StackDepotTest, Several) {
   uptr array1[] = {1, 2, 3, 4, 7};
   StackTrace s1(array1, ARRAY_SIZE(array1));
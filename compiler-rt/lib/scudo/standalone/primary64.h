@@ -128,9 +128,9 @@ public:
     if (Config::getEnableContiguousRegions()) {
       ReservedMemoryT ReservedMemory = {};
       // Reserve the space required for the Primary.
-      CHECK(ReservedMemory.create(/*Addr=*/0U, RegionSize * NumClasses,
-                                  "scudo:primary_reserve"));
-      const uptr PrimaryBase = ReservedMemory.getBase();
+      uptr PrimaryBase;
+      CHECK(reserveMemory(ReservedMemory, RegionSize * NumClasses,
+                          "scudo:primary_reserve", /*Flags=*/0, &PrimaryBase));
 
       for (uptr I = 0; I < NumClasses; I++) {
         MemMapT RegionMemMap = ReservedMemory.dispatch(
@@ -355,6 +355,7 @@ public:
   void getStats(ScopedString *Str) {
     // TODO(kostyak): get the RSS per region.
     uptr TotalMapped = 0;
+    uptr TotalRetained = 0;
     uptr PoppedBlocks = 0;
     uptr PushedBlocks = 0;
     for (uptr I = 0; I < NumClasses; I++) {
@@ -362,6 +363,7 @@ public:
       {
         ScopedLock L(Region->MMLock);
         TotalMapped += Region->MemMapInfo.MappedUser;
+        TotalRetained += Region->ReleaseInfo.LastRetainedBytes;
       }
       {
         ScopedLock L(Region->FLLock);
@@ -374,6 +376,11 @@ public:
                 "allocations; remains %zu; ReleaseToOsIntervalMs = %d\n",
                 TotalMapped >> 20, 0U, PoppedBlocks,
                 PoppedBlocks - PushedBlocks, IntervalMs >= 0 ? IntervalMs : -1);
+    if (Config::getEnableHugePages()) {
+      Str->append("Stats: SizeClassAllocator64: huge pages of %zuK; %zuK free "
+                  "kept in partially used huge pages\n",
+                  HugePageSize >> 10, TotalRetained >> 10);
+    }
 
     for (uptr I = 0; I < NumClasses; I++) {
       RegionInfo *Region = getRegionInfo(I);
@@ -524,7 +531,18 @@ private:
   static const uptr RegionSize = 1UL << RegionSizeLog;
   static const uptr NumClasses = SizeClassMap::NumClasses;
 
-  static const uptr MapSizeIncrement = Config::getMapSizeIncrement();
+  // The huge page size of x86_64 and of AArch64 with 4K pages.
+  static const uptr HugePageSizeLog = 21U;
+  static const uptr HugePageSize = 1UL << HugePageSizeLog;
+  static_assert(!Config::getEnableHugePages() ||
+                    RegionSizeLog >= HugePageSizeLog,
+                "Regions must hold at least one huge page");
+
+  // With huge pages, user memory is mapped in whole huge pages.
+  static const uptr MapSizeIncrement =
+      Config::getEnableHugePages()
+          ? Max(Config::getMapSizeIncrement(), HugePageSize)
+          : Config::getMapSizeIncrement();
   // Fill at most this number of batches from the newly map'd memory.
   static const u32 MaxNumBatches = SCUDO_ANDROID ? 4U : 8U;
 
@@ -532,6 +550,9 @@ private:
     uptr BytesInFreeListAtLastCheckpoint;
     uptr RangesReleased;
     uptr LastReleasedBytes;
+    // The free bytes that the last release kept mapped because they didn't
+    // span whole huge pages. Only used with huge pages.
+    uptr LastRetainedBytes;
     // The minimum size of pushed blocks to trigger page release.
     uptr TryReleaseThreshold;
     // The number of bytes not triggering `releaseToOSMaybe()` because of
@@ -580,6 +601,30 @@ private:
     return &RegionInfoArray[ClassId];
   }
 
+  // Reserves Size bytes in ReservedMemory and returns their base in Base. With
+  // huge pages, the range is aligned to a huge page and the padding reserved to
+  // align it is unmapped.
+  static bool reserveMemory(ReservedMemoryT &ReservedMemory, uptr Size,
+                            const char *Name, uptr Flags, uptr *Base) {
+    const uptr Padding = Config::getEnableHugePages() ? HugePageSize : 0;
+    if (!ReservedMemory.create(/*Addr=*/0U, Size + Padding, Name, Flags))
+      return false;
+    const uptr ReservedBase = ReservedMemory.getBase();
+    *Base = Padding ? roundUp(ReservedBase, HugePageSize) : ReservedBase;
+    if (*Base != ReservedBase) {
+      MemMapT Head =
+          ReservedMemory.dispatch(ReservedBase, *Base - ReservedBase);
+      Head.unmap();
+    }
+    const uptr ReservedEnd = ReservedBase + ReservedMemory.getCapacity();
+    if (*Base + Size != ReservedEnd) {
+      MemMapT Tail =
+          ReservedMemory.dispatch(*Base + Size, ReservedEnd - (*Base + Size));
+      Tail.unmap();
+    }
+    return true;
+  }
+
   uptr getRegionBaseByClassId(uptr ClassId) {
     RegionInfo *Region = getRegionInfo(ClassId);
     Region->MMLock.assertHeld();
@@ -628,7 +673,8 @@ private:
     Region->MemMapInfo.MemMap = MemMap;
 
     Region->RegionBeg = MemMap.getBase();
-    if (EnableRandomOffset) {
+    // A random offset would misalign the user memory with huge pages.
+    if (EnableRandomOffset && !Config::getEnableHugePages()) {
       Region->RegionBeg +=
           (getRandomModN(&Region->RandState, 16) + 1) * PageSize;
     }
@@ -1025,16 +1071,16 @@ private:
     if (!Config::getEnableContiguousRegions() &&
         !Region->MemMapInfo.MemMap.isAllocated()) {
       ReservedMemoryT ReservedMemory;
-      if (UNLIKELY(!ReservedMemory.create(/*Addr=*/0U, RegionSize,
-                                          "scudo:primary_reserve",
-                                          MAP_ALLOWNOMEM))) {
+      uptr RegionBase;
+      if (UNLIKELY(!reserveMemory(ReservedMemory, RegionSize,
+                                  "scudo:primary_reserve", MAP_ALLOWNOMEM,
+                                  &RegionBase))) {
         Printf("Can't reserve pages for size class %zu.\n",
                getSizeByClassId(ClassId));
         return 0U;
       }
       initRegion(Region, ClassId,
-                 ReservedMemory.dispatch(ReservedMemory.getBase(),
-                                         ReservedMemory.getCapacity()),
+                 ReservedMemory.dispatch(RegionBase, RegionSize),
                  /*EnableRandomOffset=*/false);
     }
 
@@ -1060,7 +1106,8 @@ private:
               RegionBeg + MappedUser, MapSize, "scudo:primary",
               MAP_ALLOWNOMEM | MAP_RESIZABLE |
                   (useMemoryTagging<Config>(Options.load()) ? MAP_MEMTAG
-                                                            : 0)))) {
+                                                            : 0) |
+                  (Config::getEnableHugePages() ? MAP_HUGEPAGE : 0)))) {
         return 0U;
       }
       Region->MemMapInfo.MappedUser += MapSize;
@@ -1317,11 +1364,19 @@ private:
     // ==================================================================== //
     // 4. Release the unused physical pages back to the OS.
     // ==================================================================== //
-    RegionReleaseRecorder<MemMapT> Recorder(&Region->MemMapInfo.MemMap,
-                                            Region->RegionBeg,
-                                            Context.getReleaseOffset());
+    // With huge pages, periodic releases only return whole huge pages, so that
+    // the ones still in use stay backed by huge pages. Forced releases return
+    // every free page.
+    const uptr ReleaseGranularity =
+        Config::getEnableHugePages() && ReleaseType == ReleaseToOS::Normal
+            ? HugePageSize
+            : 0U;
+    RegionReleaseRecorder<MemMapT> Recorder(
+        &Region->MemMapInfo.MemMap, Region->RegionBeg,
+        Context.getReleaseOffset(), ReleaseGranularity);
     auto SkipRegion = [](UNUSED uptr RegionIndex) { return false; };
     releaseFreeMemoryToOS(Context, Recorder, SkipRegion);
+    Region->ReleaseInfo.LastRetainedBytes = Recorder.getRetainedBytes();
     if (Recorder.getReleasedRangesCount() > 0) {
       // This is the case that we didn't hit the release threshold but it has
       // been past a certain period of time. Thus we try to release some pages
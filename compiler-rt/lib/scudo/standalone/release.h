@@ -19,20 +19,40 @@ namespace scudo {
 
 template <typename MemMapT> class RegionReleaseRecorder {
 public:
-  RegionReleaseRecorder(MemMapT *RegionMemMap, uptr Base, uptr Offset = 0)
-      : RegionMemMap(RegionMemMap), Base(Base), Offset(Offset) {}
+  // If `Granularity` is not 0, only the parts of the free ranges that are
+  // aligned to `Granularity` bytes are released, e.g. whole huge pages.
+  RegionReleaseRecorder(MemMapT *RegionMemMap, uptr Base, uptr Offset = 0,
+                        uptr Granularity = 0)
+      : RegionMemMap(RegionMemMap), Base(Base), Offset(Offset),
+        Granularity(Granularity) {}
 
   uptr getReleasedRangesCount() const { return ReleasedRangesCount; }
 
   uptr getReleasedBytes() const { return ReleasedBytes; }
 
+  // Returns the free bytes that were kept because they didn't span a whole
+  // `Granularity` unit.
+  uptr getRetainedBytes() const { return RetainedBytes; }
+
   uptr getBase() const { return Base; }
 
   // Releases [From, To) range of pages back to OS. Note that `From` and `To`
   // are offseted from `Base` + Offset.
   void releasePageRangeToOS(uptr From, uptr To) {
-    const uptr Size = To - From;
-    RegionMemMap->releasePagesToOS(getBase() + Offset + From, Size);
+    uptr Beg = getBase() + Offset + From;
+    uptr End = getBase() + Offset + To;
+    if (Granularity != 0) {
+      const uptr Size = End - Beg;
+      Beg = roundUp(Beg, Granularity);
+      End = roundDown(End, Granularity);
+      if (Beg >= End) {
+        RetainedBytes += Size;
+        return;
+      }
+      RetainedBytes += Size - (End - Beg);
+    }
+    const uptr Size = End - Beg;
+    RegionMemMap->releasePagesToOS(Beg, Size);
     ReleasedRangesCount++;
     ReleasedBytes += Size;
   }
@@ -40,11 +60,13 @@ public:
 private:
   uptr ReleasedRangesCount = 0;
   uptr ReleasedBytes = 0;
+  uptr RetainedBytes = 0;
   MemMapT *RegionMemMap = nullptr;
   uptr Base = 0;
   // The release offset from Base. This is used when we know a given range after
   // Base will not be released.
   uptr Offset = 0;
+  uptr Granularity = 0;
 };
 
 class ReleaseRecorder {
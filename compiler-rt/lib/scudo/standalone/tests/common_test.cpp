@@ -13,6 +13,7 @@
 #include "mem_map.h"
 #include <algorithm>
 #include <fstream>
+#include <thread>
 
 namespace scudo {
 
@@ -72,4 +73,15 @@ TEST(ScudoCommonTest, Zeros) {
   MemMap.unmap();
 }
 
+// Fuchsia doesn't expose the current CPU.
+TEST(ScudoCommonTest, SKIP_ON_FUCHSIA(CurrentCPU)) {
+  const s32 CPU = getCurrentCPU();
+  EXPECT_GE(CPU, 0);
+  // Another thread gets a valid CPU too.
+  s32 OtherCPU = -1;
+  std::thread T([&OtherCPU] { OtherCPU = getCurrentCPU(); });
+  T.join();
+  EXPECT_GE(OtherCPU, 0);
+}
+
 } // namespace scudo
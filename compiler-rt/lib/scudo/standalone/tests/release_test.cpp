@@ -17,6 +17,8 @@
 #include <algorithm>
 #include <random>
 #include <set>
+#include <utility>
+#include <vector>
 
 TEST(ScudoReleaseTest, RegionPageMap) {
   for (scudo::uptr I = 0; I < SCUDO_WORDSIZE; I++) {
@@ -626,6 +628,37 @@ TEST(ScudoReleaseTest, RangeReleaseRegionWithSingleBlock) {
   testReleaseRangeWithSingleBlock<scudo::FuchsiaSizeClassMap>();
 }
 
+class RangesMemMap {
+public:
+  void releasePagesToOS(scudo::uptr From, scudo::uptr Size) {
+    Released.push_back({From, Size});
+  }
+  std::vector<std::pair<scudo::uptr, scudo::uptr>> Released;
+};
+
+TEST(ScudoReleaseTest, RegionReleaseRecorderGranularity) {
+  constexpr scudo::uptr Granularity = 1UL << 21;
+  constexpr scudo::uptr PageSize = 1UL << 12;
+  RangesMemMap MemMap;
+  scudo::RegionReleaseRecorder<RangesMemMap> Recorder(
+      &MemMap, /*Base=*/Granularity, /*Offset=*/0, Granularity);
+
+  // A range not spanning a whole unit is retained.
+  Recorder.releasePageRangeToOS(PageSize, Granularity);
+  EXPECT_TRUE(MemMap.Released.empty());
+  EXPECT_EQ(Recorder.getRetainedBytes(), Granularity - PageSize);
+
+  // Only the aligned units of a range are released.
+  Recorder.releasePageRangeToOS(Granularity - PageSize,
+                                3 * Granularity + PageSize);
+  ASSERT_EQ(MemMap.Released.size(), 1U);
+  EXPECT_EQ(MemMap.Released[0].first, 2 * Granularity);
+  EXPECT_EQ(MemMap.Released[0].second, 2 * Granularity);
+  EXPECT_EQ(Recorder.getReleasedBytes(), 2 * Granularity);
+  EXPECT_EQ(Recorder.getReleasedRangesCount(), 1U);
+  EXPECT_EQ(Recorder.getRetainedBytes(), Granularity + PageSize);
+}
+
 TEST(ScudoReleaseTest, BufferPool) {
   constexpr scudo::uptr StaticBufferCount = SCUDO_WORDSIZE - 1;
   constexpr scudo::uptr StaticBufferNumElements = 512U;
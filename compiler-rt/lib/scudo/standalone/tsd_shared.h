@@ -119,6 +119,9 @@ struct TSDRegistrySharedT {
 
     Str->append("Stats: SharedTSDs: %u available; total %u\n", NumberOfTSDs,
                 TSDsArraySize);
+    Str->append("  %zu contended lookups; %zu moved to the current CPU's TSD\n",
+                atomic_load_relaxed(&NumContendedLookups),
+                atomic_load_relaxed(&NumCPULookups));
     for (uptr I = 0; I < NumberOfTSDs; ++I) {
       TSDs[I].lock();
       // Theoretically, we want to mark TSD::lock()/TSD::unlock() with proper
@@ -202,8 +205,13 @@ private:
 
   NOINLINE void initThread(Allocator *Instance) NO_THREAD_SAFETY_ANALYSIS {
     initOnceMaybe(Instance);
-    // Initial context assignment is done in a plain round-robin fashion.
-    const u32 Index = atomic_fetch_add(&CurrentIndex, 1U, memory_order_relaxed);
+    // Threads start out with the context of the CPU they run on, so that
+    // threads running on different CPUs don't contend. If the CPU is unknown,
+    // the initial context assignment is done in a plain round-robin fashion.
+    const s32 CPU = getCurrentCPU();
+    const u32 Index =
+        CPU >= 0 ? static_cast<u32>(CPU)
+                 : atomic_fetch_add(&CurrentIndex, 1U, memory_order_relaxed);
     setCurrentTSD(&TSDs[Index % NumberOfTSDs]);
     Instance->callPostInitCallback();
   }
@@ -223,7 +231,20 @@ private:
       DCHECK_NE(NumberOfCoPrimes, 0U);
       Inc = CoPrimes[R % NumberOfCoPrimes];
     }
+    atomic_fetch_add(&NumContendedLookups, 1U, memory_order_relaxed);
     if (N > 1U) {
+      // The thread was likely migrated to a CPU whose threads use another
+      // context. Threads only contend for the context of the current CPU if
+      // they were preempted, so try it first.
+      const s32 CPU = getCurrentCPU();
+      if (CPU >= 0) {
+        TSD<Allocator> *CPUTSD = &TSDs[static_cast<u32>(CPU) % N];
+        if (CPUTSD != CurrentTSD && CPUTSD->tryLock()) {
+          atomic_fetch_add(&NumCPULookups, 1U, memory_order_relaxed);
+          setCurrentTSD(CPUTSD);
+          return CPUTSD;
+        }
+      }
       u32 Index = R % N;
       uptr LowestPrecedence = UINTPTR_MAX;
       TSD<Allocator> *CandidateTSD = nullptr;
@@ -255,6 +276,8 @@ private:
   }
 
   atomic_u32 CurrentIndex = {};
+  atomic_uptr NumContendedLookups = {};
+  atomic_uptr NumCPULookups = {};
   u32 NumberOfTSDs GUARDED_BY(MutexTSDs) = 0;
   u32 NumberOfCoPrimes GUARDED_BY(MutexTSDs) = 0;
   u32 CoPrimes[TSDsArraySize] GUARDED_BY(MutexTSDs) = {};
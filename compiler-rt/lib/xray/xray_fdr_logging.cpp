@@ -27,6 +27,7 @@
 #include "sanitizer_common/sanitizer_allocator_internal.h"
 #include "sanitizer_common/sanitizer_atomic.h"
 #include "sanitizer_common/sanitizer_common.h"
+#include "sanitizer_common/sanitizer_sampler.h"
 #include "xray/xray_interface.h"
 #include "xray/xray_records.h"
 #include "xray_allocator.h"
@@ -62,6 +63,13 @@ struct XRAY_TLS_ALIGNAS(64) ThreadLocalData {
   using ControllerStorage = std::byte[sizeof(FDRController<>)];
   alignas(FDRController<>) ControllerStorage CStorage;
   FDRController<> *Controller = nullptr;
+
+  // State for sampling calls. Bit N of SampledFrames is set when the call at
+  // depth N of the call stack is recorded. Calls more than 64 frames deep are
+  // never recorded.
+  uint64_t SampledFrames = 0;
+  uint32_t Depth = 0;
+  RandomIntervalSampler Sampler = {};
 };
 
 } // namespace
@@ -82,6 +90,9 @@ static atomic_uint64_t ThresholdTicks{0};
 // Global for ticks per second.
 static atomic_uint64_t TicksPerSec{0};
 
+// Global sampling period, where 0 records every call.
+static atomic_uint32_t SamplingPeriod{0};
+
 static atomic_sint32_t LogFlushStatus = {
     XRayLogFlushStatus::XRAY_LOG_NOT_FLUSHING};
 
@@ -488,6 +499,48 @@ static bool setupTLD(ThreadLocalData &TLD) XRAY_NEVER_INSTRUMENT {
   return true;
 }
 
+// Returns whether the entry or exit of a call is to be recorded. An exit is
+// recorded iff the entry of the same call was. With a sampling period of N,
+// the distance between two recorded calls is uniformly distributed in
+// [1, 2N - 1], so that one in N calls is recorded on average while the check
+// of most calls is a decrement. The decision for each open call is kept in a
+// 64-bit mask, so calls nested deeper than that are dropped along with their
+// exits, and do not count towards the sampling period.
+static bool shouldRecord(ThreadLocalData &TLD, XRayEntryType Entry,
+                         uint64_t TSC) XRAY_NEVER_INSTRUMENT {
+  uint32_t Period = atomic_load_relaxed(&SamplingPeriod);
+  if (Period <= 1)
+    return true;
+
+  switch (Entry) {
+  case XRayEntryType::ENTRY:
+  case XRayEntryType::LOG_ARGS_ENTRY: {
+    uint32_t Depth = TLD.Depth++;
+    if (Depth >= 64)
+      return false;
+    bool Sampled =
+        TLD.Sampler.Sample(Period, static_cast<uint32_t>(TSC ^ (TSC >> 32)));
+    if (Sampled)
+      TLD.SampledFrames |= uint64_t{1} << Depth;
+    else
+      TLD.SampledFrames &= ~(uint64_t{1} << Depth);
+    return Sampled;
+  }
+  case XRayEntryType::EXIT:
+  case XRayEntryType::TAIL: {
+    // Drop the exits of calls entered before logging started.
+    if (TLD.Depth == 0)
+      return false;
+    uint32_t Depth = --TLD.Depth;
+    return Depth < 64 && (TLD.SampledFrames >> Depth) & 1;
+  }
+  case XRayEntryType::CUSTOM_EVENT:
+  case XRayEntryType::TYPED_EVENT:
+    break;
+  }
+  return true;
+}
+
 void fdrLoggingHandleArg0(int32_t FuncId,
                           XRayEntryType Entry) XRAY_NEVER_INSTRUMENT {
   auto TC = getTimestamp();
@@ -498,7 +551,7 @@ void fdrLoggingHandleArg0(int32_t FuncId,
     return;
 
   auto &TLD = getThreadLocalData();
-  if (!setupTLD(TLD))
+  if (!shouldRecord(TLD, Entry, TSC) || !setupTLD(TLD))
     return;
 
   switch (Entry) {
@@ -528,7 +581,7 @@ void fdrLoggingHandleArg1(int32_t FuncId, XRayEntryType Entry,
     return;
 
   auto &TLD = getThreadLocalData();
-  if (!setupTLD(TLD))
+  if (!shouldRecord(TLD, Entry, TSC) || !setupTLD(TLD))
     return;
 
   switch (Entry) {
@@ -698,6 +751,9 @@ XRayLogInitStatus fdrLoggingInit(size_t, size_t, void *Options,
             });
       });
 
+  atomic_store(&SamplingPeriod,
+               static_cast<u32>(Max(fdrFlags()->sampling_period, 0)),
+               memory_order_release);
   atomic_store(&ThresholdTicks,
                atomic_load_relaxed(&TicksPerSec) *
                    fdrFlags()->func_duration_threshold_us / 1000000,
@@ -0,0 +1,26 @@
+// Check that only a sample of the allocations is profiled when
+// allocation_sampling_period is set, and that the access counts of the
+// sampled allocations are still exact.
+
+// RUN: %clangxx_memprof -O0 %s -o %t
+// RUN: %env_memprof_opts=print_text=true:log_path=stderr:allocation_sampling_period=100 %run %t 2>&1 | FileCheck %s
+// RUN: %env_memprof_opts=print_text=true:log_path=stderr %run %t 2>&1 | FileCheck %s --check-prefix=ALL
+
+// About 100 of the 10000 allocations are sampled.
+// CHECK: alloc_count {{[0-9][0-9]}}{{[0-9]?}}, size (ave/min/max) 40.00 / 40 / 40
+// CHECK-NEXT: access_count (ave/min/max): 10.00 / 10 / 10
+
+// ALL: alloc_count 10000, size (ave/min/max) 40.00 / 40 / 40
+// ALL-NEXT: access_count (ave/min/max): 10.00 / 10 / 10
+
+#include <stdlib.h>
+
+int main() {
+  for (int i = 0; i < 10000; ++i) {
+    int *p = (int *)malloc(10 * sizeof(int));
+    for (int j = 0; j < 10; ++j)
+      p[j] = j;
+    free(p);
+  }
+  return 0;
+}
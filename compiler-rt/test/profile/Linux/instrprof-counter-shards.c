@@ -0,0 +1,80 @@
+// RUN: %clang_profgen -O2 -pthread -mllvm -instrprof-counter-shards=8 -c \
+// RUN:   -o %t.o %s
+// RUN: %clang_profgen -O2 -DUNSHARDED -c -o %t.unsharded.o %s
+// RUN: %clang_profgen -O2 -mllvm -instrprof-counter-shards=2 -DTWO_SHARDS -c \
+// RUN:   -o %t.two.o %s
+// RUN: %clang_profgen -O2 -pthread -o %t %t.o %t.unsharded.o %t.two.o
+// RUN: %clang_profgen -O2 -mllvm -instrprof-counter-shards=8 -S -emit-llvm \
+// RUN:   -o - %s | FileCheck %s --check-prefix=IR
+// RUN: env LLVM_PROFILE_FILE=%t.profraw %run %t
+// RUN: llvm-profdata merge -o %t.profdata %t.profraw
+// RUN: llvm-profdata show --counts --function=work %t.profdata | FileCheck %s
+// RUN: llvm-profdata show --counts --function=unsharded %t.profdata \
+// RUN:   | FileCheck %s --check-prefix=UNSHARDED
+// RUN: llvm-profdata show --counts --function=two_shards %t.profdata \
+// RUN:   | FileCheck %s --check-prefix=TWO
+
+// Each shard of a function's counters starts on a new cache line, and the
+// counters are updated in a shard picked from the address of a TLS variable.
+// Each function records its number of shards next to its profile data.
+// IR-DAG: @__profc_work = {{.*}}global [64 x i64] zeroinitializer, {{.*}}align 64
+// IR-DAG: @__profsh_work = private constant {{.*}}@__profd_work{{.*}} 8 }, section "__llvm_prf_shrd", comdat($__profc_work)
+// IR-DAG: @__profc_shard_anchor = internal thread_local(initialexec) global i8 0
+
+#include <pthread.h>
+
+#define NUM_THREADS 4
+#define NUM_CALLS 100000
+
+volatile int Sink;
+
+#if defined(UNSHARDED)
+// Counters without shards are written as they are.
+__attribute__((noinline)) void unsharded(int I) {
+  if (I % 2 == 0)
+    Sink = I;
+}
+#elif defined(TWO_SHARDS)
+// Counters with a different number of shards are folded with that number.
+__attribute__((noinline)) void two_shards(int I) {
+  if (I % 2 == 0)
+    Sink = I;
+}
+#else
+void unsharded(int I);
+void two_shards(int I);
+
+__attribute__((noinline)) void work(int I) {
+  if (I % 4 == 0)
+    Sink = I;
+}
+
+void *run(void *Arg) {
+  for (int I = 0; I < NUM_CALLS; ++I)
+    work(I);
+  return 0;
+}
+
+int main() {
+  pthread_t Threads[NUM_THREADS];
+  for (int I = 0; I < NUM_THREADS; ++I)
+    pthread_create(&Threads[I], 0, run, 0);
+  for (int I = 0; I < NUM_THREADS; ++I)
+    pthread_join(Threads[I], 0);
+  for (int I = 0; I < 10; ++I) {
+    unsharded(I);
+    two_shards(I);
+  }
+  return 0;
+}
+#endif
+
+// The counts of all threads are added up, whichever shards they used.
+// CHECK: Function count: 400000
+// CHECK: Block counts: [100000]
+
+// UNSHARDED: Function count: 10
+// UNSHARDED: Block counts: [5]
+
+// TWO: Function count: 10
+// TWO: Block counts: [5]
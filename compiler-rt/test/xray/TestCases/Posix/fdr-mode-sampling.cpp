@@ -0,0 +1,45 @@
+// RUN: %clangxx_xray -g -std=c++11 %s -o %t -fxray-modes=xray-fdr
+// RUN: rm -f fdr-sampling-test-*
+// RUN: XRAY_OPTIONS="patch_premain=false xray_logfile_base=fdr-sampling-test- \
+// RUN:     verbosity=1" \
+// RUN: XRAY_FDR_OPTIONS="no_file_flush=true func_duration_threshold_us=0" \
+// RUN:     %run %t 2>&1 | FileCheck %s
+// RUN: rm -f fdr-sampling-test-*
+//
+// REQUIRES: built-in-llvm-tree
+
+#include "xray/xray_log_interface.h"
+#include <cassert>
+#include <iostream>
+
+uint64_t var = 0;
+uint64_t buffers = 0;
+[[clang::xray_always_instrument]] void __attribute__((noinline)) f() { ++var; }
+
+int main(int argc, char *argv[]) {
+  assert(__xray_log_select_mode("xray-fdr") ==
+         XRayLogRegisterStatus::XRAY_REGISTRATION_OK);
+  auto status = __xray_log_init_mode(
+      "xray-fdr", "buffer_size=4096:buffer_max=100:func_duration_threshold_us="
+                  "0:sampling_period=4096");
+  assert(status == XRayLogInitStatus::XRAY_LOG_INITIALIZED);
+  __xray_patch();
+
+  // Recording every call would fill all 100 buffers, while the about 256
+  // sampled calls fit in a few of them. How many calls are sampled is random,
+  // so only check that something was recorded and that most calls were not.
+  for (int i = 0; i != 1 << 20; ++i) {
+    f();
+  }
+
+  auto finalize_status = __xray_log_finalize();
+  assert(finalize_status == XRayLogInitStatus::XRAY_LOG_FINALIZED);
+  auto process_status =
+      __xray_log_process_buffers([](const char *, XRayBuffer) { ++buffers; });
+  assert(process_status == XRayLogFlushStatus::XRAY_LOG_FLUSHED);
+  auto flush_status = __xray_log_flushLog();
+  assert(flush_status == XRayLogFlushStatus::XRAY_LOG_FLUSHED);
+  // CHECK: Sampled = 1
+  std::cout << "Sampled = " << (buffers >= 1 && buffers < 11) << std::endl;
+  return 0;
+}
@@ -27,6 +27,8 @@
 #include "flang/Runtime/cpp-type.h"
 #include "flang/Runtime/descriptor.h"
 #include <algorithm>
+#include <type_traits>
+#include <utility>
 
 namespace Fortran::runtime {
 
@@ -37,6 +39,19 @@ namespace Fortran::runtime {
 // AccumulateAt() member function that applies supplied subscripts to the
 // array and does something with a scalar element, and a GetResult()
 // member function that copies a final result into its destination.
+// An accumulator may also define AccumulateContiguous(), which takes a
+// pointer to a contiguous run of elements and their number; it is then used
+// for total reductions of contiguous arrays without MASK=, so that those loops
+// can be vectorized.
+
+template <typename ACCUMULATOR, typename TYPE, typename = void>
+struct HasAccumulateContiguous : std::false_type {};
+template <typename ACCUMULATOR, typename TYPE>
+struct HasAccumulateContiguous<ACCUMULATOR, TYPE,
+    std::void_t<decltype(std::declval<ACCUMULATOR &>()
+            .template AccumulateContiguous<TYPE>(
+                std::declval<const TYPE *>(), std::size_t{0}))>>
+    : std::true_type {};
 
 // Total reduction of the array argument to a scalar (or to a vector in the
 // cases of FINDLOC, MAXLOC, & MINLOC).  These are the cases without DIM= or
@@ -71,6 +86,13 @@ inline RT_API_ATTRS void DoTotalReduction(const Descriptor &x, int dim,
     }
   }
   // No MASK=, or scalar MASK=.TRUE.
+  if constexpr (HasAccumulateContiguous<ACCUMULATOR, TYPE>::value) {
+    if (x.IsContiguous()) {
+      accumulator.template AccumulateContiguous<TYPE>(
+          x.OffsetElement<TYPE>(), x.Elements());
+      return;
+    }
+  }
   for (auto elements{x.Elements()}; elements--; x.IncrementSubscripts(xAt)) {
     if (!accumulator.template AccumulateAt<TYPE>(xAt)) {
       break; // cut short, result is known
@@ -18,6 +18,7 @@
 #include <cfloat>
 #include <cinttypes>
 #include <complex>
+#include <cstddef>
 
 namespace Fortran::runtime {
 
@@ -35,6 +36,14 @@ public:
     sum_ += *array_.Element<A>(at);
     return true;
   }
+  template <typename A>
+  RT_API_ATTRS void AccumulateContiguous(const A *p, std::size_t n) {
+    INTERMEDIATE sum{sum_};
+    for (std::size_t j{0}; j < n; ++j) {
+      sum += p[j];
+    }
+    sum_ = sum;
+  }
 
 private:
   const Descriptor &array_;
@@ -53,7 +62,7 @@ public:
   }
   template <typename A> RT_API_ATTRS bool Accumulate(A x) {
     // Kahan summation
-    auto next{x + correction_};
+    auto next{x - correction_};
     auto oldSum{sum_};
     sum_ += next;
     correction_ = (sum_ - oldSum) - next; // algebraically zero
@@ -63,6 +72,32 @@ public:
   RT_API_ATTRS bool AccumulateAt(const SubscriptValue at[]) {
     return Accumulate(*array_.Element<A>(at));
   }
+  template <typename A>
+  RT_API_ATTRS void AccumulateContiguous(const A *p, std::size_t n) {
+    // Each lane is an independent Kahan summation of every lanes-th element,
+    // which removes the dependence of each addition on the previous one and
+    // lets the loop be vectorized.  The lanes are folded in at the end.
+    constexpr std::size_t lanes{8};
+    std::size_t j{0};
+    if (n >= 2 * lanes) {
+      INTERMEDIATE sum[lanes]{}, correction[lanes]{};
+      for (; j + lanes <= n; j += lanes) {
+        for (std::size_t k{0}; k < lanes; ++k) {
+          auto next{p[j + k] - correction[k]};
+          auto oldSum{sum[k]};
+          sum[k] += next;
+          correction[k] = (sum[k] - oldSum) - next;
+        }
+      }
+      for (std::size_t k{0}; k < lanes; ++k) {
+        Accumulate(sum[k]);
+        Accumulate(-correction[k]);
+      }
+    }
+    for (; j < n; ++j) {
+      Accumulate(p[j]);
+    }
+  }
 
 private:
   const Descriptor &array_;
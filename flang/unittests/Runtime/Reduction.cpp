@@ -36,6 +36,45 @@ TEST(Reductions, Int4Ops) {
   EXPECT_EQ(eor, 7) << eor;
 }
 
+TEST(Reductions, SumContiguousAndStrided) {
+  // 1.0 followed by many values each of which is too small to change it on
+  // its own.  Compensated summation has to recover their total both on the
+  // path for contiguous arrays and on the general path for a strided one.
+  constexpr int n{20003};
+  std::vector<float> data(2 * n, 1.0e3f);
+  std::vector<std::int32_t> ints(2 * n);
+  for (int j{0}; j < 2 * n; ++j) {
+    ints[j] = j;
+  }
+  for (int j{0}; j < n; ++j) {
+    data[2 * j] = j == 0 ? 1.0f : 1.0e-8f;
+  }
+  std::vector<float> contiguousData;
+  std::vector<std::int32_t> contiguousInts;
+  for (int j{0}; j < n; ++j) {
+    contiguousData.push_back(data[2 * j]);
+    contiguousInts.push_back(ints[2 * j]);
+  }
+  const float expect{1.0f + (n - 1) * 1.0e-8f};
+  const std::int32_t intExpect{static_cast<std::int32_t>(n) * (n - 1)};
+
+  auto contiguous{MakeArray<TypeCategory::Real, 4>(
+      std::vector<int>{n}, contiguousData)};
+  EXPECT_NEAR(RTNAME(SumReal4)(*contiguous, __FILE__, __LINE__), expect, 1e-6);
+  auto strided{MakeArray<TypeCategory::Real, 4>(std::vector<int>{2 * n}, data)};
+  strided->GetDimension(0).SetExtent(n).SetByteStride(2 * sizeof(float));
+  EXPECT_NEAR(RTNAME(SumReal4)(*strided, __FILE__, __LINE__), expect, 1e-6);
+
+  auto contiguousInt{MakeArray<TypeCategory::Integer, 4>(
+      std::vector<int>{n}, contiguousInts)};
+  EXPECT_EQ(RTNAME(SumInteger4)(*contiguousInt, __FILE__, __LINE__), intExpect);
+  auto stridedInt{
+      MakeArray<TypeCategory::Integer, 4>(std::vector<int>{2 * n}, ints)};
+  stridedInt->GetDimension(0).SetExtent(n).SetByteStride(
+      2 * sizeof(std::int32_t));
+  EXPECT_EQ(RTNAME(SumInteger4)(*stridedInt, __FILE__, __LINE__), intExpect);
+}
+
 TEST(Reductions, DimMaskProductInt4) {
   std::vector<int> shape{2, 3};
   auto array{MakeArray<TypeCategory::Integer, 4>(
@@ -43,6 +43,13 @@ static cl::opt<std::string>
     SizeDistributionName("size-distribution-name",
                          cl::desc("The name of the distribution to use"));
 
+static cl::opt<std::string> SizeDistributionFile(
+    "size-distribution-file",
+    cl::desc("A file holding the size distribution to use, in the format of "
+             "the files in the distributions directory. The distribution is "
+             "named after the file unless --size-distribution-name is set"),
+    cl::value_desc("filename"));
+
 static cl::opt<bool> SweepMode(
     "sweep-mode",
     cl::desc(
@@ -261,16 +268,34 @@ void main() {
                        Twine(" must be a power of two or zero"));
 
   const bool HasDistributionName = !SizeDistributionName.empty();
-  if (SweepMode && HasDistributionName)
+  const bool HasDistributionFile = !SizeDistributionFile.empty();
+  if (SweepMode && (HasDistributionName || HasDistributionFile))
     report_fatal_error("Select only one of `--" + Twine(SweepMode.ArgStr) +
-                       "` or `--" + Twine(SizeDistributionName.ArgStr) + "`");
+                       "` or `--" + Twine(SizeDistributionName.ArgStr) +
+                       "` / `--" + Twine(SizeDistributionFile.ArgStr) + "`");
 
   std::unique_ptr<MemfunctionBenchmarkBase> Benchmark;
-  if (SweepMode)
+  std::vector<double> FileProbabilities;
+  if (SweepMode) {
     Benchmark.reset(new MemfunctionBenchmarkSweep());
-  else
+  } else if (HasDistributionFile) {
+    auto BufferOrErr = MemoryBuffer::getFile(SizeDistributionFile);
+    if (!BufferOrErr)
+      report_fatal_error(Twine("Could not open file: ")
+                             .concat(BufferOrErr.getError().message())
+                             .concat(", ")
+                             .concat(SizeDistributionFile));
+    StringRef Name =
+        HasDistributionName ? SizeDistributionName : SizeDistributionFile;
+    auto DistributionOrErr = parseSizeDistribution(
+        Name, (*BufferOrErr)->getBuffer(), FileProbabilities);
+    if (!DistributionOrErr)
+      report_fatal_error(DistributionOrErr.takeError());
+    Benchmark.reset(new MemfunctionBenchmarkDistribution(*DistributionOrErr));
+  } else {
     Benchmark.reset(new MemfunctionBenchmarkDistribution(getDistributionOrDie(
         BenchmarkSetup::getDistributions(), SizeDistributionName)));
+  }
   writeStudy(Benchmark->run());
 }
 
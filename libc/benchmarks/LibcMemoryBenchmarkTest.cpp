@@ -7,6 +7,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "LibcMemoryBenchmark.h"
+#include "MemorySizeDistributions.h"
 #include "llvm/Support/Alignment.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -102,6 +103,23 @@ TEST(MismatchOffsetDistribution, MismatchAt2) {
   }
 }
 
+TEST(ParseSizeDistribution, Normalizes) {
+  std::vector<double> Storage;
+  auto MSD = parseSizeDistribution("Sampled", "0, 1,\n3 ,0\n", Storage);
+  ASSERT_TRUE(bool(MSD));
+  EXPECT_EQ(MSD->Name, "Sampled");
+  EXPECT_THAT(MSD->Probabilities, ElementsAre(0, 0.25, 0.75, 0));
+}
+
+TEST(ParseSizeDistribution, RejectsInvalid) {
+  std::vector<double> Storage;
+  for (StringRef Text : {"", "0,0", "0.5,abc", "0.5,-1"}) {
+    auto MSD = parseSizeDistribution("Invalid", Text, Storage);
+    EXPECT_FALSE(bool(MSD)) << Text.str();
+    consumeError(MSD.takeError());
+  }
+}
+
 } // namespace
 } // namespace libc_benchmarks
 } // namespace llvm
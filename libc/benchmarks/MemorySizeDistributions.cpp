@@ -1,5 +1,6 @@
 #include "MemorySizeDistributions.h"
 
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/raw_ostream.h"
 
@@ -200,5 +201,27 @@ getDistributionOrDie(ArrayRef<MemorySizeDistribution> Distributions,
   report_fatal_error(Message);
 }
 
+Expected<MemorySizeDistribution>
+parseSizeDistribution(StringRef Name, StringRef Text,
+                      std::vector<double> &Storage) {
+  Storage.clear();
+  SmallVector<StringRef, 0> Fields;
+  Text.trim().split(Fields, ',');
+  double Total = 0;
+  for (StringRef Field : Fields) {
+    double Probability;
+    if (Field.trim().getAsDouble(Probability) || Probability < 0)
+      return createStringError("invalid probability '" + Field.trim() +
+                               "' for size " + Twine(Storage.size()));
+    Storage.push_back(Probability);
+    Total += Probability;
+  }
+  if (Total <= 0)
+    return createStringError("size distribution '" + Name + "' is empty");
+  for (double &Probability : Storage)
+    Probability /= Total;
+  return MemorySizeDistribution{Name, Storage};
+}
+
 } // namespace libc_benchmarks
 } // namespace llvm
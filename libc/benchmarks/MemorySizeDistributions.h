@@ -18,6 +18,9 @@
 
 #include <llvm/ADT/ArrayRef.h>
 #include <llvm/ADT/StringRef.h>
+#include <llvm/Support/Error.h>
+
+#include <vector>
 
 namespace llvm {
 namespace libc_benchmarks {
@@ -47,6 +50,15 @@ MemorySizeDistribution
 getDistributionOrDie(ArrayRef<MemorySizeDistribution> Distributions,
                      StringRef Name);
 
+/// Parses a MemorySizeDistribution from Text, which uses the format of the
+/// files in the distributions directory: comma separated probabilities indexed
+/// by size. The probabilities are normalized and stored in Storage, which must
+/// outlive the returned distribution. This allows benchmarking with size
+/// distributions sampled from other applications.
+Expected<MemorySizeDistribution>
+parseSizeDistribution(StringRef Name, StringRef Text,
+                      std::vector<double> &Storage);
+
 } // namespace libc_benchmarks
 } // namespace llvm
 
@@ -24,6 +24,14 @@
 #  include <dirent.h> // for DIR & friends
 #endif
 
+// Where the `openat()` family of POSIX functions is available, subdirectories
+// are opened and entries of unknown type are stat'ed relative to the file
+// descriptor of the directory being iterated. This saves the kernel from
+// resolving every component of the full path again for each entry.
+#if !defined(_LIBCPP_WIN32API) && !defined(__MVS__)
+#  define DIRECTORY_ITERATOR_USE_AT_FUNCTIONS
+#endif
+
 _LIBCPP_BEGIN_NAMESPACE_FILESYSTEM
 
 using detail::ErrorHandler;
@@ -57,6 +65,9 @@ public:
       advance(ec);
   }
 
+  __dir_stream(const __dir_stream&, const path& root, directory_options opts, error_code& ec)
+      : __dir_stream(root, opts, ec) {}
+
   ~__dir_stream() noexcept {
     if (__stream_ == INVALID_HANDLE_VALUE)
       return;
@@ -116,10 +127,29 @@ public:
 
   __dir_stream(const path& root, directory_options opts, error_code& ec) : __stream_(nullptr), __root_(root) {
     if ((__stream_ = ::opendir(root.c_str())) == nullptr) {
-      ec                      = detail::capture_errno();
-      const bool allow_eacces = bool(opts & directory_options::skip_permission_denied);
-      if (allow_eacces && ec.value() == EACCES)
-        ec.clear();
+      open_failed(opts, ec);
+      return;
+    }
+    advance(ec);
+  }
+
+  // Opens the directory `root`, which names the current entry of `parent`.
+  __dir_stream(const __dir_stream& parent, const path& root, directory_options opts, error_code& ec)
+      : __stream_(nullptr), __root_(root) {
+#  if defined(DIRECTORY_ITERATOR_USE_AT_FUNCTIONS)
+    const int options = O_CLOEXEC | O_RDONLY | O_DIRECTORY;
+    int fd            = ::openat(::dirfd(parent.__stream_), root.filename().c_str(), options);
+    if (fd != -1 && (__stream_ = ::fdopendir(fd)) == nullptr) {
+      int saved_errno = errno;
+      ::close(fd);
+      errno = saved_errno;
+    }
+#  else
+    (void)parent;
+    __stream_ = ::opendir(root.c_str());
+#  endif
+    if (__stream_ == nullptr) {
+      open_failed(opts, ec);
       return;
     }
     advance(ec);
@@ -142,13 +172,49 @@ public:
         close();
         return false;
       } else {
-        __entry_.__assign_iter_entry(__root_ / str, directory_entry::__create_iter_result(str_type_pair.second));
+        path entry_path = __root_ / str;
+        auto data       = make_iter_result(entry_path, str, str_type_pair.second);
+        __entry_.__assign_iter_entry(std::move(entry_path), data);
         return true;
       }
     }
   }
 
 private:
+  void open_failed(directory_options opts, error_code& ec) {
+    ec                      = detail::capture_errno();
+    const bool allow_eacces = bool(opts & directory_options::skip_permission_denied);
+    if (allow_eacces && ec.value() == EACCES)
+      ec.clear();
+  }
+
+  directory_entry::__cached_data make_iter_result(const path& entry_path, string_view name, file_type type) {
+#  if defined(DIRECTORY_ITERATOR_USE_AT_FUNCTIONS)
+    // The filesystem doesn't report the type of its entries. Stat the entry
+    // relative to the directory now, and cache everything the result tells us,
+    // rather than making the directory_entry stat the full path on each query.
+    // `name` comes from a dirent, so it is null terminated. The attributes of
+    // a symlink are those of its target, so only its type is cached, as if
+    // the filesystem had reported it.
+    detail::StatT st;
+    if (type == file_type::none && ::fstatat(::dirfd(__stream_), name.data(), &st, AT_SYMLINK_NOFOLLOW) == 0) {
+      if (S_ISLNK(st.st_mode))
+        return directory_entry::__create_iter_result(file_type::symlink);
+      error_code ignored_ec;
+      file_status status = detail::create_file_status(ignored_ec, entry_path, st, nullptr);
+      uintmax_t size     = static_cast<uintmax_t>(-1);
+      if (filesystem::is_regular_file(status))
+        size = static_cast<uintmax_t>(st.st_size);
+      return directory_entry::__create_iter_cached_result(
+          status.type(), size, status.permissions(), detail::__extract_last_write_time(entry_path, st, &ignored_ec));
+    }
+#  else
+    (void)entry_path;
+    (void)name;
+#  endif
+    return directory_entry::__create_iter_result(type);
+  }
+
   error_code close() noexcept {
     error_code m_ec;
     if (::closedir(__stream_) == -1)
@@ -299,7 +365,7 @@ bool recursive_directory_iterator::__try_recursion(error_code* ec) {
   }
 
   if (!skip_rec) {
-    __dir_stream new_it(curr_it.__entry_.path(), __imp_->__options_, m_ec);
+    __dir_stream new_it(curr_it, curr_it.__entry_.path(), __imp_->__options_, m_ec);
     if (new_it.good()) {
       __imp_->__stack_.push(std::move(new_it));
       return true;
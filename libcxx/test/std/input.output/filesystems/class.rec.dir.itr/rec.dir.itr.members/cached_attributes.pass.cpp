@@ -0,0 +1,91 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// REQUIRES: can-create-symlinks
+// UNSUPPORTED: c++03, c++11, c++14
+// UNSUPPORTED: no-filesystem
+// UNSUPPORTED: availability-filesystem-missing
+
+// <filesystem>
+
+// class recursive_directory_iterator
+
+// Check that the directory_entry values produced while walking a tree report
+// the same attributes as querying each path directly, at every depth, and
+// that directory symlinks are only followed when asked to. The attributes of a
+// symlink to a file are those of its target. On filesystems that don't report
+// entry types, the iterator gets the attributes itself and caches them.
+
+#include <filesystem>
+#include <cassert>
+#include <chrono>
+#include <iterator>
+#include <set>
+
+#include "test_macros.h"
+#include "filesystem_test_helper.h"
+namespace fs = std::filesystem;
+using namespace fs;
+
+static void check_entry(const directory_entry& e) {
+  const path p = e.path();
+  assert(e.exists());
+  assert(e.is_symlink() == is_symlink(symlink_status(p)));
+  assert(e.is_directory() == is_directory(status(p)));
+  assert(e.is_regular_file() == is_regular_file(status(p)));
+  if (e.is_regular_file()) {
+    assert(e.file_size() == file_size(p));
+    assert(e.last_write_time() == last_write_time(p));
+  }
+}
+
+static std::set<path> walk(const path& root, directory_options opts) {
+  std::set<path> seen;
+  std::error_code ec;
+  recursive_directory_iterator it(root, opts, ec);
+  assert(!ec);
+  for (; it != recursive_directory_iterator(); it.increment(ec)) {
+    assert(!ec);
+    check_entry(*it);
+    const path rel = it->path().lexically_relative(root);
+    assert(it.depth() == static_cast<int>(std::distance(rel.begin(), rel.end())) - 1);
+    seen.insert(it->path());
+  }
+  assert(!ec);
+  return seen;
+}
+
+int main(int, char**) {
+  scoped_test_env env;
+  const path root = env.create_dir("root");
+  const path a    = env.create_dir("root/a");
+  const path b    = env.create_dir("root/a/b");
+  const path c    = env.create_dir("root/a/b/c");
+  const path f1   = env.create_file("root/f1", 42);
+  const path f2   = env.create_file("root/a/f2", 1);
+  const path f3   = env.create_file("root/a/b/f3", 100);
+  const path f4   = env.create_file("root/a/b/c/f4", 7);
+  env.create_dir("other");
+  env.create_file("other/f5", 3);
+  const path link = env.create_directory_symlink("other", "root/a/link");
+  const path target = env.create_file("other/f6", 12);
+  const path flink  = env.create_symlink("other/f6", "root/a/b/flink");
+  // Give the target a modification time that the symlink itself can't have.
+  last_write_time(target, last_write_time(target) - std::chrono::hours(24));
+
+  {
+    std::set<path> expect = {a, b, c, f1, f2, f3, f4, link, flink};
+    assert(walk(root, directory_options::none) == expect);
+  }
+  {
+    std::set<path> expect = {a, b, c, f1, f2, f3, f4, link, flink, link / "f5", link / "f6"};
+    assert(walk(root, directory_options::follow_directory_symlink) == expect);
+  }
+
+  return 0;
+}
@@ -192,6 +192,11 @@ struct Configuration {
   // Used for /lldltocachepolicy=policy
   llvm::CachePruningPolicy ltoCachePolicy;
 
+  // Used for /lldghashcache=path
+  StringRef ghashCache;
+  // Used for /lldghashcachepolicy=policy
+  llvm::CachePruningPolicy ghashCachePolicy;
+
   // Used for /opt:[no]ltodebugpassmanager
   bool ltoDebugPassManager = false;
 
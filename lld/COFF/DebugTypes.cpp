@@ -26,10 +26,13 @@
 #include "llvm/DebugInfo/PDB/Native/PDBFile.h"
 #include "llvm/DebugInfo/PDB/Native/TpiHashing.h"
 #include "llvm/DebugInfo/PDB/Native/TpiStream.h"
+#include "llvm/Support/CachePruning.h"
+#include "llvm/Support/Caching.h"
 #include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/TimeProfiler.h"
+#include "llvm/Support/xxhash.h"
 
 using namespace llvm;
 using namespace llvm::codeview;
@@ -609,6 +612,58 @@ void TpiSource::assignGHashesFromVector(
   ownedGHashes = true;
 }
 
+namespace {
+// The header of a /lldghashcache: entry. It is followed by `count` global
+// hashes and then by one bit per type record, set for item (IPI) records.
+struct GHashCacheHeader {
+  char magic[4];
+  support::ulittle32_t count;
+};
+} // namespace
+
+static constexpr char ghashCacheMagic[4] = {'L', 'G', 'H', '1'};
+
+bool TpiSource::loadGHashesFromCache(ArrayRef<uint8_t> entry) {
+  if (entry.size() < sizeof(GHashCacheHeader))
+    return false;
+  const auto *header = reinterpret_cast<const GHashCacheHeader *>(entry.data());
+  uint32_t count = header->count;
+  if (memcmp(header->magic, ghashCacheMagic, sizeof(ghashCacheMagic)) != 0 ||
+      entry.size() != sizeof(GHashCacheHeader) +
+                          uint64_t(count) * sizeof(GloballyHashedType) +
+                          divideCeil(count, 8))
+    return false;
+  entry = entry.drop_front(sizeof(GHashCacheHeader));
+
+  if (count) {
+    GloballyHashedType *hashes = new GloballyHashedType[count];
+    memcpy(hashes, entry.data(), count * sizeof(GloballyHashedType));
+    ghashes = ArrayRef(hashes, count);
+    ownedGHashes = true;
+  }
+
+  ArrayRef<uint8_t> bits = entry.drop_front(count * sizeof(GloballyHashedType));
+  isItemIndex.resize(count);
+  for (uint32_t i = 0; i != count; ++i)
+    if (bits[i / 8] & (1 << (i % 8)))
+      isItemIndex.set(i);
+  return true;
+}
+
+void TpiSource::writeGHashesToCache(raw_ostream &os) const {
+  GHashCacheHeader header;
+  memcpy(header.magic, ghashCacheMagic, sizeof(ghashCacheMagic));
+  header.count = ghashes.size();
+  os.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  os.write(reinterpret_cast<const char *>(ghashes.data()),
+           ghashes.size() * sizeof(GloballyHashedType));
+
+  SmallVector<uint8_t, 0> bits(divideCeil(ghashes.size(), 8));
+  for (unsigned i : isItemIndex.set_bits())
+    bits[i / 8] |= 1 << (i % 8);
+  os.write(reinterpret_cast<const char *>(bits.data()), bits.size());
+}
+
 // Faster way to iterate type records. forEachTypeChecked is faster than
 // iterating CVTypeArray. It avoids virtual readBytes calls in inner loops.
 static void forEachTypeChecked(ArrayRef<uint8_t> types,
@@ -1073,8 +1128,11 @@ void TypeMerger::mergeTypesWithGHash() {
     ScopedTimer t1(ctx.loadGHashTimer);
     parallelForEach(dependencySources,
                     [&](TpiSource *source) { source->loadGHashes(); });
-    parallelForEach(objectSources,
-                    [&](TpiSource *source) { source->loadGHashes(); });
+    if (ctx.config.ghashCache.empty())
+      parallelForEach(objectSources,
+                      [&](TpiSource *source) { source->loadGHashes(); });
+    else
+      loadGHashesWithCache();
   }
 
   llvm::TimeTraceScope timeScope("Merge types (GHASH)");
@@ -1187,6 +1245,67 @@ void TypeMerger::mergeTypesWithGHash() {
   clearGHashes();
 }
 
+// Objects without .debug$H need every type record hashed, which dominates
+// ghash loading for /Z7 builds. With /lldghashcache:, key such objects by the
+// content of their .debug$T and reuse the hashes computed by an earlier link.
+// Type indices in the PDB depend on every input, so only the per-object hashes
+// are cached; remapping type indices still runs on every link.
+void TypeMerger::loadGHashesWithCache() {
+  std::vector<std::unique_ptr<MemoryBuffer>> entries(ctx.tpiSourceList.size());
+  FileCache cache = check(localCache(
+      "GHash", "GHash", ctx.config.ghashCache,
+      [&](size_t task, const Twine &moduleName,
+          std::unique_ptr<MemoryBuffer> mb) {
+        entries[task] = std::move(mb);
+      }));
+  std::atomic<uint32_t> numHits = 0;
+  std::atomic<uint32_t> numMisses = 0;
+
+  parallelForEach(objectSources, [&](TpiSource *source) {
+    if (source->kind != TpiSource::Regular || getDebugH(source->file)) {
+      source->loadGHashes();
+      return;
+    }
+
+    unsigned task = source->tpiSrcIdx;
+    StringRef name = source->file->getName();
+    XXH128_hash_t hash = xxh3_128bits(source->file->debugTypes);
+    std::string key =
+        formatv("ghash-{0:x-16}{1:x-16}", hash.high64, hash.low64).str();
+    Expected<AddStreamFn> addStream = cache(task, key, name);
+    if (!addStream) {
+      warn("/lldghashcache: " + toString(addStream.takeError()));
+      source->loadGHashes();
+      return;
+    }
+
+    if (!*addStream && entries[task] &&
+        source->loadGHashesFromCache(
+            arrayRefFromStringRef(entries[task]->getBuffer()))) {
+      entries[task].reset();
+      ++numHits;
+      return;
+    }
+
+    source->loadGHashes();
+    ++numMisses;
+    if (*addStream) {
+      Expected<std::unique_ptr<CachedFileStream>> stream =
+          (*addStream)(task, name);
+      if (!stream) {
+        warn("/lldghashcache: " + toString(stream.takeError()));
+        return;
+      }
+      source->writeGHashesToCache(*(*stream)->OS);
+    }
+    entries[task].reset();
+  });
+
+  log("ghash cache: " + Twine(numHits) + " hits, " + Twine(numMisses) +
+      " misses");
+  pruneCache(ctx.config.ghashCache, ctx.config.ghashCachePolicy);
+}
+
 void TypeMerger::sortDependencies() {
   // Order dependencies first, but preserve the existing order.
   std::vector<TpiSource *> deps;
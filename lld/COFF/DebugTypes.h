@@ -63,6 +63,14 @@ public:
   /// Use global hashes to merge type information.
   virtual void remapTpiWithGHashes(GHashState *g);
 
+  /// Load global hashes and item index bits from a /lldghashcache: entry
+  /// written by writeGHashesToCache. Returns false if the entry is malformed.
+  bool loadGHashesFromCache(ArrayRef<uint8_t> entry);
+
+  /// Write the global hashes and item index bits of this source in the format
+  /// read by loadGHashesFromCache.
+  void writeGHashesToCache(raw_ostream &os) const;
+
   // Remap a type index in place.
   bool remapTypeIndex(TypeIndex &ti, llvm::codeview::TiRefKind refKind) const;
 
@@ -1533,6 +1533,8 @@ void LinkerDriver::linkerMain(ArrayRef<const char *> argsArr) {
   config->timeTraceEnabled = args.hasArg(OPT_time_trace_eq);
   config->timeTraceGranularity =
       args::getInteger(args, OPT_time_trace_granularity_eq, 500);
+  parallel::traceTasks =
+      config->timeTraceEnabled && args.hasArg(OPT_time_trace_threads);
 
   if (config->timeTraceEnabled)
     timeTraceProfilerInitialize(config->timeTraceGranularity, argsArr[0]);
@@ -2021,6 +2023,17 @@ void LinkerDriver::linkerMain(ArrayRef<const char *> argsArr) {
         parseCachePruningPolicy(arg->getValue()),
         Twine("/lldltocachepolicy: invalid cache policy: ") + arg->getValue());
 
+  // Handle /lldghashcache
+  if (auto *arg = args.getLastArg(OPT_lldghashcache))
+    config->ghashCache = arg->getValue();
+
+  // Handle /lldghashcachepolicy
+  if (auto *arg = args.getLastArg(OPT_lldghashcachepolicy))
+    config->ghashCachePolicy = CHECK(
+        parseCachePruningPolicy(arg->getValue()),
+        Twine("/lldghashcachepolicy: invalid cache policy: ") +
+            arg->getValue());
+
   // Handle /failifmismatch
   for (auto *arg : args.filtered(OPT_failifmismatch))
     checkFailIfMismatch(arg->getValue(), nullptr);
@@ -75,6 +75,9 @@ public:
 private:
   void clearGHashes();
 
+  /// Load ghashes of object sources using the /lldghashcache: directory.
+  void loadGHashesWithCache();
+
   COFFLinkerContext &ctx;
 };
 
@@ -0,0 +1,252 @@
+//===- ArchiveIndexCache.cpp ----------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Archive members are parsed lazily, but every link still reads the ELF
+// header, section header table and symbol table of every member to find the
+// symbols it defines. When the same archives are linked into many outputs,
+// that work is repeated for each of them. This file implements a cache of the
+// result keyed by the archive's path, size, modification time and file ID, in
+// the same llvm::localCache layout that the ThinLTO cache uses.
+//
+//===----------------------------------------------------------------------===//
+
+#include "ArchiveIndexCache.h"
+#include "Config.h"
+#include "InputFiles.h"
+#include "lld/Common/ErrorHandler.h"
+#include "llvm/ADT/StableHashing.h"
+#include "llvm/BinaryFormat/Magic.h"
+#include "llvm/Support/CachePruning.h"
+#include "llvm/Support/Caching.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/xxhash.h"
+
+using namespace llvm;
+using namespace llvm::ELF;
+using namespace llvm::object;
+using namespace lld;
+using namespace lld::elf;
+
+static constexpr char indexMagic[8] = {'L', 'L', 'D', 'A', 'I', 'D', 'X', '1'};
+
+// Returns the cache key of the archive at path. Any change to the archive that
+// updates its size, modification time or file ID selects a different entry;
+// entries that are no longer used are removed by pruning.
+static std::optional<std::string> getKey(StringRef path) {
+  sys::fs::file_status st;
+  if (sys::fs::status(path, st))
+    return std::nullopt;
+  SmallString<128> absPath(path);
+  if (sys::fs::make_absolute(absPath))
+    return std::nullopt;
+  sys::fs::UniqueID id = st.getUniqueID();
+  stable_hash fields[] = {
+      xxh3_64bits(absPath.str()), st.getSize(),
+      uint64_t(st.getLastModificationTime().time_since_epoch().count()),
+      id.getDevice(), id.getFile()};
+  uint64_t hash = stable_hash_combine(fields);
+  return formatv("archive-index-{0:x-16}", hash).str();
+}
+
+static bool isMemberOf(MemoryBufferRef member, MemoryBufferRef archive) {
+  return member.getBufferStart() >= archive.getBufferStart() &&
+         member.getBufferEnd() <= archive.getBufferEnd();
+}
+
+static std::optional<ArchiveIndex>
+parseIndex(StringRef buf, MemoryBufferRef archive,
+           ArrayRef<std::pair<MemoryBufferRef, uint64_t>> members) {
+  if (buf.size() < sizeof(ArchiveIndexHeader))
+    return std::nullopt;
+  const auto *hdr = reinterpret_cast<const ArchiveIndexHeader *>(buf.data());
+  uint64_t size = sizeof(ArchiveIndexHeader) +
+                  uint64_t(hdr->numMembers) * sizeof(ArchiveIndexMember) +
+                  uint64_t(hdr->numDefs) * sizeof(ArchiveIndexDef) +
+                  hdr->stringsSize;
+  if (memcmp(hdr->magic, indexMagic, sizeof(indexMagic)) != 0 ||
+      size != buf.size() || hdr->numMembers != members.size())
+    return std::nullopt;
+
+  ArchiveIndex index;
+  const char *p = buf.data() + sizeof(ArchiveIndexHeader);
+  index.members = ArrayRef(reinterpret_cast<const ArchiveIndexMember *>(p),
+                           hdr->numMembers);
+  p += hdr->numMembers * sizeof(ArchiveIndexMember);
+  index.defs =
+      ArrayRef(reinterpret_cast<const ArchiveIndexDef *>(p), hdr->numDefs);
+  p += hdr->numDefs * sizeof(ArchiveIndexDef);
+  index.strings = StringRef(p, hdr->stringsSize);
+
+  for (auto [m, member] : llvm::zip_equal(index.members, members)) {
+    MemoryBufferRef mb = member.first;
+    if (!isMemberOf(mb, archive) ||
+        m.offset != uint64_t(mb.getBufferStart() - archive.getBufferStart()) ||
+        identify_magic(mb.getBuffer()) != file_magic::elf_relocatable ||
+        m.firstGlobal > m.numSymbols ||
+        uint64_t(m.firstDef) + m.numDefs > index.defs.size())
+      return std::nullopt;
+    for (const ArchiveIndexDef &d : index.defs.slice(m.firstDef, m.numDefs))
+      if (d.index < m.firstGlobal || d.index >= m.numSymbols ||
+          uint64_t(d.nameOffset) + d.nameSize >= index.strings.size() ||
+          index.strings[d.nameOffset + d.nameSize] != '\0')
+        return std::nullopt;
+  }
+  return index;
+}
+
+std::optional<ArchiveIndex>
+elf::readArchiveIndex(Ctx &ctx, StringRef path, MemoryBufferRef archive,
+                      ArrayRef<std::pair<MemoryBufferRef, uint64_t>> members) {
+  std::optional<std::string> key = getKey(path);
+  if (!key)
+    return std::nullopt;
+
+  std::unique_ptr<MemoryBuffer> entry;
+  Expected<FileCache> cache =
+      localCache("ArchiveIndex", "ArchiveIndex", ctx.arg.archiveIndexCache,
+                 [&](size_t task, const Twine &moduleName,
+                     std::unique_ptr<MemoryBuffer> mb) {
+                   entry = std::move(mb);
+                 });
+  if (!cache) {
+    warn("--archive-index-cache: " + toString(cache.takeError()));
+    return std::nullopt;
+  }
+  Expected<AddStreamFn> addStream = (*cache)(0, *key, path);
+  if (!addStream) {
+    warn("--archive-index-cache: " + toString(addStream.takeError()));
+    return std::nullopt;
+  }
+  if (!entry)
+    return std::nullopt;
+
+  std::optional<ArchiveIndex> index =
+      parseIndex(entry->getBuffer(), archive, members);
+  if (!index) {
+    // Remove the malformed entry so that this link writes a new one.
+    log("--archive-index-cache: ignoring invalid entry for " + path);
+    sys::fs::remove(entry->getBufferIdentifier());
+    return std::nullopt;
+  }
+  ctx.memoryBuffers.push_back(std::move(entry));
+  return index;
+}
+
+template <class ELFT>
+static bool addMember(ELFFileBase &file, ArchiveIndexMember &m,
+                      SmallVectorImpl<ArchiveIndexDef> &defs,
+                      std::string &strings) {
+  ArrayRef<typename ELFT::Sym> eSyms = file.getELFSyms<ELFT>();
+  size_t firstGlobal = eSyms.size() - file.getGlobalELFSyms<ELFT>().size();
+  m.numSymbols = eSyms.size();
+  m.firstGlobal = firstGlobal;
+  m.firstDef = defs.size();
+  for (size_t i = firstGlobal, end = eSyms.size(); i != end; ++i) {
+    if (eSyms[i].st_shndx == SHN_UNDEF)
+      continue;
+    Expected<StringRef> name = eSyms[i].getName(file.getStringTable());
+    if (!name) {
+      consumeError(name.takeError());
+      return false;
+    }
+    ArchiveIndexDef &d = defs.emplace_back();
+    d.index = i;
+    d.nameOffset = strings.size();
+    d.nameSize = name->size();
+    strings.append(name->begin(), name->end());
+    strings.push_back('\0');
+  }
+  m.numDefs = defs.size() - m.firstDef;
+  return true;
+}
+
+void elf::writeArchiveIndex(Ctx &ctx, StringRef path, MemoryBufferRef archive,
+                            ArrayRef<ELFFileBase *> members) {
+  std::optional<std::string> key = getKey(path);
+  if (!key)
+    return;
+
+  SmallVector<ArchiveIndexMember, 0> records(members.size());
+  SmallVector<ArchiveIndexDef, 0> defs;
+  std::string strings;
+  for (auto [m, file] : llvm::zip_equal(records, members)) {
+    if (!isMemberOf(file->mb, archive))
+      return;
+    m.offset = file->mb.getBufferStart() - archive.getBufferStart();
+    bool ok;
+    switch (file->ekind) {
+    case ELF32LEKind:
+      ok = addMember<ELF32LE>(*file, m, defs, strings);
+      break;
+    case ELF32BEKind:
+      ok = addMember<ELF32BE>(*file, m, defs, strings);
+      break;
+    case ELF64LEKind:
+      ok = addMember<ELF64LE>(*file, m, defs, strings);
+      break;
+    case ELF64BEKind:
+      ok = addMember<ELF64BE>(*file, m, defs, strings);
+      break;
+    default:
+      llvm_unreachable("getELFKind");
+    }
+    if (!ok || strings.size() > UINT32_MAX)
+      return;
+  }
+
+  Expected<FileCache> cache =
+      localCache("ArchiveIndex", "ArchiveIndex", ctx.arg.archiveIndexCache);
+  if (!cache) {
+    warn("--archive-index-cache: " + toString(cache.takeError()));
+    return;
+  }
+  Expected<AddStreamFn> addStream = (*cache)(0, *key, path);
+  if (!addStream) {
+    warn("--archive-index-cache: " + toString(addStream.takeError()));
+    return;
+  }
+  // Another link has written the entry in the meantime.
+  if (!*addStream)
+    return;
+  Expected<std::unique_ptr<CachedFileStream>> stream = (*addStream)(0, path);
+  if (!stream) {
+    warn("--archive-index-cache: " + toString(stream.takeError()));
+    return;
+  }
+
+  ArchiveIndexHeader hdr;
+  memcpy(hdr.magic, indexMagic, sizeof(indexMagic));
+  hdr.numMembers = records.size();
+  hdr.numDefs = defs.size();
+  hdr.stringsSize = strings.size();
+  hdr.reserved = 0;
+  raw_pwrite_stream &os = *(*stream)->OS;
+  os.write(reinterpret_cast<const char *>(&hdr), sizeof(hdr));
+  os.write(reinterpret_cast<const char *>(records.data()),
+           records.size() * sizeof(ArchiveIndexMember));
+  os.write(reinterpret_cast<const char *>(defs.data()),
+           defs.size() * sizeof(ArchiveIndexDef));
+  os << strings;
+}
+
+void elf::removeArchiveIndex(Ctx &ctx, StringRef path) {
+  std::optional<std::string> key = getKey(path);
+  if (!key)
+    return;
+  // This is the entry path used by llvm::localCache.
+  SmallString<128> entryPath(ctx.arg.archiveIndexCache);
+  sys::path::append(entryPath, "llvmcache-" + *key);
+  sys::fs::remove(entryPath);
+}
+
+void elf::pruneArchiveIndexCache(Ctx &ctx) {
+  pruneCache(ctx.arg.archiveIndexCache, CachePruningPolicy());
+}
@@ -0,0 +1,85 @@
+//===- ArchiveIndexCache.h --------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// --archive-index-cache=<dir> records, for each archive, the global symbols
+// defined by its members. Later links that read the same archive insert those
+// symbols as lazy symbols directly and defer parsing a member's ELF headers
+// and symbol table until the member is extracted.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLD_ELF_ARCHIVE_INDEX_CACHE_H
+#define LLD_ELF_ARCHIVE_INDEX_CACHE_H
+
+#include "lld/Common/LLVM.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/MemoryBufferRef.h"
+#include <optional>
+
+namespace lld::elf {
+struct Ctx;
+class ELFFileBase;
+
+// An entry consists of an ArchiveIndexHeader, numMembers ArchiveIndexMember
+// records, numDefs ArchiveIndexDef records and a string table of stringsSize
+// bytes holding NUL-terminated symbol names.
+struct ArchiveIndexHeader {
+  char magic[8];
+  llvm::support::ulittle32_t numMembers;
+  llvm::support::ulittle32_t numDefs;
+  llvm::support::ulittle32_t stringsSize;
+  llvm::support::ulittle32_t reserved;
+};
+
+struct ArchiveIndexMember {
+  // Offset of the member contents from the start of the archive.
+  llvm::support::ulittle64_t offset;
+  // The size of the symbol table and the index of its first global symbol.
+  llvm::support::ulittle32_t numSymbols;
+  llvm::support::ulittle32_t firstGlobal;
+  // The defined global symbols of this member are defs[firstDef, firstDef +
+  // numDefs).
+  llvm::support::ulittle32_t firstDef;
+  llvm::support::ulittle32_t numDefs;
+};
+
+struct ArchiveIndexDef {
+  // Symbol table index and the name's position in the string table.
+  llvm::support::ulittle32_t index;
+  llvm::support::ulittle32_t nameOffset;
+  llvm::support::ulittle32_t nameSize;
+};
+
+// A validated cache entry. It points into a buffer owned by ctx.
+struct ArchiveIndex {
+  ArrayRef<ArchiveIndexMember> members;
+  ArrayRef<ArchiveIndexDef> defs;
+  StringRef strings;
+};
+
+// Returns the cached index of the archive at path whose contents are archive
+// and whose members are members, or std::nullopt if there is no valid entry.
+std::optional<ArchiveIndex>
+readArchiveIndex(Ctx &ctx, StringRef path, MemoryBufferRef archive,
+                 ArrayRef<std::pair<MemoryBufferRef, uint64_t>> members);
+
+// Records the defined global symbols of members, which must be the lazy ELF
+// relocatable objects created for every member of archive, in that order.
+void writeArchiveIndex(Ctx &ctx, StringRef path, MemoryBufferRef archive,
+                       ArrayRef<ELFFileBase *> members);
+
+// Removes the entry of the archive at path, e.g. because it does not match
+// the archive's members.
+void removeArchiveIndex(Ctx &ctx, StringRef path);
+
+// Prunes the cache directory using the ThinLTO cache's default policy.
+void pruneArchiveIndexCache(Ctx &ctx);
+} // namespace lld::elf
+
+#endif
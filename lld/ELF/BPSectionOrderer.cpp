@@ -0,0 +1,131 @@
+//===- BPSectionOrderer.cpp -----------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "BPSectionOrderer.h"
+#include "Config.h"
+#include "InputFiles.h"
+#include "InputSection.h"
+#include "SymbolTable.h"
+#include "Symbols.h"
+#include "SyntheticSections.h"
+#include "lld/Common/BPSectionOrdererBase.inc"
+#include "llvm/ADT/StableHashing.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/xxhash.h"
+
+using namespace llvm;
+using namespace lld;
+using namespace lld::elf;
+
+namespace {
+struct BPOrdererELF;
+}
+template <> struct lld::BPOrdererTraits<BPOrdererELF> {
+  using Section = elf::InputSectionBase;
+  using Defined = elf::Defined;
+};
+namespace {
+struct BPOrdererELF : lld::BPOrderer<BPOrdererELF> {
+  DenseMap<const InputSectionBase *, SmallVector<Defined *, 0>> secToSyms;
+
+  static uint64_t getSize(const Section &sec) { return sec.getSize(); }
+  static bool isCodeSection(const Section &sec) {
+    return sec.flags & ELF::SHF_EXECINSTR;
+  }
+  ArrayRef<Defined *> getSymbols(const Section &sec) {
+    auto it = secToSyms.find(&sec);
+    if (it == secToSyms.end())
+      return {};
+    return it->second;
+  }
+
+  static std::optional<StringRef> getResolvedLinkageName(StringRef name) {
+    return {};
+  }
+
+  void getSectionHashes(const Section &sec, SmallVectorImpl<uint64_t> &hashes,
+                        const DenseMap<const void *, uint64_t> &sectionToIdx) {
+    constexpr unsigned windowSize = 4;
+
+    // Every 4-byte window fits in a uint64_t, so use the window itself as its
+    // hash, followed by the trailing bytes that do not fill a whole window.
+    ArrayRef<uint8_t> data = sec.content();
+    if (data.size() >= windowSize)
+      for (size_t i = 0; i <= data.size() - windowSize; ++i)
+        hashes.push_back(support::endian::read32le(data.data() + i));
+    for (uint8_t byte : data.take_back(windowSize - 1))
+      hashes.push_back(byte);
+
+    // Relocated fields have not been written yet, so calls to different
+    // functions look alike. Mix in what each relocation refers to.
+    for (const Relocation &r : sec.relocs()) {
+      if (r.offset >= data.size())
+        continue;
+      uint64_t window =
+          xxh3_64bits(data.drop_front(r.offset).take_front(windowSize));
+      hashes.push_back(
+          stable_hash_combine(window, getRelocHash(r, sectionToIdx)));
+    }
+  }
+
+  static StringRef getSymName(const Defined &sym) { return sym.getName(); }
+  static uint64_t getSymValue(const Defined &sym) { return sym.value; }
+  static uint64_t getSymSize(const Defined &sym) { return sym.size; }
+
+private:
+  static uint64_t
+  getRelocHash(const Relocation &r,
+               const DenseMap<const void *, uint64_t> &sectionToIdx) {
+    if (auto *d = dyn_cast<Defined>(r.sym)) {
+      auto it = sectionToIdx.find(d->section);
+      if (it != sectionToIdx.end())
+        return stable_hash_combine(r.type, it->second, d->value + r.addend);
+    }
+    return stable_hash_combine(r.type, xxh3_64bits(r.sym->getName()),
+                               r.addend);
+  }
+};
+} // namespace
+
+DenseMap<const InputSectionBase *, int> elf::runBalancedPartitioning(
+    Ctx &ctx, StringRef profilePath, bool forFunctionCompression,
+    bool forDataCompression, bool compressionSortStartupFunctions,
+    bool verbose) {
+  BPOrdererELF orderer;
+  SmallVector<const InputSectionBase *, 0> sections;
+  auto addSection = [&](Symbol &sym) {
+    auto *d = dyn_cast<Defined>(&sym);
+    if (!d)
+      return;
+    auto *sec = dyn_cast_or_null<InputSection>(d->section);
+    if (!sec || sec->size == 0 || !sec->isLive() || sec->repl != sec ||
+        sec->type == ELF::SHT_NOBITS || isa<SyntheticSection>(sec))
+      return;
+    auto [it, wasInserted] = orderer.secToSyms.try_emplace(sec);
+    if (wasInserted)
+      sections.push_back(sec);
+    it->second.push_back(d);
+  };
+
+  // We want both global and local symbols. We get the global ones from the
+  // symbol table and iterate the object files for the local ones.
+  for (Symbol *sym : ctx.symtab->getSymbols())
+    addSection(*sym);
+  for (ELFFileBase *file : ctx.objectFiles)
+    for (Symbol *sym : file->getLocalSymbols())
+      addSection(*sym);
+
+  DenseMap<const InputSectionBase *, int> sectionOrder;
+  SmallVector<const InputSectionBase *, 0> order = orderer.computeOrder(
+      sections, profilePath, forFunctionCompression, forDataCompression,
+      compressionSortStartupFunctions, verbose);
+  int priority = 0;
+  for (const InputSectionBase *sec : order)
+    sectionOrder[sec] = priority++;
+  return sectionOrder;
+}
@@ -23,6 +23,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "Driver.h"
+#include "ArchiveIndexCache.h"
 #include "Config.h"
 #include "ICF.h"
 #include "InputFiles.h"
@@ -112,6 +113,7 @@ void Ctx::reset() {
   symtab = std::make_unique<SymbolTable>(*this);
 
   memoryBuffers.clear();
+  prefetchedBuffers.clear();
   objectFiles.clear();
   sharedFiles.clear();
   binaryFiles.clear();
@@ -321,19 +323,40 @@ void LinkerDriver::addFile(StringRef path, bool withLOption) {
     //
     // All files within the archive get the same group ID to allow mutual
     // references for --warn-backrefs.
+    //
+    // With --archive-index-cache, the defined symbols of ELF members are read
+    // from the cache instead of the members' symbol tables if the archive is
+    // unchanged since the entry was written. Archives with bitcode members
+    // are not cached.
+    std::optional<ArchiveIndex> index;
+    bool useIndexCache =
+        !ctx.arg.archiveIndexCache.empty() && !ctx.arg.fatLTOObjects;
+    if (useIndexCache)
+      index = readArchiveIndex(ctx, path, mbref, members);
+    SmallVector<ELFFileBase *, 0> indexed;
     bool saved = InputFile::isInGroup;
     InputFile::isInGroup = true;
-    for (const std::pair<MemoryBufferRef, uint64_t> &p : members) {
+    for (auto [i, p] : llvm::enumerate(members)) {
       auto magic = identify_magic(p.first.getBuffer());
       if (magic == file_magic::elf_relocatable) {
-        if (!tryAddFatLTOFile(p.first, path, p.second, true))
+        if (index) {
+          files.push_back(
+              createLazyObjFile(p.first, path, *index, index->members[i]));
+        } else if (!tryAddFatLTOFile(p.first, path, p.second, true)) {
           files.push_back(createObjFile(p.first, path, true));
-      } else if (magic == file_magic::bitcode)
+          indexed.push_back(cast<ELFFileBase>(files.back()));
+        }
+        continue;
+      }
+      useIndexCache = false;
+      if (magic == file_magic::bitcode)
         files.push_back(make<BitcodeFile>(p.first, path, p.second, true));
       else
         warn(path + ": archive member '" + p.first.getBufferIdentifier() +
              "' is neither ET_REL nor LLVM bitcode");
     }
+    if (useIndexCache && !index)
+      writeArchiveIndex(ctx, path, mbref, indexed);
     InputFile::isInGroup = saved;
     if (!saved)
       ++InputFile::nextGroupId;
@@ -432,6 +455,14 @@ static void checkOptions(Ctx &ctx) {
   if (ctx.arg.relaxGP && ctx.arg.emachine != EM_RISCV)
     error("--relax-gp is only supported on RISC-V targets");
 
+  if (ctx.arg.irpgoProfilePath.empty()) {
+    if (ctx.arg.bpStartupFunctionSort)
+      error("--bp-startup-sort=function must be used with --irpgo-profile=");
+    if (ctx.arg.bpCompressionSortStartupFunctions)
+      error("--bp-compression-sort-startup-functions must be used with "
+            "--irpgo-profile=");
+  }
+
   if (ctx.arg.pie && ctx.arg.shared)
     error("-shared and -pie may not be used together");
 
@@ -1258,6 +1289,7 @@ static void readConfigs(Ctx &ctx, opt::InputArgList &args) {
       hasZOption(args, "muldefs") ||
       args.hasFlag(OPT_allow_multiple_definition,
                    OPT_no_allow_multiple_definition, false);
+  ctx.arg.archiveIndexCache = args.getLastArgValue(OPT_archive_index_cache);
   ctx.arg.androidMemtagHeap =
       args.hasFlag(OPT_android_memtag_heap, OPT_no_android_memtag_heap, false);
   ctx.arg.androidMemtagStack = args.hasFlag(OPT_android_memtag_stack,
@@ -1279,6 +1311,32 @@ static void readConfigs(Ctx &ctx, opt::InputArgList &args) {
     else if (arg->getOption().matches(OPT_Bsymbolic))
       ctx.arg.bsymbolic = BsymbolicKind::All;
   }
+  ctx.arg.bpCompressionSortStartupFunctions =
+      args.hasFlag(OPT_bp_compression_sort_startup_functions,
+                   OPT_no_bp_compression_sort_startup_functions, false);
+  if (auto *arg = args.getLastArg(OPT_bp_startup_sort)) {
+    StringRef s = arg->getValue();
+    if (s == "function")
+      ctx.arg.bpStartupFunctionSort = true;
+    else if (s != "none")
+      error("unknown --bp-startup-sort= value: " + s);
+  }
+  if (auto *arg = args.getLastArg(OPT_bp_compression_sort)) {
+    StringRef s = arg->getValue();
+    if (s == "function" || s == "both")
+      ctx.arg.bpFunctionOrderForCompression = true;
+    if (s == "data" || s == "both")
+      ctx.arg.bpDataOrderForCompression = true;
+    if (s != "function" && s != "data" && s != "both" && s != "none")
+      error("unknown --bp-compression-sort= value: " + s);
+  }
+  ctx.arg.bpVerboseSectionOrderer = args.hasArg(OPT_verbose_bp_section_orderer);
+  if (ctx.arg.bpStartupFunctionSort || ctx.arg.bpFunctionOrderForCompression ||
+      ctx.arg.bpDataOrderForCompression)
+    if (args.hasArg(OPT_symbol_ordering_file, OPT_call_graph_ordering_file))
+      error("--bp-startup-sort= and --bp-compression-sort= may not be used "
+            "together with --symbol-ordering-file or "
+            "--call-graph-ordering-file");
   ctx.arg.callGraphProfileSort = getCGProfileSortKind(args);
   ctx.arg.checkSections =
       args.hasFlag(OPT_check_sections, OPT_no_check_sections, true);
@@ -1336,7 +1394,9 @@ static void readConfigs(Ctx &ctx, opt::InputArgList &args) {
       args.hasArg(OPT_ignore_data_address_equality);
   ctx.arg.ignoreFunctionAddressEquality =
       args.hasArg(OPT_ignore_function_address_equality);
+  ctx.arg.incrementalState = args.getLastArgValue(OPT_incremental_state);
   ctx.arg.init = args.getLastArgValue(OPT_init, "_init");
+  ctx.arg.irpgoProfilePath = args.getLastArgValue(OPT_irpgo_profile);
   ctx.arg.ltoAAPipeline = args.getLastArgValue(OPT_lto_aa_pipeline);
   ctx.arg.ltoCSProfileGenerate = args.hasArg(OPT_lto_cs_profile_generate);
   ctx.arg.ltoCSProfileFile = args.getLastArgValue(OPT_lto_cs_profile_file);
@@ -1480,6 +1540,8 @@ static void readConfigs(Ctx &ctx, opt::InputArgList &args) {
   ctx.arg.timeTraceEnabled = args.hasArg(OPT_time_trace_eq);
   ctx.arg.timeTraceGranularity =
       args::getInteger(args, OPT_time_trace_granularity, 500);
+  parallel::traceTasks =
+      ctx.arg.timeTraceEnabled && args.hasArg(OPT_time_trace_threads);
   ctx.arg.trace = args.hasArg(OPT_trace);
   ctx.arg.undefined = args::getStrings(args, OPT_undefined);
   ctx.arg.undefinedVersion =
@@ -1930,6 +1992,15 @@ void LinkerDriver::createFiles(opt::InputArgList &args) {
   // -r implies -Bstatic and has precedence over -Bdynamic.
   ctx.arg.isStatic = ctx.arg.relocatable;
 
+  // Open the input files named on the command line concurrently. This hides
+  // the filesystem latency, which dominates on networked filesystems.
+  if (ctx.arg.threadCount > 1) {
+    SmallVector<StringRef, 0> paths;
+    for (auto *arg : args.filtered(OPT_INPUT))
+      paths.push_back(arg->getValue());
+    prefetchFiles(paths);
+  }
+
   // Iterate over argv to process input files and positional arguments.
   std::optional<MemoryBufferRef> defaultScript;
   InputFile::isInGroup = false;
@@ -2876,6 +2947,8 @@ template <class ELFT> void LinkerDriver::link(opt::InputArgList &args) {
     ctx.symtab->addUnusedUndefined(name)->referenced = true;
 
   parseFiles(ctx, files);
+  if (!ctx.arg.archiveIndexCache.empty())
+    pruneArchiveIndexCache(ctx);
 
   // Create dynamic sections for dynamic linking and static PIE.
   ctx.arg.hasDynSymTab = !ctx.sharedFiles.empty() || ctx.arg.isPic;
@@ -170,6 +170,7 @@ std::string elf::createResponseFile(const opt::InputArgList &args) {
       os << quote(rewritePath(arg->getValue())) << "\n";
       break;
     case OPT_o:
+    case OPT_incremental_state:
     case OPT_Map:
     case OPT_print_archive_stats:
     case OPT_why_extract:
@@ -185,6 +186,9 @@ std::string elf::createResponseFile(const opt::InputArgList &args) {
     case OPT_lto_sample_profile:
       os << arg->getSpelling() << quote(rewritePath(arg->getValue())) << "\n";
       break;
+    case OPT_irpgo_profile:
+      os << arg->getSpelling() << quote(rewritePath(arg->getValue())) << "\n";
+      break;
     case OPT_call_graph_ordering_file:
     case OPT_default_script:
     case OPT_dynamic_list:
@@ -80,6 +80,7 @@
 #include "SymbolTable.h"
 #include "Symbols.h"
 #include "SyntheticSections.h"
+#include "llvm/ADT/StableHashing.h"
 #include "llvm/BinaryFormat/ELF.h"
 #include "llvm/Object/ELF.h"
 #include "llvm/Support/Parallel.h"
@@ -124,6 +125,10 @@ private:
   Ctx &ctx;
   SmallVector<InputSection *, 0> sections;
 
+  // Sections before this index are in final equivalence classes, so the main
+  // loop does not need to visit them. See run().
+  size_t variableBegin = 0;
+
   // We repeat the main loop while `Repeat` is true.
   std::atomic<bool> repeat;
 
@@ -413,8 +418,9 @@ template <class ELFT>
 void ICF<ELFT>::forEachClass(llvm::function_ref<void(size_t, size_t)> fn) {
   // If threading is disabled or the number of sections are
   // too small to use threading, call Fn sequentially.
-  if (parallel::strategy.ThreadsRequested == 1 || sections.size() < 1024) {
-    forEachClassRange(0, sections.size(), fn);
+  if (parallel::strategy.ThreadsRequested == 1 ||
+      sections.size() - variableBegin < 1024) {
+    forEachClassRange(variableBegin, sections.size(), fn);
     ++cnt;
     return;
   }
@@ -427,13 +433,14 @@ void ICF<ELFT>::forEachClass(llvm::function_ref<void(size_t, size_t)> fn) {
   // so that Fn can modify the Chunks in its shard without causing data
   // races.
   const size_t numShards = 256;
-  size_t step = sections.size() / numShards;
+  size_t step = (sections.size() - variableBegin) / numShards;
   size_t boundaries[numShards + 1];
-  boundaries[0] = 0;
+  boundaries[0] = variableBegin;
   boundaries[numShards] = sections.size();
 
   parallelFor(1, numShards, [&](size_t i) {
-    boundaries[i] = findBoundary((i - 1) * step, sections.size());
+    boundaries[i] =
+        findBoundary(variableBegin + (i - 1) * step, sections.size());
   });
 
   parallelFor(1, numShards + 1, [&](size_t i) {
@@ -459,6 +466,29 @@ static void combineRelocHashes(unsigned cnt, InputSection *isec,
   isec->eqClass[(cnt + 1) % 2] = hash | (1U << 31);
 }
 
+// Combine the parts of relocations that equalsConstant requires to be equal
+// into the content hash of a section.
+template <class RelTy>
+static uint64_t hashConstantRelocs(Ctx &ctx, uint64_t hash,
+                                   Relocs<RelTy> rels) {
+  for (const RelTy &rel : rels)
+    hash = stable_hash_combine(hash, rel.r_offset,
+                               rel.getType(ctx.arg.isMips64EL));
+  return hash;
+}
+
+// Returns true if no relocation refers to a symbol defined relative to an
+// InputSection. equalsVariable never splits the equivalence class of such a
+// section, so its class is final once constant parts have been compared.
+template <class RelTy>
+static bool hasNoVariableTargets(InputSection *isec, Relocs<RelTy> rels) {
+  for (const RelTy &rel : rels)
+    if (auto *d = dyn_cast<Defined>(&isec->file->getRelocTargetSym(rel)))
+      if (isa_and_nonnull<InputSection>(d->section))
+        return false;
+  return true;
+}
+
 static void print(Ctx &ctx, const Twine &s) {
   if (ctx.arg.printIcfSections)
     message(s);
@@ -499,10 +529,20 @@ template <class ELFT> void ICF<ELFT>::run() {
     }
   }
 
-  // Initially, we use hash values to partition sections.
+  // Initially, we use hash values to partition sections. The hash covers the
+  // content and the offsets and types of relocations, which must all be equal
+  // for equalsConstant to hold, so that segregate() has less work to do.
   parallelForEach(sections, [&](InputSection *s) {
+    uint64_t hash = stable_hash_combine(xxh3_64bits(s->content()), s->flags);
+    const RelsOrRelas<ELFT> rels = s->template relsOrRelas<ELFT>();
+    if (rels.areRelocsCrel())
+      hash = hashConstantRelocs(ctx, hash, rels.crels);
+    else if (rels.areRelocsRel())
+      hash = hashConstantRelocs(ctx, hash, rels.rels);
+    else
+      hash = hashConstantRelocs(ctx, hash, rels.relas);
     // Set MSB to 1 to avoid collisions with unique IDs.
-    s->eqClass[0] = xxh3_64bits(s->content()) | (1U << 31);
+    s->eqClass[0] = hash | (1U << 31);
   });
 
   // Perform 2 rounds of relocation hash propagation. 2 is an empirical value to
@@ -534,6 +574,48 @@ template <class ELFT> void ICF<ELFT>::run() {
     segregate(begin, end, eqClassBase, true);
   });
 
+  // Sections whose relocations do not refer to InputSections are now in their
+  // final classes. Move them to the front, keeping classes contiguous, so that
+  // the main loop only refines the classes that may still be split.
+  {
+    SmallVector<uint8_t, 0> isFinal(sections.size());
+    parallelFor(0, sections.size(), [&](size_t i) {
+      InputSection *s = sections[i];
+      const RelsOrRelas<ELFT> rels = s->template relsOrRelas<ELFT>();
+      if (rels.areRelocsCrel())
+        isFinal[i] = hasNoVariableTargets(s, rels.crels);
+      else if (rels.areRelocsRel())
+        isFinal[i] = hasNoVariableTargets(s, rels.rels);
+      else
+        isFinal[i] = hasNoVariableTargets(s, rels.relas);
+    });
+
+    SmallVector<InputSection *, 0> partitioned;
+    partitioned.reserve(sections.size());
+    for (size_t i = 0, e = sections.size(); i != e; ++i)
+      if (isFinal[i])
+        partitioned.push_back(sections[i]);
+    variableBegin = partitioned.size();
+    for (size_t i = 0, e = sections.size(); i != e; ++i)
+      if (!isFinal[i])
+        partitioned.push_back(sections[i]);
+    sections = std::move(partitioned);
+
+    // Class IDs are derived from positions in `sections`, so renumber all
+    // classes after moving them. Store the IDs in both slots because the main
+    // loop no longer updates the final classes.
+    for (size_t begin = 0, e = sections.size(); begin != e;) {
+      uint32_t oldId = sections[begin]->eqClass[next];
+      size_t end = begin + 1;
+      while (end != e && sections[end]->eqClass[next] == oldId)
+        ++end;
+      for (size_t i = begin; i != end; ++i)
+        sections[i]->eqClass[0] = sections[i]->eqClass[1] = eqClassBase + end;
+      begin = end;
+    }
+    current = next = 0;
+  }
+
   // Split groups by comparing relocations until convergence is obtained.
   do {
     repeat = false;
@@ -7,6 +7,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "InputFiles.h"
+#include "ArchiveIndexCache.h"
 #include "Config.h"
 #include "DWARF.h"
 #include "Driver.h"
@@ -212,9 +213,8 @@ InputFile::InputFile(Kind k, MemoryBufferRef m)
     ++nextGroupId;
 }
 
-std::optional<MemoryBufferRef> elf::readFile(StringRef path) {
-  llvm::TimeTraceScope timeScope("Load input files", path);
-
+// Applies --chroot and --remap-inputs to an input file path.
+static StringRef resolveInputPath(StringRef path) {
   // The --chroot option changes our virtual root directory.
   // This is useful when you are dealing with files created by --reproduce.
   if (!ctx.arg.chroot.empty() && path.starts_with("/"))
@@ -242,19 +242,49 @@ std::optional<MemoryBufferRef> elf::readFile(StringRef path) {
       path = "NUL";
 #endif
   }
+  return path;
+}
+
+void elf::prefetchFiles(ArrayRef<StringRef> paths) {
+  llvm::TimeTraceScope timeScope("Prefetch input files");
+  SmallVector<StringRef, 0> resolved;
+  for (StringRef path : paths) {
+    path = resolveInputPath(path);
+    if (!ctx.prefetchedBuffers.count(path))
+      resolved.push_back(path);
+  }
+  auto results = MemoryBuffer::getFiles(resolved, /*IsText=*/false,
+                                        /*RequiresNullTerminator=*/false);
+  // Errors are reported by readFile, which opens the file again.
+  for (auto [path, mbOrErr] : llvm::zip_equal(resolved, results))
+    if (mbOrErr)
+      ctx.prefetchedBuffers.try_emplace(path, std::move(*mbOrErr));
+}
+
+std::optional<MemoryBufferRef> elf::readFile(StringRef path) {
+  llvm::TimeTraceScope timeScope("Load input files", path);
+  path = resolveInputPath(path);
 
   log(path);
   ctx.arg.dependencyFiles.insert(llvm::CachedHashString(path));
 
-  auto mbOrErr = MemoryBuffer::getFile(path, /*IsText=*/false,
-                                       /*RequiresNullTerminator=*/false);
-  if (auto ec = mbOrErr.getError()) {
-    error("cannot open " + path + ": " + ec.message());
-    return std::nullopt;
+  std::unique_ptr<MemoryBuffer> mb;
+  auto it = ctx.prefetchedBuffers.find(path);
+  if (it != ctx.prefetchedBuffers.end()) {
+    mb = std::move(it->second);
+    ctx.prefetchedBuffers.erase(it);
+  } else {
+    auto mbOrErr = MemoryBuffer::getFile(path, /*IsText=*/false,
+                                         /*RequiresNullTerminator=*/false);
+    if (auto ec = mbOrErr.getError()) {
+      error("cannot open " + path + ": " + ec.message());
+      return std::nullopt;
+    }
+    mb = std::move(*mbOrErr);
   }
 
-  MemoryBufferRef mbref = (*mbOrErr)->getMemBufferRef();
-  ctx.memoryBuffers.push_back(std::move(*mbOrErr)); // take MB ownership
+  MemoryBufferRef mbref = mb->getMemBufferRef();
+  ctx.memoryBuffers.push_back(std::move(mb)); // take MB ownership
 
   if (ctx.tar)
     ctx.tar->append(relativeToRoot(path), mbref.getBuffer());
@@ -342,6 +372,18 @@ extern template void ObjFile<ELF64BE>::importCmseSymbols();
 
 template <class ELFT>
 static void doParseFiles(Ctx &ctx, const std::vector<InputFile *> &files) {
+  // Symbol resolution below has to follow the command line order to be
+  // deterministic, but reading and hashing the names of global symbols does
+  // not. Do that in parallel first so that the serial loop only has to probe
+  // the symbol table.
+  {
+    llvm::TimeTraceScope timeScope("Compute symbol keys");
+    parallelForEach(files, [&](InputFile *file) {
+      if (file->kind() == InputFile::ObjKind && file->ekind == ctx.arg.ekind)
+        cast<ObjFile<ELFT>>(file)->computeGlobalSymbolKeys();
+    });
+  }
+
   // Add all files to the symbol table. This will add almost all symbols that we
   // need to the symbol table. This process might add files to the link due to
   // addDependentLibrary.
@@ -583,6 +625,8 @@ uint32_t ObjFile<ELFT>::getSectionIndex(const Elf_Sym &sym) const {
 }
 
 template <class ELFT> void ObjFile<ELFT>::parse(bool ignoreComdats) {
+  if (initDeferred)
+    finishDeferredInit();
   object::ELFFile<ELFT> obj = this->getObj();
   // Read a section table. justSymbols is usually false.
   if (this->justSymbols) {
@@ -1130,8 +1174,8 @@ void ObjFile<ELFT>::initializeSymbols(const object::ELFFile<ELFT> &obj) {
   // Some entries have been filled by LazyObjFile.
   for (size_t i = firstGlobal, end = eSyms.size(); i != end; ++i)
     if (!symbols[i])
-      symbols[i] =
-          ctx.symtab->insert(CHECK(eSyms[i].getName(stringTable), this));
+      symbols[i] = insertGlobal(i);
+  globalSymbolKeys = std::vector<CachedHashStringRef>();
 
   // Perform symbol resolution on non-local symbols.
   SmallVector<unsigned, 32> undefineds;
@@ -1892,7 +1936,139 @@ ELFFileBase *elf::createObjFile(MemoryBufferRef mb, StringRef archiveName,
   return f;
 }
 
+ELFFileBase *elf::createLazyObjFile(MemoryBufferRef mb, StringRef archiveName,
+                                    const ArchiveIndex &index,
+                                    const ArchiveIndexMember &member) {
+  ELFFileBase *f;
+  switch (getELFKind(mb, archiveName)) {
+  case ELF32LEKind:
+    f = make<ObjFile<ELF32LE>>(ELF32LEKind, mb, archiveName);
+    cast<ObjFile<ELF32LE>>(f)->initFromArchiveIndex(index, member);
+    break;
+  case ELF32BEKind:
+    f = make<ObjFile<ELF32BE>>(ELF32BEKind, mb, archiveName);
+    cast<ObjFile<ELF32BE>>(f)->initFromArchiveIndex(index, member);
+    break;
+  case ELF64LEKind:
+    f = make<ObjFile<ELF64LE>>(ELF64LEKind, mb, archiveName);
+    cast<ObjFile<ELF64LE>>(f)->initFromArchiveIndex(index, member);
+    break;
+  case ELF64BEKind:
+    f = make<ObjFile<ELF64BE>>(ELF64BEKind, mb, archiveName);
+    cast<ObjFile<ELF64BE>>(f)->initFromArchiveIndex(index, member);
+    break;
+  default:
+    llvm_unreachable("getELFKind");
+  }
+  f->lazy = true;
+  return f;
+}
+
+template <class ELFT>
+void ObjFile<ELFT>::initFromArchiveIndex(const ArchiveIndex &index,
+                                         const ArchiveIndexMember &member) {
+  const Elf_Ehdr &hdr = getObj().getHeader();
+  emachine = hdr.e_machine;
+  osabi = hdr.e_ident[llvm::ELF::EI_OSABI];
+  abiVersion = hdr.e_ident[llvm::ELF::EI_ABIVERSION];
+  numSymbols = member.numSymbols;
+  firstGlobal = member.firstGlobal;
+  indexDefs = index.defs.slice(member.firstDef, member.numDefs);
+  indexStrings = index.strings;
+  initDeferred = true;
+}
+
+// Reads the section and symbol tables of a file created by
+// createLazyObjFile(). The cache entry is keyed by the archive's size and
+// modification time, so a mismatch means the archive was rewritten in place
+// within the timestamp granularity. The cache is only advisory: the entry is
+// removed and the member is read as if it was not cached.
+template <class ELFT> void ObjFile<ELFT>::finishDeferredInit() {
+  initDeferred = false;
+  uint32_t cachedFirstGlobal = firstGlobal;
+  init();
+
+  auto matchesIndex = [&] {
+    if (numELFSyms != numSymbols || firstGlobal != cachedFirstGlobal)
+      return false;
+    ArrayRef<Elf_Sym> eSyms = this->template getELFSyms<ELFT>();
+    size_t numDefs = llvm::count_if(eSyms.slice(firstGlobal), [](auto &sym) {
+      return sym.st_shndx != SHN_UNDEF;
+    });
+    if (numDefs != indexDefs.size())
+      return false;
+    for (const ArchiveIndexDef &d : indexDefs) {
+      const Elf_Sym &sym = eSyms[d.index];
+      Expected<StringRef> name = sym.getName(stringTable);
+      if (!name) {
+        consumeError(name.takeError());
+        return false;
+      }
+      if (sym.st_shndx == SHN_UNDEF ||
+          *name != StringRef(indexStrings.data() + d.nameOffset, d.nameSize))
+        return false;
+    }
+    return true;
+  };
+  if (matchesIndex())
+    return;
+
+  warn(toString(this) + ": ignoring stale --archive-index-cache entry");
+  removeArchiveIndex(ctx, archiveName);
+  // The lazy symbols inserted from the entry stay in the symbol table. Those
+  // that this member still defines are resolved by initializeSymbols; the
+  // others are demoted to undefined symbols like any unextracted lazy symbol.
+  numSymbols = numELFSyms;
+  symbols = std::make_unique<Symbol *[]>(numSymbols);
+}
+
+template <class ELFT> void ObjFile<ELFT>::computeGlobalSymbolKeys() {
+  ArrayRef<Elf_Sym> eSyms = this->getELFSyms<ELFT>();
+  if (firstGlobal == 0 || eSyms.size() <= firstGlobal)
+    return;
+  std::vector<CachedHashStringRef> keys;
+  keys.reserve(eSyms.size() - firstGlobal);
+  for (size_t i = firstGlobal, end = eSyms.size(); i != end; ++i) {
+    Expected<StringRef> name = eSyms[i].getName(stringTable);
+    // Leave invalid input to insertGlobal, which reports errors in order.
+    if (!name) {
+      consumeError(name.takeError());
+      return;
+    }
+    keys.push_back(SymbolTable::getKey(*name));
+  }
+  globalSymbolKeys = std::move(keys);
+}
+
+// Insert the global symbol at index i into the symbol table, using the key
+// precomputed by computeGlobalSymbolKeys if available.
+template <class ELFT> Symbol *ObjFile<ELFT>::insertGlobal(size_t i) {
+  if (globalSymbolKeys.empty())
+    return ctx.symtab->insert(
+        CHECK(this->getELFSyms<ELFT>()[i].getName(stringTable), this));
+
+  // The key of <name>@@<version> is <name>. Names are null-terminated in the
+  // string table, so the full name can be recovered from the key.
+  CachedHashStringRef key = globalSymbolKeys[i - firstGlobal];
+  StringRef name = key.val();
+  if (name.data()[name.size()] != '\0')
+    name = StringRef(name.data());
+  return ctx.symtab->insert(name, key);
+}
+
 template <class ELFT> void ObjFile<ELFT>::parseLazy() {
+  if (initDeferred) {
+    symbols = std::make_unique<Symbol *[]>(numSymbols);
+    for (const ArchiveIndexDef &d : indexDefs) {
+      StringRef name(indexStrings.data() + d.nameOffset, d.nameSize);
+      symbols[d.index] = ctx.symtab->insert(name);
+      symbols[d.index]->resolve(LazySymbol{*this});
+      if (!lazy)
+        break;
+    }
+    return;
+  }
+
   const ArrayRef<typename ELFT::Sym> eSyms = this->getELFSyms<ELFT>();
   numSymbols = eSyms.size();
   symbols = std::make_unique<Symbol *[]>(numSymbols);
@@ -1903,11 +2079,15 @@ template <class ELFT> void ObjFile<ELFT>::parseLazy() {
   for (size_t i = firstGlobal, end = eSyms.size(); i != end; ++i) {
     if (eSyms[i].st_shndx == SHN_UNDEF)
       continue;
-    symbols[i] = ctx.symtab->insert(CHECK(eSyms[i].getName(stringTable), this));
+    symbols[i] = insertGlobal(i);
     symbols[i]->resolve(LazySymbol{*this});
     if (!lazy)
       break;
   }
+
+  // Undefined symbols are inserted by initializeSymbols if this file is
+  // extracted, which is uncommon. Don't keep their keys around.
+  globalSymbolKeys = std::vector<CachedHashStringRef>();
 }
 
 bool InputFile::shouldExtractForCommon(StringRef name) const {
@@ -38,10 +38,17 @@ namespace elf {
 
 class InputSection;
 class Symbol;
+struct ArchiveIndex;
+struct ArchiveIndexDef;
+struct ArchiveIndexMember;
 
 // Opens a given file.
 std::optional<MemoryBufferRef> readFile(StringRef path);
 
+// Opens the given input files concurrently so that later readFile calls for
+// them do not wait for the filesystem.
+void prefetchFiles(ArrayRef<StringRef> paths);
+
 // Add symbols in File to the symbol table.
 void parseFile(Ctx &, InputFile *file);
 void parseFiles(Ctx &, const std::vector<InputFile *> &files);
@@ -249,6 +256,16 @@ public:
   void parse(bool ignoreComdats = false);
   void parseLazy();
 
+  // Compute the symbol table keys of global symbols ahead of parse() or
+  // parseLazy(). This is independent of other files and thread-safe.
+  void computeGlobalSymbolKeys();
+
+  // Initializes the file from an --archive-index-cache entry instead of
+  // init(). The section and symbol tables are not read until the file is
+  // extracted.
+  void initFromArchiveIndex(const ArchiveIndex &index,
+                            const ArchiveIndexMember &member);
+
   StringRef getShtGroupSignature(ArrayRef<Elf_Shdr> sections,
                                  const Elf_Shdr &sec);
 
@@ -295,6 +312,8 @@ private:
                           const llvm::object::ELFFile<ELFT> &obj);
   void initializeSymbols(const llvm::object::ELFFile<ELFT> &obj);
   void initializeJustSymbols();
+  Symbol *insertGlobal(size_t i);
+  void finishDeferredInit();
 
   InputSectionBase *getRelocTarget(uint32_t idx, uint32_t info);
   InputSectionBase *createInputSection(uint32_t idx, const Elf_Shdr &sec,
@@ -316,6 +335,17 @@ private:
   // If the section does not exist (which is common), the array is empty.
   ArrayRef<Elf_Word> shndxTable;
 
+  // Symbol table keys of global symbols, indexed by symbol index minus
+  // firstGlobal. Set by computeGlobalSymbolKeys and freed once the symbols
+  // have been inserted.
+  std::vector<llvm::CachedHashStringRef> globalSymbolKeys;
+
+  // The defined global symbols read from an --archive-index-cache entry.
+  // init() is deferred until extraction if initDeferred is true.
+  ArrayRef<ArchiveIndexDef> indexDefs;
+  StringRef indexStrings;
+  bool initDeferred = false;
+
   // Debugging information to retrieve source file and line for error
   // reporting. Linker may find reasonable number of errors in a
   // single object file, so we cache debugging information in order to
@@ -381,6 +411,9 @@ public:
 InputFile *createInternalFile(StringRef name);
 ELFFileBase *createObjFile(MemoryBufferRef mb, StringRef archiveName = "",
                            bool lazy = false);
+ELFFileBase *createLazyObjFile(MemoryBufferRef mb, StringRef archiveName,
+                               const ArchiveIndex &index,
+                               const ArchiveIndexMember &member);
 
 std::string replaceThinLTOSuffix(StringRef path);
 
@@ -456,16 +456,33 @@ private:
   ArrayRef<EhSectionPiece>::iterator i, j;
 };
 
+// A MIPS GOT entry requested by a relocation. MipsGotSection allocates entries
+// in the order they are requested, so parallel scanning records them and adds
+// them in task order afterwards.
+struct MipsGotRequest {
+  enum Kind : uint8_t { Entry, TlsIndex, DynTlsEntry };
+  Kind kind;
+  RelExpr expr;
+  InputFile *file;
+  Symbol *sym;
+  int64_t addend;
+};
+
 // This class encapsulates states needed to scan relocations for one
 // InputSectionBase.
 class RelocationScanner {
 public:
-  RelocationScanner(Ctx &ctx) : ctx(ctx) {}
+  RelocationScanner(Ctx &ctx, unsigned shard) : ctx(ctx), shard(shard) {}
   template <class ELFT>
   void scanSection(InputSectionBase &s, bool isEH = false);
 
+  SmallVector<MipsGotRequest, 0> mipsGotRequests;
+
 private:
   Ctx &ctx;
+  // The shard of dynamic relocation sections and diagnostics that this
+  // scanner appends to. See scanRelocations.
+  unsigned shard;
   InputSectionBase *sec;
   OffsetGetter getter;
 
@@ -478,7 +495,7 @@ private:
   bool isStaticLinkTimeConstant(RelExpr e, RelType type, const Symbol &sym,
                                 uint64_t relOff) const;
   void processAux(RelExpr expr, RelType type, uint64_t offset, Symbol &sym,
-                  int64_t addend) const;
+                  int64_t addend);
   unsigned handleTlsRelocation(RelExpr expr, RelType type, uint64_t offset,
                                Symbol &sym, int64_t addend);
 
@@ -578,7 +595,10 @@ struct UndefinedDiag {
   bool isWarning;
 };
 
+// Relocation scanning appends to one shard per task. scanRelocations
+// concatenates the shards in order into undefs.
 std::vector<UndefinedDiag> undefs;
+SmallVector<std::vector<UndefinedDiag>, 0> undefShards;
 std::mutex relocMutex;
 }
 
@@ -824,8 +844,9 @@ void elf::reportUndefinedSymbols(Ctx &ctx) {
 // Report an undefined symbol if necessary.
 // Returns true if the undefined symbol will produce an error message.
 static bool maybeReportUndefined(Ctx &ctx, Undefined &sym,
-                                 InputSectionBase &sec, uint64_t offset) {
-  std::lock_guard<std::mutex> lock(relocMutex);
+                                 InputSectionBase &sec, uint64_t offset,
+                                 unsigned shard) {
+  std::vector<UndefinedDiag> &undefs = undefShards[shard];
   // If versioned, issue an error (even if the symbol is weak) because we don't
   // know the defining filename which is required to construct a Verneed entry.
   if (sym.hasVersionSuffix) {
@@ -874,16 +895,14 @@ RelType RelocationScanner::getMipsN32RelType(RelTy *&rel) const {
   return type;
 }
 
-template <bool shard = false>
 static void addRelativeReloc(InputSectionBase &isec, uint64_t offsetInSec,
                              Symbol &sym, int64_t addend, RelExpr expr,
-                             RelType type) {
+                             RelType type, std::optional<unsigned> shard = {}) {
   Partition &part = isec.getPartition();
 
   if (sym.isTagged()) {
-    std::lock_guard<std::mutex> lock(relocMutex);
     part.relaDyn->addRelativeReloc(ctx.target->relativeRel, isec, offsetInSec,
-                                   sym, addend, type, expr);
+                                   sym, addend, type, expr, shard);
     // With MTE globals, we always want to derive the address tag by `ldg`-ing
     // the symbol. When we have a RELATIVE relocation though, we no longer have
     // a reference to the symbol. Because of this, when we have an addend that
@@ -906,14 +925,14 @@ static void addRelativeReloc(InputSectionBase &isec, uint64_t offsetInSec,
   if (part.relrDyn && isec.addralign >= 2 && offsetInSec % 2 == 0) {
     isec.addReloc({expr, type, offsetInSec, addend, &sym});
     if (shard)
-      part.relrDyn->relocsVec[parallel::getThreadIndex()].push_back(
+      part.relrDyn->relocsVec[*shard].push_back(
           {&isec, isec.relocs().size() - 1});
     else
       part.relrDyn->relocs.push_back({&isec, isec.relocs().size() - 1});
     return;
   }
-  part.relaDyn->addRelativeReloc<shard>(ctx.target->relativeRel, isec,
-                                        offsetInSec, sym, addend, type, expr);
+  part.relaDyn->addRelativeReloc(ctx.target->relativeRel, isec, offsetInSec,
+                                 sym, addend, type, expr, shard);
 }
 
 template <class PltSection, class GotPltSection>
@@ -1060,7 +1079,7 @@ bool RelocationScanner::isStaticLinkTimeConstant(RelExpr e, RelType type,
 // complicates things for the dynamic linker and means we would have to reserve
 // space for the extra PT_LOAD even if we end up not using it.
 void RelocationScanner::processAux(RelExpr expr, RelType type, uint64_t offset,
-                                   Symbol &sym, int64_t addend) const {
+                                   Symbol &sym, int64_t addend) {
   // If non-ifunc non-preemptible, change PLT to direct call and optimize GOT
   // indirection.
   const bool isIfunc = sym.isGnuIFunc();
@@ -1090,10 +1109,12 @@ void RelocationScanner::processAux(RelExpr expr, RelType type, uint64_t offset,
   // We were asked not to generate PLT entries for ifuncs. Instead, pass the
   // direct relocation on through.
   if (LLVM_UNLIKELY(isIfunc) && ctx.arg.zIfuncNoplt) {
-    std::lock_guard<std::mutex> lock(relocMutex);
-    sym.exportDynamic = true;
+    {
+      std::lock_guard<std::mutex> lock(relocMutex);
+      sym.exportDynamic = true;
+    }
     ctx.mainPart->relaDyn->addSymbolReloc(type, *sec, offset, sym, addend,
-                                          type);
+                                          type, shard);
     return;
   }
 
@@ -1106,7 +1127,8 @@ void RelocationScanner::processAux(RelExpr expr, RelType type, uint64_t offset,
       // See "Global Offset Table" in Chapter 5 in the following document
       // for detailed description:
       // ftp://www.linux-mips.org/pub/linux/mips/doc/ABI/mipsabi.pdf
-      ctx.in.mipsGot->addEntry(*sec->file, sym, addend, expr);
+      mipsGotRequests.push_back(
+          {MipsGotRequest::Entry, expr, sec->file, &sym, addend});
     } else if (!sym.isTls() || ctx.arg.emachine != EM_LOONGARCH) {
       // Many LoongArch TLS relocs reuse the R_LOONGARCH_GOT type, in which
       // case the NEEDS_GOT flag shouldn't get set.
@@ -1151,34 +1173,36 @@ void RelocationScanner::processAux(RelExpr expr, RelType type, uint64_t offset,
     RelType rel = ctx.target->getDynRel(type);
     if (oneof<R_GOT, R_LOONGARCH_GOT>(expr) ||
         (rel == ctx.target->symbolicRel && !sym.isPreemptible)) {
-      addRelativeReloc<true>(*sec, offset, sym, addend, expr, type);
+      addRelativeReloc(*sec, offset, sym, addend, expr, type, shard);
       return;
     }
     if (rel != 0) {
       if (ctx.arg.emachine == EM_MIPS && rel == ctx.target->symbolicRel)
         rel = ctx.target->relativeRel;
-      std::lock_guard<std::mutex> lock(relocMutex);
       Partition &part = sec->getPartition();
       if (ctx.arg.emachine == EM_AARCH64 && type == R_AARCH64_AUTH_ABS64) {
         // For a preemptible symbol, we can't use a relative relocation. For an
         // undefined symbol, we can't compute offset at link-time and use a
         // relative relocation. Use a symbolic relocation instead.
         if (sym.isPreemptible) {
-          part.relaDyn->addSymbolReloc(type, *sec, offset, sym, addend, type);
+          part.relaDyn->addSymbolReloc(type, *sec, offset, sym, addend, type,
+                                       shard);
         } else if (part.relrAuthDyn && sec->addralign >= 2 && offset % 2 == 0) {
           // When symbol values are determined in
           // finalizeAddressDependentContent, some .relr.auth.dyn relocations
           // may be moved to .rela.dyn.
           sec->addReloc({expr, type, offset, addend, &sym});
-          part.relrAuthDyn->relocs.push_back({sec, sec->relocs().size() - 1});
+          part.relrAuthDyn->relocsVec[shard].push_back(
+              {sec, sec->relocs().size() - 1});
         } else {
-          part.relaDyn->addReloc({R_AARCH64_AUTH_RELATIVE, sec, offset,
+          part.relaDyn->addReloc(shard,
+                                 {R_AARCH64_AUTH_RELATIVE, sec, offset,
                                   DynamicReloc::AddendOnlyWithTargetVA, sym,
                                   addend, R_ABS});
         }
         return;
       }
-      part.relaDyn->addSymbolReloc(rel, *sec, offset, sym, addend, type);
+      part.relaDyn->addSymbolReloc(rel, *sec, offset, sym, addend, type, shard);
 
       // MIPS ABI turns using of GOT and dynamic relocations inside out.
       // While regular ABI uses dynamic relocations to fill up GOT entries
@@ -1196,7 +1220,8 @@ void RelocationScanner::processAux(RelExpr expr, RelType type, uint64_t offset,
       // a dynamic relocation.
       // ftp://www.linux-mips.org/pub/linux/mips/doc/ABI/mipsabi.pdf p.4-19
       if (ctx.arg.emachine == EM_MIPS)
-        ctx.in.mipsGot->addEntry(*sec->file, sym, addend, expr);
+        mipsGotRequests.push_back(
+            {MipsGotRequest::Entry, expr, sec->file, &sym, addend});
       return;
     }
   }
@@ -1277,16 +1302,19 @@ void RelocationScanner::processAux(RelExpr expr, RelType type, uint64_t offset,
 // pollute other `handleTlsRelocation` by MIPS `ifs` statements.
 // Mips has a custom MipsGotSection that handles the writing of GOT entries
 // without dynamic relocations.
-static unsigned handleMipsTlsRelocation(Ctx &ctx, RelType type, Symbol &sym,
-                                        InputSectionBase &c, uint64_t offset,
-                                        int64_t addend, RelExpr expr) {
+static unsigned
+handleMipsTlsRelocation(RelType type, Symbol &sym, InputSectionBase &c,
+                        uint64_t offset, int64_t addend, RelExpr expr,
+                        SmallVectorImpl<MipsGotRequest> &mipsGotRequests) {
   if (expr == R_MIPS_TLSLD) {
-    ctx.in.mipsGot->addTlsIndex(*c.file);
+    mipsGotRequests.push_back(
+        {MipsGotRequest::TlsIndex, expr, c.file, &sym, 0});
     c.addReloc({expr, type, offset, addend, &sym});
     return 1;
   }
   if (expr == R_MIPS_TLSGD) {
-    ctx.in.mipsGot->addDynTlsEntry(*c.file, sym);
+    mipsGotRequests.push_back(
+        {MipsGotRequest::DynTlsEntry, expr, c.file, &sym, 0});
     c.addReloc({expr, type, offset, addend, &sym});
     return 1;
   }
@@ -1314,7 +1342,8 @@ unsigned RelocationScanner::handleTlsRelocation(RelExpr expr, RelType type,
   }
 
   if (ctx.arg.emachine == EM_MIPS)
-    return handleMipsTlsRelocation(ctx, type, sym, *sec, offset, addend, expr);
+    return handleMipsTlsRelocation(type, sym, *sec, offset, addend, expr,
+                                   mipsGotRequests);
 
   // LoongArch does not yet implement transition from TLSDESC to LE/IE, so
   // generate TLSDESC dynamic relocation for the dynamic linker to handle.
@@ -1437,7 +1466,7 @@ unsigned RelocationScanner::handleTlsRelocation(RelExpr expr, RelType type,
       // R_GOT needs a relative relocation for PIC on i386 and Hexagon.
       if (expr == R_GOT && ctx.arg.isPic &&
           !ctx.target->usesOnlyLowPageBits(type))
-        addRelativeReloc<true>(*sec, offset, sym, addend, expr, type);
+        addRelativeReloc(*sec, offset, sym, addend, expr, type, shard);
       else
         sec->addReloc({expr, type, offset, addend, &sym});
     }
@@ -1488,7 +1517,7 @@ void RelocationScanner::scanOne(typename Relocs<RelTy>::const_iterator &i) {
   // Error if the target symbol is undefined. Symbol index 0 may be used by
   // marker relocations, e.g. R_*_NONE and R_ARM_V4BX. Don't error on them.
   if (sym.isUndefined() && symIndex != 0 &&
-      maybeReportUndefined(ctx, cast<Undefined>(sym), *sec, offset))
+      maybeReportUndefined(ctx, cast<Undefined>(sym), *sec, offset, shard))
     return;
 
   if (ctx.arg.emachine == EM_PPC64) {
@@ -1506,8 +1535,10 @@ void RelocationScanner::scanOne(typename Relocs<RelTy>::const_iterator &i) {
     // Record the TOC entry (.toc + addend) as not relaxable. See the comment in
     // InputSectionBase::relocateAlloc().
     if (type == R_PPC64_TOC16_LO && sym.isSection() && isa<Defined>(sym) &&
-        cast<Defined>(sym).section->name == ".toc")
+        cast<Defined>(sym).section->name == ".toc") {
+      std::lock_guard<std::mutex> lock(relocMutex);
       ctx.ppc64noTocRelax.insert({&sym, addend});
+    }
 
     if ((type == R_PPC64_TLSGD && expr == R_TLSDESC_CALL) ||
         (type == R_PPC64_TLSLD && expr == R_TLSLD_HINT)) {
@@ -1648,51 +1679,87 @@ template <class ELFT> void elf::scanRelocations(Ctx &ctx) {
   // determine if it needs special treatment, such as creating GOT, PLT,
   // copy relocations, etc. Note that relocations for non-alloc sections are
   // directly processed by InputSection::relocateNonAlloc.
-
-  // Deterministic parallellism needs sorting relocations which is unsuitable
-  // for -z nocombreloc. MIPS and PPC64 use global states which are not suitable
-  // for parallelism.
-  bool serial = !ctx.arg.zCombreloc || ctx.arg.emachine == EM_MIPS ||
-                ctx.arg.emachine == EM_PPC64;
-  parallel::TaskGroup tg;
-  auto outerFn = [&]() {
-    for (ELFFileBase *f : ctx.objectFiles) {
-      auto fn = [f, &ctx]() {
-        RelocationScanner scanner(ctx);
-        for (InputSectionBase *s : f->getSections()) {
-          if (s && s->kind() == SectionBase::Regular && s->isLive() &&
-              (s->flags & SHF_ALLOC) &&
-              !(s->type == SHT_ARM_EXIDX && ctx.arg.emachine == EM_ARM))
-            scanner.template scanSection<ELFT>(*s);
-        }
-      };
-      if (serial)
-        fn();
-      else
-        tg.spawn(fn);
+  //
+  // Each object file is scanned by its own task, and .eh_frame and
+  // .ARM.exidx sections by one more task. A task appends dynamic relocations,
+  // undefined symbol diagnostics and MIPS GOT entries to its own shard, and the
+  // shards are merged in task order afterwards, so the result is the same as
+  // that of a serial scan regardless of scheduling.
+  const size_t numShards = ctx.objectFiles.size() + 1;
+  for (Partition &part : ctx.partitions) {
+    part.relaDyn->initShards(numShards);
+    if (part.relrDyn)
+      part.relrDyn->initShards(numShards);
+    if (part.relrAuthDyn)
+      part.relrAuthDyn->initShards(numShards);
+  }
+  undefShards.resize(numShards);
+  SmallVector<RelocationScanner, 0> scanners;
+  scanners.reserve(numShards);
+  for (size_t i = 0; i != numShards; ++i)
+    scanners.emplace_back(ctx, i);
+
+  auto scanFile = [&](size_t i) {
+    RelocationScanner &scanner = scanners[i];
+    for (InputSectionBase *s : ctx.objectFiles[i]->getSections()) {
+      if (s && s->kind() == SectionBase::Regular && s->isLive() &&
+          (s->flags & SHF_ALLOC) &&
+          !(s->type == SHT_ARM_EXIDX && ctx.arg.emachine == EM_ARM))
+        scanner.template scanSection<ELFT>(*s);
     }
-    auto scanEH = [&] {
-      RelocationScanner scanner(ctx);
-      for (Partition &part : ctx.partitions) {
-        for (EhInputSection *sec : part.ehFrame->sections)
-          scanner.template scanSection<ELFT>(*sec, /*isEH=*/true);
-        if (part.armExidx && part.armExidx->isLive())
-          for (InputSection *sec : part.armExidx->exidxSections)
-            if (sec->isLive())
-              scanner.template scanSection<ELFT>(*sec);
-      }
-    };
-    if (serial)
-      scanEH();
-    else
-      tg.spawn(scanEH);
   };
-  // If `serial` is true, call `spawn` to ensure that `scanner` runs in a thread
-  // with valid getThreadIndex().
-  if (serial)
-    tg.spawn(outerFn);
-  else
-    outerFn();
+  auto scanEH = [&] {
+    RelocationScanner &scanner = scanners.back();
+    for (Partition &part : ctx.partitions) {
+      for (EhInputSection *sec : part.ehFrame->sections)
+        scanner.template scanSection<ELFT>(*sec, /*isEH=*/true);
+      if (part.armExidx && part.armExidx->isLive())
+        for (InputSection *sec : part.armExidx->exidxSections)
+          if (sec->isLive())
+            scanner.template scanSection<ELFT>(*sec);
+    }
+  };
+
+  // On PPC64, scanning the sections of a file may set ppc64DisableTLSRelax,
+  // which affects how its .eh_frame relocations are scanned. Scan .eh_frame
+  // after the other sections in that case.
+  const bool ehLast = ctx.arg.emachine == EM_PPC64;
+  {
+    parallel::TaskGroup tg;
+    for (size_t i = 0, e = ctx.objectFiles.size(); i != e; ++i)
+      tg.spawn([&, i] { scanFile(i); });
+    if (!ehLast)
+      tg.spawn(scanEH);
+  }
+  if (ehLast)
+    scanEH();
+
+  for (Partition &part : ctx.partitions) {
+    part.relaDyn->mergeRels();
+    if (part.relrDyn)
+      part.relrDyn->mergeRels();
+    if (part.relrAuthDyn)
+      part.relrAuthDyn->mergeRels();
+  }
+  for (std::vector<UndefinedDiag> &diags : undefShards)
+    undefs.insert(undefs.end(), std::make_move_iterator(diags.begin()),
+                  std::make_move_iterator(diags.end()));
+  undefShards.clear();
+  for (RelocationScanner &scanner : scanners) {
+    for (const MipsGotRequest &req : scanner.mipsGotRequests) {
+      switch (req.kind) {
+      case MipsGotRequest::Entry:
+        ctx.in.mipsGot->addEntry(*req.file, *req.sym, req.addend, req.expr);
+        break;
+      case MipsGotRequest::TlsIndex:
+        ctx.in.mipsGot->addTlsIndex(*req.file);
+        break;
+      case MipsGotRequest::DynTlsEntry:
+        ctx.in.mipsGot->addDynTlsEntry(*req.file, *req.sym);
+        break;
+      }
+    }
+  }
 }
 
 static bool handleNonPreemptibleIfunc(Ctx &ctx, Symbol &sym, uint16_t flags) {
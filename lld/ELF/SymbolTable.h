@@ -44,6 +44,13 @@ public:
   void wrap(Symbol *sym, Symbol *real, Symbol *wrap);
 
   Symbol *insert(StringRef name);
+  // Same as insert(name), but with the key precomputed by getKey(name).
+  Symbol *insert(StringRef name, llvm::CachedHashStringRef key);
+
+  // Returns the key identifying a symbol name in the symbol table.
+  // Computing the key is the part of insert() that does not depend on other
+  // symbols, so it can be done in parallel ahead of time.
+  static llvm::CachedHashStringRef getKey(StringRef name);
 
   template <typename T> Symbol *addSymbol(const T &newSym) {
     Symbol *sym = insert(newSym.getName());
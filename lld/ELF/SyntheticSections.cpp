@@ -1630,17 +1630,18 @@ uint32_t DynamicReloc::getSymIndex(SymbolTableBaseSection *symTab) const {
 RelocationBaseSection::RelocationBaseSection(StringRef name, uint32_t type,
                                              int32_t dynamicTag,
                                              int32_t sizeDynamicTag,
-                                             bool combreloc,
-                                             unsigned concurrency)
+                                             bool combreloc)
     : SyntheticSection(SHF_ALLOC, type, ctx.arg.wordsize, name),
       dynamicTag(dynamicTag), sizeDynamicTag(sizeDynamicTag),
-      relocsVec(concurrency), combreloc(combreloc) {}
+      combreloc(combreloc) {}
 
 void RelocationBaseSection::addSymbolReloc(
     RelType dynType, InputSectionBase &isec, uint64_t offsetInSec, Symbol &sym,
-    int64_t addend, std::optional<RelType> addendRelType) {
+    int64_t addend, std::optional<RelType> addendRelType,
+    std::optional<unsigned> shard) {
   addReloc(DynamicReloc::AgainstSymbol, dynType, isec, offsetInSec, sym, addend,
-           R_ADDEND, addendRelType ? *addendRelType : ctx.target->noneRel);
+           R_ADDEND, addendRelType ? *addendRelType : ctx.target->noneRel,
+           shard);
 }
 
 void RelocationBaseSection::addAddendOnlyRelocIfNonPreemptible(
@@ -1723,12 +1724,10 @@ void RelocationBaseSection::computeRels() {
 }
 
 template <class ELFT>
-RelocationSection<ELFT>::RelocationSection(StringRef name, bool combreloc,
-                                           unsigned concurrency)
+RelocationSection<ELFT>::RelocationSection(StringRef name, bool combreloc)
     : RelocationBaseSection(name, ctx.arg.isRela ? SHT_RELA : SHT_REL,
                             ctx.arg.isRela ? DT_RELA : DT_REL,
-                            ctx.arg.isRela ? DT_RELASZ : DT_RELSZ, combreloc,
-                            concurrency) {
+                            ctx.arg.isRela ? DT_RELASZ : DT_RELSZ, combreloc) {
   this->entsize = ctx.arg.isRela ? sizeof(Elf_Rela) : sizeof(Elf_Rel);
 }
 
@@ -1744,14 +1743,13 @@ template <class ELFT> void RelocationSection<ELFT>::writeTo(uint8_t *buf) {
   }
 }
 
-RelrBaseSection::RelrBaseSection(unsigned concurrency, bool isAArch64Auth)
+RelrBaseSection::RelrBaseSection(bool isAArch64Auth)
     : SyntheticSection(
           SHF_ALLOC,
           isAArch64Auth
               ? SHT_AARCH64_AUTH_RELR
               : (ctx.arg.useAndroidRelrTags ? SHT_ANDROID_RELR : SHT_RELR),
-          ctx.arg.wordsize, isAArch64Auth ? ".relr.auth.dyn" : ".relr.dyn"),
-      relocsVec(concurrency) {}
+          ctx.arg.wordsize, isAArch64Auth ? ".relr.auth.dyn" : ".relr.dyn") {}
 
 void RelrBaseSection::mergeRels() {
   size_t newSize = relocs.size();
@@ -1765,12 +1763,12 @@ void RelrBaseSection::mergeRels() {
 
 template <class ELFT>
 AndroidPackedRelocationSection<ELFT>::AndroidPackedRelocationSection(
-    StringRef name, unsigned concurrency)
+    StringRef name)
     : RelocationBaseSection(
           name, ctx.arg.isRela ? SHT_ANDROID_RELA : SHT_ANDROID_REL,
           ctx.arg.isRela ? DT_ANDROID_RELA : DT_ANDROID_REL,
           ctx.arg.isRela ? DT_ANDROID_RELASZ : DT_ANDROID_RELSZ,
-          /*combreloc=*/false, concurrency) {
+          /*combreloc=*/false) {
   this->entsize = 1;
 }
 
@@ -2018,8 +2016,8 @@ bool AndroidPackedRelocationSection<ELFT>::updateAllocSize() {
 }
 
 template <class ELFT>
-RelrSection<ELFT>::RelrSection(unsigned concurrency, bool isAArch64Auth)
-    : RelrBaseSection(concurrency, isAArch64Auth) {
+RelrSection<ELFT>::RelrSection(bool isAArch64Auth)
+    : RelrBaseSection(isAArch64Auth) {
   this->entsize = ctx.arg.wordsize;
 }
 
@@ -4706,7 +4704,6 @@ template <class ELFT> void elf::createSyntheticSections(Ctx &ctx) {
 
   StringRef relaDynName = ctx.arg.isRela ? ".rela.dyn" : ".rel.dyn";
 
-  const unsigned threadCount = ctx.arg.threadCount;
   for (Partition &part : ctx.partitions) {
     auto add = [&](SyntheticSection &sec) {
       sec.partition = part.getNumber();
@@ -4749,11 +4746,11 @@ template <class ELFT> void elf::createSyntheticSections(Ctx &ctx) {
     }
 
     if (ctx.arg.androidPackDynRelocs)
-      part.relaDyn = std::make_unique<AndroidPackedRelocationSection<ELFT>>(
-          relaDynName, threadCount);
+      part.relaDyn =
+          std::make_unique<AndroidPackedRelocationSection<ELFT>>(relaDynName);
     else
       part.relaDyn = std::make_unique<RelocationSection<ELFT>>(
-          relaDynName, ctx.arg.zCombreloc, threadCount);
+          relaDynName, ctx.arg.zCombreloc);
 
     if (ctx.arg.hasDynSymTab) {
       add(*part.dynSymTab);
@@ -4785,10 +4782,10 @@ template <class ELFT> void elf::createSyntheticSections(Ctx &ctx) {
     add(*part.relaDyn);
 
     if (ctx.arg.relrPackDynRelocs) {
-      part.relrDyn = std::make_unique<RelrSection<ELFT>>(threadCount);
+      part.relrDyn = std::make_unique<RelrSection<ELFT>>();
       add(*part.relrDyn);
-      part.relrAuthDyn = std::make_unique<RelrSection<ELFT>>(
-          threadCount, /*isAArch64Auth=*/true);
+      part.relrAuthDyn =
+          std::make_unique<RelrSection<ELFT>>(/*isAArch64Auth=*/true);
       add(*part.relrAuthDyn);
     }
 
@@ -4878,8 +4875,7 @@ template <class ELFT> void elf::createSyntheticSections(Ctx &ctx) {
   // We always need to add rel[a].plt to output if it has entries.
   // Even for static linking it can contain R_[*]_IRELATIVE relocations.
   ctx.in.relaPlt = std::make_unique<RelocationSection<ELFT>>(
-      ctx.arg.isRela ? ".rela.plt" : ".rel.plt", /*sort=*/false,
-      /*threadCount=*/1);
+      ctx.arg.isRela ? ".rela.plt" : ".rel.plt", /*sort=*/false);
   add(*ctx.in.relaPlt);
 
   if ((ctx.arg.emachine == EM_386 || ctx.arg.emachine == EM_X86_64) &&
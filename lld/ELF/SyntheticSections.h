@@ -496,30 +496,32 @@ private:
 class RelocationBaseSection : public SyntheticSection {
 public:
   RelocationBaseSection(StringRef name, uint32_t type, int32_t dynamicTag,
-                        int32_t sizeDynamicTag, bool combreloc,
-                        unsigned concurrency);
+                        int32_t sizeDynamicTag, bool combreloc);
   /// Add a dynamic relocation without writing an addend to the output section.
   /// This overload can be used if the addends are written directly instead of
   /// using relocations on the input section (e.g. MipsGotSection::writeTo()).
-  template <bool shard = false> void addReloc(const DynamicReloc &reloc) {
-    relocs.push_back(reloc);
+  void addReloc(const DynamicReloc &reloc) { relocs.push_back(reloc); }
+  /// Add a dynamic relocation to the shard of a relocation scanning task.
+  void addReloc(unsigned shard, const DynamicReloc &reloc) {
+    relocsVec[shard].push_back(reloc);
   }
   /// Add a dynamic relocation against \p sym with an optional addend.
   void addSymbolReloc(RelType dynType, InputSectionBase &isec,
                       uint64_t offsetInSec, Symbol &sym, int64_t addend = 0,
-                      std::optional<RelType> addendRelType = {});
+                      std::optional<RelType> addendRelType = {},
+                      std::optional<unsigned> shard = {});
   /// Add a relative dynamic relocation that uses the target address of \p sym
   /// (i.e. InputSection::getRelocTargetVA()) + \p addend as the addend.
   /// This function should only be called for non-preemptible symbols or
   /// RelExpr values that refer to an address inside the output file (e.g. the
   /// address of the GOT entry for a potentially preemptible symbol).
-  template <bool shard = false>
   void addRelativeReloc(RelType dynType, InputSectionBase &isec,
                         uint64_t offsetInSec, Symbol &sym, int64_t addend,
-                        RelType addendRelType, RelExpr expr) {
+                        RelType addendRelType, RelExpr expr,
+                        std::optional<unsigned> shard = {}) {
     assert(expr != R_ADDEND && "expected non-addend relocation expression");
-    addReloc<shard>(DynamicReloc::AddendOnlyWithTargetVA, dynType, isec,
-                    offsetInSec, sym, addend, expr, addendRelType);
+    addReloc(DynamicReloc::AddendOnlyWithTargetVA, dynType, isec, offsetInSec,
+             sym, addend, expr, addendRelType, shard);
   }
   /// Add a dynamic relocation using the target address of \p sym as the addend
   /// if \p sym is non-preemptible. Otherwise add a relocation against \p sym.
@@ -527,15 +529,18 @@ public:
                                           InputSectionBase &isec,
                                           uint64_t offsetInSec, Symbol &sym,
                                           RelType addendRelType);
-  template <bool shard = false>
   void addReloc(DynamicReloc::Kind kind, RelType dynType, InputSectionBase &sec,
                 uint64_t offsetInSec, Symbol &sym, int64_t addend, RelExpr expr,
-                RelType addendRelType) {
+                RelType addendRelType, std::optional<unsigned> shard = {}) {
     // Write the addends to the relocated address if required. We skip
     // it if the written value would be zero.
     if (ctx.arg.writeAddends && (expr != R_ADDEND || addend != 0))
       sec.addReloc({expr, addendRelType, offsetInSec, addend, &sym});
-    addReloc<shard>({dynType, &sec, offsetInSec, kind, sym, addend, expr});
+    DynamicReloc reloc(dynType, &sec, offsetInSec, kind, sym, addend, expr);
+    if (shard)
+      addReloc(*shard, reloc);
+    else
+      addReloc(reloc);
   }
   bool isNeeded() const override {
     return !relocs.empty() ||
@@ -543,6 +548,7 @@ public:
   }
   size_t getSize() const override { return relocs.size() * this->entsize; }
   size_t getRelativeRelocCount() const { return numRelativeRelocs; }
+  void initShards(size_t numShards) { relocsVec.resize(numShards); }
   void mergeRels();
   void partitionRels();
   void finalizeContents() override;
@@ -558,25 +564,20 @@ public:
 
 protected:
   void computeRels();
-  // Used when parallel relocation scanning adds relocations. The elements
-  // will be moved into relocs by mergeRel().
+  // Used when parallel relocation scanning adds relocations. Each scanning
+  // task owns one shard, and mergeRels() appends them to relocs in order.
   SmallVector<SmallVector<DynamicReloc, 0>, 0> relocsVec;
   size_t numRelativeRelocs = 0; // used by -z combreloc
   bool combreloc;
 };
 
-template <>
-inline void RelocationBaseSection::addReloc<true>(const DynamicReloc &reloc) {
-  relocsVec[llvm::parallel::getThreadIndex()].push_back(reloc);
-}
-
 template <class ELFT>
 class RelocationSection final : public RelocationBaseSection {
   using Elf_Rel = typename ELFT::Rel;
   using Elf_Rela = typename ELFT::Rela;
 
 public:
-  RelocationSection(StringRef name, bool combreloc, unsigned concurrency);
+  RelocationSection(StringRef name, bool combreloc);
   void writeTo(uint8_t *buf) override;
 };
 
@@ -586,7 +587,7 @@ class AndroidPackedRelocationSection final : public RelocationBaseSection {
   using Elf_Rela = typename ELFT::Rela;
 
 public:
-  AndroidPackedRelocationSection(StringRef name, unsigned concurrency);
+  AndroidPackedRelocationSection(StringRef name);
 
   bool updateAllocSize() override;
   size_t getSize() const override { return relocData.size(); }
@@ -609,7 +610,8 @@ struct RelativeReloc {
 
 class RelrBaseSection : public SyntheticSection {
 public:
-  RelrBaseSection(unsigned concurrency, bool isAArch64Auth = false);
+  RelrBaseSection(bool isAArch64Auth = false);
+  void initShards(size_t numShards) { relocsVec.resize(numShards); }
   void mergeRels();
   bool isNeeded() const override {
     return !relocs.empty() ||
@@ -627,7 +629,7 @@ template <class ELFT> class RelrSection final : public RelrBaseSection {
   using Elf_Relr = typename ELFT::Relr;
 
 public:
-  RelrSection(unsigned concurrency, bool isAArch64Auth = false);
+  RelrSection(bool isAArch64Auth = false);
 
   bool updateAllocSize() override;
   size_t getSize() const override { return relrRelocs.size() * this->entsize; }
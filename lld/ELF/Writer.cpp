@@ -9,6 +9,7 @@
 #include "Writer.h"
 #include "AArch64ErrataFix.h"
 #include "ARMErrataFix.h"
+#include "BPSectionOrderer.h"
 #include "CallGraphSort.h"
 #include "Config.h"
 #include "InputFiles.h"
@@ -79,6 +80,8 @@ private:
   void writeSections();
   void writeSectionsBinary();
   void writeBuildId();
+  bool updateOutputInPlace(ArrayRef<uint64_t> chunkHashes);
+  void writeIncrementalState(ArrayRef<uint64_t> chunkHashes);
 
   Ctx &ctx;
   std::unique_ptr<FileOutputBuffer> &buffer;
@@ -303,6 +306,88 @@ static OutputSection *findSection(Ctx &ctx, StringRef name,
   return nullptr;
 }
 
+// --incremental-state=<file> records the identity of the output file and a
+// hash of each fixed-size chunk of its contents. When the next link produces
+// an image of the same size and the output file is still the one we wrote
+// last time, only the chunks whose hashes differ are rewritten in place. For
+// large debug builds where a small edit keeps most of the layout intact, this
+// avoids writing back gigabytes of unchanged pages.
+//
+// The format is line-oriented text:
+//
+//   lld-incremental-state 1
+//   size <output file size>
+//   id <device> <inode>
+//   mtime <nanoseconds since epoch>
+//   <xxh3 hash of chunk 0 in hex>
+//   <xxh3 hash of chunk 1 in hex>
+//   ...
+static constexpr size_t incrementalChunkSize = 64 * 1024;
+static constexpr char incrementalStateMagic[] = "lld-incremental-state 1";
+
+namespace {
+struct IncrementalState {
+  uint64_t fileSize = 0;
+  uint64_t device = 0;
+  uint64_t inode = 0;
+  int64_t mtime = 0;
+  SmallVector<uint64_t, 0> chunkHashes;
+};
+} // namespace
+
+static SmallVector<uint64_t, 0> hashChunks(ArrayRef<uint8_t> data) {
+  SmallVector<uint64_t, 0> hashes(
+      divideCeil(data.size(), incrementalChunkSize));
+  parallelFor(0, hashes.size(), [&](size_t i) {
+    hashes[i] = xxh3_64bits(
+        data.slice(i * incrementalChunkSize).take_front(incrementalChunkSize));
+  });
+  return hashes;
+}
+
+static std::optional<IncrementalState> readIncrementalState(StringRef path) {
+  ErrorOr<std::unique_ptr<MemoryBuffer>> mbOrErr = MemoryBuffer::getFile(
+      path, /*IsText=*/false, /*RequiresNullTerminator=*/false);
+  if (!mbOrErr)
+    return std::nullopt;
+
+  SmallVector<StringRef, 0> lines;
+  (*mbOrErr)->getBuffer().split(lines, '\n', -1, /*KeepEmpty=*/false);
+  if (lines.size() < 4 || lines[0] != incrementalStateMagic)
+    return std::nullopt;
+
+  IncrementalState state;
+  auto [dev, ino] = lines[2].split(' ');
+  if (!lines[1].consume_front("size ") ||
+      lines[1].getAsInteger(10, state.fileSize) || !dev.consume_front("id ") ||
+      dev.getAsInteger(10, state.device) || ino.getAsInteger(10, state.inode) ||
+      !lines[3].consume_front("mtime ") ||
+      lines[3].getAsInteger(10, state.mtime))
+    return std::nullopt;
+
+  for (StringRef line : ArrayRef(lines).drop_front(4)) {
+    uint64_t hash;
+    if (line.getAsInteger(16, hash))
+      return std::nullopt;
+    state.chunkHashes.push_back(hash);
+  }
+  if (state.chunkHashes.size() !=
+      divideCeil(state.fileSize, incrementalChunkSize))
+    return std::nullopt;
+  return state;
+}
+
+// Returns true if the output file on disk is the file described by state.
+static bool isRecordedOutput(StringRef path, const IncrementalState &state) {
+  sys::fs::file_status st;
+  if (sys::fs::status(path, st) ||
+      st.type() != sys::fs::file_type::regular_file)
+    return false;
+  return st.getSize() == state.fileSize &&
+         st.getUniqueID() == sys::fs::UniqueID(state.device, state.inode) &&
+         st.getLastModificationTime().time_since_epoch().count() == state.mtime;
+}
+
 // The main function of the writer.
 template <class ELFT> void Writer<ELFT>::run() {
   // Now that we have a complete set of output sections. This function
@@ -372,9 +457,23 @@ template <class ELFT> void Writer<ELFT>::run() {
     if (errorCount())
       return;
 
-    if (auto e = buffer->commit())
-      fatal("failed to write output '" + buffer->getPath() +
-            "': " + toString(std::move(e)));
+    if (ctx.arg.incrementalState.empty()) {
+      if (auto e = buffer->commit())
+        fatal("failed to write output '" + buffer->getPath() +
+              "': " + toString(std::move(e)));
+    } else {
+      // The output was built in memory. Patch the changed chunks of the
+      // previous output file if possible, otherwise write the whole file.
+      SmallVector<uint64_t, 0> chunkHashes =
+          hashChunks({ctx.bufferStart, size_t(fileSize)});
+      if (!updateOutputInPlace(chunkHashes)) {
+        unlinkAsync(ctx.arg.outputFile);
+        if (auto e = buffer->commit())
+          fatal("failed to write output '" + buffer->getPath() +
+                "': " + toString(std::move(e)));
+      }
+      writeIncrementalState(chunkHashes);
+    }
 
     if (!ctx.arg.cmseOutputLib.empty())
       writeARMCmseImportLib<ELFT>();
@@ -1067,9 +1166,21 @@ static void maybeShuffle(Ctx &ctx,
   }
 }
 
-// Builds section order for handling --symbol-ordering-file.
+// Builds section order for handling --symbol-ordering-file and the
+// balanced-partitioning --bp-* options.
 static DenseMap<const InputSectionBase *, int> buildSectionOrder(Ctx &ctx) {
   DenseMap<const InputSectionBase *, int> sectionOrder;
+  if (ctx.arg.bpStartupFunctionSort || ctx.arg.bpFunctionOrderForCompression ||
+      ctx.arg.bpDataOrderForCompression) {
+    TimeTraceScope timeScope("Balanced Partitioning Section Orderer");
+    return runBalancedPartitioning(
+        ctx, ctx.arg.bpStartupFunctionSort ? ctx.arg.irpgoProfilePath : "",
+        ctx.arg.bpFunctionOrderForCompression,
+        ctx.arg.bpDataOrderForCompression,
+        ctx.arg.bpCompressionSortStartupFunctions,
+        ctx.arg.bpVerboseSectionOrderer);
+  }
+
   // Use the rarely used option --call-graph-ordering-file to sort sections.
   if (!ctx.arg.callGraphProfile.empty())
     return computeCallGraphProfileOrder();
@@ -2002,19 +2113,14 @@ template <class ELFT> void Writer<ELFT>::finalizeSections() {
     // symbol table section (dynSymTab) must be the first one.
     for (Partition &part : ctx.partitions) {
       if (part.relaDyn) {
-        part.relaDyn->mergeRels();
         // Compute DT_RELACOUNT to be used by part.dynamic.
         part.relaDyn->partitionRels();
         finalizeSynthetic(part.relaDyn.get());
       }
-      if (part.relrDyn) {
-        part.relrDyn->mergeRels();
+      if (part.relrDyn)
         finalizeSynthetic(part.relrDyn.get());
-      }
-      if (part.relrAuthDyn) {
-        part.relrAuthDyn->mergeRels();
+      if (part.relrAuthDyn)
         finalizeSynthetic(part.relrAuthDyn.get());
-      }
 
       finalizeSynthetic(part.dynSymTab.get());
       finalizeSynthetic(part.gnuHashTab.get());
@@ -2784,11 +2890,14 @@ template <class ELFT> void Writer<ELFT>::openFile() {
     return;
   }
 
-  unlinkAsync(ctx.arg.outputFile);
+  // With --incremental-state=, the previous output may be updated in place, so
+  // keep it until we know whether that is possible.
+  if (ctx.arg.incrementalState.empty())
+    unlinkAsync(ctx.arg.outputFile);
   unsigned flags = 0;
   if (!ctx.arg.relocatable)
     flags |= FileOutputBuffer::F_executable;
-  if (!ctx.arg.mmapOutputFile)
+  if (!ctx.arg.mmapOutputFile || !ctx.arg.incrementalState.empty())
     flags |= FileOutputBuffer::F_no_mmap;
   Expected<std::unique_ptr<FileOutputBuffer>> bufferOrErr =
       FileOutputBuffer::create(ctx.arg.outputFile, fileSize, flags);
@@ -2860,10 +2969,35 @@ template <class ELFT> void Writer<ELFT>::writeSections() {
         sec->writeTo<ELFT>(ctx.bufferStart + sec->offset, tg);
   }
   {
-    parallel::TaskGroup tg;
+    // Write the other sections in file offset order, in windows of about
+    // outputWindowSize bytes. Once a window is complete, ask the output buffer
+    // to start writing it back to the file, so that writing a large output
+    // overlaps with producing the rest of it instead of leaving the whole
+    // image dirty in memory until commit. The last window is left to commit.
+    SmallVector<OutputSection *, 0> secs;
     for (OutputSection *sec : ctx.outputSections)
       if (!isStaticRelSecType(sec->type))
-        sec->writeTo<ELFT>(ctx.bufferStart + sec->offset, tg);
+        secs.push_back(sec);
+    llvm::stable_sort(secs, [](const OutputSection *a, const OutputSection *b) {
+      return a->offset < b->offset;
+    });
+
+    constexpr uint64_t outputWindowSize = 256 * 1024 * 1024;
+    for (size_t i = 0, e = secs.size(); i != e;) {
+      uint64_t begin = secs[i]->offset;
+      uint64_t end = begin;
+      {
+        parallel::TaskGroup tg;
+        do {
+          OutputSection *sec = secs[i++];
+          sec->writeTo<ELFT>(ctx.bufferStart + sec->offset, tg);
+          if (sec->type != SHT_NOBITS)
+            end = std::max(end, sec->offset + sec->size);
+        } while (i != e && end - begin < outputWindowSize);
+      }
+      if (i != e)
+        buffer->flushRange(begin, end - begin);
+    }
   }
 
   // Finally, check that all dynamic relocation addends were written correctly.
@@ -2944,6 +3078,73 @@ template <class ELFT> void Writer<ELFT>::writeBuildId() {
     part.buildId->writeBuildId(output);
 }
 
+// Try to update the previous output file in place, writing only the chunks
+// that differ from the recorded state. Returns false if the caller has to
+// write the whole file instead.
+template <class ELFT>
+bool Writer<ELFT>::updateOutputInPlace(ArrayRef<uint64_t> chunkHashes) {
+  StringRef path = ctx.arg.outputFile;
+  if (path == "-")
+    return false;
+  std::optional<IncrementalState> state =
+      readIncrementalState(ctx.arg.incrementalState);
+  if (!state || state->fileSize != fileSize || !isRecordedOutput(path, *state))
+    return false;
+
+  // Remove the state file first so that an interrupted update is never
+  // mistaken for a consistent output file by the next link.
+  sys::fs::remove(ctx.arg.incrementalState);
+
+  int fd;
+  if (sys::fs::openFileForReadWrite(path, fd, sys::fs::CD_OpenExisting,
+                                    sys::fs::OF_None))
+    return false;
+  raw_fd_ostream os(fd, /*shouldClose=*/true, /*unbuffered=*/true);
+  size_t numWritten = 0;
+  for (size_t i = 0, e = chunkHashes.size(); i != e; ++i) {
+    if (chunkHashes[i] == state->chunkHashes[i])
+      continue;
+    uint64_t off = i * incrementalChunkSize;
+    os.seek(off);
+    os.write(reinterpret_cast<const char *>(ctx.bufferStart) + off,
+             std::min<uint64_t>(incrementalChunkSize, fileSize - off));
+    ++numWritten;
+  }
+  os.close();
+  if (os.has_error()) {
+    os.clear_error();
+    return false;
+  }
+  buffer->discard();
+  log("--incremental-state: updated " + Twine(numWritten) + " of " +
+      Twine(chunkHashes.size()) + " chunks of " + path + " in place");
+  return true;
+}
+
+template <class ELFT>
+void Writer<ELFT>::writeIncrementalState(ArrayRef<uint64_t> chunkHashes) {
+  StringRef path = ctx.arg.outputFile;
+  sys::fs::file_status st;
+  if (path == "-" || sys::fs::status(path, st))
+    return;
+
+  std::error_code ec;
+  raw_fd_ostream os(ctx.arg.incrementalState, ec, sys::fs::OF_None);
+  if (ec) {
+    error("cannot open --incremental-state= file " + ctx.arg.incrementalState +
+          ": " + ec.message());
+    return;
+  }
+  sys::fs::UniqueID id = st.getUniqueID();
+  os << incrementalStateMagic << '\n'
+     << "size " << st.getSize() << '\n'
+     << "id " << id.getDevice() << ' ' << id.getFile() << '\n'
+     << "mtime " << st.getLastModificationTime().time_since_epoch().count()
+     << '\n';
+  for (uint64_t hash : chunkHashes)
+    os << utohexstr(hash, /*LowerCase=*/true) << '\n';
+}
+
 template void elf::writeResult<ELF32LE>(Ctx &);
 template void elf::writeResult<ELF32BE>(Ctx &);
 template void elf::writeResult<ELF64LE>(Ctx &);
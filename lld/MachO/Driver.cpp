@@ -2040,6 +2040,8 @@ bool link(ArrayRef<const char *> argsArr, llvm::raw_ostream &stdoutOS,
   config->timeTraceEnabled = args.hasArg(OPT_time_trace_eq);
   config->timeTraceGranularity =
       args::getInteger(args, OPT_time_trace_granularity_eq, 500);
+  parallel::traceTasks =
+      config->timeTraceEnabled && args.hasArg(OPT_time_trace_threads);
 
   // Initialize time trace profiler.
   if (config->timeTraceEnabled)
@@ -41,6 +41,7 @@
 #include "lld/Common/Memory.h"
 #include "llvm/BinaryFormat/MachO.h"
 #include "llvm/Support/LEB128.h"
+#include "llvm/Support/Parallel.h"
 #include <optional>
 
 using namespace llvm;
@@ -91,8 +92,9 @@ struct macho::TrieNode {
   size_t offset = 0;
 
   uint32_t getTerminalSize() const;
-  // Returns whether the new estimated offset differs from the old one.
-  bool updateOffset(size_t &nextOffset);
+  // Returns the size of the serialized node, given the current estimated
+  // offsets of its children.
+  size_t getNodeSize() const;
   void writeTo(uint8_t *buf) const;
 };
 
@@ -134,7 +136,7 @@ uint32_t TrieNode::getTerminalSize() const {
   return size;
 }
 
-bool TrieNode::updateOffset(size_t &nextOffset) {
+size_t TrieNode::getNodeSize() const {
   // Size of the whole node (including the terminalSize and the outgoing edges.)
   // In contrast, terminalSize only records the size of the other data in the
   // node.
@@ -153,12 +155,7 @@ bool TrieNode::updateOffset(size_t &nextOffset) {
     nodeSize += edge.substring.size() + 1             // String length.
                 + getULEB128Size(edge.child->offset); // Offset len.
   }
-  // On input, 'nextOffset' is the new preferred location for this node.
-  bool result = (offset != nextOffset);
-  // Store new location in node object for use by parents.
-  offset = nextOffset;
-  nextOffset += nodeSize;
-  return result;
+  return nodeSize;
 }
 
 void TrieNode::writeTo(uint8_t *buf) const {
@@ -194,12 +191,6 @@ TrieBuilder::~TrieBuilder() {
     delete node;
 }
 
-TrieNode *TrieBuilder::makeNode() {
-  auto *node = new TrieNode();
-  nodes.emplace_back(node);
-  return node;
-}
-
 static int charAt(const Symbol *sym, size_t pos) {
   StringRef str = sym->getName();
   if (pos >= str.size())
@@ -218,8 +209,14 @@ static int charAt(const Symbol *sym, size_t pos) {
 //          of characters along its path from the root.
 // pos:     The string index we are currently sorting on. Note that each symbol
 //          S contained in vec has the same prefix S[0...pos).
+//
+// Once a node is created, the rest of the call only adds edges to that node and
+// its descendants, so building a large enough subtree is spawned as a separate
+// task. The nodes are numbered afterwards, in the order a serial build would
+// create them.
 void TrieBuilder::sortAndBuild(MutableArrayRef<const Symbol *> vec,
-                               TrieNode *node, size_t lastPos, size_t pos) {
+                               TrieNode *node, size_t lastPos, size_t pos,
+                               parallel::TaskGroup &tg) {
 tailcall:
   if (vec.empty())
     return;
@@ -244,15 +241,24 @@ tailcall:
   bool isTerminal = pivot == -1;
   bool prefixesDiverge = i != 0 || j != vec.size();
   if (lastPos != pos && (isTerminal || prefixesDiverge)) {
-    TrieNode *newNode = makeNode();
+    TrieNode *newNode = new TrieNode();
     node->edges.emplace_back(pivotSymbol->getName().slice(lastPos, pos),
                              newNode);
+    // Small subtrees are built inline; tasks would cost more than they save.
+    if (vec.size() >= 4096 && !isTerminal) {
+      tg.spawn([this, vec, newNode, i, j, pos, &tg] {
+        sortAndBuild(vec.slice(0, i), newNode, pos, pos, tg);
+        sortAndBuild(vec.slice(j), newNode, pos, pos, tg);
+        sortAndBuild(vec.slice(i, j - i), newNode, pos, pos + 1, tg);
+      });
+      return;
+    }
     node = newNode;
     lastPos = pos;
   }
 
-  sortAndBuild(vec.slice(0, i), node, lastPos, pos);
-  sortAndBuild(vec.slice(j), node, lastPos, pos);
+  sortAndBuild(vec.slice(0, i), node, lastPos, pos, tg);
+  sortAndBuild(vec.slice(j), node, lastPos, pos, tg);
 
   if (isTerminal) {
     assert(j - i == 1); // no duplicate symbols
@@ -270,26 +276,45 @@ size_t TrieBuilder::build() {
   if (exported.empty())
     return 0;
 
-  TrieNode *root = makeNode();
-  sortAndBuild(exported, root, 0, 0);
+  auto *root = new TrieNode();
+  {
+    parallel::TaskGroup tg;
+    sortAndBuild(exported, root, 0, 0, tg);
+  }
+
+  // Number the nodes in depth-first order, visiting children in edge order.
+  SmallVector<TrieNode *, 0> worklist = {root};
+  while (!worklist.empty()) {
+    TrieNode *node = worklist.pop_back_val();
+    nodes.push_back(node);
+    for (const Edge &edge : llvm::reverse(node->edges))
+      worklist.push_back(edge.child);
+  }
 
   // Assign each node in the vector an offset in the trie stream, iterating
-  // until all uleb128 sizes have stabilized.
+  // until all uleb128 sizes have stabilized. The size of a node depends only
+  // on the offsets of its children, so the sizes of all nodes can be computed
+  // in parallel from the offsets of the previous iteration.
+  std::vector<size_t> sizes(nodes.size());
   size_t offset;
   bool more;
   do {
+    parallelFor(0, nodes.size(),
+                [&](size_t i) { sizes[i] = nodes[i]->getNodeSize(); });
     offset = 0;
     more = false;
-    for (TrieNode *node : nodes)
-      more |= node->updateOffset(offset);
+    for (auto [node, size] : llvm::zip_equal(nodes, sizes)) {
+      more |= node->offset != offset;
+      node->offset = offset;
+      offset += size;
+    }
   } while (more);
 
   return offset;
 }
 
 void TrieBuilder::writeTo(uint8_t *buf) const {
-  for (TrieNode *node : nodes)
-    node->writeTo(buf);
+  parallelForEach(nodes, [&](const TrieNode *node) { node->writeTo(buf); });
 }
 
 namespace {
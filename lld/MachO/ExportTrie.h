@@ -14,6 +14,10 @@
 
 #include <vector>
 
+namespace llvm::parallel {
+class TaskGroup;
+} // namespace llvm::parallel
+
 namespace lld::macho {
 
 struct TrieNode;
@@ -29,9 +33,8 @@ public:
   void writeTo(uint8_t *buf) const;
 
 private:
-  TrieNode *makeNode();
   void sortAndBuild(llvm::MutableArrayRef<const Symbol *> vec, TrieNode *node,
-                    size_t lastPos, size_t pos);
+                    size_t lastPos, size_t pos, llvm::parallel::TaskGroup &tg);
 
   uint64_t imageBase = 0;
   std::vector<const Symbol *> exported;
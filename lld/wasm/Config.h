@@ -79,6 +79,7 @@ struct Configuration {
   // Because dyamanic linking under Wasm is still experimental we default to
   // static linking
   bool isStatic = true;
+  bool timeTraceEnabled;
   bool trace;
   uint64_t globalBase;
   uint64_t initialHeap;
@@ -95,6 +96,7 @@ struct Configuration {
   unsigned ltoo;
   llvm::CodeGenOptLevel ltoCgo;
   unsigned optimize;
+  unsigned timeTraceGranularity;
   llvm::StringRef thinLTOJobs;
   bool ltoDebugPassManager;
   UnresolvedPolicy unresolvedSymbols;
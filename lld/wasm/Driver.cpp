@@ -32,6 +32,7 @@
 #include "llvm/Support/Process.h"
 #include "llvm/Support/TarWriter.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/TimeProfiler.h"
 #include "llvm/TargetParser/Host.h"
 #include <optional>
 
@@ -94,6 +95,7 @@ public:
   void linkerMain(ArrayRef<const char *> argsArr);
 
 private:
+  void link(opt::InputArgList &args);
   void createFiles(opt::InputArgList &args);
   void addFile(StringRef path);
   void addLibrary(StringRef name);
@@ -564,6 +566,11 @@ static void readConfigs(opt::InputArgList &args) {
   config->stripAll = args.hasArg(OPT_strip_all);
   config->stripDebug = args.hasArg(OPT_strip_debug);
   config->stackFirst = args.hasArg(OPT_stack_first);
+  config->timeTraceEnabled = args.hasArg(OPT_time_trace_eq);
+  config->timeTraceGranularity =
+      args::getInteger(args, OPT_time_trace_granularity, 500);
+  parallel::traceTasks =
+      config->timeTraceEnabled && args.hasArg(OPT_time_trace_threads);
   config->trace = args.hasArg(OPT_trace);
   config->thinLTOCacheDir = args.getLastArgValue(OPT_thinlto_cache_dir);
   config->thinLTOCachePolicy = CHECK(
@@ -1248,7 +1255,27 @@ void LinkerDriver::linkerMain(ArrayRef<const char *> argsArr) {
   readConfigs(args);
   setConfigs();
 
-  createFiles(args);
+  // Initialize time trace profiler.
+  if (config->timeTraceEnabled)
+    timeTraceProfilerInitialize(config->timeTraceGranularity, argsArr[0]);
+
+  {
+    llvm::TimeTraceScope timeScope("ExecuteLinker");
+    link(args);
+  }
+
+  if (config->timeTraceEnabled) {
+    checkError(timeTraceProfilerWrite(
+        args.getLastArgValue(OPT_time_trace_eq).str(), config->outputFile));
+    timeTraceProfilerCleanup();
+  }
+}
+
+void LinkerDriver::link(opt::InputArgList &args) {
+  {
+    llvm::TimeTraceScope timeScope("Create input files");
+    createFiles(args);
+  }
   if (errorCount())
     return;
 
@@ -1362,7 +1389,10 @@ void LinkerDriver::linkerMain(ArrayRef<const char *> argsArr) {
 
   // Do link-time optimization if given files are LLVM bitcode files.
   // This compiles bitcode files into real object files.
-  symtab->compileBitcodeFiles();
+  {
+    llvm::TimeTraceScope timeScope("LTO");
+    symtab->compileBitcodeFiles();
+  }
   if (errorCount())
     return;
 
@@ -1406,13 +1436,19 @@ void LinkerDriver::linkerMain(ArrayRef<const char *> argsArr) {
 
   // Split WASM_SEG_FLAG_STRINGS sections into pieces in preparation for garbage
   // collection.
-  splitSections();
+  {
+    llvm::TimeTraceScope timeScope("Split sections");
+    splitSections();
+  }
 
   // Any remaining lazy symbols should be demoted to Undefined
   demoteLazySymbols();
 
   // Do size optimizations: garbage collection
-  markLive();
+  {
+    llvm::TimeTraceScope timeScope("Mark live");
+    markLive();
+  }
 
   // Provide the indirect function table if needed.
   WasmSym::indirectFunctionTable =
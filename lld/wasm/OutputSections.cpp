@@ -77,9 +77,10 @@ void CodeSection::writeTo(uint8_t *buf) {
   // Write code section headers
   memcpy(buf, codeSectionHeader.data(), codeSectionHeader.size());
 
-  // Write code section bodies
-  for (const InputChunk *chunk : functions)
-    chunk->writeTo(buf);
+  // Write code section bodies. Each function has its own slice of the output,
+  // so they can be copied and relocated in parallel.
+  parallelForEach(functions,
+                  [&](const InputChunk *chunk) { chunk->writeTo(buf); });
 }
 
 uint32_t CodeSection::getNumRelocations() const {
@@ -172,9 +173,9 @@ void DataSection::writeTo(uint8_t *buf) {
   // Write data section headers
   memcpy(buf, dataSectionHeader.data(), dataSectionHeader.size());
 
-  for (const OutputSegment *segment : segments) {
+  parallelForEach(segments, [&](const OutputSegment *segment) {
     if (!segment->requiredInBinary())
-      continue;
+      return;
     // Write data segment header
     uint8_t *segStart = buf + segment->sectionOffset;
     memcpy(segStart, segment->header.data(), segment->header.size());
@@ -182,7 +183,7 @@ void DataSection::writeTo(uint8_t *buf) {
     // Write segment data payload
     for (const InputChunk *chunk : segment->inputSegments)
       chunk->writeTo(buf);
-  }
+  });
 }
 
 uint32_t DataSection::getNumRelocations() const {
@@ -264,9 +265,10 @@ void CustomSection::writeTo(uint8_t *buf) {
   memcpy(buf, nameData.data(), nameData.size());
   buf += nameData.size();
 
-  // Write custom sections payload
-  for (const InputChunk *section : inputSections)
-    section->writeTo(buf);
+  // Write custom sections payload. Debug info sections are made up of one
+  // chunk per input file, which are relocated in parallel.
+  parallelForEach(inputSections,
+                  [&](const InputChunk *section) { section->writeTo(buf); });
 }
 
 uint32_t CustomSection::getNumRelocations() const {
@@ -16,6 +16,7 @@
 #include "InputElement.h"
 #include "OutputSegment.h"
 #include "SymbolTable.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include <optional>
 
@@ -803,13 +804,22 @@ void NameSection::writeBody() {
         writeStr(sub.os, toString(*s), "symbol name");
       }
     }
-    for (const InputFunction *f : out.functionSec->inputFunctions) {
+    // Demangling the names of large modules takes a while, so do it upfront
+    // in parallel.
+    ArrayRef<InputFunction *> inputFunctions = out.functionSec->inputFunctions;
+    std::vector<std::string> demangled(inputFunctions.size());
+    parallelFor(0, inputFunctions.size(), [&](size_t i) {
+      const InputFunction *f = inputFunctions[i];
+      if (!f->name.empty() && f->debugName.empty())
+        demangled[i] = maybeDemangleSymbol(f->name);
+    });
+    for (auto [f, name] : llvm::zip_equal(inputFunctions, demangled)) {
       if (!f->name.empty()) {
         writeUleb128(sub.os, f->getFunctionIndex(), "func index");
         if (!f->debugName.empty()) {
           writeStr(sub.os, f->debugName, "symbol name");
         } else {
-          writeStr(sub.os, maybeDemangleSymbol(f->name), "symbol name");
+          writeStr(sub.os, name, "symbol name");
         }
       }
     }
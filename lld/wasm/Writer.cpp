@@ -35,6 +35,7 @@
 #include "llvm/Support/Parallel.h"
 #include "llvm/Support/RandomNumberGenerator.h"
 #include "llvm/Support/SHA1.h"
+#include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/xxhash.h"
 
 #include <cstdarg>
@@ -1847,7 +1848,10 @@ void Writer::run() {
 
   createHeader();
   log("-- finalizeSections");
-  finalizeSections();
+  {
+    llvm::TimeTraceScope timeScope("Finalize sections");
+    finalizeSections();
+  }
 
   log("-- writeMapFile");
   writeMapFile(outputSections);
@@ -1860,8 +1864,11 @@ void Writer::run() {
   writeHeader();
 
   log("-- writeSections");
-  writeSections();
-  writeBuildId();
+  {
+    llvm::TimeTraceScope timeScope("Write sections");
+    writeSections();
+    writeBuildId();
+  }
   if (errorCount())
     return;
 
@@ -1892,6 +1899,9 @@ void Writer::createHeader() {
   fileSize += header.size();
 }
 
-void writeResult() { Writer().run(); }
+void writeResult() {
+  llvm::TimeTraceScope timeScope("Write output file");
+  Writer().run();
+}
 
 } // namespace wasm::lld
@@ -52,6 +52,7 @@
 #include "lldb/Utility/Listener.h"
 #include "lldb/Utility/NameMatches.h"
 #include "lldb/Utility/ProcessInfo.h"
+#include "lldb/Utility/RangeMap.h"
 #include "lldb/Utility/Status.h"
 #include "lldb/Utility/StructuredData.h"
 #include "lldb/Utility/TraceGDBRemotePackets.h"
@@ -1575,6 +1576,23 @@ public:
   size_t ReadMemoryFromInferior(lldb::addr_t vm_addr, void *buf, size_t size,
                                 Status &error);
 
+  /// Read several ranges of memory from a process, bypassing caching.
+  ///
+  /// \param[in] ranges
+  ///     The ranges to read. Their sizes must not add up to more than the
+  ///     size of \a buffer.
+  ///
+  /// \param[out] buffer
+  ///     The buffer that receives the bytes of each range in turn.
+  ///
+  /// \return
+  ///     For each range, the part of \a buffer holding the bytes read from
+  ///     it, which is shorter than the range if only a prefix of it could be
+  ///     read, and empty if none of it could.
+  llvm::SmallVector<llvm::MutableArrayRef<uint8_t>>
+  ReadMemoryRanges(llvm::ArrayRef<Range<lldb::addr_t, size_t>> ranges,
+                   llvm::MutableArrayRef<uint8_t> buffer);
+
   /// Read a NULL terminated C string from memory
   ///
   /// This function will read a cache page at a time until the NULL
@@ -2789,6 +2807,17 @@ protected:
   virtual size_t DoReadMemory(lldb::addr_t vm_addr, void *buf, size_t size,
                               Status &error) = 0;
 
+  /// Actually do the reading of several ranges of memory from a process.
+  ///
+  /// The default implementation reads each range with \a DoReadMemory.
+  /// Subclasses can override this function when they can read many ranges
+  /// at once, e.g. to avoid a round trip to a remote stub per range.
+  ///
+  /// \see ReadMemoryRanges
+  virtual llvm::SmallVector<llvm::MutableArrayRef<uint8_t>>
+  DoReadMemoryRanges(llvm::ArrayRef<Range<lldb::addr_t, size_t>> ranges,
+                     llvm::MutableArrayRef<uint8_t> buffer);
+
   virtual void DoFindInMemory(lldb::addr_t start_addr, lldb::addr_t end_addr,
                               const uint8_t *buf, size_t size,
                               AddressRanges &matches, size_t alignment,
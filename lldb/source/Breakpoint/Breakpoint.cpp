@@ -30,6 +30,8 @@
 #include "lldb/Utility/Log.h"
 #include "lldb/Utility/Stream.h"
 #include "lldb/Utility/StreamString.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallPtrSet.h"
 
 #include <memory>
 
@@ -497,58 +499,63 @@ void Breakpoint::ModulesChanged(ModuleList &module_list, bool load,
     // 3) If we don't see this module in our breakpoint location list, call
     // ResolveInModules.
 
+    // Sort the locations by module in a single pass, rather than walking all
+    // of them for each new module: a process can load thousands of modules
+    // at once, e.g. on attach.
+    BreakpointLocationCollection locations_with_no_section;
+    llvm::DenseMap<Module *, std::vector<BreakpointLocationSP>>
+        locations_by_module;
+    for (BreakpointLocationSP break_loc_sp :
+         m_locations.BreakpointLocations()) {
+      // If the section for this location was deleted, that means it's Module
+      // has gone away but somebody forgot to tell us. Let's clean it up here.
+      Address section_addr(break_loc_sp->GetAddress());
+      if (section_addr.SectionWasDeleted()) {
+        locations_with_no_section.Add(break_loc_sp);
+        continue;
+      }
+
+      if (!break_loc_sp->IsEnabled())
+        continue;
+
+      // If we don't have a Section, that means this location is a raw address
+      // that we haven't resolved to a section yet.  So we'll have to look in
+      // all the new modules to resolve this location.
+      if (SectionSP section_sp = section_addr.GetSection())
+        if (ModuleSP loc_module_sp = section_sp->GetModule())
+          locations_by_module[loc_module_sp.get()].push_back(break_loc_sp);
+    }
+
+    size_t num_to_delete = locations_with_no_section.GetSize();
+    for (size_t i = 0; i < num_to_delete; i++)
+      m_locations.RemoveLocation(locations_with_no_section.GetByIndex(i));
+
     ModuleList new_modules; // We'll stuff the "unseen" modules in this list,
                             // and then resolve
     // them after the locations pass.  Have to do it this way because resolving
     // breakpoints will add new locations potentially.
+    llvm::SmallPtrSet<Module *, 16> new_module_set;
 
     for (ModuleSP module_sp : module_list.Modules()) {
-      bool seen = false;
       if (!m_filter_sp->ModulePasses(module_sp))
         continue;
 
-      BreakpointLocationCollection locations_with_no_section;
-      for (BreakpointLocationSP break_loc_sp :
-           m_locations.BreakpointLocations()) {
-
-        // If the section for this location was deleted, that means it's Module
-        // has gone away but somebody forgot to tell us. Let's clean it up
-        // here.
-        Address section_addr(break_loc_sp->GetAddress());
-        if (section_addr.SectionWasDeleted()) {
-          locations_with_no_section.Add(break_loc_sp);
-          continue;
-        }
-
-        if (!break_loc_sp->IsEnabled())
-          continue;
-
-        SectionSP section_sp(section_addr.GetSection());
-
-        // If we don't have a Section, that means this location is a raw
-        // address that we haven't resolved to a section yet.  So we'll have to
-        // look in all the new modules to resolve this location. Otherwise, if
-        // it was set in this module, re-resolve it here.
-        if (section_sp && section_sp->GetModule() == module_sp) {
-          if (!seen)
-            seen = true;
+      // If locations were set in this module, re-resolve them here.
+      auto pos = locations_by_module.find(module_sp.get());
+      if (pos == locations_by_module.end()) {
+        if (new_module_set.insert(module_sp.get()).second)
+          new_modules.Append(module_sp);
+        continue;
+      }
 
-          if (!break_loc_sp->ResolveBreakpointSite()) {
-            LLDB_LOGF(log,
-                      "Warning: could not set breakpoint site for "
-                      "breakpoint location %d of breakpoint %d.\n",
-                      break_loc_sp->GetID(), GetID());
-          }
+      for (BreakpointLocationSP &break_loc_sp : pos->second) {
+        if (!break_loc_sp->ResolveBreakpointSite()) {
+          LLDB_LOGF(log,
+                    "Warning: could not set breakpoint site for "
+                    "breakpoint location %d of breakpoint %d.\n",
+                    break_loc_sp->GetID(), GetID());
         }
       }
-
-      size_t num_to_delete = locations_with_no_section.GetSize();
-
-      for (size_t i = 0; i < num_to_delete; i++)
-        m_locations.RemoveLocation(locations_with_no_section.GetByIndex(i));
-
-      if (!seen)
-        new_modules.AppendIfNeeded(module_sp);
     }
 
     if (new_modules.GetSize() > 0) {
@@ -18,13 +18,18 @@
 #include "lldb/Symbol/CompileUnit.h"
 #include "lldb/Symbol/Symbol.h"
 #include "lldb/Symbol/TypeSystem.h"
+#include "lldb/Target/Language.h"
 #include "lldb/Target/Process.h"
+#include "lldb/Target/StackFrame.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Target/Thread.h"
 #include "lldb/Target/ThreadSpec.h"
 #include "lldb/Utility/LLDBLog.h"
 #include "lldb/Utility/Log.h"
 #include "lldb/Utility/StreamString.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringSwitch.h"
+#include "llvm/Support/MathExtras.h"
 
 using namespace lldb;
 using namespace lldb_private;
@@ -223,6 +228,66 @@ const char *BreakpointLocation::GetConditionText(size_t *hash) const {
       .GetConditionText(hash);
 }
 
+/// Evaluate a condition of the form "<variable> <comparison> <literal>", where
+/// the variable is a local variable or parameter of integer type and the
+/// literal is a decimal, hexadecimal or octal integer that fits in an int,
+/// without the expression parser. Such a literal has type int, so the usual
+/// arithmetic conversions of the C languages never turn a negative operand
+/// into an unsigned one and comparing the values exactly gives the C result.
+/// Larger literals may be unsigned, e.g. -1 == 0xffffffff is true for an int.
+///
+/// \return
+///     The value of the condition, or std::nullopt if the condition is not of
+///     this form and needs to be evaluated as an expression.
+static std::optional<bool> EvaluateSimpleCondition(llvm::StringRef condition,
+                                                   StackFrame &frame) {
+  condition = condition.trim();
+  llvm::StringRef name = condition.take_while(
+      [](char c) { return llvm::isAlnum(c) || c == '_'; });
+  if (name.empty() || llvm::isDigit(name.front()))
+    return std::nullopt;
+
+  llvm::StringRef rest = condition.drop_front(name.size()).ltrim();
+  llvm::StringRef op;
+  for (llvm::StringRef candidate : {"==", "!=", "<=", ">=", "<", ">"}) {
+    if (rest.starts_with(candidate)) {
+      op = candidate;
+      break;
+    }
+  }
+  if (op.empty())
+    return std::nullopt;
+  uint64_t literal;
+  if (rest.drop_front(op.size()).trim().getAsInteger(0, literal))
+    return std::nullopt;
+
+  ValueObjectSP value_sp = frame.FindVariable(ConstString(name));
+  if (!value_sp)
+    return std::nullopt;
+  CompilerType type = value_sp->GetCompilerType();
+  bool is_signed;
+  if (!type.IsIntegerOrEnumerationType(is_signed))
+    return std::nullopt;
+  std::optional<uint64_t> int_bits =
+      type.GetBasicTypeFromAST(eBasicTypeInt).GetBitSize(&frame);
+  if (!int_bits || *int_bits == 0 || *int_bits > 64 ||
+      literal > uint64_t(llvm::maxIntN(*int_bits)))
+    return std::nullopt;
+  Scalar scalar;
+  if (!value_sp->ResolveValue(scalar) || scalar.GetType() != Scalar::e_int)
+    return std::nullopt;
+
+  const int cmp = llvm::APSInt::compareValues(
+      scalar.GetAPSInt(), llvm::APSInt(llvm::APInt(64, literal), true));
+  return llvm::StringSwitch<bool>(op)
+      .Case("==", cmp == 0)
+      .Case("!=", cmp != 0)
+      .Case("<=", cmp <= 0)
+      .Case(">=", cmp >= 0)
+      .Case("<", cmp < 0)
+      .Default(cmp > 0);
+}
+
 bool BreakpointLocation::ConditionSaysStop(ExecutionContext &exe_ctx,
                                            Status &error) {
   Log *log = GetLog(LLDBLog::Breakpoints);
@@ -239,18 +304,33 @@ bool BreakpointLocation::ConditionSaysStop(ExecutionContext &exe_ctx,
 
   error.Clear();
 
+  // See if we can figure out the language from the frame, otherwise use the
+  // default language:
+  LanguageType language = eLanguageTypeUnknown;
+  CompileUnit *comp_unit = m_address.CalculateSymbolContextCompileUnit();
+  if (comp_unit)
+    language = comp_unit->GetLanguage();
+
+  // Conditions that just compare a variable with a constant are common, and
+  // evaluating an expression costs much more than reading the variable.
+  if (StackFrame *frame = exe_ctx.GetFramePtr()) {
+    if (language == eLanguageTypeUnknown ||
+        Language::LanguageIsCFamily(language)) {
+      if (std::optional<bool> result =
+              EvaluateSimpleCondition(condition_text, *frame)) {
+        LLDB_LOGF(log, "Condition evaluated without the expression parser, "
+                       "result is %s.",
+                  *result ? "true" : "false");
+        return *result;
+      }
+    }
+  }
+
   DiagnosticManager diagnostics;
 
   if (condition_hash != m_condition_hash || !m_user_expression_sp ||
       !m_user_expression_sp->IsParseCacheable() ||
       !m_user_expression_sp->MatchesContext(exe_ctx)) {
-    LanguageType language = eLanguageTypeUnknown;
-    // See if we can figure out the language from the frame, otherwise use the
-    // default language:
-    CompileUnit *comp_unit = m_address.CalculateSymbolContextCompileUnit();
-    if (comp_unit)
-      language = comp_unit->GetLanguage();
-
     m_user_expression_sp.reset(GetTarget().GetUserExpressionForLanguage(
         condition_text, llvm::StringRef(), language, Expression::eResultTypeAny,
         EvaluateExpressionOptions(), nullptr, error));
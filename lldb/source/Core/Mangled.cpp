@@ -437,7 +437,12 @@ enum MangledEncoding {
   /// "NSValue". If we tried to demangled the name "OBJC_CLASS_$_NSValue" it
   /// would fail, but in these cases we want these unrelated names to be
   /// preserved.
-  MangledAndDemangled = 3u
+  MangledAndDemangled = 3u,
+  /// If the mangled name has already been demangled, we save both names so
+  /// that loading the object from a cache doesn't need to demangle it again.
+  /// The decoded names are linked as counterparts in the string pool, just
+  /// like after demangling.
+  MangledAndDemangledCounterpart = 4u
 };
 
 bool Mangled::Decode(const DataExtractor &data, lldb::offset_t *offset_ptr,
@@ -461,6 +466,12 @@ bool Mangled::Decode(const DataExtractor &data, lldb::offset_t *offset_ptr,
       m_mangled.SetString(strtab.Get(data.GetU32(offset_ptr)));
       m_demangled.SetString(strtab.Get(data.GetU32(offset_ptr)));
       return true;
+
+    case MangledAndDemangledCounterpart:
+      m_mangled.SetString(strtab.Get(data.GetU32(offset_ptr)));
+      m_demangled.SetStringWithMangledCounterpart(
+          strtab.Get(data.GetU32(offset_ptr)), m_mangled);
+      return true;
   }
   return false;
 }
@@ -468,7 +479,7 @@ bool Mangled::Decode(const DataExtractor &data, lldb::offset_t *offset_ptr,
 ///
 /// uint8_t encoding;
 /// char str1[]; (only if DemangledOnly, MangledOnly)
-/// char str2[]; (only if MangledAndDemangled)
+/// char str2[]; (only if MangledAndDemangled, MangledAndDemangledCounterpart)
 ///
 /// The strings are stored as NULL terminated UTF8 strings and str1 and str2
 /// are only saved if we need them based on the encoding.
@@ -477,8 +488,11 @@ bool Mangled::Decode(const DataExtractor &data, lldb::offset_t *offset_ptr,
 /// in demanglers. These kinds of mangled objects know when the mangled and
 /// demangled names are the counterparts for each other. This is done because
 /// demangling is very expensive and avoiding demangling the same name twice
-/// saves us a lot of compute time. For these kinds of names we only need to
-/// save the mangled name and have the encoding set to "MangledOnly".
+/// saves us a lot of compute time. For these kinds of names we save both
+/// names and have the encoding set to "MangledAndDemangledCounterpart", so
+/// that the names don't need to be demangled again when they are loaded from
+/// the cache. If the name hasn't been demangled yet, we only save the mangled
+/// name and have the encoding set to "MangledOnly".
 ///
 /// If a mangled obejct has only a demangled name, then we save only that string
 /// and have the encoding set to "DemangledOnly".
@@ -496,10 +510,11 @@ void Mangled::Encode(DataEncoder &file, ConstStringTable &strtab) const {
     encoding = MangledOnly;
     if (m_demangled) {
       // We have both mangled and demangled names. If the demangled name is the
-      // counterpart of the mangled name, then we only need to save the mangled
-      // named. If they are different, we need to save both.
+      // counterpart of the mangled name, we relink them when decoding.
       ConstString s;
-      if (!(m_mangled.GetMangledCounterpart(s) && s == m_demangled))
+      if (m_mangled.GetMangledCounterpart(s) && s == m_demangled)
+        encoding = MangledAndDemangledCounterpart;
+      else
         encoding = MangledAndDemangled;
     }
   } else if (m_demangled) {
@@ -516,6 +531,7 @@ void Mangled::Encode(DataEncoder &file, ConstStringTable &strtab) const {
       file.AppendU32(strtab.Add(m_mangled));
       break;
     case MangledAndDemangled:
+    case MangledAndDemangledCounterpart:
       file.AppendU32(strtab.Add(m_mangled));
       file.AppendU32(strtab.Add(m_demangled));
       break;
@@ -18,6 +18,7 @@
 #include "lldb/Utility/Log.h"
 #include "lldb/Utility/Status.h"
 
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/Support/Path.h"
 
 #include "DYLDRendezvous.h"
@@ -496,7 +497,6 @@ bool DYLDRendezvous::RemoveSOEntriesFromRemote(
 }
 
 bool DYLDRendezvous::AddSOEntries() {
-  SOEntry entry;
   iterator pos;
 
   assert(m_previous.state == eAdd);
@@ -504,10 +504,11 @@ bool DYLDRendezvous::AddSOEntries() {
   if (m_current.map_addr == 0)
     return false;
 
-  for (addr_t cursor = m_current.map_addr; cursor != 0; cursor = entry.next) {
-    if (!ReadSOEntryFromMemory(cursor, entry))
-      return false;
+  std::vector<SOEntry> entries;
+  if (!ReadSOEntriesFromMemory(entries))
+    return false;
 
+  for (SOEntry &entry : entries) {
     // Only add shared libraries and not the executable.
     if (SOEntryIsMainExecutable(entry))
       continue;
@@ -565,18 +566,17 @@ bool DYLDRendezvous::SOEntryIsMainExecutable(const SOEntry &entry) {
 }
 
 bool DYLDRendezvous::TakeSnapshot(SOEntryList &entry_list) {
-  SOEntry entry;
-
   if (m_current.map_addr == 0)
     return false;
 
   // Clear previous entries since we are about to obtain an up to date list.
   entry_list.clear();
 
-  for (addr_t cursor = m_current.map_addr; cursor != 0; cursor = entry.next) {
-    if (!ReadSOEntryFromMemory(cursor, entry))
-      return false;
+  std::vector<SOEntry> entries;
+  if (!ReadSOEntriesFromMemory(entries))
+    return false;
 
+  for (SOEntry &entry : entries) {
     // Only add shared libraries and not the executable.
     if (SOEntryIsMainExecutable(entry))
       continue;
@@ -695,11 +695,48 @@ bool DYLDRendezvous::ReadSOEntryFromMemory(lldb::addr_t addr, SOEntry &entry) {
   if (!(addr = ReadPointer(addr, &entry.prev)))
     return false;
 
-  std::string file_path = ReadStringFromMemory(entry.path_addr);
-  entry.file_spec.SetFile(file_path, FileSpec::Style::native);
+  return true;
+}
+
+void DYLDRendezvous::ReadSOEntryPaths(llvm::MutableArrayRef<SOEntry> entries) {
+  // Read the start of every path at once, which saves a round trip per shared
+  // object when the process is remote. Only the paths that do not fit into
+  // their chunk are read again on their own.
+  const size_t chunk_size = 256;
+  std::vector<Range<addr_t, size_t>> ranges;
+  for (const SOEntry &entry : entries) {
+    const bool has_path =
+        entry.path_addr != 0 && entry.path_addr != LLDB_INVALID_ADDRESS;
+    ranges.emplace_back(entry.path_addr, has_path ? chunk_size : 0);
+  }
+  std::vector<uint8_t> buffer(ranges.size() * chunk_size);
+  llvm::SmallVector<llvm::MutableArrayRef<uint8_t>> chunks =
+      m_process->ReadMemoryRanges(ranges, buffer);
+
+  for (auto [entry, range, chunk] : llvm::zip_equal(entries, ranges, chunks)) {
+    std::string file_path;
+    if (range.GetByteSize() != 0) {
+      auto terminator = llvm::find(chunk, '\0');
+      if (terminator != chunk.end())
+        file_path.assign(chunk.begin(), terminator);
+      else
+        file_path = ReadStringFromMemory(entry.path_addr);
+    }
+    entry.file_spec.SetFile(file_path, FileSpec::Style::native);
+
+    UpdateBaseAddrIfNecessary(entry, file_path);
+  }
+}
 
-  UpdateBaseAddrIfNecessary(entry, file_path);
+bool DYLDRendezvous::ReadSOEntriesFromMemory(std::vector<SOEntry> &entries) {
+  SOEntry entry;
+  for (addr_t cursor = m_current.map_addr; cursor != 0; cursor = entry.next) {
+    if (!ReadSOEntryFromMemory(cursor, entry))
+      return false;
+    entries.push_back(entry);
+  }
 
+  ReadSOEntryPaths(entries);
   return true;
 }
 
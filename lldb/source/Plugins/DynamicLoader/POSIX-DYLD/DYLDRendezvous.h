@@ -11,6 +11,7 @@
 
 #include <list>
 #include <string>
+#include <vector>
 
 #include "lldb/Utility/FileSpec.h"
 #include "lldb/lldb-defines.h"
@@ -18,6 +19,8 @@
 
 #include "lldb/Core/LoadedModuleInfoList.h"
 
+#include "llvm/ADT/ArrayRef.h"
+
 using lldb_private::LoadedModuleInfoList;
 
 namespace lldb_private {
@@ -311,9 +314,15 @@ protected:
   /// addr.
   std::string ReadStringFromMemory(lldb::addr_t addr);
 
-  /// Reads an SOEntry starting at \p addr.
+  /// Reads the fields of an SOEntry starting at \p addr, except for its path.
   bool ReadSOEntryFromMemory(lldb::addr_t addr, SOEntry &entry);
 
+  /// Reads the paths of \p entries, batching the reads of all of them.
+  void ReadSOEntryPaths(llvm::MutableArrayRef<SOEntry> entries);
+
+  /// Reads all SOEntries of the link map supplied by the runtime linker.
+  bool ReadSOEntriesFromMemory(std::vector<SOEntry> &entries);
+
   /// Updates the current set of SOEntries, the set of added entries, and the
   /// set of removed entries.
   bool UpdateSOEntries();
@@ -10,6 +10,7 @@
 #include "DynamicLoaderPOSIXDYLD.h"
 
 #include "lldb/Breakpoint/BreakpointLocation.h"
+#include "lldb/Core/Debugger.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/ModuleSpec.h"
 #include "lldb/Core/PluginManager.h"
@@ -24,6 +25,7 @@
 #include "lldb/Utility/LLDBLog.h"
 #include "lldb/Utility/Log.h"
 #include "lldb/Utility/ProcessInfo.h"
+#include "llvm/Support/ThreadPool.h"
 
 #include <memory>
 #include <optional>
@@ -202,12 +204,18 @@ void DynamicLoaderPOSIXDYLD::UpdateLoadedSections(ModuleSP module,
                                                   addr_t link_map_addr,
                                                   addr_t base_addr,
                                                   bool base_addr_is_offset) {
-  m_loaded_modules[module] = link_map_addr;
+  {
+    std::lock_guard<std::mutex> guard(m_loaded_modules_mutex);
+    m_loaded_modules[module] = link_map_addr;
+  }
   UpdateLoadedSectionsCommon(module, base_addr, base_addr_is_offset);
 }
 
 void DynamicLoaderPOSIXDYLD::UnloadSections(const ModuleSP module) {
-  m_loaded_modules.erase(module);
+  {
+    std::lock_guard<std::mutex> guard(m_loaded_modules_mutex);
+    m_loaded_modules.erase(module);
+  }
 
   UnloadSectionsCommon(module);
 }
@@ -415,7 +423,10 @@ void DynamicLoaderPOSIXDYLD::RefreshModules() {
   // The rendezvous class doesn't enumerate the main module, so track that
   // ourselves here.
   ModuleSP executable = GetTargetExecutable();
-  m_loaded_modules[executable] = m_rendezvous.GetLinkMapAddress();
+  {
+    std::lock_guard<std::mutex> guard(m_loaded_modules_mutex);
+    m_loaded_modules[executable] = m_rendezvous.GetLinkMapAddress();
+  }
 
   DYLDRendezvous::iterator I;
   DYLDRendezvous::iterator E;
@@ -652,7 +663,10 @@ void DynamicLoaderPOSIXDYLD::LoadAllCurrentModules() {
   // The rendezvous class doesn't enumerate the main module, so track that
   // ourselves here.
   ModuleSP executable = GetTargetExecutable();
-  m_loaded_modules[executable] = m_rendezvous.GetLinkMapAddress();
+  {
+    std::lock_guard<std::mutex> guard(m_loaded_modules_mutex);
+    m_loaded_modules[executable] = m_rendezvous.GetLinkMapAddress();
+  }
 
   std::vector<FileSpec> module_names;
   for (I = m_rendezvous.begin(), E = m_rendezvous.end(); I != E; ++I)
@@ -660,19 +674,39 @@ void DynamicLoaderPOSIXDYLD::LoadAllCurrentModules() {
   m_process->PrefetchModuleSpecs(
       module_names, m_process->GetTarget().GetArchitecture().GetTriple());
 
-  for (I = m_rendezvous.begin(), E = m_rendezvous.end(); I != E; ++I) {
-    ModuleSP module_sp =
-        LoadModuleAtAddress(I->file_spec, I->link_addr, I->base_addr, true);
-    if (module_sp.get()) {
+  // Finding, parsing and preloading the symbols of the modules is
+  // independent for each module, so do it in parallel if we may. The modules
+  // are still appended to module_list in the order of the rendezvous.
+  std::vector<const DYLDRendezvous::SOEntry *> entries;
+  for (I = m_rendezvous.begin(), E = m_rendezvous.end(); I != E; ++I)
+    entries.push_back(&*I);
+  std::vector<ModuleSP> module_sps(entries.size());
+  auto load_module = [&](size_t idx) {
+    const DYLDRendezvous::SOEntry &entry = *entries[idx];
+    module_sps[idx] = LoadModuleAtAddress(entry.file_spec, entry.link_addr,
+                                          entry.base_addr, true);
+  };
+  if (m_process->GetTarget().GetParallelModuleLoad()) {
+    llvm::ThreadPoolTaskGroup task_group(Debugger::GetThreadPool());
+    for (size_t idx = 0; idx < entries.size(); ++idx)
+      task_group.async(load_module, idx);
+    task_group.wait();
+  } else {
+    for (size_t idx = 0; idx < entries.size(); ++idx)
+      load_module(idx);
+  }
+
+  for (size_t idx = 0; idx < entries.size(); ++idx) {
+    const DYLDRendezvous::SOEntry &entry = *entries[idx];
+    if (ModuleSP module_sp = module_sps[idx]) {
       LLDB_LOG(log, "LoadAllCurrentModules loading module: {0}",
-               I->file_spec.GetFilename());
+               entry.file_spec.GetFilename());
       module_list.Append(module_sp);
     } else {
-      Log *log = GetLog(LLDBLog::DynamicLoader);
       LLDB_LOGF(
           log,
           "DynamicLoaderPOSIXDYLD::%s failed loading module %s at 0x%" PRIx64,
-          __FUNCTION__, I->file_spec.GetPath().c_str(), I->base_addr);
+          __FUNCTION__, entry.file_spec.GetPath().c_str(), entry.base_addr);
     }
   }
 
@@ -744,15 +778,19 @@ DynamicLoaderPOSIXDYLD::GetThreadLocalData(const lldb::ModuleSP module_sp,
                                            const lldb::ThreadSP thread,
                                            lldb::addr_t tls_file_addr) {
   Log *log = GetLog(LLDBLog::DynamicLoader);
-  auto it = m_loaded_modules.find(module_sp);
-  if (it == m_loaded_modules.end()) {
-    LLDB_LOGF(
-        log, "GetThreadLocalData error: module(%s) not found in loaded modules",
-        module_sp->GetObjectName().AsCString());
-    return LLDB_INVALID_ADDRESS;
+  addr_t link_map;
+  {
+    std::lock_guard<std::mutex> guard(m_loaded_modules_mutex);
+    auto it = m_loaded_modules.find(module_sp);
+    if (it == m_loaded_modules.end()) {
+      LLDB_LOGF(
+          log,
+          "GetThreadLocalData error: module(%s) not found in loaded modules",
+          module_sp->GetObjectName().AsCString());
+      return LLDB_INVALID_ADDRESS;
+    }
+    link_map = it->second;
   }
-
-  addr_t link_map = it->second;
   if (link_map == LLDB_INVALID_ADDRESS || link_map == 0) {
     LLDB_LOGF(log,
               "GetThreadLocalData error: invalid link map address=0x%" PRIx64,
@@ -27,6 +27,7 @@
 #include "lldb/Target/Platform.h"
 #include "lldb/Utility/Event.h"
 #include "lldb/Utility/FileSpec.h"
+#include "lldb/Utility/GDBRemote.h"
 #include "lldb/Utility/Log.h"
 #include "lldb/Utility/RegularExpression.h"
 #include "lldb/Utility/StreamString.h"
@@ -112,6 +113,12 @@ size_t GDBRemoteCommunication::SendNack() {
 
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunication::SendPacketNoLock(llvm::StringRef payload) {
+  std::string compressed_payload;
+  if (m_send_compression_type != CompressionType::None) {
+    compressed_payload = CompressPayload(payload);
+    payload = compressed_payload;
+  }
+
   StreamString packet(0, 4, eByteOrderBig);
   packet.PutChar('$');
   packet.Write(payload.data(), payload.size());
@@ -613,6 +620,39 @@ bool GDBRemoteCommunication::DecompressPacket() {
   return true;
 }
 
+std::string GDBRemoteCommunication::CompressPayload(llvm::StringRef payload) {
+  // Short packets, like most replies, are not worth the time to compress.
+  constexpr size_t min_compressed_size = 384;
+
+#if LLVM_ENABLE_ZLIB
+  if (m_send_compression_type == CompressionType::ZlibDeflate &&
+      payload.size() >= min_compressed_size) {
+    z_stream stream;
+    memset(&stream, 0, sizeof(z_stream));
+    // A window size of -15 produces the raw deflate stream DecompressPacket
+    // inflates.
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8,
+                     Z_DEFAULT_STRATEGY) == Z_OK) {
+      std::vector<uint8_t> compressed(deflateBound(&stream, payload.size()));
+      stream.next_in = (Bytef *)payload.data();
+      stream.avail_in = (uInt)payload.size();
+      stream.next_out = (Bytef *)compressed.data();
+      stream.avail_out = (uInt)compressed.size();
+      int status = deflate(&stream, Z_FINISH);
+      deflateEnd(&stream);
+      if (status == Z_STREAM_END && stream.total_out < payload.size()) {
+        StreamGDBRemote packet;
+        packet.Printf("C%" PRIu64 ":", (uint64_t)payload.size());
+        packet.PutEscapedBytes(compressed.data(), stream.total_out);
+        return std::string(packet.GetString());
+      }
+    }
+  }
+#endif
+
+  return "N" + payload.str();
+}
+
 GDBRemoteCommunication::PacketType
 GDBRemoteCommunication::CheckForPacket(const uint8_t *src, size_t src_len,
                                        StringExtractorGDBRemote &packet) {
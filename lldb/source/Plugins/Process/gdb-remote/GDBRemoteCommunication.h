@@ -183,6 +183,10 @@ protected:
   std::string m_bytes;
   std::recursive_mutex m_bytes_mutex;
   CompressionType m_compression_type;
+  // The compression of the packets this side sends, which a server enables
+  // when the client asks for it with QEnableCompression. m_compression_type
+  // is the compression of the packets this side receives.
+  CompressionType m_send_compression_type = CompressionType::None;
 
   PacketResult SendPacketNoLock(llvm::StringRef payload);
   PacketResult SendNotificationPacketNoLock(llvm::StringRef notify_type,
@@ -213,6 +217,10 @@ protected:
   // on m_bytes.  The checksum was for the compressed packet.
   bool DecompressPacket();
 
+  // Frame \p payload for m_send_compression_type: prefix it with 'C', the
+  // uncompressed size and ':' if it is worth compressing, or with 'N' if not.
+  std::string CompressPayload(llvm::StringRef payload);
+
   Status StartListenThread(const char *hostname = "127.0.0.1",
                            uint16_t port = 0);
 
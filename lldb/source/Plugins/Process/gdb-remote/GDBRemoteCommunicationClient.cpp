@@ -287,6 +287,7 @@ void GDBRemoteCommunicationClient::ResetDiscoverableSettings(bool did_exec) {
     m_avoid_g_packets = eLazyBoolCalculate;
     m_supports_multiprocess = eLazyBoolCalculate;
     m_supports_qSaveCore = eLazyBoolCalculate;
+    m_supports_multi_mem_read = eLazyBoolCalculate;
     m_supports_qXfer_auxv_read = eLazyBoolCalculate;
     m_supports_qXfer_libraries_read = eLazyBoolCalculate;
     m_supports_qXfer_libraries_svr4_read = eLazyBoolCalculate;
@@ -347,6 +348,7 @@ void GDBRemoteCommunicationClient::GetRemoteQSupported() {
   m_supports_QPassSignals = eLazyBoolNo;
   m_supports_memory_tagging = eLazyBoolNo;
   m_supports_qSaveCore = eLazyBoolNo;
+  m_supports_multi_mem_read = eLazyBoolNo;
   m_uses_native_signals = eLazyBoolNo;
 
   m_max_packet_size = UINT64_MAX; // It's supposed to always be there, but if
@@ -399,6 +401,8 @@ void GDBRemoteCommunicationClient::GetRemoteQSupported() {
         m_supports_memory_tagging = eLazyBoolYes;
       else if (x == "qSaveCore+")
         m_supports_qSaveCore = eLazyBoolYes;
+      else if (x == "MultiMemRead+")
+        m_supports_multi_mem_read = eLazyBoolYes;
       else if (x == "native-signals+")
         m_uses_native_signals = eLazyBoolYes;
       // Look for a list of compressions in the features list e.g.
@@ -715,6 +719,61 @@ Status GDBRemoteCommunicationClient::WriteMemoryTags(
   return status;
 }
 
+bool GDBRemoteCommunicationClient::GetMultiMemReadSupported() {
+  if (m_supports_multi_mem_read == eLazyBoolCalculate)
+    GetRemoteQSupported();
+  return m_supports_multi_mem_read == eLazyBoolYes;
+}
+
+llvm::Expected<llvm::SmallVector<llvm::MutableArrayRef<uint8_t>>>
+GDBRemoteCommunicationClient::MultiMemRead(
+    llvm::ArrayRef<Range<lldb::addr_t, size_t>> ranges,
+    llvm::MutableArrayRef<uint8_t> buffer,
+    std::chrono::seconds interrupt_timeout) {
+  // Format MultiMemRead:ranges:<addr>,<len>;<addr>,<len>;...;
+  StreamString packet;
+  packet.PutCString("MultiMemRead:ranges:");
+  for (const Range<lldb::addr_t, size_t> &range : ranges)
+    packet.Printf("%" PRIx64 ",%" PRIx64 ";", range.GetRangeBase(),
+                  (uint64_t)range.GetByteSize());
+
+  StringExtractorGDBRemote response;
+  if (SendPacketAndWaitForResponse(packet.GetString(), response,
+                                   interrupt_timeout) !=
+          PacketResult::Success ||
+      !response.IsNormalResponse())
+    return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                   "MultiMemRead packet failed");
+
+  // We are expecting <len>,<len>,...;<data><data>... The lower level packet
+  // receive layer has already de-quoted any escaping in the data.
+  llvm::StringRef lengths, data;
+  std::tie(lengths, data) = response.GetStringRef().split(';');
+  llvm::SmallVector<llvm::StringRef, 16> length_strs;
+  lengths.split(length_strs, ',');
+  if (length_strs.size() != ranges.size())
+    return llvm::createStringError(
+        llvm::inconvertibleErrorCode(),
+        "MultiMemRead response has %zu lengths for %zu ranges",
+        length_strs.size(), ranges.size());
+
+  llvm::SmallVector<llvm::MutableArrayRef<uint8_t>> results;
+  for (auto [range, length_str] : llvm::zip_equal(ranges, length_strs)) {
+    size_t length;
+    if (length_str.getAsInteger(16, length) || length > range.GetByteSize() ||
+        length > data.size())
+      return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                     "Invalid length in MultiMemRead response");
+    assert(range.GetByteSize() <= buffer.size() &&
+           "buffer too small for the ranges");
+    llvm::copy(data.take_front(length), buffer.begin());
+    results.push_back(buffer.take_front(length));
+    buffer = buffer.drop_front(range.GetByteSize());
+    data = data.drop_front(length);
+  }
+  return results;
+}
+
 bool GDBRemoteCommunicationClient::GetxPacketSupported() {
   if (m_supports_x == eLazyBoolCalculate) {
     StringExtractorGDBRemote response;
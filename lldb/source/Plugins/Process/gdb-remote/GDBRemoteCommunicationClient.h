@@ -23,6 +23,7 @@
 #include "lldb/Utility/ArchSpec.h"
 #include "lldb/Utility/GDBRemote.h"
 #include "lldb/Utility/ProcessInfo.h"
+#include "lldb/Utility/RangeMap.h"
 #include "lldb/Utility/StructuredData.h"
 #include "lldb/Utility/TraceGDBRemotePackets.h"
 #include "lldb/Utility/UUID.h"
@@ -440,6 +441,26 @@ public:
   Status WriteMemoryTags(lldb::addr_t addr, size_t len, int32_t type,
                          const std::vector<uint8_t> &tags);
 
+  bool GetMultiMemReadSupported();
+
+  /// Read several ranges of memory with a single MultiMemRead packet.
+  ///
+  /// \param[in] ranges
+  ///     The ranges to read. Their sizes must not add up to more than the
+  ///     size of \a buffer.
+  ///
+  /// \param[out] buffer
+  ///     The buffer that receives the bytes of each range in turn.
+  ///
+  /// \return
+  ///     For each range, the part of \a buffer holding the bytes read from
+  ///     it, which is shorter than the range if the server could only read a
+  ///     prefix of it.
+  llvm::Expected<llvm::SmallVector<llvm::MutableArrayRef<uint8_t>>>
+  MultiMemRead(llvm::ArrayRef<Range<lldb::addr_t, size_t>> ranges,
+               llvm::MutableArrayRef<uint8_t> buffer,
+               std::chrono::seconds interrupt_timeout);
+
   /// Use qOffsets to query the offset used when relocating the target
   /// executable. If successful, the returned structure will contain at least
   /// one value in the offsets field.
@@ -560,6 +581,7 @@ protected:
   LazyBool m_supports_multiprocess = eLazyBoolCalculate;
   LazyBool m_supports_memory_tagging = eLazyBoolCalculate;
   LazyBool m_supports_qSaveCore = eLazyBoolCalculate;
+  LazyBool m_supports_multi_mem_read = eLazyBoolCalculate;
   LazyBool m_uses_native_signals = eLazyBoolCalculate;
 
   bool m_supports_qProcessInfoPID : 1, m_supports_qfProcessInfo : 1,
@@ -41,6 +41,7 @@
 #include "lldb/Utility/StreamString.h"
 #include "lldb/Utility/UnimplementedError.h"
 #include "lldb/Utility/UriParser.h"
+#include "llvm/Config/llvm-config.h" // for LLVM_ENABLE_ZLIB
 #include "llvm/Support/JSON.h"
 #include "llvm/Support/ScopedPrinter.h"
 #include "llvm/TargetParser/Triple.h"
@@ -94,6 +95,9 @@ void GDBRemoteCommunicationServerLLGS::RegisterPacketHandlers() {
       &GDBRemoteCommunicationServerLLGS::Handle_memory_read);
   RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_M,
                                 &GDBRemoteCommunicationServerLLGS::Handle_M);
+  RegisterMemberFunctionHandler(
+      StringExtractorGDBRemote::eServerPacketType_MultiMemRead,
+      &GDBRemoteCommunicationServerLLGS::Handle_MultiMemRead);
   RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType__M,
                                 &GDBRemoteCommunicationServerLLGS::Handle__M);
   RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType__m,
@@ -242,6 +246,9 @@ void GDBRemoteCommunicationServerLLGS::RegisterPacketHandlers() {
   RegisterMemberFunctionHandler(
       StringExtractorGDBRemote::eServerPacketType_QNonStop,
       &GDBRemoteCommunicationServerLLGS::Handle_QNonStop);
+  RegisterMemberFunctionHandler(
+      StringExtractorGDBRemote::eServerPacketType_QEnableCompression,
+      &GDBRemoteCommunicationServerLLGS::Handle_QEnableCompression);
   RegisterMemberFunctionHandler(
       StringExtractorGDBRemote::eServerPacketType_vStdio,
       &GDBRemoteCommunicationServerLLGS::Handle_vStdio);
@@ -2547,6 +2554,64 @@ GDBRemoteCommunicationServerLLGS::Handle_memory_read(
   return SendPacketNoLock(response.GetString());
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_MultiMemRead(
+    StringExtractorGDBRemote &packet) {
+  Log *log = GetLog(LLDBLog::Process);
+
+  if (!m_current_process ||
+      (m_current_process->GetID() == LLDB_INVALID_PROCESS_ID)) {
+    LLDB_LOGF(
+        log,
+        "GDBRemoteCommunicationServerLLGS::%s failed, no process available",
+        __FUNCTION__);
+    return SendErrorResponse(0x15);
+  }
+
+  // The packet format is "MultiMemRead:ranges:<addr>,<len>;<addr>,<len>;...;"
+  llvm::StringRef ranges = packet.GetStringRef();
+  if (!ranges.consume_front("MultiMemRead:ranges:"))
+    return SendIllFormedResponse(packet, "Missing ranges in MultiMemRead");
+  if (!ranges.consume_back(";"))
+    return SendIllFormedResponse(packet,
+                                 "Missing terminator in MultiMemRead");
+
+  // The response is "<len>,<len>,...;<data><data>...", where each length is
+  // the number of bytes read from the corresponding range.
+  StreamGDBRemote lengths;
+  std::string data;
+  std::string buf;
+  for (llvm::StringRef range : llvm::split(ranges, ';')) {
+    auto [addr_str, len_str] = range.split(',');
+    lldb::addr_t read_addr;
+    uint64_t byte_count;
+    if (addr_str.getAsInteger(16, read_addr) ||
+        len_str.getAsInteger(16, byte_count))
+      return SendIllFormedResponse(packet, "Invalid range in MultiMemRead");
+
+    size_t bytes_read = 0;
+    if (byte_count > 0) {
+      buf.resize(byte_count);
+      Status error = m_current_process->ReadMemoryWithoutTrap(
+          read_addr, buf.data(), byte_count, bytes_read);
+      LLDB_LOG(log,
+               "ReadMemoryWithoutTrap({0}) read {1} of {2} requested bytes "
+               "(error: {3})",
+               read_addr, bytes_read, byte_count, error);
+      data.append(buf.data(), bytes_read);
+    }
+    if (lengths.GetSize())
+      lengths.PutChar(',');
+    lengths.Printf("%" PRIx64, (uint64_t)bytes_read);
+  }
+
+  StreamGDBRemote response;
+  response.PutCString(lengths.GetString());
+  response.PutChar(';');
+  response.PutEscapedBytes(data.data(), data.size());
+  return SendPacketNoLock(response.GetString());
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::Handle__M(StringExtractorGDBRemote &packet) {
   Log *log = GetLog(LLDBLog::Process);
@@ -3980,6 +4045,33 @@ GDBRemoteCommunicationServerLLGS::Handle_QNonStop(
   return SendOKResponse();
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_QEnableCompression(
+    StringExtractorGDBRemote &packet) {
+  StringRef packet_str{packet.GetStringRef()};
+  assert(packet_str.starts_with("QEnableCompression:"));
+  packet_str.consume_front("QEnableCompression:");
+
+  CompressionType type = CompressionType::None;
+  for (StringRef field : llvm::split(packet_str, ';')) {
+    if (field.consume_front("type:")) {
+#if LLVM_ENABLE_ZLIB
+      if (field == "zlib-deflate")
+        type = CompressionType::ZlibDeflate;
+#endif
+    }
+  }
+  if (!m_compression_supported || type == CompressionType::None)
+    return SendErrorResponse(
+        Status::FromErrorString("Unsupported compression type"));
+
+  // Send the response uncompressed, the client only starts decompressing once
+  // it has seen it.
+  PacketResult packet_result = SendOKResponse();
+  m_send_compression_type = type;
+  return packet_result;
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::HandleNotificationAck(
     std::deque<std::string> &queue) {
@@ -4213,7 +4305,12 @@ std::vector<std::string> GDBRemoteCommunicationServerLLGS::HandleFeatures(
                             "QListThreadsInStopReply+",
                             "qXfer:features:read+",
                             "QNonStop+",
+                            "MultiMemRead+",
                         });
+#if LLVM_ENABLE_ZLIB
+  if (m_compression_supported)
+    ret.push_back("SupportedCompressions=zlib-deflate");
+#endif
 
   // report server-only features
   using Extension = NativeProcessProtocol::Extension;
@@ -40,6 +40,12 @@ public:
 
   void SetLaunchInfo(const ProcessLaunchInfo &info);
 
+  /// Offer the client to compress the packets lldb-server sends, which pays
+  /// off for large replies, like trace data, over slow connections.
+  void SetCompressionSupported(bool supported) {
+    m_compression_supported = supported;
+  }
+
   /// Launch a process with the current launch settings.
   ///
   /// This method supports running an lldb-gdbserver or similar
@@ -119,6 +125,7 @@ protected:
   bool m_list_threads_in_stop_reply = false;
   bool m_non_stop = false;
   bool m_disabling_non_stop = false;
+  bool m_compression_supported = false;
   std::deque<std::string> m_stdio_notification_queue;
   std::deque<std::string> m_stop_notification_queue;
 
@@ -199,6 +206,7 @@ protected:
   PacketResult Handle_memory_read(StringExtractorGDBRemote &packet);
 
   PacketResult Handle_M(StringExtractorGDBRemote &packet);
+  PacketResult Handle_MultiMemRead(StringExtractorGDBRemote &packet);
   PacketResult Handle__M(StringExtractorGDBRemote &packet);
   PacketResult Handle__m(StringExtractorGDBRemote &packet);
 
@@ -255,6 +263,8 @@ protected:
 
   PacketResult Handle_QNonStop(StringExtractorGDBRemote &packet);
 
+  PacketResult Handle_QEnableCompression(StringExtractorGDBRemote &packet);
+
   PacketResult HandleNotificationAck(std::deque<std::string> &queue);
 
   PacketResult Handle_vStdio(StringExtractorGDBRemote &packet);
@@ -2668,6 +2668,61 @@ size_t ProcessGDBRemote::DoReadMemory(addr_t addr, void *buf, size_t size,
   return 0;
 }
 
+llvm::SmallVector<llvm::MutableArrayRef<uint8_t>>
+ProcessGDBRemote::DoReadMemoryRanges(
+    llvm::ArrayRef<Range<lldb::addr_t, size_t>> ranges,
+    llvm::MutableArrayRef<uint8_t> buffer) {
+  if (!m_gdb_comm.GetMultiMemReadSupported())
+    return Process::DoReadMemoryRanges(ranges, buffer);
+
+  // Send as many ranges per MultiMemRead packet as fit into a response, each
+  // range taking at most its size and the size of its length. Ranges that
+  // would not fit into a response on their own are read separately.
+  GetMaxMemorySize();
+  Log *log = GetLog(GDBRLog::Memory);
+  llvm::SmallVector<llvm::MutableArrayRef<uint8_t>> results;
+  while (!ranges.empty()) {
+    size_t batch_size = 0;
+    size_t batch_bytes = 0;
+    size_t response_size = 0;
+    for (const Range<lldb::addr_t, size_t> &range : ranges) {
+      // A length takes at most 16 hex digits and a separator.
+      const size_t range_response_size = range.GetByteSize() + 17;
+      if (response_size + range_response_size > m_max_memory_size)
+        break;
+      response_size += range_response_size;
+      batch_bytes += range.GetByteSize();
+      ++batch_size;
+    }
+
+    if (batch_size == 0) {
+      batch_size = 1;
+      batch_bytes = ranges.front().GetByteSize();
+    }
+    llvm::ArrayRef<Range<lldb::addr_t, size_t>> batch =
+        ranges.take_front(batch_size);
+    llvm::MutableArrayRef<uint8_t> batch_buffer =
+        buffer.take_front(batch_bytes);
+
+    llvm::SmallVector<llvm::MutableArrayRef<uint8_t>> batch_results;
+    if (response_size == 0) {
+      batch_results = Process::DoReadMemoryRanges(batch, batch_buffer);
+    } else if (auto batch_results_or_err = m_gdb_comm.MultiMemRead(
+                   batch, batch_buffer, GetInterruptTimeout())) {
+      batch_results = std::move(*batch_results_or_err);
+    } else {
+      LLDB_LOG_ERROR(log, batch_results_or_err.takeError(),
+                     "MultiMemRead failed, reading ranges separately: {0}");
+      batch_results = Process::DoReadMemoryRanges(batch, batch_buffer);
+    }
+    llvm::append_range(results, batch_results);
+
+    ranges = ranges.drop_front(batch_size);
+    buffer = buffer.drop_front(batch_bytes);
+  }
+  return results;
+}
+
 bool ProcessGDBRemote::SupportsMemoryTagging() {
   return m_gdb_comm.GetMemoryTaggingSupported();
 }
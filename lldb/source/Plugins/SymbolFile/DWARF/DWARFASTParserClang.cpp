@@ -520,6 +520,8 @@ TypeSP DWARFASTParserClang::ParseTypeFromDWARF(const SymbolContext &sc,
       break;
     }
     UpdateSymbolContextScopeForType(sc, die, type_sp);
+    if (type_sp)
+      ++m_num_types_parsed;
   }
   if (type_sp) {
     dwarf->GetDIEToType()[die.GetDIE()] = type_sp.get();
@@ -2180,6 +2182,7 @@ bool DWARFASTParserClang::CompleteTypeFromDWARF(
 
   const dw_tag_t tag = die.Tag();
 
+  ++m_num_types_completed;
   assert(clang_type);
   switch (tag) {
   case DW_TAG_structure_type:
@@ -112,6 +112,13 @@ public:
   void MapDeclDIEToDefDIE(const lldb_private::plugin::dwarf::DWARFDIE &decl_die,
                           const lldb_private::plugin::dwarf::DWARFDIE &def_die);
 
+  /// The number of types this parser created from a DIE, which may only be
+  /// forward declarations.
+  uint64_t GetNumTypesParsed() const { return m_num_types_parsed; }
+
+  /// The number of forward declared types this parser completed on demand.
+  uint64_t GetNumTypesCompleted() const { return m_num_types_completed; }
+
 protected:
   /// Protected typedefs and members.
   /// @{
@@ -139,6 +146,9 @@ protected:
   DeclContextToDIEMap m_decl_ctx_to_die;
   DIEToModuleMap m_die_to_module;
   std::unique_ptr<lldb_private::ClangASTImporter> m_clang_ast_importer_up;
+  /// Used for reporting statistics.
+  uint64_t m_num_types_parsed = 0;
+  uint64_t m_num_types_completed = 0;
   /// @}
 
   clang::DeclContext *
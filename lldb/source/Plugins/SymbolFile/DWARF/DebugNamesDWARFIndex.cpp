@@ -165,6 +165,23 @@ bool DebugNamesDWARFIndex::ProcessEntry(
   return callback(die);
 }
 
+bool DebugNamesDWARFIndex::ProcessTypeEntry(
+    const DebugNames::Entry &entry, llvm::DenseSet<uint64_t> &seen_type_units,
+    llvm::function_ref<bool(DWARFDIE die)> callback) {
+  std::optional<uint64_t> type_sig = entry.getForeignTUTypeSignature();
+  if (!type_sig)
+    return ProcessEntry(entry, callback);
+  if (seen_type_units.contains(*type_sig))
+    return true;
+  // Only count type units we could find, so that a missing .dwo file, or an
+  // entry that doesn't match the type unit in the .dwp file, doesn't hide the
+  // other entries.
+  if (!GetForeignTypeUnit(entry).value_or(nullptr))
+    return true;
+  seen_type_units.insert(*type_sig);
+  return ProcessEntry(entry, callback);
+}
+
 void DebugNamesDWARFIndex::MaybeLogLookupError(llvm::Error error,
                                                const DebugNames::NameIndex &ni,
                                                llvm::StringRef name) {
@@ -341,17 +358,26 @@ void DebugNamesDWARFIndex::GetFullyQualifiedType(
     parent_names.emplace_back(context[idx].name);
 
   // For each entry, grab its parent chain and check if we have a match.
+  llvm::DenseSet<uint64_t> seen_type_units;
   for (const DebugNames::Entry &entry :
        m_debug_names_up->equal_range(leaf_name)) {
     if (!isType(entry.tag()))
       continue;
 
+    // All type units with the same signature describe the same type, so we
+    // only need to load one of them (see ProcessTypeEntry).
+    std::optional<uint64_t> type_sig = entry.getForeignTUTypeSignature();
+    if (type_sig && seen_type_units.contains(*type_sig))
+      continue;
+
     // If we get a NULL foreign_tu back, the entry doesn't match the type unit
     // in the .dwp file, or we were not able to load the .dwo file or the DWO ID
     // didn't match.
     std::optional<DWARFTypeUnit *> foreign_tu = GetForeignTypeUnit(entry);
     if (foreign_tu && foreign_tu.value() == nullptr)
       continue;
+    if (type_sig)
+      seen_type_units.insert(*type_sig);
 
     // Grab at most one extra parent, subsequent parents are not necessary to
     // test equality.
@@ -404,10 +430,11 @@ bool DebugNamesDWARFIndex::SameParentChain(
 
 void DebugNamesDWARFIndex::GetTypes(
     ConstString name, llvm::function_ref<bool(DWARFDIE die)> callback) {
+  llvm::DenseSet<uint64_t> seen_type_units;
   for (const DebugNames::Entry &entry :
        m_debug_names_up->equal_range(name.GetStringRef())) {
     if (isType(entry.tag())) {
-      if (!ProcessEntry(entry, callback))
+      if (!ProcessTypeEntry(entry, seen_type_units, callback))
         return;
     }
   }
@@ -419,9 +446,10 @@ void DebugNamesDWARFIndex::GetTypes(
     const DWARFDeclContext &context,
     llvm::function_ref<bool(DWARFDIE die)> callback) {
   auto name = context[0].name;
+  llvm::DenseSet<uint64_t> seen_type_units;
   for (const DebugNames::Entry &entry : m_debug_names_up->equal_range(name)) {
     if (entry.tag() == context[0].tag) {
-      if (!ProcessEntry(entry, callback))
+      if (!ProcessTypeEntry(entry, seen_type_units, callback))
         return;
     }
   }
@@ -114,6 +114,17 @@ private:
   bool ProcessEntry(const DebugNames::Entry &entry,
                     llvm::function_ref<bool(DWARFDIE die)> callback);
 
+  /// Like ProcessEntry, but skips entries for foreign type units that have the
+  /// signature of a type unit in \a seen_type_units, and adds the signature
+  /// of the type unit of \a entry to it once that has been found.
+  ///
+  /// Without a .dwp file, every .dwo file that uses a type has its own copy
+  /// of its type unit, and each of them has an entry. Processing one of them
+  /// avoids loading all of these .dwo files for a single type lookup.
+  bool ProcessTypeEntry(const DebugNames::Entry &entry,
+                        llvm::DenseSet<uint64_t> &seen_type_units,
+                        llvm::function_ref<bool(DWARFDIE die)> callback);
+
   /// Returns true if `parent_entries` have identical names to `parent_names`.
   bool SameParentChain(llvm::ArrayRef<llvm::StringRef> parent_names,
                        llvm::ArrayRef<DebugNames::Entry> parent_entries) const;
@@ -82,13 +82,28 @@ void ManualDWARFIndex::Index() {
                     total_progress);
 
   std::vector<IndexSet> sets(units_to_index.size());
+  NameToDIE IndexSet::*const indices[] = {
+      &IndexSet::function_basenames,
+      &IndexSet::function_fullnames,
+      &IndexSet::function_methods,
+      &IndexSet::function_selectors,
+      &IndexSet::objc_class_selectors,
+      &IndexSet::globals,
+      &IndexSet::types,
+      &IndexSet::namespaces,
+  };
 
   // Keep memory down by clearing DIEs for any units if indexing
   // caused us to load the unit's DIEs.
   std::vector<std::optional<DWARFUnit::ScopedExtractDIEs>> clear_cu_dies(
       units_to_index.size());
   auto parser_fn = [&](size_t cu_idx) {
-    IndexUnit(*units_to_index[cu_idx], dwp_dwarf, sets[cu_idx]);
+    IndexSet &set = sets[cu_idx];
+    IndexUnit(*units_to_index[cu_idx], dwp_dwarf, set);
+    // Sort the names of each unit while the units are indexed in parallel,
+    // so that finalizing each index only has to merge them.
+    for (auto index : indices)
+      (set.*index).Finalize();
     progress.Increment();
   };
 
@@ -120,21 +135,16 @@ void ManualDWARFIndex::Index() {
   task_group.wait();
 
   auto finalize_fn = [this, &sets, &progress](NameToDIE(IndexSet::*index)) {
-    NameToDIE &result = m_set.*index;
-    for (auto &set : sets)
-      result.Append(set.*index);
-    result.Finalize();
+    std::vector<const NameToDIE *> unit_indices;
+    unit_indices.reserve(sets.size());
+    for (const auto &set : sets)
+      unit_indices.push_back(&(set.*index));
+    (m_set.*index).MergeFinalized(unit_indices);
     progress.Increment();
   };
 
-  task_group.async(finalize_fn, &IndexSet::function_basenames);
-  task_group.async(finalize_fn, &IndexSet::function_fullnames);
-  task_group.async(finalize_fn, &IndexSet::function_methods);
-  task_group.async(finalize_fn, &IndexSet::function_selectors);
-  task_group.async(finalize_fn, &IndexSet::objc_class_selectors);
-  task_group.async(finalize_fn, &IndexSet::globals);
-  task_group.async(finalize_fn, &IndexSet::types);
-  task_group.async(finalize_fn, &IndexSet::namespaces);
+  for (auto index : indices)
+    task_group.async(finalize_fn, index);
   task_group.wait();
 
   SaveToCache();
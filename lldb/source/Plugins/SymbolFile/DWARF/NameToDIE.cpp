@@ -27,6 +27,14 @@ void NameToDIE::Finalize() {
   m_map.SizeToFit();
 }
 
+void NameToDIE::MergeFinalized(llvm::ArrayRef<const NameToDIE *> others) {
+  std::vector<const UniqueCStringMap<DIERef> *> maps;
+  maps.reserve(others.size());
+  for (const NameToDIE *other : others)
+    maps.push_back(&other->m_map);
+  m_map.MergeSorted(maps, std::less<DIERef>());
+}
+
 void NameToDIE::Insert(ConstString name, const DIERef &die_ref) {
   m_map.Append(name, die_ref);
 }
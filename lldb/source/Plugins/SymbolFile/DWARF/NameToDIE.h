@@ -34,6 +34,11 @@ public:
 
   void Finalize();
 
+  /// Replace the contents of this map with the entries of \a others, which
+  /// must all be finalized. The result is finalized as well. This is faster
+  /// than appending the maps and finalizing the result.
+  void MergeFinalized(llvm::ArrayRef<const NameToDIE *> others);
+
   bool Find(ConstString name,
             llvm::function_ref<bool(DIERef ref)> callback) const;
 
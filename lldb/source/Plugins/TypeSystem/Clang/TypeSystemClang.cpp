@@ -9134,6 +9134,18 @@ npdb::PdbAstBuilder *TypeSystemClang::GetNativePDBParser() {
   return m_native_pdb_ast_parser_up.get();
 }
 
+std::optional<llvm::json::Value> TypeSystemClang::ReportStatistics() {
+  if (!m_dwarf_ast_parser_up)
+    return std::nullopt;
+  // Types are parsed from DWARF as forward declarations where possible and
+  // only completed when their definition is needed, so the ratio of the two
+  // shows how much of the debug info a session actually imported.
+  return llvm::json::Object{
+      {"dwarfTypesParsed", m_dwarf_ast_parser_up->GetNumTypesParsed()},
+      {"dwarfTypesCompleted", m_dwarf_ast_parser_up->GetNumTypesCompleted()},
+  };
+}
+
 bool TypeSystemClang::LayoutRecordType(
     const clang::RecordDecl *record_decl, uint64_t &bit_size,
     uint64_t &alignment,
@@ -524,6 +524,8 @@ public:
   PDBASTParser *GetPDBParser() override;
   npdb::PdbAstBuilder *GetNativePDBParser() override;
 
+  std::optional<llvm::json::Value> ReportStatistics() override;
+
   // TypeSystemClang callbacks for external source lookups.
   void CompleteTagDecl(clang::TagDecl *);
 
@@ -2214,6 +2214,52 @@ size_t Process::ReadMemoryFromInferior(addr_t addr, void *buf, size_t size,
   return bytes_read;
 }
 
+llvm::SmallVector<llvm::MutableArrayRef<uint8_t>>
+Process::ReadMemoryRanges(llvm::ArrayRef<Range<lldb::addr_t, size_t>> ranges,
+                          llvm::MutableArrayRef<uint8_t> buffer) {
+  LLDB_SCOPED_TIMER();
+
+  llvm::SmallVector<Range<lldb::addr_t, size_t>> fixed_ranges(ranges);
+  if (ABISP abi_sp = GetABI())
+    for (Range<lldb::addr_t, size_t> &range : fixed_ranges)
+      range.SetRangeBase(abi_sp->FixAnyAddress(range.GetRangeBase()));
+
+  llvm::SmallVector<llvm::MutableArrayRef<uint8_t>> results =
+      DoReadMemoryRanges(fixed_ranges, buffer);
+  assert(results.size() == fixed_ranges.size());
+
+  // Replace any software breakpoint opcodes that fall into these ranges.
+  for (auto [range, result] : llvm::zip_equal(fixed_ranges, results))
+    if (!result.empty())
+      RemoveBreakpointOpcodesFromBuffer(range.GetRangeBase(), result.size(),
+                                        result.data());
+  return results;
+}
+
+llvm::SmallVector<llvm::MutableArrayRef<uint8_t>>
+Process::DoReadMemoryRanges(llvm::ArrayRef<Range<lldb::addr_t, size_t>> ranges,
+                            llvm::MutableArrayRef<uint8_t> buffer) {
+  llvm::SmallVector<llvm::MutableArrayRef<uint8_t>> results;
+  for (const Range<lldb::addr_t, size_t> &range : ranges) {
+    const size_t size = range.GetByteSize();
+    assert(size <= buffer.size() && "buffer too small for the ranges");
+    size_t bytes_read = 0;
+    while (bytes_read < size) {
+      Status error;
+      const size_t curr_size = size - bytes_read;
+      const size_t curr_bytes_read =
+          DoReadMemory(range.GetRangeBase() + bytes_read,
+                       buffer.data() + bytes_read, curr_size, error);
+      bytes_read += curr_bytes_read;
+      if (curr_bytes_read == curr_size || curr_bytes_read == 0)
+        break;
+    }
+    results.push_back(buffer.take_front(bytes_read));
+    buffer = buffer.drop_front(size);
+  }
+  return results;
+}
+
 uint64_t Process::ReadUnsignedIntegerFromMemory(lldb::addr_t vm_addr,
                                                 size_t integer_byte_size,
                                                 uint64_t fail_value,
@@ -0,0 +1,52 @@
+"""
+Test that simple breakpoint conditions comparing a variable with an integer
+literal follow the C conversion rules, whether or not they go through the
+expression parser.
+"""
+
+import lldb
+import lldbsuite.test.lldbutil as lldbutil
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test.decorators import *
+
+
+class BreakpointConditionLiteralsTestCase(TestBase):
+    def check_condition(self, condition, expected_x):
+        """Run to the breakpoint with the given condition and check the values
+        of x it stops for."""
+        self.build()
+        exe = self.getBuildArtifact("a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        bkpt = target.BreakpointCreateBySourceRegex(
+            "// break here", lldb.SBFileSpec("main.c")
+        )
+        self.assertTrue(bkpt.IsValid(), VALID_BREAKPOINT)
+        bkpt.SetCondition(condition)
+
+        process = target.LaunchSimple(None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+
+        stopped_x = []
+        while process.GetState() == lldb.eStateStopped:
+            thread = lldbutil.get_stopped_thread(process, lldb.eStopReasonBreakpoint)
+            self.assertTrue(thread.IsValid())
+            stopped_x.append(
+                thread.GetFrameAtIndex(0).FindVariable("x").GetValueAsSigned()
+            )
+            process.Continue()
+        self.assertEqual(process.GetState(), lldb.eStateExited)
+        self.assertEqual(stopped_x, expected_x)
+
+    def test_small_literal(self):
+        self.check_condition("x == 2", [2])
+        self.check_condition("x < 0x2", [1, -1])
+        self.check_condition("u == 5", [1, -1, 2])
+
+    def test_signed_variable_hex_literal(self):
+        """In C, 0xffffffff is an unsigned int, so x is converted to unsigned
+        and -1 compares equal to it."""
+        self.check_condition("x == 0xffffffff", [-1])
+        self.check_condition("x > 0xfffffffe", [-1])
+        self.check_condition("x != 0xffffffff", [1, 2])
@@ -0,0 +1,12 @@
+int g_count = 0;
+
+void func(int x, unsigned u) {
+  g_count += x + u; // break here
+}
+
+int main(int argc, char const *argv[]) {
+  func(1, 5);
+  func(-1, 5);
+  func(2, 5);
+  return 0;
+}
@@ -0,0 +1,110 @@
+import gdbremote_testcase
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class TestGdbRemoteMultiMemRead(gdbremote_testcase.GdbRemoteTestCaseBase):
+    MEMORY_CONTENTS = "Test contents 0123456789 ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+
+    def launch_and_get_message_address(self):
+        self.build()
+        self.set_inferior_startup_launch()
+        procs = self.prep_debug_monitor_and_inferior(
+            inferior_args=[
+                "set-message:%s" % self.MEMORY_CONTENTS,
+                "get-data-address-hex:g_message",
+                "sleep:5",
+            ]
+        )
+
+        self.add_qSupported_packets()
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        features = self.parse_qSupported_response(context)
+        if features.get("MultiMemRead") != "+":
+            self.skipTest("MultiMemRead not supported by lldb-server")
+
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            [
+                "read packet: $c#63",
+                {
+                    "type": "output_match",
+                    "regex": self.maybe_strict_output_regex(
+                        r"data address: 0x([0-9a-fA-F]+)\r\n"
+                    ),
+                    "capture": {1: "message_address"},
+                },
+                "read packet: {}".format(chr(3)),
+                {
+                    "direction": "send",
+                    "regex": r"^\$T([0-9a-fA-F]{2})thread:([0-9a-fA-F]+);",
+                    "capture": {1: "stop_signo", 2: "stop_thread_id"},
+                },
+            ],
+            True,
+        )
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.assertIsNotNone(context.get("message_address"))
+        return int(context.get("message_address"), 16)
+
+    def multi_mem_read(self, ranges):
+        """Send a MultiMemRead packet for the given string of ranges and return
+        the lengths and the decoded data of the response."""
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            [
+                "read packet: $MultiMemRead:ranges:{}#00".format(ranges),
+                {
+                    "direction": "send",
+                    "regex": re.compile(
+                        r"^\$([^;#]*);(.*)#[0-9a-fA-F]{2}$", re.MULTILINE | re.DOTALL
+                    ),
+                    "capture": {1: "lengths", 2: "data"},
+                },
+            ],
+            True,
+        )
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        lengths = [int(length, 16) for length in context.get("lengths").split(",")]
+        return (lengths, self.decode_gdbremote_binary(context.get("data")))
+
+    def expect_error_reply(self, packet):
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            [
+                "read packet: ${}#00".format(packet),
+                {"direction": "send", "regex": r"^\$E([0-9a-fA-F]{2})#"},
+            ],
+            True,
+        )
+        self.assertIsNotNone(self.expect_gdbremote_sequence())
+
+    @skipIfWindows  # No pty support to test any inferior output
+    def test_reads_all_ranges(self):
+        address = self.launch_and_get_message_address()
+        lengths, data = self.multi_mem_read(
+            "{:x},4;{:x},6;".format(address, address + 14)
+        )
+        self.assertEqual(lengths, [4, 6])
+        self.assertEqual(data, self.MEMORY_CONTENTS[0:4] + self.MEMORY_CONTENTS[14:20])
+
+    @skipIfWindows  # No pty support to test any inferior output
+    def test_reports_unreadable_ranges(self):
+        address = self.launch_and_get_message_address()
+        # Nothing can be read at address 0, but the other ranges are still read.
+        lengths, data = self.multi_mem_read(
+            "{:x},4;0,8;{:x},2;".format(address, address + 5)
+        )
+        self.assertEqual(lengths, [4, 0, 2])
+        self.assertEqual(data, self.MEMORY_CONTENTS[0:4] + self.MEMORY_CONTENTS[5:7])
+
+    @skipIfWindows  # No pty support to test any inferior output
+    def test_rejects_malformed_packets(self):
+        address = self.launch_and_get_message_address()
+        self.expect_error_reply("MultiMemRead:{:x},4;".format(address))
+        self.expect_error_reply("MultiMemRead:ranges:{:x},4".format(address))
+        self.expect_error_reply("MultiMemRead:ranges:{:x},zz;".format(address))
@@ -66,3 +66,39 @@ TEST(UniqueCStringMap, ValueCompare) {
   EXPECT_THAT(Map.GetValues(Foo, Values), 3);
   EXPECT_THAT(Values, testing::ElementsAre(-5, 0, 5));
 }
+
+TEST(UniqueCStringMap, MergeSorted) {
+  ConstString Foo("foo"), Bar("bar"), Baz("baz");
+  UniqueCStringMap<int> A, B, C, Empty;
+  A.Append(Foo, 3);
+  A.Append(Bar, 1);
+  B.Append(Foo, 1);
+  B.Append(Baz, 2);
+  C.Append(Foo, 2);
+  C.Append(Bar, 0);
+  C.Append(Bar, 2);
+
+  UniqueCStringMap<int> Expected;
+  for (const UniqueCStringMap<int> *Map : {&A, &B, &C}) {
+    for (const auto &Entry : *Map)
+      Expected.Append(Entry);
+  }
+  Expected.Sort(std::less<int>());
+
+  A.Sort(std::less<int>());
+  B.Sort(std::less<int>());
+  C.Sort(std::less<int>());
+  UniqueCStringMap<int> Merged;
+  Merged.Append(Baz, 42);
+  Merged.MergeSorted({&A, &Empty, &B, &C}, std::less<int>());
+
+  ASSERT_EQ(Merged.GetSize(), Expected.GetSize());
+  for (size_t I = 0; I < Expected.GetSize(); ++I) {
+    EXPECT_EQ(Merged.GetCStringAtIndex(I), Expected.GetCStringAtIndex(I));
+    EXPECT_EQ(Merged.GetValueAtIndexUnchecked(I),
+              Expected.GetValueAtIndexUnchecked(I));
+  }
+  std::vector<int> Values;
+  EXPECT_THAT(Merged.GetValues(Foo, Values), 3);
+  EXPECT_THAT(Values, testing::ElementsAre(1, 2, 3));
+}
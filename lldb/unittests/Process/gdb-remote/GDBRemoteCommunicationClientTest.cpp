@@ -605,6 +605,45 @@ TEST_F(GDBRemoteCommunicationClientTest, WriteMemoryTags) {
                  "E03", false);
 }
 
+TEST_F(GDBRemoteCommunicationClientTest, MultiMemRead) {
+  std::vector<Range<addr_t, size_t>> ranges = {
+      {0x1000, 4}, {0x2000, 0}, {0x3000, 3}, {0x4000, 2}};
+  uint8_t buffer[9];
+  const auto &MultiMemRead = [&](llvm::StringRef response) {
+    std::future<std::optional<std::vector<std::string>>> result =
+        std::async(std::launch::async, [&] {
+          auto results_or_err =
+              client.MultiMemRead(ranges, buffer, std::chrono::seconds(0));
+          if (!results_or_err) {
+            llvm::consumeError(results_or_err.takeError());
+            return std::optional<std::vector<std::string>>();
+          }
+          std::vector<std::string> results;
+          for (llvm::MutableArrayRef<uint8_t> result : *results_or_err)
+            results.emplace_back(result.begin(), result.end());
+          return std::optional(results);
+        });
+
+    HandlePacket(server, "MultiMemRead:ranges:1000,4;2000,0;3000,3;4000,2;",
+                 response);
+    return result.get();
+  };
+
+  // The data may contain separators, and ranges may be read partially.
+  EXPECT_THAT(MultiMemRead("4,0,1,2;ab;d;e,"),
+              testing::Optional(testing::ElementsAre("ab;d", "", ";", "e,")));
+  EXPECT_THAT(MultiMemRead("2,0,0,1;xyz"),
+              testing::Optional(testing::ElementsAre("xy", "", "", "z")));
+
+  EXPECT_EQ(MultiMemRead("E01"), std::nullopt);
+  // Each range needs a length.
+  EXPECT_EQ(MultiMemRead("4,0,3;abcdefg"), std::nullopt);
+  // A range can't return more than was asked for.
+  EXPECT_EQ(MultiMemRead("4,0,3,3;abcdefghij"), std::nullopt);
+  // Lengths can't extend past the data.
+  EXPECT_EQ(MultiMemRead("4,0,3,2;abc"), std::nullopt);
+}
+
 // Prior to this verison, constructing a std::future for a type without a
 // default constructor is not possible.
 // https://developercommunity.visualstudio.com/t/c-shared-state-futuresstate-default-constructs-the/60897
@@ -6,6 +6,8 @@
 //
 //===----------------------------------------------------------------------===//
 #include "GDBRemoteTestUtils.h"
+#include "llvm/Config/llvm-config.h" // for LLVM_ENABLE_ZLIB
+#include "llvm/Support/FormatVariadic.h"
 #include "llvm/Testing/Support/Error.h"
 
 using namespace lldb_private::process_gdb_remote;
@@ -23,6 +25,8 @@ public:
     return GDBRemoteCommunication::ReadPacket(response, std::chrono::seconds(1),
                                               /*sync_on_timeout*/ false);
   }
+
+  void SetCompressionType(CompressionType type) { m_compression_type = type; }
 };
 
 class GDBRemoteCommunicationTest : public GDBRemoteTest {
@@ -68,3 +72,23 @@ TEST_F(GDBRemoteCommunicationTest, ReadPacket) {
     ASSERT_EQ(PacketResult::Success, server.GetAck());
   }
 }
+
+#if LLVM_ENABLE_ZLIB
+TEST_F(GDBRemoteCommunicationTest, ReadCompressedPacket) {
+  client.SetCompressionType(CompressionType::ZlibDeflate);
+  server.SetSendCompressionType(CompressionType::ZlibDeflate);
+
+  // Short packets are sent uncompressed, long ones compressed.
+  std::string long_payload;
+  for (unsigned i = 0; i < 256; ++i)
+    long_payload += llvm::formatv("{0:x-4}", i);
+  for (llvm::StringRef payload :
+       {llvm::StringRef("OK"), llvm::StringRef(long_payload)}) {
+    SCOPED_TRACE(payload);
+    StringExtractorGDBRemote response;
+    ASSERT_EQ(PacketResult::Success, server.SendPacket(payload));
+    ASSERT_EQ(PacketResult::Success, client.ReadPacket(response));
+    ASSERT_EQ(payload, response.GetStringRef());
+  }
+}
+#endif
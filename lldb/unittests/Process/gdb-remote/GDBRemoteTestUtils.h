@@ -62,6 +62,10 @@ public:
     return GDBRemoteCommunicationServer::SendPacketNoLock(payload);
   }
 
+  void SetSendCompressionType(CompressionType type) {
+    m_send_compression_type = type;
+  }
+
   PacketResult GetPacket(StringExtractorGDBRemote &response) {
     const bool sync_on_timeout = false;
     return ReadPacket(response, std::chrono::seconds(1), sync_on_timeout);
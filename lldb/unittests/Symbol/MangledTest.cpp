@@ -57,7 +57,7 @@ TEST(MangledTest, EncodeDecodeMangled) {
 
   // Test encoding a mangled object that has demangled its name by computing it.
   mangled.GetDemangledName();
-  // EncodeDecode(mangled);
+  EncodeDecode(mangled);
 
   // Test encoding a mangled object that has just a demangled name
   mangled.SetMangledName(ConstString());
@@ -0,0 +1,116 @@
+//===- FlatHashMapBM.cpp - FlatHashMap vs. DenseMap benchmarks ------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/FlatHashMap.h"
+#include <vector>
+
+using namespace llvm;
+
+// Pointer keys, like the ones of ValueMaps and SelectionDAG CSE maps.
+static std::vector<int *> getKeys(size_t N, std::vector<int> &Storage) {
+  Storage.resize(2 * N);
+  std::vector<int *> Keys;
+  for (size_t I = 0; I < N; ++I)
+    Keys.push_back(&Storage[2 * I]);
+  // Shuffle deterministically so that insertion order is not address order.
+  uint64_t State = 0x9E3779B97F4A7C15;
+  for (size_t I = N; I > 1; --I) {
+    State = State * 6364136223846793005 + 1442695040888963407;
+    std::swap(Keys[I - 1], Keys[(State >> 33) % I]);
+  }
+  return Keys;
+}
+
+template <typename MapT> static void BM_Insert(benchmark::State &State) {
+  std::vector<int> Storage;
+  std::vector<int *> Keys = getKeys(State.range(0), Storage);
+  for (auto _ : State) {
+    MapT M;
+    for (int *K : Keys)
+      M[K] = 1;
+    benchmark::DoNotOptimize(M);
+  }
+  State.SetItemsProcessed(State.iterations() * Keys.size());
+}
+
+template <typename MapT> static void BM_FindHit(benchmark::State &State) {
+  std::vector<int> Storage;
+  std::vector<int *> Keys = getKeys(State.range(0), Storage);
+  MapT M;
+  for (int *K : Keys)
+    M[K] = 1;
+  for (auto _ : State)
+    for (int *K : Keys)
+      benchmark::DoNotOptimize(M.find(K));
+  State.SetItemsProcessed(State.iterations() * Keys.size());
+  State.counters["bytes"] = M.getMemorySize();
+}
+
+template <typename MapT> static void BM_FindMiss(benchmark::State &State) {
+  std::vector<int> Storage;
+  std::vector<int *> Keys = getKeys(State.range(0), Storage);
+  MapT M;
+  for (int *K : Keys)
+    M[K] = 1;
+  for (auto _ : State)
+    for (int *K : Keys)
+      benchmark::DoNotOptimize(M.find(K + 1));
+  State.SetItemsProcessed(State.iterations() * Keys.size());
+}
+
+// Erase the oldest key and insert a new one, keeping the size stable. This is
+// where DenseMap accumulates tombstones.
+template <typename MapT> static void BM_Churn(benchmark::State &State) {
+  std::vector<int> Storage;
+  size_t N = State.range(0);
+  std::vector<int *> Keys = getKeys(4 * N, Storage);
+  for (auto _ : State) {
+    MapT M;
+    for (size_t I = 0; I < N; ++I)
+      M[Keys[I]] = 1;
+    for (size_t I = N; I < Keys.size(); ++I) {
+      M.erase(Keys[I - N]);
+      M[Keys[I]] = 1;
+      benchmark::DoNotOptimize(M.find(Keys[I - N / 2]));
+    }
+    benchmark::DoNotOptimize(M);
+  }
+  State.SetItemsProcessed(State.iterations() * 3 * N);
+}
+
+template <typename MapT> static void BM_Iterate(benchmark::State &State) {
+  std::vector<int> Storage;
+  std::vector<int *> Keys = getKeys(State.range(0), Storage);
+  MapT M;
+  for (int *K : Keys)
+    M[K] = 1;
+  for (auto _ : State) {
+    int Sum = 0;
+    for (auto &KV : M)
+      Sum += KV.second;
+    benchmark::DoNotOptimize(Sum);
+  }
+  State.SetItemsProcessed(State.iterations() * Keys.size());
+}
+
+using DenseMapT = DenseMap<int *, int>;
+using FlatHashMapT = FlatHashMap<int *, int>;
+
+#define MAP_BENCHMARK(NAME)                                                    \
+  BENCHMARK_TEMPLATE(NAME, DenseMapT)->Range(16, 1 << 20);                     \
+  BENCHMARK_TEMPLATE(NAME, FlatHashMapT)->Range(16, 1 << 20)
+
+MAP_BENCHMARK(BM_Insert);
+MAP_BENCHMARK(BM_FindHit);
+MAP_BENCHMARK(BM_FindMiss);
+MAP_BENCHMARK(BM_Churn);
+MAP_BENCHMARK(BM_Iterate);
+
+BENCHMARK_MAIN();
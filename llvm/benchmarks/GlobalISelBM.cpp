@@ -0,0 +1,234 @@
+//===- GlobalISelBM.cpp - GlobalISel compile-time benchmarks --------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// These benchmarks measure the compile time of GlobalISel on AArch64, in MIR
+// instructions per second.
+//
+// BM_GISelPipeline runs the core GlobalISel passes up to and including the
+// given one, without the combiners, so the time spent in a pass is the
+// difference to the previous one. BM_CodeGen runs the whole code generator,
+// to compare GlobalISel against FastISel (at -O0) and SelectionDAG. LLVM
+// options, e.g. -aarch64-gisel-fast-combine, can be passed after the
+// benchmark options.
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/CodeGen/GlobalISel/IRTranslator.h"
+#include "llvm/CodeGen/GlobalISel/InstructionSelect.h"
+#include "llvm/CodeGen/GlobalISel/Legalizer.h"
+#include "llvm/CodeGen/GlobalISel/RegBankSelect.h"
+#include "llvm/CodeGen/MachineFunctionPass.h"
+#include "llvm/CodeGen/MachineModuleInfo.h"
+#include "llvm/CodeGen/TargetPassConfig.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Module.h"
+#include "llvm/InitializePasses.h"
+#include "llvm/MC/TargetRegistry.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Target/TargetMachine.h"
+#include "llvm/TargetParser/Triple.h"
+#include <memory>
+
+using namespace llvm;
+
+/// The last GlobalISel pass BM_GISelPipeline runs.
+enum class Stage { IRTranslator, Legalizer, RegBankSelect, InstructionSelect };
+
+static std::unique_ptr<LLVMTargetMachine> createTargetMachine(unsigned OptLevel,
+                                                              bool GlobalISel) {
+  Triple TargetTriple("aarch64-unknown-linux-gnu");
+  std::string Error;
+  const Target *T = TargetRegistry::lookupTarget("", TargetTriple, Error);
+  if (!T)
+    return nullptr;
+
+  TargetOptions Options;
+  Options.EnableGlobalISel = GlobalISel;
+  Options.GlobalISelAbort = GlobalISelAbortMode::Enable;
+  auto *TM = static_cast<LLVMTargetMachine *>(T->createTargetMachine(
+      TargetTriple.str(), "", "", Options, std::nullopt, std::nullopt,
+      *CodeGenOpt::getLevel(OptLevel)));
+  return std::unique_ptr<LLVMTargetMachine>(TM);
+}
+
+/// A straight-line function with \p NumInstrs instructions that mixes
+/// arithmetic, memory accesses and selects.
+static std::unique_ptr<Module> genIR(LLVMContext &Ctx, unsigned NumInstrs,
+                                     const TargetMachine &TM) {
+  std::string IR = "define i64 @foo(ptr %p, i64 %a, i64 %b) {\n"
+                   "  %v0 = add i64 %a, %b\n";
+  unsigned I = 1;
+  for (unsigned N = 1; N < NumInstrs; ++I) {
+    std::string V = "%v" + std::to_string(I);
+    std::string Prev = "%v" + std::to_string(I - 1);
+    switch (I % 4) {
+    case 0:
+      IR += "  " + V + " = add i64 " + Prev + ", %a\n";
+      N += 1;
+      break;
+    case 1:
+      IR += "  %g" + std::to_string(I) + " = getelementptr i64, ptr %p, i64 " +
+            Prev + "\n";
+      IR += "  " + V + " = load i64, ptr %g" + std::to_string(I) + "\n";
+      N += 2;
+      break;
+    case 2:
+      IR += "  " + V + " = shl i64 " + Prev + ", 3\n";
+      N += 1;
+      break;
+    case 3:
+      IR += "  %c" + std::to_string(I) + " = icmp ult i64 " + Prev + ", %b\n";
+      IR += "  " + V + " = select i1 %c" + std::to_string(I) + ", i64 " +
+            Prev + ", i64 %a\n";
+      N += 2;
+      break;
+    }
+  }
+  IR += "  ret i64 %v" + std::to_string(I - 1) + "\n}\n";
+
+  SMDiagnostic Err;
+  std::unique_ptr<Module> M = parseAssemblyString(IR, Err, Ctx);
+  if (!M) {
+    Err.print("GlobalISelBM", errs());
+    return nullptr;
+  }
+  M->setTargetTriple(TM.getTargetTriple().str());
+  M->setDataLayout(TM.createDataLayout());
+  return M;
+}
+
+namespace {
+/// Counts the instructions of the machine functions it runs on.
+struct MIRCounter : public MachineFunctionPass {
+  static char ID;
+  unsigned &NumInstrs;
+
+  MIRCounter(unsigned &NumInstrs)
+      : MachineFunctionPass(ID), NumInstrs(NumInstrs) {}
+
+  bool runOnMachineFunction(MachineFunction &MF) override {
+    for (const MachineBasicBlock &MBB : MF)
+      NumInstrs += MBB.size();
+    return false;
+  }
+
+  void getAnalysisUsage(AnalysisUsage &AU) const override {
+    AU.setPreservesAll();
+    MachineFunctionPass::getAnalysisUsage(AU);
+  }
+};
+} // end anonymous namespace
+
+char MIRCounter::ID = 0;
+
+/// Run the GlobalISel passes up to \p Last on \p M and return the number of
+/// MIR instructions \p M has afterwards.
+static unsigned runGISelPipeline(Module &M, LLVMTargetMachine &TM,
+                                 Stage Last) {
+  legacy::PassManager PM;
+  TargetPassConfig *TPC = TM.createPassConfig(PM);
+  TPC->setDisableVerify(true);
+  PM.add(TPC);
+  PM.add(new MachineModuleInfoWrapperPass(&TM));
+  PM.add(new IRTranslator(TM.getOptLevel()));
+  if (Last >= Stage::Legalizer)
+    PM.add(new Legalizer());
+  if (Last >= Stage::RegBankSelect)
+    PM.add(new RegBankSelect());
+  if (Last >= Stage::InstructionSelect)
+    PM.add(new InstructionSelect(TM.getOptLevel()));
+  TPC->setInitialized();
+  unsigned NumInstrs = 0;
+  PM.add(new MIRCounter(NumInstrs));
+  PM.run(M);
+  return NumInstrs;
+}
+
+/// Arguments: the number of IR instructions and the optimization level.
+template <Stage Last> static void BM_GISelPipeline(benchmark::State &State) {
+  std::unique_ptr<LLVMTargetMachine> TM =
+      createTargetMachine(State.range(1), /*GlobalISel=*/true);
+  LLVMContext Ctx;
+  std::unique_ptr<Module> M = TM ? genIR(Ctx, State.range(0), *TM) : nullptr;
+  if (!M) {
+    State.SkipWithError("cannot create the AArch64 target or the module");
+    return;
+  }
+  // Measure throughput in terms of the generic MIR the passes start from.
+  unsigned NumMIRInstrs = runGISelPipeline(*M, *TM, Stage::IRTranslator);
+  for (auto _ : State)
+    benchmark::DoNotOptimize(runGISelPipeline(*M, *TM, Last));
+  State.SetItemsProcessed(State.iterations() * NumMIRInstrs);
+}
+
+/// Arguments: the number of IR instructions, the optimization level, and
+/// whether to use GlobalISel rather than FastISel or SelectionDAG.
+static void BM_CodeGen(benchmark::State &State) {
+  std::unique_ptr<LLVMTargetMachine> TM =
+      createTargetMachine(State.range(1), State.range(2));
+  LLVMContext Ctx;
+  std::unique_ptr<Module> M = TM ? genIR(Ctx, State.range(0), *TM) : nullptr;
+  if (!M) {
+    State.SkipWithError("cannot create the AArch64 target or the module");
+    return;
+  }
+  unsigned NumMIRInstrs = 0;
+  {
+    std::unique_ptr<LLVMTargetMachine> GISelTM =
+        createTargetMachine(State.range(1), /*GlobalISel=*/true);
+    NumMIRInstrs = runGISelPipeline(*M, *GISelTM, Stage::IRTranslator);
+  }
+  SmallString<0> Buffer;
+  for (auto _ : State) {
+    Buffer.clear();
+    raw_svector_ostream OS(Buffer);
+    legacy::PassManager PM;
+    if (TM->addPassesToEmitFile(PM, OS, nullptr, CodeGenFileType::ObjectFile,
+                                /*DisableVerify=*/true)) {
+      State.SkipWithError("the target cannot emit object files");
+      break;
+    }
+    PM.run(*M);
+    benchmark::DoNotOptimize(Buffer.data());
+  }
+  State.SetItemsProcessed(State.iterations() * NumMIRInstrs);
+}
+
+BENCHMARK(BM_GISelPipeline<Stage::IRTranslator>)
+    ->ArgsProduct({{256, 4096}, {0, 1}});
+BENCHMARK(BM_GISelPipeline<Stage::Legalizer>)
+    ->ArgsProduct({{256, 4096}, {0, 1}});
+BENCHMARK(BM_GISelPipeline<Stage::RegBankSelect>)
+    ->ArgsProduct({{256, 4096}, {0, 1}});
+BENCHMARK(BM_GISelPipeline<Stage::InstructionSelect>)
+    ->ArgsProduct({{256, 4096}, {0, 1}});
+BENCHMARK(BM_CodeGen)->ArgsProduct({{256, 4096}, {0, 1}, {0, 1}});
+
+int main(int argc, char **argv) {
+  LLVMInitializeAArch64TargetInfo();
+  LLVMInitializeAArch64Target();
+  LLVMInitializeAArch64TargetMC();
+  LLVMInitializeAArch64AsmPrinter();
+  PassRegistry &Registry = *PassRegistry::getPassRegistry();
+  initializeCore(Registry);
+  initializeCodeGen(Registry);
+  initializeGlobalISel(Registry);
+  initializeTarget(Registry);
+  initializeAnalysis(Registry);
+
+  benchmark::Initialize(&argc, argv);
+  cl::ParseCommandLineOptions(argc, argv, "GlobalISel benchmarks\n");
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
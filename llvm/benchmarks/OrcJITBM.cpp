@@ -0,0 +1,239 @@
+//===- OrcJITBM.cpp - ORC and JITLink end-to-end benchmarks ---------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Benchmarks for JIT startup, symbol lookup, materialization throughput,
+// executor round trips and memory management. Run with
+// --benchmark_format=json for machine readable results.
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/ExecutionEngine/JITLink/JITLinkMemoryManager.h"
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/ExecutionEngine/Orc/MapperJITLinkMemoryManager.h"
+#include "llvm/ExecutionEngine/Orc/MemoryMapper.h"
+#include "llvm/ExecutionEngine/Orc/Shared/SimpleRemoteEPCUtils.h"
+#include "llvm/ExecutionEngine/Orc/SimpleRemoteEPC.h"
+#include "llvm/ExecutionEngine/Orc/TargetProcess/SimpleExecutorMemoryManager.h"
+#include "llvm/ExecutionEngine/Orc/TargetProcess/SimpleRemoteEPCServer.h"
+#include "llvm/IRReader/IRReader.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+
+#if LLVM_ON_UNIX
+#include <unistd.h>
+#endif
+
+using namespace llvm;
+using namespace llvm::orc;
+
+namespace {
+
+/// Returns a module defining NumFunctions functions named "<Prefix><N>", each
+/// returning N.
+ThreadSafeModule makeModule(StringRef Prefix, unsigned NumFunctions) {
+  std::string IR;
+  raw_string_ostream OS(IR);
+  for (unsigned I = 0; I != NumFunctions; ++I)
+    OS << "define i32 @" << Prefix << I << "() {\n"
+       << "entry:\n"
+       << "  ret i32 " << I << "\n"
+       << "}\n";
+
+  auto Ctx = std::make_unique<LLVMContext>();
+  SMDiagnostic Diag;
+  auto M = parseIR(MemoryBufferRef(IR, Prefix), Diag, *Ctx);
+  if (!M)
+    report_fatal_error(Twine("Invalid benchmark module: ") + Diag.getMessage());
+  return ThreadSafeModule(std::move(M), std::move(Ctx));
+}
+
+template <typename T> T exitOnErr(Expected<T> ValOrErr) {
+  if (!ValOrErr)
+    report_fatal_error(ValOrErr.takeError());
+  return std::move(*ValOrErr);
+}
+
+void exitOnErr(Error Err) {
+  if (Err)
+    report_fatal_error(std::move(Err));
+}
+
+void initializeTargets() {
+  static bool Initialized = [] {
+    InitializeNativeTarget();
+    InitializeNativeTargetAsmPrinter();
+    return true;
+  }();
+  (void)Initialized;
+}
+
+/// Create an LLJIT, add a module and call one of its functions.
+void BM_LLJITColdStart(benchmark::State &State) {
+  initializeTargets();
+  for (auto _ : State) {
+    auto J = exitOnErr(LLJITBuilder().create());
+    exitOnErr(J->addIRModule(makeModule("f", 1)));
+    auto F = exitOnErr(J->lookup("f0"));
+    benchmark::DoNotOptimize(F.toPtr<int (*)()>()());
+  }
+}
+BENCHMARK(BM_LLJITColdStart)->Unit(benchmark::kMillisecond);
+
+/// Look up an already materialized symbol in a JITDylib defining
+/// State.range(0) symbols.
+void BM_LLJITLookupReady(benchmark::State &State) {
+  initializeTargets();
+  auto J = exitOnErr(LLJITBuilder().create());
+  unsigned NumFunctions = State.range(0);
+  exitOnErr(J->addIRModule(makeModule("f", NumFunctions)));
+  std::string Name = ("f" + Twine(NumFunctions / 2)).str();
+  exitOnErr(J->lookup(Name).takeError());
+
+  for (auto _ : State)
+    benchmark::DoNotOptimize(exitOnErr(J->lookup(Name)));
+}
+BENCHMARK(BM_LLJITLookupReady)->Arg(1)->Arg(1024)->Unit(
+    benchmark::kMicrosecond);
+
+/// Call a lazily compiled function for the first time: the lookup of its
+/// lazy reexport, and the compile of its body on the first call.
+void BM_LLLazyJITFirstCall(benchmark::State &State) {
+  initializeTargets();
+  auto J = exitOnErr(LLLazyJITBuilder().create());
+  unsigned Iteration = 0;
+
+  for (auto _ : State) {
+    State.PauseTiming();
+    std::string Prefix = ("f" + Twine(Iteration++) + "_").str();
+    exitOnErr(J->addLazyIRModule(makeModule(Prefix, 1)));
+    State.ResumeTiming();
+
+    auto F = exitOnErr(J->lookup(Prefix + "0"));
+    benchmark::DoNotOptimize(F.toPtr<int (*)()>()());
+  }
+}
+BENCHMARK(BM_LLLazyJITFirstCall)->Unit(benchmark::kMicrosecond);
+
+/// Materialize 64 modules with one lookup, on State.range(0) compile threads.
+void BM_ConcurrentMaterialization(benchmark::State &State) {
+  initializeTargets();
+  constexpr unsigned NumModules = 64;
+
+  for (auto _ : State) {
+    State.PauseTiming();
+    auto J = exitOnErr(
+        LLJITBuilder().setNumCompileThreads(State.range(0)).create());
+    SymbolLookupSet Names;
+    for (unsigned I = 0; I != NumModules; ++I) {
+      std::string Prefix = ("m" + Twine(I) + "_").str();
+      exitOnErr(J->addIRModule(makeModule(Prefix, 16)));
+      Names.add(J->mangleAndIntern(Prefix + "0"));
+    }
+    State.ResumeTiming();
+
+    auto &ES = J->getExecutionSession();
+    benchmark::DoNotOptimize(exitOnErr(ES.lookup(
+        makeJITDylibSearchOrder(&J->getMainJITDylib()), std::move(Names))));
+
+    State.PauseTiming();
+    J.reset();
+    State.ResumeTiming();
+  }
+  State.SetItemsProcessed(State.iterations() * NumModules);
+}
+BENCHMARK(BM_ConcurrentMaterialization)
+    ->Arg(0)
+    ->Arg(2)
+    ->Arg(4)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+void noop() {}
+
+/// Run a function in an executor connected through a pair of pipes, so each
+/// call makes one round trip through the SimpleRemoteEPC protocol.
+void BM_EPCRoundTrip(benchmark::State &State) {
+#if LLVM_ON_UNIX && LLVM_ENABLE_THREADS
+  int ToExecutor[2], FromExecutor[2];
+  if (pipe(ToExecutor) != 0 || pipe(FromExecutor) != 0) {
+    State.SkipWithError("Cannot create pipes");
+    return;
+  }
+
+  auto Server =
+      exitOnErr(SimpleRemoteEPCServer::Create<FDSimpleRemoteEPCTransport>(
+          [](SimpleRemoteEPCServer::Setup &S) -> Error {
+            S.setDispatcher(
+                std::make_unique<SimpleRemoteEPCServer::ThreadDispatcher>());
+            S.bootstrapSymbols() =
+                SimpleRemoteEPCServer::defaultBootstrapSymbols();
+            S.services().push_back(
+                std::make_unique<rt_bootstrap::SimpleExecutorMemoryManager>());
+            return Error::success();
+          },
+          ToExecutor[0], FromExecutor[1]));
+
+  auto EPC = exitOnErr(SimpleRemoteEPC::Create<FDSimpleRemoteEPCTransport>(
+      std::make_unique<DynamicThreadPoolTaskDispatcher>(std::nullopt),
+      SimpleRemoteEPC::Setup(), FromExecutor[0], ToExecutor[1]));
+
+  for (auto _ : State)
+    benchmark::DoNotOptimize(
+        exitOnErr(EPC->runAsVoidFunction(ExecutorAddr::fromPtr(&noop))));
+
+  exitOnErr(EPC->disconnect());
+  exitOnErr(Server->waitForDisconnect());
+#else
+  State.SkipWithError("Requires threads and a Unix host");
+#endif
+}
+BENCHMARK(BM_EPCRoundTrip)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+/// Allocate, finalize and deallocate a small code and data allocation, the
+/// shape of a single JIT'd function.
+void benchmarkMemoryManager(benchmark::State &State,
+                            jitlink::JITLinkMemoryManager &MemMgr) {
+  using namespace jitlink;
+  for (auto _ : State) {
+    auto Alloc = exitOnErr(SimpleSegmentAlloc::Create(
+        MemMgr, nullptr,
+        {{MemProt::Read | MemProt::Exec, {256, Align(16)}},
+         {MemProt::Read | MemProt::Write, {64, Align(8)}}}));
+    auto FA = exitOnErr(Alloc.finalize());
+    exitOnErr(MemMgr.deallocate(std::move(FA)));
+  }
+}
+
+void BM_InProcessMemoryManager(benchmark::State &State) {
+  auto MemMgr = exitOnErr(jitlink::InProcessMemoryManager::Create());
+  benchmarkMemoryManager(State, *MemMgr);
+}
+BENCHMARK(BM_InProcessMemoryManager)->Unit(benchmark::kMicrosecond);
+
+template <typename MemoryMapperType>
+void BM_MapperJITLinkMemoryManager(benchmark::State &State) {
+  auto Mapper = MemoryMapperType::Create();
+  if (!Mapper) {
+    consumeError(Mapper.takeError());
+    State.SkipWithError("Memory mapper not supported on this host");
+    return;
+  }
+  MapperJITLinkMemoryManager MemMgr(16 * 1024 * 1024, std::move(*Mapper));
+  benchmarkMemoryManager(State, MemMgr);
+}
+BENCHMARK(BM_MapperJITLinkMemoryManager<InProcessMemoryMapper>)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_MapperJITLinkMemoryManager<DualMappedMemoryMapper>)
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
+
+BENCHMARK_MAIN();
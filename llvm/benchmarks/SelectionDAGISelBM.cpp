@@ -0,0 +1,157 @@
+//===- SelectionDAGISelBM.cpp - SelectionDAG ISel throughput benchmarks ---===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// These benchmarks measure the throughput of SelectionDAG instruction
+// selection on X86 and AArch64, in IR instructions per second. Only the
+// passes up to and including instruction selection run, on a fresh copy of
+// the module in every iteration, so the matcher table interpreter makes up a
+// large part of the time. Targets that are not built are skipped. LLVM
+// options can be passed after the benchmark options.
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/CodeGen/MachineModuleInfo.h"
+#include "llvm/CodeGen/TargetPassConfig.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Module.h"
+#include "llvm/InitializePasses.h"
+#include "llvm/MC/TargetRegistry.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Target/TargetMachine.h"
+#include "llvm/TargetParser/Triple.h"
+#include "llvm/Transforms/Utils/Cloning.h"
+#include <memory>
+
+using namespace llvm;
+
+static std::unique_ptr<LLVMTargetMachine>
+createTargetMachine(StringRef TripleName, unsigned OptLevel) {
+  Triple TargetTriple(TripleName);
+  std::string Error;
+  const Target *T = TargetRegistry::lookupTarget("", TargetTriple, Error);
+  if (!T)
+    return nullptr;
+
+  TargetOptions Options;
+  auto *TM = static_cast<LLVMTargetMachine *>(T->createTargetMachine(
+      TargetTriple.str(), "", "", Options, std::nullopt, std::nullopt,
+      *CodeGenOpt::getLevel(OptLevel)));
+  return std::unique_ptr<LLVMTargetMachine>(TM);
+}
+
+/// A straight-line function with about \p NumInstrs instructions that mixes
+/// 32- and 64-bit arithmetic, memory accesses and selects, so that the
+/// selected nodes go through opcode as well as type switches.
+static std::unique_ptr<Module> genIR(LLVMContext &Ctx, unsigned NumInstrs,
+                                     const TargetMachine &TM) {
+  std::string IR = "define i64 @foo(ptr %p, i64 %a, i32 %b) {\n"
+                   "  %v0 = add i64 %a, 1\n";
+  unsigned I = 1;
+  for (unsigned N = 1; N < NumInstrs; ++I) {
+    std::string V = "%v" + std::to_string(I);
+    std::string Prev = "%v" + std::to_string(I - 1);
+    std::string T = "%t" + std::to_string(I);
+    switch (I % 5) {
+    case 0:
+      IR += "  " + V + " = add i64 " + Prev + ", %a\n";
+      N += 1;
+      break;
+    case 1:
+      IR += "  " + T + " = getelementptr i64, ptr %p, i64 " + Prev + "\n";
+      IR += "  " + V + " = load i64, ptr " + T + "\n";
+      N += 2;
+      break;
+    case 2:
+      IR += "  " + T + " = trunc i64 " + Prev + " to i32\n";
+      IR += "  %u" + std::to_string(I) + " = xor i32 " + T + ", %b\n";
+      IR += "  " + V + " = zext i32 %u" + std::to_string(I) + " to i64\n";
+      N += 3;
+      break;
+    case 3:
+      IR += "  " + V + " = shl i64 " + Prev + ", 3\n";
+      N += 1;
+      break;
+    case 4:
+      IR += "  " + T + " = icmp ult i64 " + Prev + ", %a\n";
+      IR += "  " + V + " = select i1 " + T + ", i64 " + Prev + ", i64 %a\n";
+      N += 2;
+      break;
+    }
+  }
+  IR += "  ret i64 %v" + std::to_string(I - 1) + "\n}\n";
+
+  SMDiagnostic Err;
+  std::unique_ptr<Module> M = parseAssemblyString(IR, Err, Ctx);
+  if (!M) {
+    Err.print("SelectionDAGISelBM", errs());
+    return nullptr;
+  }
+  M->setTargetTriple(TM.getTargetTriple().str());
+  M->setDataLayout(TM.createDataLayout());
+  return M;
+}
+
+/// Run the IR passes of the code generator and instruction selection on \p M.
+static void runISel(Module &M, LLVMTargetMachine &TM) {
+  legacy::PassManager PM;
+  TargetPassConfig *TPC = TM.createPassConfig(PM);
+  TPC->setDisableVerify(true);
+  PM.add(TPC);
+  PM.add(new MachineModuleInfoWrapperPass(&TM));
+  TPC->addISelPasses();
+  TPC->setInitialized();
+  PM.run(M);
+}
+
+/// Arguments: the number of IR instructions and the optimization level. At
+/// -O0 FastISel would select most of the instructions, so stick to -O1 and up.
+static void BM_SelectionDAGISel(benchmark::State &State,
+                                const char *TripleName) {
+  std::unique_ptr<LLVMTargetMachine> TM =
+      createTargetMachine(TripleName, State.range(1));
+  LLVMContext Ctx;
+  std::unique_ptr<Module> M = TM ? genIR(Ctx, State.range(0), *TM) : nullptr;
+  if (!M) {
+    State.SkipWithError("cannot create the target or the module");
+    return;
+  }
+  for (auto _ : State) {
+    // The IR passes change the module, so start from the same one each time.
+    State.PauseTiming();
+    std::unique_ptr<Module> Clone = CloneModule(*M);
+    State.ResumeTiming();
+    runISel(*Clone, *TM);
+  }
+  State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+
+BENCHMARK_CAPTURE(BM_SelectionDAGISel, x86_64, "x86_64-unknown-linux-gnu")
+    ->ArgsProduct({{256, 4096}, {1, 2}});
+BENCHMARK_CAPTURE(BM_SelectionDAGISel, aarch64, "aarch64-unknown-linux-gnu")
+    ->ArgsProduct({{256, 4096}, {1, 2}});
+
+int main(int argc, char **argv) {
+  InitializeAllTargetInfos();
+  InitializeAllTargets();
+  InitializeAllTargetMCs();
+  PassRegistry &Registry = *PassRegistry::getPassRegistry();
+  initializeCore(Registry);
+  initializeCodeGen(Registry);
+  initializeTarget(Registry);
+  initializeAnalysis(Registry);
+
+  benchmark::Initialize(&argc, argv);
+  cl::ParseCommandLineOptions(argc, argv, "SelectionDAG ISel benchmarks\n");
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,78 @@
+//===- StringRefBM.cpp - StringRef search benchmarks ----------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/StringRef.h"
+#include <string>
+
+using namespace llvm;
+
+// Text resembling a generated .ll file: short lines of identifiers.
+static std::string getText(size_t Size) {
+  static const char *const Lines[] = {
+      "  %0 = load i32, ptr %x, align 4\n",
+      "  %add = add nsw i32 %0, 1\n",
+      "  store i32 %add, ptr %y, align 4\n",
+      "  br label %for.cond\n",
+  };
+  std::string Text;
+  for (unsigned I = 0; Text.size() < Size; ++I)
+    Text += Lines[I % std::size(Lines)];
+  return Text;
+}
+
+static void BM_CountNewlines(benchmark::State &State) {
+  std::string Text = getText(State.range(0));
+  for (auto _ : State)
+    benchmark::DoNotOptimize(StringRef(Text).count('\n'));
+  State.SetBytesProcessed(State.iterations() * Text.size());
+}
+
+static void BM_FindString(benchmark::State &State) {
+  std::string Text = getText(State.range(0));
+  for (auto _ : State)
+    benchmark::DoNotOptimize(StringRef(Text).find("ret void"));
+  State.SetBytesProcessed(State.iterations() * Text.size());
+}
+
+static void BM_FindCRLF(benchmark::State &State) {
+  std::string Text = getText(State.range(0));
+  for (auto _ : State)
+    benchmark::DoNotOptimize(StringRef(Text).find("\r\n"));
+  State.SetBytesProcessed(State.iterations() * Text.size());
+}
+
+static void BM_FindFirstOf(benchmark::State &State) {
+  std::string Text = getText(State.range(0));
+  for (auto _ : State)
+    benchmark::DoNotOptimize(StringRef(Text).find_first_of("\r\f\v"));
+  State.SetBytesProcessed(State.iterations() * Text.size());
+}
+
+// Splitting into lines exercises many short searches.
+static void BM_SplitLines(benchmark::State &State) {
+  std::string Text = getText(State.range(0));
+  for (auto _ : State) {
+    StringRef Rest = Text;
+    size_t NumLines = 0;
+    while (!Rest.empty()) {
+      Rest = Rest.split('\n').second;
+      ++NumLines;
+    }
+    benchmark::DoNotOptimize(NumLines);
+  }
+  State.SetBytesProcessed(State.iterations() * Text.size());
+}
+
+BENCHMARK(BM_CountNewlines)->Range(1 << 10, 1 << 24);
+BENCHMARK(BM_FindString)->Range(1 << 10, 1 << 24);
+BENCHMARK(BM_FindCRLF)->Range(1 << 10, 1 << 24);
+BENCHMARK(BM_FindFirstOf)->Range(1 << 10, 1 << 24);
+BENCHMARK(BM_SplitLines)->Range(1 << 10, 1 << 24);
+
+BENCHMARK_MAIN();
@@ -224,6 +224,36 @@ public:
     return {};
   }
 
+  /// Look up \p Key without inserting it.
+  ///
+  /// \returns the entry for \p Key, or nullptr if there is none.
+  KeyDataTy *find(const KeyTy &Key) const {
+    uint64_t Hash = Info::getHashValue(Key);
+    Bucket &CurBucket = BucketsArray[getBucketIdx(Hash)];
+    uint32_t ExtHashBits = getExtHashBits(Hash);
+
+#if LLVM_ENABLE_THREADS
+    std::lock_guard<std::mutex> Lock(CurBucket.Guard);
+#endif
+
+    uint32_t CurEntryIdx = getStartIdx(ExtHashBits, CurBucket.Size);
+    while (true) {
+      uint32_t CurEntryHashBits = CurBucket.Hashes[CurEntryIdx];
+      KeyDataTy *EntryData = CurBucket.Entries[CurEntryIdx];
+
+      // The bucket is never full, so an empty slot ends every probe sequence.
+      if (CurEntryHashBits == 0 && EntryData == nullptr)
+        return nullptr;
+
+      if (CurEntryHashBits == ExtHashBits &&
+          Info::isEqual(Info::getKey(*EntryData), Key))
+        return EntryData;
+
+      CurEntryIdx++;
+      CurEntryIdx &= (CurBucket.Size - 1);
+    }
+  }
+
   /// Print information about current state of hash table structures.
   void printStatistic(raw_ostream &OS) {
     OS << "\n--- HashTable statistic:\n";
@@ -359,13 +389,13 @@ protected:
       delete[] SrcEntries;
   }
 
-  uint32_t getBucketIdx(hash_code Hash) { return Hash & HashMask; }
+  uint32_t getBucketIdx(hash_code Hash) const { return Hash & HashMask; }
 
-  uint32_t getExtHashBits(uint64_t Hash) {
+  uint32_t getExtHashBits(uint64_t Hash) const {
     return (Hash & ExtHashMask) >> HashBitsNum;
   }
 
-  uint32_t getStartIdx(uint32_t ExtHashBits, uint32_t BucketSize) {
+  uint32_t getStartIdx(uint32_t ExtHashBits, uint32_t BucketSize) const {
     assert((BucketSize > 0) && "Empty bucket");
 
     return ExtHashBits & (BucketSize - 1);
@@ -0,0 +1,167 @@
+//===- ConcurrentStringMap.h ------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file defines ConcurrentStringMap, a StringMap-like table that can be
+/// populated from many threads at once, and ConcurrentStringPool, a string
+/// interner built on top of it.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ADT_CONCURRENTSTRINGMAP_H
+#define LLVM_ADT_CONCURRENTSTRINGMAP_H
+
+#include "llvm/ADT/ConcurrentHashtable.h"
+#include "llvm/ADT/StringMapEntry.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/PerThreadBumpPtrAllocator.h"
+#include "llvm/Support/xxhash.h"
+#include <atomic>
+#include <optional>
+#include <type_traits>
+
+namespace llvm {
+
+/// ConcurrentHashTableByPtr traits for StringMapEntry<ValueTy> keyed by the
+/// string.
+template <typename ValueTy> class ConcurrentStringMapInfo {
+public:
+  using EntryTy = StringMapEntry<ValueTy>;
+
+  static uint64_t getHashValue(StringRef Key) { return xxh3_64bits(Key); }
+
+  static bool isEqual(StringRef LHS, StringRef RHS) { return LHS == RHS; }
+
+  static StringRef getKey(const EntryTy &Entry) { return Entry.getKey(); }
+
+  static EntryTy *create(StringRef Key,
+                         parallel::PerThreadBumpPtrAllocator &Allocator) {
+    return EntryTy::create(Key, Allocator);
+  }
+};
+
+/// A map from strings to values of type \p ValueTy that supports concurrent
+/// insertions and lookups.
+///
+/// Entries are StringMapEntry objects allocated from a
+/// PerThreadBumpPtrAllocator, so each thread fills its own arena and the keys
+/// returned by getKey() stay valid until the map is cleared or destroyed.
+/// Entries are never removed individually, and values are never destroyed,
+/// which is why \p ValueTy must be trivially destructible.
+///
+/// The table is a ConcurrentHashTableByPtr, which locks only the bucket that a
+/// key hashes to. It has many more buckets than there are threads, so threads
+/// rarely wait for each other.
+///
+/// Like PerThreadBumpPtrAllocator, insertions must run on the threads of the
+/// llvm::parallel executor, e.g. inside parallelFor or a TaskGroup, unless
+/// parallel::strategy requests a single thread.
+template <typename ValueTy> class ConcurrentStringMap {
+  static_assert(std::is_trivially_destructible_v<ValueTy>,
+                "values are not destroyed");
+
+public:
+  using EntryTy = StringMapEntry<ValueTy>;
+
+  /// \p EstimatedSize is the expected number of entries, which determines the
+  /// initial size of the table.
+  explicit ConcurrentStringMap(
+      uint64_t EstimatedSize = 100000,
+      size_t ThreadsNum = parallel::strategy.compute_thread_count())
+      : Table(Allocator, EstimatedSize, ThreadsNum) {}
+
+  ConcurrentStringMap(const ConcurrentStringMap &) = delete;
+  ConcurrentStringMap &operator=(const ConcurrentStringMap &) = delete;
+
+  /// \defgroup Methods which could be called asynchronously:
+  ///
+  /// @{
+
+  /// Insert \p Key with a value-initialized value, unless it is already in the
+  /// map.
+  ///
+  /// \returns the entry for \p Key and whether it was inserted.
+  std::pair<EntryTy *, bool> insert(StringRef Key) {
+    std::pair<EntryTy *, bool> Result = Table.insert(Key);
+    if (Result.second)
+      NumEntries.fetch_add(1, std::memory_order_relaxed);
+    return Result;
+  }
+
+  /// \returns the value for \p Key, inserting it if it is not in the map.
+  /// Concurrent accesses to the same value must be synchronized by the caller.
+  ValueTy &operator[](StringRef Key) { return insert(Key).first->getValue(); }
+
+  /// \returns the entry for \p Key, or nullptr if it is not in the map.
+  EntryTy *find(StringRef Key) const { return Table.find(Key); }
+
+  bool contains(StringRef Key) const { return find(Key) != nullptr; }
+
+  /// \returns the number of entries. This may be out of date by the time it
+  /// returns if other threads are inserting.
+  size_t size() const { return NumEntries.load(std::memory_order_relaxed); }
+  bool empty() const { return size() == 0; }
+
+  /// @}
+
+  /// \defgroup Methods which could not be called asynchronously:
+  ///
+  /// @{
+
+  /// \returns the allocator of the entries.
+  parallel::PerThreadBumpPtrAllocator &getAllocator() { return Allocator; }
+
+  /// Print information about the hash table and the allocators.
+  void printStatistic(raw_ostream &OS) {
+    Table.printStatistic(OS);
+    OS << "\nAllocated bytes = " << Allocator.getBytesAllocated() << '\n';
+  }
+
+  /// @}
+
+private:
+  // Must be initialized before Table, which keeps a reference to it.
+  parallel::PerThreadBumpPtrAllocator Allocator;
+  ConcurrentHashTableByPtr<StringRef, EntryTy,
+                           parallel::PerThreadBumpPtrAllocator,
+                           ConcurrentStringMapInfo<ValueTy>>
+      Table;
+  std::atomic<size_t> NumEntries = 0;
+};
+
+/// A string interner that can be used from many threads at once. Equal
+/// strings are saved once and map to the same StringRef, so interned strings
+/// can be compared by their data pointers.
+class ConcurrentStringPool {
+public:
+  explicit ConcurrentStringPool(
+      uint64_t EstimatedSize = 100000,
+      size_t ThreadsNum = parallel::strategy.compute_thread_count())
+      : Map(EstimatedSize, ThreadsNum) {}
+
+  /// \returns the unique copy of \p S, which lives as long as the pool.
+  StringRef save(StringRef S) { return Map.insert(S).first->getKey(); }
+
+  /// \returns the unique copy of \p S if it was saved before.
+  std::optional<StringRef> lookup(StringRef S) const {
+    if (auto *Entry = Map.find(S))
+      return Entry->getKey();
+    return std::nullopt;
+  }
+
+  size_t size() const { return Map.size(); }
+
+  void printStatistic(raw_ostream &OS) { Map.printStatistic(OS); }
+
+private:
+  ConcurrentStringMap<std::nullopt_t> Map;
+};
+
+} // end namespace llvm
+
+#endif // LLVM_ADT_CONCURRENTSTRINGMAP_H
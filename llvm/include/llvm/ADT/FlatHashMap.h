@@ -0,0 +1,699 @@
+//===- llvm/ADT/FlatHashMap.h - Group probed hash table ---------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file defines the FlatHashMap class, an open addressing hash table in
+/// the style of Swiss tables.
+///
+/// Next to the buckets, the table keeps one control byte per bucket which is
+/// either empty, deleted, or holds 7 bits of the hash of the key stored in the
+/// bucket. Lookups load a group of 16 (SSE2) or 8 (portable) control bytes at
+/// once and only compare keys whose hash bits match, probing group by group.
+///
+/// Unlike DenseMap, FlatHashMap does not reserve empty and tombstone keys, and
+/// erasing a key only leaves a deleted marker if its group has never had a
+/// free bucket, so lookups do not degrade under insert/erase churn. The table
+/// grows at a load factor of 7/8 rather than 3/4. It uses the same
+/// DenseMapInfo traits as DenseMap, except that getEmptyKey() and
+/// getTombstoneKey() are never called.
+///
+/// Iteration order is unspecified, and any insertion or erasure invalidates
+/// iterators and references to the buckets.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ADT_FLATHASHMAP_H
+#define LLVM_ADT_FLATHASHMAP_H
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseMapInfo.h"
+#include "llvm/ADT/EpochTracker.h"
+#include "llvm/ADT/bit.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/MemAlloc.h"
+#include "llvm/Support/type_traits.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LLVM_FLAT_HASH_MAP_SSE2 1
+#else
+#define LLVM_FLAT_HASH_MAP_SSE2 0
+#endif
+
+namespace llvm {
+
+namespace detail {
+
+/// Control byte values of FlatHashMap buckets that do not hold a key. A bucket
+/// holding a key has the non-negative 7-bit hash fragment of the key instead.
+enum : int8_t {
+  FlatHashEmpty = -128,
+  FlatHashDeleted = -2,
+};
+
+/// A group of control bytes that is probed at once. The match functions return
+/// a mask with one bit set per matching control byte; the index of the byte is
+/// the index of the bit shifted right by Shift.
+#if LLVM_FLAT_HASH_MAP_SSE2
+struct FlatHashGroup {
+  static constexpr unsigned Width = 16;
+  static constexpr unsigned Shift = 0;
+
+  explicit FlatHashGroup(const int8_t *Pos)
+      : Ctrl(_mm_load_si128(reinterpret_cast<const __m128i *>(Pos))) {}
+
+  uint64_t match(int8_t H2) const {
+    return unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(H2), Ctrl)));
+  }
+  uint64_t matchEmpty() const { return match(FlatHashEmpty); }
+  uint64_t matchEmptyOrDeleted() const {
+    return unsigned(_mm_movemask_epi8(Ctrl));
+  }
+
+private:
+  __m128i Ctrl;
+};
+#else
+struct FlatHashGroup {
+  static constexpr unsigned Width = 8;
+  static constexpr unsigned Shift = 3;
+
+  explicit FlatHashGroup(const int8_t *Pos)
+      : Ctrl(support::endian::read64le(Pos)) {}
+
+  /// May report false positives after a true match. They are harmless because
+  /// the keys of all matches are compared anyway.
+  uint64_t match(int8_t H2) const {
+    uint64_t X = Ctrl ^ (LSBs * uint8_t(H2));
+    return (X - LSBs) & ~X & MSBs;
+  }
+  uint64_t matchEmpty() const { return Ctrl & ~(Ctrl << 6) & MSBs; }
+  uint64_t matchEmptyOrDeleted() const { return Ctrl & MSBs; }
+
+private:
+  static constexpr uint64_t LSBs = 0x0101010101010101;
+  static constexpr uint64_t MSBs = 0x8080808080808080;
+  uint64_t Ctrl;
+};
+#endif
+
+template <typename KeyT, typename ValueT, typename KeyInfoT, typename BucketT,
+          bool IsConst = false>
+class FlatHashMapIterator : DebugEpochBase::HandleBase {
+  friend class FlatHashMapIterator<KeyT, ValueT, KeyInfoT, BucketT, true>;
+  friend class FlatHashMapIterator<KeyT, ValueT, KeyInfoT, BucketT, false>;
+
+public:
+  using difference_type = ptrdiff_t;
+  using value_type = std::conditional_t<IsConst, const BucketT, BucketT>;
+  using pointer = value_type *;
+  using reference = value_type &;
+  using iterator_category = std::forward_iterator_tag;
+
+private:
+  const int8_t *Ctrl = nullptr;
+  pointer Ptr = nullptr;
+  pointer End = nullptr;
+
+  void advancePastFreeBuckets() {
+    while (Ptr != End && *Ctrl < 0) {
+      ++Ctrl;
+      ++Ptr;
+    }
+  }
+
+public:
+  FlatHashMapIterator() = default;
+
+  FlatHashMapIterator(const int8_t *Ctrl, pointer Pos, pointer E,
+                      const DebugEpochBase &Epoch, bool NoAdvance = false)
+      : DebugEpochBase::HandleBase(&Epoch), Ctrl(Ctrl), Ptr(Pos), End(E) {
+    assert(isHandleInSync() && "invalid construction!");
+    if (!NoAdvance)
+      advancePastFreeBuckets();
+  }
+
+  // Converting ctor from non-const iterators to const iterators. SFINAE'd out
+  // for const iterator destinations so it doesn't end up as a user defined copy
+  // constructor.
+  template <bool IsConstSrc,
+            typename = std::enable_if_t<!IsConstSrc && IsConst>>
+  FlatHashMapIterator(
+      const FlatHashMapIterator<KeyT, ValueT, KeyInfoT, BucketT, IsConstSrc>
+          &I)
+      : DebugEpochBase::HandleBase(I), Ctrl(I.Ctrl), Ptr(I.Ptr), End(I.End) {}
+
+  reference operator*() const {
+    assert(isHandleInSync() && "invalid iterator access!");
+    assert(Ptr != End && "dereferencing end() iterator");
+    return *Ptr;
+  }
+  pointer operator->() const { return &operator*(); }
+
+  friend bool operator==(const FlatHashMapIterator &LHS,
+                         const FlatHashMapIterator &RHS) {
+    assert((!LHS.Ptr || LHS.isHandleInSync()) && "handle not in sync!");
+    assert((!RHS.Ptr || RHS.isHandleInSync()) && "handle not in sync!");
+    assert(LHS.getEpochAddress() == RHS.getEpochAddress() &&
+           "comparing incomparable iterators!");
+    return LHS.Ptr == RHS.Ptr;
+  }
+
+  friend bool operator!=(const FlatHashMapIterator &LHS,
+                         const FlatHashMapIterator &RHS) {
+    return !(LHS == RHS);
+  }
+
+  inline FlatHashMapIterator &operator++() { // Preincrement
+    assert(isHandleInSync() && "invalid iterator access!");
+    assert(Ptr != End && "incrementing end() iterator");
+    ++Ctrl;
+    ++Ptr;
+    advancePastFreeBuckets();
+    return *this;
+  }
+  FlatHashMapIterator operator++(int) { // Postincrement
+    assert(isHandleInSync() && "invalid iterator access!");
+    FlatHashMapIterator Tmp = *this;
+    ++*this;
+    return Tmp;
+  }
+};
+
+} // end namespace detail
+
+template <typename KeyT, typename ValueT,
+          typename KeyInfoT = DenseMapInfo<KeyT>,
+          typename BucketT = llvm::detail::DenseMapPair<KeyT, ValueT>>
+class FlatHashMap : public DebugEpochBase {
+  template <typename T>
+  using const_arg_type_t = typename const_pointer_or_const_ref<T>::type;
+
+  using Group = detail::FlatHashGroup;
+
+public:
+  using size_type = unsigned;
+  using key_type = KeyT;
+  using mapped_type = ValueT;
+  using value_type = BucketT;
+
+  using iterator = detail::FlatHashMapIterator<KeyT, ValueT, KeyInfoT, BucketT>;
+  using const_iterator =
+      detail::FlatHashMapIterator<KeyT, ValueT, KeyInfoT, BucketT, true>;
+
+  /// Create a FlatHashMap that can hold at least \p InitialReserve entries
+  /// without growing.
+  explicit FlatHashMap(unsigned InitialReserve = 0) { reserve(InitialReserve); }
+
+  FlatHashMap(std::initializer_list<value_type> Vals) {
+    reserve(Vals.size());
+    for (const value_type &KV : Vals)
+      insert(KV);
+  }
+
+  FlatHashMap(const FlatHashMap &Other) : DebugEpochBase() {
+    if (Other.NumBuckets == 0)
+      return;
+    allocate(Other.NumBuckets);
+    std::memcpy(Ctrl, Other.Ctrl, NumBuckets);
+    for (size_t I = 0; I != NumBuckets; ++I)
+      if (Ctrl[I] >= 0)
+        ::new (&getBuckets()[I]) BucketT(Other.getBuckets()[I]);
+    NumEntries = Other.NumEntries;
+    GrowthLeft = Other.GrowthLeft;
+  }
+
+  FlatHashMap(FlatHashMap &&Other) : DebugEpochBase() { swap(Other); }
+
+  FlatHashMap &operator=(const FlatHashMap &Other) {
+    if (&Other != this) {
+      FlatHashMap Tmp(Other);
+      swap(Tmp);
+    }
+    return *this;
+  }
+
+  FlatHashMap &operator=(FlatHashMap &&Other) {
+    FlatHashMap Tmp(std::move(Other));
+    swap(Tmp);
+    return *this;
+  }
+
+  ~FlatHashMap() {
+    destroyAll();
+    deallocate();
+  }
+
+  inline iterator begin() {
+    if (empty())
+      return end();
+    return iterator(Ctrl, getBuckets(), getBucketsEnd(), *this);
+  }
+  inline iterator end() {
+    return iterator(Ctrl + NumBuckets, getBucketsEnd(), getBucketsEnd(), *this,
+                    true);
+  }
+  inline const_iterator begin() const {
+    if (empty())
+      return end();
+    return const_iterator(Ctrl, getBuckets(), getBucketsEnd(), *this);
+  }
+  inline const_iterator end() const {
+    return const_iterator(Ctrl + NumBuckets, getBucketsEnd(), getBucketsEnd(),
+                          *this, true);
+  }
+
+  [[nodiscard]] bool empty() const { return NumEntries == 0; }
+  unsigned size() const { return NumEntries; }
+
+  /// Grow the map so that it can contain at least \p NumEntries items before
+  /// resizing again.
+  void reserve(size_type NumEntries) {
+    incrementEpoch();
+    if (NumEntries <= this->NumEntries + GrowthLeft)
+      return;
+    size_t NewNumBuckets = Group::Width;
+    while (getMaxLoad(NewNumBuckets) < NumEntries)
+      NewNumBuckets *= 2;
+    resize(std::max(NewNumBuckets, NumBuckets));
+  }
+
+  void clear() {
+    incrementEpoch();
+    if (NumBuckets == 0)
+      return;
+    destroyAll();
+    // If the capacity of the table is huge, and the # elements used is small,
+    // release it.
+    if (NumEntries * 4 < NumBuckets && NumBuckets > 64) {
+      deallocate();
+      NumEntries = 0;
+      GrowthLeft = 0;
+      return;
+    }
+    std::memset(Ctrl, detail::FlatHashEmpty, NumBuckets);
+    NumEntries = 0;
+    GrowthLeft = getMaxLoad(NumBuckets);
+  }
+
+  /// Return true if the specified key is in the map, false otherwise.
+  bool contains(const_arg_type_t<KeyT> Val) const {
+    return doFind(Val) != nullptr;
+  }
+
+  /// Return 1 if the specified key is in the map, 0 otherwise.
+  size_type count(const_arg_type_t<KeyT> Val) const {
+    return contains(Val) ? 1 : 0;
+  }
+
+  iterator find(const_arg_type_t<KeyT> Val) { return find_as(Val); }
+  const_iterator find(const_arg_type_t<KeyT> Val) const { return find_as(Val); }
+
+  /// Alternate version of find() which allows a different, and possibly less
+  /// expensive, key type. The DenseMapInfo is responsible for supplying methods
+  /// getHashValue(LookupKeyT) and isEqual(LookupKeyT, KeyT) for each key type
+  /// used.
+  template <class LookupKeyT> iterator find_as(const LookupKeyT &Val) {
+    if (BucketT *Bucket = doFind(Val))
+      return makeIterator(Bucket);
+    return end();
+  }
+  template <class LookupKeyT>
+  const_iterator find_as(const LookupKeyT &Val) const {
+    if (const BucketT *Bucket = doFind(Val))
+      return makeConstIterator(Bucket);
+    return end();
+  }
+
+  /// lookup - Return the entry for the specified key, or a default
+  /// constructed value if no such entry exists.
+  ValueT lookup(const_arg_type_t<KeyT> Val) const {
+    if (const BucketT *Bucket = doFind(Val))
+      return Bucket->getSecond();
+    return ValueT();
+  }
+
+  /// at - Return the entry for the specified key, or abort if no such
+  /// entry exists.
+  const ValueT &at(const_arg_type_t<KeyT> Val) const {
+    const BucketT *Bucket = doFind(Val);
+    assert(Bucket && "FlatHashMap::at failed due to a missing key");
+    return Bucket->getSecond();
+  }
+
+  // Inserts key,value pair into the map if the key isn't already in the map.
+  // If the key is already in the map, it returns false and doesn't update the
+  // value.
+  std::pair<iterator, bool> insert(const std::pair<KeyT, ValueT> &KV) {
+    return try_emplace(KV.first, KV.second);
+  }
+
+  // Inserts key,value pair into the map if the key isn't already in the map.
+  // If the key is already in the map, it returns false and doesn't update the
+  // value.
+  std::pair<iterator, bool> insert(std::pair<KeyT, ValueT> &&KV) {
+    return try_emplace(std::move(KV.first), std::move(KV.second));
+  }
+
+  // Inserts key,value pair into the map if the key isn't already in the map.
+  // The value is constructed in-place if the key is not in the map, otherwise
+  // it is not moved.
+  template <typename... Ts>
+  std::pair<iterator, bool> try_emplace(KeyT &&Key, Ts &&...Args) {
+    return tryEmplaceImpl(std::move(Key), std::forward<Ts>(Args)...);
+  }
+
+  // Inserts key,value pair into the map if the key isn't already in the map.
+  // The value is constructed in-place if the key is not in the map, otherwise
+  // it is not moved.
+  template <typename... Ts>
+  std::pair<iterator, bool> try_emplace(const KeyT &Key, Ts &&...Args) {
+    return tryEmplaceImpl(Key, std::forward<Ts>(Args)...);
+  }
+
+  /// insert - Range insertion of pairs.
+  template <typename InputIt> void insert(InputIt I, InputIt E) {
+    for (; I != E; ++I)
+      insert(*I);
+  }
+
+  template <typename V>
+  std::pair<iterator, bool> insert_or_assign(const KeyT &Key, V &&Val) {
+    auto Ret = try_emplace(Key, std::forward<V>(Val));
+    if (!Ret.second)
+      Ret.first->second = std::forward<V>(Val);
+    return Ret;
+  }
+
+  template <typename V>
+  std::pair<iterator, bool> insert_or_assign(KeyT &&Key, V &&Val) {
+    auto Ret = try_emplace(std::move(Key), std::forward<V>(Val));
+    if (!Ret.second)
+      Ret.first->second = std::forward<V>(Val);
+    return Ret;
+  }
+
+  bool erase(const KeyT &Val) {
+    BucketT *Bucket = doFind(Val);
+    if (!Bucket)
+      return false;
+    eraseBucket(Bucket);
+    return true;
+  }
+  void erase(iterator I) {
+    BucketT *Bucket = &*I;
+    eraseBucket(Bucket);
+  }
+
+  ValueT &operator[](const KeyT &Key) {
+    return try_emplace(Key).first->second;
+  }
+
+  ValueT &operator[](KeyT &&Key) {
+    return try_emplace(std::move(Key)).first->second;
+  }
+
+  void swap(FlatHashMap &RHS) {
+    this->incrementEpoch();
+    RHS.incrementEpoch();
+    std::swap(Ctrl, RHS.Ctrl);
+    std::swap(NumBuckets, RHS.NumBuckets);
+    std::swap(NumEntries, RHS.NumEntries);
+    std::swap(GrowthLeft, RHS.GrowthLeft);
+  }
+
+  /// Return the approximate size (in bytes) of the actual map.
+  /// This is just the raw memory used by FlatHashMap.
+  /// If entries are pointers to objects, the size of the referenced objects
+  /// are not included.
+  size_t getMemorySize() const {
+    return NumBuckets ? getAllocationSize(NumBuckets) : 0;
+  }
+
+  /// Return the number of buckets, including the free ones.
+  size_t getNumBuckets() const { return NumBuckets; }
+
+private:
+  /// The control bytes, followed by the buckets, in a single allocation.
+  int8_t *Ctrl = nullptr;
+  size_t NumBuckets = 0;
+  unsigned NumEntries = 0;
+  /// The number of empty buckets that can be filled before the table has to
+  /// be rehashed.
+  size_t GrowthLeft = 0;
+
+  static size_t getMaxLoad(size_t NumBuckets) {
+    return NumBuckets - NumBuckets / 8;
+  }
+
+  static size_t getBucketsOffset(size_t NumBuckets) {
+    return alignTo(NumBuckets, alignof(BucketT));
+  }
+
+  static size_t getAllocationSize(size_t NumBuckets) {
+    return getBucketsOffset(NumBuckets) + NumBuckets * sizeof(BucketT);
+  }
+
+  static constexpr size_t getAllocationAlign() {
+    return std::max<size_t>(alignof(BucketT), Group::Width);
+  }
+
+  BucketT *getBuckets() const {
+    return reinterpret_cast<BucketT *>(Ctrl + getBucketsOffset(NumBuckets));
+  }
+  BucketT *getBucketsEnd() const { return getBuckets() + NumBuckets; }
+
+  iterator makeIterator(BucketT *Bucket) {
+    return iterator(Ctrl + (Bucket - getBuckets()), Bucket, getBucketsEnd(),
+                    *this, true);
+  }
+  const_iterator makeConstIterator(const BucketT *Bucket) const {
+    return const_iterator(Ctrl + (Bucket - getBuckets()), Bucket,
+                          getBucketsEnd(), *this, true);
+  }
+
+  /// Mix the result of DenseMapInfo::getHashValue, which is often weak (e.g.
+  /// shifted pointers), so that both the group index taken from the low bits
+  /// and the 7-bit fragment taken from the top bits are well distributed.
+  template <class LookupKeyT> static uint64_t getHash(const LookupKeyT &Val) {
+    uint64_t H = uint64_t(KeyInfoT::getHashValue(Val)) * 0x9E3779B97F4A7C15;
+    return H ^ (H >> 32);
+  }
+  static int8_t getH2(uint64_t Hash) { return int8_t(Hash >> 57); }
+
+  /// Visits the groups starting at the one selected by the hash, using
+  /// triangular steps, which reach every group of a power-of-two table.
+  struct ProbeSeq {
+    size_t Mask;
+    size_t Offset;
+    size_t Index = 0;
+
+    ProbeSeq(uint64_t Hash, size_t NumGroups)
+        : Mask(NumGroups - 1), Offset(Hash & Mask) {}
+    size_t getFirstBucket() const { return Offset * Group::Width; }
+    void next() {
+      ++Index;
+      Offset = (Offset + Index) & Mask;
+    }
+  };
+
+  template <typename LookupKeyT>
+  const BucketT *doFind(const LookupKeyT &Val) const {
+    if (NumBuckets == 0)
+      return nullptr;
+    uint64_t Hash = getHash(Val);
+    int8_t H2 = getH2(Hash);
+    const BucketT *Buckets = getBuckets();
+    for (ProbeSeq Seq(Hash, NumBuckets / Group::Width);; Seq.next()) {
+      size_t First = Seq.getFirstBucket();
+      Group G(Ctrl + First);
+      for (uint64_t M = G.match(H2); M; M &= M - 1) {
+        const BucketT *Bucket =
+            Buckets + First + (countr_zero(M) >> Group::Shift);
+        if (LLVM_LIKELY(KeyInfoT::isEqual(Val, Bucket->getFirst())))
+          return Bucket;
+      }
+      if (LLVM_LIKELY(G.matchEmpty()))
+        return nullptr;
+      assert(Seq.Index <= Seq.Mask && "full table");
+    }
+  }
+  template <typename LookupKeyT> BucketT *doFind(const LookupKeyT &Val) {
+    return const_cast<BucketT *>(
+        static_cast<const FlatHashMap *>(this)->doFind(Val));
+  }
+
+  /// Returns the first empty or deleted bucket in the probe sequence of
+  /// \p Hash.
+  size_t findInsertSlot(uint64_t Hash) const {
+    for (ProbeSeq Seq(Hash, NumBuckets / Group::Width);; Seq.next()) {
+      size_t First = Seq.getFirstBucket();
+      if (uint64_t M = Group(Ctrl + First).matchEmptyOrDeleted())
+        return First + (countr_zero(M) >> Group::Shift);
+      assert(Seq.Index <= Seq.Mask && "full table");
+    }
+  }
+
+  template <typename KeyArg, typename... Ts>
+  std::pair<iterator, bool> tryEmplaceImpl(KeyArg &&Key, Ts &&...Args) {
+    if (BucketT *Bucket = doFind(Key))
+      return std::make_pair(makeIterator(Bucket), false);
+
+    incrementEpoch();
+    uint64_t Hash = getHash(Key);
+    size_t Slot = 0;
+    if (NumBuckets != 0)
+      Slot = findInsertSlot(Hash);
+    // Deleted buckets can be reused without affecting the load factor.
+    if (NumBuckets == 0 ||
+        (GrowthLeft == 0 && Ctrl[Slot] == detail::FlatHashEmpty)) {
+      rehashAndGrow();
+      Slot = findInsertSlot(Hash);
+    }
+    if (Ctrl[Slot] == detail::FlatHashEmpty)
+      --GrowthLeft;
+    Ctrl[Slot] = getH2(Hash);
+    ++NumEntries;
+
+    BucketT *Bucket = getBuckets() + Slot;
+    ::new (&Bucket->getFirst()) KeyT(std::forward<KeyArg>(Key));
+    ::new (&Bucket->getSecond()) ValueT(std::forward<Ts>(Args)...);
+    return std::make_pair(makeIterator(Bucket), true);
+  }
+
+  void eraseBucket(BucketT *Bucket) {
+    incrementEpoch();
+    size_t Slot = Bucket - getBuckets();
+    Bucket->~BucketT();
+    --NumEntries;
+    // A group that has an empty bucket has never been full, so no probe
+    // sequence ever continued past it, and the bucket can become empty again
+    // instead of deleted.
+    if (Group(Ctrl + (Slot & ~size_t(Group::Width - 1))).matchEmpty()) {
+      Ctrl[Slot] = detail::FlatHashEmpty;
+      ++GrowthLeft;
+    } else {
+      Ctrl[Slot] = detail::FlatHashDeleted;
+    }
+  }
+
+  /// Called when there is no empty bucket left that can be filled. If enough
+  /// buckets are only deleted, the table is rehashed at the same size to
+  /// drop them, otherwise it is doubled.
+  void rehashAndGrow() {
+    if (NumBuckets == 0)
+      resize(Group::Width);
+    else if (NumBuckets > Group::Width &&
+             uint64_t(NumEntries) * 32 <= uint64_t(NumBuckets) * 25)
+      resize(NumBuckets);
+    else
+      resize(NumBuckets * 2);
+  }
+
+  void resize(size_t NewNumBuckets) {
+    assert(isPowerOf2_64(NewNumBuckets) && NewNumBuckets >= Group::Width);
+    incrementEpoch();
+    int8_t *OldCtrl = Ctrl;
+    size_t OldNumBuckets = NumBuckets;
+    BucketT *OldBuckets = getBuckets();
+
+    allocate(NewNumBuckets);
+    std::memset(Ctrl, detail::FlatHashEmpty, NumBuckets);
+    GrowthLeft = getMaxLoad(NumBuckets) - NumEntries;
+    if (!OldCtrl)
+      return;
+
+    BucketT *Buckets = getBuckets();
+    for (size_t I = 0; I != OldNumBuckets; ++I) {
+      if (OldCtrl[I] < 0)
+        continue;
+      BucketT &Old = OldBuckets[I];
+      uint64_t Hash = getHash(Old.getFirst());
+      size_t Slot = findInsertSlot(Hash);
+      Ctrl[Slot] = getH2(Hash);
+      ::new (&Buckets[Slot]) BucketT(std::move(Old));
+      Old.~BucketT();
+    }
+    deallocate_buffer(OldCtrl, getAllocationSize(OldNumBuckets),
+                      getAllocationAlign());
+  }
+
+  void allocate(size_t Num) {
+    NumBuckets = Num;
+    Ctrl = static_cast<int8_t *>(
+        allocate_buffer(getAllocationSize(Num), getAllocationAlign()));
+  }
+
+  void deallocate() {
+    if (Ctrl)
+      deallocate_buffer(Ctrl, getAllocationSize(NumBuckets),
+                        getAllocationAlign());
+    Ctrl = nullptr;
+    NumBuckets = 0;
+  }
+
+  void destroyAll() {
+    if constexpr (std::is_trivially_destructible_v<BucketT>)
+      return;
+    BucketT *Buckets = getBuckets();
+    for (size_t I = 0; I != NumBuckets; ++I)
+      if (Ctrl[I] >= 0)
+        Buckets[I].~BucketT();
+  }
+};
+
+/// Equality comparison for FlatHashMap.
+///
+/// Iterates over elements of LHS confirming that each (key, value) pair in LHS
+/// is also in RHS, and that no additional pairs are in RHS.
+/// Equivalent to N calls to RHS.find and N value comparisons. Amortized
+/// complexity is linear, worst case is O(N^2) (if every hash collides).
+template <typename KeyT, typename ValueT, typename KeyInfoT, typename BucketT>
+bool operator==(const FlatHashMap<KeyT, ValueT, KeyInfoT, BucketT> &LHS,
+                const FlatHashMap<KeyT, ValueT, KeyInfoT, BucketT> &RHS) {
+  if (LHS.size() != RHS.size())
+    return false;
+
+  for (auto &KV : LHS) {
+    auto I = RHS.find(KV.first);
+    if (I == RHS.end() || I->second != KV.second)
+      return false;
+  }
+
+  return true;
+}
+
+/// Inequality comparison for FlatHashMap.
+///
+/// Equivalent to !(LHS == RHS). See operator== for performance notes.
+template <typename KeyT, typename ValueT, typename KeyInfoT, typename BucketT>
+bool operator!=(const FlatHashMap<KeyT, ValueT, KeyInfoT, BucketT> &LHS,
+                const FlatHashMap<KeyT, ValueT, KeyInfoT, BucketT> &RHS) {
+  return !(LHS == RHS);
+}
+
+template <typename KeyT, typename ValueT, typename KeyInfoT, typename BucketT>
+inline size_t
+capacity_in_bytes(const FlatHashMap<KeyT, ValueT, KeyInfoT, BucketT> &X) {
+  return X.getMemorySize();
+}
+
+} // end namespace llvm
+
+#endif // LLVM_ADT_FLATHASHMAP_H
@@ -17,7 +17,9 @@
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/FoldingSet.h"
 #include "llvm/ADT/IntrusiveRefCntPtr.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/TinyPtrVector.h"
 #include "llvm/ADT/iterator.h"
 #include "llvm/Support/Allocator.h"
 #include "llvm/Support/ErrorHandling.h"
@@ -209,8 +211,6 @@ private:
   Factory *factory;
   ImutAVLTree *left;
   ImutAVLTree *right;
-  ImutAVLTree *prev = nullptr;
-  ImutAVLTree *next = nullptr;
 
   unsigned height : 28;
   bool IsMutable : 1;
@@ -329,13 +329,11 @@ public:
     if (right)
       right->release();
     if (IsCanonicalized) {
-      if (next)
-        next->prev = prev;
-
-      if (prev)
-        prev->next = next;
-      else
-        factory->Cache[factory->maskCacheIndex(computeDigest())] = next;
+      auto I = factory->Cache.find(factory->maskCacheIndex(computeDigest()));
+      assert(I != factory->Cache.end() && "Canonical tree not in the cache.");
+      I->second.erase(llvm::find(I->second, this));
+      if (I->second.empty())
+        factory->Cache.erase(I);
     }
 
     // We need to clear the mutability bit in case we are
@@ -362,7 +360,9 @@ class ImutAVLFactory {
   using TreeTy = ImutAVLTree<ImutInfo>;
   using value_type_ref = typename TreeTy::value_type_ref;
   using key_type_ref = typename TreeTy::key_type_ref;
-  using CacheTy = DenseMap<unsigned, TreeTy*>;
+  // Canonical trees by digest. Collisions are kept in the map rather than
+  // linked through the trees, which keeps the nodes of all trees smaller.
+  using CacheTy = DenseMap<unsigned, TinyPtrVector<TreeTy *>>;
 
   CacheTy Cache;
   uintptr_t Allocator;
@@ -607,28 +607,21 @@ public:
     // Search the hashtable for another tree with the same digest, and
     // if find a collision compare those trees by their contents.
     unsigned digest = TNew->computeDigest();
-    TreeTy *&entry = Cache[maskCacheIndex(digest)];
-    do {
-      if (!entry)
-        break;
-      for (TreeTy *T = entry ; T != nullptr; T = T->next) {
-        // Compare the Contents('T') with Contents('TNew')
-        typename TreeTy::iterator TI = T->begin(), TE = T->end();
-        if (!compareTreeWithSection(TNew, TI, TE))
-          continue;
-        if (TI != TE)
-          continue; // T has more contents than TNew.
-        // Trees did match!  Return 'T'.
-        if (TNew->refCount == 0)
-          TNew->destroy();
-        return T;
-      }
-      entry->prev = TNew;
-      TNew->next = entry;
+    TinyPtrVector<TreeTy *> &Entries = Cache[maskCacheIndex(digest)];
+    for (TreeTy *T : Entries) {
+      // Compare the Contents('T') with Contents('TNew')
+      typename TreeTy::iterator TI = T->begin(), TE = T->end();
+      if (!compareTreeWithSection(TNew, TI, TE))
+        continue;
+      if (TI != TE)
+        continue; // T has more contents than TNew.
+      // Trees did match!  Return 'T'.
+      if (TNew->refCount == 0)
+        TNew->destroy();
+      return T;
     }
-    while (false);
 
-    entry = TNew;
+    Entries.push_back(TNew);
     TNew->IsCanonicalized = true;
     return TNew;
   }
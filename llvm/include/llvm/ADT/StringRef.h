@@ -445,13 +445,7 @@ namespace llvm {
     /// @{
 
     /// Return the number of occurrences of \p C in the string.
-    [[nodiscard]] size_t count(char C) const {
-      size_t Count = 0;
-      for (size_t I = 0; I != Length; ++I)
-        if (Data[I] == C)
-          ++Count;
-      return Count;
-    }
+    [[nodiscard]] size_t count(char C) const;
 
     /// Return the number of non-overlapped occurrences of \p Str in
     /// the string.
@@ -659,6 +659,9 @@ public:
   MemoryEffects getMemoryEffects(const CallBase *Call) {
     return AA.getMemoryEffects(Call, AAQI);
   }
+  bool isNoAlias(const MemoryLocation &LocA, const MemoryLocation &LocB) {
+    return alias(LocA, LocB) == AliasResult::NoAlias;
+  }
   bool isMustAlias(const MemoryLocation &LocA, const MemoryLocation &LocB) {
     return alias(LocA, LocB) == AliasResult::MustAlias;
   }
@@ -962,6 +965,37 @@ private:
   }
 };
 
+/// An analysis that provides a BatchAAResults whose cache of alias queries is
+/// kept across passes.
+///
+/// The cached results refer to the values of the function, so they are
+/// invalidated by any pass that does not preserve this analysis, which
+/// includes every pass that changes the function, and with the AAManager
+/// results. Like any other BatchAAResults, the result must not be used while
+/// the function changes, and its query mode must not be changed.
+class AAQueryCacheAnalysis : public AnalysisInfoMixin<AAQueryCacheAnalysis> {
+  friend AnalysisInfoMixin<AAQueryCacheAnalysis>;
+
+  static AnalysisKey Key;
+
+public:
+  class Result {
+  public:
+    Result(AAResults &AA) : BatchAA(std::make_unique<BatchAAResults>(AA)) {}
+
+    BatchAAResults &getBatchAA() { return *BatchAA; }
+
+    bool invalidate(Function &F, const PreservedAnalyses &PA,
+                    FunctionAnalysisManager::Invalidator &Inv);
+
+  private:
+    // BatchAAResults refers to its own members, so it must not move.
+    std::unique_ptr<BatchAAResults> BatchAA;
+  };
+
+  Result run(Function &F, FunctionAnalysisManager &AM);
+};
+
 /// A wrapper pass to provide the legacy pass manager access to a suitably
 /// prepared AAResults object.
 class AAResultsWrapperPass : public FunctionPass {
@@ -129,6 +129,9 @@ enum : unsigned {
   INVALID_MEMORYACCESS_ID = -1U
 };
 
+using MemoryAccessPair = std::pair<MemoryAccess *, MemoryLocation>;
+using ConstMemoryAccessPair = std::pair<const MemoryAccess *, MemoryLocation>;
+
 template <class T> class memoryaccess_def_iterator_base;
 using memoryaccess_def_iterator = memoryaccess_def_iterator_base<MemoryAccess>;
 using const_memoryaccess_def_iterator =
@@ -700,7 +703,10 @@ DEFINE_TRANSPARENT_OPERAND_ACCESSORS(MemoryPhi, MemoryAccess)
 /// accesses.
 class MemorySSA {
 public:
-  MemorySSA(Function &, AliasAnalysis *, DominatorTree *);
+  /// If \p BatchAA is given, it answers the alias queries made while
+  /// building MemorySSA, and keeps their results for later queries.
+  MemorySSA(Function &, AliasAnalysis *, DominatorTree *,
+            BatchAAResults *BatchAA = nullptr);
   MemorySSA(Loop &, AliasAnalysis *, DominatorTree *);
 
   // MemorySSA must remain where it's constructed; Walkers it creates store
@@ -1069,6 +1075,19 @@ public:
                                                   const MemoryLocation &,
                                                   BatchAAResults &AA) = 0;
 
+  /// Answer getClobberingMemoryAccess(MemoryAccess *, const MemoryLocation &)
+  /// for every (starting access, location) pair in \p Queries, and put the
+  /// answer to Queries[I] into Results[I].
+  ///
+  /// All queries share \p AA, and the MemorySSA walkers also share the upward
+  /// walks of queries for the same location that pass through the same
+  /// accesses. This is much cheaper than separate queries when many of them
+  /// walk the same long def chains, e.g. in large straight-line code.
+  virtual void
+  getClobberingMemoryAccesses(ArrayRef<MemoryAccessPair> Queries,
+                              SmallVectorImpl<MemoryAccess *> &Results,
+                              BatchAAResults &AA);
+
   MemoryAccess *getClobberingMemoryAccess(const Instruction *I) {
     BatchAAResults BAA(MSSA->getAA());
     return getClobberingMemoryAccess(I, BAA);
@@ -1085,6 +1104,12 @@ public:
     return getClobberingMemoryAccess(MA, Loc, BAA);
   }
 
+  void getClobberingMemoryAccesses(ArrayRef<MemoryAccessPair> Queries,
+                                   SmallVectorImpl<MemoryAccess *> &Results) {
+    BatchAAResults BAA(MSSA->getAA());
+    getClobberingMemoryAccesses(Queries, Results, BAA);
+  }
+
   /// Given a memory access, invalidate anything this walker knows about
   /// that access.
   /// This API is used by walkers that store information to perform basic cache
@@ -1113,9 +1138,6 @@ public:
                                           BatchAAResults &) override;
 };
 
-using MemoryAccessPair = std::pair<MemoryAccess *, MemoryLocation>;
-using ConstMemoryAccessPair = std::pair<const MemoryAccess *, MemoryLocation>;
-
 /// Iterator base class used to implement const and non-const iterators
 /// over the defining accesses of a MemoryAccess.
 template <class T>
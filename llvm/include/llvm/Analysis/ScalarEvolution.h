@@ -69,12 +69,6 @@ extern bool VerifySCEV;
 /// opaque objects that the client is not allowed to do much with directly.
 ///
 class SCEV : public FoldingSetNode {
-  friend struct FoldingSetTrait<SCEV>;
-
-  /// A reference to an Interned FoldingSetNodeID for this node.  The
-  /// ScalarEvolution's BumpPtrAllocator holds the data.
-  FoldingSetNodeIDRef FastID;
-
   // The SCEV baseclass this node corresponds to
   const SCEVTypes SCEVType;
 
@@ -131,9 +125,8 @@ public:
     NoWrapMask = (1 << 3) - 1
   };
 
-  explicit SCEV(const FoldingSetNodeIDRef ID, SCEVTypes SCEVTy,
-                unsigned short ExpressionSize)
-      : FastID(ID), SCEVType(SCEVTy), ExpressionSize(ExpressionSize) {}
+  explicit SCEV(SCEVTypes SCEVTy, unsigned short ExpressionSize)
+      : SCEVType(SCEVTy), ExpressionSize(ExpressionSize) {}
   SCEV(const SCEV &) = delete;
   SCEV &operator=(const SCEV &) = delete;
 
@@ -145,6 +138,11 @@ public:
   /// Return operands of this SCEV expression.
   ArrayRef<const SCEV *> operands() const;
 
+  /// Add the key under which ScalarEvolution uniques this expression to
+  /// \p ID. The key is computed from the expression instead of being kept in
+  /// the node, which keeps the nodes small.
+  void Profile(FoldingSetNodeID &ID) const;
+
   /// Return true if the expression is a constant zero.
   bool isZero() const;
 
@@ -178,21 +176,6 @@ public:
   void dump() const;
 };
 
-// Specialize FoldingSetTrait for SCEV to avoid needing to compute
-// temporary FoldingSetNodeID values.
-template <> struct FoldingSetTrait<SCEV> : DefaultFoldingSetTrait<SCEV> {
-  static void Profile(const SCEV &X, FoldingSetNodeID &ID) { ID = X.FastID; }
-
-  static bool Equals(const SCEV &X, const FoldingSetNodeID &ID, unsigned IDHash,
-                     FoldingSetNodeID &TempID) {
-    return ID == X.FastID;
-  }
-
-  static unsigned ComputeHash(const SCEV &X, FoldingSetNodeID &TempID) {
-    return X.FastID.ComputeHash();
-  }
-};
-
 inline raw_ostream &operator<<(raw_ostream &OS, const SCEV &S) {
   S.print(OS);
   return OS;
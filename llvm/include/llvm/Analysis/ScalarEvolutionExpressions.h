@@ -62,8 +62,7 @@ class SCEVConstant : public SCEV {
 
   ConstantInt *V;
 
-  SCEVConstant(const FoldingSetNodeIDRef ID, ConstantInt *v)
-      : SCEV(ID, scConstant, 1), V(v) {}
+  SCEVConstant(ConstantInt *v) : SCEV(scConstant, 1), V(v) {}
 
 public:
   ConstantInt *getValue() const { return V; }
@@ -80,8 +79,7 @@ public:
 class SCEVVScale : public SCEV {
   friend class ScalarEvolution;
 
-  SCEVVScale(const FoldingSetNodeIDRef ID, Type *ty)
-      : SCEV(ID, scVScale, 0), Ty(ty) {}
+  SCEVVScale(Type *ty) : SCEV(scVScale, 0), Ty(ty) {}
 
   Type *Ty;
 
@@ -105,8 +103,7 @@ protected:
   const SCEV *Op;
   Type *Ty;
 
-  SCEVCastExpr(const FoldingSetNodeIDRef ID, SCEVTypes SCEVTy, const SCEV *op,
-               Type *ty);
+  SCEVCastExpr(SCEVTypes SCEVTy, const SCEV *op, Type *ty);
 
 public:
   const SCEV *getOperand() const { return Op; }
@@ -130,7 +127,7 @@ public:
 class SCEVPtrToIntExpr : public SCEVCastExpr {
   friend class ScalarEvolution;
 
-  SCEVPtrToIntExpr(const FoldingSetNodeIDRef ID, const SCEV *Op, Type *ITy);
+  SCEVPtrToIntExpr(const SCEV *Op, Type *ITy);
 
 public:
   /// Methods for support type inquiry through isa, cast, and dyn_cast:
@@ -140,8 +137,7 @@ public:
 /// This is the base class for unary integral cast operator classes.
 class SCEVIntegralCastExpr : public SCEVCastExpr {
 protected:
-  SCEVIntegralCastExpr(const FoldingSetNodeIDRef ID, SCEVTypes SCEVTy,
-                       const SCEV *op, Type *ty);
+  SCEVIntegralCastExpr(SCEVTypes SCEVTy, const SCEV *op, Type *ty);
 
 public:
   /// Methods for support type inquiry through isa, cast, and dyn_cast:
@@ -156,7 +152,7 @@ public:
 class SCEVTruncateExpr : public SCEVIntegralCastExpr {
   friend class ScalarEvolution;
 
-  SCEVTruncateExpr(const FoldingSetNodeIDRef ID, const SCEV *op, Type *ty);
+  SCEVTruncateExpr(const SCEV *op, Type *ty);
 
 public:
   /// Methods for support type inquiry through isa, cast, and dyn_cast:
@@ -168,7 +164,7 @@ public:
 class SCEVZeroExtendExpr : public SCEVIntegralCastExpr {
   friend class ScalarEvolution;
 
-  SCEVZeroExtendExpr(const FoldingSetNodeIDRef ID, const SCEV *op, Type *ty);
+  SCEVZeroExtendExpr(const SCEV *op, Type *ty);
 
 public:
   /// Methods for support type inquiry through isa, cast, and dyn_cast:
@@ -182,7 +178,7 @@ public:
 class SCEVSignExtendExpr : public SCEVIntegralCastExpr {
   friend class ScalarEvolution;
 
-  SCEVSignExtendExpr(const FoldingSetNodeIDRef ID, const SCEV *op, Type *ty);
+  SCEVSignExtendExpr(const SCEV *op, Type *ty);
 
 public:
   /// Methods for support type inquiry through isa, cast, and dyn_cast:
@@ -202,9 +198,8 @@ protected:
   const SCEV *const *Operands;
   size_t NumOperands;
 
-  SCEVNAryExpr(const FoldingSetNodeIDRef ID, enum SCEVTypes T,
-               const SCEV *const *O, size_t N)
-      : SCEV(ID, T, computeExpressionSize(ArrayRef(O, N))), Operands(O),
+  SCEVNAryExpr(enum SCEVTypes T, const SCEV *const *O, size_t N)
+      : SCEV(T, computeExpressionSize(ArrayRef(O, N))), Operands(O),
         NumOperands(N) {}
 
 public:
@@ -246,9 +241,8 @@ public:
 /// This node is the base class for n'ary commutative operators.
 class SCEVCommutativeExpr : public SCEVNAryExpr {
 protected:
-  SCEVCommutativeExpr(const FoldingSetNodeIDRef ID, enum SCEVTypes T,
-                      const SCEV *const *O, size_t N)
-      : SCEVNAryExpr(ID, T, O, N) {}
+  SCEVCommutativeExpr(enum SCEVTypes T, const SCEV *const *O, size_t N)
+      : SCEVNAryExpr(T, O, N) {}
 
 public:
   /// Methods for support type inquiry through isa, cast, and dyn_cast:
@@ -268,8 +262,8 @@ class SCEVAddExpr : public SCEVCommutativeExpr {
 
   Type *Ty;
 
-  SCEVAddExpr(const FoldingSetNodeIDRef ID, const SCEV *const *O, size_t N)
-      : SCEVCommutativeExpr(ID, scAddExpr, O, N) {
+  SCEVAddExpr(const SCEV *const *O, size_t N)
+      : SCEVCommutativeExpr(scAddExpr, O, N) {
     auto *FirstPointerTypedOp = find_if(operands(), [](const SCEV *Op) {
       return Op->getType()->isPointerTy();
     });
@@ -290,8 +284,8 @@ public:
 class SCEVMulExpr : public SCEVCommutativeExpr {
   friend class ScalarEvolution;
 
-  SCEVMulExpr(const FoldingSetNodeIDRef ID, const SCEV *const *O, size_t N)
-      : SCEVCommutativeExpr(ID, scMulExpr, O, N) {}
+  SCEVMulExpr(const SCEV *const *O, size_t N)
+      : SCEVCommutativeExpr(scMulExpr, O, N) {}
 
 public:
   Type *getType() const { return getOperand(0)->getType(); }
@@ -306,8 +300,8 @@ class SCEVUDivExpr : public SCEV {
 
   std::array<const SCEV *, 2> Operands;
 
-  SCEVUDivExpr(const FoldingSetNodeIDRef ID, const SCEV *lhs, const SCEV *rhs)
-      : SCEV(ID, scUDivExpr, computeExpressionSize({lhs, rhs})) {
+  SCEVUDivExpr(const SCEV *lhs, const SCEV *rhs)
+      : SCEV(scUDivExpr, computeExpressionSize({lhs, rhs})) {
     Operands[0] = lhs;
     Operands[1] = rhs;
   }
@@ -349,9 +343,8 @@ class SCEVAddRecExpr : public SCEVNAryExpr {
 
   const Loop *L;
 
-  SCEVAddRecExpr(const FoldingSetNodeIDRef ID, const SCEV *const *O, size_t N,
-                 const Loop *l)
-      : SCEVNAryExpr(ID, scAddRecExpr, O, N), L(l) {}
+  SCEVAddRecExpr(const SCEV *const *O, size_t N, const Loop *l)
+      : SCEVNAryExpr(scAddRecExpr, O, N), L(l) {}
 
 public:
   Type *getType() const { return getStart()->getType(); }
@@ -431,9 +424,8 @@ class SCEVMinMaxExpr : public SCEVCommutativeExpr {
 
 protected:
   /// Note: Constructing subclasses via this constructor is allowed
-  SCEVMinMaxExpr(const FoldingSetNodeIDRef ID, enum SCEVTypes T,
-                 const SCEV *const *O, size_t N)
-      : SCEVCommutativeExpr(ID, T, O, N) {
+  SCEVMinMaxExpr(enum SCEVTypes T, const SCEV *const *O, size_t N)
+      : SCEVCommutativeExpr(T, O, N) {
     assert(isMinMaxType(T));
     // Min and max never overflow
     setNoWrapFlags((NoWrapFlags)(FlagNUW | FlagNSW));
@@ -464,8 +456,8 @@ public:
 class SCEVSMaxExpr : public SCEVMinMaxExpr {
   friend class ScalarEvolution;
 
-  SCEVSMaxExpr(const FoldingSetNodeIDRef ID, const SCEV *const *O, size_t N)
-      : SCEVMinMaxExpr(ID, scSMaxExpr, O, N) {}
+  SCEVSMaxExpr(const SCEV *const *O, size_t N)
+      : SCEVMinMaxExpr(scSMaxExpr, O, N) {}
 
 public:
   /// Methods for support type inquiry through isa, cast, and dyn_cast:
@@ -476,8 +468,8 @@ public:
 class SCEVUMaxExpr : public SCEVMinMaxExpr {
   friend class ScalarEvolution;
 
-  SCEVUMaxExpr(const FoldingSetNodeIDRef ID, const SCEV *const *O, size_t N)
-      : SCEVMinMaxExpr(ID, scUMaxExpr, O, N) {}
+  SCEVUMaxExpr(const SCEV *const *O, size_t N)
+      : SCEVMinMaxExpr(scUMaxExpr, O, N) {}
 
 public:
   /// Methods for support type inquiry through isa, cast, and dyn_cast:
@@ -488,8 +480,8 @@ public:
 class SCEVSMinExpr : public SCEVMinMaxExpr {
   friend class ScalarEvolution;
 
-  SCEVSMinExpr(const FoldingSetNodeIDRef ID, const SCEV *const *O, size_t N)
-      : SCEVMinMaxExpr(ID, scSMinExpr, O, N) {}
+  SCEVSMinExpr(const SCEV *const *O, size_t N)
+      : SCEVMinMaxExpr(scSMinExpr, O, N) {}
 
 public:
   /// Methods for support type inquiry through isa, cast, and dyn_cast:
@@ -500,8 +492,8 @@ public:
 class SCEVUMinExpr : public SCEVMinMaxExpr {
   friend class ScalarEvolution;
 
-  SCEVUMinExpr(const FoldingSetNodeIDRef ID, const SCEV *const *O, size_t N)
-      : SCEVMinMaxExpr(ID, scUMinExpr, O, N) {}
+  SCEVUMinExpr(const SCEV *const *O, size_t N)
+      : SCEVMinMaxExpr(scUMinExpr, O, N) {}
 
 public:
   /// Methods for support type inquiry through isa, cast, and dyn_cast:
@@ -525,9 +517,8 @@ class SCEVSequentialMinMaxExpr : public SCEVNAryExpr {
 
 protected:
   /// Note: Constructing subclasses via this constructor is allowed
-  SCEVSequentialMinMaxExpr(const FoldingSetNodeIDRef ID, enum SCEVTypes T,
-                           const SCEV *const *O, size_t N)
-      : SCEVNAryExpr(ID, T, O, N) {
+  SCEVSequentialMinMaxExpr(enum SCEVTypes T, const SCEV *const *O, size_t N)
+      : SCEVNAryExpr(T, O, N) {
     assert(isSequentialMinMaxType(T));
     // Min and max never overflow
     setNoWrapFlags((NoWrapFlags)(FlagNUW | FlagNSW));
@@ -559,9 +550,8 @@ public:
 class SCEVSequentialUMinExpr : public SCEVSequentialMinMaxExpr {
   friend class ScalarEvolution;
 
-  SCEVSequentialUMinExpr(const FoldingSetNodeIDRef ID, const SCEV *const *O,
-                         size_t N)
-      : SCEVSequentialMinMaxExpr(ID, scSequentialUMinExpr, O, N) {}
+  SCEVSequentialUMinExpr(const SCEV *const *O, size_t N)
+      : SCEVSequentialMinMaxExpr(scSequentialUMinExpr, O, N) {}
 
 public:
   /// Methods for support type inquiry through isa, cast, and dyn_cast:
@@ -585,9 +575,8 @@ class SCEVUnknown final : public SCEV, private CallbackVH {
   /// instances owned by a ScalarEvolution.
   SCEVUnknown *Next;
 
-  SCEVUnknown(const FoldingSetNodeIDRef ID, Value *V, ScalarEvolution *se,
-              SCEVUnknown *next)
-      : SCEV(ID, scUnknown, 1), CallbackVH(V), SE(se), Next(next) {}
+  SCEVUnknown(Value *V, ScalarEvolution *se, SCEVUnknown *next)
+      : SCEV(scUnknown, 1), CallbackVH(V), SE(se), Next(next) {}
 
   // Implement CallbackVH.
   void deleted() override;
@@ -260,6 +260,17 @@ struct ParserCallbacks {
            BufPtr[3] == 0xde;
   }
 
+  /// isCompressedBitcode - Return true if the given bytes are the magic bytes
+  /// for a compressed bitcode container (see writeCompressedBitcode).
+  inline bool isCompressedBitcode(const unsigned char *BufPtr,
+                                  const unsigned char *BufEnd) {
+    return BufEnd - BufPtr >= 4 &&
+           BufPtr[0] == 'B' &&
+           BufPtr[1] == 'C' &&
+           BufPtr[2] == 'Z' &&
+           BufPtr[3] == 0x01;
+  }
+
   /// isBitcode - Return true if the given bytes are the magic bytes for
   /// LLVM IR bitcode, either with or without a wrapper.
   inline bool isBitcode(const unsigned char *BufPtr,
@@ -268,6 +279,12 @@ struct ParserCallbacks {
            isRawBitcode(BufPtr, BufEnd);
   }
 
+  /// Decompress the compressed bitcode container in \p Buffer. The returned
+  /// buffer holds the original bitcode file, which can then be read, lazily
+  /// or not, like any other.
+  Expected<std::unique_ptr<MemoryBuffer>>
+  decompressBitcode(MemoryBufferRef Buffer);
+
   /// SkipBitcodeWrapperHeader - Some systems wrap bc files with a special
   /// header for padding or other reasons.  The format of this header is:
   ///
@@ -17,6 +17,7 @@
 #include "llvm/IR/ModuleSummaryIndex.h"
 #include "llvm/MC/StringTableBuilder.h"
 #include "llvm/Support/Allocator.h"
+#include "llvm/Support/Compression.h"
 #include "llvm/Support/MemoryBufferRef.h"
 #include <map>
 #include <memory>
@@ -132,6 +133,20 @@ void WriteBitcodeToFile(const Module &M, raw_ostream &Out,
                         bool GenerateHash = false,
                         ModuleHash *ModHash = nullptr);
 
+/// Write \p Bitcode, the contents of a bitcode file, to \p Out as a compressed
+/// bitcode container. The container is laid out as follows, in little endian:
+///
+/// struct bcz_header {
+///   uint32_t Magic;            // 'B', 'C', 'Z', 0x01
+///   uint32_t Format;           // 0 for zlib, 1 for zstd
+///   uint64_t UncompressedSize; // Size of the bitcode file.
+/// };
+///
+/// followed by the compressed bitcode file. Readers recognize it with
+/// isCompressedBitcode and restore the bitcode file with decompressBitcode.
+void writeCompressedBitcode(StringRef Bitcode, compression::Params P,
+                            raw_ostream &Out);
+
 /// Write the specified thin link bitcode file (i.e., the minimized bitcode
 /// file) to the given raw output stream, where it will be written in a new
 /// bitcode block. The thin link bitcode file is used for thin link, and it
@@ -32,6 +32,15 @@ enum BitstreamWrapperHeader : unsigned {
   BWH_HeaderSize = 5 * 4
 };
 
+/// Offsets of the fields of the compressed bitcode container header. The
+/// uncompressed size is a 64-bit field.
+enum CompressedBitcodeHeader : unsigned {
+  CBH_MagicField = 0 * 4,
+  CBH_FormatField = 1 * 4,
+  CBH_SizeField = 2 * 4,
+  CBH_HeaderSize = 4 * 4
+};
+
 namespace bitc {
 enum StandardWidths {
   BlockIDWidth = 8,   // We use VBR-8 for block IDs.
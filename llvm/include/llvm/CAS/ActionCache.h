@@ -0,0 +1,55 @@
+//===- llvm/CAS/ActionCache.h - On-disk cache of action results -*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file declares ActionCache, which maps the ID of a computation to the
+/// ID of its result in an ObjectStore.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CAS_ACTIONCACHE_H
+#define LLVM_CAS_ACTIONCACHE_H
+
+#include "llvm/CAS/CASID.h"
+#include "llvm/CAS/OnDiskTrieHashMap.h"
+#include <memory>
+
+namespace llvm {
+namespace cas {
+
+/// A cache from action keys to results, shared by many processes.
+///
+/// A key is the CASID of an object that describes a computation completely,
+/// e.g. a compiler invocation and the IDs of its inputs, and the result is
+/// the CASID of its output. Actions are expected to be deterministic: once a
+/// result is recorded for a key it cannot change, and put() reports an error
+/// if a different result is recorded for the same key.
+class ActionCache {
+public:
+  /// Open the cache in \p Path, creating the directory if necessary.
+  static Expected<std::unique_ptr<ActionCache>>
+  open(const Twine &Path, uint64_t Capacity = DefaultCapacity);
+
+  static constexpr uint64_t DefaultCapacity = 1ULL << 30;
+
+  /// Return the result recorded for \p ActionKey, if any.
+  std::optional<CASID> get(const CASID &ActionKey) const;
+
+  /// Record \p Result as the result of \p ActionKey.
+  Error put(const CASID &ActionKey, const CASID &Result);
+
+private:
+  ActionCache(OnDiskTrieHashMap Cache) : Cache(std::move(Cache)) {}
+
+  OnDiskTrieHashMap Cache;
+};
+
+} // end namespace cas
+} // end namespace llvm
+
+#endif // LLVM_CAS_ACTIONCACHE_H
@@ -0,0 +1,78 @@
+//===- llvm/CAS/CASID.h - Content-addressed object IDs ----------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CAS_CASID_H
+#define LLVM_CAS_CASID_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/Hashing.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Error.h"
+#include <array>
+#include <cstring>
+#include <string>
+
+namespace llvm {
+
+class raw_ostream;
+
+namespace cas {
+
+/// The identity of an object in an ObjectStore: the BLAKE3 hash of its
+/// content and references.
+class CASID {
+public:
+  static constexpr size_t NumBytes = 32;
+  using HashT = std::array<uint8_t, NumBytes>;
+
+  CASID() : Hash() {}
+  explicit CASID(const HashT &Hash) : Hash(Hash) {}
+
+  /// Create an ID from \p Bytes, which must be NumBytes long.
+  static CASID create(ArrayRef<uint8_t> Bytes) {
+    assert(Bytes.size() == NumBytes && "wrong hash size");
+    CASID ID;
+    std::memcpy(ID.Hash.data(), Bytes.data(), NumBytes);
+    return ID;
+  }
+
+  /// Parse the hexadecimal form produced by toString().
+  static Expected<CASID> parse(StringRef Str);
+
+  ArrayRef<uint8_t> getHash() const { return Hash; }
+
+  /// Return the hash in hexadecimal.
+  std::string toString() const;
+  void print(raw_ostream &OS) const;
+
+  friend bool operator==(const CASID &LHS, const CASID &RHS) {
+    return LHS.Hash == RHS.Hash;
+  }
+  friend bool operator!=(const CASID &LHS, const CASID &RHS) {
+    return !(LHS == RHS);
+  }
+  friend hash_code hash_value(const CASID &ID) {
+    // The hash is already uniformly distributed.
+    uint64_t Prefix;
+    std::memcpy(&Prefix, ID.Hash.data(), sizeof(Prefix));
+    return hash_code(Prefix);
+  }
+
+private:
+  HashT Hash;
+};
+
+inline raw_ostream &operator<<(raw_ostream &OS, const CASID &ID) {
+  ID.print(OS);
+  return OS;
+}
+
+} // end namespace cas
+} // end namespace llvm
+
+#endif // LLVM_CAS_CASID_H
@@ -0,0 +1,102 @@
+//===- MappedFileRegionArena.h - Bump allocator in a file -------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file declares MappedFileRegionArena, a bump allocator over a file that
+/// several processes map at once.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CAS_MAPPEDFILEREGIONARENA_H
+#define LLVM_CAS_MAPPEDFILEREGIONARENA_H
+
+#include "llvm/ADT/STLFunctionalExtras.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/FileSystem.h"
+#include <algorithm>
+#include <atomic>
+
+namespace llvm {
+namespace cas {
+
+/// A shared, read-write mapping of a file with a bump allocator in it.
+///
+/// The file is created sparse with a fixed capacity and mapped in one piece,
+/// so addresses in the mapping stay valid, and allocations are offsets from
+/// the start of the file that are valid in every process. The allocator's
+/// state lives in a header at the start of the file, and allocation is a
+/// single atomic add, so any number of threads and processes may allocate
+/// concurrently. Memory is never freed.
+///
+/// New memory is zero-initialized. Data that other processes may read must be
+/// published through atomics, e.g. by OnDiskTrieHashMap.
+class MappedFileRegionArena {
+public:
+  /// Alignment of every allocation.
+  static constexpr uint64_t Alignment = 8;
+
+  /// Open the arena in \p Path, creating the file with \p Capacity bytes if it
+  /// does not exist. An existing file keeps its capacity. \p Magic identifies
+  /// the format of the file and is checked when it is opened again.
+  ///
+  /// \p NewFileConstructor initializes a new file. It runs while holding an
+  /// exclusive lock on the file, before any other process can use the arena,
+  /// and typically allocates the client's root data structure, whose offset it
+  /// records with setUserHeaderOffset().
+  static Expected<MappedFileRegionArena>
+  create(const Twine &Path, uint64_t Capacity, uint64_t Magic,
+         function_ref<Error(MappedFileRegionArena &)> NewFileConstructor);
+
+  MappedFileRegionArena(MappedFileRegionArena &&) = default;
+  MappedFileRegionArena &operator=(MappedFileRegionArena &&) = default;
+
+  /// Allocate \p Size bytes and return their offset.
+  Expected<uint64_t> allocateOffset(uint64_t Size);
+
+  char *data() const { return Region.data(); }
+  uint64_t capacity() const { return Region.size(); }
+  /// The number of bytes allocated, including the header.
+  uint64_t size() const {
+    // Failed allocations past the end still bump the size.
+    return std::min(getHeader().Size.load(std::memory_order_relaxed),
+                    capacity());
+  }
+  StringRef getPath() const { return Path; }
+
+  /// Return whether [\p Offset, \p Offset + \p Size) is allocated memory.
+  bool isValidRange(uint64_t Offset, uint64_t Size) const {
+    return Offset >= sizeof(Header) && Offset <= size() &&
+           Size <= size() - Offset;
+  }
+
+  /// The offset of the client's root data structure.
+  uint64_t getUserHeaderOffset() const { return getHeader().UserHeaderOffset; }
+  void setUserHeaderOffset(uint64_t Offset) {
+    getHeader().UserHeaderOffset = Offset;
+  }
+
+private:
+  struct Header {
+    uint64_t Magic;
+    uint64_t UserHeaderOffset;
+    std::atomic<uint64_t> Size;
+  };
+
+  MappedFileRegionArena(std::string Path, sys::fs::mapped_file_region Region)
+      : Path(std::move(Path)), Region(std::move(Region)) {}
+
+  Header &getHeader() const { return *reinterpret_cast<Header *>(data()); }
+
+  std::string Path;
+  sys::fs::mapped_file_region Region;
+};
+
+} // end namespace cas
+} // end namespace llvm
+
+#endif // LLVM_CAS_MAPPEDFILEREGIONARENA_H
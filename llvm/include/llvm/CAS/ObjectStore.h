@@ -0,0 +1,98 @@
+//===- llvm/CAS/ObjectStore.h - On-disk content-addressed store -*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file declares ObjectStore, a content-addressed object store on disk
+/// that can be shared by many processes, e.g. to deduplicate build artifacts
+/// such as object files.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CAS_OBJECTSTORE_H
+#define LLVM_CAS_OBJECTSTORE_H
+
+#include "llvm/CAS/CASID.h"
+#include "llvm/CAS/OnDiskTrieHashMap.h"
+#include <memory>
+
+namespace llvm {
+
+class MemoryBuffer;
+
+namespace cas {
+
+/// An object loaded from an ObjectStore. It refers to the memory of the store
+/// and is valid as long as the store is.
+class ObjectHandle {
+public:
+  /// The content of the object, which is followed by a null terminator.
+  StringRef getData() const { return Data; }
+
+  size_t getNumRefs() const { return NumRefs; }
+  CASID getRef(size_t I) const {
+    assert(I < NumRefs && "reference out of range");
+    return CASID::create(ArrayRef(Refs + I * CASID::NumBytes, CASID::NumBytes));
+  }
+
+  /// Return a buffer of the content that does not own its memory.
+  std::unique_ptr<MemoryBuffer> getMemoryBuffer(StringRef Name = "") const;
+
+private:
+  friend class ObjectStore;
+  ObjectHandle(StringRef Data, const uint8_t *Refs, size_t NumRefs)
+      : Data(Data), Refs(Refs), NumRefs(NumRefs) {}
+
+  StringRef Data;
+  const uint8_t *Refs;
+  size_t NumRefs;
+};
+
+/// A content-addressed store of immutable objects. An object is a blob of
+/// data and a list of references to other objects, and its ID is the hash of
+/// both, so storing the same object twice stores it once.
+///
+/// The store lives in a directory. Objects and the index of their IDs share a
+/// single file, which is mapped into memory, so loading an object copies
+/// nothing. Any number of threads and processes may store and load objects
+/// concurrently; objects become visible to the other processes as soon as
+/// store() returns.
+class ObjectStore {
+public:
+  /// Open the store in \p Path, creating the directory if necessary.
+  /// \p Capacity is the maximum size of the store's file if it is created; the
+  /// file is sparse, so only the space that is used takes up disk space.
+  static Expected<std::unique_ptr<ObjectStore>>
+  open(const Twine &Path, uint64_t Capacity = DefaultCapacity);
+
+  static constexpr uint64_t DefaultCapacity = 4ULL << 30;
+
+  /// Return the ID an object with \p Refs and \p Data would have.
+  static CASID computeID(ArrayRef<CASID> Refs, StringRef Data);
+
+  /// Store an object and return its ID.
+  Expected<CASID> store(ArrayRef<CASID> Refs, StringRef Data);
+  Expected<CASID> store(StringRef Data) { return store({}, Data); }
+
+  /// Load the object \p ID, or return std::nullopt if it is not in the store.
+  Expected<std::optional<ObjectHandle>> load(const CASID &ID) const;
+
+  bool contains(const CASID &ID) const;
+
+  /// The number of bytes used in the store's file.
+  uint64_t getStorageSize() const { return Index.getArena().size(); }
+
+private:
+  ObjectStore(OnDiskTrieHashMap Index) : Index(std::move(Index)) {}
+
+  OnDiskTrieHashMap Index;
+};
+
+} // end namespace cas
+} // end namespace llvm
+
+#endif // LLVM_CAS_OBJECTSTORE_H
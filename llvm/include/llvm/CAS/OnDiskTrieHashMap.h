@@ -0,0 +1,101 @@
+//===- OnDiskTrieHashMap.h - Lock-free hash trie in a file ------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file declares OnDiskTrieHashMap, a map from fixed-size hashes to
+/// fixed-size values, stored in a file that many processes share.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CAS_ONDISKTRIEHASHMAP_H
+#define LLVM_CAS_ONDISKTRIEHASHMAP_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/CAS/MappedFileRegionArena.h"
+#include <optional>
+
+namespace llvm {
+namespace cas {
+
+/// A hash trie in a MappedFileRegionArena.
+///
+/// Keys are hashes, which are assumed to be uniformly distributed. The root
+/// node has 2^RootBits slots indexed by the first bits of the hash, and
+/// subtries have 2^SubtrieBits slots indexed by the following bits. A slot is
+/// either empty, or points to a record (a hash followed by its value), or to
+/// a subtrie. When an insertion hits a slot holding a record with a different
+/// hash, the record is pushed down into a new subtrie.
+///
+/// Slots are only ever changed by compare-and-exchange, from empty to a
+/// record or from a record to a subtrie that contains it, so lookups and
+/// insertions never take locks, and a record never moves once published.
+/// Values are written before their record is published and are immutable
+/// afterwards. Many threads and processes may use the map concurrently.
+class OnDiskTrieHashMap {
+public:
+  /// Open or create the map in \p Path. \p HashSize and \p ValueSize are the
+  /// sizes in bytes of the keys and values; \p Capacity is the size of a new
+  /// file. Opening an existing file with different sizes is an error.
+  static Expected<OnDiskTrieHashMap> create(const Twine &Path, size_t HashSize,
+                                            size_t ValueSize,
+                                            uint64_t Capacity,
+                                            unsigned RootBits = 12,
+                                            unsigned SubtrieBits = 6);
+
+  /// A record of the map. Records are identified by their offset in the file,
+  /// which is the same in every process.
+  struct Record {
+    uint64_t Offset;
+    ArrayRef<uint8_t> Hash;
+    /// Writable only when constructing the record.
+    MutableArrayRef<char> Value;
+  };
+
+  /// Return the record of \p Hash, if it is in the map.
+  std::optional<Record> find(ArrayRef<uint8_t> Hash) const;
+
+  /// Return the record of \p Hash, inserting it if it is not in the map.
+  /// \p Construct is called at most once to initialize the value of a new
+  /// record, before the record is visible to others. The boolean is true if
+  /// the record was inserted.
+  Expected<std::pair<Record, bool>>
+  insertLazy(ArrayRef<uint8_t> Hash,
+             function_ref<void(MutableArrayRef<char> Value)> Construct);
+
+  /// Return the record at \p Offset, which was returned by find() or
+  /// insertLazy(), possibly in another process.
+  Expected<Record> getRecord(uint64_t Offset) const;
+
+  /// Return the underlying arena, which can be used to allocate data that the
+  /// values refer to.
+  MappedFileRegionArena &getArena() { return Arena; }
+  const MappedFileRegionArena &getArena() const { return Arena; }
+
+private:
+  struct TrieHeader;
+
+  OnDiskTrieHashMap(MappedFileRegionArena Arena);
+
+  const TrieHeader &getTrieHeader() const;
+  unsigned getNumBits(unsigned StartBit) const;
+  std::atomic<uint64_t> &getSlot(uint64_t Node, ArrayRef<uint8_t> Hash,
+                                 unsigned StartBit) const;
+  Record makeRecord(uint64_t Offset) const;
+  Error checkSlot(uint64_t Slot) const;
+
+  MappedFileRegionArena Arena;
+  size_t HashSize;
+  size_t ValueSize;
+  unsigned RootBits;
+  unsigned SubtrieBits;
+};
+
+} // end namespace cas
+} // end namespace llvm
+
+#endif // LLVM_CAS_ONDISKTRIEHASHMAP_H
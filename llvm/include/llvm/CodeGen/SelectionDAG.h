@@ -140,6 +140,31 @@ template<> struct FoldingSetTrait<SDVTListNode> : DefaultFoldingSetTrait<SDVTLis
   }
 };
 
+/// Specialize FoldingSetTrait for SDNode to compare the hash bits cached in
+/// the nodes of the CSE map before their profiles.
+template <> struct FoldingSetTrait<SDNode> : DefaultFoldingSetTrait<SDNode> {
+  static bool Equals(SDNode &X, const FoldingSetNodeID &ID, unsigned IDHash,
+                     FoldingSetNodeID &TempID) {
+    uint16_t Bits = SDNode::getCSEHashBits(IDHash);
+    if (X.CSEHashBits && X.CSEHashBits != Bits)
+      return false;
+    X.Profile(TempID);
+    if (TempID == ID) {
+      X.CSEHashBits = Bits;
+      return true;
+    }
+    X.CSEHashBits = SDNode::getCSEHashBits(TempID.ComputeHash());
+    return false;
+  }
+
+  static unsigned ComputeHash(SDNode &X, FoldingSetNodeID &TempID) {
+    X.Profile(TempID);
+    unsigned Hash = TempID.ComputeHash();
+    X.CSEHashBits = SDNode::getCSEHashBits(Hash);
+    return Hash;
+  }
+};
+
 template <> struct ilist_alloc_traits<SDNode> {
   static void deleteNode(SDNode *) {
     llvm_unreachable("ilist_traits<SDNode> shouldn't see a deleteNode call!");
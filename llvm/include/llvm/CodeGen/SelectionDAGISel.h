@@ -523,6 +523,11 @@ private:
   /// state machines that start with a OPC_SwitchOpcode node.
   std::vector<unsigned> OpcodeOffset;
 
+  /// OpcodeTypeOffset - For the opcodes whose case in the OpcodeOffset table
+  /// starts with a OPC_SwitchType node, the start of the case for each value
+  /// type, indexed by MVT::SimpleValueType, or zero if there is none.
+  std::vector<std::vector<unsigned>> OpcodeTypeOffset;
+
   void UpdateChains(SDNode *NodeToMatch, SDValue InputChain,
                     SmallVectorImpl<SDNode *> &ChainNodesMatched,
                     bool isMorphNodeTo);
@@ -624,14 +624,28 @@ public:
   /// Unique and persistent id per SDNode in the DAG. Used for debug printing.
   /// We do not place that under `#if LLVM_ENABLE_ABI_BREAKING_CHECKS`
   /// intentionally because it adds unneeded complexity without noticeable
-  /// benefits (see discussion with @thakis in D120714). Currently, there are
-  /// two padding bytes after this field.
+  /// benefits (see discussion with @thakis in D120714). The two bytes after
+  /// this field, which used to be padding, hold CSEHashBits.
   uint16_t PersistentId = 0xffff;
 
 private:
   friend class SelectionDAG;
   // TODO: unfriend HandleSDNode once we fix its operand handling.
   friend class HandleSDNode;
+  friend struct FoldingSetTrait<SDNode>;
+
+  /// The high bits of the hash of this node in the CSE map, or 0 if they are
+  /// not known yet. They let the CSE map reject most nodes in the bucket of a
+  /// lookup without computing their profile.
+  uint16_t CSEHashBits = 0;
+
+  /// Return the value of CSEHashBits for a node with hash \p Hash.
+  static uint16_t getCSEHashBits(unsigned Hash) {
+    // The bucket of a node is picked by the low bits of its hash, and so the
+    // nodes of a bucket only differ in the high ones.
+    uint16_t Bits = Hash >> 16;
+    return Bits ? Bits : 1;
+  }
 
   /// Unique id per SDNode in the DAG.
   int NodeId = -1;
@@ -4,6 +4,7 @@
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/MC/MCSection.h"
 #include "llvm/MC/MCStreamer.h"
+#include "llvm/Support/StringSaver.h"
 #include <cassert>
 
 namespace llvm {
@@ -33,6 +34,10 @@ class DWPStringPool {
   MCStreamer &Out;
   MCSection *Sec;
   DenseMap<const char *, uint32_t, CStrDenseMapInfo> Pool;
+  // The pool owns a copy of every unique string, so that the input files
+  // don't have to be kept in memory once they have been processed.
+  BumpPtrAllocator Alloc;
+  StringSaver Saver{Alloc};
   uint32_t Offset = 0;
 
 public:
@@ -41,14 +46,17 @@ public:
   uint32_t getOffset(const char *Str, unsigned Length) {
     assert(strlen(Str) + 1 == Length && "Ensure length hint is correct");
 
-    auto Pair = Pool.insert(std::make_pair(Str, Offset));
-    if (Pair.second) {
-      Out.switchSection(Sec);
-      Out.emitBytes(StringRef(Str, Length));
-      Offset += Length;
-    }
+    auto It = Pool.find(Str);
+    if (It != Pool.end())
+      return It->second;
 
-    return Pair.first->second;
+    StringRef Saved = Saver.save(StringRef(Str, Length - 1));
+    Pool.insert(std::make_pair(Saved.data(), Offset));
+    Out.switchSection(Sec);
+    Out.emitBytes(StringRef(Saved.data(), Length));
+    uint32_t StrOffset = Offset;
+    Offset += Length;
+    return StrOffset;
   }
 };
 } // namespace llvm
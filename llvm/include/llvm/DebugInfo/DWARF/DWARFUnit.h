@@ -22,11 +22,13 @@
 #include "llvm/DebugInfo/DWARF/DWARFLocationExpression.h"
 #include "llvm/DebugInfo/DWARF/DWARFUnitIndex.h"
 #include "llvm/Support/DataExtractor.h"
+#include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <utility>
 #include <vector>
@@ -242,6 +244,13 @@ class DWARFUnit {
   /// The compile unit debug information entry items.
   std::vector<DWARFDebugInfoEntry> DieArray;
 
+  /// How much of the unit DieArray holds. The DIEs are extracted under
+  /// ExtractDIEsMutex, so that threads can share a unit; checking whether they
+  /// are available takes no lock.
+  enum class DIEsExtracted : uint8_t { None, UnitDIE, All };
+  std::atomic<DIEsExtracted> ExtractedDIEs = DIEsExtracted::None;
+  std::mutex ExtractDIEsMutex;
+
   /// Map from range's start address to end address and corresponding DIE.
   /// IntervalMap does not support range removal, as a result, we use the
   /// std::map::upper_bound for address range lookup.
@@ -251,11 +260,15 @@ class DWARFUnit {
   /// to the end address and the corresponding DIE.
   std::map<uint64_t, std::pair<uint64_t, DWARFDie>> VariableDieMap;
   DenseSet<uint64_t> RootsParsedForVariables;
+  /// Guards AddrDieMap, VariableDieMap and RootsParsedForVariables, which are
+  /// built on the first lookup.
+  std::mutex AddrDieMapsMutex;
 
   using die_iterator_range =
       iterator_range<std::vector<DWARFDebugInfoEntry>::iterator>;
 
   std::shared_ptr<DWARFUnit> DWO;
+  std::mutex DWOMutex;
 
 protected:
   friend dwarf_linker::parallel::CompileUnit;
@@ -566,6 +579,11 @@ public:
 
   Error tryExtractDIEsIfNeeded(bool CUDieOnly);
 
+  /// clearDIEs - Clear parsed DIEs to keep memory usage low. No other thread
+  /// may be using the DIEs, and DWARFDie handles into the unit are invalidated.
+  /// The DIEs are extracted again when they are next accessed.
+  void clearDIEs(bool KeepCUDie);
+
 private:
   /// Size in bytes of the .debug_info data associated with this compile unit.
   size_t getDebugInfoSize() const {
@@ -574,16 +592,15 @@ private:
   }
 
   /// extractDIEsIfNeeded - Parses a compile unit and indexes its DIEs if it
-  /// hasn't already been done
+  /// hasn't already been done. Threads may call this concurrently. In a
+  /// thread-safe context, all DIEs are extracted even if only the unit DIE is
+  /// requested, since extracting the others later would move the unit DIE.
   void extractDIEsIfNeeded(bool CUDieOnly);
 
   /// extractDIEsToVector - Appends all parsed DIEs to a vector.
   void extractDIEsToVector(bool AppendCUDie, bool AppendNonCUDIEs,
                            std::vector<DWARFDebugInfoEntry> &DIEs) const;
 
-  /// clearDIEs - Clear parsed DIEs to keep memory usage low.
-  void clearDIEs(bool KeepCUDie);
-
   /// parseDWO - Parses .dwo file for current compile unit. Returns true if
   /// it was actually constructed.
   /// The \p AlternativeLocation specifies an alternative location to get
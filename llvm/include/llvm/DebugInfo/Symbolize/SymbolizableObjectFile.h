@@ -90,6 +90,16 @@ private:
     }
   };
   std::vector<SymbolDesc> Symbols;
+  // Indices into Symbols sorted by name, built on the first findSymbol call.
+  // Symbols with the same name stay in address order.
+  mutable std::vector<uint32_t> SymbolsByName;
+  // Address ranges of the non-virtual text sections, in section order.
+  struct TextSection {
+    uint64_t Addr;
+    uint64_t Size;
+    uint64_t Index;
+  };
+  std::vector<TextSection> TextSections;
   // (index, filename) pairs of ELF STT_FILE symbols.
   std::vector<std::pair<uint32_t, StringRef>> FileSymbols;
 
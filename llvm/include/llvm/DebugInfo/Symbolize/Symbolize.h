@@ -199,9 +199,16 @@ private:
   /// Update the LRU cache order when a binary is accessed.
   void recordAccess(CachedBinary &Bin);
 
+  /// DemangleName, memoized: tools symbolize addresses of the same functions
+  /// over and over, e.g. llvm-objdump for every instruction.
+  std::string demangleFunctionName(const std::string &Name,
+                                   const SymbolizableModule *Info);
+
   std::map<std::string, std::unique_ptr<SymbolizableModule>, std::less<>>
       Modules;
   StringMap<std::string> BuildIDPaths;
+  /// Contains the results of demangleFunctionName().
+  StringMap<std::string> DemangledFunctionNames;
 
   /// Contains cached results of getOrCreateObjectPair().
   std::map<std::pair<std::string, std::string>, ObjectPair>
@@ -34,6 +34,7 @@
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/TargetParser/SubtargetFeature.h"
 #include "llvm/TargetParser/Triple.h"
+#include <chrono>
 #include <optional>
 
 #include <map>
@@ -1987,6 +1988,38 @@ void visitExistingEdges(LinkGraph &G, VisitorTs &&...Vs) {
 Expected<std::unique_ptr<LinkGraph>>
 createLinkGraphFromObject(MemoryBufferRef ObjectBuffer);
 
+/// Cumulative time spent in phases of JITLink, summed over all the links (and
+/// threads) of the process since collection was enabled.
+struct LinkPhaseTimes {
+  /// Time spent building LinkGraphs from object buffers.
+  std::chrono::nanoseconds BuildGraph{0};
+  /// Time spent copying block content and applying fixups.
+  std::chrono::nanoseconds ApplyFixups{0};
+};
+
+/// Enable or disable the collection of LinkPhaseTimes. Collection is disabled
+/// by default.
+void setLinkPhaseTimesEnabled(bool Enabled);
+
+/// Returns the LinkPhaseTimes collected so far.
+LinkPhaseTimes getLinkPhaseTimes();
+
+/// Adds the time spent in a scope to one of the LinkPhaseTimes if collection
+/// is enabled.
+class LinkPhaseTimeRegion {
+public:
+  enum Phase { BuildGraph, ApplyFixups };
+
+  LinkPhaseTimeRegion(Phase P);
+  LinkPhaseTimeRegion(const LinkPhaseTimeRegion &) = delete;
+  LinkPhaseTimeRegion &operator=(const LinkPhaseTimeRegion &) = delete;
+  ~LinkPhaseTimeRegion();
+
+private:
+  Phase P;
+  std::optional<std::chrono::steady_clock::time_point> Start;
+};
+
 /// Create a \c LinkGraph defining the given absolute symbols.
 std::unique_ptr<LinkGraph> absoluteSymbolsLinkGraph(const Triple &TT,
                                                     orc::SymbolMap Symbols);
@@ -28,6 +28,7 @@
 #include "llvm/Support/ExtensibleRTTI.h"
 
 #include <atomic>
+#include <chrono>
 #include <deque>
 #include <future>
 #include <memory>
@@ -1491,9 +1492,29 @@ public:
   /// Will return null if no Platform has been set for this ExecutionSession.
   Platform *getPlatform() { return P.get(); }
 
+  /// Contention statistics for the session mutex.
+  struct SessionLockStats {
+    /// The number of times that runSessionLocked had to wait for another
+    /// thread to release the session mutex.
+    uint64_t ContendedAcquisitions = 0;
+    /// The total time spent waiting for the session mutex, summed over all
+    /// threads.
+    std::chrono::nanoseconds WaitTime{0};
+  };
+
+  /// Returns the contention statistics for the session mutex.
+  SessionLockStats getSessionLockStats() const {
+    SessionLockStats Stats;
+    Stats.ContendedAcquisitions = NumContendedSessionLocks.load();
+    Stats.WaitTime = std::chrono::nanoseconds(SessionLockWaitNanos.load());
+    return Stats;
+  }
+
   /// Run the given lambda with the session mutex locked.
   template <typename Func> decltype(auto) runSessionLocked(Func &&F) {
-    std::lock_guard<std::recursive_mutex> Lock(SessionMutex);
+    std::unique_lock<std::recursive_mutex> Lock(SessionMutex, std::try_to_lock);
+    if (!Lock.owns_lock())
+      lockSessionContended(Lock);
     return F();
   }
 
@@ -1853,7 +1874,12 @@ private:
   void dumpDispatchInfo(Task &T);
 #endif // NDEBUG
 
+  // Blocks on the session mutex, recording the wait in the lock statistics.
+  void lockSessionContended(std::unique_lock<std::recursive_mutex> &Lock);
+
   mutable std::recursive_mutex SessionMutex;
+  std::atomic<uint64_t> NumContendedSessionLocks{0};
+  std::atomic<int64_t> SessionLockWaitNanos{0};
   bool SessionOpen = true;
   std::unique_ptr<ExecutorProcessControl> EPC;
   std::unique_ptr<Platform> P;
@@ -14,6 +14,7 @@
 #define LLVM_EXECUTIONENGINE_ORC_LLJIT_H
 
 #include "llvm/ADT/SmallSet.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
 #include "llvm/ExecutionEngine/Orc/CompileOnDemandLayer.h"
 #include "llvm/ExecutionEngine/Orc/CompileUtils.h"
 #include "llvm/ExecutionEngine/Orc/ExecutionUtils.h"
@@ -21,6 +22,7 @@
 #include "llvm/ExecutionEngine/Orc/IRTransformLayer.h"
 #include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
 #include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
+#include "llvm/Support/CachePruning.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/ThreadPool.h"
 #include <variant>
@@ -222,6 +224,10 @@ public:
   /// Returns a reference to the IR compile layer.
   IRCompileLayer &getIRCompileLayer() { return *CompileLayer; }
 
+  /// Returns the object cache used by the IR compile layer, or null if none
+  /// was set up.
+  ObjectCache *getObjectCache() { return ObjCache.get(); }
+
   /// Returns a linker-mangled version of UnmangledName.
   std::string mangle(StringRef UnmangledName) const;
 
@@ -258,6 +264,7 @@ protected:
 
   std::unique_ptr<ObjectLayer> ObjLinkingLayer;
   std::unique_ptr<ObjectTransformLayer> ObjTransformLayer;
+  std::unique_ptr<ObjectCache> ObjCache;
   std::unique_ptr<IRCompileLayer> CompileLayer;
   std::unique_ptr<IRTransformLayer> TransformLayer;
   std::unique_ptr<IRTransformLayer> InitHelperTransformLayer;
@@ -326,6 +333,9 @@ public:
   NotifyCreatedFunction NotifyCreated;
   unsigned NumCompileThreads = 0;
   std::optional<bool> SupportConcurrentCompilation;
+  std::unique_ptr<ObjectCache> ObjCache;
+  std::string ObjectCacheDir;
+  CachePruningPolicy ObjectCachePruningPolicy;
 
   /// Called prior to JIT class construcion to fix up defaults.
   Error prepareForConstruction();
@@ -486,6 +496,31 @@ public:
     return impl();
   }
 
+  /// Set an ObjectCache for the default compile function to query before
+  /// compiling modules.
+  ///
+  /// This should not be called if a CompileFunctionCreator or an object cache
+  /// directory is set.
+  SetterImpl &setObjectCache(std::unique_ptr<ObjectCache> ObjCache) {
+    impl().ObjCache = std::move(ObjCache);
+    return impl();
+  }
+
+  /// Cache compiled objects in the given directory, across JIT instances and
+  /// processes, using a PersistentObjectCache. Objects are keyed by the IR of
+  /// the module and by the target machine configuration of the JIT, and the
+  /// directory is pruned according to Policy.
+  ///
+  /// This should not be called if a CompileFunctionCreator or an ObjectCache
+  /// is set.
+  SetterImpl &
+  setObjectCacheDirectory(std::string ObjectCacheDir,
+                          CachePruningPolicy Policy = CachePruningPolicy()) {
+    impl().ObjectCacheDir = std::move(ObjectCacheDir);
+    impl().ObjectCachePruningPolicy = std::move(Policy);
+    return impl();
+  }
+
   /// Create an instance of the JIT.
   Expected<std::unique_ptr<JITType>> create() {
     if (auto Err = impl().prepareForConstruction())
@@ -22,6 +22,24 @@ namespace orc {
 
 class MapperJITLinkMemoryManager : public jitlink::JITLinkMemoryManager {
 public:
+  /// Statistics about the address space reserved from the mapper. The
+  /// fragmentation of the reservations can be measured by comparing
+  /// LargestFreeRange with FreeBytes.
+  struct MemoryStats {
+    /// Bytes reserved from the mapper.
+    size_t ReservedBytes = 0;
+    /// Bytes of the reservations that are allocated, including the padding
+    /// of segments to page boundaries.
+    size_t AllocatedBytes = 0;
+    /// Bytes of the reservations that are available for allocation.
+    size_t FreeBytes = 0;
+    /// The number of disjoint ranges that FreeBytes is made of.
+    size_t NumFreeRanges = 0;
+    /// The size of the largest free range, i.e. of the largest allocation
+    /// that does not need a new reservation.
+    size_t LargestFreeRange = 0;
+  };
+
   MapperJITLinkMemoryManager(size_t ReservationGranularity,
                              std::unique_ptr<MemoryMapper> Mapper);
 
@@ -46,11 +64,33 @@ public:
   // synchronous overload
   using JITLinkMemoryManager::deallocate;
 
+  /// Returns the current statistics of the reserved address space.
+  MemoryStats getMemoryStats();
+
 private:
   class InFlightAlloc;
 
+  /// A deallocate call waiting to be sent to the mapper.
+  struct PendingDeallocation {
+    std::vector<FinalizedAlloc> Allocs;
+    OnDeallocatedFunction OnDeallocated;
+  };
+
+  /// Deinitialize all pending deallocations with a single mapper call.
+  void deinitializePendingDeallocations();
+
+  /// Release the memory of deinitialized allocations for reuse.
+  void reclaimMemory(std::vector<FinalizedAlloc> &Allocs);
+
   std::mutex Mutex;
 
+  // Deallocations requested while a deinitialize call is in flight are
+  // coalesced into the next call, saving a round trip to the executor for
+  // each of them.
+  std::mutex DeallocationsMutex;
+  std::vector<PendingDeallocation> PendingDeallocations;
+  bool DeinitializeInFlight = false;
+
   // We reserve multiples of this from the executor address space
   size_t ReservationUnits;
 
@@ -62,6 +102,9 @@ private:
   // Ranges that have been reserved in executor and already allocated
   DenseMap<ExecutorAddr, ExecutorAddrDiff> UsedMemory;
 
+  // Total size of the ranges reserved in executor
+  size_t ReservedBytes = 0;
+
   std::unique_ptr<MemoryMapper> Mapper;
 };
 
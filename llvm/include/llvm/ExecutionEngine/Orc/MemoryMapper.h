@@ -81,9 +81,12 @@ public:
 
 class InProcessMemoryMapper : public MemoryMapper {
 public:
-  InProcessMemoryMapper(size_t PageSize);
+  /// If UseHugePages is true then reservations are requested to be backed by
+  /// huge pages where the host supports it.
+  InProcessMemoryMapper(size_t PageSize, bool UseHugePages = false);
 
-  static Expected<std::unique_ptr<InProcessMemoryMapper>> Create();
+  static Expected<std::unique_ptr<InProcessMemoryMapper>>
+  Create(bool UseHugePages = false);
 
   unsigned int getPageSize() override { return PageSize; }
 
@@ -119,6 +122,62 @@ private:
   AllocationMap Allocations;
 
   size_t PageSize;
+  bool UseHugePages;
+};
+
+/// Maps each reservation in the current process twice, from the same shared
+/// memory: a read/write view that the content is written through, and a view
+/// at the executor addresses whose pages are only writable when their segment
+/// is. Code is therefore never mapped writable and executable at once, and
+/// writing the content of an allocation never requires changing protections.
+///
+/// Pages of the executor view keep their protections after deinitialization
+/// until they are initialized again, which halves the number of protection
+/// changes compared to InProcessMemoryMapper.
+class DualMappedMemoryMapper final : public MemoryMapper {
+public:
+  /// If UseHugePages is true then reservations are requested to be backed by
+  /// huge pages where the host supports it.
+  DualMappedMemoryMapper(size_t PageSize, bool UseHugePages = false);
+
+  static Expected<std::unique_ptr<DualMappedMemoryMapper>>
+  Create(bool UseHugePages = false);
+
+  unsigned int getPageSize() override { return PageSize; }
+
+  void reserve(size_t NumBytes, OnReservedFunction OnReserved) override;
+
+  char *prepare(ExecutorAddr Addr, size_t ContentSize) override;
+
+  void initialize(AllocInfo &AI, OnInitializedFunction OnInitialized) override;
+
+  void deinitialize(ArrayRef<ExecutorAddr> Allocations,
+                    OnDeinitializedFunction OnDeInitialized) override;
+
+  void release(ArrayRef<ExecutorAddr> Reservations,
+               OnReleasedFunction OnRelease) override;
+
+  ~DualMappedMemoryMapper() override;
+
+private:
+  struct Allocation {
+    std::vector<shared::WrapperFunctionCall> DeinitializationActions;
+  };
+  using AllocationMap = DenseMap<ExecutorAddr, Allocation>;
+
+  struct Reservation {
+    char *WorkingAddr;
+    size_t Size;
+    std::vector<ExecutorAddr> Allocations;
+  };
+
+  std::mutex Mutex;
+  std::map<ExecutorAddr, Reservation> Reservations;
+  AllocationMap Allocations;
+
+  size_t PageSize;
+  bool UseHugePages;
+  unsigned SharedMemoryCount = 0;
 };
 
 class SharedMemoryMapper final : public MemoryMapper {
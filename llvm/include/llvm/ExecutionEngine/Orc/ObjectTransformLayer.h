@@ -40,6 +40,9 @@ public:
     this->Transform = std::move(Transform);
   }
 
+  /// Returns the current transform, e.g. to wrap it in a new one.
+  const TransformFunction &getTransform() const { return Transform; }
+
 private:
   ObjectLayer &BaseLayer;
   TransformFunction Transform;
@@ -0,0 +1,91 @@
+//===- PersistentObjectCache.h - On-disk object cache for ORC ---*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// An ObjectCache that keeps compiled objects on disk across process restarts.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_EXECUTIONENGINE_ORC_PERSISTENTOBJECTCACHE_H
+#define LLVM_EXECUTIONENGINE_ORC_PERSISTENTOBJECTCACHE_H
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/Support/CachePruning.h"
+#include "llvm/Support/Caching.h"
+#include "llvm/Support/Error.h"
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace llvm {
+namespace orc {
+
+class JITTargetMachineBuilder;
+
+/// An ObjectCache that stores compiled objects in a directory.
+///
+/// Objects are keyed by a hash of the module's bitcode and of the target that
+/// it is compiled for (triple, CPU, features, optimization level, relocation
+/// and code models), so a cache directory can be shared between JITs built for
+/// different targets. Entries are committed atomically by renaming temporary
+/// files, which makes it safe for several processes to share a directory, and
+/// the directory is pruned according to a CachePruningPolicy in the same way
+/// as the ThinLTO cache.
+///
+/// Failures to read or write the cache are not reported: the module is simply
+/// compiled again.
+class PersistentObjectCache : public ObjectCache {
+public:
+  /// Create a cache in the given directory for objects compiled by target
+  /// machines that are built by JTMB. The directory is created on the first
+  /// write, and is pruned according to Policy on creation.
+  static Expected<std::unique_ptr<PersistentObjectCache>>
+  Create(StringRef CacheDir, const JITTargetMachineBuilder &JTMB,
+         CachePruningPolicy Policy = CachePruningPolicy());
+
+  /// Returns the string describing the target of JTMB that is included in
+  /// the cache keys.
+  static std::string getTargetKey(const JITTargetMachineBuilder &JTMB);
+
+  void notifyObjectCompiled(const Module *M, MemoryBufferRef Obj) override;
+  std::unique_ptr<MemoryBuffer> getObject(const Module *M) override;
+
+  /// Prune the cache directory according to the policy. Returns true if
+  /// pruning occurred.
+  bool prune();
+
+  /// Returns the statistics of this cache instance.
+  const FileCacheStats &getStats() const { return Stats; }
+
+  /// Returns the cache directory.
+  StringRef getCacheDir() const { return CacheDir; }
+
+private:
+  PersistentObjectCache(std::string CacheDir, std::string TargetKey,
+                        CachePruningPolicy Policy)
+      : CacheDir(std::move(CacheDir)), TargetKey(std::move(TargetKey)),
+        Policy(std::move(Policy)) {}
+
+  std::string getCacheKey(const Module &M) const;
+  std::string getEntryPath(StringRef Key) const;
+
+  std::string CacheDir;
+  std::string TargetKey;
+  CachePruningPolicy Policy;
+  FileCacheStats Stats;
+
+  /// Keys of the modules being compiled after a miss, so that they are only
+  /// computed once per module.
+  std::mutex PendingKeysMutex;
+  DenseMap<const Module *, std::string> PendingKeys;
+};
+
+} // end namespace orc
+} // end namespace llvm
+
+#endif // LLVM_EXECUTIONENGINE_ORC_PERSISTENTOBJECTCACHE_H
@@ -0,0 +1,125 @@
+//===- ProfileGuidedSpeculation.h - Profile-driven speculation --*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Speculative compilation for LLLazyJIT, driven by a profile of prior runs.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_EXECUTIONENGINE_ORC_PROFILEGUIDEDSPECULATION_H
+#define LLVM_EXECUTIONENGINE_ORC_PROFILEGUIDEDSPECULATION_H
+
+#include "llvm/ExecutionEngine/Orc/Core.h"
+#include "llvm/ExecutionEngine/Orc/Speculation.h"
+#include "llvm/Support/Error.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace llvm {
+namespace orc {
+
+class LLLazyJIT;
+
+/// Compiles the functions that a profile says are likely to be called before
+/// they are first called.
+///
+/// Functions are compiled in decreasing order of hotness through lookups of
+/// their bodies in the implementation dylibs of the CompileOnDemandLayer, and
+/// so they run on the session's TaskDispatcher. When a function is first
+/// called, its lazy call-through then only has to resolve an already compiled
+/// body.
+///
+/// Speculation stops once the JIT has emitted MemoryBudget bytes of objects,
+/// or when it is cancelled. Compiles that are already in flight finish.
+class ProfileGuidedSpeculator {
+public:
+  /// A function and its hotness, e.g. its number of calls in prior runs.
+  using ProfileEntry = std::pair<std::string, uint64_t>;
+
+  struct Config {
+    /// The number of object bytes emitted by the JIT after which no more
+    /// speculative compiles are started. Zero means no limit.
+    uint64_t MemoryBudget = 0;
+    /// The maximum number of speculative compiles in flight at once.
+    unsigned MaxInFlight = 4;
+  };
+
+  /// Create a speculator for J. This sets the ImplSymbolMap of J's
+  /// CompileOnDemandLayer, and wraps the transform of J's object transform
+  /// layer to count the emitted bytes.
+  static std::unique_ptr<ProfileGuidedSpeculator> Create(LLLazyJIT &J,
+                                                         Config C);
+
+  /// Read the hotness of functions from an indexed InstrProf profile. The
+  /// hotness of a function is the sum of its counters. Functions with local
+  /// linkage are skipped, since the JIT renames them.
+  static Expected<std::vector<ProfileEntry>>
+  readInstrProf(StringRef ProfilePath);
+
+  ProfileGuidedSpeculator(const ProfileGuidedSpeculator &) = delete;
+  ProfileGuidedSpeculator &operator=(const ProfileGuidedSpeculator &) = delete;
+
+  /// Cancel speculation and wait for the compiles in flight.
+  ~ProfileGuidedSpeculator();
+
+  /// Speculatively compile the functions of Profile (by IR name) that are
+  /// defined in JD, hottest first. Functions that have not been added to JD
+  /// are ignored.
+  void speculate(JITDylib &JD, ArrayRef<ProfileEntry> Profile);
+
+  /// Drop the speculative compiles that have not started yet.
+  void cancel();
+
+  /// Wait until no speculative compiles are queued or in flight.
+  void waitForCompletion();
+
+  /// Returns the number of functions that were speculatively compiled.
+  uint64_t getNumSpeculated() const { return NumSpeculated; }
+
+  /// Returns the number of object bytes emitted by the JIT.
+  uint64_t getEmittedBytes() const { return *EmittedBytes; }
+
+private:
+  struct PendingSpeculation {
+    JITDylib *JD;
+    SymbolStringPtr Name;
+  };
+
+  ProfileGuidedSpeculator(LLLazyJIT &J, Config C) : J(J), C(C) {}
+
+  /// Start queued compiles while the budget and MaxInFlight allow it.
+  void startQueued();
+  void compileBody(SymbolStringPtr Name);
+  void finished();
+
+  LLLazyJIT &J;
+  Config C;
+  ImplSymbolMap ImplMap;
+
+  std::mutex M;
+  std::condition_variable IdleCV;
+  std::deque<PendingSpeculation> Queue;
+  unsigned InFlight = 0;
+  bool Starting = false;
+
+  std::atomic<uint64_t> NumSpeculated{0};
+  // Shared with the object transform, which outlives the speculator.
+  std::shared_ptr<std::atomic<uint64_t>> EmittedBytes =
+      std::make_shared<std::atomic<uint64_t>>(0);
+};
+
+} // end namespace orc
+} // end namespace llvm
+
+#endif // LLVM_EXECUTIONENGINE_ORC_PROFILEGUIDEDSPECULATION_H
@@ -0,0 +1,97 @@
+//===- SessionSnapshot.h - Save and restore linked JIT code -----*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Snapshots of the LinkGraphs linked by an ObjectLinkingLayer, so that a later
+// process can link them again without compiling or parsing any objects.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_EXECUTIONENGINE_ORC_SESSIONSNAPSHOT_H
+#define LLVM_EXECUTIONENGINE_ORC_SESSIONSNAPSHOT_H
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ExecutionEngine/JITLink/JITLink.h"
+#include "llvm/ExecutionEngine/Orc/ObjectLinkingLayer.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/MemoryBufferRef.h"
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace llvm {
+namespace orc {
+
+/// Serialize G to OS. Fails if G uses edge kinds of an architecture that is
+/// not supported by snapshots, or if it has allocation actions.
+Error writeLinkGraph(jitlink::LinkGraph &G, raw_ostream &OS);
+
+/// Deserialize a LinkGraph written by writeLinkGraph. Data must hold exactly
+/// one graph.
+Expected<std::unique_ptr<jitlink::LinkGraph>>
+readLinkGraph(ArrayRef<uint8_t> Data);
+
+/// An ObjectLinkingLayer plugin that records the graphs linked by the layer,
+/// keyed by the JITDylib that they were linked into, and that can write them
+/// to a snapshot.
+///
+/// Graphs are recorded before any JIT linker pass runs, i.e. as they were
+/// parsed from their objects. Restoring a snapshot adds them back to an
+/// ObjectLinkingLayer: external symbols are looked up again and the JIT linker
+/// only has to lay out the graphs and apply their fixups, so the process does
+/// not have to compile or parse anything.
+///
+/// Graphs synthesized by ORC itself (e.g. platform headers), which by
+/// convention are named "<...>", are not recorded: the platform of the
+/// restoring process creates its own. Graphs of removed resources are dropped
+/// from the snapshot.
+class SessionSnapshotPlugin : public ObjectLinkingLayer::Plugin {
+public:
+  /// Returns the JITDylib to add the graphs of the named JITDylib to, or null
+  /// to skip them.
+  using GetJITDylibFunction = std::function<JITDylib *(StringRef JDName)>;
+
+  /// Write the graphs recorded so far to OS.
+  Error save(raw_ostream &OS);
+
+  /// Write the graphs recorded so far to the file at Path.
+  Error saveToFile(StringRef Path);
+
+  /// Add the graphs of Snapshot to L. If GetJD is empty then graphs are added
+  /// to the JITDylibs with the same names in L's session, and it is an error
+  /// for one not to exist.
+  static Error restore(ObjectLinkingLayer &L, MemoryBufferRef Snapshot,
+                       GetJITDylibFunction GetJD = GetJITDylibFunction());
+
+  /// Returns the number of graphs that are recorded.
+  size_t getNumRecordedGraphs();
+
+  void modifyPassConfig(MaterializationResponsibility &MR,
+                        jitlink::LinkGraph &G,
+                        jitlink::PassConfiguration &Config) override;
+  Error notifyEmitted(MaterializationResponsibility &MR) override;
+  Error notifyFailed(MaterializationResponsibility &MR) override;
+  Error notifyRemovingResources(JITDylib &JD, ResourceKey K) override;
+  void notifyTransferringResources(JITDylib &JD, ResourceKey DstKey,
+                                   ResourceKey SrcKey) override;
+
+private:
+  struct RecordedGraph {
+    std::string JDName;
+    std::string Data;
+  };
+
+  std::mutex M;
+  DenseMap<MaterializationResponsibility *, RecordedGraph> InFlightGraphs;
+  DenseMap<ResourceKey, std::vector<RecordedGraph>> Graphs;
+};
+
+} // end namespace orc
+} // end namespace llvm
+
+#endif // LLVM_EXECUTIONENGINE_ORC_SESSIONSNAPSHOT_H
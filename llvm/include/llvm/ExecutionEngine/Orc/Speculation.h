@@ -40,7 +40,6 @@ public:
   using ImapTy = DenseMap<Alias, AliaseeDetails>;
   void trackImpls(SymbolAliasMap ImplMaps, JITDylib *SrcJD);
 
-private:
   // FIX ME: find a right way to distinguish the pre-compile Symbols, and update
   // the callsite
   std::optional<AliaseeDetails> getImplFor(const SymbolStringPtr &StubSymbol) {
@@ -52,6 +51,7 @@ private:
       return std::nullopt;
   }
 
+private:
   std::mutex ConcurrentAccess;
   ImapTy Maps;
 };
@@ -22,10 +22,12 @@
 #include <string>
 
 #if LLVM_ENABLE_THREADS
+#include <atomic>
 #include <condition_variable>
 #include <deque>
 #include <mutex>
 #include <thread>
+#include <vector>
 #endif
 
 namespace llvm {
@@ -131,6 +133,53 @@ private:
   std::deque<std::unique_ptr<Task>> MaterializationTaskQueue;
 };
 
+/// Runs tasks on a fixed number of worker threads.
+///
+/// Each worker has its own queue. Tasks dispatched by a worker go to the front
+/// of its own queue, so tasks spawned by a task tend to run on the same thread
+/// while their data is still in cache. Idle workers steal from the back of the
+/// other queues. Tasks dispatched from other threads are spread round-robin
+/// over the workers.
+///
+/// Unlike DynamicThreadPoolTaskDispatcher, the number of threads is bounded.
+/// Tasks must therefore not block on the completion of other tasks: if every
+/// worker blocks, the dispatcher deadlocks.
+class WorkStealingTaskDispatcher : public TaskDispatcher {
+public:
+  WorkStealingTaskDispatcher(size_t NumThreads);
+  ~WorkStealingTaskDispatcher() override;
+  void dispatch(std::unique_ptr<Task> T) override;
+  void shutdown() override;
+
+  /// Returns the number of tasks that were run by a worker other than the
+  /// one whose queue they were dispatched to.
+  size_t getNumStolenTasks() const { return NumStolenTasks; }
+
+private:
+  struct WorkerQueue {
+    std::mutex M;
+    std::deque<std::unique_ptr<Task>> Tasks;
+  };
+
+  void runWorker(size_t Index);
+  std::unique_ptr<Task> takeTask(size_t Index);
+
+  std::vector<std::unique_ptr<WorkerQueue>> Queues;
+  std::vector<std::thread> Threads;
+
+  std::mutex StateMutex;
+  std::condition_variable WorkAvailableCV;
+  std::condition_variable OutstandingCV;
+  // Tasks in the queues that no worker has claimed yet.
+  size_t Unclaimed = 0;
+  // Tasks that have been dispatched but have not finished running.
+  size_t Outstanding = 0;
+  bool Stopping = false;
+
+  std::atomic<size_t> NextQueue{0};
+  std::atomic<size_t> NumStolenTasks{0};
+};
+
 #endif // LLVM_ENABLE_THREADS
 
 } // End namespace orc
@@ -0,0 +1,114 @@
+//===- TieredCompileLayer.h - Recompile hot functions -----------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// JIT layer that emits functions through a fast base layer first, counts their
+// calls, and recompiles the hot ones through an optimizing layer.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_EXECUTIONENGINE_ORC_TIEREDCOMPILELAYER_H
+#define LLVM_EXECUTIONENGINE_ORC_TIEREDCOMPILELAYER_H
+
+#include "llvm/ExecutionEngine/Orc/IndirectionUtils.h"
+#include "llvm/ExecutionEngine/Orc/Layer.h"
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace llvm {
+namespace orc {
+
+/// A layer that compiles modules in two tiers.
+///
+/// Modules are emitted through the base layer, which is expected to compile
+/// quickly (e.g. at -O0). Every externally visible function is called through
+/// an indirect stub, and its tier-0 body counts its calls. Once a function has
+/// been called HotCallThreshold times, a copy of its original IR is emitted
+/// through the hot layer (e.g. optimizing at -O3) on a task of the execution
+/// session, and its stub is updated to point at the new body.
+///
+/// Calls are only counted on function entry, and calls between functions of
+/// the same module also go through the stubs. The call counters call back into
+/// the JIT process, so the executor must be the JIT process itself.
+class TieredCompileLayer : public IRLayer {
+public:
+  /// Builder for IndirectStubsManagers.
+  using IndirectStubsManagerBuilder =
+      std::function<std::unique_ptr<IndirectStubsManager>()>;
+
+  /// Construct a TieredCompileLayer.
+  TieredCompileLayer(ExecutionSession &ES, IRLayer &BaseLayer,
+                     IRLayer &HotLayer,
+                     IndirectStubsManagerBuilder BuildIndirectStubsManager);
+
+  /// Sets the number of calls after which a function is recompiled.
+  void setHotCallThreshold(uint64_t Threshold) {
+    assert(Threshold && "Functions are hot after at least one call");
+    HotCallThreshold = Threshold;
+  }
+
+  /// Emits the given module. This should not be called by clients: it will be
+  /// called by the JIT when a definition added via the add method is requested.
+  void emit(std::unique_ptr<MaterializationResponsibility> R,
+            ThreadSafeModule TSM) override;
+
+private:
+  struct PerDylibResources {
+    PerDylibResources(JITDylib &ImplD,
+                      std::unique_ptr<IndirectStubsManager> ISMgr)
+        : ImplD(ImplD), ISMgr(std::move(ISMgr)) {}
+    JITDylib &ImplD;
+    std::unique_ptr<IndirectStubsManager> ISMgr;
+  };
+
+  /// A function whose calls are counted.
+  struct TieredFunction {
+    /// The dylib resources of the dylib that the function is defined in.
+    PerDylibResources *PDR;
+    /// A copy of the module defining the function, as it was before adding
+    /// the call counters.
+    std::shared_ptr<ThreadSafeModule> SourceModule;
+    /// The IR name of the function.
+    std::string Name;
+    /// The name of the stub of the function.
+    SymbolStringPtr StubName;
+    /// The name of the body of the function in the hot tier.
+    SymbolStringPtr HotName;
+  };
+
+  PerDylibResources &getPerDylibResources(JITDylib &TargetD);
+
+  /// Move the body of F to a new tier-0 function that counts its calls,
+  /// leaving F as a declaration that resolves to the stub.
+  Function &createTier0Body(Function &F, uint64_t Id);
+
+  /// Called by the tier-0 bodies once they are hot.
+  static void notifyHot(TieredCompileLayer *Layer, uint64_t Id);
+
+  /// Emit the hot tier of a function and point its stub at it.
+  void emitHotFunction(uint64_t Id);
+
+  mutable std::mutex TieredLayerMutex;
+
+  IRLayer &BaseLayer;
+  IRLayer &HotLayer;
+  IndirectStubsManagerBuilder BuildIndirectStubsManager;
+  std::map<const JITDylib *, PerDylibResources> DylibResources;
+  std::deque<TieredFunction> Functions;
+  SymbolLinkagePromoter PromoteSymbols;
+  uint64_t HotCallThreshold = 1000;
+};
+
+} // end namespace orc
+} // end namespace llvm
+
+#endif // LLVM_EXECUTIONENGINE_ORC_TIEREDCOMPILELAYER_H
@@ -15,6 +15,7 @@
 #define LLVM_IR_MODULE_H
 
 #include "llvm-c/Types.h"
+#include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
@@ -41,6 +42,7 @@
 
 namespace llvm {
 
+class ConstantArray;
 class Error;
 class FunctionType;
 class GVMaterializer;
@@ -881,6 +883,11 @@ public:
   /// be called where all uses of the LLVMContext are understood.
   void dropTriviallyDeadConstantArrays();
 
+  /// Like dropTriviallyDeadConstantArrays(), but only visits \p Candidates and
+  /// the ConstantArrays that become unused when those are destroyed, instead
+  /// of every ConstantArray in the LLVMContext.
+  void dropTriviallyDeadConstantArrays(ArrayRef<ConstantArray *> Candidates);
+
 /// @name Utility functions for printing and dumping Module objects
 /// @{
 
@@ -133,7 +133,10 @@ inline const char *getHotnessName(CalleeInfo::HotnessType HT) {
 
 class GlobalValueSummary;
 
-using GlobalValueSummaryList = std::vector<std::unique_ptr<GlobalValueSummary>>;
+/// Most GUIDs in a combined index have a single summary, so keep it inline
+/// rather than in a separate heap allocation per GUID.
+using GlobalValueSummaryList =
+    SmallVector<std::unique_ptr<GlobalValueSummary>, 1>;
 
 struct alignas(8) GlobalValueSummaryInfo {
   union NameOrGV {
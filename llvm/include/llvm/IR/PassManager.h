@@ -245,6 +245,58 @@ extern template class PassManager<Function>;
 /// Convenience typedef for a pass manager over functions.
 using FunctionPassManager = PassManager<Function>;
 
+/// Statistics on how the results cached by analysis managers are used.
+///
+/// Once attached to analysis managers with
+/// AnalysisManager::setInvalidationTracker(), this records for every analysis
+/// how often its result was computed, served from the cache, kept across a
+/// pass that did not preserve all analyses, and invalidated. A result that is
+/// computed again for an IR unit after being invalidated on it is counted as
+/// recomputed, and an invalidated result that was never served from the cache
+/// is counted as unused. Both point at passes that could have preserved the
+/// analysis by updating it. IR units are identified by address, so the counts
+/// are approximate when IR units are deleted and their memory reused.
+class AnalysisInvalidationTracker {
+public:
+  void recordComputed(AnalysisKey *ID, StringRef Name, const void *IR);
+  void recordCacheHit(AnalysisKey *ID, StringRef Name, const void *IR);
+  void recordPreserved(AnalysisKey *ID, StringRef Name, const void *IR);
+  void recordInvalidated(AnalysisKey *ID, StringRef Name, const void *IR);
+  /// Record that a result was deleted because its IR unit is going away.
+  void recordCleared(AnalysisKey *ID, const void *IR);
+
+  /// Print a table of the statistics, analyses with the most recomputations
+  /// first.
+  void print(raw_ostream &OS) const;
+
+  /// Forget everything recorded so far.
+  void reset();
+
+private:
+  struct AnalysisStats {
+    StringRef Name;
+    unsigned Computed = 0;
+    unsigned CacheHits = 0;
+    unsigned Preserved = 0;
+    unsigned Invalidated = 0;
+    unsigned Recomputed = 0;
+    unsigned Unused = 0;
+  };
+
+  struct ResultState {
+    unsigned CacheHits = 0;
+    bool IsLive = false;
+  };
+
+  AnalysisStats &getStats(AnalysisKey *ID, StringRef Name);
+
+  DenseMap<AnalysisKey *, AnalysisStats> Stats;
+
+  /// The state of every result computed so far, by analysis and IR unit.
+  /// Invalidated results stay in the map to detect recomputation.
+  DenseMap<std::pair<AnalysisKey *, const void *>, ResultState> Results;
+};
+
 /// A container for analyses that lazily runs them and caches their
 /// results.
 ///
@@ -394,10 +446,21 @@ public:
   /// IR units itself has potentially changed, and thus we can't even look up a
   /// a result and invalidate/clear it directly.
   void clear() {
+    // Callers clear everything in place of invalidating it, e.g. when an
+    // outer proxy is invalidated, so count that as invalidation.
+    if (LLVM_UNLIKELY(Tracker))
+      for (const auto &IDAndIR : AnalysisResults)
+        Tracker->recordInvalidated(IDAndIR.first.first,
+                                   lookUpPass(IDAndIR.first.first).name(),
+                                   IDAndIR.first.second);
     AnalysisResults.clear();
     AnalysisResultLists.clear();
   }
 
+  /// Record how cached results are used in \p T, or stop recording if \p T
+  /// is null. \p T must outlive this analysis manager or be detached first.
+  void setInvalidationTracker(AnalysisInvalidationTracker *T) { Tracker = T; }
+
   /// Get the result of an analysis pass for a given IR unit.
   ///
   /// Runs the analysis if a cached result is not available.
@@ -510,7 +573,11 @@ private:
   ResultConceptT *getCachedResultImpl(AnalysisKey *ID, IRUnitT &IR) const {
     typename AnalysisResultMapT::const_iterator RI =
         AnalysisResults.find({ID, &IR});
-    return RI == AnalysisResults.end() ? nullptr : &*RI->second->second;
+    if (RI == AnalysisResults.end())
+      return nullptr;
+    if (LLVM_UNLIKELY(Tracker))
+      Tracker->recordCacheHit(ID, lookUpPass(ID).name(), &IR);
+    return &*RI->second->second;
   }
 
   /// Map type from analysis pass ID to pass concept pointer.
@@ -529,6 +596,9 @@ private:
   /// Map from an analysis ID and IR unit to a particular cached
   /// analysis result.
   AnalysisResultMapT AnalysisResults;
+
+  /// Records how the cached results are used, if set.
+  AnalysisInvalidationTracker *Tracker = nullptr;
 };
 
 extern template class AnalysisManager<Module>;
@@ -125,8 +125,11 @@ AnalysisManager<IRUnitT, ExtraArgTs...>::clear(IRUnitT &IR,
   if (ResultsListI == AnalysisResultLists.end())
     return;
   // Delete the map entries that point into the results list.
-  for (auto &IDAndResult : ResultsListI->second)
+  for (auto &IDAndResult : ResultsListI->second) {
+    if (LLVM_UNLIKELY(Tracker))
+      Tracker->recordCleared(IDAndResult.first, &IR);
     AnalysisResults.erase({IDAndResult.first, &IR});
+  }
 
   // And actually destroy and erase the results associated with this IR.
   AnalysisResultLists.erase(ResultsListI);
@@ -163,6 +166,11 @@ AnalysisManager<IRUnitT, ExtraArgTs...>::getResultImpl(
     assert(RI != AnalysisResults.end() && "we just inserted it!");
 
     RI->second = std::prev(ResultList.end());
+
+    if (LLVM_UNLIKELY(Tracker))
+      Tracker->recordComputed(ID, P.name(), &IR);
+  } else if (LLVM_UNLIKELY(Tracker)) {
+    Tracker->recordCacheHit(ID, lookUpPass(ID).name(), &IR);
   }
 
   return *RI->second->second;
@@ -210,10 +218,14 @@ inline void AnalysisManager<IRUnitT, ExtraArgTs...>::invalidate(
     for (auto I = ResultsList.begin(), E = ResultsList.end(); I != E;) {
       AnalysisKey *ID = I->first;
       if (!IsResultInvalidated.lookup(ID)) {
+        if (LLVM_UNLIKELY(Tracker))
+          Tracker->recordPreserved(ID, this->lookUpPass(ID).name(), &IR);
         ++I;
         continue;
       }
 
+      if (LLVM_UNLIKELY(Tracker))
+        Tracker->recordInvalidated(ID, this->lookUpPass(ID).name(), &IR);
       if (auto *PI = getCachedResult<PassInstrumentationAnalysis>(IR))
         PI->runAnalysisInvalidated(this->lookUpPass(ID), IR);
 
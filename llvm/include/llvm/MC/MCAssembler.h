@@ -111,9 +111,14 @@ private:
   /// Check whether the given fragment needs relaxation.
   bool fragmentNeedsRelaxation(const MCRelaxableFragment *IF) const;
 
-  /// Perform one layout iteration and return true if any offsets
-  /// were adjusted.
-  bool layoutOnce();
+  /// Relax the first \p FirstStable sections, each until its own layout is
+  /// stable. \p Worklists holds the fragments of each section that may still
+  /// change; fragments that are fully relaxed are removed from it. Return the
+  /// number of leading sections that have to be relaxed again because a later
+  /// section changed after they were relaxed, which is 0 once all sections
+  /// are stable.
+  unsigned relaxOnce(unsigned FirstStable,
+                     MutableArrayRef<SmallVector<MCFragment *, 0>> Worklists);
 
   /// Perform relaxation on a single fragment - returns true if the fragment
   /// changes as a result of relaxation.
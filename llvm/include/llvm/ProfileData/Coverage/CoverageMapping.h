@@ -945,6 +945,16 @@ class CoverageMapping {
                bool &DataFound,
                SmallVectorImpl<object::BuildID> *FoundBinaryIDs = nullptr);
 
+  // Load coverage records from the readers of the file Filename, whose binary
+  // IDs are BinaryIDs.
+  static Error
+  loadFromFileReaders(StringRef Filename,
+                      ArrayRef<std::unique_ptr<CoverageMappingReader>> Readers,
+                      ArrayRef<object::BuildIDRef> BinaryIDs,
+                      IndexedInstrProfReader &ProfileReader,
+                      CoverageMapping &Coverage, bool &DataFound,
+                      SmallVectorImpl<object::BuildID> *FoundBinaryIDs);
+
   /// Add a function record corresponding to \p Record.
   Error loadFunctionRecord(const CoverageMappingRecord &Record,
                            IndexedInstrProfReader &ProfileReader);
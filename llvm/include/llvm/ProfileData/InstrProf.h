@@ -106,6 +106,10 @@ inline StringRef getInstrProfBitmapVarPrefix() { return "__profbm_"; }
 /// Return the name prefix of value profile variables.
 inline StringRef getInstrProfValuesVarPrefix() { return "__profvp_"; }
 
+/// Return the name prefix of the variables recording how many shards the
+/// counters of a function have.
+inline StringRef getInstrProfCounterShardsVarPrefix() { return "__profsh_"; }
+
 /// Return the name of value profile node array variables:
 inline StringRef getInstrProfVNodesVarName() { return "__llvm_prf_vnodes"; }
 
@@ -178,6 +182,11 @@ inline StringRef getInstrProfBitmapBiasVarName() {
   return INSTR_PROF_QUOTE(INSTR_PROF_PROFILE_BITMAP_BIAS_VAR);
 }
 
+/// Return the name of the ELF section holding the counter shard records.
+inline StringRef getInstrProfCounterShardsSectionName() {
+  return INSTR_PROF_QUOTE(INSTR_PROF_SHRD_COMMON);
+}
+
 /// Return the marker used to separate PGO names during serialization.
 inline StringRef getInstrProfNameSeparator() { return "\01"; }
 
@@ -718,6 +718,10 @@ private:
   StringRef VTableName;
   /// A memory buffer holding binary ids.
   ArrayRef<uint8_t> BinaryIdsBuffer;
+  /// A memory buffer holding the temporal profile traces, which are only
+  /// decoded once they are asked for. A compiler never needs them.
+  ArrayRef<uint8_t> TemporalProfTracesBuffer;
+  uint64_t NumTemporalProfTraces = 0;
 
   // Index to the current record in the record array.
   unsigned RecordIndex = 0;
@@ -786,6 +790,9 @@ public:
                      StringRef DeprecatedFuncName = "",
                      uint64_t *MismatchedFuncSum = nullptr);
 
+  SmallVector<TemporalProfTraceTy> &
+  getTemporalProfTraces(std::optional<uint64_t> Weight = {}) override;
+
   /// Return the memprof record for the function identified by
   /// llvm::md5(Name).
   Expected<memprof::MemProfRecord> getMemProfRecord(uint64_t FuncNameHash) {
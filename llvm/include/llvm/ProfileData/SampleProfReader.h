@@ -711,8 +711,11 @@ protected:
   std::vector<FunctionId> NameTable;
 
   /// CSNameTable is used to save full context vectors. It is the backing buffer
-  /// for SampleContextFrames.
-  std::vector<SampleContextFrameVector> CSNameTable;
+  /// for SampleContextFrames. The frames of the context with index I are
+  /// CSNameTable[CSNameTableOffsets[I], CSNameTableOffsets[I + 1]), so that
+  /// the contexts do not need an allocation each.
+  std::vector<SampleContextFrame> CSNameTable;
+  std::vector<size_t> CSNameTableOffsets;
 
   /// Table to cache MD5 values of sample contexts corresponding to
   /// readSampleContextFromTable(), used to index into Profiles or
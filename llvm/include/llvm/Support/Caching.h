@@ -16,6 +16,7 @@
 #define LLVM_SUPPORT_CACHING_H
 
 #include "llvm/Support/Error.h"
+#include <atomic>
 
 namespace llvm {
 
@@ -63,17 +64,32 @@ using FileCache = std::function<Expected<AddStreamFn>(
 using AddBufferFn = std::function<void(unsigned Task, const Twine &ModuleName,
                                        std::unique_ptr<MemoryBuffer> MB)>;
 
+/// Counters of the accesses to a file cache. They may be updated concurrently
+/// by the cache and its stream callbacks.
+struct FileCacheStats {
+  std::atomic<uint64_t> Hits{0};
+  std::atomic<uint64_t> Misses{0};
+  /// The number of bytes of the files added to the link on hits.
+  std::atomic<uint64_t> BytesRead{0};
+  /// The number of bytes of the files committed to the cache on misses.
+  std::atomic<uint64_t> BytesWritten{0};
+
+  void print(raw_ostream &OS) const;
+};
+
 /// Create a local file system cache which uses the given cache name, temporary
 /// file prefix, cache directory and file callback.  This function does not
 /// immediately create the cache directory if it does not yet exist; this is
 /// done lazily the first time a file is added.  The cache name appears in error
 /// messages for errors during caching. The temporary file prefix is used in the
-/// temporary file naming scheme used when writing files atomically.
+/// temporary file naming scheme used when writing files atomically. If \p Stats
+/// is given, it is updated on every access to the cache and must outlive it.
 Expected<FileCache> localCache(
     const Twine &CacheNameRef, const Twine &TempFilePrefixRef,
     const Twine &CacheDirectoryPathRef,
     AddBufferFn AddBuffer = [](size_t Task, const Twine &ModuleName,
-                               std::unique_ptr<MemoryBuffer> MB) {});
+                               std::unique_ptr<MemoryBuffer> MB) {},
+    FileCacheStats *Stats = nullptr);
 } // namespace llvm
 
 #endif
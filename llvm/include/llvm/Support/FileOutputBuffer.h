@@ -76,6 +76,12 @@ public:
   /// but keeps the memory mapping alive.
   virtual void discard() {}
 
+  /// Hints that the bytes in [Offset, Offset + Size) are final, so they may be
+  /// written to the file now instead of at commit(). The range may still be
+  /// modified afterwards. This is a no-op unless the buffer is a mapped file
+  /// on a platform that can start write-back of a file range early.
+  virtual void flushRange(size_t Offset, size_t Size) {}
+
 protected:
   FileOutputBuffer(StringRef Path) : FinalPath(Path) {}
 
@@ -0,0 +1,151 @@
+//===- llvm/Support/HotPathTrace.h - Low-overhead event tracing -*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This provides tracing cheap enough to put inside inner loops, such as the
+// per-instruction visit of InstCombine, where TimeTraceScope would dominate
+// the work being measured.
+//
+// Events are recorded with macros:
+//
+// \code
+//   {
+//     LLVM_HOT_PATH_TRACE_SCOPE("my_event_name", I.getOpcode());
+//     ...my code...
+//   }
+//   LLVM_HOT_PATH_TRACE_INSTANT("my_instant_event", N);
+// \endcode
+//
+// Event names must be string literals or otherwise outlive the tracing
+// session; they are stored as pointers. Each event carries one integer
+// argument.
+//
+// Every thread writes fixed-size records into its own ring buffer, without
+// locks or allocation. When a buffer is full the oldest records are
+// overwritten, so the trace always holds the most recent events of every
+// thread, like a flight recorder.
+//
+// The macros compile to nothing unless LLVM_ENABLE_HOT_PATH_TRACE is defined
+// to 1, e.g. by configuring with -DLLVM_ENABLE_HOT_PATH_TRACE=ON. When they
+// are compiled in, tracing is off until hotPathTraceEnable() is called, and
+// the cost of a disabled event is a single load and branch.
+//
+// hotPathTraceWrite() exports the records as JSON in Chrome "Trace Event"
+// format, which can be loaded into http://ui.perfetto.dev or chrome://tracing.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_SUPPORT_HOTPATHTRACE_H
+#define LLVM_SUPPORT_HOTPATHTRACE_H
+
+#include "llvm/Support/Compiler.h"
+#include "llvm/Support/Error.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#ifndef LLVM_ENABLE_HOT_PATH_TRACE
+#define LLVM_ENABLE_HOT_PATH_TRACE 0
+#endif
+
+namespace llvm {
+
+class raw_ostream;
+
+/// A traced event. Instant events have End == Begin.
+struct HotPathTraceRecord {
+  const char *Name;
+  uint64_t Arg;
+  /// Nanoseconds since the steady clock's epoch.
+  uint64_t Begin;
+  uint64_t End;
+};
+
+namespace detail {
+extern std::atomic<bool> HotPathTraceIsEnabled;
+void hotPathTraceAppend(const char *Name, uint64_t Arg, uint64_t Begin,
+                        uint64_t End);
+} // namespace detail
+
+/// Start recording events. Threads that have not recorded an event yet get a
+/// ring buffer of \p RecordsPerThread records, rounded up to a power of two.
+void hotPathTraceEnable(size_t RecordsPerThread = 64 * 1024);
+
+/// Stop recording events. Records are kept until hotPathTraceClear().
+void hotPathTraceDisable();
+
+/// Is the hot path tracer recording events?
+inline bool hotPathTraceEnabled() {
+  return detail::HotPathTraceIsEnabled.load(std::memory_order_relaxed);
+}
+
+/// Discard all records. Must not run concurrently with traced code.
+void hotPathTraceClear();
+
+/// Write the records of all threads to \p OS as JSON, in Chrome "Trace Event"
+/// format. Must not run concurrently with traced code.
+void hotPathTraceWrite(raw_ostream &OS, StringRef ProcName = "");
+
+/// Write the records of all threads to the file \p FileName.
+Error hotPathTraceWrite(StringRef FileName, StringRef ProcName = "");
+
+/// Return the current time in the unit of HotPathTraceRecord.
+inline uint64_t hotPathTraceNow() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/// Records an event for the lifetime of the object, if tracing was enabled
+/// when it was constructed. Use LLVM_HOT_PATH_TRACE_SCOPE rather than this
+/// class so that the event disappears when tracing is compiled out.
+class HotPathTraceScope {
+public:
+  HotPathTraceScope(const char *Name, uint64_t Arg) : Name(Name), Arg(Arg) {
+    if (LLVM_UNLIKELY(hotPathTraceEnabled()))
+      Begin = hotPathTraceNow();
+  }
+  HotPathTraceScope(const HotPathTraceScope &) = delete;
+  HotPathTraceScope &operator=(const HotPathTraceScope &) = delete;
+  ~HotPathTraceScope() {
+    if (LLVM_UNLIKELY(Begin))
+      detail::hotPathTraceAppend(Name, Arg, Begin, hotPathTraceNow());
+  }
+
+private:
+  const char *Name;
+  uint64_t Arg;
+  uint64_t Begin = 0;
+};
+
+} // end namespace llvm
+
+#if LLVM_ENABLE_HOT_PATH_TRACE
+#define LLVM_HOT_PATH_TRACE_CONCAT_IMPL(A, B) A##B
+#define LLVM_HOT_PATH_TRACE_CONCAT(A, B) LLVM_HOT_PATH_TRACE_CONCAT_IMPL(A, B)
+/// Record an event from here to the end of the enclosing scope.
+#define LLVM_HOT_PATH_TRACE_SCOPE(NAME, ARG)                                   \
+  ::llvm::HotPathTraceScope LLVM_HOT_PATH_TRACE_CONCAT(HotPathTraceScope_,     \
+                                                       __LINE__)(              \
+      NAME, static_cast<uint64_t>(ARG))
+/// Record an event without duration.
+#define LLVM_HOT_PATH_TRACE_INSTANT(NAME, ARG)                                 \
+  do {                                                                         \
+    if (LLVM_UNLIKELY(::llvm::hotPathTraceEnabled())) {                        \
+      uint64_t HotPathTraceTime = ::llvm::hotPathTraceNow();                   \
+      ::llvm::detail::hotPathTraceAppend(NAME, static_cast<uint64_t>(ARG),     \
+                                         HotPathTraceTime, HotPathTraceTime);  \
+    }                                                                          \
+  } while (false)
+#else
+#define LLVM_HOT_PATH_TRACE_SCOPE(NAME, ARG)
+#define LLVM_HOT_PATH_TRACE_INSTANT(NAME, ARG)                                 \
+  do {                                                                         \
+  } while (false)
+#endif
+
+#endif // LLVM_SUPPORT_HOTPATHTRACE_H
@@ -15,6 +15,7 @@
 
 #include "llvm-c/Types.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/Support/Alignment.h"
@@ -99,6 +100,14 @@ public:
           bool RequiresNullTerminator = true, bool IsVolatile = false,
           std::optional<Align> Alignment = std::nullopt);
 
+  /// Open the specified files concurrently, as if by calling getFile() on
+  /// each of them. This hides the latency of opening and reading many files,
+  /// e.g. on a networked filesystem. The results are in the order of
+  /// \p Filenames.
+  static SmallVector<ErrorOr<std::unique_ptr<MemoryBuffer>>, 0>
+  getFiles(ArrayRef<StringRef> Filenames, bool IsText = false,
+           bool RequiresNullTerminator = true, bool IsVolatile = false);
+
   /// Read all of the specified file into a MemoryBuffer as a stream
   /// (i.e. until EOF reached). This is useful for special files that
   /// look like a regular file but have 0 size (e.g. /proc/cpuinfo on Linux).
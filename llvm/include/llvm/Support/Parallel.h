@@ -29,6 +29,11 @@ namespace parallel {
 // initialized before the first use of parallel routines.
 extern ThreadPoolStrategy strategy;
 
+// If true, a task spawned by a thread that has a time trace profiler is
+// recorded as a "Parallel task" section in the time trace of the worker thread
+// that runs it. Defaults to false.
+extern bool traceTasks;
+
 #if LLVM_ENABLE_THREADS
 #define GET_THREAD_INDEX_IMPL                                                  \
   if (parallel::strategy.ThreadsRequested == 1)                                \
@@ -83,9 +88,22 @@ public:
     std::unique_lock<std::mutex> lock(Mutex);
     Cond.wait(lock, [&] { return Count == 0; });
   }
+
+  bool isDone() const {
+    std::lock_guard<std::mutex> lock(Mutex);
+    return Count == 0;
+  }
 };
 } // namespace detail
 
+// Scheduling hint for TaskGroup::spawn().
+enum class TaskPriority {
+  Normal,
+  // The task is on the critical path. It is started before any other queued
+  // task that is not high priority.
+  High,
+};
+
 class TaskGroup {
   detail::Latch L;
   bool Parallel;
@@ -95,11 +113,12 @@ public:
   ~TaskGroup();
 
   // Spawn a task, but does not wait for it to finish.
-  // Tasks marked with \p Sequential will be executed
-  // exactly in the order which they were spawned.
-  void spawn(std::function<void()> f);
+  void spawn(std::function<void()> f,
+             TaskPriority Priority = TaskPriority::Normal);
 
-  void sync() const { L.sync(); }
+  // Wait for all spawned tasks to finish. When called on a worker thread, the
+  // worker runs the queued tasks of this group while it waits.
+  void sync() const;
 
   bool isParallel() const { return Parallel; }
 };
@@ -0,0 +1,236 @@
+//===- SlabPoolAllocator.h - Size-class pool allocator ----------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+/// \file
+///
+/// This file defines SlabPoolAllocator, a thread-safe allocator for small
+/// objects that are frequently created and destroyed, such as operand and use
+/// lists. Unlike BumpPtrAllocator, freed memory is reused.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_SUPPORT_SLABPOOLALLOCATOR_H
+#define LLVM_SUPPORT_SLABPOOLALLOCATOR_H
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/AllocatorBase.h"
+#include "llvm/Support/Compiler.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace llvm {
+
+/// A snapshot of the memory held by a SlabPoolAllocator.
+struct SlabPoolStats {
+  /// Number and total size of the slabs allocated from the system.
+  size_t NumSlabs = 0;
+  size_t SlabBytes = 0;
+  /// Bytes of blocks handed out and not yet deallocated, rounded up to their
+  /// size class.
+  size_t InUseBytes = 0;
+  /// Bytes of deallocated blocks waiting for reuse, in the shared free lists
+  /// and in the caches of the threads.
+  size_t FreeBytes = 0;
+  /// Number and total size of the allocations too large or too aligned for a
+  /// size class, which are forwarded to the system allocator.
+  size_t NumLargeAllocations = 0;
+  size_t LargeBytes = 0;
+
+  /// Slab bytes that are not in use, i.e. free blocks and slab space that has
+  /// not been carved into blocks yet.
+  size_t getWastedBytes() const { return SlabBytes - InUseBytes; }
+};
+
+/// Receives the events of a SlabPoolAllocator, e.g. to measure fragmentation
+/// over time. Callbacks are invoked while the allocator's lock is held and must
+/// not call back into the allocator. They run on the slow paths only; the
+/// allocations and deallocations served by a thread cache are not reported.
+class SlabPoolListener {
+public:
+  virtual ~SlabPoolListener();
+
+  /// A slab of \p Size bytes was allocated from the system.
+  virtual void slabAllocated(size_t Size) {}
+  /// A large allocation of \p Size bytes was forwarded to the system.
+  virtual void largeAllocated(size_t Size) {}
+  /// A large allocation of \p Size bytes was released.
+  virtual void largeDeallocated(size_t Size) {}
+  /// All memory is about to be released, by Reset() or by the destructor.
+  /// \p Stats describes the memory held at this point.
+  virtual void released(const SlabPoolStats &Stats) {}
+};
+
+/// A pool allocator with one free list per size class.
+///
+/// Requests of up to MaxPooledSize bytes with an alignment of at most
+/// BlockAlign are rounded up to a multiple of BlockAlign and served from
+/// slabs. Each thread keeps a cache of free blocks per size class, so most
+/// Allocate() and Deallocate() calls do not take a lock; batches of blocks
+/// move between the thread caches and the shared free lists under a lock.
+/// Larger requests go to the system allocator.
+///
+/// Allocate() and Deallocate() may be called concurrently from any thread,
+/// and a block may be deallocated by a different thread than the one that
+/// allocated it. Reset() and the destructor release all memory at once, which
+/// makes object destruction unnecessary for trivially destructible objects;
+/// they must not run concurrently with other uses. Blocks cached by a thread
+/// that has exited are only reclaimed by Reset().
+class SlabPoolAllocator : public AllocatorBase<SlabPoolAllocator> {
+public:
+  static constexpr size_t BlockAlign = 16;
+  static constexpr size_t MaxBlockSize = 1024;
+
+  /// \p SlabSize is the size of the slabs allocated from the system and
+  /// \p MaxPooledSize the size above which requests bypass the pools. It is
+  /// rounded up to a multiple of BlockAlign and must not exceed MaxBlockSize.
+  explicit SlabPoolAllocator(size_t SlabSize = 64 * 1024,
+                             size_t MaxPooledSize = 512);
+  SlabPoolAllocator(const SlabPoolAllocator &) = delete;
+  SlabPoolAllocator &operator=(const SlabPoolAllocator &) = delete;
+  ~SlabPoolAllocator();
+
+  /// Allocate \a Size bytes of \a Alignment aligned memory.
+  LLVM_ATTRIBUTE_RETURNS_NONNULL void *Allocate(size_t Size,
+                                                size_t Alignment) {
+    if (LLVM_UNLIKELY(!isPooled(Size, Alignment)))
+      return allocateLarge(Size, Alignment);
+    unsigned Class = getSizeClass(Size);
+    ThreadCache &Cache = getThreadCache();
+    if (FreeBlock *Block = Cache.Heads[Class]) {
+      Cache.Heads[Class] = Block->Next;
+      Cache.addCount(Class, -1);
+      return Block;
+    }
+    return refill(Cache, Class);
+  }
+
+  // Pull in base class overloads.
+  using AllocatorBase<SlabPoolAllocator>::Allocate;
+
+  /// Deallocate \a Ptr to \a Size bytes of memory allocated by this
+  /// allocator.
+  void Deallocate(const void *Ptr, size_t Size, size_t Alignment) {
+    if (LLVM_UNLIKELY(!isPooled(Size, Alignment)))
+      return deallocateLarge(Ptr);
+    unsigned Class = getSizeClass(Size);
+    ThreadCache &Cache = getThreadCache();
+    auto *Block = static_cast<FreeBlock *>(const_cast<void *>(Ptr));
+    Block->Next = Cache.Heads[Class];
+    Cache.Heads[Class] = Block;
+    if (LLVM_UNLIKELY(Cache.addCount(Class, 1) > 2 * getBatchSize(Class)))
+      flush(Cache, Class);
+  }
+
+  // Pull in base class overloads.
+  using AllocatorBase<SlabPoolAllocator>::Deallocate;
+
+  /// Release all memory, including the blocks that were not deallocated.
+  void Reset();
+
+  /// Return the memory currently held by the allocator. The result is only
+  /// exact if no other thread is using the allocator.
+  SlabPoolStats getStats() const;
+
+  /// Set the listener notified of allocator events, or nullptr for none. Must
+  /// not be called concurrently with other uses of the allocator.
+  void setListener(SlabPoolListener *L) { Listener = L; }
+
+  /// Return the total memory allocated from the system.
+  size_t getTotalMemory() const;
+
+  void PrintStats() const;
+
+private:
+  static constexpr unsigned MaxSizeClasses = MaxBlockSize / BlockAlign;
+
+  struct FreeBlock {
+    FreeBlock *Next;
+  };
+
+  struct ThreadCache {
+    std::thread::id Owner;
+    FreeBlock *Heads[MaxSizeClasses] = {};
+    // Only written by the owning thread. Atomic so that getStats() can read
+    // them from another thread.
+    std::atomic<unsigned> Counts[MaxSizeClasses] = {};
+
+    unsigned addCount(unsigned Class, int Delta) {
+      unsigned Count = Counts[Class].load(std::memory_order_relaxed) + Delta;
+      Counts[Class].store(Count, std::memory_order_relaxed);
+      return Count;
+    }
+  };
+
+  // The cache of the allocator a thread used last. Allocators are identified
+  // by a unique ID rather than by address so that a new allocator at the
+  // address of a destroyed one does not pick up its cache. A thread that
+  // alternates between allocators looks up its cache under the lock. Zero
+  // initialized as a thread_local, and IDs start at 1.
+  struct LastCache {
+    uint64_t AllocatorID;
+    ThreadCache *Cache;
+  };
+  static inline thread_local LastCache Last;
+
+  bool isPooled(size_t Size, size_t Alignment) const {
+    return Size <= MaxPooledSize && Alignment <= BlockAlign;
+  }
+  static unsigned getSizeClass(size_t Size) {
+    return Size == 0 ? 0 : (Size - 1) / BlockAlign;
+  }
+  static size_t getBlockSize(unsigned Class) {
+    return (Class + 1) * BlockAlign;
+  }
+  // The number of blocks moved between a thread cache and the shared free
+  // lists at once: up to 4 KiB, but at least 4 blocks.
+  static unsigned getBatchSize(unsigned Class) {
+    return std::max<unsigned>(4096 / getBlockSize(Class), 4);
+  }
+
+  ThreadCache &getThreadCache() {
+    if (LLVM_LIKELY(Last.AllocatorID == ID))
+      return *Last.Cache;
+    return getThreadCacheSlow();
+  }
+
+  ThreadCache &getThreadCacheSlow();
+  void *refill(ThreadCache &Cache, unsigned Class);
+  void flush(ThreadCache &Cache, unsigned Class);
+  void *allocateLarge(size_t Size, size_t Alignment);
+  void deallocateLarge(const void *Ptr);
+  void releaseAll();
+
+  const uint64_t ID;
+  const size_t SlabSize;
+  const size_t MaxPooledSize;
+  SlabPoolListener *Listener = nullptr;
+
+  /// Protects everything below.
+  mutable std::mutex Mutex;
+  SmallVector<std::unique_ptr<ThreadCache>, 4> Caches;
+  SmallVector<void *, 16> Slabs;
+  char *CurPtr = nullptr;
+  char *End = nullptr;
+  FreeBlock *SharedHeads[MaxSizeClasses] = {};
+  size_t SharedCounts[MaxSizeClasses] = {};
+  /// The number of blocks carved from slabs per size class.
+  size_t NumCarved[MaxSizeClasses] = {};
+  /// Large allocations with their size and alignment, released by Reset().
+  DenseMap<void *, std::pair<size_t, size_t>> LargeAllocations;
+  size_t LargeBytes = 0;
+};
+
+} // end namespace llvm
+
+#endif // LLVM_SUPPORT_SLABPOOLALLOCATOR_H
@@ -0,0 +1,109 @@
+//===- llvm/Support/SuffixArray.h - Array for substrings --------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+// A compact alternative to SuffixTree for finding repeated substrings.
+//
+// A suffix array holds the start indices of the suffixes of a string in
+// lexicographic order. Together with the longest common prefix (LCP) of each
+// pair of neighboring suffixes, it describes the internal nodes of the suffix
+// tree implicitly: every internal node corresponds to an LCP interval, a range
+// of neighboring suffixes that share a prefix longer than that of the suffixes
+// around the range.
+//
+// The array takes two unsigned integers per element of the string, whereas a
+// SuffixTree allocates a node, and a child map for every internal node, per
+// element. The repeated substrings it finds are those a SuffixTree finds with
+// leaf descendants, though in a different order.
+//
+// The suffix array is constructed by prefix doubling with radix sorting in
+// O(N log N) time, and the LCPs with Kasai's algorithm in O(N) time.
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_SUPPORT_SUFFIXARRAY_H
+#define LLVM_SUPPORT_SUFFIXARRAY_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/SuffixTree.h"
+#include <utility>
+#include <vector>
+
+namespace llvm {
+class SuffixArray {
+public:
+  /// A repeated substring in the array.
+  using RepeatedSubstring = SuffixTree::RepeatedSubstring;
+
+private:
+  /// The start indices of the suffixes of the string in lexicographic order.
+  std::vector<unsigned> Suffixes;
+
+  /// The length of the longest common prefix of Suffixes[I - 1] and
+  /// Suffixes[I] at index I, and 0 at index 0.
+  std::vector<unsigned> LCPs;
+
+public:
+  /// Construct a suffix array from a sequence of unsigned integers.
+  SuffixArray(ArrayRef<unsigned> Str);
+
+  ArrayRef<unsigned> getSuffixes() const { return Suffixes; }
+  ArrayRef<unsigned> getLCPs() const { return LCPs; }
+
+  /// Iterator for finding all repeated substrings in the suffix array.
+  struct RepeatedSubstringIterator {
+  private:
+    /// The suffix array we're iterating over, or null for the end iterator.
+    const SuffixArray *SA = nullptr;
+    /// The repeated substring associated with the current LCP interval.
+    RepeatedSubstring RS;
+    /// The LCP and first index of the LCP intervals that contain the
+    /// current index.
+    SmallVector<std::pair<unsigned, unsigned>> Intervals;
+    /// The next index of the suffix array to visit.
+    unsigned Idx = 1;
+    /// The first index of the next LCP interval to open.
+    unsigned FirstIdx = 0;
+    /// The minimum length of a repeated substring to find.
+    /// Since we're outlining, we want at least two instructions in the range.
+    const unsigned MinLength = 2;
+
+    /// Move the iterator to the next repeated substring.
+    void advance();
+
+  public:
+    /// Return the current repeated substring.
+    RepeatedSubstring &operator*() { return RS; }
+
+    RepeatedSubstringIterator &operator++() {
+      advance();
+      return *this;
+    }
+
+    bool operator==(const RepeatedSubstringIterator &Other) const {
+      return SA == Other.SA && Idx == Other.Idx &&
+             Intervals.size() == Other.Intervals.size();
+    }
+    bool operator!=(const RepeatedSubstringIterator &Other) const {
+      return !(*this == Other);
+    }
+
+    RepeatedSubstringIterator(const SuffixArray *SA) : SA(SA) {
+      if (!SA)
+        return;
+      Intervals.push_back({0, 0});
+      advance();
+    }
+  };
+
+  typedef RepeatedSubstringIterator iterator;
+  iterator begin() const { return iterator(this); }
+  iterator end() const { return iterator(nullptr); }
+};
+
+} // namespace llvm
+
+#endif // LLVM_SUPPORT_SUFFIXARRAY_H
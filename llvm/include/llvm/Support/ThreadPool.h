@@ -52,6 +52,13 @@ class ThreadPoolInterface {
   virtual void asyncEnqueue(std::function<void()> Task,
                             ThreadPoolTaskGroup *Group) = 0;
 
+  /// Enqueue a task that should preferably run on NUMA node \p Node. The
+  /// default implementation ignores the hint.
+  virtual void asyncEnqueueOnNode(std::function<void()> Task,
+                                  ThreadPoolTaskGroup *Group, unsigned Node) {
+    asyncEnqueue(std::move(Task), Group);
+  }
+
 public:
   /// Destroying the pool will drain the pending tasks and wait. The current
   /// thread may participate in the execution of the pending tasks.
@@ -104,14 +111,37 @@ public:
                      &Group);
   }
 
+  /// Asynchronous submission of a task that should preferably run on a worker
+  /// pinned to NUMA node \p Node, see ThreadPoolStrategy::PinToNUMANode, so
+  /// that the memory it allocates stays local to the data it starts from. The
+  /// hint is ignored if workers are not pinned; otherwise the task may still
+  /// run on another node rather than leaving a thread idle.
+  template <typename Func>
+  auto asyncOnNode(unsigned Node, Func &&F)
+      -> std::shared_future<decltype(F())> {
+    return asyncImpl(std::function<decltype(F())()>(std::forward<Func>(F)),
+                     nullptr, Node);
+  }
+
+  template <typename Func>
+  auto asyncOnNode(ThreadPoolTaskGroup &Group, unsigned Node, Func &&F)
+      -> std::shared_future<decltype(F())> {
+    return asyncImpl(std::function<decltype(F())()>(std::forward<Func>(F)),
+                     &Group, Node);
+  }
+
 private:
   /// Asynchronous submission of a task to the pool. The returned future can be
   /// used to wait for the task to finish and is *non-blocking* on destruction.
   template <typename ResTy>
-  std::shared_future<ResTy> asyncImpl(std::function<ResTy()> Task,
-                                      ThreadPoolTaskGroup *Group) {
+  std::shared_future<ResTy>
+  asyncImpl(std::function<ResTy()> Task, ThreadPoolTaskGroup *Group,
+            std::optional<unsigned> Node = std::nullopt) {
     auto Future = std::async(std::launch::deferred, std::move(Task)).share();
-    asyncEnqueue([Future]() { Future.wait(); }, Group);
+    if (Node)
+      asyncEnqueueOnNode([Future]() { Future.wait(); }, Group, *Node);
+    else
+      asyncEnqueue([Future]() { Future.wait(); }, Group);
     return Future;
   }
 };
@@ -164,6 +194,22 @@ private:
   /// used to wait for the task to finish and is *non-blocking* on destruction.
   void asyncEnqueue(std::function<void()> Task,
                     ThreadPoolTaskGroup *Group) override {
+    enqueue({std::move(Task), Group, std::nullopt});
+  }
+
+  void asyncEnqueueOnNode(std::function<void()> Task,
+                          ThreadPoolTaskGroup *Group, unsigned Node) override {
+    enqueue({std::move(Task), Group, Node});
+  }
+
+  struct QueuedTask {
+    std::function<void()> Fn;
+    ThreadPoolTaskGroup *Group;
+    /// The NUMA node the task prefers to run on, if any.
+    std::optional<unsigned> Node;
+  };
+
+  void enqueue(QueuedTask Task) {
     int requestedThreads;
     {
       // Lock the queue and push the new task
@@ -171,7 +217,7 @@ private:
 
       // Don't allow enqueueing after disabling the pool
       assert(EnableFlag && "Queuing a thread during ThreadPool destruction");
-      Tasks.emplace_back(std::make_pair(std::move(Task), Group));
+      Tasks.push_back(std::move(Task));
       requestedThreads = ActiveThreads + Tasks.size();
     }
     QueueCondition.notify_one();
@@ -190,7 +236,7 @@ private:
   mutable llvm::sys::RWMutex ThreadsLock;
 
   /// Tasks waiting for execution in the pool.
-  std::deque<std::pair<std::function<void()>, ThreadPoolTaskGroup *>> Tasks;
+  std::deque<QueuedTask> Tasks;
 
   /// Locking and signaling for accessing the Tasks queue.
   std::mutex QueueLock;
@@ -277,6 +323,11 @@ public:
                       std::forward<Args>(ArgList)...);
   }
 
+  /// Calls ThreadPool::asyncOnNode() for this group.
+  template <typename Func> inline auto asyncOnNode(unsigned Node, Func &&F) {
+    return Pool.asyncOnNode(*this, Node, std::forward<Func>(F));
+  }
+
   /// Calls ThreadPool::wait() for this group.
   void wait() { Pool.wait(*this); }
 
@@ -129,6 +129,12 @@ constexpr bool llvm_is_multithreaded() { return LLVM_ENABLE_THREADS; }
     // threads, or hardware cores.
     bool Limit = false;
 
+    // If set, apply_thread_strategy() pins each thread to the CPUs of one NUMA
+    // node, distributing the threads round-robin over the nodes. Memory first
+    // touched by a thread is then allocated on its own node. Only implemented
+    // on Linux; ignored on single-node systems.
+    bool PinToNUMANode = false;
+
     /// Retrieves the max available threads for the current strategy. This
     /// accounts for affinity masks and takes advantage of all CPU sockets.
     unsigned compute_thread_count() const;
@@ -142,6 +148,10 @@ constexpr bool llvm_is_multithreaded() { return LLVM_ENABLE_THREADS; }
     /// Finds the CPU socket where a thread should go. Returns 'std::nullopt' if
     /// the thread shall remain on the actual CPU socket.
     std::optional<unsigned> compute_cpu_socket(unsigned ThreadPoolNum) const;
+
+    /// Finds the NUMA node \p ThreadPoolNum is pinned to when PinToNUMANode is
+    /// set. Returns 'std::nullopt' if the thread is not pinned to a node.
+    std::optional<unsigned> compute_numa_node(unsigned ThreadPoolNum) const;
   };
 
   /// Build a strategy from a number of threads as a string provided in \p Num.
@@ -149,6 +159,8 @@ constexpr bool llvm_is_multithreaded() { return LLVM_ENABLE_THREADS; }
   /// strategy, we attempt to equally allocate the threads on all CPU sockets.
   /// "0" or an empty string will return the \p Default strategy.
   /// "all" for using all hardware threads.
+  /// Any of the above may be followed by ":numa" to set PinToNUMANode, e.g.
+  /// "all:numa" or "16:numa".
   std::optional<ThreadPoolStrategy>
   get_threadpool_strategy(StringRef Num, ThreadPoolStrategy Default = {});
 
@@ -229,7 +241,8 @@ constexpr bool llvm_is_multithreaded() { return LLVM_ENABLE_THREADS; }
   /// cross CPU sockets boundaries.
   llvm::BitVector get_thread_affinity_mask();
 
-  /// Returns how many physical CPUs or NUMA groups the system has.
+  /// Returns how many physical CPUs or NUMA groups the system has. On Linux,
+  /// this is the number of NUMA nodes with CPUs in the process affinity mask.
   unsigned get_cpus();
 
   /// Returns how many physical cores (as opposed to logical cores returned from
@@ -106,6 +106,11 @@ void timeTraceProfilerInitialize(unsigned TimeTraceGranularity,
                                  StringRef ProcName,
                                  bool TimeTraceVerbose = false);
 
+/// Initialize the time trace profiler of a worker thread with the settings of
+/// \p Parent, the profiler of the thread that handed work to it. The worker
+/// should call timeTraceProfilerFinishThread() when the work is done.
+void timeTraceProfilerInitialize(TimeTraceProfiler *Parent);
+
 /// Cleanup the time trace profiler, if it was initialized.
 void timeTraceProfilerCleanup();
 
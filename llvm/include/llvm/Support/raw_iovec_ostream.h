@@ -0,0 +1,86 @@
+//===- raw_iovec_ostream.h - Scatter-gather file output stream --*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+//  This file defines the raw_iovec_ostream class.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_SUPPORT_RAW_IOVEC_OSTREAM_H
+#define LLVM_SUPPORT_RAW_IOVEC_OSTREAM_H
+
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/raw_ostream.h"
+#include <memory>
+
+namespace llvm {
+
+/// A raw_ostream that collects the written data as a list of fragments and
+/// writes them to a raw_fd_ostream with raw_fd_ostream::write_vectored.
+///
+/// Data passed to writeStable() is referenced rather than copied; it must stay
+/// alive and unchanged until the next flushPending(). This lets clients that
+/// already hold their output in memory, such as the fragments of an object
+/// file, write it without copying it into a stream buffer. Everything else is
+/// copied into storage owned by this stream, as with any raw_ostream.
+///
+/// Pending fragments are written by flushPending(), by pwrite(), by the
+/// destructor and whenever too many of them accumulate.
+class raw_iovec_ostream : public raw_pwrite_stream {
+  raw_fd_ostream &OS;
+
+  /// The fragments not written to OS yet.
+  SmallVector<StringRef, 0> Pending;
+  uint64_t PendingBytes = 0;
+
+  /// Storage for the copied data. Chunks are reused after a flush; copies
+  /// larger than a chunk are freed.
+  SmallVector<std::unique_ptr<char[]>, 0> Chunks;
+  SmallVector<std::unique_ptr<char[]>, 0> LargeCopies;
+  size_t CurChunk = 0;
+  char *CurPtr = nullptr;
+  char *End = nullptr;
+  size_t CopiedBytes = 0;
+
+  void write_impl(const char *Ptr, size_t Size) override;
+  void pwrite_impl(const char *Ptr, size_t Size, uint64_t Offset) override;
+  uint64_t current_pos() const override { return OS.tell() + PendingBytes; }
+
+  void addFragment(StringRef Data);
+
+public:
+  /// The size of the chunks holding copied data.
+  static constexpr size_t ChunkSize = 64 * 1024;
+  /// writeStable() copies data smaller than this, which is cheaper than
+  /// giving the kernel another fragment.
+  static constexpr size_t MinStableSize = 256;
+  /// Limits on the pending fragments and copied bytes before a flush.
+  static constexpr size_t MaxPendingFragments = 1024;
+  static constexpr size_t MaxCopiedBytes = 16 * ChunkSize;
+
+  explicit raw_iovec_ostream(raw_fd_ostream &OS)
+      : raw_pwrite_stream(/*Unbuffered=*/true, OStreamKind::OK_IOVecStream),
+        OS(OS) {}
+  ~raw_iovec_ostream() override;
+
+  /// Write \p Data by reference. See the class comment for the lifetime
+  /// requirements.
+  void writeStable(StringRef Data);
+
+  /// Write all pending fragments to the underlying stream. After this, data
+  /// passed to writeStable() is no longer referenced.
+  void flushPending();
+
+  static bool classof(const raw_ostream *OS) {
+    return OS->get_kind() == OStreamKind::OK_IOVecStream;
+  }
+};
+
+} // end namespace llvm
+
+#endif // LLVM_SUPPORT_RAW_IOVEC_OSTREAM_H
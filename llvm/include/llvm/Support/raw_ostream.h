@@ -28,6 +28,7 @@
 
 namespace llvm {
 
+template <typename T> class ArrayRef;
 class Duration;
 class formatv_object_base;
 class format_object_base;
@@ -56,6 +57,7 @@ public:
     OK_OStream,
     OK_FDStream,
     OK_SVecStream,
+    OK_IOVecStream,
   };
 
 private:
@@ -542,6 +544,11 @@ public:
   /// to the offset specified from the beginning of the file.
   uint64_t seek(uint64_t off);
 
+  /// Flushes the stream and writes \p Pieces in order, directly from the
+  /// caller's memory. On Unix this uses writev, which saves copying the pieces
+  /// into the stream buffer.
+  void write_vectored(ArrayRef<StringRef> Pieces);
+
   bool is_displayed() const override;
 
   bool has_colors() const override;
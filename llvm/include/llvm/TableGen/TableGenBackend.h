@@ -47,6 +47,11 @@ public:
 /// is no callback was applied.
 bool ApplyCallback(RecordKeeper &Records, raw_ostream &OS);
 
+/// Apply the callback registered for the command line option \p Name,
+/// whether or not that option was given. Returns true if there is no such
+/// option.
+bool ApplyCallback(RecordKeeper &Records, StringRef Name, raw_ostream &OS);
+
 } // namespace TableGen::Emitter
 
 /// emitSourceFileHeader - Output an LLVM style file header to the specified
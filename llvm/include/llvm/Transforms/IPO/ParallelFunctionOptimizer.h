@@ -0,0 +1,116 @@
+//===- ParallelFunctionOptimizer.h - Optimize in parallel -------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+/// \file
+///
+/// This file provides a way to run function-level optimizations on the
+/// functions of a module on several threads.
+///
+/// An LLVMContext cannot be used by several threads at once, so the functions
+/// are not optimized in place. Instead, the function definitions are split
+/// into partitions of about the same size, and every partition is copied into
+/// a module of its own in a fresh LLVMContext, which is optimized on a thread
+/// of its own. The optimized function bodies are then moved back into the
+/// original module.
+///
+/// The same mechanism provides a cache of optimized functions that is shared
+/// between compilations, e.g. of the inline functions of a header that many
+/// translation units define.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TRANSFORMS_IPO_PARALLELFUNCTIONOPTIMIZER_H
+#define LLVM_TRANSFORMS_IPO_PARALLELFUNCTIONOPTIMIZER_H
+
+#include "llvm/ADT/STLFunctionalExtras.h"
+#include "llvm/IR/PassManager.h"
+#include <functional>
+#include <string>
+
+namespace llvm {
+
+class Module;
+
+namespace cas {
+class ActionCache;
+class ObjectStore;
+} // end namespace cas
+
+/// Split the function definitions of \p M into at most \p NumPartitions
+/// partitions and call \p OptimizePartition on a module for each of them,
+/// concurrently on up to \p NumPartitions threads. Every partition module
+/// lives in an LLVMContext of its own. It contains the definitions of the
+/// functions in the partition, declarations of the other functions, and the
+/// global variables of \p M. Afterwards, the bodies of the functions in the
+/// partition, and anything \p OptimizePartition added to the partition module,
+/// are moved back into \p M.
+///
+/// \p OptimizePartition may change function bodies and attributes and add new
+/// globals, e.g. by running a function pass pipeline. Changes to the other
+/// globals of a partition module are discarded.
+///
+/// If \p NumPartitions is 1, if \p M has less than two function definitions,
+/// or if \p M cannot be partitioned because it has unnamed globals or ifuncs
+/// or takes the address of basic blocks, \p OptimizePartition is called on
+/// \p M itself.
+void optimizeFunctionsInParallel(
+    Module &M, unsigned NumPartitions,
+    function_ref<void(Module &)> OptimizePartition);
+
+/// Where optimizeFunctionsWithCache() keeps the functions it optimized.
+struct FunctionPipelineCache {
+  /// Stores the bitcode of the optimized functions.
+  cas::ObjectStore &Objects;
+  /// Maps a function and the pipeline key to its optimized bitcode.
+  cas::ActionCache &Actions;
+  /// Identifies the function pipeline and anything else its result depends
+  /// on that is not part of the function, e.g. the target options.
+  std::string PipelineKey;
+};
+
+/// Like optimizeFunctionsInParallel(), but with a partition for every
+/// function definition of \p M, which only contains the definition, the
+/// global variables it refers to, and declarations of the other globals it
+/// uses. The optimized partition is looked up in \p Cache by the bitcode of
+/// the partition and the pipeline key, and \p OptimizePartition is only
+/// called, on up to \p NumThreads threads, for the partitions that are not in
+/// the cache yet.
+///
+/// \p OptimizePartition must only change the function definition, as if it
+/// ran a function pass pipeline, and its result must only depend on the
+/// partition module and the pipeline key. Functions that differ only in their
+/// debug info, e.g. that of their compile unit, are cached separately.
+void optimizeFunctionsWithCache(Module &M, FunctionPipelineCache &Cache,
+                                unsigned NumThreads,
+                                function_ref<void(Module &)> OptimizePartition);
+
+/// A module pass that calls optimizeFunctionsInParallel(), e.g. to run a
+/// function pass pipeline on several threads, or optimizeFunctionsWithCache()
+/// if it is given a cache.
+class ParallelFunctionOptimizerPass
+    : public PassInfoMixin<ParallelFunctionOptimizerPass> {
+public:
+  /// \p OptimizePartition is called concurrently and must not access any
+  /// state shared with the other partitions. It typically builds the analysis
+  /// managers and pass pipeline it runs on every call.
+  ParallelFunctionOptimizerPass(unsigned NumPartitions,
+                                std::function<void(Module &)> OptimizePartition,
+                                FunctionPipelineCache *Cache = nullptr)
+      : NumPartitions(NumPartitions),
+        OptimizePartition(std::move(OptimizePartition)), Cache(Cache) {}
+
+  PreservedAnalyses run(Module &M, ModuleAnalysisManager &);
+
+private:
+  unsigned NumPartitions;
+  std::function<void(Module &)> OptimizePartition;
+  FunctionPipelineCache *Cache;
+};
+
+} // end namespace llvm
+
+#endif // LLVM_TRANSFORMS_IPO_PARALLELFUNCTIONOPTIMIZER_H
@@ -18,7 +18,9 @@
 
 #include "llvm/IR/Function.h"
 #include "llvm/IR/PassManager.h"
+#include "llvm/IR/StructuralHash.h"
 #include "llvm/Pass.h"
+#include <optional>
 
 #define DEBUG_TYPE "instcombine"
 #include "llvm/Transforms/Utils/InstructionWorklist.h"
@@ -45,6 +47,33 @@ struct InstCombineOptions {
   }
 };
 
+/// Remembers the structural hash a function had when InstCombinePass last
+/// left it at a fixpoint.
+///
+/// With -instcombine-skip-unchanged, InstCombinePass caches this analysis and
+/// skips functions whose hash still matches, since running InstCombine again
+/// on them would not change anything. The result is never invalidated: the
+/// hash itself detects changes. The hash does not cover everything InstCombine
+/// looks at, e.g. attributes and metadata, so skipping may miss folds that
+/// such changes enable.
+class InstCombineFixpointAnalysis
+    : public AnalysisInfoMixin<InstCombineFixpointAnalysis> {
+  friend AnalysisInfoMixin<InstCombineFixpointAnalysis>;
+  static AnalysisKey Key;
+
+public:
+  struct Result {
+    std::optional<IRHash> FixpointHash;
+
+    bool invalidate(Function &, const PreservedAnalyses &,
+                    FunctionAnalysisManager::Invalidator &) {
+      return false;
+    }
+  };
+
+  Result run(Function &, FunctionAnalysisManager &) { return Result(); }
+};
+
 class InstCombinePass : public PassInfoMixin<InstCombinePass> {
 private:
   InstructionWorklist Worklist;
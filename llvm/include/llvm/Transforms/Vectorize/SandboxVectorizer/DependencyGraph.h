@@ -134,6 +134,10 @@ private:
   /// The DAG spans across all instructions in this interval.
   Interval<Instruction> DAGInterval;
 
+  /// Creates the nodes of the instructions in \p NewSection, which is just
+  /// above or just below DAGInterval, and connects them to the existing nodes.
+  void createNewNodes(const Interval<Instruction> &NewSection);
+
 public:
   DependencyGraph() {}
 
@@ -158,8 +162,11 @@ public:
     return It->second.get();
   }
   /// Build/extend the dependency graph such that it includes \p Instrs. Returns
-  /// the interval spanning \p Instrs.
+  /// the interval spanning \p Instrs. Only the instructions that are not
+  /// already in the DAG are visited, so the DAG can be extended incrementally.
   Interval<Instruction> extend(ArrayRef<Instruction *> Instrs);
+  /// \Returns the interval of instructions that the DAG spans.
+  const Interval<Instruction> &getInterval() const { return DAGInterval; }
 #ifndef NDEBUG
   void print(raw_ostream &OS) const;
   LLVM_DUMP_METHOD void dump() const;
@@ -154,6 +154,21 @@ public:
     auto NewToI = To->comesBefore(Other.To) ? To : Other.To;
     return Interval(NewFromI, NewToI);
   }
+  /// \Returns the smallest interval that contains both this and \p Other,
+  /// including any gap between them.
+  // Example:
+  // |---|        this
+  //        |---| Other
+  // |----------| this->getUnionInterval(Other)
+  Interval getUnionInterval(const Interval &Other) const {
+    if (empty())
+      return Other;
+    if (Other.empty())
+      return *this;
+    auto *NewFromI = From->comesBefore(Other.From) ? From : Other.From;
+    auto *NewToI = To->comesBefore(Other.To) ? Other.To : To;
+    return Interval(NewFromI, NewToI);
+  }
   /// Difference operation. This returns up to two intervals.
   // Example:
   // |--------| this
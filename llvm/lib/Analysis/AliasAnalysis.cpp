@@ -59,6 +59,7 @@ using namespace llvm;
 STATISTIC(NumNoAlias,   "Number of NoAlias results");
 STATISTIC(NumMayAlias,  "Number of MayAlias results");
 STATISTIC(NumMustAlias, "Number of MustAlias results");
+STATISTIC(NumQueryCaches, "Number of alias query caches computed");
 
 namespace llvm {
 /// Allow disabling BasicAA from the AA results. This is particularly useful
@@ -802,6 +803,22 @@ AAManager::Result AAManager::run(Function &F, FunctionAnalysisManager &AM) {
   return R;
 }
 
+AnalysisKey AAQueryCacheAnalysis::Key;
+
+AAQueryCacheAnalysis::Result
+AAQueryCacheAnalysis::run(Function &F, FunctionAnalysisManager &AM) {
+  ++NumQueryCaches;
+  return Result(AM.getResult<AAManager>(F));
+}
+
+bool AAQueryCacheAnalysis::Result::invalidate(
+    Function &F, const PreservedAnalyses &PA,
+    FunctionAnalysisManager::Invalidator &Inv) {
+  auto PAC = PA.getChecker<AAQueryCacheAnalysis>();
+  return !(PAC.preserved() || PAC.preservedSet<AllAnalysesOn<Function>>()) ||
+         Inv.invalidate<AAManager>(F, PA);
+}
+
 bool llvm::isNoAliasCall(const Value *V) {
   if (const auto *Call = dyn_cast<CallBase>(V))
     return Call->hasRetAttr(Attribute::NoAlias);
@@ -975,20 +975,14 @@ static void createCandidatesFromSuffixTree(
   for (const unsigned &StartIdx : RS.StartIndices) {
     unsigned EndIdx = StartIdx + StringLen - 1;
 
-    // Check that this subsequence does not contain an illegal instruction.
-    bool ContainsIllegal = false;
-    for (unsigned CurrIdx = StartIdx; CurrIdx <= EndIdx; CurrIdx++) {
-      unsigned Key = IntegerMapping[CurrIdx];
-      if (Key > Mapper.IllegalInstrNumber) {
-        ContainsIllegal = true;
-        break;
-      }
-    }
-
-    // If we have an illegal instruction, we should not create an
-    // IRSimilarityCandidate for this region.
-    if (ContainsIllegal)
-      continue;
+    // Every illegal instruction is mapped to a number of its own, so a
+    // repeated subsequence can never contain one. This saves walking every
+    // instance of every repeated subsequence.
+    assert(llvm::none_of(ArrayRef(IntegerMapping).slice(StartIdx, StringLen),
+                         [&Mapper](unsigned Key) {
+                           return Key > Mapper.IllegalInstrNumber;
+                         }) &&
+           "Repeated subsequence contains an illegal instruction!");
 
     // We are getting iterators to the instructions in this region of code
     // by advancing the start and end indices from the start of the
@@ -1393,8 +1387,10 @@ void IRSimilarityIdentifier::findCandidates(
 
   // Sort the suffix tree from longest substring to shortest.
   std::vector<SuffixTree::RepeatedSubstring> RSes;
+  // The iterator resets its RepeatedSubstring when advancing, so the start
+  // indices can be moved out instead of copied.
   for (SuffixTree::RepeatedSubstring &RS : ST)
-    RSes.push_back(RS);
+    RSes.push_back(std::move(RS));
 
   llvm::stable_sort(RSes, [](const SuffixTree::RepeatedSubstring &LHS,
                              const SuffixTree::RepeatedSubstring &RHS) {
@@ -54,6 +54,7 @@
 #include <cassert>
 #include <iterator>
 #include <memory>
+#include <optional>
 #include <utility>
 
 using namespace llvm;
@@ -1004,6 +1005,9 @@ public:
   MemoryAccess *getClobberingMemoryAccessBase(MemoryAccess *, BatchAAResults &,
                                               unsigned &, bool,
                                               bool UseInvariantGroup = true);
+  void getClobberingMemoryAccessesBase(ArrayRef<MemoryAccessPair>,
+                                       SmallVectorImpl<MemoryAccess *> &,
+                                       BatchAAResults &);
 };
 
 /// A MemorySSAWalker that does AA walks to disambiguate accesses. It no
@@ -1018,6 +1022,7 @@ public:
   ~CachingWalker() override = default;
 
   using MemorySSAWalker::getClobberingMemoryAccess;
+  using MemorySSAWalker::getClobberingMemoryAccesses;
 
   MemoryAccess *getClobberingMemoryAccess(MemoryAccess *MA, BatchAAResults &BAA,
                                           unsigned &UWL) {
@@ -1046,6 +1051,12 @@ public:
     return getClobberingMemoryAccess(MA, Loc, BAA, UpwardWalkLimit);
   }
 
+  void getClobberingMemoryAccesses(ArrayRef<MemoryAccessPair> Queries,
+                                   SmallVectorImpl<MemoryAccess *> &Results,
+                                   BatchAAResults &BAA) override {
+    Walker->getClobberingMemoryAccessesBase(Queries, Results, BAA);
+  }
+
   void invalidateInfo(MemoryAccess *MA) override {
     if (auto *MUD = dyn_cast<MemoryUseOrDef>(MA))
       MUD->resetOptimized();
@@ -1061,6 +1072,7 @@ public:
   ~SkipSelfWalker() override = default;
 
   using MemorySSAWalker::getClobberingMemoryAccess;
+  using MemorySSAWalker::getClobberingMemoryAccesses;
 
   MemoryAccess *getClobberingMemoryAccess(MemoryAccess *MA, BatchAAResults &BAA,
                                           unsigned &UWL) {
@@ -1084,6 +1096,12 @@ public:
     return getClobberingMemoryAccess(MA, Loc, BAA, UpwardWalkLimit);
   }
 
+  void getClobberingMemoryAccesses(ArrayRef<MemoryAccessPair> Queries,
+                                   SmallVectorImpl<MemoryAccess *> &Results,
+                                   BatchAAResults &BAA) override {
+    Walker->getClobberingMemoryAccessesBase(Queries, Results, BAA);
+  }
+
   void invalidateInfo(MemoryAccess *MA) override {
     if (auto *MUD = dyn_cast<MemoryUseOrDef>(MA))
       MUD->resetOptimized();
@@ -1230,7 +1248,8 @@ void MemorySSA::markUnreachableAsLiveOnEntry(BasicBlock *BB) {
   }
 }
 
-MemorySSA::MemorySSA(Function &Func, AliasAnalysis *AA, DominatorTree *DT)
+MemorySSA::MemorySSA(Function &Func, AliasAnalysis *AA, DominatorTree *DT,
+                     BatchAAResults *BatchAA)
     : DT(DT), F(&Func), LiveOnEntryDef(nullptr), Walker(nullptr),
       SkipWalker(nullptr) {
   // Build MemorySSA using a batch alias analysis. This reuses the internal
@@ -1239,8 +1258,10 @@ MemorySSA::MemorySSA(Function &Func, AliasAnalysis *AA, DominatorTree *DT)
   // significantly reduce the time spent by the compiler in AA, because we will
   // make queries about all the instructions in the Function.
   assert(AA && "No alias analysis?");
-  BatchAAResults BatchAA(*AA);
-  buildMemorySSA(BatchAA, iterator_range(F->begin(), F->end()));
+  std::optional<BatchAAResults> LocalBatchAA;
+  if (!BatchAA)
+    BatchAA = &LocalBatchAA.emplace(*AA);
+  buildMemorySSA(*BatchAA, iterator_range(F->begin(), F->end()));
   // Intentionally leave AA to nullptr while building so we don't accidentally
   // use non-batch AliasAnalysis.
   this->AA = AA;
@@ -2367,7 +2388,11 @@ MemorySSAAnalysis::Result MemorySSAAnalysis::run(Function &F,
                                                  FunctionAnalysisManager &AM) {
   auto &DT = AM.getResult<DominatorTreeAnalysis>(F);
   auto &AA = AM.getResult<AAManager>(F);
-  return MemorySSAAnalysis::Result(std::make_unique<MemorySSA>(F, &AA, &DT));
+  // Share the alias queries with the other passes that run on the unchanged
+  // function.
+  auto &BatchAA = AM.getResult<AAQueryCacheAnalysis>(F).getBatchAA();
+  return MemorySSAAnalysis::Result(
+      std::make_unique<MemorySSA>(F, &AA, &DT, &BatchAA));
 }
 
 bool MemorySSAAnalysis::Result::invalidate(
@@ -2444,6 +2469,14 @@ void MemorySSAWrapperPass::print(raw_ostream &OS, const Module *M) const {
 
 MemorySSAWalker::MemorySSAWalker(MemorySSA *M) : MSSA(M) {}
 
+void MemorySSAWalker::getClobberingMemoryAccesses(
+    ArrayRef<MemoryAccessPair> Queries,
+    SmallVectorImpl<MemoryAccess *> &Results, BatchAAResults &AA) {
+  Results.clear();
+  for (const auto &[MA, Loc] : Queries)
+    Results.push_back(getClobberingMemoryAccess(MA, Loc, AA));
+}
+
 /// Walk the use-def chains starting at \p StartingAccess and find
 /// the MemoryAccess that actually clobbers Loc.
 ///
@@ -2490,6 +2523,64 @@ MemoryAccess *MemorySSA::ClobberWalkerBase::getClobberingMemoryAccessBase(
   return Clobber;
 }
 
+/// Answer a batch of location queries like the method above. Every MemoryDef
+/// that an upward walk for a location passes without finding a clobber has
+/// the same clobber for that location as the walk, so it is remembered for
+/// them, and the walks of later queries stop when they reach one of them.
+/// Phis are left to the clobber walker.
+void MemorySSA::ClobberWalkerBase::getClobberingMemoryAccessesBase(
+    ArrayRef<MemoryAccessPair> Queries,
+    SmallVectorImpl<MemoryAccess *> &Results, BatchAAResults &BAA) {
+  DenseMap<ConstMemoryAccessPair, MemoryAccess *> Clobbers;
+  SmallVector<const MemoryAccess *, 8> Walked;
+  Results.clear();
+  Results.reserve(Queries.size());
+  for (const auto &[Start, Loc] : Queries) {
+    assert(!isa<MemoryUse>(Start) && "Use cannot be defining access");
+    unsigned UpwardWalkLimit = MaxCheckLimit;
+    if (Loc.Ptr == nullptr) {
+      Results.push_back(
+          getClobberingMemoryAccessBase(Start, Loc, BAA, UpwardWalkLimit));
+      continue;
+    }
+
+    // Walk up the def chain until a clobber, a phi or a remembered access.
+    // The clobber is only remembered if the walk limit did not cut the walk
+    // short.
+    Walked.clear();
+    MemoryAccess *Clobber = nullptr;
+    bool Remember = true;
+    for (MemoryAccess *Current = Start; !Clobber;) {
+      if (MemoryAccess *Known = Clobbers.lookup({Current, Loc})) {
+        Clobber = Known;
+      } else if (MSSA->isLiveOnEntryDef(Current)) {
+        Clobber = Current;
+      } else if (auto *MD = dyn_cast<MemoryDef>(Current)) {
+        if (!--UpwardWalkLimit) {
+          Clobber = MD;
+          Remember = false;
+          continue;
+        }
+        Walked.push_back(MD);
+        if (instructionClobbersQuery(MD, Loc, nullptr, BAA))
+          Clobber = MD;
+        else
+          Current = MD->getDefiningAccess();
+      } else {
+        Walked.push_back(Current);
+        Clobber =
+            getClobberingMemoryAccessBase(Current, Loc, BAA, UpwardWalkLimit);
+        Remember = UpwardWalkLimit != 0;
+      }
+    }
+
+    if (Remember)
+      for (const MemoryAccess *MA : Walked)
+        Clobbers[{MA, Loc}] = Clobber;
+    Results.push_back(Clobber);
+  }
+}
+
 static const Instruction *
 getInvariantGroupClobberingInstruction(Instruction &I, DominatorTree &DT) {
   if (!I.hasMetadata(LLVMContext::MD_invariant_group) || I.isVolatile())
@@ -142,6 +142,14 @@ STATISTIC(NumExitCountsNotComputed,
           "Number of loop exits without predictable exit counts");
 STATISTIC(NumBruteForceTripCountsComputed,
           "Number of loops with trip counts computed by force");
+STATISTIC(NumExistingSCEVHits,
+          "Number of values whose SCEV was found in the cache");
+STATISTIC(NumExistingSCEVMisses,
+          "Number of values whose SCEV was not found in the cache");
+STATISTIC(NumBackedgeTakenInfoHits,
+          "Number of loops whose backedge-taken info was found in the cache");
+STATISTIC(NumBackedgeTakenInfoMisses,
+          "Number of loops whose backedge-taken info was computed");
 
 #ifdef EXPENSIVE_CHECKS
 bool llvm::VerifySCEV = true;
@@ -439,6 +447,48 @@ ArrayRef<const SCEV *> SCEV::operands() const {
   llvm_unreachable("Unknown SCEV kind!");
 }
 
+void SCEV::Profile(FoldingSetNodeID &ID) const {
+  // This must match the IDs the ScalarEvolution::get* methods look up.
+  ID.AddInteger(getSCEVType());
+  switch (getSCEVType()) {
+  case scConstant:
+    ID.AddPointer(cast<SCEVConstant>(this)->getValue());
+    return;
+  case scVScale:
+    ID.AddPointer(getType());
+    return;
+  case scUnknown:
+    ID.AddPointer(cast<SCEVUnknown>(this)->getValue());
+    return;
+  case scPtrToInt:
+  case scUDivExpr:
+  case scAddExpr:
+  case scMulExpr:
+  case scUMaxExpr:
+  case scSMaxExpr:
+  case scUMinExpr:
+  case scSMinExpr:
+  case scSequentialUMinExpr:
+    for (const SCEV *Op : operands())
+      ID.AddPointer(Op);
+    return;
+  case scTruncate:
+  case scZeroExtend:
+  case scSignExtend:
+    ID.AddPointer(cast<SCEVCastExpr>(this)->getOperand());
+    ID.AddPointer(getType());
+    return;
+  case scAddRecExpr:
+    for (const SCEV *Op : operands())
+      ID.AddPointer(Op);
+    ID.AddPointer(cast<SCEVAddRecExpr>(this)->getLoop());
+    return;
+  case scCouldNotCompute:
+    llvm_unreachable("Attempt to use a SCEVCouldNotCompute object!");
+  }
+  llvm_unreachable("Unknown SCEV kind!");
+}
+
 bool SCEV::isZero() const {
   if (const SCEVConstant *SC = dyn_cast<SCEVConstant>(this))
     return SC->getValue()->isZero();
@@ -469,8 +519,7 @@ bool SCEV::isNonConstantNegative() const {
   return SC->getAPInt().isNegative();
 }
 
-SCEVCouldNotCompute::SCEVCouldNotCompute() :
-  SCEV(FoldingSetNodeIDRef(), scCouldNotCompute, 0) {}
+SCEVCouldNotCompute::SCEVCouldNotCompute() : SCEV(scCouldNotCompute, 0) {}
 
 bool SCEVCouldNotCompute::classof(const SCEV *S) {
   return S->getSCEVType() == scCouldNotCompute;
@@ -482,7 +531,7 @@ const SCEV *ScalarEvolution::getConstant(ConstantInt *V) {
   ID.AddPointer(V);
   void *IP = nullptr;
   if (const SCEV *S = UniqueSCEVs.FindNodeOrInsertPos(ID, IP)) return S;
-  SCEV *S = new (SCEVAllocator) SCEVConstant(ID.Intern(SCEVAllocator), V);
+  SCEV *S = new (SCEVAllocator) SCEVConstant(V);
   UniqueSCEVs.InsertNode(S, IP);
   return S;
 }
@@ -504,7 +553,7 @@ const SCEV *ScalarEvolution::getVScale(Type *Ty) {
   void *IP = nullptr;
   if (const SCEV *S = UniqueSCEVs.FindNodeOrInsertPos(ID, IP))
     return S;
-  SCEV *S = new (SCEVAllocator) SCEVVScale(ID.Intern(SCEVAllocator), Ty);
+  SCEV *S = new (SCEVAllocator) SCEVVScale(Ty);
   UniqueSCEVs.InsertNode(S, IP);
   return S;
 }
@@ -516,39 +565,33 @@ const SCEV *ScalarEvolution::getElementCount(Type *Ty, ElementCount EC) {
   return Res;
 }
 
-SCEVCastExpr::SCEVCastExpr(const FoldingSetNodeIDRef ID, SCEVTypes SCEVTy,
-                           const SCEV *op, Type *ty)
-    : SCEV(ID, SCEVTy, computeExpressionSize(op)), Op(op), Ty(ty) {}
+SCEVCastExpr::SCEVCastExpr(SCEVTypes SCEVTy, const SCEV *op, Type *ty)
+    : SCEV(SCEVTy, computeExpressionSize(op)), Op(op), Ty(ty) {}
 
-SCEVPtrToIntExpr::SCEVPtrToIntExpr(const FoldingSetNodeIDRef ID, const SCEV *Op,
-                                   Type *ITy)
-    : SCEVCastExpr(ID, scPtrToInt, Op, ITy) {
+SCEVPtrToIntExpr::SCEVPtrToIntExpr(const SCEV *Op, Type *ITy)
+    : SCEVCastExpr(scPtrToInt, Op, ITy) {
   assert(getOperand()->getType()->isPointerTy() && Ty->isIntegerTy() &&
          "Must be a non-bit-width-changing pointer-to-integer cast!");
 }
 
-SCEVIntegralCastExpr::SCEVIntegralCastExpr(const FoldingSetNodeIDRef ID,
-                                           SCEVTypes SCEVTy, const SCEV *op,
+SCEVIntegralCastExpr::SCEVIntegralCastExpr(SCEVTypes SCEVTy, const SCEV *op,
                                            Type *ty)
-    : SCEVCastExpr(ID, SCEVTy, op, ty) {}
+    : SCEVCastExpr(SCEVTy, op, ty) {}
 
-SCEVTruncateExpr::SCEVTruncateExpr(const FoldingSetNodeIDRef ID, const SCEV *op,
-                                   Type *ty)
-    : SCEVIntegralCastExpr(ID, scTruncate, op, ty) {
+SCEVTruncateExpr::SCEVTruncateExpr(const SCEV *op, Type *ty)
+    : SCEVIntegralCastExpr(scTruncate, op, ty) {
   assert(getOperand()->getType()->isIntOrPtrTy() && Ty->isIntOrPtrTy() &&
          "Cannot truncate non-integer value!");
 }
 
-SCEVZeroExtendExpr::SCEVZeroExtendExpr(const FoldingSetNodeIDRef ID,
-                                       const SCEV *op, Type *ty)
-    : SCEVIntegralCastExpr(ID, scZeroExtend, op, ty) {
+SCEVZeroExtendExpr::SCEVZeroExtendExpr(const SCEV *op, Type *ty)
+    : SCEVIntegralCastExpr(scZeroExtend, op, ty) {
   assert(getOperand()->getType()->isIntOrPtrTy() && Ty->isIntOrPtrTy() &&
          "Cannot zero extend non-integer value!");
 }
 
-SCEVSignExtendExpr::SCEVSignExtendExpr(const FoldingSetNodeIDRef ID,
-                                       const SCEV *op, Type *ty)
-    : SCEVIntegralCastExpr(ID, scSignExtend, op, ty) {
+SCEVSignExtendExpr::SCEVSignExtendExpr(const SCEV *op, Type *ty)
+    : SCEVIntegralCastExpr(scSignExtend, op, ty) {
   assert(getOperand()->getType()->isIntOrPtrTy() && Ty->isIntOrPtrTy() &&
          "Cannot sign extend non-integer value!");
 }
@@ -1067,8 +1110,7 @@ const SCEV *ScalarEvolution::getLosslessPtrToIntExpr(const SCEV *Op,
     // Create an explicit cast node.
     // We can reuse the existing insert position since if we get here,
     // we won't have made any changes which would invalidate it.
-    SCEV *S = new (SCEVAllocator)
-        SCEVPtrToIntExpr(ID.Intern(SCEVAllocator), Op, IntPtrTy);
+    SCEV *S = new (SCEVAllocator) SCEVPtrToIntExpr(Op, IntPtrTy);
     UniqueSCEVs.InsertNode(S, IP);
     registerUser(S, Op);
     return S;
@@ -1187,8 +1229,7 @@ const SCEV *ScalarEvolution::getTruncateExpr(const SCEV *Op, Type *Ty,
     return getTruncateOrZeroExtend(SZ->getOperand(), Ty, Depth + 1);
 
   if (Depth > MaxCastDepth) {
-    SCEV *S =
-        new (SCEVAllocator) SCEVTruncateExpr(ID.Intern(SCEVAllocator), Op, Ty);
+    SCEV *S = new (SCEVAllocator) SCEVTruncateExpr(Op, Ty);
     UniqueSCEVs.InsertNode(S, IP);
     registerUser(S, Op);
     return S;
@@ -1240,8 +1281,7 @@ const SCEV *ScalarEvolution::getTruncateExpr(const SCEV *Op, Type *Ty,
   // The cast wasn't folded; create an explicit cast node. We can reuse
   // the existing insert position since if we get here, we won't have
   // made any changes which would invalidate it.
-  SCEV *S = new (SCEVAllocator) SCEVTruncateExpr(ID.Intern(SCEVAllocator),
-                                                 Op, Ty);
+  SCEV *S = new (SCEVAllocator) SCEVTruncateExpr(Op, Ty);
   UniqueSCEVs.InsertNode(S, IP);
   registerUser(S, Op);
   return S;
@@ -1612,8 +1652,7 @@ const SCEV *ScalarEvolution::getZeroExtendExprImpl(const SCEV *Op, Type *Ty,
   void *IP = nullptr;
   if (const SCEV *S = UniqueSCEVs.FindNodeOrInsertPos(ID, IP)) return S;
   if (Depth > MaxCastDepth) {
-    SCEV *S = new (SCEVAllocator) SCEVZeroExtendExpr(ID.Intern(SCEVAllocator),
-                                                     Op, Ty);
+    SCEV *S = new (SCEVAllocator) SCEVZeroExtendExpr(Op, Ty);
     UniqueSCEVs.InsertNode(S, IP);
     registerUser(S, Op);
     return S;
@@ -1896,8 +1935,7 @@ const SCEV *ScalarEvolution::getZeroExtendExprImpl(const SCEV *Op, Type *Ty,
   // The cast wasn't folded; create an explicit cast node.
   // Recompute the insert position, as it may have been invalidated.
   if (const SCEV *S = UniqueSCEVs.FindNodeOrInsertPos(ID, IP)) return S;
-  SCEV *S = new (SCEVAllocator) SCEVZeroExtendExpr(ID.Intern(SCEVAllocator),
-                                                   Op, Ty);
+  SCEV *S = new (SCEVAllocator) SCEVZeroExtendExpr(Op, Ty);
   UniqueSCEVs.InsertNode(S, IP);
   registerUser(S, Op);
   return S;
@@ -1953,8 +1991,7 @@ const SCEV *ScalarEvolution::getSignExtendExprImpl(const SCEV *Op, Type *Ty,
   if (const SCEV *S = UniqueSCEVs.FindNodeOrInsertPos(ID, IP)) return S;
   // Limit recursion depth.
   if (Depth > MaxCastDepth) {
-    SCEV *S = new (SCEVAllocator) SCEVSignExtendExpr(ID.Intern(SCEVAllocator),
-                                                     Op, Ty);
+    SCEV *S = new (SCEVAllocator) SCEVSignExtendExpr(Op, Ty);
     UniqueSCEVs.InsertNode(S, IP);
     registerUser(S, Op);
     return S;
@@ -2159,8 +2196,7 @@ const SCEV *ScalarEvolution::getSignExtendExprImpl(const SCEV *Op, Type *Ty,
   // The cast wasn't folded; create an explicit cast node.
   // Recompute the insert position, as it may have been invalidated.
   if (const SCEV *S = UniqueSCEVs.FindNodeOrInsertPos(ID, IP)) return S;
-  SCEV *S = new (SCEVAllocator) SCEVSignExtendExpr(ID.Intern(SCEVAllocator),
-                                                   Op, Ty);
+  SCEV *S = new (SCEVAllocator) SCEVSignExtendExpr(Op, Ty);
   UniqueSCEVs.InsertNode(S, IP);
   registerUser(S, { Op });
   return S;
@@ -3000,8 +3036,7 @@ ScalarEvolution::getOrCreateAddExpr(ArrayRef<const SCEV *> Ops,
   if (!S) {
     const SCEV **O = SCEVAllocator.Allocate<const SCEV *>(Ops.size());
     std::uninitialized_copy(Ops.begin(), Ops.end(), O);
-    S = new (SCEVAllocator)
-        SCEVAddExpr(ID.Intern(SCEVAllocator), O, Ops.size());
+    S = new (SCEVAllocator) SCEVAddExpr(O, Ops.size());
     UniqueSCEVs.InsertNode(S, IP);
     registerUser(S, Ops);
   }
@@ -3023,8 +3058,7 @@ ScalarEvolution::getOrCreateAddRecExpr(ArrayRef<const SCEV *> Ops,
   if (!S) {
     const SCEV **O = SCEVAllocator.Allocate<const SCEV *>(Ops.size());
     std::uninitialized_copy(Ops.begin(), Ops.end(), O);
-    S = new (SCEVAllocator)
-        SCEVAddRecExpr(ID.Intern(SCEVAllocator), O, Ops.size(), L);
+    S = new (SCEVAllocator) SCEVAddRecExpr(O, Ops.size(), L);
     UniqueSCEVs.InsertNode(S, IP);
     LoopUsers[L].push_back(S);
     registerUser(S, Ops);
@@ -3046,8 +3080,7 @@ ScalarEvolution::getOrCreateMulExpr(ArrayRef<const SCEV *> Ops,
   if (!S) {
     const SCEV **O = SCEVAllocator.Allocate<const SCEV *>(Ops.size());
     std::uninitialized_copy(Ops.begin(), Ops.end(), O);
-    S = new (SCEVAllocator) SCEVMulExpr(ID.Intern(SCEVAllocator),
-                                        O, Ops.size());
+    S = new (SCEVAllocator) SCEVMulExpr(O, Ops.size());
     UniqueSCEVs.InsertNode(S, IP);
     registerUser(S, Ops);
   }
@@ -3567,8 +3600,7 @@ const SCEV *ScalarEvolution::getUDivExpr(const SCEV *LHS,
   // changes). Make sure we get a new one.
   IP = nullptr;
   if (const SCEV *S = UniqueSCEVs.FindNodeOrInsertPos(ID, IP)) return S;
-  SCEV *S = new (SCEVAllocator) SCEVUDivExpr(ID.Intern(SCEVAllocator),
-                                             LHS, RHS);
+  SCEV *S = new (SCEVAllocator) SCEVUDivExpr(LHS, RHS);
   UniqueSCEVs.InsertNode(S, IP);
   registerUser(S, {LHS, RHS});
   return S;
@@ -3952,8 +3984,7 @@ const SCEV *ScalarEvolution::getMinMaxExpr(SCEVTypes Kind,
     return ExistingSCEV;
   const SCEV **O = SCEVAllocator.Allocate<const SCEV *>(Ops.size());
   std::uninitialized_copy(Ops.begin(), Ops.end(), O);
-  SCEV *S = new (SCEVAllocator)
-      SCEVMinMaxExpr(ID.Intern(SCEVAllocator), Kind, O, Ops.size());
+  SCEV *S = new (SCEVAllocator) SCEVMinMaxExpr(Kind, O, Ops.size());
 
   UniqueSCEVs.InsertNode(S, IP);
   registerUser(S, Ops);
@@ -4338,8 +4369,7 @@ ScalarEvolution::getSequentialMinMaxExpr(SCEVTypes Kind,
 
   const SCEV **O = SCEVAllocator.Allocate<const SCEV *>(Ops.size());
   std::uninitialized_copy(Ops.begin(), Ops.end(), O);
-  SCEV *S = new (SCEVAllocator)
-      SCEVSequentialMinMaxExpr(ID.Intern(SCEVAllocator), Kind, O, Ops.size());
+  SCEV *S = new (SCEVAllocator) SCEVSequentialMinMaxExpr(Kind, O, Ops.size());
 
   UniqueSCEVs.InsertNode(S, IP);
   registerUser(S, Ops);
@@ -4429,8 +4459,7 @@ const SCEV *ScalarEvolution::getUnknown(Value *V) {
            "Stale SCEVUnknown in uniquing map!");
     return S;
   }
-  SCEV *S = new (SCEVAllocator) SCEVUnknown(ID.Intern(SCEVAllocator), V, this,
-                                            FirstUnknown);
+  SCEV *S = new (SCEVAllocator) SCEVUnknown(V, this, FirstUnknown);
   FirstUnknown = cast<SCEVUnknown>(S);
   UniqueSCEVs.InsertNode(S, IP);
   return S;
@@ -4566,8 +4595,10 @@ const SCEV *ScalarEvolution::getExistingSCEV(Value *V) {
     const SCEV *S = I->second;
     assert(checkValidity(S) &&
            "existing SCEV has not been properly invalidated");
+    ++NumExistingSCEVHits;
     return S;
   }
+  ++NumExistingSCEVMisses;
   return nullptr;
 }
 
@@ -8353,8 +8384,11 @@ ScalarEvolution::getBackedgeTakenInfo(const Loop *L) {
   // backedge-taken count, which could result in infinite recursion.
   std::pair<DenseMap<const Loop *, BackedgeTakenInfo>::iterator, bool> Pair =
       BackedgeTakenCounts.insert({L, BackedgeTakenInfo()});
-  if (!Pair.second)
+  if (!Pair.second) {
+    ++NumBackedgeTakenInfoHits;
     return Pair.first->second;
+  }
+  ++NumBackedgeTakenInfoMisses;
 
   // computeBackedgeTakenCount may allocate memory for its result. Inserting it
   // into the BackedgeTakenCounts map transfers ownership. Otherwise, the result
@@ -66,6 +66,7 @@
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Compiler.h"
+#include "llvm/Support/Compression.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorHandling.h"
@@ -80,6 +81,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <deque>
+#include <limits>
 #include <map>
 #include <memory>
 #include <optional>
@@ -6972,18 +6974,19 @@ Error BitcodeReader::materialize(GlobalValue *GV) {
   if (DISubprogram *SP = MDLoader->lookupSubprogramForFunction(F))
     F->setSubprogram(SP);
 
-  // Check if the TBAA Metadata are valid, otherwise we will need to strip them.
-  if (!MDLoader->isStrippingTBAA()) {
-    for (auto &I : instructions(F)) {
+  // Walk the body once to validate the TBAA metadata, upgrade old branch
+  // weights and drop incompatible call attributes.
+  for (auto &I : instructions(F)) {
+    // Check if the TBAA Metadata are valid, otherwise we will need to strip
+    // them.
+    if (!MDLoader->isStrippingTBAA()) {
       MDNode *TBAA = I.getMetadata(LLVMContext::MD_tbaa);
-      if (!TBAA || TBAAVerifyHelper.visitTBAAMetadata(I, TBAA))
-        continue;
-      MDLoader->setStripTBAA(true);
-      stripTBAA(F->getParent());
+      if (TBAA && !TBAAVerifyHelper.visitTBAAMetadata(I, TBAA)) {
+        MDLoader->setStripTBAA(true);
+        stripTBAA(F->getParent());
+      }
     }
-  }
 
-  for (auto &I : instructions(F)) {
     // "Upgrade" older incorrect branch weights by dropping them.
     if (auto *MD = I.getMetadata(LLVMContext::MD_prof)) {
       if (MD->getOperand(0) != nullptr && isa<MDString>(MD->getOperand(0))) {
@@ -8226,6 +8229,55 @@ static Expected<StringRef> readBlobInRecord(BitstreamCursor &Stream,
 // External interface
 //===----------------------------------------------------------------------===//
 
+Expected<std::unique_ptr<MemoryBuffer>>
+llvm::decompressBitcode(MemoryBufferRef Buffer) {
+  const unsigned char *BufPtr =
+      reinterpret_cast<const unsigned char *>(Buffer.getBufferStart());
+  const unsigned char *BufEnd =
+      reinterpret_cast<const unsigned char *>(Buffer.getBufferEnd());
+  if (!isCompressedBitcode(BufPtr, BufEnd))
+    return error("Invalid compressed bitcode signature");
+  if (unsigned(BufEnd - BufPtr) < CBH_HeaderSize)
+    return error("Invalid compressed bitcode header");
+
+  compression::Format F;
+  switch (support::endian::read32le(&BufPtr[CBH_FormatField])) {
+  case 0:
+    F = compression::Format::Zlib;
+    break;
+  case 1:
+    F = compression::Format::Zstd;
+    break;
+  default:
+    return error("Unknown compressed bitcode format");
+  }
+  if (const char *Reason = compression::getReasonIfUnsupported(F))
+    return error(Twine("Cannot decompress bitcode: ") + Reason);
+
+  // Neither format can expand its input by more than this, so a larger size
+  // in the header is corrupt and must not be allocated.
+  ArrayRef<uint8_t> Input(BufPtr + CBH_HeaderSize, BufEnd);
+  uint64_t MaxRatio = F == compression::Format::Zlib ? 1032 : 32768;
+  uint64_t Size = support::endian::read64le(&BufPtr[CBH_SizeField]);
+  if (Size > std::numeric_limits<size_t>::max() ||
+      Size / MaxRatio > Input.size())
+    return error("Invalid compressed bitcode size");
+  std::unique_ptr<WritableMemoryBuffer> Result =
+      WritableMemoryBuffer::getNewUninitMemBuffer(
+          Size, Buffer.getBufferIdentifier());
+  if (!Result)
+    return error("Compressed bitcode is too large");
+  uint8_t *Output = reinterpret_cast<uint8_t *>(Result->getBufferStart());
+  size_t OutputSize = Size;
+  if (Error E = F == compression::Format::Zlib
+                    ? compression::zlib::decompress(Input, Output, OutputSize)
+                    : compression::zstd::decompress(Input, Output, OutputSize))
+    return std::move(E);
+  if (OutputSize != Size)
+    return error("Compressed bitcode size mismatch");
+  return std::move(Result);
+}
+
 Expected<std::vector<BitcodeModule>>
 llvm::getBitcodeModuleList(MemoryBufferRef Buffer) {
   auto FOrErr = getBitcodeFileContents(Buffer);
@@ -63,6 +63,7 @@
 #include "llvm/Support/AtomicOrdering.h"
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Compression.h"
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorHandling.h"
@@ -5172,6 +5173,20 @@ void llvm::WriteBitcodeToFile(const Module &M, raw_ostream &Out,
   }
 }
 
+void llvm::writeCompressedBitcode(StringRef Bitcode, compression::Params P,
+                                  raw_ostream &Out) {
+  SmallVector<uint8_t, 0> Compressed;
+  compression::compress(P, arrayRefFromStringRef(Bitcode), Compressed);
+
+  char Header[CBH_HeaderSize] = {'B', 'C', 'Z', 0x01};
+  support::endian::write32le(&Header[CBH_FormatField],
+                             P.format == compression::Format::Zlib ? 0 : 1);
+  support::endian::write64le(&Header[CBH_SizeField], Bitcode.size());
+  Out.write(Header, CBH_HeaderSize);
+  Out.write(reinterpret_cast<const char *>(Compressed.data()),
+            Compressed.size());
+}
+
 void IndexBitcodeWriter::write() {
   Stream.EnterSubblock(bitc::MODULE_BLOCK_ID, 3);
 
@@ -0,0 +1,59 @@
+//===- ActionCache.cpp - On-disk cache of action results ------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/CAS/ActionCache.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include <cstring>
+
+using namespace llvm;
+using namespace llvm::cas;
+
+static CASID getResult(const OnDiskTrieHashMap::Record &R) {
+  return CASID::create(ArrayRef(
+      reinterpret_cast<const uint8_t *>(R.Value.data()), R.Value.size()));
+}
+
+Expected<std::unique_ptr<ActionCache>>
+ActionCache::open(const Twine &Path, uint64_t Capacity) {
+  SmallString<256> CachePath;
+  Path.toVector(CachePath);
+  if (std::error_code EC = sys::fs::create_directories(CachePath))
+    return createFileError(CachePath, errorCodeToError(EC));
+  sys::path::append(CachePath, "actions.v1");
+  Expected<OnDiskTrieHashMap> Cache = OnDiskTrieHashMap::create(
+      CachePath, CASID::NumBytes, CASID::NumBytes, Capacity);
+  if (!Cache)
+    return Cache.takeError();
+  return std::unique_ptr<ActionCache>(new ActionCache(std::move(*Cache)));
+}
+
+std::optional<CASID> ActionCache::get(const CASID &ActionKey) const {
+  if (std::optional<OnDiskTrieHashMap::Record> R =
+          Cache.find(ActionKey.getHash()))
+    return getResult(*R);
+  return std::nullopt;
+}
+
+Error ActionCache::put(const CASID &ActionKey, const CASID &Result) {
+  auto Inserted =
+      Cache.insertLazy(ActionKey.getHash(), [&](MutableArrayRef<char> Value) {
+        std::memcpy(Value.data(), Result.getHash().data(), CASID::NumBytes);
+      });
+  if (!Inserted)
+    return Inserted.takeError();
+  CASID Existing = getResult(Inserted->first);
+  if (Existing != Result)
+    return createStringError(make_error_code(std::errc::invalid_argument),
+                             "conflicting results for action " +
+                                 ActionKey.toString() + ": " +
+                                 Existing.toString() + " and " +
+                                 Result.toString());
+  return Error::success();
+}
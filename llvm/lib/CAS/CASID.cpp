@@ -0,0 +1,26 @@
+//===- CASID.cpp - Content-addressed object IDs ---------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/CAS/CASID.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace llvm;
+using namespace llvm::cas;
+
+Expected<CASID> CASID::parse(StringRef Str) {
+  std::string Bytes;
+  if (Str.size() != 2 * NumBytes || !tryGetFromHex(Str, Bytes))
+    return createStringError(make_error_code(std::errc::invalid_argument),
+                             "invalid CAS ID '" + Str + "'");
+  return create(arrayRefFromStringRef(Bytes));
+}
+
+std::string CASID::toString() const { return toHex(Hash, /*LowerCase=*/true); }
+
+void CASID::print(raw_ostream &OS) const { OS << toString(); }
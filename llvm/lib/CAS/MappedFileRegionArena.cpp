@@ -0,0 +1,89 @@
+//===- MappedFileRegionArena.cpp - Bump allocator in a mapped file --------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/CAS/MappedFileRegionArena.h"
+#include "llvm/ADT/ScopeExit.h"
+#include "llvm/Support/MathExtras.h"
+
+using namespace llvm;
+using namespace llvm::cas;
+
+Expected<MappedFileRegionArena> MappedFileRegionArena::create(
+    const Twine &PathTwine, uint64_t Capacity, uint64_t Magic,
+    function_ref<Error(MappedFileRegionArena &)> NewFileConstructor) {
+  std::string Path = PathTwine.str();
+  auto createError = [&](std::error_code EC, const Twine &Msg) {
+    return createFileError(Path, createStringError(EC, Msg));
+  };
+
+  int FD;
+  if (std::error_code EC = sys::fs::openFileForReadWrite(
+          Path, FD, sys::fs::CD_OpenAlways, sys::fs::OF_None))
+    return createFileError(Path, errorCodeToError(EC));
+  auto CloseFile = make_scope_exit([&] { sys::fs::closeFile(FD); });
+
+  // Hold an exclusive lock while the file is sized and initialized, so that
+  // other processes only ever map an initialized file.
+  if (std::error_code EC = sys::fs::lockFile(FD))
+    return createError(EC, "cannot lock file");
+  auto UnlockFile = make_scope_exit([&] { sys::fs::unlockFile(FD); });
+
+  sys::fs::file_status Status;
+  if (std::error_code EC = sys::fs::status(FD, Status))
+    return createFileError(Path, errorCodeToError(EC));
+  // An existing file keeps its size: other processes may have mapped it.
+  if (Status.getSize() == 0) {
+    Capacity = alignTo(std::max<uint64_t>(Capacity, sizeof(Header)),
+                       Alignment);
+    if (std::error_code EC =
+            sys::fs::resize_file_before_mapping_readwrite(FD, Capacity))
+      return createError(EC, "cannot resize file");
+  } else {
+    Capacity = Status.getSize();
+    if (Capacity < sizeof(Header))
+      return createError(make_error_code(std::errc::invalid_argument),
+                         "file is too small");
+  }
+
+  std::error_code EC;
+  sys::fs::mapped_file_region Region(
+      sys::fs::convertFDToNativeFile(FD),
+      sys::fs::mapped_file_region::readwrite, Capacity, 0, EC);
+  if (EC)
+    return createError(EC, "cannot map file");
+
+  MappedFileRegionArena Arena(std::move(Path), std::move(Region));
+  Header &H = Arena.getHeader();
+  // A zero magic means the file is new, or its initialization did not finish.
+  // The magic is written last, so a process that crashed while initializing
+  // the file leaves it to be initialized again.
+  if (H.Magic == 0) {
+    H.UserHeaderOffset = 0;
+    H.Size.store(alignTo(sizeof(Header), Alignment),
+                 std::memory_order_relaxed);
+    if (Error E = NewFileConstructor(Arena))
+      return std::move(E);
+    H.Magic = Magic;
+  } else if (H.Magic != Magic) {
+    return createError(make_error_code(std::errc::invalid_argument),
+                       "unexpected file format");
+  }
+  return std::move(Arena);
+}
+
+Expected<uint64_t> MappedFileRegionArena::allocateOffset(uint64_t Size) {
+  Size = alignTo(Size, Alignment);
+  uint64_t Offset =
+      getHeader().Size.fetch_add(Size, std::memory_order_relaxed);
+  if (Offset > capacity() || Size > capacity() - Offset)
+    return createFileError(
+        Path, createStringError(make_error_code(std::errc::not_enough_memory),
+                                "file of " + Twine(capacity()) +
+                                    " bytes is full"));
+  return Offset;
+}
@@ -0,0 +1,118 @@
+//===- ObjectStore.cpp - On-disk content-addressed store ------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/CAS/ObjectStore.h"
+#include "llvm/Support/BLAKE3.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include <cstring>
+
+using namespace llvm;
+using namespace llvm::cas;
+
+namespace {
+/// The value of an object in the index. The object itself is stored in the
+/// same file at DataOffset: the hashes of its references, followed by its
+/// content and a null terminator.
+struct ObjectLocation {
+  uint64_t DataOffset;
+  uint64_t DataSize;
+  uint64_t NumRefs;
+};
+} // end anonymous namespace
+
+std::unique_ptr<MemoryBuffer>
+ObjectHandle::getMemoryBuffer(StringRef Name) const {
+  return MemoryBuffer::getMemBuffer(Data, Name,
+                                    /*RequiresNullTerminator=*/true);
+}
+
+Expected<std::unique_ptr<ObjectStore>>
+ObjectStore::open(const Twine &Path, uint64_t Capacity) {
+  SmallString<256> IndexPath;
+  Path.toVector(IndexPath);
+  if (std::error_code EC = sys::fs::create_directories(IndexPath))
+    return createFileError(IndexPath, errorCodeToError(EC));
+  sys::path::append(IndexPath, "objects.v1");
+  Expected<OnDiskTrieHashMap> Index = OnDiskTrieHashMap::create(
+      IndexPath, CASID::NumBytes, sizeof(ObjectLocation), Capacity);
+  if (!Index)
+    return Index.takeError();
+  return std::unique_ptr<ObjectStore>(new ObjectStore(std::move(*Index)));
+}
+
+CASID ObjectStore::computeID(ArrayRef<CASID> Refs, StringRef Data) {
+  BLAKE3 Hasher;
+  uint8_t NumRefs[8];
+  support::endian::write64le(NumRefs, Refs.size());
+  Hasher.update(NumRefs);
+  for (const CASID &Ref : Refs)
+    Hasher.update(Ref.getHash());
+  Hasher.update(Data);
+  return CASID(Hasher.final());
+}
+
+Expected<CASID> ObjectStore::store(ArrayRef<CASID> Refs, StringRef Data) {
+  CASID ID = computeID(Refs, Data);
+  if (contains(ID))
+    return ID;
+
+  // Write the object before inserting it into the index, which publishes it.
+  // If another thread or process stores the same object concurrently, one of
+  // the copies is left unused.
+  MappedFileRegionArena &Arena = Index.getArena();
+  uint64_t RefsSize = Refs.size() * CASID::NumBytes;
+  Expected<uint64_t> Offset = Arena.allocateOffset(RefsSize + Data.size() + 1);
+  if (!Offset)
+    return Offset.takeError();
+  char *Ptr = Arena.data() + *Offset;
+  for (const CASID &Ref : Refs) {
+    std::memcpy(Ptr, Ref.getHash().data(), CASID::NumBytes);
+    Ptr += CASID::NumBytes;
+  }
+  std::memcpy(Ptr, Data.data(), Data.size());
+  Ptr[Data.size()] = '\0';
+
+  ObjectLocation Loc{*Offset, Data.size(), Refs.size()};
+  auto Inserted =
+      Index.insertLazy(ID.getHash(), [&](MutableArrayRef<char> Value) {
+        std::memcpy(Value.data(), &Loc, sizeof(Loc));
+      });
+  if (!Inserted)
+    return Inserted.takeError();
+  return ID;
+}
+
+Expected<std::optional<ObjectHandle>>
+ObjectStore::load(const CASID &ID) const {
+  std::optional<OnDiskTrieHashMap::Record> R = Index.find(ID.getHash());
+  if (!R)
+    return std::nullopt;
+  ObjectLocation Loc;
+  std::memcpy(&Loc, R->Value.data(), sizeof(Loc));
+
+  const MappedFileRegionArena &Arena = Index.getArena();
+  uint64_t MaxSize = Arena.capacity();
+  if (Loc.NumRefs > MaxSize / CASID::NumBytes || Loc.DataSize >= MaxSize ||
+      !Arena.isValidRange(Loc.DataOffset, Loc.NumRefs * CASID::NumBytes +
+                                              Loc.DataSize + 1))
+    return createFileError(
+        Arena.getPath(),
+        createStringError(make_error_code(std::errc::invalid_argument),
+                          "corrupt object " + ID.toString()));
+  const char *Ptr = Arena.data() + Loc.DataOffset;
+  const char *Data = Ptr + Loc.NumRefs * CASID::NumBytes;
+  return ObjectHandle(StringRef(Data, Loc.DataSize),
+                      reinterpret_cast<const uint8_t *>(Ptr), Loc.NumRefs);
+}
+
+bool ObjectStore::contains(const CASID &ID) const {
+  return Index.find(ID.getHash()).has_value();
+}
@@ -0,0 +1,232 @@
+//===- OnDiskTrieHashMap.cpp - Lock-free hash trie in a file --------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/CAS/OnDiskTrieHashMap.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/MathExtras.h"
+#include <cstring>
+
+using namespace llvm;
+using namespace llvm::cas;
+
+/// "llvmtrie" in little endian. Change it when the format changes.
+static constexpr uint64_t TrieMagic = 0x656972746d766c6c;
+
+/// Slots pointing to a subtrie have the low bit set. Records and subtries are
+/// allocated at offsets aligned to MappedFileRegionArena::Alignment.
+static constexpr uint64_t SubtrieTag = 1;
+
+struct OnDiskTrieHashMap::TrieHeader {
+  uint32_t HashSize;
+  uint32_t ValueSize;
+  uint32_t RootBits;
+  uint32_t SubtrieBits;
+  uint64_t RootOffset;
+};
+
+static uint64_t getNodeSize(unsigned NumBits) {
+  return sizeof(std::atomic<uint64_t>) << NumBits;
+}
+
+/// Return the \p NumBits bits of \p Hash from \p StartBit on, most significant
+/// bit first.
+static unsigned getBits(ArrayRef<uint8_t> Hash, unsigned StartBit,
+                        unsigned NumBits) {
+  unsigned Index = 0;
+  for (unsigned I = StartBit, E = StartBit + NumBits; I != E; ++I)
+    Index = (Index << 1) | ((Hash[I / 8] >> (7 - I % 8)) & 1);
+  return Index;
+}
+
+Expected<OnDiskTrieHashMap>
+OnDiskTrieHashMap::create(const Twine &Path, size_t HashSize, size_t ValueSize,
+                          uint64_t Capacity, unsigned RootBits,
+                          unsigned SubtrieBits) {
+  assert(HashSize > 0 && RootBits > 0 && RootBits <= 20 && SubtrieBits > 0 &&
+         SubtrieBits <= 20 && "invalid trie parameters");
+  auto NewFileConstructor = [&](MappedFileRegionArena &Arena) -> Error {
+    Expected<uint64_t> HeaderOffset = Arena.allocateOffset(sizeof(TrieHeader));
+    if (!HeaderOffset)
+      return HeaderOffset.takeError();
+    Expected<uint64_t> RootOffset =
+        Arena.allocateOffset(getNodeSize(RootBits));
+    if (!RootOffset)
+      return RootOffset.takeError();
+    auto *H = reinterpret_cast<TrieHeader *>(Arena.data() + *HeaderOffset);
+    *H = {uint32_t(HashSize), uint32_t(ValueSize), RootBits, SubtrieBits,
+          *RootOffset};
+    Arena.setUserHeaderOffset(*HeaderOffset);
+    return Error::success();
+  };
+  Expected<MappedFileRegionArena> Arena = MappedFileRegionArena::create(
+      Path, Capacity, TrieMagic, NewFileConstructor);
+  if (!Arena)
+    return Arena.takeError();
+
+  auto createCorruptError = [&](const Twine &Msg) {
+    return createFileError(
+        Arena->getPath(),
+        createStringError(make_error_code(std::errc::invalid_argument), Msg));
+  };
+  uint64_t HeaderOffset = Arena->getUserHeaderOffset();
+  if (!Arena->isValidRange(HeaderOffset, sizeof(TrieHeader)))
+    return createCorruptError("corrupt trie header");
+  const auto &H =
+      *reinterpret_cast<const TrieHeader *>(Arena->data() + HeaderOffset);
+  if (H.HashSize != HashSize || H.ValueSize != ValueSize)
+    return createCorruptError("trie has hashes of " + Twine(H.HashSize) +
+                              " bytes and values of " + Twine(H.ValueSize) +
+                              " bytes, expected " + Twine(HashSize) +
+                              " and " + Twine(ValueSize));
+  // An existing file keeps its trie parameters.
+  if (H.RootBits == 0 || H.RootBits > 20 || H.SubtrieBits == 0 ||
+      H.SubtrieBits > 20 ||
+      !Arena->isValidRange(H.RootOffset, getNodeSize(H.RootBits)))
+    return createCorruptError("corrupt trie header");
+  return OnDiskTrieHashMap(std::move(*Arena));
+}
+
+OnDiskTrieHashMap::OnDiskTrieHashMap(MappedFileRegionArena Arena)
+    : Arena(std::move(Arena)) {
+  const TrieHeader &H = getTrieHeader();
+  HashSize = H.HashSize;
+  ValueSize = H.ValueSize;
+  RootBits = H.RootBits;
+  SubtrieBits = H.SubtrieBits;
+}
+
+const OnDiskTrieHashMap::TrieHeader &OnDiskTrieHashMap::getTrieHeader() const {
+  return *reinterpret_cast<const TrieHeader *>(Arena.data() +
+                                               Arena.getUserHeaderOffset());
+}
+
+unsigned OnDiskTrieHashMap::getNumBits(unsigned StartBit) const {
+  unsigned Bits = StartBit == 0 ? RootBits : SubtrieBits;
+  return std::min<unsigned>(Bits, HashSize * 8 - StartBit);
+}
+
+std::atomic<uint64_t> &OnDiskTrieHashMap::getSlot(uint64_t Node,
+                                                  ArrayRef<uint8_t> Hash,
+                                                  unsigned StartBit) const {
+  auto *Slots = reinterpret_cast<std::atomic<uint64_t> *>(Arena.data() + Node);
+  return Slots[getBits(Hash, StartBit, getNumBits(StartBit))];
+}
+
+static uint64_t getValueOffset(size_t HashSize) {
+  return alignTo(HashSize, MappedFileRegionArena::Alignment);
+}
+
+OnDiskTrieHashMap::Record OnDiskTrieHashMap::makeRecord(uint64_t Offset) const {
+  char *Data = Arena.data() + Offset;
+  return Record{Offset,
+                ArrayRef(reinterpret_cast<const uint8_t *>(Data), HashSize),
+                MutableArrayRef(Data + getValueOffset(HashSize), ValueSize)};
+}
+
+Error OnDiskTrieHashMap::checkSlot(uint64_t Slot) const {
+  bool IsValid =
+      Slot & SubtrieTag
+          ? Arena.isValidRange(Slot & ~SubtrieTag, getNodeSize(SubtrieBits))
+          : Arena.isValidRange(Slot, getValueOffset(HashSize) + ValueSize);
+  if (IsValid)
+    return Error::success();
+  return createFileError(
+      Arena.getPath(),
+      createStringError(make_error_code(std::errc::invalid_argument),
+                        "corrupt trie slot 0x" + Twine::utohexstr(Slot)));
+}
+
+Expected<OnDiskTrieHashMap::Record>
+OnDiskTrieHashMap::getRecord(uint64_t Offset) const {
+  assert(!(Offset & SubtrieTag) && "not a record offset");
+  if (Error E = checkSlot(Offset))
+    return std::move(E);
+  return makeRecord(Offset);
+}
+
+std::optional<OnDiskTrieHashMap::Record>
+OnDiskTrieHashMap::find(ArrayRef<uint8_t> Hash) const {
+  assert(Hash.size() == HashSize && "wrong hash size");
+  uint64_t Node = getTrieHeader().RootOffset;
+  for (unsigned StartBit = 0; StartBit < HashSize * 8;
+       StartBit += getNumBits(StartBit)) {
+    uint64_t Slot =
+        getSlot(Node, Hash, StartBit).load(std::memory_order_acquire);
+    if (!Slot || errorToBool(checkSlot(Slot)))
+      return std::nullopt;
+    if (Slot & SubtrieTag) {
+      Node = Slot & ~SubtrieTag;
+      continue;
+    }
+    Record R = makeRecord(Slot);
+    if (R.Hash != Hash)
+      return std::nullopt;
+    return R;
+  }
+  return std::nullopt;
+}
+
+Expected<std::pair<OnDiskTrieHashMap::Record, bool>>
+OnDiskTrieHashMap::insertLazy(
+    ArrayRef<uint8_t> Hash,
+    function_ref<void(MutableArrayRef<char> Value)> Construct) {
+  assert(Hash.size() == HashSize && "wrong hash size");
+  uint64_t RecordSize = getValueOffset(HashSize) + ValueSize;
+  // The record to insert, allocated and constructed when the first empty slot
+  // is found.
+  std::optional<Record> NewRecord;
+
+  uint64_t Node = getTrieHeader().RootOffset;
+  unsigned StartBit = 0;
+  while (StartBit < HashSize * 8) {
+    std::atomic<uint64_t> &Slot = getSlot(Node, Hash, StartBit);
+    uint64_t Existing = Slot.load(std::memory_order_acquire);
+    if (!Existing) {
+      if (!NewRecord) {
+        Expected<uint64_t> Offset = Arena.allocateOffset(RecordSize);
+        if (!Offset)
+          return Offset.takeError();
+        NewRecord = makeRecord(*Offset);
+        std::memcpy(Arena.data() + *Offset, Hash.data(), HashSize);
+        Construct(NewRecord->Value);
+      }
+      if (Slot.compare_exchange_strong(Existing, NewRecord->Offset,
+                                       std::memory_order_acq_rel))
+        return std::make_pair(*NewRecord, true);
+      // Another thread or process filled the slot; look at what it stored.
+    }
+    if (Error E = checkSlot(Existing))
+      return std::move(E);
+
+    if (Existing & SubtrieTag) {
+      Node = Existing & ~SubtrieTag;
+      StartBit += getNumBits(StartBit);
+      continue;
+    }
+
+    Record R = makeRecord(Existing);
+    if (R.Hash == Hash)
+      return std::make_pair(R, false);
+
+    // The slot holds a different hash. Push that record down into a new
+    // subtrie and try again with the subtrie in the slot. If the slot changes
+    // in the meantime, the subtrie is abandoned.
+    unsigned NextBit = StartBit + getNumBits(StartBit);
+    assert(NextBit < HashSize * 8 && "distinct hashes with the same bits");
+    Expected<uint64_t> Subtrie =
+        Arena.allocateOffset(getNodeSize(SubtrieBits));
+    if (!Subtrie)
+      return Subtrie.takeError();
+    getSlot(*Subtrie, R.Hash, NextBit).store(Existing,
+                                             std::memory_order_relaxed);
+    Slot.compare_exchange_strong(Existing, *Subtrie | SubtrieTag,
+                                 std::memory_order_acq_rel);
+  }
+  llvm_unreachable("ran out of hash bits");
+}
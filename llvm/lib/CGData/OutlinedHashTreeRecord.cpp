@@ -72,27 +72,68 @@ void OutlinedHashTreeRecord::serialize(raw_ostream &OS) const {
 }
 
 void OutlinedHashTreeRecord::deserialize(const unsigned char *&Ptr) {
-  IdHashNodeStableMapTy IdNodeStableMap;
+  // Read the nodes into flat arrays and build the tree from them directly,
+  // instead of going through an IdHashNodeStableMapTy that allocates a map
+  // entry and a successor vector per node.
+  struct NodeRecord {
+    stable_hash Hash;
+    unsigned Terminals;
+    unsigned SuccessorBegin;
+    unsigned SuccessorEnd;
+  };
+  SmallVector<NodeRecord> Records;
+  SmallVector<unsigned> SuccessorIds;
+  DenseMap<unsigned, unsigned> IdToRecord;
+
   auto NumIdNodeStableMap =
       endian::readNext<uint32_t, endianness::little, unaligned>(Ptr);
+  Records.reserve(NumIdNodeStableMap);
+  IdToRecord.reserve(NumIdNodeStableMap);
 
   for (unsigned I = 0; I < NumIdNodeStableMap; ++I) {
     auto Id = endian::readNext<uint32_t, endianness::little, unaligned>(Ptr);
-    HashNodeStable NodeStable;
-    NodeStable.Hash =
+    NodeRecord Record;
+    Record.Hash =
         endian::readNext<uint64_t, endianness::little, unaligned>(Ptr);
-    NodeStable.Terminals =
+    Record.Terminals =
         endian::readNext<uint32_t, endianness::little, unaligned>(Ptr);
     auto NumSuccessorIds =
         endian::readNext<uint32_t, endianness::little, unaligned>(Ptr);
+    Record.SuccessorBegin = SuccessorIds.size();
     for (unsigned J = 0; J < NumSuccessorIds; ++J)
-      NodeStable.SuccessorIds.push_back(
+      SuccessorIds.push_back(
           endian::readNext<uint32_t, endianness::little, unaligned>(Ptr));
+    Record.SuccessorEnd = SuccessorIds.size();
 
-    IdNodeStableMap[Id] = std::move(NodeStable);
+    IdToRecord[Id] = Records.size();
+    Records.push_back(Record);
   }
 
-  convertFromStableData(IdNodeStableMap);
+  // The root node is at 0.
+  assert(HashTree->getRoot()->Successors.empty());
+  auto RootI = IdToRecord.find(0);
+  if (RootI == IdToRecord.end())
+    return;
+
+  SmallVector<std::pair<HashNode *, unsigned>> Worklist;
+  Worklist.emplace_back(HashTree->getRoot(), RootI->second);
+  while (!Worklist.empty()) {
+    auto [Curr, RecordIndex] = Worklist.pop_back_val();
+    const NodeRecord &Record = Records[RecordIndex];
+    Curr->Hash = Record.Hash;
+    if (Record.Terminals)
+      Curr->Terminals = Record.Terminals;
+    auto &Successors = Curr->Successors;
+    assert(Successors.empty());
+    Successors.reserve(Record.SuccessorEnd - Record.SuccessorBegin);
+    for (unsigned I = Record.SuccessorBegin; I != Record.SuccessorEnd; ++I) {
+      assert(IdToRecord.count(SuccessorIds[I]));
+      unsigned SuccessorIndex = IdToRecord.lookup(SuccessorIds[I]);
+      auto Sucessor = std::make_unique<HashNode>();
+      Worklist.emplace_back(Sucessor.get(), SuccessorIndex);
+      Successors[Records[SuccessorIndex].Hash] = std::move(Sucessor);
+    }
+  }
 }
 
 void OutlinedHashTreeRecord::serializeYAML(yaml::Output &YOS) const {
@@ -12,6 +12,7 @@
 
 #include "InterferenceCache.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/CodeGen/LiveIntervals.h"
 #include "llvm/CodeGen/MachineBasicBlock.h"
 #include "llvm/CodeGen/MachineFunction.h"
@@ -27,6 +28,9 @@ using namespace llvm;
 
 #define DEBUG_TYPE "regalloc"
 
+STATISTIC(NumCacheHits, "Number of interference cache hits");
+STATISTIC(NumCacheMisses, "Number of interference cache misses");
+
 // Static member used for null interference cursors.
 const InterferenceCache::BlockInterference
     InterferenceCache::Cursor::NoInterference;
@@ -58,15 +62,23 @@ void InterferenceCache::init(MachineFunction *mf,
   reinitPhysRegEntries();
   for (Entry &E : Entries)
     E.clear(mf, indexes, lis);
+  NumHits = NumRevalidations = NumMisses = 0;
 }
 
 InterferenceCache::Entry *InterferenceCache::get(MCRegister PhysReg) {
   unsigned char E = PhysRegEntries[PhysReg.id()];
   if (E < CacheEntries && Entries[E].getPhysReg() == PhysReg) {
-    if (!Entries[E].valid(LIUArray, TRI))
+    if (!Entries[E].valid(LIUArray, TRI)) {
       Entries[E].revalidate(LIUArray, TRI);
+      ++NumRevalidations;
+    } else {
+      ++NumHits;
+      ++NumCacheHits;
+    }
     return &Entries[E];
   }
+  ++NumMisses;
+  ++NumCacheMisses;
   // No valid entry exists, pick the next round-robin entry.
   E = RoundRobin;
   if (++RoundRobin == CacheEntries)
@@ -148,6 +148,12 @@ class LLVM_LIBRARY_VISIBILITY InterferenceCache {
   // Next round-robin entry to be picked.
   unsigned RoundRobin = 0;
 
+  // Lookups of the current function that found an up to date entry, had to
+  // revalidate it, or had to reuse another entry.
+  unsigned NumHits = 0;
+  unsigned NumRevalidations = 0;
+  unsigned NumMisses = 0;
+
   // The actual cache entries.
   Entry Entries[CacheEntries];
 
@@ -173,6 +179,12 @@ public:
   /// be supported.
   unsigned getMaxCursors() const { return CacheEntries; }
 
+  /// Return the number of lookups in the current function that found a valid
+  /// entry, found an outdated one, and had to recompute an entry from scratch.
+  unsigned getNumHits() const { return NumHits; }
+  unsigned getNumRevalidations() const { return NumRevalidations; }
+  unsigned getNumMisses() const { return NumMisses; }
+
   /// Cursor - The primary query interface for the block interference cache.
   class Cursor {
     Entry *CacheEntry = nullptr;
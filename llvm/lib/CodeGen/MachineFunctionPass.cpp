@@ -24,14 +24,20 @@
 #include "llvm/CodeGen/MachineModuleInfo.h"
 #include "llvm/CodeGen/MachineOptimizationRemarkEmitter.h"
 #include "llvm/CodeGen/Passes.h"
+#include "llvm/IR/DiagnosticHandler.h"
 #include "llvm/IR/Dominators.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/PrintPasses.h"
+#include <chrono>
 
 using namespace llvm;
 using namespace ore;
 
+/// The remark pass name that enables per-pass, per-function profiling, e.g.
+/// with -pass-remarks-analysis=machine-pass-profile.
+static const char ProfileRemarkPass[] = "machine-pass-profile";
+
 Pass *MachineFunctionPass::createPrinterPass(raw_ostream &O,
                                              const std::string &Banner) const {
   return createMachineFunctionPrinterPass(O, Banner);
@@ -67,9 +73,15 @@ bool MachineFunctionPass::runOnFunction(Function &F) {
   bool ShouldEmitSizeRemarks =
       F.getParent()->shouldEmitInstrCountChangedRemark();
 
+  // Check if the user asked for the time and MI counts of every pass on every
+  // function, to find the functions that make a pass slow.
+  bool ShouldProfile =
+      F.getContext().getDiagHandlerPtr()->isAnalysisRemarkEnabled(
+          ProfileRemarkPass);
+
   // If we want size remarks, collect the number of MachineInstrs in our
   // MachineFunction before the pass runs.
-  if (ShouldEmitSizeRemarks)
+  if (ShouldEmitSizeRemarks || ShouldProfile)
     CountBefore = MF.getInstructionCount();
 
   // For --print-changed, if the function name is a candidate, save the
@@ -91,8 +103,30 @@ bool MachineFunctionPass::runOnFunction(Function &F) {
 
   MFProps.reset(ClearedProperties);
 
+  std::chrono::steady_clock::time_point Start;
+  if (ShouldProfile)
+    Start = std::chrono::steady_clock::now();
+
   bool RV = runOnMachineFunction(MF);
 
+  if (ShouldProfile && !MF.empty()) {
+    auto Time = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - Start);
+    CountAfter = MF.getInstructionCount();
+    MachineOptimizationRemarkEmitter MORE(MF, nullptr);
+    MORE.emit([&]() {
+      MachineOptimizationRemarkAnalysis R(ProfileRemarkPass, "PassProfile",
+                                          MF.getFunction().getSubprogram(),
+                                          &MF.front());
+      R << NV("Pass", getPassName()) << ": Function: "
+        << NV("Function", F.getName()) << ": " << NV("TimeUS", Time.count())
+        << " us, MI Instruction count changed from "
+        << NV("MIInstrsBefore", CountBefore) << " to "
+        << NV("MIInstrsAfter", CountAfter);
+      return R;
+    });
+  }
+
   if (ShouldEmitSizeRemarks) {
     // We wanted size remarks. Check if there was a change to the number of
     // MachineInstrs in the module. Emit a remark if there was a change.
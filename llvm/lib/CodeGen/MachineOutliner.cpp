@@ -75,6 +75,7 @@
 #include "llvm/InitializePasses.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/SuffixArray.h"
 #include "llvm/Support/SuffixTree.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Transforms/Utils/ModuleUtils.h"
@@ -135,6 +136,18 @@ static cl::opt<bool> OutlinerLeafDescendants(
              "tree as candidates for outlining (if false, only leaf children "
              "are considered)"));
 
+static cl::opt<bool> OutlinerSuffixArray(
+    "machine-outliner-suffix-array", cl::init(false), cl::Hidden,
+    cl::desc("Find repeated instruction sequences with a suffix array rather "
+             "than a suffix tree, which takes much less memory on large "
+             "modules (requires -outliner-leaf-descendants)"));
+
+static cl::opt<unsigned> OutlinerMaxFunctionsPerRound(
+    "machine-outliner-max-functions-per-round", cl::init(0), cl::Hidden,
+    cl::desc("The maximum number of functions to create in one outlining "
+             "round; the remaining candidates are left to later rounds "
+             "(see -machine-outliner-reruns). 0 means no limit."));
+
 static cl::opt<bool>
     DisableGlobalOutlining("disable-global-outlining", cl::Hidden,
                            cl::desc("Disable global outlining only by ignoring "
@@ -746,7 +759,6 @@ void MachineOutliner::findCandidates(
     InstructionMapper &Mapper,
     std::vector<std::unique_ptr<OutlinedFunction>> &FunctionList) {
   FunctionList.clear();
-  SuffixTree ST(Mapper.UnsignedVec, OutlinerLeafDescendants);
 
   // First, find all of the repeated substrings in the tree of minimum length
   // 2.
@@ -754,7 +766,7 @@ void MachineOutliner::findCandidates(
   LLVM_DEBUG(dbgs() << "*** Discarding overlapping candidates *** \n");
   LLVM_DEBUG(
       dbgs() << "Searching for overlaps in all repeated sequences...\n");
-  for (SuffixTree::RepeatedSubstring &RS : ST) {
+  auto FindCandidatesForRepeatedSeq = [&](SuffixTree::RepeatedSubstring &RS) {
     CandidatesForRepeatedSeq.clear();
     unsigned StringLen = RS.Length;
     LLVM_DEBUG(dbgs() << "  Sequence length: " << StringLen << "\n");
@@ -825,7 +837,7 @@ void MachineOutliner::findCandidates(
     // Create an OutlinedFunction to store it and check if it'd be beneficial
     // to outline.
     if (CandidatesForRepeatedSeq.size() < MinRepeats)
-      continue;
+      return;
 
     // Arbitrarily choose a TII from the first candidate.
     // FIXME: Should getOutliningCandidateInfo move to TargetMachine?
@@ -839,17 +851,29 @@ void MachineOutliner::findCandidates(
     // If we deleted too many candidates, then there's nothing worth outlining.
     // FIXME: This should take target-specified instruction sizes into account.
     if (!OF.has_value() || OF.value()->Candidates.size() < MinRepeats)
-      continue;
+      return;
 
     // Is it better to outline this candidate than not?
     if (OF.value()->getBenefit() < OutlinerBenefitThreshold) {
       emitNotOutliningCheaperRemark(StringLen, CandidatesForRepeatedSeq,
                                     *OF.value());
-      continue;
+      return;
     }
 
     FunctionList.emplace_back(std::move(OF.value()));
+  };
+
+  // A suffix array finds the same repeated substrings as a suffix tree with
+  // leaf descendants, in a fraction of the memory.
+  if (OutlinerSuffixArray && OutlinerLeafDescendants) {
+    SuffixArray SA(Mapper.UnsignedVec);
+    for (SuffixArray::RepeatedSubstring &RS : SA)
+      FindCandidatesForRepeatedSeq(RS);
+    return;
   }
+  SuffixTree ST(Mapper.UnsignedVec, OutlinerLeafDescendants);
+  for (SuffixTree::RepeatedSubstring &RS : ST)
+    FindCandidatesForRepeatedSeq(RS);
 }
 
 void MachineOutliner::computeAndPublishHashSequence(MachineFunction &MF,
@@ -1044,8 +1068,16 @@ bool MachineOutliner::outline(
   // Walk over each function, outlining them as we go along. Functions are
   // outlined greedily, based off the sort above.
   auto *UnsignedVecBegin = Mapper.UnsignedVec.begin();
+  unsigned NumCreated = 0;
   LLVM_DEBUG(dbgs() << "WALKING FUNCTION LIST\n");
   for (auto &OF : FunctionList) {
+    // Leave the remaining candidates to the next round.
+    if (OutlinerMaxFunctionsPerRound &&
+        NumCreated == OutlinerMaxFunctionsPerRound) {
+      LLVM_DEBUG(dbgs() << "STOP: Created " << NumCreated
+                        << " functions in this round\n");
+      break;
+    }
 #ifndef NDEBUG
     auto NumCandidatesBefore = OF->Candidates.size();
 #endif
@@ -1081,6 +1113,7 @@ bool MachineOutliner::outline(
     OF->MF = createOutlinedFunction(M, *OF, Mapper, OutlinedFunctionNum);
     emitOutlinedFunctionRemark(*OF);
     FunctionsCreated++;
+    NumCreated++;
     OutlinedFunctionNum++; // Created a function, move to the next name.
     MachineFunction *MF = OF->MF;
     const TargetSubtargetInfo &STI = MF->getSubtarget();
@@ -81,6 +81,8 @@ using namespace llvm;
 STATISTIC(NumGlobalSplits, "Number of split global live ranges");
 STATISTIC(NumLocalSplits,  "Number of split local live ranges");
 STATISTIC(NumEvicted,      "Number of interferences evicted");
+STATISTIC(NumRegionSplitsSkipped,
+          "Number of region splits skipped over the budget");
 
 static cl::opt<SplitEditor::ComplementSpillMode> SplitSpillMode(
     "split-spill-mode", cl::Hidden,
@@ -127,6 +129,13 @@ static cl::opt<unsigned long> GrowRegionComplexityBudget(
              "limit its budget and bail out once we reach the limit."),
     cl::init(10000), cl::Hidden);
 
+static cl::opt<unsigned long> RegionSplitBudget(
+    "greedy-region-split-budget",
+    cl::desc("Once the region split candidates of a function visited this "
+             "many blocks, split its live ranges around blocks instead, which "
+             "is cheaper (0 means no limit)."),
+    cl::init(0), cl::Hidden);
+
 static cl::opt<bool> GreedyRegClassPriorityTrumpsGlobalness(
     "greedy-regclass-priority-trumps-globalness",
     cl::desc("Change the greedy register allocator's live range priority "
@@ -146,6 +155,26 @@ static cl::opt<unsigned> SplitThresholdForRegWithHint(
              "percentate"),
     cl::init(75), cl::Hidden);
 
+namespace {
+/// Adds the time spent in its scope to a duration, if enabled.
+class WorkTimer {
+  std::chrono::steady_clock::duration *Time = nullptr;
+  std::chrono::steady_clock::time_point Start;
+
+public:
+  WorkTimer(bool Enabled, std::chrono::steady_clock::duration &Time) {
+    if (!Enabled)
+      return;
+    this->Time = &Time;
+    Start = std::chrono::steady_clock::now();
+  }
+  ~WorkTimer() {
+    if (Time)
+      *Time += std::chrono::steady_clock::now() - Start;
+  }
+};
+} // end anonymous namespace
+
 static RegisterRegAlloc greedyRegAlloc("greedy", "greedy register allocator",
                                        createGreedyRegisterAllocator);
 
@@ -513,6 +542,7 @@ void RAGreedy::evictInterference(const LiveInterval &VirtReg,
            "Cannot decrease cascade number, illegal eviction");
     ExtraInfo->setCascade(Intf->reg(), Cascade);
     ++NumEvicted;
+    ++Work.Evictions;
     NewVRegs.push_back(Intf->reg());
   }
 }
@@ -581,6 +611,7 @@ MCRegister RAGreedy::tryEvict(const LiveInterval &VirtReg,
                               const SmallVirtRegSet &FixedRegisters) {
   NamedRegionTimer T("evict", "Evict", TimerGroupName, TimerGroupDescription,
                      TimePassesIsEnabled);
+  WorkTimer WT(TimeWork, Work.EvictTime);
 
   MCRegister BestPhys = EvictAdvisor->tryFindEvictionCandidate(
       VirtReg, Order, CostPerUseLimit, FixedRegisters);
@@ -1062,6 +1093,7 @@ MCRegister RAGreedy::tryRegionSplit(const LiveInterval &VirtReg,
                                     SmallVectorImpl<Register> &NewVRegs) {
   if (!TRI->shouldRegionSplitForVirtReg(*MF, VirtReg))
     return MCRegister::NoRegister;
+  WorkTimer WT(TimeWork, Work.RegionSplitTime);
   unsigned NumCands = 0;
   BlockFrequency SpillCost = calcSpillCost();
   BlockFrequency BestCost;
@@ -1087,6 +1119,7 @@ MCRegister RAGreedy::tryRegionSplit(const LiveInterval &VirtReg,
   if (!HasCompact && BestCand == NoCand)
     return MCRegister::NoRegister;
 
+  ++Work.RegionSplits;
   return doRegionSplit(VirtReg, BestCand, HasCompact, NewVRegs);
 }
 
@@ -1120,6 +1153,9 @@ RAGreedy::calculateRegionSplitCostAroundReg(MCPhysReg PhysReg,
     GlobalCand.resize(NumCands+1);
   GlobalSplitCandidate &Cand = GlobalCand[NumCands];
   Cand.reset(IntfCache, PhysReg);
+  ++Work.RegionSplitCandidates;
+  Work.RegionSplitCost +=
+      SA->getUseBlocks().size() + SA->getNumThroughBlocks();
 
   SpillPlacer->prepare(Cand.LiveBundles);
   BlockFrequency Cost;
@@ -1820,11 +1856,17 @@ unsigned RAGreedy::trySplit(const LiveInterval &VirtReg, AllocationOrder &Order,
 
   // First try to split around a region spanning multiple blocks. RS_Split2
   // ranges already made dubious progress with region splitting, so they go
-  // straight to single block splitting.
+  // straight to single block splitting, as do all ranges once region
+  // splitting exceeded its budget.
   if (ExtraInfo->getStage(VirtReg) < RS_Split2) {
-    MCRegister PhysReg = tryRegionSplit(VirtReg, Order, NewVRegs);
-    if (PhysReg || !NewVRegs.empty())
-      return PhysReg;
+    if (overRegionSplitBudget()) {
+      ++NumRegionSplitsSkipped;
+      ++Work.RegionSplitsSkipped;
+    } else {
+      MCRegister PhysReg = tryRegionSplit(VirtReg, Order, NewVRegs);
+      if (PhysReg || !NewVRegs.empty())
+        return PhysReg;
+    }
   }
 
   // Then isolate blocks.
@@ -2691,6 +2733,44 @@ void RAGreedy::reportStats() {
   }
 }
 
+bool RAGreedy::overRegionSplitBudget() const {
+  return RegionSplitBudget && Work.RegionSplitCost >= RegionSplitBudget;
+}
+
+void RAGreedy::reportWork() {
+  using namespace ore;
+  auto ToMicroseconds = [](std::chrono::steady_clock::duration D) {
+    return uint64_t(
+        std::chrono::duration_cast<std::chrono::microseconds>(D).count());
+  };
+  ORE->emit([&]() {
+    DebugLoc Loc;
+    if (auto *SP = MF->getFunction().getSubprogram())
+      Loc = DILocation::get(SP->getContext(), SP->getLine(), 1, SP);
+    MachineOptimizationRemarkAnalysis R(DEBUG_TYPE, "RegAllocWork", Loc,
+                                        &MF->front());
+    R << NV("Evictions", Work.Evictions) << " evictions in "
+      << NV("EvictionChains", ExtraInfo->getNumCascades())
+      << " eviction chains in "
+      << NV("EvictTimeUS", ToMicroseconds(Work.EvictTime)) << " us, "
+      << NV("RegionSplits", Work.RegionSplits)
+      << " region splits from "
+      << NV("RegionSplitCandidates", Work.RegionSplitCandidates)
+      << " candidates visiting "
+      << NV("RegionSplitCost", Work.RegionSplitCost) << " blocks in "
+      << NV("RegionSplitTimeUS", ToMicroseconds(Work.RegionSplitTime))
+      << " us, " << NV("RegionSplitsSkipped", Work.RegionSplitsSkipped)
+      << " region splits skipped over the budget, "
+      << NV("InterferenceCacheHits", IntfCache.getNumHits())
+      << " interference cache hits, "
+      << NV("InterferenceCacheRevalidations", IntfCache.getNumRevalidations())
+      << " revalidations and "
+      << NV("InterferenceCacheMisses", IntfCache.getNumMisses())
+      << " misses";
+    return R;
+  });
+}
+
 bool RAGreedy::hasVirtRegAlloc() {
   for (unsigned I = 0, E = MRI->getNumVirtRegs(); I != E; ++I) {
     Register Reg = Register::index2VirtReg(I);
@@ -2732,6 +2812,8 @@ bool RAGreedy::runOnMachineFunction(MachineFunction &mf) {
   MBFI = &getAnalysis<MachineBlockFrequencyInfoWrapperPass>().getMBFI();
   DomTree = &getAnalysis<MachineDominatorTreeWrapperPass>().getDomTree();
   ORE = &getAnalysis<MachineOptimizationRemarkEmitterPass>().getORE();
+  Work = RAGreedyWork();
+  TimeWork = ORE->allowExtraAnalysis(DEBUG_TYPE);
   Loops = &getAnalysis<MachineLoopInfoWrapperPass>().getLI();
   Bundles = &getAnalysis<EdgeBundles>();
   SpillPlacer = &getAnalysis<SpillPlacement>();
@@ -2776,6 +2858,7 @@ bool RAGreedy::runOnMachineFunction(MachineFunction &mf) {
     MF->verify(this, "Before post optimization", &errs());
   postOptimization();
   reportStats();
+  reportWork();
 
   releaseMemory();
   return true;
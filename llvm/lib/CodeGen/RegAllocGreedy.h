@@ -33,6 +33,7 @@
 #include "llvm/CodeGen/Spiller.h"
 #include "llvm/CodeGen/TargetRegisterInfo.h"
 #include <algorithm>
+#include <chrono>
 #include <cstdint>
 #include <memory>
 #include <queue>
@@ -119,6 +120,9 @@ public:
       return Cascade;
     }
 
+    /// Return the number of eviction chains started so far.
+    unsigned getNumCascades() const { return NextCascade - 1; }
+
     unsigned getCascadeOrCurrentNext(Register Reg) const {
       unsigned Cascade = getCascade(Reg);
       if (!Cascade)
@@ -450,6 +454,34 @@ private:
 
   /// Report the statistic for each loop.
   void reportStats();
+
+  /// The work done on the current function, to find out where the compile
+  /// time goes through a remark.
+  struct RAGreedyWork {
+    unsigned Evictions = 0;
+    unsigned RegionSplits = 0;
+    unsigned RegionSplitCandidates = 0;
+    /// The blocks visited while computing the cost of region split
+    /// candidates, which bounds the region splitting work.
+    uint64_t RegionSplitCost = 0;
+    /// The live ranges for which region splitting was skipped because it
+    /// exceeded its budget.
+    unsigned RegionSplitsSkipped = 0;
+    /// The time spent evicting and region splitting, if measured.
+    std::chrono::steady_clock::duration EvictTime{};
+    std::chrono::steady_clock::duration RegionSplitTime{};
+  };
+  RAGreedyWork Work;
+
+  /// Whether to measure the times in Work, only done if its remark is
+  /// enabled.
+  bool TimeWork = false;
+
+  /// Return true if region splitting exceeded its budget in this function.
+  bool overRegionSplitBudget() const;
+
+  /// Report Work through a remark.
+  void reportWork();
 };
 } // namespace llvm
 #endif // #ifndef LLVM_CODEGEN_REGALLOCGREEDY_H_
@@ -61,6 +61,7 @@
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/DebugCounter.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/HotPathTrace.h"
 #include "llvm/Support/KnownBits.h"
 #include "llvm/Support/MathExtras.h"
 #include "llvm/Support/raw_ostream.h"
@@ -1783,6 +1784,7 @@ void DAGCombiner::Run(CombineLevel AtLevel) {
       AddToWorklist(ChildN.getNode(), /*IsCandidateForPruning=*/true,
                     /*SkipIfCombinedBefore=*/true);
 
+    LLVM_HOT_PATH_TRACE_SCOPE("DAGCombine", N->getOpcode());
     SDValue RV = combine(N);
 
     if (!RV.getNode())
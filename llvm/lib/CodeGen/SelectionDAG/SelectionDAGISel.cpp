@@ -3352,19 +3352,14 @@ void SelectionDAGISel::SelectCodeCommon(SDNode *NodeToMatch,
   // Determine where to start the interpreter.  Normally we start at opcode #0,
   // but if the state machine starts with an OPC_SwitchOpcode, then we
   // accelerate the first lookup (which is guaranteed to be hot) with the
-  // OpcodeOffset table.
+  // OpcodeOffset table.  If the case of the opcode starts with an
+  // OPC_SwitchType in turn, the OpcodeTypeOffset table skips that one too.
   unsigned MatcherIndex = 0;
 
-  if (!OpcodeOffset.empty()) {
-    // Already computed the OpcodeOffset table, just index into it.
-    if (N.getOpcode() < OpcodeOffset.size())
-      MatcherIndex = OpcodeOffset[N.getOpcode()];
-    LLVM_DEBUG(dbgs() << "  Initial Opcode index to " << MatcherIndex << "\n");
-
-  } else if (MatcherTable[0] == OPC_SwitchOpcode) {
-    // Otherwise, the table isn't computed, but the state machine does start
-    // with an OPC_SwitchOpcode instruction.  Populate the table now, since this
-    // is the first time we're selecting an instruction.
+  if (OpcodeOffset.empty() && MatcherTable[0] == OPC_SwitchOpcode) {
+    // The table isn't computed, but the state machine does start with an
+    // OPC_SwitchOpcode instruction.  Populate the table now, since this is the
+    // first time we're selecting an instruction.
     unsigned Idx = 1;
     while (true) {
       // Get the size of this case.
@@ -3382,9 +3377,49 @@ void SelectionDAGISel::SelectCodeCommon(SDNode *NodeToMatch,
       Idx += CaseSize;
     }
 
-    // Okay, do the lookup for the first opcode.
-    if (N.getOpcode() < OpcodeOffset.size())
-      MatcherIndex = OpcodeOffset[N.getOpcode()];
+    // Index the cases of the OPC_SwitchType instructions that the opcode
+    // cases start with by type.  The cases of a type switch are disjoint, so
+    // jumping straight into one of them doesn't change what is matched.
+    OpcodeTypeOffset.resize(OpcodeOffset.size());
+    for (unsigned Opc = 0, E = OpcodeOffset.size(); Opc != E; ++Opc) {
+      Idx = OpcodeOffset[Opc];
+      if (Idx == 0 || MatcherTable[Idx] != OPC_SwitchType)
+        continue;
+      std::vector<unsigned> &TypeOffset = OpcodeTypeOffset[Opc];
+      ++Idx;
+      while (true) {
+        unsigned CaseSize = MatcherTable[Idx++];
+        if (CaseSize & 128)
+          CaseSize = GetVBR(CaseSize, MatcherTable, Idx);
+        if (CaseSize == 0) break;
+
+        MVT CaseVT = getSimpleVT(MatcherTable, Idx);
+        if (CaseVT == MVT::iPTR)
+          CaseVT = TLI->getPointerTy(CurDAG->getDataLayout());
+        if (CaseVT.SimpleTy >= TypeOffset.size())
+          TypeOffset.resize(CaseVT.SimpleTy + 1);
+        // Like OPC_SwitchType, prefer the first case of a type.
+        if (TypeOffset[CaseVT.SimpleTy] == 0)
+          TypeOffset[CaseVT.SimpleTy] = Idx;
+        Idx += CaseSize;
+      }
+    }
+  }
+
+  if (N.getOpcode() < OpcodeOffset.size()) {
+    MatcherIndex = OpcodeOffset[N.getOpcode()];
+    LLVM_DEBUG(dbgs() << "  Initial Opcode index to " << MatcherIndex << "\n");
+
+    // If the type isn't one of the cases, let OPC_SwitchType bail out.
+    const std::vector<unsigned> &TypeOffset = OpcodeTypeOffset[N.getOpcode()];
+    if (!TypeOffset.empty()) {
+      MVT::SimpleValueType VT = N.getSimpleValueType().SimpleTy;
+      if (VT < TypeOffset.size() && TypeOffset[VT] != 0) {
+        MatcherIndex = TypeOffset[VT];
+        LLVM_DEBUG(dbgs() << "  Initial Type index to " << MatcherIndex
+                          << "\n");
+      }
+    }
   }
 
   while (true) {
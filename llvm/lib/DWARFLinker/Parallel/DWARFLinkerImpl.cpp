@@ -865,8 +865,13 @@ void DWARFLinkerImpl::glueCompileUnitsAndWriteToTheOutput() {
   // units into the resulting file.
   emitCommonSectionsAndWriteCompileUnitsToTheOutput();
 
-  if (ArtificialTypeUnit != nullptr)
+  if (ArtificialTypeUnit != nullptr) {
+    if (std::optional<SectionDescriptor *> DebugInfo =
+            ArtificialTypeUnit->tryGetSectionDescriptor(
+                DebugSectionKind::DebugInfo))
+      TypeUnitDebugInfoSize = (*DebugInfo)->getContents().size();
     ArtificialTypeUnit.reset();
+  }
 
   // Write common debug sections into the resulting file.
   writeCommonSectionsToTheOutput();
@@ -934,6 +939,13 @@ void DWARFLinkerImpl::printStatistic() {
         FormatStr, sys::path::filename(E.first).take_back(45), E.second.Input,
         E.second.Output, ComputePercentange(E.second.Input, E.second.Output));
   }
+  // Types deduplicated across object files are emitted into the type unit
+  // rather than into the units of any one object.
+  if (TypeUnitDebugInfoSize) {
+    OutputTotal += TypeUnitDebugInfoSize;
+    llvm::outs() << formatv(FormatStr, "<type unit>", 0, TypeUnitDebugInfoSize,
+                            ComputePercentange(0, TypeUnitDebugInfoSize));
+  }
   // Print total and footer.
   outs() << "----------------------------------------------------------------"
             "---------------\n";
@@ -347,6 +347,10 @@ protected:
   std::unique_ptr<TypeUnit> ArtificialTypeUnit;
   /// @}
 
+  /// Size of the .debug_info of the type unit, which holds the types
+  /// deduplicated across all object files.
+  uint64_t TypeUnitDebugInfoSize = 0;
+
   /// \defgroup Data members accessed sequentially.
   ///
   /// @{
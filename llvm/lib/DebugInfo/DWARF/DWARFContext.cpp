@@ -53,6 +53,7 @@
 #include "llvm/Support/Path.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <deque>
 #include <map>
@@ -248,6 +249,19 @@ DWARFContext::DWARFContextState::parseMacroOrMacinfo(MacroSecType SectionType) {
 }
 
 namespace {
+/// Returns the offset of U's line table in its line section, if it has one.
+std::optional<uint64_t> getStmtListOffset(DWARFUnit *U) {
+  auto UnitDIE = U->getUnitDIE();
+  if (!UnitDIE)
+    return std::nullopt;
+
+  auto Offset = toSectionOffset(UnitDIE.find(DW_AT_stmt_list));
+  if (!Offset)
+    return std::nullopt; // No line table for this compile unit.
+
+  return *Offset + U->getLineTableOffset();
+}
+
 class ThreadUnsafeDWARFContextState : public DWARFContext::DWARFContextState {
 
   DWARFUnitVector NormalUnits;
@@ -400,15 +414,11 @@ public:
     if (!Line)
       Line = std::make_unique<DWARFDebugLine>();
 
-    auto UnitDIE = U->getUnitDIE();
-    if (!UnitDIE)
-      return nullptr;
-
-    auto Offset = toSectionOffset(UnitDIE.find(DW_AT_stmt_list));
+    std::optional<uint64_t> Offset = getStmtListOffset(U);
     if (!Offset)
-      return nullptr; // No line table for this compile unit.
+      return nullptr;
 
-    uint64_t stmtOffset = *Offset + U->getLineTableOffset();
+    uint64_t stmtOffset = *Offset;
     // See if the line table is cached.
     if (const DWARFLineTable *lt = Line->getLineTable(stmtOffset))
       return lt;
@@ -429,16 +439,8 @@ public:
     if (!Line)
       return;
 
-    auto UnitDIE = U->getUnitDIE();
-    if (!UnitDIE)
-      return;
-
-    auto Offset = toSectionOffset(UnitDIE.find(DW_AT_stmt_list));
-    if (!Offset)
-      return;
-
-    uint64_t stmtOffset = *Offset + U->getLineTableOffset();
-    Line->clearLineTable(stmtOffset);
+    if (std::optional<uint64_t> Offset = getStmtListOffset(U))
+      Line->clearLineTable(*Offset);
   }
 
   Expected<const DWARFDebugFrame *> getDebugFrame() override {
@@ -630,6 +632,17 @@ public:
 class ThreadSafeState : public ThreadUnsafeDWARFContextState {
   std::recursive_mutex Mutex;
 
+  /// Line tables are parsed under a lock of their own rather than under Mutex,
+  /// so that threads can parse the line tables of different units at the same
+  /// time.
+  struct LineTableEntry {
+    std::atomic<bool> Parsed = false;
+    std::mutex ParseMutex;
+    DWARFDebugLine::LineTable Table;
+  };
+  std::mutex LineTablesMutex;
+  DenseMap<uint64_t, std::unique_ptr<LineTableEntry>> LineTables;
+
 public:
   ThreadSafeState(DWARFContext &DC, std::string &DWP) :
       ThreadUnsafeDWARFContextState(DC, DWP) {}
@@ -676,12 +689,43 @@ public:
   }
   Expected<const DWARFDebugLine::LineTable *>
   getLineTableForUnit(DWARFUnit *U, function_ref<void(Error)> RecoverableErrorHandler) override {
-    std::unique_lock<std::recursive_mutex> LockGuard(Mutex);
-    return ThreadUnsafeDWARFContextState::getLineTableForUnit(U, RecoverableErrorHandler);
+    std::optional<uint64_t> Offset = getStmtListOffset(U);
+    // Make sure the offset is good before we try to parse.
+    if (!Offset || *Offset >= U->getLineSection().Data.size())
+      return nullptr;
+
+    LineTableEntry *Entry;
+    {
+      std::lock_guard<std::mutex> Lock(LineTablesMutex);
+      auto &E = LineTables[*Offset];
+      if (!E)
+        E = std::make_unique<LineTableEntry>();
+      Entry = E.get();
+    }
+
+    if (!Entry->Parsed.load(std::memory_order_acquire)) {
+      std::lock_guard<std::mutex> Lock(Entry->ParseMutex);
+      if (!Entry->Parsed.load(std::memory_order_relaxed)) {
+        DWARFDataExtractor Data(U->getContext().getDWARFObj(),
+                                U->getLineSection(), U->isLittleEndian(),
+                                U->getAddressByteSize());
+        uint64_t ParseOffset = *Offset;
+        Error Err = Entry->Table.parse(Data, &ParseOffset, U->getContext(), U,
+                                       RecoverableErrorHandler);
+        // As in DWARFDebugLine, a table that fails to parse is still cached
+        // and the error is only reported once.
+        Entry->Parsed.store(true, std::memory_order_release);
+        if (Err)
+          return std::move(Err);
+      }
+    }
+    return &Entry->Table;
   }
   void clearLineTableForUnit(DWARFUnit *U) override {
-    std::unique_lock<std::recursive_mutex> LockGuard(Mutex);
-    return ThreadUnsafeDWARFContextState::clearLineTableForUnit(U);
+    if (std::optional<uint64_t> Offset = getStmtListOffset(U)) {
+      std::lock_guard<std::mutex> Lock(LineTablesMutex);
+      LineTables.erase(*Offset);
+    }
   }
   Expected<const DWARFDebugFrame *> getDebugFrame() override {
     std::unique_lock<std::recursive_mutex> LockGuard(Mutex);
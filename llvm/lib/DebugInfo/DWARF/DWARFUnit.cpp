@@ -7,6 +7,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/DebugInfo/DWARF/DWARFUnit.h"
+#include "llvm/ADT/ScopeExit.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/BinaryFormat/Dwarf.h"
@@ -496,13 +497,31 @@ void DWARFUnit::extractDIEsIfNeeded(bool CUDieOnly) {
 }
 
 Error DWARFUnit::tryExtractDIEsIfNeeded(bool CUDieOnly) {
-  if ((CUDieOnly && !DieArray.empty()) ||
-      DieArray.size() > 1)
+  // Appending the other DIEs to DieArray may reallocate it, while another
+  // thread holds the unit DIE or reads DieArray without the lock. So a unit
+  // of a thread-safe context is only ever extracted once, completely.
+  if (CUDieOnly && Context.isThreadSafe())
+    CUDieOnly = false;
+
+  DIEsExtracted Needed =
+      CUDieOnly ? DIEsExtracted::UnitDIE : DIEsExtracted::All;
+  if (ExtractedDIEs.load(std::memory_order_acquire) >= Needed)
     return Error::success(); // Already parsed.
 
+  std::lock_guard<std::mutex> Lock(ExtractDIEsMutex);
+  if (ExtractedDIEs.load(std::memory_order_relaxed) >= Needed)
+    return Error::success(); // Parsed by another thread.
+
   bool HasCUDie = !DieArray.empty();
   extractDIEsToVector(!HasCUDie, !CUDieOnly, DieArray);
 
+  // Publish the DIEs on every path out of here, including the errors for
+  // unit attributes below: the DIEs themselves are usable either way.
+  auto PublishDIEs = make_scope_exit([&]() {
+    ExtractedDIEs.store(DieArray.empty() ? DIEsExtracted::None : Needed,
+                        std::memory_order_release);
+  });
+
   if (DieArray.empty())
     return Error::success();
 
@@ -603,6 +622,7 @@ Error DWARFUnit::tryExtractDIEsIfNeeded(bool CUDieOnly) {
 bool DWARFUnit::parseDWO(StringRef DWOAlternativeLocation) {
   if (IsDWO)
     return false;
+  std::lock_guard<std::mutex> Lock(DWOMutex);
   if (DWO)
     return false;
   DWARFDie UnitDie = getUnitDIE();
@@ -653,6 +673,7 @@ bool DWARFUnit::parseDWO(StringRef DWOAlternativeLocation) {
 }
 
 void DWARFUnit::clearDIEs(bool KeepCUDie) {
+  std::lock_guard<std::mutex> Lock(ExtractDIEsMutex);
   // Do not use resize() + shrink_to_fit() to free memory occupied by dies.
   // shrink_to_fit() is a *non-binding* request to reduce capacity() to size().
   // It depends on the implementation whether the request is fulfilled.
@@ -661,6 +682,9 @@ void DWARFUnit::clearDIEs(bool KeepCUDie) {
   DieArray = (KeepCUDie && !DieArray.empty())
                  ? std::vector<DWARFDebugInfoEntry>({DieArray[0]})
                  : std::vector<DWARFDebugInfoEntry>();
+  ExtractedDIEs.store(DieArray.empty() ? DIEsExtracted::None
+                                       : DIEsExtracted::UnitDIE,
+                      std::memory_order_release);
 }
 
 Expected<DWARFAddressRangesVector>
@@ -762,6 +786,7 @@ void DWARFUnit::updateAddressDieMap(DWARFDie Die) {
 
 DWARFDie DWARFUnit::getSubroutineForAddress(uint64_t Address) {
   extractDIEsIfNeeded(false);
+  std::lock_guard<std::mutex> Lock(AddrDieMapsMutex);
   if (AddrDieMap.empty())
     updateAddressDieMap(getUnitDIE());
   auto R = AddrDieMap.upper_bound(Address);
@@ -853,6 +878,7 @@ DWARFDie DWARFUnit::getVariableForAddress(uint64_t Address) {
 
   auto RootDie = getUnitDIE();
 
+  std::lock_guard<std::mutex> Lock(AddrDieMapsMutex);
   auto RootLookup = RootsParsedForVariables.insert(RootDie.getOffset());
   if (RootLookup.second)
     updateVariableDieMap(RootDie);
@@ -1158,7 +1184,11 @@ parseDWARFStringOffsetsTableHeader(DWARFDataExtractor &DA,
 Expected<std::optional<StrOffsetsContributionDescriptor>>
 DWARFUnit::determineStringOffsetsTableContribution(DWARFDataExtractor &DA) {
   assert(!IsDWO);
-  auto OptOffset = toSectionOffset(getUnitDIE().find(DW_AT_str_offsets_base));
+  // This is called while the DIEs are being extracted, so use the unit DIE
+  // directly rather than through getUnitDIE().
+  assert(!DieArray.empty());
+  DWARFDie UnitDie(this, &DieArray[0]);
+  auto OptOffset = toSectionOffset(UnitDie.find(DW_AT_str_offsets_base));
   if (!OptOffset)
     return std::nullopt;
   auto DescOrError =
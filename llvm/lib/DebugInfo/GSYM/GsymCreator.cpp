@@ -11,11 +11,13 @@
 #include "llvm/DebugInfo/GSYM/LineTable.h"
 #include "llvm/DebugInfo/GSYM/OutputAggregator.h"
 #include "llvm/MC/StringTableBuilder.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/raw_ostream.h"
 
 #include <algorithm>
 #include <cassert>
 #include <functional>
+#include <mutex>
 #include <vector>
 
 using namespace llvm;
@@ -168,13 +170,39 @@ llvm::Error GsymCreator::encode(FileWriter &O) const {
   StrTab.write(O.get_stream());
   const off_t StrtabSize = O.tell() - StrtabOffset;
   std::vector<uint32_t> AddrInfoOffsets;
-
-  // Write out the address infos for each function info.
-  for (const auto &FuncInfo : Funcs) {
-    if (Expected<uint64_t> OffsetOrErr = FuncInfo.encode(O))
-      AddrInfoOffsets.push_back(OffsetOrErr.get());
-    else
-      return OffsetOrErr.takeError();
+  AddrInfoOffsets.reserve(Funcs.size());
+
+  // Write out the address infos for each function info. The function infos
+  // are encoded in parallel into buffers, one chunk at a time to bound the
+  // memory used by the buffers, and the buffers are written out in order. An
+  // encoding doesn't depend on where it is written as long as it starts 4 byte
+  // aligned.
+  constexpr size_t EncodeChunkSize = 4096;
+  std::vector<SmallString<64>> Encodings;
+  for (size_t ChunkStart = 0; ChunkStart < Funcs.size();
+       ChunkStart += EncodeChunkSize) {
+    const size_t ChunkEnd =
+        std::min(ChunkStart + EncodeChunkSize, Funcs.size());
+    Encodings.assign(ChunkEnd - ChunkStart, SmallString<64>());
+    std::mutex ErrorMutex;
+    llvm::Error EncodeErr = Error::success();
+    parallelFor(ChunkStart, ChunkEnd, [&](size_t Idx) {
+      raw_svector_ostream OS(Encodings[Idx - ChunkStart]);
+      FileWriter FW(OS, O.getByteOrder());
+      Expected<uint64_t> OffsetOrErr = Funcs[Idx].encode(FW);
+      if (!OffsetOrErr) {
+        std::lock_guard<std::mutex> Lock(ErrorMutex);
+        EncodeErr = joinErrors(std::move(EncodeErr), OffsetOrErr.takeError());
+      }
+    });
+    if (EncodeErr)
+      return EncodeErr;
+    for (const auto &Encoding : Encodings) {
+      O.alignTo(4);
+      AddrInfoOffsets.push_back(O.tell());
+      O.writeData(ArrayRef<uint8_t>(
+          reinterpret_cast<const uint8_t *>(Encoding.data()), Encoding.size()));
+    }
   }
   // Fixup the string table offset and size in the header
   O.fixup32((uint32_t)StrtabOffset, offsetof(Header, StrtabOffset));
@@ -195,7 +223,7 @@ void GsymCreator::prepareMergedFunctions(OutputAggregator &Out) {
     return;
 
   // Sort the function infos by address range first
-  llvm::sort(Funcs);
+  llvm::parallelSort(Funcs, std::less<FunctionInfo>());
   std::vector<FunctionInfo> TopLevelFuncs;
 
   // Add the first function info to the top level functions
@@ -270,7 +298,7 @@ llvm::Error GsymCreator::finalize(OutputAggregator &Out) {
   if (!IsSegment) {
     if (NumBefore > 1) {
       // Sort function infos so we can emit sorted functions.
-      llvm::sort(Funcs);
+      llvm::parallelSort(Funcs, std::less<FunctionInfo>());
       std::vector<FunctionInfo> FinalizedFuncs;
       FinalizedFuncs.reserve(Funcs.size());
       FinalizedFuncs.emplace_back(std::move(Funcs.front()));
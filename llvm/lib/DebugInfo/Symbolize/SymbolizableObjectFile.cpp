@@ -22,6 +22,7 @@
 #include "llvm/Support/DataExtractor.h"
 #include "llvm/TargetParser/Triple.h"
 #include <algorithm>
+#include <numeric>
 
 using namespace llvm;
 using namespace object;
@@ -84,6 +85,11 @@ SymbolizableObjectFile::create(const object::ObjectFile *Obj,
   }
   SS.erase(J, SS.end());
 
+  for (SectionRef Sec : Obj->sections())
+    if (Sec.isText() && !Sec.isVirtual())
+      res->TextSections.push_back(
+          {Sec.getAddress(), Sec.getSize(), Sec.getIndex()});
+
   return std::move(res);
 }
 
@@ -353,15 +359,27 @@ std::vector<DILocal> SymbolizableObjectFile::symbolizeFrame(
 
 std::vector<object::SectionedAddress>
 SymbolizableObjectFile::findSymbol(StringRef Symbol, uint64_t Offset) const {
+  if (SymbolsByName.empty() && !Symbols.empty()) {
+    SymbolsByName.resize(Symbols.size());
+    std::iota(SymbolsByName.begin(), SymbolsByName.end(), 0);
+    llvm::stable_sort(SymbolsByName, [&](uint32_t L, uint32_t R) {
+      return Symbols[L].Name < Symbols[R].Name;
+    });
+  }
+
   std::vector<object::SectionedAddress> Result;
-  for (const SymbolDesc &Sym : Symbols) {
-    if (Sym.Name == Symbol) {
-      uint64_t Addr = Sym.Addr;
-      if (Offset < Sym.Size)
-        Addr += Offset;
-      object::SectionedAddress A{Addr, getModuleSectionIndexForAddress(Addr)};
-      Result.push_back(A);
-    }
+  auto Begin = llvm::partition_point(
+      SymbolsByName, [&](uint32_t Idx) { return Symbols[Idx].Name < Symbol; });
+  auto End = std::partition_point(
+      Begin, SymbolsByName.end(),
+      [&](uint32_t Idx) { return Symbols[Idx].Name == Symbol; });
+  for (uint32_t Idx : make_range(Begin, End)) {
+    const SymbolDesc &Sym = Symbols[Idx];
+    uint64_t Addr = Sym.Addr;
+    if (Offset < Sym.Size)
+      Addr += Offset;
+    object::SectionedAddress A{Addr, getModuleSectionIndexForAddress(Addr)};
+    Result.push_back(A);
   }
   return Result;
 }
@@ -369,15 +387,11 @@ SymbolizableObjectFile::findSymbol(StringRef Symbol, uint64_t Offset) const {
 /// Search for the first occurence of specified Address in ObjectFile.
 uint64_t SymbolizableObjectFile::getModuleSectionIndexForAddress(
     uint64_t Address) const {
-
-  for (SectionRef Sec : Module->sections()) {
-    if (!Sec.isText() || Sec.isVirtual())
-      continue;
-
-    if (Address >= Sec.getAddress() &&
-        Address < Sec.getAddress() + Sec.getSize())
-      return Sec.getIndex();
-  }
+  // Sections of relocatable objects all start at address 0 and overlap, so
+  // keep returning the first match rather than searching by address.
+  for (const TextSection &Sec : TextSections)
+    if (Address >= Sec.Addr && Address < Sec.Addr + Sec.Size)
+      return Sec.Index;
 
   return object::SectionedAddress::UndefSection;
 }
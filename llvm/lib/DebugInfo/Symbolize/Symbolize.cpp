@@ -76,7 +76,7 @@ LLVMSymbolizer::symbolizeCodeCommon(const T &ModuleSpecifier,
                           Opts.SkipLineZero),
       Opts.UseSymbolTable);
   if (Opts.Demangle)
-    LineInfo.FunctionName = DemangleName(LineInfo.FunctionName, Info);
+    LineInfo.FunctionName = demangleFunctionName(LineInfo.FunctionName, Info);
   return LineInfo;
 }
 
@@ -125,7 +125,7 @@ Expected<DIInliningInfo> LLVMSymbolizer::symbolizeInlinedCodeCommon(
   if (Opts.Demangle) {
     for (int i = 0, n = InlinedContext.getNumberOfFrames(); i < n; i++) {
       auto *Frame = InlinedContext.getMutableFrame(i);
-      Frame->FunctionName = DemangleName(Frame->FunctionName, Info);
+      Frame->FunctionName = demangleFunctionName(Frame->FunctionName, Info);
     }
   }
   return InlinedContext;
@@ -257,7 +257,8 @@ LLVMSymbolizer::findSymbolCommon(const T &ModuleSpecifier, StringRef Symbol,
         Opts.UseSymbolTable);
     if (LineInfo.FileName != DILineInfo::BadString) {
       if (Opts.Demangle)
-        LineInfo.FunctionName = DemangleName(LineInfo.FunctionName, Info);
+        LineInfo.FunctionName =
+            demangleFunctionName(LineInfo.FunctionName, Info);
       Result.push_back(LineInfo);
     }
   }
@@ -291,6 +292,7 @@ void LLVMSymbolizer::flush() {
   ObjectPairForPathArch.clear();
   Modules.clear();
   BuildIDPaths.clear();
+  DemangledFunctionNames.clear();
 }
 
 namespace {
@@ -779,6 +781,19 @@ LLVMSymbolizer::DemangleName(const std::string &Name,
   return Name;
 }
 
+std::string
+LLVMSymbolizer::demangleFunctionName(const std::string &Name,
+                                     const SymbolizableModule *Info) {
+  // How Win32 names demangle depends on the module.
+  if (Info && Info->isWin32Module())
+    return DemangleName(Name, Info);
+
+  auto [It, Inserted] = DemangledFunctionNames.try_emplace(Name);
+  if (Inserted)
+    It->second = DemangleName(Name, Info);
+  return It->second;
+}
+
 void LLVMSymbolizer::recordAccess(CachedBinary &Bin) {
   if (Bin->getBinary())
     LRUBinaries.splice(LRUBinaries.end(), LRUBinaries, Bin.getIterator());
@@ -35,12 +35,14 @@
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/LockFileManager.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/xxhash.h"
 
 #include <atomic>
+#include <mutex>
 #include <optional>
 #include <thread>
 
@@ -52,6 +54,37 @@ namespace {
 std::optional<SmallVector<StringRef>> DebuginfodUrls;
 // Many Readers/Single Writer lock protecting the global debuginfod URL list.
 llvm::sys::RWMutex UrlsMutex;
+
+// The artifacts that threads of this process are fetching, by cache path.
+struct InFlightFetch {
+  std::mutex Mutex;
+  unsigned NumThreads = 0;
+};
+std::mutex InFlightFetchesMutex;
+StringMap<InFlightFetch> InFlightFetches;
+
+/// Holds the fetch of an artifact for one thread of this process at a time.
+class InFlightFetchLock {
+  StringMapEntry<InFlightFetch> *Entry;
+  std::unique_lock<std::mutex> Lock;
+
+public:
+  InFlightFetchLock(StringRef ArtifactPath) {
+    {
+      std::lock_guard<std::mutex> Guard(InFlightFetchesMutex);
+      Entry = &*InFlightFetches.try_emplace(ArtifactPath).first;
+      ++Entry->second.NumThreads;
+    }
+    Lock = std::unique_lock<std::mutex>(Entry->second.Mutex);
+  }
+
+  ~InFlightFetchLock() {
+    Lock.unlock();
+    std::lock_guard<std::mutex> Guard(InFlightFetchesMutex);
+    if (--Entry->second.NumThreads == 0)
+      InFlightFetches.erase(Entry->getKey());
+  }
+};
 } // namespace
 
 std::string getDebuginfodCacheKey(llvm::StringRef S) {
@@ -282,6 +315,19 @@ Expected<std::string> getCachedOrDownloadArtifact(
         "allow Debuginfod to make HTTP requests, call HTTPClient::initialize() "
         "at the beginning of main.");
 
+  // Fetch each artifact only once. Threads of this process wait for the one
+  // fetching it, and processes wait for the one that holds the lock file next
+  // to it; both then find it in the cache. A process that fails to fetch it
+  // or that takes too long doesn't stop others from fetching it themselves.
+  InFlightFetchLock FetchLock(AbsCachedArtifactPath);
+  if (sys::fs::exists(AbsCachedArtifactPath))
+    return std::string(AbsCachedArtifactPath);
+  LockFileManager ArtifactLock(AbsCachedArtifactPath);
+  if (ArtifactLock == LockFileManager::LFS_Shared &&
+      ArtifactLock.waitForUnlock() == LockFileManager::Res_Success &&
+      sys::fs::exists(AbsCachedArtifactPath))
+    return std::string(AbsCachedArtifactPath);
+
   HTTPClient Client;
   Client.setTimeout(Timeout);
   for (StringRef ServerUrl : DebuginfodUrls) {
@@ -20,6 +20,7 @@
 #include "llvm/Support/Format.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/raw_ostream.h"
+#include <atomic>
 
 using namespace llvm;
 using namespace llvm::object;
@@ -473,8 +474,36 @@ PointerJumpStubCreator getPointerJumpStubCreator(const Triple &TT) {
   }
 }
 
+static std::atomic<bool> LinkPhaseTimesEnabled{false};
+static std::atomic<int64_t> BuildGraphNanos{0};
+static std::atomic<int64_t> ApplyFixupsNanos{0};
+
+void setLinkPhaseTimesEnabled(bool Enabled) { LinkPhaseTimesEnabled = Enabled; }
+
+LinkPhaseTimes getLinkPhaseTimes() {
+  LinkPhaseTimes Times;
+  Times.BuildGraph = std::chrono::nanoseconds(BuildGraphNanos.load());
+  Times.ApplyFixups = std::chrono::nanoseconds(ApplyFixupsNanos.load());
+  return Times;
+}
+
+LinkPhaseTimeRegion::LinkPhaseTimeRegion(Phase P) : P(P) {
+  if (LinkPhaseTimesEnabled.load(std::memory_order_relaxed))
+    Start = std::chrono::steady_clock::now();
+}
+
+LinkPhaseTimeRegion::~LinkPhaseTimeRegion() {
+  if (!Start)
+    return;
+  int64_t Nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now() - *Start)
+                      .count();
+  (P == BuildGraph ? BuildGraphNanos : ApplyFixupsNanos) += Nanos;
+}
+
 Expected<std::unique_ptr<LinkGraph>>
 createLinkGraphFromObject(MemoryBufferRef ObjectBuffer) {
+  LinkPhaseTimeRegion TR(LinkPhaseTimeRegion::BuildGraph);
   auto Magic = identify_magic(ObjectBuffer.getBuffer());
   switch (Magic) {
   case file_magic::macho_object:
@@ -160,8 +160,11 @@ void JITLinkerBase::linkPhase3(std::unique_ptr<JITLinkerBase> Self,
   });
 
   // Fix up block content.
-  if (auto Err = fixUpBlocks(*G))
-    return abandonAllocAndBailOut(std::move(Self), std::move(Err));
+  {
+    LinkPhaseTimeRegion TR(LinkPhaseTimeRegion::ApplyFixups);
+    if (auto Err = fixUpBlocks(*G))
+      return abandonAllocAndBailOut(std::move(Self), std::move(Err));
+  }
 
   LLVM_DEBUG({
     dbgs() << "Link graph \"" << G->getName() << "\" after copy-and-fixup:\n";
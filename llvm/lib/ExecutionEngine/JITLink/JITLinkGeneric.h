@@ -14,6 +14,7 @@
 #define LIB_EXECUTIONENGINE_JITLINK_JITLINKGENERIC_H
 
 #include "llvm/ExecutionEngine/JITLink/JITLink.h"
+#include "llvm/Support/Parallel.h"
 
 #define DEBUG_TYPE "jitlink"
 
@@ -132,14 +133,11 @@ private:
   Error fixUpBlocks(LinkGraph &G) const override {
     LLVM_DEBUG(dbgs() << "Fixing up blocks:\n");
 
+    std::vector<Block *> Blocks;
     for (auto &Sec : G.sections()) {
       bool NoAllocSection = Sec.getMemLifetime() == orc::MemLifetime::NoAlloc;
 
       for (auto *B : Sec.blocks()) {
-        LLVM_DEBUG(dbgs() << "  " << *B << ":\n");
-
-        // Copy Block data and apply fixups.
-        LLVM_DEBUG(dbgs() << "    Applying fixups.\n");
         assert((!B->isZeroFill() || all_of(B->edges(),
                                            [](const Edge &E) {
                                              return E.getKind() ==
@@ -149,33 +147,62 @@ private:
 
         // If this is a no-alloc section then copy the block content into
         // memory allocated on the Graph's allocator (if it hasn't been
-        // already).
+        // already). The allocator is not thread safe, so this is done before
+        // any fixups are applied in parallel.
         if (NoAllocSection)
           (void)B->getMutableContent(G);
 
-        for (auto &E : B->edges()) {
+        Blocks.push_back(B);
+      }
+    }
 
-          // Skip non-relocation edges.
-          if (!E.isRelocation())
-            continue;
+    // Fixups only write to the content of the block that they are in, so the
+    // blocks of large graphs are fixed up in parallel. Debug output is kept
+    // in order.
+    bool FixUpInParallel = Blocks.size() >= ParallelFixUpThreshold;
+    LLVM_DEBUG(FixUpInParallel = false);
+
+    auto FixUpBlock = [&](Block *B) -> Error {
+      LLVM_DEBUG(dbgs() << "  " << *B << ":\n");
+
+      // Copy Block data and apply fixups.
+      LLVM_DEBUG(dbgs() << "    Applying fixups.\n");
+      [[maybe_unused]] bool NoAllocSection =
+          B->getSection().getMemLifetime() == orc::MemLifetime::NoAlloc;
+
+      for (auto &E : B->edges()) {
+
+        // Skip non-relocation edges.
+        if (!E.isRelocation())
+          continue;
+
+        // If B is a block in a Standard or Finalize section then make sure
+        // that no edges point to symbols in NoAlloc sections.
+        assert((NoAllocSection || !E.getTarget().isDefined() ||
+                E.getTarget().getBlock().getSection().getMemLifetime() !=
+                    orc::MemLifetime::NoAlloc) &&
+               "Block in allocated section has edge pointing to no-alloc "
+               "section");
+
+        // Dispatch to LinkerImpl for fixup.
+        if (auto Err = impl().applyFixup(G, *B, E))
+          return Err;
+      }
+      return Error::success();
+    };
 
-          // If B is a block in a Standard or Finalize section then make sure
-          // that no edges point to symbols in NoAlloc sections.
-          assert((NoAllocSection || !E.getTarget().isDefined() ||
-                  E.getTarget().getBlock().getSection().getMemLifetime() !=
-                      orc::MemLifetime::NoAlloc) &&
-                 "Block in allocated section has edge pointing to no-alloc "
-                 "section");
+    if (FixUpInParallel)
+      return parallelForEachError(Blocks, FixUpBlock);
 
-          // Dispatch to LinkerImpl for fixup.
-          if (auto Err = impl().applyFixup(G, *B, E))
-            return Err;
-        }
-      }
-    }
+    for (auto *B : Blocks)
+      if (auto Err = FixUpBlock(B))
+        return Err;
 
     return Error::success();
   }
+
+  /// The number of blocks from which fixups are applied in parallel.
+  static constexpr size_t ParallelFixUpThreshold = 1024;
 };
 
 /// Removes dead symbols/blocks/addressables.
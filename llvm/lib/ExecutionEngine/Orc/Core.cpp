@@ -1968,6 +1968,17 @@ void ExecutionSession::runJITDispatchHandler(SendResultFunction SendResult,
             .str()));
 }
 
+void ExecutionSession::lockSessionContended(
+    std::unique_lock<std::recursive_mutex> &Lock) {
+  auto Start = std::chrono::steady_clock::now();
+  Lock.lock();
+  auto Wait = std::chrono::steady_clock::now() - Start;
+  NumContendedSessionLocks.fetch_add(1, std::memory_order_relaxed);
+  SessionLockWaitNanos.fetch_add(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(Wait).count(),
+      std::memory_order_relaxed);
+}
+
 void ExecutionSession::dump(raw_ostream &OS) {
   runSessionLocked([this, &OS]() {
     for (auto &JD : JDs)
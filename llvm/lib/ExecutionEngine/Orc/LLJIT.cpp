@@ -18,6 +18,7 @@
 #include "llvm/ExecutionEngine/Orc/MachOPlatform.h"
 #include "llvm/ExecutionEngine/Orc/ObjectLinkingLayer.h"
 #include "llvm/ExecutionEngine/Orc/ObjectTransformLayer.h"
+#include "llvm/ExecutionEngine/Orc/PersistentObjectCache.h"
 #include "llvm/ExecutionEngine/Orc/RTDyldObjectLinkingLayer.h"
 #include "llvm/ExecutionEngine/Orc/Shared/OrcError.h"
 #include "llvm/ExecutionEngine/Orc/TargetProcess/RegisterEHFrames.h"
@@ -859,6 +860,32 @@ Error LLJITBuilderState::prepareForConstruction() {
     };
   }
 
+  if (!ObjectCacheDir.empty() || ObjCache) {
+    if (CreateCompileFunction)
+      return make_error<StringError>(
+          "An object cache cannot be used with a custom "
+          "CompileFunctionCreator",
+          inconvertibleErrorCode());
+
+    // Create the cache last so that its key reflects the final relocation and
+    // code models.
+    if (!ObjectCacheDir.empty()) {
+      if (ObjCache)
+        return make_error<StringError>(
+            "ObjectCache and object cache directory cannot both be set",
+            inconvertibleErrorCode());
+      LLVM_DEBUG({
+        dbgs() << "Creating PersistentObjectCache in " << ObjectCacheDir
+               << "\n";
+      });
+      auto CacheOrErr = PersistentObjectCache::Create(
+          ObjectCacheDir, *JTMB, ObjectCachePruningPolicy);
+      if (!CacheOrErr)
+        return CacheOrErr.takeError();
+      ObjCache = std::move(*CacheOrErr);
+    }
+  }
+
   return Error::success();
 }
 
@@ -989,13 +1016,15 @@ LLJIT::createCompileFunction(LLJITBuilderState &S,
 
   // If using a custom EPC then use a ConcurrentIRCompiler by default.
   if (*S.SupportConcurrentCompilation)
-    return std::make_unique<ConcurrentIRCompiler>(std::move(JTMB));
+    return std::make_unique<ConcurrentIRCompiler>(std::move(JTMB),
+                                                  S.ObjCache.get());
 
   auto TM = JTMB.createTargetMachine();
   if (!TM)
     return TM.takeError();
 
-  return std::make_unique<TMOwningSimpleCompiler>(std::move(*TM));
+  return std::make_unique<TMOwningSimpleCompiler>(std::move(*TM),
+                                                  S.ObjCache.get());
 }
 
 LLJIT::LLJIT(LLJITBuilderState &S, Error &Err)
@@ -1033,6 +1062,7 @@ LLJIT::LLJIT(LLJITBuilderState &S, Error &Err)
       Err = CompileFunction.takeError();
       return;
     }
+    ObjCache = std::move(S.ObjCache);
     CompileLayer = std::make_unique<IRCompileLayer>(
         *ES, *ObjTransformLayer, std::move(*CompileFunction));
     TransformLayer = std::make_unique<IRTransformLayer>(*ES, *CompileLayer);
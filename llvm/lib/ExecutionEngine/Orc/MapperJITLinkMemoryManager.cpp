@@ -138,7 +138,14 @@ void MapperJITLinkMemoryManager::allocate(const JITLinkDylib *JD, LinkGraph &G,
 
   if (SelectedRange.empty()) { // no already reserved range was found
     auto TotalAllocation = alignTo(TotalSize, ReservationUnits);
-    Mapper->reserve(TotalAllocation, std::move(CompleteAllocation));
+    Mapper->reserve(TotalAllocation,
+                    [this, CompleteAllocation = std::move(CompleteAllocation)](
+                        Expected<ExecutorAddrRange> Result) mutable {
+                      // Mutex is still held by allocate.
+                      if (Result)
+                        ReservedBytes += Result->size();
+                      CompleteAllocation(std::move(Result));
+                    });
   } else {
     CompleteAllocation(SelectedRange);
   }
@@ -146,44 +153,98 @@ void MapperJITLinkMemoryManager::allocate(const JITLinkDylib *JD, LinkGraph &G,
 
 void MapperJITLinkMemoryManager::deallocate(
     std::vector<FinalizedAlloc> Allocs, OnDeallocatedFunction OnDeallocated) {
-  std::vector<ExecutorAddr> Bases;
-  Bases.reserve(Allocs.size());
-  for (auto &FA : Allocs) {
-    ExecutorAddr Addr = FA.getAddress();
-    Bases.push_back(Addr);
+  {
+    std::lock_guard<std::mutex> Lock(DeallocationsMutex);
+    PendingDeallocations.push_back(
+        {std::move(Allocs), std::move(OnDeallocated)});
+
+    // The in-flight call will pick this deallocation up when it completes.
+    if (DeinitializeInFlight)
+      return;
+    DeinitializeInFlight = true;
   }
 
-  Mapper->deinitialize(Bases, [this, Allocs = std::move(Allocs),
-                               OnDeallocated = std::move(OnDeallocated)](
+  deinitializePendingDeallocations();
+}
+
+void MapperJITLinkMemoryManager::deinitializePendingDeallocations() {
+  std::vector<PendingDeallocation> Batch;
+  {
+    std::lock_guard<std::mutex> Lock(DeallocationsMutex);
+    assert(DeinitializeInFlight && "Deinitialize not marked in flight");
+    std::swap(Batch, PendingDeallocations);
+  }
+
+  std::vector<ExecutorAddr> Bases;
+  for (auto &PD : Batch)
+    for (auto &FA : PD.Allocs)
+      Bases.push_back(FA.getAddress());
+
+  Mapper->deinitialize(Bases, [this, Batch = std::move(Batch)](
                                   llvm::Error Err) mutable {
     // TODO: How should we treat memory that we fail to deinitialize?
     // We're currently bailing out and treating it as "burned" -- should we
     // require that a failure to deinitialize still reset the memory so that
     // we can reclaim it?
     if (Err) {
-      for (auto &FA : Allocs)
-        FA.release();
-      OnDeallocated(std::move(Err));
-      return;
+      // Every caller in the batch gets a copy of the error.
+      std::string ErrMsg = toString(std::move(Err));
+      for (auto &PD : Batch) {
+        for (auto &FA : PD.Allocs)
+          FA.release();
+        PD.OnDeallocated(
+            make_error<StringError>(ErrMsg, inconvertibleErrorCode()));
+      }
+    } else {
+      for (auto &PD : Batch) {
+        reclaimMemory(PD.Allocs);
+        PD.OnDeallocated(Error::success());
+      }
     }
 
     {
-      std::lock_guard<std::mutex> Lock(Mutex);
-
-      for (auto &FA : Allocs) {
-        ExecutorAddr Addr = FA.getAddress();
-        ExecutorAddrDiff Size = UsedMemory[Addr];
-
-        UsedMemory.erase(Addr);
-        AvailableMemory.insert(Addr, Addr + Size - 1, true);
-
-        FA.release();
+      std::lock_guard<std::mutex> Lock(DeallocationsMutex);
+      if (PendingDeallocations.empty()) {
+        DeinitializeInFlight = false;
+        return;
       }
     }
 
-    OnDeallocated(Error::success());
+    deinitializePendingDeallocations();
   });
 }
 
+void MapperJITLinkMemoryManager::reclaimMemory(
+    std::vector<FinalizedAlloc> &Allocs) {
+  std::lock_guard<std::mutex> Lock(Mutex);
+
+  for (auto &FA : Allocs) {
+    ExecutorAddr Addr = FA.getAddress();
+    ExecutorAddrDiff Size = UsedMemory[Addr];
+
+    UsedMemory.erase(Addr);
+    AvailableMemory.insert(Addr, Addr + Size - 1, true);
+
+    FA.release();
+  }
+}
+
+MapperJITLinkMemoryManager::MemoryStats
+MapperJITLinkMemoryManager::getMemoryStats() {
+  std::lock_guard<std::mutex> Lock(Mutex);
+
+  MemoryStats Stats;
+  Stats.ReservedBytes = ReservedBytes;
+  for (auto &KV : UsedMemory)
+    Stats.AllocatedBytes += KV.second;
+  for (auto It = AvailableMemory.begin(); It != AvailableMemory.end(); ++It) {
+    size_t Size = It.stop() - It.start() + 1;
+    Stats.FreeBytes += Size;
+    ++Stats.NumFreeRanges;
+    Stats.LargestFreeRange = std::max(Stats.LargestFreeRange, Size);
+  }
+  return Stats;
+}
+
 } // end namespace orc
 } // end namespace llvm
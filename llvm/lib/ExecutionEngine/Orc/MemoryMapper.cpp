@@ -30,22 +30,26 @@ namespace orc {
 
 MemoryMapper::~MemoryMapper() {}
 
-InProcessMemoryMapper::InProcessMemoryMapper(size_t PageSize)
-    : PageSize(PageSize) {}
+InProcessMemoryMapper::InProcessMemoryMapper(size_t PageSize,
+                                             bool UseHugePages)
+    : PageSize(PageSize), UseHugePages(UseHugePages) {}
 
 Expected<std::unique_ptr<InProcessMemoryMapper>>
-InProcessMemoryMapper::Create() {
+InProcessMemoryMapper::Create(bool UseHugePages) {
   auto PageSize = sys::Process::getPageSize();
   if (!PageSize)
     return PageSize.takeError();
-  return std::make_unique<InProcessMemoryMapper>(*PageSize);
+  return std::make_unique<InProcessMemoryMapper>(*PageSize, UseHugePages);
 }
 
 void InProcessMemoryMapper::reserve(size_t NumBytes,
                                     OnReservedFunction OnReserved) {
+  unsigned Flags = sys::Memory::MF_READ | sys::Memory::MF_WRITE;
+  if (UseHugePages)
+    Flags |= sys::Memory::MF_HUGE_HINT;
+
   std::error_code EC;
-  auto MB = sys::Memory::allocateMappedMemory(
-      NumBytes, nullptr, sys::Memory::MF_READ | sys::Memory::MF_WRITE, EC);
+  auto MB = sys::Memory::allocateMappedMemory(NumBytes, nullptr, Flags, EC);
 
   if (EC)
     return OnReserved(errorCodeToError(EC));
@@ -192,6 +196,234 @@ InProcessMemoryMapper::~InProcessMemoryMapper() {
   cantFail(F.get());
 }
 
+// DualMappedMemoryMapper
+
+#if defined(LLVM_ON_UNIX) && !defined(__ANDROID__) && !defined(__MVS__)
+#define DUAL_MAPPING_SUPPORTED
+#endif
+
+DualMappedMemoryMapper::DualMappedMemoryMapper(size_t PageSize,
+                                               bool UseHugePages)
+    : PageSize(PageSize), UseHugePages(UseHugePages) {}
+
+Expected<std::unique_ptr<DualMappedMemoryMapper>>
+DualMappedMemoryMapper::Create(bool UseHugePages) {
+#if defined(DUAL_MAPPING_SUPPORTED)
+  auto PageSize = sys::Process::getPageSize();
+  if (!PageSize)
+    return PageSize.takeError();
+  return std::make_unique<DualMappedMemoryMapper>(*PageSize, UseHugePages);
+#else
+  return make_error<StringError>(
+      "DualMappedMemoryMapper is not supported on this platform yet",
+      inconvertibleErrorCode());
+#endif
+}
+
+void DualMappedMemoryMapper::reserve(size_t NumBytes,
+                                     OnReservedFunction OnReserved) {
+#if defined(DUAL_MAPPING_SUPPORTED)
+  NumBytes = alignTo(NumBytes, PageSize);
+
+  std::string SharedMemoryName;
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    SharedMemoryName = ("/jitlink_dual_" + Twine(sys::Process::getProcessId()) +
+                        "_" + Twine(++SharedMemoryCount))
+                           .str();
+  }
+
+  int SharedMemoryFile =
+      shm_open(SharedMemoryName.c_str(), O_RDWR | O_CREAT | O_EXCL, 0700);
+  if (SharedMemoryFile < 0)
+    return OnReserved(errorCodeToError(errnoAsErrorCode()));
+
+  // The memory is only reachable through the mappings below.
+  shm_unlink(SharedMemoryName.c_str());
+
+  if (ftruncate(SharedMemoryFile, NumBytes) < 0) {
+    auto EC = errnoAsErrorCode();
+    close(SharedMemoryFile);
+    return OnReserved(errorCodeToError(EC));
+  }
+
+  void *WorkingView = mmap(nullptr, NumBytes, PROT_READ | PROT_WRITE,
+                           MAP_SHARED, SharedMemoryFile, 0);
+  if (WorkingView == MAP_FAILED) {
+    auto EC = errnoAsErrorCode();
+    close(SharedMemoryFile);
+    return OnReserved(errorCodeToError(EC));
+  }
+
+  // Pages of the executor view are inaccessible until they're initialized.
+  void *ExecutorView =
+      mmap(nullptr, NumBytes, PROT_NONE, MAP_SHARED, SharedMemoryFile, 0);
+  if (ExecutorView == MAP_FAILED) {
+    auto EC = errnoAsErrorCode();
+    munmap(WorkingView, NumBytes);
+    close(SharedMemoryFile);
+    return OnReserved(errorCodeToError(EC));
+  }
+
+  close(SharedMemoryFile);
+
+#if defined(MADV_HUGEPAGE)
+  // This is only a hint, so failures are ignored.
+  if (UseHugePages) {
+    madvise(WorkingView, NumBytes, MADV_HUGEPAGE);
+    madvise(ExecutorView, NumBytes, MADV_HUGEPAGE);
+  }
+#endif
+
+  auto Base = ExecutorAddr::fromPtr(ExecutorView);
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Reservations[Base] = {static_cast<char *>(WorkingView), NumBytes, {}};
+  }
+
+  OnReserved(ExecutorAddrRange(Base, NumBytes));
+#else
+  OnReserved(make_error<StringError>(
+      "DualMappedMemoryMapper is not supported on this platform yet",
+      inconvertibleErrorCode()));
+#endif
+}
+
+char *DualMappedMemoryMapper::prepare(ExecutorAddr Addr, size_t ContentSize) {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  auto R = Reservations.upper_bound(Addr);
+  assert(R != Reservations.begin() && "Attempt to prepare unreserved range");
+  R--;
+
+  ExecutorAddrDiff Offset = Addr - R->first;
+  assert(Offset + ContentSize <= R->second.Size &&
+         "Attempt to prepare range beyond reservation");
+
+  return R->second.WorkingAddr + Offset;
+}
+
+void DualMappedMemoryMapper::initialize(MemoryMapper::AllocInfo &AI,
+                                        OnInitializedFunction OnInitialized) {
+  char *WorkingBase = prepare(AI.MappingBase, 0);
+  ExecutorAddr MinAddr(~0ULL);
+
+  // FIXME: Release finalize lifetime segments.
+  for (auto &Segment : AI.Segments) {
+    auto Base = AI.MappingBase + Segment.Offset;
+    auto Size = Segment.ContentSize + Segment.ZeroFillSize;
+
+    if (Base < MinAddr)
+      MinAddr = Base;
+
+    // The working memory may hold content from a previous allocation.
+    std::memset(WorkingBase + Segment.Offset + Segment.ContentSize, 0,
+                Segment.ZeroFillSize);
+
+    if (auto EC = sys::Memory::protectMappedMemory(
+            {Base.toPtr<void *>(), Size},
+            toSysMemoryProtectionFlags(Segment.AG.getMemProt()))) {
+      return OnInitialized(errorCodeToError(EC));
+    }
+    if ((Segment.AG.getMemProt() & MemProt::Exec) == MemProt::Exec)
+      sys::Memory::InvalidateInstructionCache(Base.toPtr<void *>(), Size);
+  }
+
+  auto DeinitializeActions = shared::runFinalizeActions(AI.Actions);
+  if (!DeinitializeActions)
+    return OnInitialized(DeinitializeActions.takeError());
+
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Allocations[MinAddr].DeinitializationActions =
+        std::move(*DeinitializeActions);
+    Reservations[AI.MappingBase].Allocations.push_back(MinAddr);
+  }
+
+  OnInitialized(MinAddr);
+}
+
+void DualMappedMemoryMapper::deinitialize(
+    ArrayRef<ExecutorAddr> Bases,
+    MemoryMapper::OnDeinitializedFunction OnDeinitialized) {
+  Error AllErr = Error::success();
+
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+
+    for (auto Base : llvm::reverse(Bases)) {
+      if (Error Err = shared::runDeallocActions(
+              Allocations[Base].DeinitializationActions)) {
+        AllErr = joinErrors(std::move(AllErr), std::move(Err));
+      }
+
+      // The content of the area is written through the working view when it
+      // is reused, so its protections are left alone until then.
+      Allocations.erase(Base);
+    }
+  }
+
+  OnDeinitialized(std::move(AllErr));
+}
+
+void DualMappedMemoryMapper::release(ArrayRef<ExecutorAddr> Bases,
+                                     OnReleasedFunction OnReleased) {
+  Error Err = Error::success();
+
+  for (auto Base : Bases) {
+    std::vector<ExecutorAddr> AllocAddrs;
+    char *WorkingAddr;
+    size_t Size;
+    {
+      std::lock_guard<std::mutex> Lock(Mutex);
+      auto &R = Reservations[Base];
+      WorkingAddr = R.WorkingAddr;
+      Size = R.Size;
+      AllocAddrs.swap(R.Allocations);
+    }
+
+    // deinitialize sub allocations
+    std::promise<MSVCPError> P;
+    auto F = P.get_future();
+    deinitialize(AllocAddrs, [&](Error Err) { P.set_value(std::move(Err)); });
+    if (Error E = F.get()) {
+      Err = joinErrors(std::move(Err), std::move(E));
+    }
+
+#if defined(DUAL_MAPPING_SUPPORTED)
+    if (munmap(Base.toPtr<void *>(), Size) != 0)
+      Err = joinErrors(std::move(Err), errorCodeToError(errnoAsErrorCode()));
+    if (munmap(WorkingAddr, Size) != 0)
+      Err = joinErrors(std::move(Err), errorCodeToError(errnoAsErrorCode()));
+#else
+    (void)WorkingAddr;
+    (void)Size;
+#endif
+
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Reservations.erase(Base);
+  }
+
+  OnReleased(std::move(Err));
+}
+
+DualMappedMemoryMapper::~DualMappedMemoryMapper() {
+  std::vector<ExecutorAddr> ReservationAddrs;
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+
+    ReservationAddrs.reserve(Reservations.size());
+    for (const auto &R : Reservations)
+      ReservationAddrs.push_back(R.first);
+  }
+
+  std::promise<MSVCPError> P;
+  auto F = P.get_future();
+  release(ReservationAddrs, [&](Error Err) { P.set_value(std::move(Err)); });
+  cantFail(F.get());
+}
+
+#undef DUAL_MAPPING_SUPPORTED
+
 // SharedMemoryMapper
 
 SharedMemoryMapper::SharedMemoryMapper(ExecutorProcessControl &EPC,
@@ -0,0 +1,203 @@
+//===----- PersistentObjectCache.cpp - On-disk object cache for ORC -------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/PersistentObjectCache.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA256.h"
+#include "llvm/Support/raw_ostream.h"
+
+#define DEBUG_TYPE "orc"
+
+using namespace llvm;
+using namespace llvm::orc;
+
+Expected<std::unique_ptr<PersistentObjectCache>>
+PersistentObjectCache::Create(StringRef CacheDir,
+                              const JITTargetMachineBuilder &JTMB,
+                              CachePruningPolicy Policy) {
+  if (CacheDir.empty())
+    return make_error<StringError>("Object cache directory must not be empty",
+                                   inconvertibleErrorCode());
+
+  SmallString<128> AbsCacheDir(CacheDir);
+  if (auto EC = sys::fs::make_absolute(AbsCacheDir))
+    return createStringError(EC, "Cannot resolve object cache directory " +
+                                     CacheDir + ": " + EC.message());
+
+  std::unique_ptr<PersistentObjectCache> Cache(new PersistentObjectCache(
+      std::string(AbsCacheDir), getTargetKey(JTMB), std::move(Policy)));
+  Cache->prune();
+  return std::move(Cache);
+}
+
+std::string
+PersistentObjectCache::getTargetKey(const JITTargetMachineBuilder &JTMB) {
+  std::string Key;
+  raw_string_ostream KeyStream(Key);
+  KeyStream << JTMB.getTargetTriple().str() << ';' << JTMB.getCPU() << ';'
+            << JTMB.getFeatures().getString() << ";O"
+            << static_cast<int>(JTMB.getCodeGenOptLevel()) << ";reloc=";
+  if (auto &RM = JTMB.getRelocationModel())
+    KeyStream << static_cast<int>(*RM);
+  else
+    KeyStream << "default";
+  KeyStream << ";cm=";
+  if (auto &CM = JTMB.getCodeModel())
+    KeyStream << static_cast<int>(*CM);
+  else
+    KeyStream << "default";
+
+  // The target options that change the code generated for a module.
+  const TargetOptions &Options = JTMB.getOptions();
+  KeyStream << ";float-abi=" << static_cast<int>(Options.FloatABIType)
+            << ";fp-contract=" << static_cast<int>(Options.AllowFPOpFusion)
+            << ";fp-math=" << Options.UnsafeFPMath << Options.NoInfsFPMath
+            << Options.NoNaNsFPMath << Options.NoTrappingFPMath
+            << Options.NoSignedZerosFPMath << Options.ApproxFuncFPMath
+            << ";emulated-tls=" << Options.EmulatedTLS
+            << ";sections=" << Options.FunctionSections
+            << Options.DataSections << ";eh="
+            << static_cast<int>(Options.ExceptionModel);
+  return Key;
+}
+
+std::string PersistentObjectCache::getCacheKey(const Module &M) const {
+  SmallVector<char, 0> Bitcode;
+  {
+    raw_svector_ostream BitcodeStream(Bitcode);
+    WriteBitcodeToFile(M, BitcodeStream);
+  }
+
+  SHA256 Hasher;
+  Hasher.update(TargetKey);
+  // Separate the target key from the bitcode so that the two can't run into
+  // each other.
+  Hasher.update(ArrayRef<uint8_t>{0});
+  Hasher.update(ArrayRef<uint8_t>(
+      reinterpret_cast<const uint8_t *>(Bitcode.data()), Bitcode.size()));
+  return toHex(Hasher.final());
+}
+
+std::string PersistentObjectCache::getEntryPath(StringRef Key) const {
+  // Name the entries like the ThinLTO cache so that pruneCache knows that it
+  // is allowed to remove them.
+  SmallString<128> EntryPath(CacheDir);
+  sys::path::append(EntryPath, "llvmcache-" + Key);
+  return std::string(EntryPath);
+}
+
+std::unique_ptr<MemoryBuffer>
+PersistentObjectCache::getObject(const Module *M) {
+  std::string Key = getCacheKey(*M);
+  std::string EntryPath = getEntryPath(Key);
+
+  // Update the access time of the entry so that the pruner considers it
+  // recently used.
+  Expected<sys::fs::file_t> FDOrErr =
+      sys::fs::openNativeFileForRead(EntryPath, sys::fs::OF_UpdateAtime);
+  if (FDOrErr) {
+    ErrorOr<std::unique_ptr<MemoryBuffer>> MBOrErr =
+        MemoryBuffer::getOpenFile(*FDOrErr, EntryPath, /*FileSize=*/-1,
+                                  /*RequiresNullTerminator=*/false);
+    sys::fs::closeFile(*FDOrErr);
+    if (MBOrErr) {
+      LLVM_DEBUG({
+        dbgs() << "Object cache hit for " << M->getModuleIdentifier() << " ("
+               << EntryPath << ")\n";
+      });
+      ++Stats.Hits;
+      Stats.BytesRead += (*MBOrErr)->getBufferSize();
+      return std::move(*MBOrErr);
+    }
+  } else
+    consumeError(FDOrErr.takeError());
+
+  LLVM_DEBUG({
+    dbgs() << "Object cache miss for " << M->getModuleIdentifier() << "\n";
+  });
+  ++Stats.Misses;
+  std::lock_guard<std::mutex> Lock(PendingKeysMutex);
+  PendingKeys[M] = std::move(Key);
+  return nullptr;
+}
+
+void PersistentObjectCache::notifyObjectCompiled(const Module *M,
+                                                 MemoryBufferRef Obj) {
+  std::string Key;
+  {
+    std::lock_guard<std::mutex> Lock(PendingKeysMutex);
+    auto I = PendingKeys.find(M);
+    if (I != PendingKeys.end()) {
+      Key = std::move(I->second);
+      PendingKeys.erase(I);
+    }
+  }
+  if (Key.empty())
+    Key = getCacheKey(*M);
+  std::string EntryPath = getEntryPath(Key);
+
+  // Create the directory lazily so that the filesystem is only touched once
+  // the cache is written.
+  if (auto EC = sys::fs::create_directories(CacheDir)) {
+    LLVM_DEBUG({
+      dbgs() << "Cannot create object cache directory " << CacheDir << ": "
+             << EC.message() << "\n";
+    });
+    return;
+  }
+
+  // Write to a temporary file and rename it into place, so that concurrent
+  // readers (possibly in other processes) never see a partial entry. Name it
+  // so that the pruner ignores it.
+  SmallString<128> TempFileModel(CacheDir);
+  sys::path::append(TempFileModel, "Orc-%%%%%%.tmp.o");
+  Expected<sys::fs::TempFile> Temp = sys::fs::TempFile::create(
+      TempFileModel, sys::fs::owner_read | sys::fs::owner_write);
+  if (!Temp) {
+    Error Err = Temp.takeError();
+    LLVM_DEBUG({
+      dbgs() << "Cannot create object cache temporary file: "
+             << toString(std::move(Err)) << "\n";
+    });
+    consumeError(std::move(Err));
+    return;
+  }
+
+  {
+    raw_fd_ostream OS(Temp->FD, /*shouldClose=*/false);
+    OS << Obj.getBuffer();
+    OS.flush();
+    if (OS.has_error()) {
+      OS.clear_error();
+      consumeError(Temp->discard());
+      return;
+    }
+  }
+
+  // If another process committed the same entry first, the rename replaces
+  // it with an identical object.
+  if (Error Err = Temp->keep(EntryPath)) {
+    LLVM_DEBUG({
+      dbgs() << "Cannot commit object cache entry " << EntryPath << ": "
+             << toString(std::move(Err)) << "\n";
+    });
+    consumeError(std::move(Err));
+    consumeError(Temp->discard());
+    return;
+  }
+  Stats.BytesWritten += Obj.getBufferSize();
+}
+
+bool PersistentObjectCache::prune() { return pruneCache(CacheDir, Policy); }
@@ -0,0 +1,204 @@
+//===----- ProfileGuidedSpeculation.cpp - Profile-driven speculation ------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/ProfileGuidedSpeculation.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/ExecutionEngine/Orc/ObjectTransformLayer.h"
+#include "llvm/IR/GlobalValue.h"
+#include "llvm/ProfileData/InstrProfReader.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/VirtualFileSystem.h"
+
+#define DEBUG_TYPE "orc"
+
+namespace llvm {
+namespace orc {
+
+std::unique_ptr<ProfileGuidedSpeculator>
+ProfileGuidedSpeculator::Create(LLLazyJIT &J, Config C) {
+  assert(C.MaxInFlight && "Speculation needs at least one compile in flight");
+  std::unique_ptr<ProfileGuidedSpeculator> S(
+      new ProfileGuidedSpeculator(J, C));
+
+  J.getCompileOnDemandLayer().setImplMap(&S->ImplMap);
+
+  // Count the bytes of every object that the JIT emits, including the ones
+  // that are not speculated: the budget bounds the JIT's memory.
+  auto &ObjTransformLayer = J.getObjTransformLayer();
+  auto Prev = ObjTransformLayer.getTransform();
+  ObjTransformLayer.setTransform(
+      [EmittedBytes = S->EmittedBytes, Prev = std::move(Prev)](
+          std::unique_ptr<MemoryBuffer> Obj)
+          -> Expected<std::unique_ptr<MemoryBuffer>> {
+        if (Prev) {
+          auto Transformed = Prev(std::move(Obj));
+          if (!Transformed)
+            return Transformed.takeError();
+          Obj = std::move(*Transformed);
+        }
+        if (Obj)
+          *EmittedBytes += Obj->getBufferSize();
+        return std::move(Obj);
+      });
+
+  return S;
+}
+
+Expected<std::vector<ProfileGuidedSpeculator::ProfileEntry>>
+ProfileGuidedSpeculator::readInstrProf(StringRef ProfilePath) {
+  auto FS = vfs::getRealFileSystem();
+  auto ReaderOrErr = IndexedInstrProfReader::create(ProfilePath, *FS);
+  if (!ReaderOrErr)
+    return ReaderOrErr.takeError();
+  auto &Reader = **ReaderOrErr;
+
+  std::vector<ProfileEntry> Profile;
+  for (const auto &Record : Reader) {
+    // Local functions are named "<file>;<name>" (or "<file>:<name>" by
+    // frontend instrumentation).
+    StringRef Name = Record.Name;
+    if (Name.contains(GlobalIdentifierDelimiter) || Name.contains(':'))
+      continue;
+
+    uint64_t Hotness = 0;
+    for (uint64_t Count : Record.Counts)
+      Hotness = SaturatingAdd(Hotness, Count);
+    Profile.push_back({Name.str(), Hotness});
+  }
+  if (Reader.hasError())
+    return Reader.getError();
+
+  return Profile;
+}
+
+ProfileGuidedSpeculator::~ProfileGuidedSpeculator() {
+  cancel();
+  waitForCompletion();
+  J.getCompileOnDemandLayer().setImplMap(nullptr);
+}
+
+void ProfileGuidedSpeculator::speculate(JITDylib &JD,
+                                        ArrayRef<ProfileEntry> Profile) {
+  std::vector<const ProfileEntry *> Hottest;
+  for (auto &Entry : Profile)
+    Hottest.push_back(&Entry);
+  llvm::stable_sort(Hottest, [](const ProfileEntry *LHS,
+                                const ProfileEntry *RHS) {
+    return LHS->second > RHS->second;
+  });
+
+  {
+    std::lock_guard<std::mutex> Lock(M);
+    for (auto *Entry : Hottest)
+      Queue.push_back({&JD, J.mangleAndIntern(Entry->first)});
+  }
+
+  startQueued();
+}
+
+void ProfileGuidedSpeculator::cancel() {
+  std::lock_guard<std::mutex> Lock(M);
+  Queue.clear();
+  if (!InFlight)
+    IdleCV.notify_all();
+}
+
+void ProfileGuidedSpeculator::waitForCompletion() {
+  std::unique_lock<std::mutex> Lock(M);
+  IdleCV.wait(Lock, [this]() { return !InFlight && Queue.empty(); });
+}
+
+void ProfileGuidedSpeculator::startQueued() {
+  // Lookups may complete on this thread, before ES.lookup returns. Only one
+  // thread starts compiles at a time, so that their completions don't recurse
+  // in here.
+  {
+    std::lock_guard<std::mutex> Lock(M);
+    if (Starting)
+      return;
+    Starting = true;
+  }
+
+  while (true) {
+    PendingSpeculation Next;
+    {
+      std::lock_guard<std::mutex> Lock(M);
+      if (C.MemoryBudget && *EmittedBytes >= C.MemoryBudget) {
+        LLVM_DEBUG({
+          if (!Queue.empty())
+            dbgs() << "Speculation memory budget exhausted, dropping "
+                   << Queue.size() << " queued functions\n";
+        });
+        Queue.clear();
+      }
+      if (Queue.empty() || InFlight == C.MaxInFlight) {
+        Starting = false;
+        if (!InFlight && Queue.empty())
+          IdleCV.notify_all();
+        return;
+      }
+      Next = std::move(Queue.front());
+      Queue.pop_front();
+      ++InFlight;
+    }
+
+    // Look up the stub first: that makes the CompileOnDemandLayer emit the
+    // lazy reexports of the module defining it, which records the function's
+    // body in the ImplSymbolMap.
+    auto &ES = J.getExecutionSession();
+    ES.lookup(
+        LookupKind::Static,
+        makeJITDylibSearchOrder(Next.JD, JITDylibLookupFlags::MatchAllSymbols),
+        SymbolLookupSet(Next.Name, SymbolLookupFlags::WeaklyReferencedSymbol),
+        SymbolState::Ready,
+        [this, Name = Next.Name](Expected<SymbolMap> Result) {
+          if (!Result) {
+            J.getExecutionSession().reportError(Result.takeError());
+            return finished();
+          }
+          compileBody(Name);
+        },
+        NoDependenciesToRegister);
+  }
+}
+
+void ProfileGuidedSpeculator::compileBody(SymbolStringPtr Name) {
+  // Functions that are not lazily compiled have no separate body.
+  auto Impl = ImplMap.getImplFor(Name);
+  if (!Impl)
+    return finished();
+
+  LLVM_DEBUG(dbgs() << "Speculatively compiling " << Impl->first << "\n");
+  auto &ES = J.getExecutionSession();
+  ES.lookup(
+      LookupKind::Static,
+      makeJITDylibSearchOrder(Impl->second,
+                              JITDylibLookupFlags::MatchAllSymbols),
+      SymbolLookupSet(Impl->first, SymbolLookupFlags::WeaklyReferencedSymbol),
+      SymbolState::Ready,
+      [this](Expected<SymbolMap> Result) {
+        if (Result)
+          ++NumSpeculated;
+        else
+          J.getExecutionSession().reportError(Result.takeError());
+        finished();
+      },
+      NoDependenciesToRegister);
+}
+
+void ProfileGuidedSpeculator::finished() {
+  {
+    std::lock_guard<std::mutex> Lock(M);
+    --InFlight;
+  }
+  startQueued();
+}
+
+} // end namespace orc
+} // end namespace llvm
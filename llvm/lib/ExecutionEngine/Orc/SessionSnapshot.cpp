@@ -0,0 +1,744 @@
+//===------- SessionSnapshot.cpp - Save and restore linked JIT code -------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/SessionSnapshot.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringSet.h"
+#include "llvm/ExecutionEngine/JITLink/aarch64.h"
+#include "llvm/ExecutionEngine/JITLink/i386.h"
+#include "llvm/ExecutionEngine/JITLink/loongarch.h"
+#include "llvm/ExecutionEngine/JITLink/ppc64.h"
+#include "llvm/ExecutionEngine/JITLink/riscv.h"
+#include "llvm/ExecutionEngine/JITLink/x86_64.h"
+#include "llvm/Support/BinaryByteStream.h"
+#include "llvm/Support/BinaryStreamReader.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/EndianStream.h"
+#include "llvm/Support/raw_ostream.h"
+
+#define DEBUG_TYPE "orc"
+
+using namespace llvm;
+using namespace llvm::jitlink;
+using namespace llvm::orc;
+
+namespace {
+
+constexpr StringLiteral SnapshotMagic = "ORCSNAP1";
+
+// Flags of serialized symbols.
+enum : uint8_t {
+  SymbolHasName = 1U << 0,
+  SymbolIsLive = 1U << 1,
+  SymbolIsCallable = 1U << 2,
+  SymbolIsWeaklyReferenced = 1U << 3,
+};
+
+// Edge kinds are architecture specific, so snapshots are limited to the
+// architectures whose edge kinds are known here.
+LinkGraph::GetEdgeKindNameFunction getEdgeKindNameFunction(const Triple &TT) {
+  switch (TT.getArch()) {
+  case Triple::aarch64:
+    return aarch64::getEdgeKindName;
+  case Triple::loongarch32:
+  case Triple::loongarch64:
+    return loongarch::getEdgeKindName;
+  case Triple::ppc64:
+  case Triple::ppc64le:
+    return ppc64::getEdgeKindName;
+  case Triple::riscv32:
+  case Triple::riscv64:
+    return riscv::getEdgeKindName;
+  case Triple::x86:
+    return i386::getEdgeKindName;
+  case Triple::x86_64:
+    return x86_64::getEdgeKindName;
+  default:
+    return nullptr;
+  }
+}
+
+// Returns the number of bytes at the edge's offset that the fixup of an edge
+// of kind K rewrites, or std::nullopt if the kind is unknown.
+std::optional<size_t> getFixupSize(const Triple &TT, Edge::Kind K) {
+  if (K == Edge::KeepAlive)
+    return 0;
+
+  switch (TT.getArch()) {
+  case Triple::aarch64:
+    switch (K) {
+    case aarch64::Pointer64:
+    case aarch64::Delta64:
+    case aarch64::NegDelta64:
+      return 8;
+    default:
+      // The other kinds are 32-bit data or instructions.
+      if (K > Edge::KeepAlive &&
+          K <= aarch64::RequestTLSDescEntryAndTransformToPageOffset12)
+        return 4;
+      return std::nullopt;
+    }
+  case Triple::loongarch32:
+  case Triple::loongarch64:
+    switch (K) {
+    case loongarch::Pointer64:
+    case loongarch::Delta64:
+      return 8;
+    default:
+      if (K > Edge::KeepAlive &&
+          K <= loongarch::RequestGOTAndTransformToPageOffset12)
+        return 4;
+      return std::nullopt;
+    }
+  case Triple::ppc64:
+  case Triple::ppc64le:
+    switch (K) {
+    case ppc64::Pointer64:
+    case ppc64::Delta64:
+    case ppc64::TOC:
+    case ppc64::Delta34:
+    case ppc64::RequestGOTAndTransformToDelta34:
+    case ppc64::RequestTLSDescInGOTAndTransformToDelta34:
+    // The branch and the nop after it that restores the TOC pointer.
+    case ppc64::CallBranchDeltaRestoreTOC:
+      return 8;
+    case ppc64::Pointer32:
+    case ppc64::Pointer14:
+    case ppc64::Delta32:
+    case ppc64::NegDelta32:
+    case ppc64::CallBranchDelta:
+    case ppc64::RequestCall:
+    case ppc64::RequestCallNoTOC:
+      return 4;
+    default:
+      // The other kinds rewrite a 16-bit immediate.
+      if (K > Edge::KeepAlive &&
+          K <= ppc64::RequestTLSDescInGOTAndTransformToDelta34)
+        return 2;
+      return std::nullopt;
+    }
+  case Triple::riscv32:
+  case Triple::riscv64:
+    switch (K) {
+    case riscv::R_RISCV_64:
+    case riscv::R_RISCV_ADD64:
+    case riscv::R_RISCV_SUB64:
+    // An auipc and a jalr.
+    case riscv::R_RISCV_CALL:
+    case riscv::R_RISCV_CALL_PLT:
+    case riscv::CallRelaxable:
+      return 8;
+    case riscv::R_RISCV_ADD16:
+    case riscv::R_RISCV_SUB16:
+    case riscv::R_RISCV_SET16:
+    case riscv::R_RISCV_RVC_BRANCH:
+    case riscv::R_RISCV_RVC_JUMP:
+      return 2;
+    case riscv::R_RISCV_ADD8:
+    case riscv::R_RISCV_SUB8:
+    case riscv::R_RISCV_SUB6:
+    case riscv::R_RISCV_SET6:
+    case riscv::R_RISCV_SET8:
+      return 1;
+    case riscv::AlignRelaxable:
+      return 0;
+    default:
+      if (K > Edge::KeepAlive && K <= riscv::NegDelta32)
+        return 4;
+      return std::nullopt;
+    }
+  case Triple::x86:
+    switch (K) {
+    case i386::None:
+      return 0;
+    case i386::Pointer16:
+    case i386::PCRel16:
+      return 2;
+    default:
+      if (K > Edge::KeepAlive &&
+          K <= i386::BranchPCRel32ToPtrJumpStubBypassable)
+        return 4;
+      return std::nullopt;
+    }
+  case Triple::x86_64:
+    switch (K) {
+    case x86_64::Pointer64:
+    case x86_64::Delta64:
+    case x86_64::NegDelta64:
+    case x86_64::Delta64FromGOT:
+    case x86_64::RequestGOTAndTransformToDelta64:
+    case x86_64::RequestGOTAndTransformToDelta64FromGOT:
+      return 8;
+    case x86_64::Pointer16:
+    case x86_64::Delta16:
+      return 2;
+    case x86_64::Pointer8:
+    case x86_64::Delta8:
+      return 1;
+    default:
+      if (K > Edge::KeepAlive && K < x86_64::FirstPlatformRelocation)
+        return 4;
+      return std::nullopt;
+    }
+  default:
+    return std::nullopt;
+  }
+}
+
+Error makeMalformedError(const Twine &Msg) {
+  return make_error<StringError>("Malformed session snapshot: " + Msg,
+                                 inconvertibleErrorCode());
+}
+
+void writeString(support::endian::Writer &W, StringRef S) {
+  W.write<uint32_t>(S.size());
+  W.OS << S;
+}
+
+Error readString(BinaryStreamReader &R, StringRef &S) {
+  uint32_t Size;
+  if (auto Err = R.readInteger(Size))
+    return Err;
+  return R.readFixedString(S, Size);
+}
+
+/// Copy S into G, which does not own the names of its sections and symbols.
+StringRef copyString(LinkGraph &G, StringRef S) {
+  auto Buf = G.allocateContent(ArrayRef<char>(S.data(), S.size()));
+  return StringRef(Buf.data(), Buf.size());
+}
+
+} // end anonymous namespace
+
+namespace llvm {
+namespace orc {
+
+Error writeLinkGraph(LinkGraph &G, raw_ostream &OS) {
+  if (!getEdgeKindNameFunction(G.getTargetTriple()))
+    return make_error<StringError>("Session snapshots do not support " +
+                                       G.getTargetTriple().getArchName(),
+                                   inconvertibleErrorCode());
+  if (!G.allocActions().empty())
+    return make_error<StringError>(
+        "Cannot snapshot graph " + G.getName() + " with allocation actions",
+        inconvertibleErrorCode());
+
+  support::endian::Writer W(OS, endianness::little);
+  writeString(W, G.getName());
+  writeString(W, G.getTargetTriple().str());
+  writeString(W, G.getFeatures().getString());
+  W.write<uint8_t>(G.getPointerSize());
+  W.write<uint8_t>(G.getEndianness() == endianness::little ? 0 : 1);
+
+  // Sections and their blocks.
+  std::vector<Block *> Blocks;
+  DenseMap<Block *, uint32_t> BlockIndices;
+  W.write<uint32_t>(G.sections_size());
+  for (auto &Sec : G.sections()) {
+    writeString(W, Sec.getName());
+    W.write<uint8_t>(static_cast<uint8_t>(Sec.getMemProt()));
+    W.write<uint8_t>(static_cast<uint8_t>(Sec.getMemLifetime()));
+    W.write<uint32_t>(Sec.blocks_size());
+    for (auto *B : Sec.blocks()) {
+      BlockIndices[B] = Blocks.size();
+      Blocks.push_back(B);
+      W.write<uint8_t>(B->isZeroFill());
+      W.write<uint64_t>(B->getAddress().getValue());
+      W.write<uint64_t>(B->getAlignment());
+      W.write<uint64_t>(B->getAlignmentOffset());
+      W.write<uint64_t>(B->getSize());
+      if (!B->isZeroFill())
+        OS << StringRef(B->getContent().data(), B->getSize());
+    }
+  }
+
+  // Symbols, numbered in the order that they are written so that edges can
+  // refer to them.
+  DenseMap<Symbol *, uint32_t> SymbolIndices;
+  auto AddSymbolIndex = [&](Symbol *Sym) {
+    uint32_t Index = SymbolIndices.size();
+    SymbolIndices[Sym] = Index;
+  };
+
+  std::vector<Symbol *> Defined(G.defined_symbols().begin(),
+                                G.defined_symbols().end());
+  W.write<uint32_t>(Defined.size());
+  for (auto *Sym : Defined) {
+    AddSymbolIndex(Sym);
+    uint8_t Flags = 0;
+    if (Sym->hasName())
+      Flags |= SymbolHasName;
+    if (Sym->isLive())
+      Flags |= SymbolIsLive;
+    if (Sym->isCallable())
+      Flags |= SymbolIsCallable;
+    W.write<uint32_t>(BlockIndices[&Sym->getBlock()]);
+    W.write<uint64_t>(Sym->getOffset());
+    W.write<uint64_t>(Sym->getSize());
+    W.write<uint8_t>(static_cast<uint8_t>(Sym->getLinkage()));
+    W.write<uint8_t>(static_cast<uint8_t>(Sym->getScope()));
+    W.write<uint8_t>(Flags);
+    W.write<uint8_t>(Sym->getTargetFlags());
+    if (Sym->hasName())
+      writeString(W, Sym->getName());
+  }
+
+  std::vector<Symbol *> Externals(G.external_symbols().begin(),
+                                  G.external_symbols().end());
+  W.write<uint32_t>(Externals.size());
+  for (auto *Sym : Externals) {
+    AddSymbolIndex(Sym);
+    writeString(W, Sym->getName());
+    W.write<uint64_t>(Sym->getSize());
+    W.write<uint8_t>(static_cast<uint8_t>(Sym->getLinkage()));
+    W.write<uint8_t>(Sym->isWeaklyReferenced() ? SymbolIsWeaklyReferenced
+                                               : 0);
+  }
+
+  std::vector<Symbol *> Absolutes(G.absolute_symbols().begin(),
+                                  G.absolute_symbols().end());
+  W.write<uint32_t>(Absolutes.size());
+  for (auto *Sym : Absolutes) {
+    AddSymbolIndex(Sym);
+    writeString(W, Sym->getName());
+    W.write<uint64_t>(Sym->getAddress().getValue());
+    W.write<uint64_t>(Sym->getSize());
+    W.write<uint8_t>(static_cast<uint8_t>(Sym->getLinkage()));
+    W.write<uint8_t>(static_cast<uint8_t>(Sym->getScope()));
+    W.write<uint8_t>(Sym->isLive() ? SymbolIsLive : 0);
+  }
+
+  // Edges, by block.
+  for (auto *B : Blocks) {
+    W.write<uint32_t>(B->edges_size());
+    for (auto &E : B->edges()) {
+      auto I = SymbolIndices.find(&E.getTarget());
+      if (I == SymbolIndices.end())
+        return make_error<StringError>("Edge in graph " + G.getName() +
+                                           " targets a symbol outside it",
+                                       inconvertibleErrorCode());
+      if (!getFixupSize(G.getTargetTriple(), E.getKind()))
+        return make_error<StringError>(
+            Twine("Cannot snapshot edge of kind ") +
+                G.getEdgeKindName(E.getKind()) + " in graph " + G.getName(),
+            inconvertibleErrorCode());
+      W.write<uint8_t>(E.getKind());
+      W.write<uint32_t>(E.getOffset());
+      W.write<uint32_t>(I->second);
+      W.write<int64_t>(E.getAddend());
+    }
+  }
+
+  return Error::success();
+}
+
+Expected<std::unique_ptr<LinkGraph>> readLinkGraph(ArrayRef<uint8_t> Data) {
+  BinaryByteStream Stream(Data, endianness::little);
+  BinaryStreamReader R(Stream);
+
+  StringRef Name, TripleStr, Features;
+  uint8_t PointerSize, Endian;
+  if (auto Err = readString(R, Name))
+    return std::move(Err);
+  if (auto Err = readString(R, TripleStr))
+    return std::move(Err);
+  if (auto Err = readString(R, Features))
+    return std::move(Err);
+  if (auto Err = R.readInteger(PointerSize))
+    return std::move(Err);
+  if (auto Err = R.readInteger(Endian))
+    return std::move(Err);
+
+  Triple TT(TripleStr);
+  auto GetEdgeKindName = getEdgeKindNameFunction(TT);
+  if (!GetEdgeKindName)
+    return makeMalformedError("unsupported triple " + TripleStr);
+  if (Endian > 1)
+    return makeMalformedError("invalid endianness");
+
+  auto G = std::make_unique<LinkGraph>(
+      Name.str(), TT, SubtargetFeatures(Features), PointerSize,
+      Endian ? endianness::big : endianness::little, GetEdgeKindName);
+
+  std::vector<Block *> Blocks;
+  uint32_t NumSections;
+  if (auto Err = R.readInteger(NumSections))
+    return std::move(Err);
+  for (uint32_t I = 0; I != NumSections; ++I) {
+    StringRef SecName;
+    uint8_t Prot, Lifetime;
+    uint32_t NumBlocks;
+    if (auto Err = readString(R, SecName))
+      return std::move(Err);
+    if (auto Err = R.readInteger(Prot))
+      return std::move(Err);
+    if (auto Err = R.readInteger(Lifetime))
+      return std::move(Err);
+    if (auto Err = R.readInteger(NumBlocks))
+      return std::move(Err);
+
+    if (G->findSectionByName(SecName))
+      return makeMalformedError("duplicate section " + SecName);
+    if (Prot & ~static_cast<uint8_t>(MemProt::Read | MemProt::Write |
+                                     MemProt::Exec))
+      return makeMalformedError("invalid protections for section " + SecName);
+    if (Lifetime > static_cast<uint8_t>(MemLifetime::NoAlloc))
+      return makeMalformedError("invalid lifetime for section " + SecName);
+
+    auto &Sec = G->createSection(copyString(*G, SecName),
+                                 static_cast<MemProt>(Prot));
+    Sec.setMemLifetime(static_cast<MemLifetime>(Lifetime));
+
+    for (uint32_t J = 0; J != NumBlocks; ++J) {
+      uint8_t IsZeroFill;
+      uint64_t Addr, Alignment, AlignmentOffset, Size;
+      if (auto Err = R.readInteger(IsZeroFill))
+        return std::move(Err);
+      if (auto Err = R.readInteger(Addr))
+        return std::move(Err);
+      if (auto Err = R.readInteger(Alignment))
+        return std::move(Err);
+      if (auto Err = R.readInteger(AlignmentOffset))
+        return std::move(Err);
+      if (auto Err = R.readInteger(Size))
+        return std::move(Err);
+
+      if (!isPowerOf2_64(Alignment) || AlignmentOffset >= Alignment)
+        return makeMalformedError("invalid alignment of block in section " +
+                                  SecName);
+
+      if (IsZeroFill) {
+        Blocks.push_back(&G->createZeroFillBlock(
+            Sec, Size, ExecutorAddr(Addr), Alignment, AlignmentOffset));
+        continue;
+      }
+
+      ArrayRef<uint8_t> Content;
+      if (auto Err = R.readBytes(Content, Size))
+        return std::move(Err);
+      Blocks.push_back(&G->createMutableContentBlock(
+          Sec,
+          G->allocateContent(ArrayRef<char>(
+              reinterpret_cast<const char *>(Content.data()), Content.size())),
+          ExecutorAddr(Addr), Alignment, AlignmentOffset));
+    }
+  }
+
+  auto ReadLinkageAndScope = [&](uint8_t &L, uint8_t &S) -> Error {
+    if (auto Err = R.readInteger(L))
+      return Err;
+    if (auto Err = R.readInteger(S))
+      return Err;
+    if (L > static_cast<uint8_t>(Linkage::Weak) ||
+        S > static_cast<uint8_t>(Scope::Local))
+      return makeMalformedError("invalid symbol linkage or scope");
+    return Error::success();
+  };
+
+  // Only local symbols may share a name. LinkGraph asserts that external
+  // symbol names are unique.
+  StringSet<> GlobalNames, ExternalNames;
+  std::vector<Symbol *> Symbols;
+  uint32_t NumDefined;
+  if (auto Err = R.readInteger(NumDefined))
+    return std::move(Err);
+  for (uint32_t I = 0; I != NumDefined; ++I) {
+    uint32_t BlockIndex;
+    uint64_t Offset, Size;
+    uint8_t L, S, Flags, TargetFlags;
+    StringRef SymName;
+    if (auto Err = R.readInteger(BlockIndex))
+      return std::move(Err);
+    if (auto Err = R.readInteger(Offset))
+      return std::move(Err);
+    if (auto Err = R.readInteger(Size))
+      return std::move(Err);
+    if (auto Err = ReadLinkageAndScope(L, S))
+      return std::move(Err);
+    if (auto Err = R.readInteger(Flags))
+      return std::move(Err);
+    if (auto Err = R.readInteger(TargetFlags))
+      return std::move(Err);
+    if (Flags & SymbolHasName)
+      if (auto Err = readString(R, SymName))
+        return std::move(Err);
+
+    if (BlockIndex >= Blocks.size() ||
+        Offset > Blocks[BlockIndex]->getSize() ||
+        Size > Blocks[BlockIndex]->getSize() - Offset || TargetFlags > 1)
+      return makeMalformedError("invalid defined symbol");
+    if ((Flags & SymbolHasName) && S != static_cast<uint8_t>(Scope::Local) &&
+        !GlobalNames.insert(SymName).second)
+      return makeMalformedError("duplicate symbol " + SymName);
+
+    Block &B = *Blocks[BlockIndex];
+    bool IsCallable = Flags & SymbolIsCallable;
+    bool IsLive = Flags & SymbolIsLive;
+    Symbol *Sym;
+    if (Flags & SymbolHasName)
+      Sym = &G->addDefinedSymbol(B, Offset, copyString(*G, SymName), Size,
+                                 static_cast<Linkage>(L), static_cast<Scope>(S),
+                                 IsCallable, IsLive);
+    else
+      Sym = &G->addAnonymousSymbol(B, Offset, Size, IsCallable, IsLive);
+    Sym->setTargetFlags(TargetFlags);
+    Symbols.push_back(Sym);
+  }
+
+  uint32_t NumExternals;
+  if (auto Err = R.readInteger(NumExternals))
+    return std::move(Err);
+  for (uint32_t I = 0; I != NumExternals; ++I) {
+    StringRef SymName;
+    uint64_t Size;
+    uint8_t L, Flags;
+    if (auto Err = readString(R, SymName))
+      return std::move(Err);
+    if (auto Err = R.readInteger(Size))
+      return std::move(Err);
+    if (auto Err = R.readInteger(L))
+      return std::move(Err);
+    if (auto Err = R.readInteger(Flags))
+      return std::move(Err);
+
+    if (SymName.empty() || L > static_cast<uint8_t>(Linkage::Weak))
+      return makeMalformedError("invalid external symbol");
+    if (!ExternalNames.insert(SymName).second)
+      return makeMalformedError("duplicate external symbol " + SymName);
+
+    auto &Sym = G->addExternalSymbol(copyString(*G, SymName), Size,
+                                     Flags & SymbolIsWeaklyReferenced);
+    Sym.setLinkage(static_cast<Linkage>(L));
+    Symbols.push_back(&Sym);
+  }
+
+  uint32_t NumAbsolutes;
+  if (auto Err = R.readInteger(NumAbsolutes))
+    return std::move(Err);
+  for (uint32_t I = 0; I != NumAbsolutes; ++I) {
+    StringRef SymName;
+    uint64_t Addr, Size;
+    uint8_t L, S, Flags;
+    if (auto Err = readString(R, SymName))
+      return std::move(Err);
+    if (auto Err = R.readInteger(Addr))
+      return std::move(Err);
+    if (auto Err = R.readInteger(Size))
+      return std::move(Err);
+    if (auto Err = ReadLinkageAndScope(L, S))
+      return std::move(Err);
+    if (auto Err = R.readInteger(Flags))
+      return std::move(Err);
+
+    if (!SymName.empty() && S != static_cast<uint8_t>(Scope::Local) &&
+        !GlobalNames.insert(SymName).second)
+      return makeMalformedError("duplicate symbol " + SymName);
+
+    Symbols.push_back(&G->addAbsoluteSymbol(
+        copyString(*G, SymName), ExecutorAddr(Addr), Size,
+        static_cast<Linkage>(L), static_cast<Scope>(S), Flags & SymbolIsLive));
+  }
+
+  for (auto *B : Blocks) {
+    uint32_t NumEdges;
+    if (auto Err = R.readInteger(NumEdges))
+      return std::move(Err);
+    for (uint32_t I = 0; I != NumEdges; ++I) {
+      uint8_t Kind;
+      uint32_t Offset, TargetIndex;
+      int64_t Addend;
+      if (auto Err = R.readInteger(Kind))
+        return std::move(Err);
+      if (auto Err = R.readInteger(Offset))
+        return std::move(Err);
+      if (auto Err = R.readInteger(TargetIndex))
+        return std::move(Err);
+      if (auto Err = R.readInteger(Addend))
+        return std::move(Err);
+
+      auto FixupSize = getFixupSize(TT, Kind);
+      if (!FixupSize || Offset > B->getSize() ||
+          *FixupSize > B->getSize() - Offset || TargetIndex >= Symbols.size())
+        return makeMalformedError("invalid edge");
+      B->addEdge(Kind, Offset, *Symbols[TargetIndex], Addend);
+    }
+  }
+
+  if (R.bytesRemaining())
+    return makeMalformedError("trailing data after graph " + Name);
+
+  return std::move(G);
+}
+
+Error SessionSnapshotPlugin::save(raw_ostream &OS) {
+  std::lock_guard<std::mutex> Lock(M);
+
+  uint32_t NumGraphs = 0;
+  for (auto &KV : Graphs)
+    NumGraphs += KV.second.size();
+
+  support::endian::Writer W(OS, endianness::little);
+  OS << SnapshotMagic;
+  W.write<uint32_t>(NumGraphs);
+  for (auto &KV : Graphs) {
+    for (auto &RG : KV.second) {
+      writeString(W, RG.JDName);
+      W.write<uint64_t>(RG.Data.size());
+      OS << RG.Data;
+    }
+  }
+
+  return Error::success();
+}
+
+Error SessionSnapshotPlugin::saveToFile(StringRef Path) {
+  std::error_code EC;
+  raw_fd_ostream OS(Path, EC);
+  if (EC)
+    return createFileError(Path, EC);
+  if (auto Err = save(OS))
+    return Err;
+  OS.close();
+  if (OS.has_error())
+    return createFileError(Path, OS.error());
+  return Error::success();
+}
+
+Error SessionSnapshotPlugin::restore(ObjectLinkingLayer &L,
+                                     MemoryBufferRef Snapshot,
+                                     GetJITDylibFunction GetJD) {
+  BinaryByteStream Stream(arrayRefFromStringRef(Snapshot.getBuffer()),
+                          endianness::little);
+  BinaryStreamReader R(Stream);
+
+  StringRef Magic;
+  if (auto Err = R.readFixedString(Magic, SnapshotMagic.size()))
+    consumeError(std::move(Err));
+  if (Magic != SnapshotMagic)
+    return make_error<StringError>(Snapshot.getBufferIdentifier() +
+                                       " is not a session snapshot",
+                                   inconvertibleErrorCode());
+
+  uint32_t NumGraphs;
+  if (auto Err = R.readInteger(NumGraphs))
+    return Err;
+  for (uint32_t I = 0; I != NumGraphs; ++I) {
+    StringRef JDName;
+    uint64_t Size;
+    ArrayRef<uint8_t> Data;
+    if (auto Err = readString(R, JDName))
+      return Err;
+    if (auto Err = R.readInteger(Size))
+      return Err;
+    if (auto Err = R.readBytes(Data, Size))
+      return Err;
+
+    JITDylib *JD = GetJD ? GetJD(JDName)
+                         : L.getExecutionSession().getJITDylibByName(JDName);
+    if (!JD) {
+      if (GetJD)
+        continue;
+      return make_error<StringError>("No JITDylib named " + JDName +
+                                         " to restore snapshot graphs into",
+                                     inconvertibleErrorCode());
+    }
+
+    auto G = readLinkGraph(Data);
+    if (!G)
+      return G.takeError();
+    if (auto Err = L.add(*JD, std::move(*G)))
+      return Err;
+  }
+
+  return Error::success();
+}
+
+size_t SessionSnapshotPlugin::getNumRecordedGraphs() {
+  std::lock_guard<std::mutex> Lock(M);
+  size_t NumGraphs = 0;
+  for (auto &KV : Graphs)
+    NumGraphs += KV.second.size();
+  return NumGraphs;
+}
+
+void SessionSnapshotPlugin::modifyPassConfig(
+    MaterializationResponsibility &MR, LinkGraph &G,
+    PassConfiguration &Config) {
+  if (StringRef(G.getName()).starts_with("<"))
+    return;
+
+  // Record the graph before any other pass changes it.
+  Config.PrePrunePasses.insert(
+      Config.PrePrunePasses.begin(), [this, &MR](LinkGraph &G) {
+        RecordedGraph RG;
+        RG.JDName = MR.getTargetJITDylib().getName();
+        raw_string_ostream OS(RG.Data);
+        if (auto Err = writeLinkGraph(G, OS)) {
+          // The graph is still linked, it is just missing from snapshots.
+          LLVM_DEBUG({
+            dbgs() << "Not recording " << G.getName()
+                   << " for session snapshots: " << Err << "\n";
+          });
+          consumeError(std::move(Err));
+          return Error::success();
+        }
+
+        std::lock_guard<std::mutex> Lock(M);
+        InFlightGraphs[&MR] = std::move(RG);
+        return Error::success();
+      });
+}
+
+Error SessionSnapshotPlugin::notifyEmitted(MaterializationResponsibility &MR) {
+  RecordedGraph RG;
+  {
+    std::lock_guard<std::mutex> Lock(M);
+    auto I = InFlightGraphs.find(&MR);
+    if (I == InFlightGraphs.end())
+      return Error::success();
+    RG = std::move(I->second);
+    InFlightGraphs.erase(I);
+  }
+
+  // The session lock is held while the resource key is used, so only take
+  // our lock inside it, as notifyRemovingResources does.
+  return MR.withResourceKeyDo([&](ResourceKey K) {
+    std::lock_guard<std::mutex> Lock(M);
+    Graphs[K].push_back(std::move(RG));
+  });
+}
+
+Error SessionSnapshotPlugin::notifyFailed(MaterializationResponsibility &MR) {
+  std::lock_guard<std::mutex> Lock(M);
+  InFlightGraphs.erase(&MR);
+  return Error::success();
+}
+
+Error SessionSnapshotPlugin::notifyRemovingResources(JITDylib &JD,
+                                                     ResourceKey K) {
+  std::lock_guard<std::mutex> Lock(M);
+  Graphs.erase(K);
+  return Error::success();
+}
+
+void SessionSnapshotPlugin::notifyTransferringResources(JITDylib &JD,
+                                                        ResourceKey DstKey,
+                                                        ResourceKey SrcKey) {
+  std::lock_guard<std::mutex> Lock(M);
+  auto I = Graphs.find(SrcKey);
+  if (I == Graphs.end())
+    return;
+  auto SrcGraphs = std::move(I->second);
+  Graphs.erase(I);
+  auto &DstGraphs = Graphs[DstKey];
+  DstGraphs.insert(DstGraphs.end(), std::make_move_iterator(SrcGraphs.begin()),
+                   std::make_move_iterator(SrcGraphs.end()));
+}
+
+} // end namespace orc
+} // end namespace llvm
@@ -80,6 +80,107 @@ void DynamicThreadPoolTaskDispatcher::shutdown() {
   Running = false;
   OutstandingCV.wait(Lock, [this]() { return Outstanding == 0; });
 }
+
+namespace {
+// The WorkStealingTaskDispatcher worker running on this thread, if any.
+struct CurrentWorker {
+  const WorkStealingTaskDispatcher *D = nullptr;
+  size_t Index = 0;
+};
+} // namespace
+
+static thread_local CurrentWorker ThisWorker;
+
+WorkStealingTaskDispatcher::WorkStealingTaskDispatcher(size_t NumThreads) {
+  assert(NumThreads && "WorkStealingTaskDispatcher needs at least one thread");
+  for (size_t I = 0; I != NumThreads; ++I)
+    Queues.push_back(std::make_unique<WorkerQueue>());
+  for (size_t I = 0; I != NumThreads; ++I)
+    Threads.emplace_back([this, I]() { runWorker(I); });
+}
+
+WorkStealingTaskDispatcher::~WorkStealingTaskDispatcher() { shutdown(); }
+
+void WorkStealingTaskDispatcher::dispatch(std::unique_ptr<Task> T) {
+  if (ThisWorker.D == this) {
+    auto &Q = *Queues[ThisWorker.Index];
+    std::lock_guard<std::mutex> Lock(Q.M);
+    Q.Tasks.push_front(std::move(T));
+  } else {
+    auto &Q = *Queues[NextQueue++ % Queues.size()];
+    std::lock_guard<std::mutex> Lock(Q.M);
+    Q.Tasks.push_back(std::move(T));
+  }
+
+  {
+    std::lock_guard<std::mutex> Lock(StateMutex);
+    ++Unclaimed;
+    ++Outstanding;
+  }
+  WorkAvailableCV.notify_one();
+}
+
+void WorkStealingTaskDispatcher::shutdown() {
+  std::unique_lock<std::mutex> Lock(StateMutex);
+  if (Stopping)
+    return;
+  OutstandingCV.wait(Lock, [this]() { return Outstanding == 0; });
+  Stopping = true;
+  Lock.unlock();
+
+  WorkAvailableCV.notify_all();
+  for (auto &T : Threads)
+    T.join();
+  Threads.clear();
+}
+
+std::unique_ptr<Task> WorkStealingTaskDispatcher::takeTask(size_t Index) {
+  // The caller has claimed a task, so one is queued somewhere even if other
+  // workers take the ones we see first.
+  while (true) {
+    {
+      auto &Q = *Queues[Index];
+      std::lock_guard<std::mutex> Lock(Q.M);
+      if (!Q.Tasks.empty()) {
+        auto T = std::move(Q.Tasks.front());
+        Q.Tasks.pop_front();
+        return T;
+      }
+    }
+
+    for (size_t I = 1; I != Queues.size(); ++I) {
+      auto &Q = *Queues[(Index + I) % Queues.size()];
+      std::lock_guard<std::mutex> Lock(Q.M);
+      if (!Q.Tasks.empty()) {
+        auto T = std::move(Q.Tasks.back());
+        Q.Tasks.pop_back();
+        ++NumStolenTasks;
+        return T;
+      }
+    }
+  }
+}
+
+void WorkStealingTaskDispatcher::runWorker(size_t Index) {
+  ThisWorker.D = this;
+  ThisWorker.Index = Index;
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> Lock(StateMutex);
+      WorkAvailableCV.wait(Lock, [this]() { return Unclaimed || Stopping; });
+      if (!Unclaimed)
+        return;
+      --Unclaimed;
+    }
+
+    takeTask(Index)->run();
+
+    std::lock_guard<std::mutex> Lock(StateMutex);
+    if (--Outstanding == 0)
+      OutstandingCV.notify_all();
+  }
+}
 #endif
 
 } // namespace orc
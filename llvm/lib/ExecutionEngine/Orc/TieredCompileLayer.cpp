@@ -0,0 +1,304 @@
+//===--- TieredCompileLayer.cpp - Recompile hot functions -----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/TieredCompileLayer.h"
+#include "llvm/ExecutionEngine/Orc/Mangling.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/Debug.h"
+
+#define DEBUG_TYPE "orc"
+
+using namespace llvm;
+using namespace llvm::orc;
+
+TieredCompileLayer::TieredCompileLayer(
+    ExecutionSession &ES, IRLayer &BaseLayer, IRLayer &HotLayer,
+    IndirectStubsManagerBuilder BuildIndirectStubsManager)
+    : IRLayer(ES, BaseLayer.getManglingOptions()), BaseLayer(BaseLayer),
+      HotLayer(HotLayer),
+      BuildIndirectStubsManager(std::move(BuildIndirectStubsManager)) {}
+
+void TieredCompileLayer::emit(std::unique_ptr<MaterializationResponsibility> R,
+                              ThreadSafeModule TSM) {
+  assert(TSM && "Null module");
+
+  // Modules without functions are emitted as they are.
+  if (none_of(R->getSymbols(),
+              [](const auto &KV) { return KV.second.isCallable(); })) {
+    BaseLayer.emit(std::move(R), std::move(TSM));
+    return;
+  }
+
+  auto &ES = getExecutionSession();
+  auto &PDR = getPerDylibResources(R->getTargetJITDylib());
+
+  // Promote the local symbols, so that the hot tier of a function can refer to
+  // the symbols of its module, and keep a copy of the module to build the hot
+  // tiers from.
+  TSM.withModuleDo([&](Module &M) {
+    std::lock_guard<std::mutex> Lock(TieredLayerMutex);
+    PromoteSymbols(M);
+  });
+  auto SourceModule =
+      std::make_shared<ThreadSafeModule>(cloneToNewContext(TSM));
+
+  // Move the bodies of the callable symbols to tier-0 functions. The callable
+  // symbols themselves are provided by stubs.
+  SymbolFlagsMap Callables;
+  SymbolAliasMap NonCallables;
+  DenseMap<SymbolStringPtr, SymbolStringPtr> Tier0Bodies;
+  IndirectStubsManager::StubInitsMap StubInits;
+  TSM.withModuleDo([&](Module &M) {
+    MangleAndInterner Mangle(ES, M.getDataLayout());
+    for (auto &F : make_early_inc_range(M.functions())) {
+      // An alias can't refer to a declaration, so functions with aliases are
+      // left untouched.
+      if (F.isDeclaration() || F.hasAvailableExternallyLinkage() ||
+          any_of(F.users(), [](User *U) { return isa<GlobalAlias>(U); }))
+        continue;
+
+      auto StubName = Mangle(F.getName());
+      auto I = R->getSymbols().find(StubName);
+      if (I == R->getSymbols().end() || !I->second.isCallable())
+        continue;
+
+      uint64_t Id;
+      {
+        std::lock_guard<std::mutex> Lock(TieredLayerMutex);
+        Id = Functions.size();
+        Functions.push_back({&PDR, SourceModule, F.getName().str(), StubName,
+                             Mangle((F.getName() + ".tier1").str())});
+      }
+      Function &Body = createTier0Body(F, Id);
+
+      Callables[StubName] = I->second;
+      Tier0Bodies[StubName] = Mangle(Body.getName());
+      StubInits[*StubName] = {ExecutorAddr(), I->second};
+    }
+  });
+
+  for (auto &[Name, Flags] : R->getSymbols())
+    if (!Callables.count(Name))
+      NonCallables[Name] = SymbolAliasMapEntry(Name, Flags);
+
+  // Lodge the tier-0 module with the implementation dylib, and re-export its
+  // non-callable symbols.
+  if (auto Err = BaseLayer.add(PDR.ImplD, std::move(TSM))) {
+    ES.reportError(std::move(Err));
+    R->failMaterialization();
+    return;
+  }
+  if (!NonCallables.empty())
+    if (auto Err =
+            R->replace(reexports(PDR.ImplD, std::move(NonCallables),
+                                 JITDylibLookupFlags::MatchAllSymbols))) {
+      ES.reportError(std::move(Err));
+      R->failMaterialization();
+      return;
+    }
+  if (Callables.empty())
+    return;
+
+  // Resolve the callable symbols to their stubs right away: the tier-0 bodies
+  // may call each other through them, so they can't be resolved first.
+  if (auto Err = PDR.ISMgr->createStubs(StubInits)) {
+    ES.reportError(std::move(Err));
+    R->failMaterialization();
+    return;
+  }
+  SymbolMap Stubs;
+  for (auto &[Name, Flags] : Callables)
+    Stubs[Name] = PDR.ISMgr->findStub(*Name, false);
+  if (auto Err = R->notifyResolved(Stubs)) {
+    ES.reportError(std::move(Err));
+    R->failMaterialization();
+    return;
+  }
+
+  // Once the tier-0 bodies are resolved, point the stubs at them. The stubs
+  // are ready once the bodies are.
+  SymbolNameSet StubNames, Tier0Names;
+  for (auto &[StubName, Tier0Name] : Tier0Bodies) {
+    StubNames.insert(StubName);
+    Tier0Names.insert(Tier0Name);
+  }
+  ES.lookup(
+      LookupKind::Static,
+      makeJITDylibSearchOrder(&PDR.ImplD, JITDylibLookupFlags::MatchAllSymbols),
+      SymbolLookupSet(Tier0Names), SymbolState::Resolved,
+      [&ES, &PDR, R = std::move(R), Tier0Bodies = std::move(Tier0Bodies),
+       StubNames = std::move(StubNames),
+       Tier0Names = std::move(Tier0Names)](Expected<SymbolMap> Result) mutable {
+        if (!Result) {
+          ES.reportError(Result.takeError());
+          R->failMaterialization();
+          return;
+        }
+        for (auto &[StubName, Tier0Name] : Tier0Bodies) {
+          assert(Result->count(Tier0Name) && "Tier-0 body not resolved");
+          if (auto Err = PDR.ISMgr->updatePointer(
+                  *StubName, (*Result)[Tier0Name].getAddress())) {
+            ES.reportError(std::move(Err));
+            R->failMaterialization();
+            return;
+          }
+        }
+        SymbolDependenceGroup DepGroup{std::move(StubNames),
+                                       {{&PDR.ImplD, std::move(Tier0Names)}}};
+        if (auto Err = R->notifyEmitted(DepGroup)) {
+          ES.reportError(std::move(Err));
+          R->failMaterialization();
+        }
+      },
+      NoDependenciesToRegister);
+}
+
+TieredCompileLayer::PerDylibResources &
+TieredCompileLayer::getPerDylibResources(JITDylib &TargetD) {
+  std::lock_guard<std::mutex> Lock(TieredLayerMutex);
+
+  auto I = DylibResources.find(&TargetD);
+  if (I == DylibResources.end()) {
+    auto &ImplD =
+        getExecutionSession().createBareJITDylib(TargetD.getName() + ".tiered");
+    JITDylibSearchOrder NewLinkOrder;
+    TargetD.withLinkOrderDo([&](const JITDylibSearchOrder &TargetLinkOrder) {
+      NewLinkOrder = TargetLinkOrder;
+    });
+
+    assert(!NewLinkOrder.empty() && NewLinkOrder.front().first == &TargetD &&
+           NewLinkOrder.front().second ==
+               JITDylibLookupFlags::MatchAllSymbols &&
+           "TargetD must be at the front of its own search order and match "
+           "non-exported symbol");
+    NewLinkOrder.insert(std::next(NewLinkOrder.begin()),
+                        {&ImplD, JITDylibLookupFlags::MatchAllSymbols});
+    ImplD.setLinkOrder(NewLinkOrder, false);
+    TargetD.setLinkOrder(std::move(NewLinkOrder), false);
+
+    PerDylibResources PDR(ImplD, BuildIndirectStubsManager());
+    I = DylibResources.insert(std::make_pair(&TargetD, std::move(PDR))).first;
+  }
+
+  return I->second;
+}
+
+Function &TieredCompileLayer::createTier0Body(Function &F, uint64_t Id) {
+  Module &M = *F.getParent();
+  LLVMContext &Ctx = M.getContext();
+
+  // Move the body of F to a new function. The uses of F, including the calls
+  // from within its module, remain uses of the declaration.
+  auto *Body =
+      Function::Create(F.getFunctionType(), GlobalValue::ExternalLinkage,
+                       F.getAddressSpace(), F.getName() + ".tier0", &M);
+  Body->copyAttributesFrom(&F);
+  Body->setLinkage(GlobalValue::ExternalLinkage);
+  Body->setVisibility(GlobalValue::HiddenVisibility);
+  Body->setComdat(nullptr);
+  Body->copyMetadata(&F, 0);
+  Body->splice(Body->end(), &F);
+  for (auto [FromArg, ToArg] : zip(F.args(), Body->args())) {
+    ToArg.takeName(&FromArg);
+    FromArg.replaceAllUsesWith(&ToArg);
+  }
+  F.setLinkage(GlobalValue::ExternalLinkage);
+  F.setComdat(nullptr);
+  F.setPersonalityFn(nullptr);
+  F.clearMetadata();
+
+  // Count the calls after the static allocas of the entry block, and notify
+  // the layer when the threshold is reached.
+  auto *Int64Ty = Type::getInt64Ty(Ctx);
+  auto *Counter = new GlobalVariable(M, Int64Ty, false,
+                                     GlobalValue::InternalLinkage,
+                                     ConstantInt::get(Int64Ty, 0),
+                                     F.getName() + ".count");
+  BasicBlock &Entry = Body->getEntryBlock();
+  BasicBlock *Rest = Entry.splitBasicBlock(Entry.getFirstNonPHIOrDbgOrAlloca());
+  BasicBlock *Hot = BasicBlock::Create(Ctx, "hot", Body, Rest);
+  Entry.getTerminator()->eraseFromParent();
+
+  IRBuilder<> Builder(&Entry);
+  auto *Calls = Builder.CreateAtomicRMW(
+      AtomicRMWInst::Add, Counter, ConstantInt::get(Int64Ty, 1), MaybeAlign(),
+      AtomicOrdering::Monotonic);
+  auto *IsHot = Builder.CreateICmpEQ(
+      Calls, ConstantInt::get(Int64Ty, HotCallThreshold - 1));
+  Builder.CreateCondBr(IsHot, Hot, Rest);
+
+  Builder.SetInsertPoint(Hot);
+  auto *PtrTy = PointerType::getUnqual(Ctx);
+  auto *IntPtrTy = M.getDataLayout().getIntPtrType(Ctx);
+  auto *NotifyTy = FunctionType::get(Type::getVoidTy(Ctx), {PtrTy, Int64Ty},
+                                     /*isVarArg=*/false);
+  auto AsConstantPtr = [&](ExecutorAddr Addr) {
+    return ConstantExpr::getIntToPtr(
+        ConstantInt::get(IntPtrTy, Addr.getValue()), PtrTy);
+  };
+  Builder.CreateCall(NotifyTy,
+                     AsConstantPtr(ExecutorAddr::fromPtr(&notifyHot)),
+                     {AsConstantPtr(ExecutorAddr::fromPtr(this)),
+                      ConstantInt::get(Int64Ty, Id)});
+  Builder.CreateBr(Rest);
+
+  return *Body;
+}
+
+void TieredCompileLayer::notifyHot(TieredCompileLayer *Layer, uint64_t Id) {
+  // Recompile on a task, so that the caller only waits for it if the session
+  // has no threads to run it on.
+  Layer->getExecutionSession().dispatchTask(makeGenericNamedTask(
+      [Layer, Id]() { Layer->emitHotFunction(Id); },
+      "TieredCompileLayer hot function compile"));
+}
+
+void TieredCompileLayer::emitHotFunction(uint64_t Id) {
+  auto &ES = getExecutionSession();
+  TieredFunction TF;
+  {
+    std::lock_guard<std::mutex> Lock(TieredLayerMutex);
+    TF = Functions[Id];
+  }
+
+  // Extract the function from the source module, leaving every other global as
+  // a declaration. As the local symbols have been promoted, these resolve to
+  // the definitions in the tier-0 module.
+  auto TSM = cloneToNewContext(*TF.SourceModule, [&](const GlobalValue &GV) {
+    return GV.getName() == TF.Name;
+  });
+  TSM.withModuleDo([&](Module &M) {
+    M.setModuleIdentifier((M.getModuleIdentifier() + ".tier1." + TF.Name));
+    Function *F = M.getFunction(TF.Name);
+    assert(F && !F->isDeclaration() && "Function not cloned");
+    F->setName(TF.Name + ".tier1");
+    F->setLinkage(GlobalValue::ExternalLinkage);
+  });
+
+  if (auto Err = HotLayer.add(TF.PDR->ImplD, std::move(TSM))) {
+    ES.reportError(std::move(Err));
+    return;
+  }
+  auto HotBody = ES.lookup(
+      makeJITDylibSearchOrder(&TF.PDR->ImplD,
+                              JITDylibLookupFlags::MatchAllSymbols),
+      TF.HotName);
+  if (!HotBody) {
+    ES.reportError(HotBody.takeError());
+    return;
+  }
+
+  // Pointer-sized writes are atomic on the hosts that have stubs, so callers
+  // see either the old or the new body.
+  LLVM_DEBUG(dbgs() << "Tiered up " << TF.Name << "\n");
+  if (auto Err =
+          TF.PDR->ISMgr->updatePointer(*TF.StubName, HotBody->getAddress()))
+    ES.reportError(std::move(Err));
+}
@@ -151,7 +151,7 @@ LLVMContextImpl::~LLVMContextImpl() {
 }
 
 void LLVMContextImpl::dropTriviallyDeadConstantArrays() {
-  SmallSetVector<ConstantArray *, 4> WorkList;
+  SmallVector<ConstantArray *, 4> Candidates;
 
   // When ArrayConstants are of substantial size and only a few in them are
   // dead, starting WorkList with all elements of ArrayConstants can be
@@ -159,7 +159,15 @@ void LLVMContextImpl::dropTriviallyDeadConstantArrays() {
   // uses.
   for (ConstantArray *C : ArrayConstants)
     if (C->use_empty())
-      WorkList.insert(C);
+      Candidates.push_back(C);
+
+  dropTriviallyDeadConstantArrays(Candidates);
+}
+
+void LLVMContextImpl::dropTriviallyDeadConstantArrays(
+    ArrayRef<ConstantArray *> Candidates) {
+  SmallSetVector<ConstantArray *, 4> WorkList;
+  WorkList.insert(Candidates.begin(), Candidates.end());
 
   while (!WorkList.empty()) {
     ConstantArray *C = WorkList.pop_back_val();
@@ -177,6 +185,11 @@ void Module::dropTriviallyDeadConstantArrays() {
   Context.pImpl->dropTriviallyDeadConstantArrays();
 }
 
+void Module::dropTriviallyDeadConstantArrays(
+    ArrayRef<ConstantArray *> Candidates) {
+  Context.pImpl->dropTriviallyDeadConstantArrays(Candidates);
+}
+
 namespace llvm {
 
 /// Make MDOperand transparent for hashing.
@@ -1686,6 +1686,9 @@ public:
   /// Destroy the ConstantArrays if they are not used.
   void dropTriviallyDeadConstantArrays();
 
+  /// Destroy the unused ConstantArrays reachable from \p Candidates.
+  void dropTriviallyDeadConstantArrays(ArrayRef<ConstantArray *> Candidates);
+
   mutable OptPassGate *OPG = nullptr;
 
   /// Access the object which can disable optional passes and individual
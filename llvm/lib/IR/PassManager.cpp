@@ -8,7 +8,10 @@
 
 #include "llvm/IR/PassManager.h"
 #include "llvm/IR/Module.h"
+#include "llvm/IR/PassInstrumentation.h"
 #include "llvm/IR/PassManagerImpl.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
 #include <optional>
 
 using namespace llvm;
@@ -157,6 +160,95 @@ void llvm::printIRUnitNameForStackTrace<Function>(raw_ostream &OS,
   OS << "function \"" << IR.getName() << "\"";
 }
 
+AnalysisInvalidationTracker::AnalysisStats &
+AnalysisInvalidationTracker::getStats(AnalysisKey *ID, StringRef Name) {
+  AnalysisStats &S = Stats[ID];
+  S.Name = Name;
+  return S;
+}
+
+// Every pass manager queries PassInstrumentationAnalysis around every pass, and
+// it is never invalidated, so it is left out of the statistics.
+
+void AnalysisInvalidationTracker::recordComputed(AnalysisKey *ID,
+                                                 StringRef Name,
+                                                 const void *IR) {
+  if (ID == PassInstrumentationAnalysis::ID())
+    return;
+  AnalysisStats &S = getStats(ID, Name);
+  ++S.Computed;
+  auto [It, Inserted] = Results.try_emplace({ID, IR});
+  if (!Inserted && !It->second.IsLive)
+    ++S.Recomputed;
+  It->second = {0, true};
+}
+
+void AnalysisInvalidationTracker::recordCacheHit(AnalysisKey *ID,
+                                                 StringRef Name,
+                                                 const void *IR) {
+  if (ID == PassInstrumentationAnalysis::ID())
+    return;
+  ++getStats(ID, Name).CacheHits;
+  ++Results[{ID, IR}].CacheHits;
+}
+
+void AnalysisInvalidationTracker::recordPreserved(AnalysisKey *ID,
+                                                  StringRef Name,
+                                                  const void *IR) {
+  if (ID == PassInstrumentationAnalysis::ID())
+    return;
+  ++getStats(ID, Name).Preserved;
+}
+
+void AnalysisInvalidationTracker::recordInvalidated(AnalysisKey *ID,
+                                                    StringRef Name,
+                                                    const void *IR) {
+  if (ID == PassInstrumentationAnalysis::ID())
+    return;
+  AnalysisStats &S = getStats(ID, Name);
+  ++S.Invalidated;
+  ResultState &R = Results[{ID, IR}];
+  if (R.CacheHits == 0)
+    ++S.Unused;
+  R.IsLive = false;
+}
+
+void AnalysisInvalidationTracker::recordCleared(AnalysisKey *ID,
+                                                const void *IR) {
+  Results.erase({ID, IR});
+}
+
+void AnalysisInvalidationTracker::print(raw_ostream &OS) const {
+  std::vector<const AnalysisStats *> Sorted;
+  unsigned Computed = 0, Recomputed = 0;
+  for (const auto &Entry : Stats) {
+    Sorted.push_back(&Entry.second);
+    Computed += Entry.second.Computed;
+    Recomputed += Entry.second.Recomputed;
+  }
+  llvm::sort(Sorted, [](const AnalysisStats *L, const AnalysisStats *R) {
+    if (L->Recomputed != R->Recomputed)
+      return L->Recomputed > R->Recomputed;
+    return L->Name < R->Name;
+  });
+
+  OS << "===" << std::string(73, '-') << "===\n"
+     << "                      Analysis invalidation report\n"
+     << "===" << std::string(73, '-') << "===\n"
+     << "  Total: " << Computed << " results computed, " << Recomputed
+     << " after being invalidated on the same IR unit\n\n"
+     << "  Computed   Cached     Kept  Invalid.  Recomp.   Unused  Analysis\n";
+  for (const AnalysisStats *S : Sorted)
+    OS << format("%10u %8u %8u %9u %8u %8u  ", S->Computed, S->CacheHits,
+                 S->Preserved, S->Invalidated, S->Recomputed, S->Unused)
+       << S->Name << "\n";
+}
+
+void AnalysisInvalidationTracker::reset() {
+  Stats.clear();
+  Results.clear();
+}
+
 AnalysisSetKey CFGAnalyses::SetKey;
 
 AnalysisSetKey PreservedAnalyses::AllAnalysesKey;
@@ -33,6 +33,20 @@ const char TimeIRParsingDescription[] = "Parse IR";
 std::unique_ptr<Module>
 llvm::getLazyIRModule(std::unique_ptr<MemoryBuffer> Buffer, SMDiagnostic &Err,
                       LLVMContext &Context, bool ShouldLazyLoadMetadata) {
+  if (isCompressedBitcode((const unsigned char *)Buffer->getBufferStart(),
+                          (const unsigned char *)Buffer->getBufferEnd())) {
+    Expected<std::unique_ptr<MemoryBuffer>> BitcodeOrErr =
+        decompressBitcode(Buffer->getMemBufferRef());
+    if (Error E = BitcodeOrErr.takeError()) {
+      handleAllErrors(std::move(E), [&](ErrorInfoBase &EIB) {
+        Err = SMDiagnostic(Buffer->getBufferIdentifier(), SourceMgr::DK_Error,
+                           EIB.message());
+      });
+      return nullptr;
+    }
+    Buffer = std::move(*BitcodeOrErr);
+  }
+
   if (isBitcode((const unsigned char *)Buffer->getBufferStart(),
                 (const unsigned char *)Buffer->getBufferEnd())) {
     Expected<std::unique_ptr<Module>> ModuleOrErr = getOwningLazyBitcodeModule(
@@ -72,6 +86,24 @@ std::unique_ptr<Module> llvm::parseIR(MemoryBufferRef Buffer, SMDiagnostic &Err,
   NamedRegionTimer T(TimeIRParsingName, TimeIRParsingDescription,
                      TimeIRParsingGroupName, TimeIRParsingGroupDescription,
                      TimePassesIsEnabled);
+  // The module does not refer to the bitcode once it is fully parsed, so the
+  // decompressed bitcode only needs to live until then.
+  std::unique_ptr<MemoryBuffer> Decompressed;
+  if (isCompressedBitcode((const unsigned char *)Buffer.getBufferStart(),
+                          (const unsigned char *)Buffer.getBufferEnd())) {
+    Expected<std::unique_ptr<MemoryBuffer>> BitcodeOrErr =
+        decompressBitcode(Buffer);
+    if (Error E = BitcodeOrErr.takeError()) {
+      handleAllErrors(std::move(E), [&](ErrorInfoBase &EIB) {
+        Err = SMDiagnostic(Buffer.getBufferIdentifier(), SourceMgr::DK_Error,
+                           EIB.message());
+      });
+      return nullptr;
+    }
+    Decompressed = std::move(*BitcodeOrErr);
+    Buffer = Decompressed->getMemBufferRef();
+  }
+
   if (isBitcode((const unsigned char *)Buffer.getBufferStart(),
                 (const unsigned char *)Buffer.getBufferEnd())) {
     Expected<std::unique_ptr<Module>> ModuleOrErr =
@@ -1677,6 +1677,28 @@ ThinBackend lto::createWriteIndexesThinBackend(
       };
 }
 
+/// Estimate the cost of the ThinLTO backend for a module from the combined
+/// index: the number of instructions of the functions it defines and of the
+/// functions it imports.
+static uint64_t
+getBackendCost(const ModuleSummaryIndex &Index,
+               const GVSummaryMapTy &DefinedGlobals,
+               const FunctionImporter::ImportMapTy &ImportList) {
+  uint64_t Cost = 0;
+  for (const auto &[GUID, Summary] : DefinedGlobals)
+    if (auto *FS = dyn_cast<FunctionSummary>(Summary->getBaseObject()))
+      Cost += FS->instCount();
+  for (const auto &[FromModule, GUID, Kind] : ImportList) {
+    if (Kind != GlobalValueSummary::Definition)
+      continue;
+    if (GlobalValueSummary *Summary =
+            Index.findSummaryInModule(GUID, FromModule))
+      if (auto *FS = dyn_cast<FunctionSummary>(Summary->getBaseObject()))
+        Cost += FS->instCount();
+  }
+  return Cost;
+}
+
 Error LTO::runThinLTO(AddStreamFn AddStream, FileCache Cache,
                       const DenseSet<GlobalValue::GUID> &GUIDPreservedSymbols) {
   LLVM_DEBUG(dbgs() << "Running ThinLTO\n");
@@ -1864,15 +1886,26 @@ Error LTO::runThinLTO(AddStreamFn AddStream, FileCache Cache,
         if (Error E = ProcessOneModule(I))
           return E;
     } else {
-      // When executing in parallel, process largest bitsize modules first to
-      // improve parallelism, and avoid starving the thread pool near the end.
-      // This saves about 15 sec on a 36-core machine while link `clang.exe`
-      // (out of 100 sec).
-      std::vector<BitcodeModule *> ModulesVec;
-      ModulesVec.reserve(ModuleMap.size());
+      // When executing in parallel, process the most expensive modules first
+      // to improve parallelism, and avoid starving the thread pool near the
+      // end. This saves about 15 sec on a 36-core machine while link
+      // `clang.exe` (out of 100 sec).
+      std::vector<uint64_t> Costs;
+      Costs.reserve(ModuleMap.size());
       for (auto &Mod : ModuleMap)
-        ModulesVec.push_back(&Mod.second);
-      for (int I : generateModulesOrdering(ModulesVec))
+        Costs.push_back(getBackendCost(ThinLTO.CombinedIndex,
+                                       ModuleToDefinedGVSummaries[Mod.first],
+                                       ImportLists[Mod.first]));
+      auto Seq = llvm::seq<int>(0, ModuleMap.size());
+      std::vector<int> ModulesOrdering(Seq.begin(), Seq.end());
+      llvm::stable_sort(ModulesOrdering, [&](int LeftIndex, int RightIndex) {
+        auto LSize = (ModuleMap.begin() + LeftIndex)->second.getBuffer().size();
+        auto RSize =
+            (ModuleMap.begin() + RightIndex)->second.getBuffer().size();
+        return std::make_pair(Costs[LeftIndex], LSize) >
+               std::make_pair(Costs[RightIndex], RSize);
+      });
+      for (int I : ModulesOrdering)
         if (Error E = ProcessOneModule(I))
           return E;
     }
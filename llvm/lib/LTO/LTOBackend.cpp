@@ -120,7 +120,9 @@ Error Config::addSaveTemps(std::string OutputFileName, bool UseInputModulePath,
         PathPrefix = M.getModuleIdentifier() + ".";
       std::string Path = PathPrefix + PathSuffix + ".bc";
       std::error_code EC;
-      raw_fd_ostream OS(Path, EC, sys::fs::OpenFlags::OF_None);
+      // A raw_fd_stream lets the bitcode writer flush as it goes instead of
+      // building the whole file in memory first.
+      raw_fd_stream OS(Path, EC);
       // Because -save-temps is a debugging feature, we report the error
       // directly and exit.
       if (EC)
@@ -456,13 +458,17 @@ static void splitCodeGen(const Config &C, TargetMachine *TM,
 
         // Enqueue the task
         CodegenThreadPool.async(
-            [&](const SmallString<0> &BC, unsigned ThreadId) {
+            [&](SmallString<0> &BC, unsigned ThreadId) {
               LTOLLVMContext Ctx(C);
               Expected<std::unique_ptr<Module>> MOrErr =
                   parseBitcodeFile(MemoryBufferRef(BC.str(), "ld-temp.o"), Ctx);
               if (!MOrErr)
                 report_fatal_error("Failed to read bitcode");
               std::unique_ptr<Module> MPartInCtx = std::move(MOrErr.get());
+              // The module is fully materialized, so the bitcode is no longer
+              // needed. Free it now rather than when the task is destroyed, as
+              // all partitions are in memory at once during codegen.
+              (void)SmallString<0>(std::move(BC));
 
               std::unique_ptr<TargetMachine> TM =
                   createTargetMachine(C, T, *MPartInCtx);
@@ -25,6 +25,7 @@
 #include "llvm/IR/Module.h"
 #include "llvm/IR/PseudoProbe.h"
 #include "llvm/IR/TypeFinder.h"
+#include "llvm/IR/ValueHandle.h"
 #include "llvm/Object/ModuleSymbolTable.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/Path.h"
@@ -399,6 +400,11 @@ class IRLinker {
   /// A metadata map that's shared between IRLinker instances.
   MDMapT &SharedMDs;
 
+  /// ConstantArrays that may be unused once the link is done and SrcM is
+  /// destroyed, see IRMover::move(). Destroying SrcM already frees some of
+  /// them, so they are held in value handles.
+  SmallVectorImpl<WeakVH> &MaybeDeadArrays;
+
   /// Mapping of values from what they used to be in Src, to what they are now
   /// in DstM.  ValueToValueMapTy is a ValueMap, which involves some overhead
   /// due to the use of Value handles which the Linker doesn't actually need,
@@ -540,10 +546,12 @@ public:
   IRLinker(Module &DstM, MDMapT &SharedMDs,
            IRMover::IdentifiedStructTypeSet &Set, std::unique_ptr<Module> SrcM,
            ArrayRef<GlobalValue *> ValuesToLink,
-           IRMover::LazyCallback AddLazyFor, bool IsPerformingImport)
+           IRMover::LazyCallback AddLazyFor, bool IsPerformingImport,
+           SmallVectorImpl<WeakVH> &MaybeDeadArrays)
       : DstM(DstM), SrcM(std::move(SrcM)), AddLazyFor(std::move(AddLazyFor)),
         TypeMap(Set), GValMaterializer(*this), LValMaterializer(*this),
-        SharedMDs(SharedMDs), IsPerformingImport(IsPerformingImport),
+        SharedMDs(SharedMDs), MaybeDeadArrays(MaybeDeadArrays),
+        IsPerformingImport(IsPerformingImport),
         Mapper(ValueMap, RF_ReuseAndMutateDistinctMDs | RF_IgnoreMissingLocals,
                &TypeMap, &GValMaterializer),
         IndirectSymbolMCID(Mapper.registerAlternateMappingContext(
@@ -989,8 +997,11 @@ IRLinker::linkAppendingVarProto(GlobalVariable *DstGV,
       IsOldStructor, SrcElements);
 
   // Replace any uses of the two global variables with uses of the new
-  // global.
+  // global. This leaves the old initializer of DstGV unused.
   if (DstGV) {
+    if (DstGV->hasInitializer())
+      if (auto *Init = dyn_cast<ConstantArray>(DstGV->getInitializer()))
+        MaybeDeadArrays.emplace_back(Init);
     RAUWWorklist.push_back(std::make_pair(DstGV, NG));
   }
 
@@ -1545,6 +1556,12 @@ Error IRLinker::run() {
     if (Error Err = SrcM->getMaterializer()->materializeMetadata())
       return Err;
 
+  // The initializers of the source globals become unused along with SrcM.
+  for (GlobalVariable &GV : SrcM->globals())
+    if (GV.hasInitializer())
+      if (auto *Init = dyn_cast<ConstantArray>(GV.getInitializer()))
+        MaybeDeadArrays.emplace_back(Init);
+
   // Convert source module to match dest for the duration of the link.
   ScopedDbgInfoFormatSetter FormatSetter(*SrcM, DstM.IsNewDbgInfoFormat);
 
@@ -1775,10 +1792,22 @@ IRMover::IRMover(Module &M) : Composite(M) {
 Error IRMover::move(std::unique_ptr<Module> Src,
                     ArrayRef<GlobalValue *> ValuesToLink,
                     LazyCallback AddLazyFor, bool IsPerformingImport) {
-  IRLinker TheIRLinker(Composite, SharedMDs, IdentifiedStructTypes,
-                       std::move(Src), ValuesToLink, std::move(AddLazyFor),
-                       IsPerformingImport);
-  Error E = TheIRLinker.run();
-  Composite.dropTriviallyDeadConstantArrays();
+  // Only look for dead ConstantArrays among the ones this link can make
+  // unused, so that linking many modules does not rescan all the constants of
+  // the context every time. The source module has to be gone by then.
+  SmallVector<WeakVH, 16> MaybeDeadArrays;
+  Error E = [&]() {
+    IRLinker TheIRLinker(Composite, SharedMDs, IdentifiedStructTypes,
+                         std::move(Src), ValuesToLink, std::move(AddLazyFor),
+                         IsPerformingImport, MaybeDeadArrays);
+    return TheIRLinker.run();
+  }();
+  // ~GlobalValue destroys the dead constants that use a source global, so
+  // skip the candidates that are already gone.
+  SmallVector<ConstantArray *, 16> Candidates;
+  for (Value *V : MaybeDeadArrays)
+    if (V)
+      Candidates.push_back(cast<ConstantArray>(V));
+  Composite.dropTriviallyDeadConstantArrays(Candidates);
   return E;
 }
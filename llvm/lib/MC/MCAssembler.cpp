@@ -34,6 +34,7 @@
 #include "llvm/Support/EndianStream.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/LEB128.h"
+#include "llvm/Support/raw_iovec_ostream.h"
 #include "llvm/Support/raw_ostream.h"
 #include <cassert>
 #include <cstdint>
@@ -66,6 +67,10 @@ STATISTIC(evaluateFixup, "Number of evaluated fixups");
 STATISTIC(ObjectBytes, "Number of emitted object file bytes");
 STATISTIC(RelaxationSteps, "Number of assembler layout and relaxation steps");
 STATISTIC(RelaxedInstructions, "Number of relaxed instructions");
+STATISTIC(RelaxationSectionPasses,
+          "Number of relaxation passes over the fragments of a section");
+STATISTIC(RelaxationFragmentVisits,
+          "Number of fragments visited during relaxation");
 
 } // end namespace stats
 } // end anonymous namespace
@@ -598,6 +603,16 @@ void MCAssembler::writeFragmentPadding(raw_ostream &OS,
   }
 }
 
+// Fragment contents outlive the writing of their section, so a
+// raw_iovec_ostream can reference them instead of copying them.
+static void writeContents(raw_ostream &OS,
+                          const SmallVectorImpl<char> &Contents) {
+  if (auto *IOS = dyn_cast<raw_iovec_ostream>(&OS))
+    IOS->writeStable(StringRef(Contents.data(), Contents.size()));
+  else
+    OS << Contents;
+}
+
 /// Write the fragment \p F to the output file.
 static void writeFragment(raw_ostream &OS, const MCAssembler &Asm,
                           const MCFragment &F) {
@@ -665,12 +680,12 @@ static void writeFragment(raw_ostream &OS, const MCAssembler &Asm,
 
   case MCFragment::FT_Data:
     ++stats::EmittedDataFragments;
-    OS << cast<MCDataFragment>(F).getContents();
+    writeContents(OS, cast<MCDataFragment>(F).getContents());
     break;
 
   case MCFragment::FT_Relaxable:
     ++stats::EmittedRelaxableFragments;
-    OS << cast<MCRelaxableFragment>(F).getContents();
+    writeContents(OS, cast<MCRelaxableFragment>(F).getContents());
     break;
 
   case MCFragment::FT_Fill: {
@@ -867,6 +882,9 @@ void MCAssembler::writeSectionData(raw_ostream &OS,
 
   for (const MCFragment &F : *Sec)
     writeFragment(OS, *this, F);
+  // Do not reference the fragments past this point.
+  if (auto *IOS = dyn_cast<raw_iovec_ostream>(&OS))
+    IOS->flushPending();
 
   assert(getContext().hadError() ||
          OS.tell() - Start == getSectionAddressSize(*Sec));
@@ -890,6 +908,23 @@ MCAssembler::handleFixup(MCFragment &F, const MCFixup &Fixup,
   return std::make_tuple(Target, FixedValue, IsResolved);
 }
 
+/// Return true if relaxFragment may change \p F.
+static bool mayRelax(const MCFragment &F) {
+  switch (F.getKind()) {
+  default:
+    return false;
+  case MCFragment::FT_Relaxable:
+  case MCFragment::FT_Dwarf:
+  case MCFragment::FT_DwarfFrame:
+  case MCFragment::FT_LEB:
+  case MCFragment::FT_BoundaryAlign:
+  case MCFragment::FT_CVInlineLines:
+  case MCFragment::FT_CVDefRange:
+  case MCFragment::FT_PseudoProbe:
+    return true;
+  }
+}
+
 void MCAssembler::layout() {
   assert(getBackendPtr() && "Expected assembler backend");
   DEBUG_WITH_TYPE("mc-dump", {
@@ -920,14 +955,23 @@ void MCAssembler::layout() {
     }
   }
 
+  // Collect the fragments whose size relaxation may change. The others, data
+  // fragments in particular, do not need to be visited again.
+  SmallVector<SmallVector<MCFragment *, 0>, 0> Worklists(Sections.size());
+  for (auto [Sec, Worklist] : zip_equal(Sections, Worklists))
+    for (MCFragment &Frag : *Sec)
+      if (mayRelax(Frag))
+        Worklist.push_back(&Frag);
+
   // Layout until everything fits.
   this->HasLayout = true;
-  while (layoutOnce()) {
+  for (unsigned FirstStable = Sections.size();
+       (FirstStable = relaxOnce(FirstStable, Worklists));) {
     if (getContext().hadError())
       return;
     // Size of fragments in one section can depend on the size of fragments in
     // another. If any fragment has changed size, we have to re-layout (and
-    // as a result possibly further relax) all.
+    // as a result possibly further relax) the sections relaxed before it.
     for (MCSection &Sec : *this)
       Sec.setHasLayout(false);
   }
@@ -1290,15 +1334,43 @@ bool MCAssembler::relaxFragment(MCFragment &F) {
   }
 }
 
-bool MCAssembler::layoutOnce() {
+unsigned MCAssembler::relaxOnce(
+    unsigned FirstStable,
+    MutableArrayRef<SmallVector<MCFragment *, 0>> Worklists) {
   ++stats::RelaxationSteps;
 
-  bool Changed = false;
-  for (MCSection &Sec : *this)
-    for (MCFragment &Frag : Sec)
-      if (relaxFragment(Frag))
-        Changed = true;
-  return Changed;
+  // Most fragments only depend on the layout of their own section, so relax
+  // every section to a fixed point before moving on to the next one. This
+  // keeps the number of passes over all fragments low.
+  unsigned Res = 0;
+  for (unsigned I = 0; I != FirstStable; ++I) {
+    MCSection &Sec = *Sections[I];
+    SmallVector<MCFragment *, 0> &Worklist = Worklists[I];
+    while (!Worklist.empty()) {
+      ++stats::RelaxationSectionPasses;
+      stats::RelaxationFragmentVisits += Worklist.size();
+      bool Changed = false;
+      for (MCFragment *Frag : Worklist)
+        if (relaxFragment(*Frag))
+          Changed = true;
+      // An instruction that was relaxed to a form that never needs relaxation
+      // cannot change any more.
+      erase_if(Worklist, [&](MCFragment *Frag) {
+        auto *RF = dyn_cast<MCRelaxableFragment>(Frag);
+        return RF && !getBackend().mayNeedRelaxation(RF->getInst(),
+                                                     *RF->getSubtargetInfo());
+      });
+      if (!Changed)
+        break;
+      // The sections before this one were relaxed against its old layout, so
+      // they have to be relaxed again. The ones after it will see the new one,
+      // including those that were stable before.
+      Res = I;
+      FirstStable = Sections.size();
+      Sec.setHasLayout(false);
+    }
+  }
+  return Res;
 }
 
 #if !defined(NDEBUG) || defined(LLVM_ENABLE_DUMP)
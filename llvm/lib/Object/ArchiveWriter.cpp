@@ -31,6 +31,7 @@
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/Format.h"
 #include "llvm/Support/MathExtras.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/SmallVectorMemoryBuffer.h"
 #include "llvm/Support/raw_ostream.h"
@@ -843,18 +844,55 @@ computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
       Entry.second = Entry.second > 1 ? 1 : 0;
   }
 
+  // Each bitcode member is read into a context of its own, so that members
+  // can be read in parallel. The contexts must outlive SymFiles.
+  std::vector<std::unique_ptr<LLVMContext>> MemberContexts;
   std::vector<std::unique_ptr<SymbolicFile>> SymFiles;
 
   if (NeedSymbols != SymtabWritingMode::NoSymtab || isAIXBigArchive(Kind)) {
-    for (const NewArchiveMember &M : NewMembers) {
+    MemberContexts.resize(NewMembers.size());
+    SymFiles.resize(NewMembers.size());
+    std::vector<std::optional<Error>> MemberErrors(NewMembers.size());
+    std::vector<std::vector<Error>> MemberWarnings(NewMembers.size());
+    parallelFor(0, NewMembers.size(), [&](size_t Index) {
+      const NewArchiveMember &M = NewMembers[Index];
+      MemoryBufferRef Buf = M.Buf->getMemBufferRef();
+      LLVMContext *MemberContext = &Context;
+      if (identify_magic(Buf.getBuffer()) == file_magic::bitcode) {
+        MemberContexts[Index] = std::make_unique<LLVMContext>();
+        MemberContext = MemberContexts[Index].get();
+      }
       Expected<std::unique_ptr<SymbolicFile>> SymFileOrErr = getSymbolicFile(
-          M.Buf->getMemBufferRef(), Context, Kind, [&](Error Err) {
-            Warn(createFileError(M.MemberName, std::move(Err)));
+          Buf, *MemberContext, Kind, [&](Error Err) {
+            MemberWarnings[Index].push_back(
+                createFileError(M.MemberName, std::move(Err)));
           });
       if (!SymFileOrErr)
-        return createFileError(M.MemberName, SymFileOrErr.takeError());
-      SymFiles.push_back(std::move(*SymFileOrErr));
+        MemberErrors[Index] =
+            createFileError(M.MemberName, SymFileOrErr.takeError());
+      else
+        SymFiles[Index] = std::move(*SymFileOrErr);
+    });
+
+    // Report warnings and errors in member order, stopping at the first error
+    // as a serial read would.
+    Error FirstErr = Error::success();
+    for (size_t Index = 0; Index != NewMembers.size(); ++Index) {
+      for (Error &W : MemberWarnings[Index]) {
+        if (FirstErr)
+          consumeError(std::move(W));
+        else
+          Warn(std::move(W));
+      }
+      if (!MemberErrors[Index])
+        continue;
+      if (FirstErr)
+        consumeError(std::move(*MemberErrors[Index]));
+      else
+        FirstErr = std::move(*MemberErrors[Index]);
     }
+    if (FirstErr)
+      return std::move(FirstErr);
   }
 
   if (SymMap) {
@@ -27,6 +27,7 @@
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/VirtualFileSystem.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
@@ -964,32 +965,124 @@ static Error handleMaybeNoDataFoundError(Error E) {
       });
 }
 
-Error CoverageMapping::loadFromFile(
-    StringRef Filename, StringRef Arch, StringRef CompilationDir,
-    IndexedInstrProfReader &ProfileReader, CoverageMapping &Coverage,
-    bool &DataFound, SmallVectorImpl<object::BuildID> *FoundBinaryIDs) {
+namespace {
+
+/// The coverage mapping read from an object file, and the buffers that it
+/// refers to.
+struct ObjectFileCoverage {
+  std::unique_ptr<MemoryBuffer> CovMappingBuf;
+  SmallVector<std::unique_ptr<MemoryBuffer>, 4> Buffers;
+  SmallVector<std::unique_ptr<CoverageMappingReader>, 4> Readers;
+  SmallVector<object::BuildIDRef> BinaryIDs;
+};
+
+/// A reader of the records that another reader decoded up front, so that the
+/// records of several object files can be decoded in parallel. It keeps the
+/// other reader alive, as the records refer to its filenames.
+class DecodedCoverageReader : public CoverageMappingReader {
+  struct DecodedRecord {
+    StringRef FunctionName;
+    uint64_t FunctionHash;
+    std::vector<StringRef> Filenames;
+    std::vector<CounterExpression> Expressions;
+    std::vector<CounterMappingRegion> MappingRegions;
+  };
+
+  std::unique_ptr<CoverageMappingReader> Reader;
+  std::vector<DecodedRecord> Records;
+  size_t NextRecord = 0;
+  /// The error that stopped decoding, returned after the records before it.
+  coveragemap_error DecodeErr = coveragemap_error::success;
+
+public:
+  DecodedCoverageReader(std::unique_ptr<CoverageMappingReader> R)
+      : Reader(std::move(R)) {
+    for (auto RecordOrErr : *Reader) {
+      if (Error E = RecordOrErr.takeError()) {
+        handleAllErrors(std::move(E), [&](const CoverageMapError &CME) {
+          DecodeErr = CME.get();
+        });
+        break;
+      }
+      const auto &Record = *RecordOrErr;
+      Records.push_back({Record.FunctionName, Record.FunctionHash,
+                         Record.Filenames.vec(), Record.Expressions.vec(),
+                         Record.MappingRegions.vec()});
+    }
+  }
+
+  Error readNextRecord(CoverageMappingRecord &Record) override {
+    if (NextRecord == Records.size())
+      return make_error<CoverageMapError>(
+          DecodeErr == coveragemap_error::success ? coveragemap_error::eof
+                                                  : DecodeErr);
+
+    const auto &R = Records[NextRecord++];
+    Record.FunctionName = R.FunctionName;
+    Record.FunctionHash = R.FunctionHash;
+    Record.Filenames = R.Filenames;
+    Record.Expressions = R.Expressions;
+    Record.MappingRegions = R.MappingRegions;
+    return Error::success();
+  }
+};
+
+} // end anonymous namespace
+
+/// Read the coverage mapping of the object file Filename. A file without
+/// coverage mapping has no readers. If Decode is true then the records are
+/// decoded as well, which only touches the returned object.
+static Expected<ObjectFileCoverage>
+readObjectFileCoverage(StringRef Filename, StringRef Arch,
+                       StringRef CompilationDir, bool ReadBinaryIDs,
+                       bool Decode) {
+  ObjectFileCoverage File;
   auto CovMappingBufOrErr = MemoryBuffer::getFileOrSTDIN(
       Filename, /*IsText=*/false, /*RequiresNullTerminator=*/false);
   if (std::error_code EC = CovMappingBufOrErr.getError())
     return createFileError(Filename, errorCodeToError(EC));
-  MemoryBufferRef CovMappingBufRef =
-      CovMappingBufOrErr.get()->getMemBufferRef();
-  SmallVector<std::unique_ptr<MemoryBuffer>, 4> Buffers;
+  File.CovMappingBuf = std::move(CovMappingBufOrErr.get());
 
-  SmallVector<object::BuildIDRef> BinaryIDs;
   auto CoverageReadersOrErr = BinaryCoverageReader::create(
-      CovMappingBufRef, Arch, Buffers, CompilationDir,
-      FoundBinaryIDs ? &BinaryIDs : nullptr);
+      File.CovMappingBuf->getMemBufferRef(), Arch, File.Buffers,
+      CompilationDir, ReadBinaryIDs ? &File.BinaryIDs : nullptr);
   if (Error E = CoverageReadersOrErr.takeError()) {
     E = handleMaybeNoDataFoundError(std::move(E));
     if (E)
       return createFileError(Filename, std::move(E));
-    return E;
+    return std::move(File);
   }
 
-  SmallVector<std::unique_ptr<CoverageMappingReader>, 4> Readers;
-  for (auto &Reader : CoverageReadersOrErr.get())
-    Readers.push_back(std::move(Reader));
+  for (auto &Reader : CoverageReadersOrErr.get()) {
+    if (Decode)
+      File.Readers.push_back(
+          std::make_unique<DecodedCoverageReader>(std::move(Reader)));
+    else
+      File.Readers.push_back(std::move(Reader));
+  }
+  return std::move(File);
+}
+
+Error CoverageMapping::loadFromFile(
+    StringRef Filename, StringRef Arch, StringRef CompilationDir,
+    IndexedInstrProfReader &ProfileReader, CoverageMapping &Coverage,
+    bool &DataFound, SmallVectorImpl<object::BuildID> *FoundBinaryIDs) {
+  auto FileOrErr = readObjectFileCoverage(
+      Filename, Arch, CompilationDir,
+      /*ReadBinaryIDs=*/FoundBinaryIDs != nullptr, /*Decode=*/false);
+  if (!FileOrErr)
+    return FileOrErr.takeError();
+  return loadFromFileReaders(Filename, FileOrErr->Readers,
+                             FileOrErr->BinaryIDs, ProfileReader, Coverage,
+                             DataFound, FoundBinaryIDs);
+}
+
+Error CoverageMapping::loadFromFileReaders(
+    StringRef Filename,
+    ArrayRef<std::unique_ptr<CoverageMappingReader>> Readers,
+    ArrayRef<object::BuildIDRef> BinaryIDs,
+    IndexedInstrProfReader &ProfileReader, CoverageMapping &Coverage,
+    bool &DataFound, SmallVectorImpl<object::BuildID> *FoundBinaryIDs) {
   if (FoundBinaryIDs && !Readers.empty()) {
     llvm::append_range(*FoundBinaryIDs,
                        llvm::map_range(BinaryIDs, [](object::BuildIDRef BID) {
@@ -1021,12 +1114,30 @@ Expected<std::unique_ptr<CoverageMapping>> CoverageMapping::load(
     return Arches[Idx];
   };
 
+  // Read and decode the coverage mapping of the object files in parallel.
+  // Only loading the records, which looks them up in the profile, has to be
+  // done in order.
+  std::vector<std::optional<Expected<ObjectFileCoverage>>> Files(
+      ObjectFilenames.size());
+  parallelFor(0, ObjectFilenames.size(), [&](size_t I) {
+    Files[I] = readObjectFileCoverage(ObjectFilenames[I], GetArch(I),
+                                      CompilationDir, /*ReadBinaryIDs=*/true,
+                                      /*Decode=*/ObjectFilenames.size() > 1);
+  });
+
   SmallVector<object::BuildID> FoundBinaryIDs;
-  for (const auto &File : llvm::enumerate(ObjectFilenames)) {
-    if (Error E =
-            loadFromFile(File.value(), GetArch(File.index()), CompilationDir,
-                         *ProfileReader, *Coverage, DataFound, &FoundBinaryIDs))
+  for (const auto &[I, File] : llvm::enumerate(Files)) {
+    Error E = *File ? loadFromFileReaders(ObjectFilenames[I], (*File)->Readers,
+                                          (*File)->BinaryIDs, *ProfileReader,
+                                          *Coverage, DataFound, &FoundBinaryIDs)
+                    : File->takeError();
+    File.reset();
+    if (E) {
+      for (auto &Rest : drop_begin(Files, I + 1))
+        if (!*Rest)
+          consumeError(Rest->takeError());
       return std::move(E);
+    }
   }
 
   if (BIDFetcher) {
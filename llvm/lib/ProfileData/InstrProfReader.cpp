@@ -1450,25 +1450,23 @@ Error IndexedInstrProfReader::readHeader() {
         support::endian::readNext<uint64_t, llvm::endianness::little>(Ptr);
     TemporalProfTraceStreamSize =
         support::endian::readNext<uint64_t, llvm::endianness::little>(Ptr);
+    // Only check that the traces are in bounds here. They are decoded by
+    // getTemporalProfTraces.
+    const unsigned char *TracesStart = Ptr;
     for (unsigned i = 0; i < NumTraces; i++) {
       // Expect at least two 64 bit fields: Weight and NumFunctions
       if (Ptr + 2 * sizeof(uint64_t) > PtrEnd)
         return error(instrprof_error::truncated);
-      TemporalProfTraceTy Trace;
-      Trace.Weight =
-          support::endian::readNext<uint64_t, llvm::endianness::little>(Ptr);
+      Ptr += sizeof(uint64_t);
       const uint64_t NumFunctions =
           support::endian::readNext<uint64_t, llvm::endianness::little>(Ptr);
       // Expect at least NumFunctions 64 bit fields
       if (Ptr + NumFunctions * sizeof(uint64_t) > PtrEnd)
         return error(instrprof_error::truncated);
-      for (unsigned j = 0; j < NumFunctions; j++) {
-        const uint64_t NameRef =
-            support::endian::readNext<uint64_t, llvm::endianness::little>(Ptr);
-        Trace.FunctionNameRefs.push_back(NameRef);
-      }
-      TemporalProfTraces.push_back(std::move(Trace));
+      Ptr += NumFunctions * sizeof(uint64_t);
     }
+    TemporalProfTracesBuffer = ArrayRef<uint8_t>(TracesStart, Ptr);
+    NumTemporalProfTraces = NumTraces;
   }
 
   // Load the remapping table now if requested.
@@ -1486,6 +1484,32 @@ Error IndexedInstrProfReader::readHeader() {
   return success();
 }
 
+SmallVector<TemporalProfTraceTy> &
+IndexedInstrProfReader::getTemporalProfTraces(std::optional<uint64_t> Weight) {
+  // The weights are already in the traces of an indexed profile.
+  if (TemporalProfTracesBuffer.empty())
+    return TemporalProfTraces;
+
+  // readHeader checked the bounds of the traces.
+  const unsigned char *Ptr = TemporalProfTracesBuffer.data();
+  TemporalProfTraces.reserve(NumTemporalProfTraces);
+  for (uint64_t I = 0; I < NumTemporalProfTraces; ++I) {
+    TemporalProfTraceTy Trace;
+    Trace.Weight =
+        support::endian::readNext<uint64_t, llvm::endianness::little>(Ptr);
+    const uint64_t NumFunctions =
+        support::endian::readNext<uint64_t, llvm::endianness::little>(Ptr);
+    Trace.FunctionNameRefs.reserve(NumFunctions);
+    for (uint64_t J = 0; J < NumFunctions; ++J)
+      Trace.FunctionNameRefs.push_back(
+          support::endian::readNext<uint64_t, llvm::endianness::little>(Ptr));
+    TemporalProfTraces.push_back(std::move(Trace));
+  }
+  assert(Ptr == TemporalProfTracesBuffer.end());
+  TemporalProfTracesBuffer = {};
+  return TemporalProfTraces;
+}
+
 InstrProfSymtab &IndexedInstrProfReader::getSymtab() {
   if (Symtab)
     return *Symtab;
@@ -558,11 +558,13 @@ SampleProfileReaderBinary::readContextFromTable(size_t *RetIdx) {
   auto ContextIdx = readNumber<size_t>();
   if (std::error_code EC = ContextIdx.getError())
     return EC;
-  if (*ContextIdx >= CSNameTable.size())
+  if (*ContextIdx + 1 >= CSNameTableOffsets.size())
     return sampleprof_error::truncated_name_table;
   if (RetIdx)
     *RetIdx = *ContextIdx;
-  return CSNameTable[*ContextIdx];
+  size_t Begin = CSNameTableOffsets[*ContextIdx];
+  size_t End = CSNameTableOffsets[*ContextIdx + 1];
+  return SampleContextFrames(CSNameTable).slice(Begin, End - Begin);
 }
 
 ErrorOr<std::pair<SampleContext, uint64_t>>
@@ -1206,7 +1208,8 @@ std::error_code SampleProfileReaderExtBinaryBase::readCSNameTableSec() {
     return EC;
 
   CSNameTable.clear();
-  CSNameTable.reserve(*Size);
+  CSNameTableOffsets.clear();
+  CSNameTableOffsets.reserve(*Size + 1);
   if (ProfileIsCS) {
     // Delay MD5 computation of CS context until they are needed. Use 0 to
     // indicate MD5 value is to be calculated as no known string has a MD5
@@ -1216,7 +1219,7 @@ std::error_code SampleProfileReaderExtBinaryBase::readCSNameTableSec() {
     MD5SampleContextStart = MD5SampleContextTable.data();
   }
   for (size_t I = 0; I < *Size; ++I) {
-    CSNameTable.emplace_back(SampleContextFrameVector());
+    CSNameTableOffsets.push_back(CSNameTable.size());
     auto ContextSize = readNumber<uint32_t>();
     if (std::error_code EC = ContextSize.getError())
       return EC;
@@ -1235,10 +1238,11 @@ std::error_code SampleProfileReaderExtBinaryBase::readCSNameTableSec() {
       if (std::error_code EC = Discriminator.getError())
         return EC;
 
-      CSNameTable.back().emplace_back(
+      CSNameTable.emplace_back(
           FName.get(), LineLocation(LineOffset.get(), Discriminator.get()));
     }
   }
+  CSNameTableOffsets.push_back(CSNameTable.size());
 
   return sampleprof_error::success;
 }
@@ -15,8 +15,10 @@
 #include "llvm/Support/Caching.h"
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
 
 #if !defined(_MSC_VER) && !defined(__MINGW32__)
 #include <unistd.h>
@@ -26,10 +28,21 @@
 
 using namespace llvm;
 
+void FileCacheStats::print(raw_ostream &OS) const {
+  uint64_t NumHits = Hits, NumMisses = Misses;
+  uint64_t Total = NumHits + NumMisses;
+  OS << "cache hits: " << NumHits << ", misses: " << NumMisses;
+  if (Total)
+    OS << format(" (%.1f%% hit rate)", 100.0 * NumHits / Total);
+  OS << ", bytes read: " << BytesRead << ", bytes written: " << BytesWritten
+     << "\n";
+}
+
 Expected<FileCache> llvm::localCache(const Twine &CacheNameRef,
                                      const Twine &TempFilePrefixRef,
                                      const Twine &CacheDirectoryPathRef,
-                                     AddBufferFn AddBuffer) {
+                                     AddBufferFn AddBuffer,
+                                     FileCacheStats *Stats) {
 
   // Create local copies which are safely captured-by-copy in lambdas
   SmallString<64> CacheName, TempFilePrefix, CacheDirectoryPath;
@@ -55,6 +68,10 @@ Expected<FileCache> llvm::localCache(const Twine &CacheNameRef,
                                     /*RequiresNullTerminator=*/false);
       sys::fs::closeFile(*FDOrErr);
       if (MBOrErr) {
+        if (Stats) {
+          ++Stats->Hits;
+          Stats->BytesRead += (*MBOrErr)->getBufferSize();
+        }
         AddBuffer(Task, ModuleName, std::move(*MBOrErr));
         return AddStreamFn();
       }
@@ -72,6 +89,8 @@ Expected<FileCache> llvm::localCache(const Twine &CacheNameRef,
     if (EC != errc::no_such_file_or_directory && EC != errc::permission_denied)
       return createStringError(EC, Twine("Failed to open cache file ") +
                                        EntryPath + ": " + EC.message() + "\n");
+    if (Stats)
+      ++Stats->Misses;
 
     // This file stream is responsible for commiting the resulting file to the
     // cache and calling AddBuffer to add it to the link.
@@ -80,13 +99,14 @@ Expected<FileCache> llvm::localCache(const Twine &CacheNameRef,
       sys::fs::TempFile TempFile;
       std::string ModuleName;
       unsigned Task;
+      FileCacheStats *Stats;
 
       CacheStream(std::unique_ptr<raw_pwrite_stream> OS, AddBufferFn AddBuffer,
                   sys::fs::TempFile TempFile, std::string EntryPath,
-                  std::string ModuleName, unsigned Task)
+                  std::string ModuleName, unsigned Task, FileCacheStats *Stats)
           : CachedFileStream(std::move(OS), std::move(EntryPath)),
             AddBuffer(std::move(AddBuffer)), TempFile(std::move(TempFile)),
-            ModuleName(ModuleName), Task(Task) {}
+            ModuleName(ModuleName), Task(Task), Stats(Stats) {}
 
       ~CacheStream() {
         // TODO: Manually commit rather than using non-trivial destructor,
@@ -135,6 +155,8 @@ Expected<FileCache> llvm::localCache(const Twine &CacheNameRef,
                              TempFile.TmpName + " to " + ObjectPathName + ": " +
                              toString(std::move(E)) + "\n");
 
+        if (Stats)
+          Stats->BytesWritten += (*MBOrErr)->getBufferSize();
         AddBuffer(Task, ModuleName, std::move(*MBOrErr));
       }
     };
@@ -164,7 +186,7 @@ Expected<FileCache> llvm::localCache(const Twine &CacheNameRef,
       return std::make_unique<CacheStream>(
           std::make_unique<raw_fd_ostream>(Temp->FD, /* ShouldClose */ false),
           AddBuffer, std::move(*Temp), std::string(EntryPath), ModuleName.str(),
-          Task);
+          Task, Stats);
     };
   };
 }
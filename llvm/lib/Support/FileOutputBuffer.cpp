@@ -23,6 +23,10 @@
 #include <io.h>
 #endif
 
+#if defined(__linux__)
+#include <fcntl.h>
+#endif
+
 using namespace llvm;
 using namespace llvm::sys;
 
@@ -66,6 +70,15 @@ public:
     consumeError(Temp.discard());
   }
 
+  void flushRange(size_t Offset, size_t Size) override {
+#if defined(__linux__)
+    // Start asynchronous write-back of the dirty pages in the range, so that
+    // writing a large file overlaps with producing the rest of it.
+    if (Temp.FD >= 0)
+      ::sync_file_range(Temp.FD, Offset, Size, SYNC_FILE_RANGE_WRITE);
+#endif
+  }
+
 private:
   fs::mapped_file_region Buffer;
   fs::TempFile Temp;
@@ -0,0 +1,185 @@
+//===-- HotPathTrace.cpp - Low-overhead event tracing ---------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the per-thread ring buffers of the hot path tracer and
+// their export to the Chrome trace format.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/HotPathTrace.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/Threading.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+std::atomic<bool> llvm::detail::HotPathTraceIsEnabled{false};
+
+namespace {
+
+struct ThreadBuffer {
+  ThreadBuffer(size_t Size)
+      : Records(new HotPathTraceRecord[Size]), Mask(Size - 1),
+        Tid(get_threadid()) {
+    SmallString<64> Name;
+    get_thread_name(Name);
+    ThreadName = std::string(Name);
+  }
+
+  size_t getNumRecords() const {
+    return std::min<uint64_t>(NumAppended.load(std::memory_order_acquire),
+                              Mask + 1);
+  }
+
+  std::unique_ptr<HotPathTraceRecord[]> Records;
+  const uint64_t Mask;
+  // Only written by the owning thread, and by hotPathTraceClear().
+  std::atomic<uint64_t> NumAppended{0};
+  const uint64_t Tid;
+  std::string ThreadName;
+};
+
+struct HotPathTracer {
+  std::mutex Lock;
+  // Buffers outlive their threads so that the events of finished worker
+  // threads can still be written.
+  std::vector<std::unique_ptr<ThreadBuffer>> Buffers;
+  size_t RecordsPerThread = 0;
+};
+
+} // end anonymous namespace
+
+static HotPathTracer &getTracer() {
+  static HotPathTracer Tracer;
+  return Tracer;
+}
+
+static thread_local ThreadBuffer *CurrentBuffer = nullptr;
+
+static ThreadBuffer *createThreadBuffer() {
+  HotPathTracer &Tracer = getTracer();
+  std::lock_guard<std::mutex> Lock(Tracer.Lock);
+  Tracer.Buffers.push_back(
+      std::make_unique<ThreadBuffer>(Tracer.RecordsPerThread));
+  return Tracer.Buffers.back().get();
+}
+
+void llvm::detail::hotPathTraceAppend(const char *Name, uint64_t Arg,
+                                      uint64_t Begin, uint64_t End) {
+  ThreadBuffer *Buffer = CurrentBuffer;
+  if (LLVM_UNLIKELY(!Buffer))
+    Buffer = CurrentBuffer = createThreadBuffer();
+  uint64_t N = Buffer->NumAppended.load(std::memory_order_relaxed);
+  Buffer->Records[N & Buffer->Mask] = {Name, Arg, Begin, End};
+  Buffer->NumAppended.store(N + 1, std::memory_order_release);
+}
+
+void llvm::hotPathTraceEnable(size_t RecordsPerThread) {
+  HotPathTracer &Tracer = getTracer();
+  {
+    std::lock_guard<std::mutex> Lock(Tracer.Lock);
+    Tracer.RecordsPerThread =
+        PowerOf2Ceil(std::max<size_t>(RecordsPerThread, 1));
+  }
+  detail::HotPathTraceIsEnabled.store(true, std::memory_order_release);
+}
+
+void llvm::hotPathTraceDisable() {
+  detail::HotPathTraceIsEnabled.store(false, std::memory_order_release);
+}
+
+void llvm::hotPathTraceClear() {
+  HotPathTracer &Tracer = getTracer();
+  std::lock_guard<std::mutex> Lock(Tracer.Lock);
+  for (const std::unique_ptr<ThreadBuffer> &Buffer : Tracer.Buffers)
+    Buffer->NumAppended.store(0, std::memory_order_relaxed);
+}
+
+void llvm::hotPathTraceWrite(raw_ostream &OS, StringRef ProcName) {
+  HotPathTracer &Tracer = getTracer();
+  std::lock_guard<std::mutex> Lock(Tracer.Lock);
+  int64_t Pid = sys::Process::getProcessId();
+
+  // Make the timestamps relative to the oldest record.
+  uint64_t StartTime = UINT64_MAX;
+  for (const std::unique_ptr<ThreadBuffer> &Buffer : Tracer.Buffers)
+    for (size_t I = 0, E = Buffer->getNumRecords(); I != E; ++I)
+      StartTime = std::min(StartTime, Buffer->Records[I].Begin);
+  auto toMicroseconds = [&](uint64_t Time) {
+    return double(Time - StartTime) / 1000;
+  };
+
+  json::OStream J(OS);
+  J.objectBegin();
+  J.attributeBegin("traceEvents");
+  J.arrayBegin();
+
+  for (const std::unique_ptr<ThreadBuffer> &Buffer : Tracer.Buffers) {
+    uint64_t NumAppended = Buffer->NumAppended.load(std::memory_order_acquire);
+    size_t NumRecords = Buffer->getNumRecords();
+    // Write the records oldest first, starting after the newest one if the
+    // buffer has wrapped around.
+    for (uint64_t I = NumAppended - NumRecords; I != NumAppended; ++I) {
+      const HotPathTraceRecord &R = Buffer->Records[I & Buffer->Mask];
+      J.object([&] {
+        J.attribute("pid", Pid);
+        J.attribute("tid", int64_t(Buffer->Tid));
+        J.attribute("ts", toMicroseconds(R.Begin));
+        if (R.End == R.Begin) {
+          J.attribute("ph", "i");
+          J.attribute("s", "t");
+        } else {
+          J.attribute("ph", "X");
+          J.attribute("dur", double(R.End - R.Begin) / 1000);
+        }
+        J.attribute("name", R.Name);
+        J.attributeObject("args", [&] { J.attribute("arg", R.Arg); });
+      });
+    }
+  }
+
+  auto writeMetadataEvent = [&](const char *Name, uint64_t Tid,
+                                StringRef Arg) {
+    J.object([&] {
+      J.attribute("pid", Pid);
+      J.attribute("tid", int64_t(Tid));
+      J.attribute("ts", 0);
+      J.attribute("ph", "M");
+      J.attribute("name", Name);
+      J.attributeObject("args", [&] { J.attribute("name", Arg); });
+    });
+  };
+
+  if (!ProcName.empty())
+    writeMetadataEvent("process_name", get_threadid(), ProcName);
+  for (const std::unique_ptr<ThreadBuffer> &Buffer : Tracer.Buffers)
+    if (!Buffer->ThreadName.empty())
+      writeMetadataEvent("thread_name", Buffer->Tid, Buffer->ThreadName);
+
+  J.arrayEnd();
+  J.attributeEnd();
+  J.objectEnd();
+}
+
+Error llvm::hotPathTraceWrite(StringRef FileName, StringRef ProcName) {
+  std::error_code EC;
+  raw_fd_ostream OS(FileName, EC, sys::fs::OF_TextWithCRLF);
+  if (EC)
+    return createStringError(EC, "Could not open " + FileName);
+  hotPathTraceWrite(OS, ProcName);
+  return Error::success();
+}
@@ -20,6 +20,7 @@
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MathExtras.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Process.h"
 #include "llvm/Support/Program.h"
 #include "llvm/Support/SmallVectorMemoryBuffer.h"
@@ -266,6 +267,20 @@ MemoryBuffer::getFile(const Twine &Filename, bool IsText,
                                   Alignment);
 }
 
+SmallVector<ErrorOr<std::unique_ptr<MemoryBuffer>>, 0>
+MemoryBuffer::getFiles(ArrayRef<StringRef> Filenames, bool IsText,
+                       bool RequiresNullTerminator, bool IsVolatile) {
+  SmallVector<ErrorOr<std::unique_ptr<MemoryBuffer>>, 0> Results;
+  Results.reserve(Filenames.size());
+  for (size_t I = 0, E = Filenames.size(); I != E; ++I)
+    Results.emplace_back(std::make_error_code(std::errc::invalid_argument));
+  parallelFor(0, Filenames.size(), [&](size_t I) {
+    Results[I] = getFile(Filenames[I], IsText, RequiresNullTerminator,
+                         IsVolatile);
+  });
+  return Results;
+}
+
 template <typename MB>
 static ErrorOr<std::unique_ptr<MB>>
 getOpenFileImpl(sys::fs::file_t FD, const Twine &Filename, uint64_t FileSize,
@@ -10,13 +10,16 @@
 #include "llvm/Config/llvm-config.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/Threading.h"
+#include "llvm/Support/TimeProfiler.h"
 
 #include <atomic>
+#include <deque>
 #include <future>
 #include <thread>
 #include <vector>
 
 llvm::ThreadPoolStrategy llvm::parallel::strategy;
+bool llvm::parallel::traceTasks = false;
 
 namespace llvm {
 namespace parallel {
@@ -38,18 +41,33 @@ namespace {
 class Executor {
 public:
   virtual ~Executor() = default;
-  virtual void add(std::function<void()> func) = 0;
+  virtual void add(std::function<void()> func, const Latch *Group,
+                   TaskPriority Priority) = 0;
+  /// Run one queued task of \p Group on the calling worker thread. Returns
+  /// false if no task of \p Group is waiting to be run.
+  virtual bool runGroupTask(const Latch *Group) = 0;
   virtual size_t getThreadCount() const = 0;
 
   static Executor *getDefaultExecutor();
 };
 
-/// An implementation of an Executor that runs closures on a thread pool
-///   in filo order.
+/// An implementation of an Executor that runs closures on a thread pool using
+///   work stealing.
+///
+/// Every worker owns a deque. Tasks spawned on a worker are pushed to the back
+/// of its deque and popped from there in filo order, while idle workers steal
+/// the oldest task from the front of the other deques. Tasks spawned from
+/// other threads go to a shared stack, and high priority tasks to a shared
+/// queue that is checked before anything else.
+///
+/// A worker that waits for a TaskGroup runs the queued tasks of that group
+/// instead of blocking, so that nested TaskGroups can run in parallel without
+/// deadlocking the pool.
 class ThreadPoolExecutor : public Executor {
 public:
   explicit ThreadPoolExecutor(ThreadPoolStrategy S) {
     ThreadCount = S.compute_thread_count();
+    Queues = std::make_unique<WorkerQueue[]>(ThreadCount);
     // Spawn all but one of the threads in another thread as spawning threads
     // can take a while.
     Threads.reserve(ThreadCount);
@@ -97,34 +115,150 @@ public:
     static void call(void *Ptr) { ((ThreadPoolExecutor *)Ptr)->stop(); }
   };
 
-  void add(std::function<void()> F) override {
+  void add(std::function<void()> F, const Latch *Group,
+           TaskPriority Priority) override {
+    Task T{std::move(F), Group};
+    if (Priority == TaskPriority::Normal && threadIndex != UINT_MAX) {
+      WorkerQueue &Q = Queues[threadIndex];
+      std::lock_guard<std::mutex> Lock(Q.Mutex);
+      Q.Tasks.push_back(std::move(T));
+    }
     {
       std::lock_guard<std::mutex> Lock(Mutex);
-      WorkStack.push_back(std::move(F));
+      if (Priority == TaskPriority::High)
+        HighQueue.push_back(std::move(T));
+      else if (threadIndex == UINT_MAX)
+        WorkStack.push_back(std::move(T));
+      ++Pending;
     }
     Cond.notify_one();
   }
 
+  bool runGroupTask(const Latch *Group) override {
+    assert(threadIndex != UINT_MAX);
+    Task T;
+    if (!takeGroupTask(threadIndex, Group, T))
+      return false;
+    T.F();
+    return true;
+  }
+
   size_t getThreadCount() const override { return ThreadCount; }
 
 private:
+  struct Task {
+    std::function<void()> F;
+    const Latch *Group = nullptr;
+  };
+
+  struct WorkerQueue {
+    std::mutex Mutex;
+    std::deque<Task> Tasks;
+  };
+
+  // Removes the last task of Group from Tasks, if there is one.
+  static bool takeFrom(std::deque<Task> &Tasks, const Latch *Group, Task &T) {
+    for (auto I = Tasks.rbegin(), E = Tasks.rend(); I != E; ++I) {
+      if (I->Group != Group)
+        continue;
+      T = std::move(*I);
+      Tasks.erase(std::next(I).base());
+      return true;
+    }
+    return false;
+  }
+
+  // Takes the next task for an idle worker: high priority tasks first, then
+  // the newest task of its own deque, then the newest task spawned from
+  // outside of the pool, and finally the oldest task of another worker.
+  bool takeTask(unsigned ID, Task &T) {
+    if (Pending <= 0)
+      return false;
+    {
+      std::lock_guard<std::mutex> Lock(Mutex);
+      if (!HighQueue.empty()) {
+        T = std::move(HighQueue.front());
+        HighQueue.pop_front();
+        --Pending;
+        return true;
+      }
+    }
+    {
+      WorkerQueue &Q = Queues[ID];
+      std::lock_guard<std::mutex> Lock(Q.Mutex);
+      if (!Q.Tasks.empty()) {
+        T = std::move(Q.Tasks.back());
+        Q.Tasks.pop_back();
+        --Pending;
+        return true;
+      }
+    }
+    {
+      std::lock_guard<std::mutex> Lock(Mutex);
+      if (!WorkStack.empty()) {
+        T = std::move(WorkStack.back());
+        WorkStack.pop_back();
+        --Pending;
+        return true;
+      }
+    }
+    for (unsigned I = 1; I < ThreadCount; ++I) {
+      WorkerQueue &Q = Queues[(ID + I) % ThreadCount];
+      std::lock_guard<std::mutex> Lock(Q.Mutex);
+      if (!Q.Tasks.empty()) {
+        T = std::move(Q.Tasks.front());
+        Q.Tasks.pop_front();
+        --Pending;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Takes a task of Group for a worker that waits for Group. Only tasks of
+  // Group are considered: running an unrelated task could make the wait
+  // depend on work that is not needed to complete the group, and it would
+  // interleave with the per-thread state of the suspended task.
+  bool takeGroupTask(unsigned ID, const Latch *Group, Task &T) {
+    for (unsigned I = 0; I < ThreadCount; ++I) {
+      WorkerQueue &Q = Queues[(ID + I) % ThreadCount];
+      std::lock_guard<std::mutex> Lock(Q.Mutex);
+      if (takeFrom(Q.Tasks, Group, T)) {
+        --Pending;
+        return true;
+      }
+    }
+    std::lock_guard<std::mutex> Lock(Mutex);
+    if (takeFrom(HighQueue, Group, T) || takeFrom(WorkStack, Group, T)) {
+      --Pending;
+      return true;
+    }
+    return false;
+  }
+
   void work(ThreadPoolStrategy S, unsigned ThreadID) {
     threadIndex = ThreadID;
     S.apply_thread_strategy(ThreadID);
     while (true) {
+      Task T;
+      if (takeTask(ThreadID, T)) {
+        T.F();
+        continue;
+      }
       std::unique_lock<std::mutex> Lock(Mutex);
-      Cond.wait(Lock, [&] { return Stop || !WorkStack.empty(); });
+      Cond.wait(Lock, [&] { return Stop || Pending > 0; });
       if (Stop)
         break;
-      auto Task = std::move(WorkStack.back());
-      WorkStack.pop_back();
-      Lock.unlock();
-      Task();
     }
   }
 
   std::atomic<bool> Stop{false};
-  std::vector<std::function<void()>> WorkStack;
+  // The number of tasks that are queued but not yet taken. It may briefly be
+  // out of date while a task is being added, which only causes a retry.
+  std::atomic<ptrdiff_t> Pending{0};
+  std::unique_ptr<WorkerQueue[]> Queues;
+  std::deque<Task> HighQueue;
+  std::deque<Task> WorkStack;
   std::mutex Mutex;
   std::condition_variable Cond;
   std::promise<void> ThreadsCreated;
@@ -174,37 +308,64 @@ size_t getThreadCount() {
 }
 #endif
 
-// Latch::sync() called by the dtor may cause one thread to block. If is a dead
-// lock if all threads in the default executor are blocked. To prevent the dead
-// lock, only allow the root TaskGroup to run tasks parallelly. In the scenario
-// of nested parallel_for_each(), only the outermost one runs parallelly.
+// A TaskGroup created on a worker thread of the default executor is parallel
+// as well. Waiting for it does not block the worker as long as tasks of the
+// group are queued, because the worker runs them itself, see sync(). Hence
+// nested parallel_for_each() and parallelFor() run in parallel too.
 TaskGroup::TaskGroup()
 #if LLVM_ENABLE_THREADS
-    : Parallel((parallel::strategy.ThreadsRequested != 1) &&
-               (threadIndex == UINT_MAX)) {}
+    : Parallel(parallel::strategy.ThreadsRequested != 1) {}
 #else
     : Parallel(false) {}
 #endif
 TaskGroup::~TaskGroup() {
   // We must ensure that all the workloads have finished before decrementing the
   // instances count.
-  L.sync();
+  sync();
 }
 
-void TaskGroup::spawn(std::function<void()> F) {
+void TaskGroup::spawn(std::function<void()> F, TaskPriority Priority) {
 #if LLVM_ENABLE_THREADS
   if (Parallel) {
     L.inc();
-    detail::Executor::getDefaultExecutor()->add([&, F = std::move(F)] {
-      F();
-      L.dec();
-    });
+    TimeTraceProfiler *Profiler =
+        traceTasks ? getTimeTraceProfilerInstance() : nullptr;
+    detail::Executor::getDefaultExecutor()->add(
+        [&, F = std::move(F), Profiler] {
+          // The trace of the worker is handed over once the task is done, so
+          // that it is complete by the time the spawning thread writes the
+          // trace.
+          if (Profiler && !getTimeTraceProfilerInstance()) {
+            timeTraceProfilerInitialize(Profiler);
+            {
+              TimeTraceScope Scope("Parallel task");
+              F();
+            }
+            timeTraceProfilerFinishThread();
+          } else {
+            F();
+          }
+          L.dec();
+        },
+        &L, Priority);
     return;
   }
 #endif
   F();
 }
 
+void TaskGroup::sync() const {
+#if LLVM_ENABLE_THREADS
+  if (Parallel && threadIndex != UINT_MAX) {
+    detail::Executor *E = detail::Executor::getDefaultExecutor();
+    while (!L.isDone())
+      if (!E->runGroupTask(&L))
+        break;
+  }
+#endif
+  L.sync();
+}
+
 } // namespace parallel
 } // namespace llvm
 
@@ -0,0 +1,199 @@
+//===- SlabPoolAllocator.cpp - Size-class pool allocator ------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/SlabPoolAllocator.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/raw_ostream.h"
+#include <tuple>
+
+using namespace llvm;
+
+SlabPoolListener::~SlabPoolListener() = default;
+
+static uint64_t getNextAllocatorID() {
+  static std::atomic<uint64_t> NextID{1};
+  return NextID.fetch_add(1, std::memory_order_relaxed);
+}
+
+SlabPoolAllocator::SlabPoolAllocator(size_t SlabSize, size_t MaxPooledSize)
+    : ID(getNextAllocatorID()), SlabSize(SlabSize),
+      MaxPooledSize(alignTo(MaxPooledSize, BlockAlign)) {
+  assert(this->MaxPooledSize <= MaxBlockSize && "size classes too large");
+  assert(SlabSize >= this->MaxPooledSize && "slabs too small");
+}
+
+SlabPoolAllocator::~SlabPoolAllocator() { releaseAll(); }
+
+SlabPoolAllocator::ThreadCache &SlabPoolAllocator::getThreadCacheSlow() {
+  std::thread::id Self = std::this_thread::get_id();
+  ThreadCache *Cache = nullptr;
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    for (const std::unique_ptr<ThreadCache> &C : Caches)
+      if (C->Owner == Self)
+        Cache = C.get();
+    if (!Cache) {
+      Caches.push_back(std::make_unique<ThreadCache>());
+      Cache = Caches.back().get();
+      Cache->Owner = Self;
+    }
+  }
+  Last.AllocatorID = ID;
+  Last.Cache = Cache;
+  return *Cache;
+}
+
+void *SlabPoolAllocator::refill(ThreadCache &Cache, unsigned Class) {
+  size_t BlockSize = getBlockSize(Class);
+  unsigned Batch = getBatchSize(Class);
+  std::lock_guard<std::mutex> Lock(Mutex);
+
+  // Take a batch from the shared free list, if it has any blocks.
+  if (FreeBlock *Head = SharedHeads[Class]) {
+    FreeBlock *Tail = Head;
+    unsigned N = 1;
+    for (; N < Batch && Tail->Next; ++N)
+      Tail = Tail->Next;
+    SharedHeads[Class] = Tail->Next;
+    SharedCounts[Class] -= N;
+    Tail->Next = nullptr;
+    Cache.Heads[Class] = Head->Next;
+    Cache.addCount(Class, N - 1);
+    return Head;
+  }
+
+  // Otherwise carve a batch from the current slab, starting a new one if it
+  // does not have room for at least one block.
+  if (size_t(End - CurPtr) < BlockSize) {
+    CurPtr = static_cast<char *>(allocate_buffer(SlabSize, BlockAlign));
+    End = CurPtr + SlabSize;
+    Slabs.push_back(CurPtr);
+    if (Listener)
+      Listener->slabAllocated(SlabSize);
+  }
+  unsigned N = std::min<size_t>(Batch, (End - CurPtr) / BlockSize);
+  auto *Result = reinterpret_cast<FreeBlock *>(CurPtr);
+  FreeBlock *Head = nullptr;
+  for (unsigned I = N - 1; I > 0; --I) {
+    auto *Block = reinterpret_cast<FreeBlock *>(CurPtr + I * BlockSize);
+    Block->Next = Head;
+    Head = Block;
+  }
+  CurPtr += N * BlockSize;
+  NumCarved[Class] += N;
+  Cache.Heads[Class] = Head;
+  Cache.addCount(Class, N - 1);
+  return Result;
+}
+
+void SlabPoolAllocator::flush(ThreadCache &Cache, unsigned Class) {
+  // Keep one batch in the cache and hand the rest to the other threads.
+  unsigned Batch = getBatchSize(Class);
+  FreeBlock *Tail = Cache.Heads[Class];
+  for (unsigned I = 1; I < Batch; ++I)
+    Tail = Tail->Next;
+  FreeBlock *Head = Tail->Next;
+  Tail->Next = nullptr;
+  unsigned N = Cache.Counts[Class].load(std::memory_order_relaxed) - Batch;
+  Cache.addCount(Class, -int(N));
+
+  FreeBlock *RestTail = Head;
+  while (RestTail->Next)
+    RestTail = RestTail->Next;
+  std::lock_guard<std::mutex> Lock(Mutex);
+  RestTail->Next = SharedHeads[Class];
+  SharedHeads[Class] = Head;
+  SharedCounts[Class] += N;
+}
+
+void *SlabPoolAllocator::allocateLarge(size_t Size, size_t Alignment) {
+  void *Ptr = allocate_buffer(Size, Alignment);
+  std::lock_guard<std::mutex> Lock(Mutex);
+  LargeAllocations.try_emplace(Ptr, Size, Alignment);
+  LargeBytes += Size;
+  if (Listener)
+    Listener->largeAllocated(Size);
+  return Ptr;
+}
+
+void SlabPoolAllocator::deallocateLarge(const void *Ptr) {
+  size_t Size, Alignment;
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    auto It = LargeAllocations.find(const_cast<void *>(Ptr));
+    assert(It != LargeAllocations.end() && "not allocated by this allocator");
+    std::tie(Size, Alignment) = It->second;
+    LargeAllocations.erase(It);
+    LargeBytes -= Size;
+    if (Listener)
+      Listener->largeDeallocated(Size);
+  }
+  deallocate_buffer(const_cast<void *>(Ptr), Size, Alignment);
+}
+
+SlabPoolStats SlabPoolAllocator::getStats() const {
+  SlabPoolStats Stats;
+  std::lock_guard<std::mutex> Lock(Mutex);
+  Stats.NumSlabs = Slabs.size();
+  Stats.SlabBytes = Slabs.size() * SlabSize;
+  Stats.NumLargeAllocations = LargeAllocations.size();
+  Stats.LargeBytes = LargeBytes;
+  for (unsigned Class = 0; Class != MaxSizeClasses; ++Class) {
+    size_t NumFree = SharedCounts[Class];
+    for (const std::unique_ptr<ThreadCache> &C : Caches)
+      NumFree += C->Counts[Class].load(std::memory_order_relaxed);
+    size_t BlockSize = getBlockSize(Class);
+    Stats.InUseBytes += (NumCarved[Class] - NumFree) * BlockSize;
+    Stats.FreeBytes += NumFree * BlockSize;
+  }
+  return Stats;
+}
+
+size_t SlabPoolAllocator::getTotalMemory() const {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  return Slabs.size() * SlabSize + LargeBytes;
+}
+
+void SlabPoolAllocator::PrintStats() const {
+  SlabPoolStats Stats = getStats();
+  errs() << "\nNumber of memory regions: " << Stats.NumSlabs << '\n'
+         << "Bytes in slabs: " << Stats.SlabBytes << '\n'
+         << "Bytes in use: " << Stats.InUseBytes << '\n'
+         << "Bytes free for reuse: " << Stats.FreeBytes << '\n'
+         << "Large allocations: " << Stats.NumLargeAllocations << " ("
+         << Stats.LargeBytes << " bytes)\n";
+}
+
+void SlabPoolAllocator::releaseAll() {
+  if (Listener)
+    Listener->released(getStats());
+  for (void *Slab : Slabs)
+    deallocate_buffer(Slab, SlabSize, BlockAlign);
+  for (auto &[Ptr, SizeAndAlign] : LargeAllocations)
+    deallocate_buffer(Ptr, SizeAndAlign.first, SizeAndAlign.second);
+}
+
+void SlabPoolAllocator::Reset() {
+  releaseAll();
+  Slabs.clear();
+  LargeAllocations.clear();
+  LargeBytes = 0;
+  CurPtr = End = nullptr;
+  for (unsigned Class = 0; Class != MaxSizeClasses; ++Class) {
+    SharedHeads[Class] = nullptr;
+    SharedCounts[Class] = 0;
+    NumCarved[Class] = 0;
+  }
+  // Keep the caches, the threads still point to them.
+  for (const std::unique_ptr<ThreadCache> &C : Caches) {
+    for (unsigned Class = 0; Class != MaxSizeClasses; ++Class) {
+      C->Heads[Class] = nullptr;
+      C->Counts[Class].store(0, std::memory_order_relaxed);
+    }
+  }
+}
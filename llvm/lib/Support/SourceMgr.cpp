@@ -88,13 +88,11 @@ static std::vector<T> &GetOrCreateOffsetCache(void *&OffsetCache,
 
   // Lazily fill in the offset cache.
   auto *Offsets = new std::vector<T>();
-  size_t Sz = Buffer->getBufferSize();
-  assert(Sz <= std::numeric_limits<T>::max());
   StringRef S = Buffer->getBuffer();
-  for (size_t N = 0; N < Sz; ++N) {
-    if (S[N] == '\n')
-      Offsets->push_back(static_cast<T>(N));
-  }
+  assert(S.size() <= std::numeric_limits<T>::max());
+  Offsets->reserve(S.count('\n'));
+  for (size_t N = S.find('\n'); N != StringRef::npos; N = S.find('\n', N + 1))
+    Offsets->push_back(static_cast<T>(N));
 
   OffsetCache = Offsets;
   return *Offsets;
@@ -13,10 +13,87 @@
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/edit_distance.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/MathExtras.h"
 #include <bitset>
 
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LLVM_STRINGREF_SSE2 1
+#elif (defined(__aarch64__) || defined(_M_ARM64)) && !defined(__ARM_BIG_ENDIAN)
+#include <arm_neon.h>
+#define LLVM_STRINGREF_NEON 1
+#endif
+
+#if defined(LLVM_STRINGREF_SSE2) || defined(LLVM_STRINGREF_NEON)
+#define LLVM_STRINGREF_SIMD 1
+#endif
+
 using namespace llvm;
 
+#ifdef LLVM_STRINGREF_SIMD
+namespace {
+/// 16 bytes of a string, compared at once. Both SSE2 and NEON are part of the
+/// baseline of their targets, so no runtime dispatch is needed.
+struct ByteBlock {
+  static constexpr size_t Size = 16;
+
+#ifdef LLVM_STRINGREF_SSE2
+  __m128i V;
+
+  /// The number of bits per byte in the result of mask().
+  static constexpr unsigned MaskBits = 1;
+
+  static ByteBlock load(const char *P) {
+    return {_mm_loadu_si128(reinterpret_cast<const __m128i *>(P))};
+  }
+  static ByteBlock splat(char C) { return {_mm_set1_epi8(C)}; }
+  static ByteBlock zero() { return {_mm_setzero_si128()}; }
+  ByteBlock eq(ByteBlock O) const { return {_mm_cmpeq_epi8(V, O.V)}; }
+  ByteBlock operator&(ByteBlock O) const { return {_mm_and_si128(V, O.V)}; }
+  ByteBlock operator|(ByteBlock O) const { return {_mm_or_si128(V, O.V)}; }
+  ByteBlock operator-(ByteBlock O) const { return {_mm_sub_epi8(V, O.V)}; }
+  uint64_t mask() const { return unsigned(_mm_movemask_epi8(V)); }
+  uint64_t sumBytes() const {
+    __m128i Sums = _mm_sad_epu8(V, _mm_setzero_si128());
+    return uint64_t(_mm_cvtsi128_si32(Sums)) +
+           uint64_t(_mm_cvtsi128_si32(_mm_srli_si128(Sums, 8)));
+  }
+#else
+  uint8x16_t V;
+
+  static constexpr unsigned MaskBits = 4;
+
+  static ByteBlock load(const char *P) {
+    return {vld1q_u8(reinterpret_cast<const uint8_t *>(P))};
+  }
+  static ByteBlock splat(char C) { return {vdupq_n_u8(uint8_t(C))}; }
+  static ByteBlock zero() { return {vdupq_n_u8(0)}; }
+  ByteBlock eq(ByteBlock O) const { return {vceqq_u8(V, O.V)}; }
+  ByteBlock operator&(ByteBlock O) const { return {vandq_u8(V, O.V)}; }
+  ByteBlock operator|(ByteBlock O) const { return {vorrq_u8(V, O.V)}; }
+  ByteBlock operator-(ByteBlock O) const { return {vsubq_u8(V, O.V)}; }
+  // Narrow each byte to a nibble; NEON has no movemask.
+  uint64_t mask() const {
+    uint8x8_t Nibbles = vshrn_n_u16(vreinterpretq_u16_u8(V), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(Nibbles), 0);
+  }
+  uint64_t sumBytes() const { return vaddlvq_u8(V); }
+#endif
+
+  /// Return the index of the first byte set in \p Mask, a result of mask().
+  static unsigned firstIndex(uint64_t Mask) {
+    return llvm::countr_zero(Mask) / MaskBits;
+  }
+  /// Clear the first byte set in \p Mask.
+  static uint64_t clearFirst(uint64_t Mask) {
+    return Mask & ~(((uint64_t(1) << MaskBits) - 1)
+                    << (firstIndex(Mask) * MaskBits));
+  }
+};
+} // end anonymous namespace
+#endif
+
 // MSVC emits references to this into the translation units which reference it.
 #ifndef _MSC_VER
 constexpr size_t StringRef::npos;
@@ -145,6 +222,30 @@ size_t StringRef::find(StringRef Str, size_t From) const {
     return Ptr == nullptr ? npos : Ptr - Data;
   }
 
+#ifdef LLVM_STRINGREF_SIMD
+  // Compare 16 candidate positions at once against the first and the last
+  // character of the needle, and only compare the rest at the positions where
+  // both match. The remaining positions are handled below.
+  if (Size - N + 1 >= ByteBlock::Size) {
+    ByteBlock First = ByteBlock::splat(Needle[0]);
+    ByteBlock Last = ByteBlock::splat(Needle[N - 1]);
+    const char *BlockStop = Start + (Size - N + 1) - ByteBlock::Size;
+    for (; Start <= BlockStop; Start += ByteBlock::Size) {
+      ByteBlock Match = ByteBlock::load(Start).eq(First) &
+                        ByteBlock::load(Start + N - 1).eq(Last);
+      for (uint64_t Mask = Match.mask(); Mask;
+           Mask = ByteBlock::clearFirst(Mask)) {
+        const char *Candidate = Start + ByteBlock::firstIndex(Mask);
+        if (std::memcmp(Candidate + 1, Needle + 1, N - 2) == 0)
+          return Candidate - Data;
+      }
+    }
+    Size = Length - (Start - Data);
+    if (Size < N)
+      return npos;
+  }
+#endif
+
   const char *Stop = Start + (Size - N + 1);
 
   if (N == 2) {
@@ -236,11 +337,31 @@ size_t StringRef::rfind_insensitive(StringRef Str) const {
 /// Note: O(size() + Chars.size())
 StringRef::size_type StringRef::find_first_of(StringRef Chars,
                                               size_t From) const {
+  size_type i = std::min(From, Length);
+#ifdef LLVM_STRINGREF_SIMD
+  // Compare against each character when there are few of them, e.g. when
+  // looking for the end of a line or a token.
+  constexpr size_t MaxSIMDChars = 4;
+  if (!Chars.empty() && Chars.size() <= MaxSIMDChars) {
+    ByteBlock Splats[MaxSIMDChars];
+    for (size_t I = 0; I != Chars.size(); ++I)
+      Splats[I] = ByteBlock::splat(Chars[I]);
+    for (; i + ByteBlock::Size <= Length; i += ByteBlock::Size) {
+      ByteBlock B = ByteBlock::load(Data + i);
+      ByteBlock Match = B.eq(Splats[0]);
+      for (size_t I = 1; I != Chars.size(); ++I)
+        Match = Match | B.eq(Splats[I]);
+      if (uint64_t Mask = Match.mask())
+        return i + ByteBlock::firstIndex(Mask);
+    }
+  }
+#endif
+
   std::bitset<1 << CHAR_BIT> CharBits;
   for (char C : Chars)
     CharBits.set((unsigned char)C);
 
-  for (size_type i = std::min(From, Length), e = Length; i != e; ++i)
+  for (size_type e = Length; i != e; ++i)
     if (CharBits.test((unsigned char)Data[i]))
       return i;
   return npos;
@@ -366,6 +487,29 @@ void StringRef::split(SmallVectorImpl<StringRef> &A, char Separator,
 // Helpful Algorithms
 //===----------------------------------------------------------------------===//
 
+/// count - Return the number of occurrences of \arg C in the string.
+size_t StringRef::count(char C) const {
+  size_t Count = 0;
+  size_t I = 0;
+#ifdef LLVM_STRINGREF_SIMD
+  // Accumulate the matches in 8-bit lanes, which overflow after 255 blocks.
+  ByteBlock Splat = ByteBlock::splat(C);
+  while (I + ByteBlock::Size <= Length) {
+    ByteBlock Sums = ByteBlock::zero();
+    size_t NumBlocks =
+        std::min<size_t>((Length - I) / ByteBlock::Size, 255);
+    for (size_t E = I + NumBlocks * ByteBlock::Size; I != E;
+         I += ByteBlock::Size)
+      Sums = Sums - ByteBlock::load(Data + I).eq(Splat);
+    Count += Sums.sumBytes();
+  }
+#endif
+  for (; I != Length; ++I)
+    if (Data[I] == C)
+      ++Count;
+  return Count;
+}
+
 /// count - Return the number of non-overlapped occurrences of \arg Str in
 /// the string.
 size_t StringRef::count(StringRef Str) const {
@@ -0,0 +1,114 @@
+//===- llvm/Support/SuffixArray.cpp - Implement Suffix Array ----*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the Suffix Array class.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/SuffixArray.h"
+#include "llvm/ADT/STLExtras.h"
+#include <numeric>
+
+using namespace llvm;
+
+SuffixArray::SuffixArray(ArrayRef<unsigned> Str) {
+  unsigned N = Str.size();
+  Suffixes.resize(N);
+  if (N == 0)
+    return;
+
+  // Rank the suffixes by their first element.
+  std::iota(Suffixes.begin(), Suffixes.end(), 0);
+  llvm::sort(Suffixes, [&](unsigned A, unsigned B) {
+    return std::make_pair(Str[A], A) < std::make_pair(Str[B], B);
+  });
+  std::vector<unsigned> Ranks(N), Tmp(N);
+  Ranks[Suffixes[0]] = 0;
+  for (unsigned I = 1; I != N; ++I)
+    Ranks[Suffixes[I]] =
+        Ranks[Suffixes[I - 1]] + (Str[Suffixes[I]] != Str[Suffixes[I - 1]]);
+
+  // Double the length of the sorted prefixes until all ranks are distinct.
+  // Suffixes are sorted by the rank of their first K elements, then by the
+  // rank of the next K elements, where a suffix shorter than that comes
+  // first.
+  std::vector<unsigned> Counts;
+  for (unsigned K = 1; Ranks[Suffixes[N - 1]] != N - 1; K *= 2) {
+    // Order the suffixes by their second key.
+    unsigned J = 0;
+    for (unsigned I = N - std::min(K, N); I != N; ++I)
+      Tmp[J++] = I;
+    for (unsigned S : Suffixes)
+      if (S >= K)
+        Tmp[J++] = S - K;
+
+    // Stably sort them by their first key.
+    Counts.assign(Ranks[Suffixes[N - 1]] + 1, 0);
+    for (unsigned R : Ranks)
+      ++Counts[R];
+    std::partial_sum(Counts.begin(), Counts.end(), Counts.begin());
+    for (unsigned I = N; I-- != 0;)
+      Suffixes[--Counts[Ranks[Tmp[I]]]] = Tmp[I];
+
+    auto SecondKey = [&](unsigned S) -> int64_t {
+      return S + K < N ? Ranks[S + K] : -1;
+    };
+    Tmp[Suffixes[0]] = 0;
+    for (unsigned I = 1; I != N; ++I) {
+      unsigned A = Suffixes[I - 1], B = Suffixes[I];
+      Tmp[B] = Tmp[A] + (Ranks[A] != Ranks[B] || SecondKey(A) != SecondKey(B));
+    }
+    std::swap(Ranks, Tmp);
+  }
+
+  // Compute the LCPs with Kasai's algorithm. The LCP of a suffix with its
+  // predecessor is at most one shorter than that of the previous suffix.
+  LCPs.assign(N, 0);
+  unsigned Len = 0;
+  for (unsigned I = 0; I != N; ++I) {
+    unsigned Rank = Ranks[I];
+    if (Rank == 0) {
+      Len = 0;
+      continue;
+    }
+    unsigned Prev = Suffixes[Rank - 1];
+    while (I + Len < N && Prev + Len < N && Str[I + Len] == Str[Prev + Len])
+      ++Len;
+    LCPs[Rank] = Len;
+    if (Len > 0)
+      --Len;
+  }
+}
+
+void SuffixArray::RepeatedSubstringIterator::advance() {
+  // Visit the LCP intervals bottom-up. An interval ends at the first suffix
+  // whose LCP with its predecessor is shorter than that of the interval.
+  unsigned N = SA->Suffixes.size();
+  while (Idx <= N) {
+    unsigned LCP = Idx < N ? SA->LCPs[Idx] : 0;
+    if (LCP < Intervals.back().first) {
+      auto [Length, First] = Intervals.pop_back_val();
+      // The enclosing interval starts where this one does.
+      FirstIdx = First;
+      if (Length < MinLength)
+        continue;
+      RS.Length = Length;
+      RS.StartIndices.assign(SA->Suffixes.begin() + First,
+                             SA->Suffixes.begin() + Idx);
+      return;
+    }
+    if (LCP > Intervals.back().first)
+      Intervals.push_back({LCP, FirstIdx});
+    FirstIdx = Idx++;
+  }
+
+  // Only the root interval is left.
+  SA = nullptr;
+  Idx = 1;
+  Intervals.clear();
+}
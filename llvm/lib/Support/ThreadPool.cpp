@@ -32,6 +32,10 @@ ThreadPoolInterface::~ThreadPoolInterface() = default;
 
 #if LLVM_ENABLE_THREADS
 
+// The NUMA node the current worker thread is pinned to, or -1 if it is not
+// pinned.
+static LLVM_THREAD_LOCAL int CurrentThreadNUMANode = -1;
+
 StdThreadPool::StdThreadPool(ThreadPoolStrategy S)
     : Strategy(S), MaxThreadCount(S.compute_thread_count()) {}
 
@@ -45,6 +49,8 @@ void StdThreadPool::grow(int requested) {
     Threads.emplace_back([this, ThreadID] {
       set_thread_name(formatv("llvm-worker-{0}", ThreadID));
       Strategy.apply_thread_strategy(ThreadID);
+      if (std::optional<unsigned> Node = Strategy.compute_numa_node(ThreadID))
+        CurrentThreadNUMANode = *Node;
       processTasks(nullptr);
     });
   }
@@ -82,13 +88,23 @@ void StdThreadPool::processTasks(ThreadPoolTaskGroup *WaitingForGroup) {
       // in order for wait() to properly detect that even if the queue is
       // empty, there is still a task in flight.
       ++ActiveThreads;
-      Task = std::move(Tasks.front().first);
-      GroupOfTask = Tasks.front().second;
+      // A worker pinned to a NUMA node prefers the oldest task for its node or
+      // without a preference, but takes any task rather than going idle.
+      auto It = Tasks.begin();
+      if (CurrentThreadNUMANode >= 0) {
+        auto Local = llvm::find_if(Tasks, [](const QueuedTask &T) {
+          return !T.Node || *T.Node == unsigned(CurrentThreadNUMANode);
+        });
+        if (Local != Tasks.end())
+          It = Local;
+      }
+      Task = std::move(It->Fn);
+      GroupOfTask = It->Group;
       // Need to count active threads in each group separately, ActiveThreads
       // would never be 0 if waiting for another group inside a wait.
       if (GroupOfTask != nullptr)
         ++ActiveGroups[GroupOfTask]; // Increment or set to 1 if new item
-      Tasks.pop_front();
+      Tasks.erase(It);
     }
 #ifndef NDEBUG
     if (CurrentThreadTaskGroups == nullptr)
@@ -138,7 +154,7 @@ bool StdThreadPool::workCompletedUnlocked(ThreadPoolTaskGroup *Group) const {
     return !ActiveThreads && Tasks.empty();
   return ActiveGroups.count(Group) == 0 &&
          !llvm::any_of(Tasks,
-                       [Group](const auto &T) { return T.second == Group; });
+                       [Group](const auto &T) { return T.Group == Group; });
 }
 
 void StdThreadPool::wait() {
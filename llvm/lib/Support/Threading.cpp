@@ -48,6 +48,11 @@ unsigned llvm::ThreadPoolStrategy::compute_thread_count() const {
 // Unknown if threading turned off
 int llvm::get_physical_cores() { return -1; }
 
+std::optional<unsigned>
+llvm::ThreadPoolStrategy::compute_numa_node(unsigned ThreadPoolNum) const {
+  return std::nullopt;
+}
+
 #else
 
 static int computeHostNumHardwareThreads();
@@ -64,6 +69,16 @@ unsigned llvm::ThreadPoolStrategy::compute_thread_count() const {
   return std::min((unsigned)MaxThreadCount, ThreadsRequested);
 }
 
+std::optional<unsigned>
+llvm::ThreadPoolStrategy::compute_numa_node(unsigned ThreadPoolNum) const {
+  if (!PinToNUMANode)
+    return std::nullopt;
+  unsigned Nodes = get_cpus();
+  if (Nodes <= 1)
+    return std::nullopt;
+  return ThreadPoolNum % Nodes;
+}
+
 // Include the platform-specific parts of this class.
 #ifdef LLVM_ON_UNIX
 #include "Unix/Threading.inc"
@@ -97,20 +112,25 @@ const std::optional<unsigned> llvm::thread::DefaultStackSize;
 
 std::optional<ThreadPoolStrategy>
 llvm::get_threadpool_strategy(StringRef Num, ThreadPoolStrategy Default) {
+  bool PinToNUMANode = Num.consume_back(":numa");
+  auto WithNUMA = [&](ThreadPoolStrategy S) {
+    S.PinToNUMANode |= PinToNUMANode;
+    return S;
+  };
   if (Num == "all")
-    return llvm::hardware_concurrency();
+    return WithNUMA(llvm::hardware_concurrency());
   if (Num.empty())
-    return Default;
+    return WithNUMA(Default);
   unsigned V;
   if (Num.getAsInteger(10, V))
     return std::nullopt; // malformed 'Num' value
   if (V == 0)
-    return Default;
+    return WithNUMA(Default);
 
   // Do not take the Default into account. This effectively disables
   // heavyweight_hardware_concurrency() if the user asks for any number of
   // threads on the cmd-line.
   ThreadPoolStrategy S = llvm::hardware_concurrency();
   S.ThreadsRequested = V;
-  return S;
+  return WithNUMA(S);
 }
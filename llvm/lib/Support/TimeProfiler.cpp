@@ -354,6 +354,13 @@ void llvm::timeTraceProfilerInitialize(unsigned TimeTraceGranularity,
       TimeTraceVerbose);
 }
 
+void llvm::timeTraceProfilerInitialize(TimeTraceProfiler *Parent) {
+  assert(TimeTraceProfilerInstance == nullptr &&
+         "Profiler should not be initialized");
+  TimeTraceProfilerInstance = new TimeTraceProfiler(
+      Parent->TimeTraceGranularity, Parent->ProcName, Parent->TimeTraceVerbose);
+}
+
 // Removes all TimeTraceProfilerInstances.
 // Called from main thread.
 void llvm::timeTraceProfilerCleanup() {
@@ -0,0 +1,82 @@
+//===- raw_iovec_ostream.cpp - Scatter-gather file output stream ----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/raw_iovec_ostream.h"
+#include "llvm/ADT/ArrayRef.h"
+#include <cstring>
+
+using namespace llvm;
+
+raw_iovec_ostream::~raw_iovec_ostream() { flushPending(); }
+
+void raw_iovec_ostream::addFragment(StringRef Data) {
+  Pending.push_back(Data);
+  PendingBytes += Data.size();
+  if (Pending.size() >= MaxPendingFragments || CopiedBytes >= MaxCopiedBytes)
+    flushPending();
+}
+
+void raw_iovec_ostream::write_impl(const char *Ptr, size_t Size) {
+  if (Size == 0)
+    return;
+  CopiedBytes += Size;
+  if (size_t(End - CurPtr) < Size) {
+    if (Size > ChunkSize) {
+      LargeCopies.push_back(std::make_unique<char[]>(Size));
+      std::memcpy(LargeCopies.back().get(), Ptr, Size);
+      addFragment(StringRef(LargeCopies.back().get(), Size));
+      return;
+    }
+    size_t Next = CurPtr ? CurChunk + 1 : 0;
+    if (Next == Chunks.size())
+      Chunks.push_back(std::make_unique<char[]>(ChunkSize));
+    CurChunk = Next;
+    CurPtr = Chunks[CurChunk].get();
+    End = CurPtr + ChunkSize;
+  }
+
+  std::memcpy(CurPtr, Ptr, Size);
+  StringRef Data(CurPtr, Size);
+  CurPtr += Size;
+  // Extend the last fragment if this copy directly follows it, which keeps
+  // runs of small writes in one fragment.
+  if (!Pending.empty() && Pending.back().end() == Data.data()) {
+    Pending.back() = StringRef(Pending.back().data(),
+                               Pending.back().size() + Size);
+    PendingBytes += Size;
+    if (CopiedBytes >= MaxCopiedBytes)
+      flushPending();
+    return;
+  }
+  addFragment(Data);
+}
+
+void raw_iovec_ostream::writeStable(StringRef Data) {
+  if (Data.size() < MinStableSize) {
+    write(Data.data(), Data.size());
+    return;
+  }
+  addFragment(Data);
+}
+
+void raw_iovec_ostream::flushPending() {
+  if (!Pending.empty())
+    OS.write_vectored(Pending);
+  Pending.clear();
+  PendingBytes = 0;
+  CopiedBytes = 0;
+  LargeCopies.clear();
+  CurChunk = 0;
+  CurPtr = End = nullptr;
+}
+
+void raw_iovec_ostream::pwrite_impl(const char *Ptr, size_t Size,
+                                    uint64_t Offset) {
+  flushPending();
+  OS.pwrite(Ptr, Size, Offset);
+}
@@ -38,6 +38,10 @@
 # include <unistd.h>
 #endif
 
+#if defined(LLVM_ON_UNIX)
+#include <sys/uio.h>
+#endif
+
 #if defined(__CYGWIN__)
 #include <io.h>
 #endif
@@ -803,6 +807,56 @@ void raw_fd_ostream::write_impl(const char *Ptr, size_t Size) {
   } while (Size > 0);
 }
 
+void raw_fd_ostream::write_vectored(ArrayRef<StringRef> Pieces) {
+  flush();
+#if defined(LLVM_ON_UNIX)
+  if (TiedStream)
+    TiedStream->flush();
+
+  assert(FD >= 0 && "File already closed.");
+  SmallVector<struct iovec, 64> Vecs;
+  for (StringRef Piece : Pieces) {
+    if (Piece.empty())
+      continue;
+    Vecs.push_back({const_cast<char *>(Piece.data()), Piece.size()});
+    pos += Piece.size();
+  }
+
+  // POSIX only guarantees that IOV_MAX is at least 16, but it is 1024 on all
+  // systems we care about.
+  const size_t MaxVecs = 1024;
+  size_t I = 0;
+  while (I != Vecs.size()) {
+    ssize_t ret =
+        ::writev(FD, &Vecs[I], std::min<size_t>(Vecs.size() - I, MaxVecs));
+    if (ret < 0) {
+      // See write_impl for the handling of recoverable errors.
+      if (errno == EINTR || errno == EAGAIN
+#ifdef EWOULDBLOCK
+          || errno == EWOULDBLOCK
+#endif
+          )
+        continue;
+      error_detected(errnoAsErrorCode());
+      return;
+    }
+
+    // Skip the pieces written completely and trim the one written partially.
+    size_t Written = ret;
+    for (; I != Vecs.size() && Written >= Vecs[I].iov_len; ++I)
+      Written -= Vecs[I].iov_len;
+    if (Written) {
+      Vecs[I].iov_base = static_cast<char *>(Vecs[I].iov_base) + Written;
+      Vecs[I].iov_len -= Written;
+    }
+  }
+#else
+  for (StringRef Piece : Pieces)
+    if (!Piece.empty())
+      write_impl(Piece.data(), Piece.size());
+#endif
+}
+
 void raw_fd_ostream::close() {
   assert(ShouldClose);
   ShouldClose = false;
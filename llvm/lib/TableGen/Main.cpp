@@ -17,6 +17,7 @@
 #include "llvm/TableGen/Main.h"
 #include "TGLexer.h"
 #include "TGParser.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/Support/CommandLine.h"
@@ -63,6 +64,12 @@ WriteIfChanged("write-if-changed", cl::desc("Only write output if it changed"));
 static cl::opt<bool>
 TimePhases("time-phases", cl::desc("Time phases of parser and backend"));
 
+static cl::list<std::string> ExtraOutputs(
+    "emit-to",
+    cl::desc("Also run the backend of the given action, e.g. gen-instr-info, "
+             "on the parsed records and write its output to the given file"),
+    cl::value_desc("action=filename"));
+
 static cl::opt<bool> NoWarnOnUnusedTemplateArgs(
     "no-warn-on-unused-template-args",
     cl::desc("Disable unused template argument warnings."));
@@ -86,7 +93,10 @@ static int createDependencyFile(const TGParser &Parser, const char *argv0) {
   if (EC)
     return reportError(argv0, "error opening " + DependFilename + ":" +
                                   EC.message() + "\n");
-  DepOut.os() << OutputFilename << ":";
+  DepOut.os() << OutputFilename;
+  for (StringRef Output : ExtraOutputs)
+    DepOut.os() << ' ' << Output.split('=').second;
+  DepOut.os() << ":";
   for (const auto &Dep : Parser.getDependencies()) {
     DepOut.os() << ' ' << Dep;
   }
@@ -95,6 +105,29 @@ static int createDependencyFile(const TGParser &Parser, const char *argv0) {
   return 0;
 }
 
+/// Write \p Contents to \p Filename, unless -write-if-changed is given and
+/// the file already has these contents.
+static int writeOutput(const char *argv0, StringRef Filename,
+                       StringRef Contents) {
+  if (WriteIfChanged) {
+    // Only updates the real output file if there are any differences.
+    // This prevents recompilation of all the files depending on it if there
+    // aren't any.
+    if (auto ExistingOrErr = MemoryBuffer::getFile(Filename, /*IsText=*/true))
+      if (std::move(ExistingOrErr.get())->getBuffer() == Contents)
+        return 0;
+  }
+  std::error_code EC;
+  ToolOutputFile OutFile(Filename, EC, sys::fs::OF_Text);
+  if (EC)
+    return reportError(argv0, "error opening " + Filename + ": " +
+                                  EC.message() + "\n");
+  OutFile.os() << Contents;
+  if (ErrorsPrinted == 0)
+    OutFile.keep();
+  return 0;
+}
+
 int llvm::TableGenMain(const char *argv0,
                        std::function<TableGenMainFn> MainFn) {
   RecordKeeper Records;
@@ -139,6 +172,25 @@ int llvm::TableGenMain(const char *argv0,
   if (status)
     return 1;
 
+  // Run the backends of the extra outputs on the same records, which saves
+  // parsing the input again for each of them.
+  SmallVector<std::pair<StringRef, std::string>> ExtraOutStrings;
+  for (StringRef Output : ExtraOutputs) {
+    auto [Action, Filename] = Output.split('=');
+    if (Filename.empty())
+      return reportError(argv0, "expected action=filename for -emit-to, got '" +
+                                    Output + "'\n");
+    std::string ExtraOutString;
+    raw_string_ostream ExtraOut(ExtraOutString);
+    Records.startBackendTimer("Backend " + Action.str());
+    bool Unknown = TableGen::Emitter::ApplyCallback(Records, Action, ExtraOut);
+    Records.stopBackendTimer();
+    if (Unknown)
+      return reportError(argv0, "unknown action '" + Action +
+                                    "' for -emit-to\n");
+    ExtraOutStrings.emplace_back(Filename, std::move(ExtraOutString));
+  }
+
   // Always write the depfile, even if the main output hasn't changed.
   // If it's missing, Ninja considers the output dirty.  If this was below
   // the early exit below and someone deleted the .inc.d file but not the .inc
@@ -149,27 +201,11 @@ int llvm::TableGenMain(const char *argv0,
   }
 
   Records.startTimer("Write output");
-  bool WriteFile = true;
-  if (WriteIfChanged) {
-    // Only updates the real output file if there are any differences.
-    // This prevents recompilation of all the files depending on it if there
-    // aren't any.
-    if (auto ExistingOrErr =
-            MemoryBuffer::getFile(OutputFilename, /*IsText=*/true))
-      if (std::move(ExistingOrErr.get())->getBuffer() == OutString)
-        WriteFile = false;
-  }
-  if (WriteFile) {
-    std::error_code EC;
-    ToolOutputFile OutFile(OutputFilename, EC, sys::fs::OF_Text);
-    if (EC)
-      return reportError(argv0, "error opening " + OutputFilename + ": " +
-                                    EC.message() + "\n");
-    OutFile.os() << OutString;
-    if (ErrorsPrinted == 0)
-      OutFile.keep();
-  }
-  
+  if (int Ret = writeOutput(argv0, OutputFilename, OutString))
+    return Ret;
+  for (const auto &[Filename, Contents] : ExtraOutStrings)
+    if (int Ret = writeOutput(argv0, Filename, Contents))
+      return Ret;
   Records.stopTimer();
   Records.stopPhaseTiming();
 
@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/TableGen/TableGenBackend.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/ManagedStatic.h"
@@ -52,10 +53,14 @@ struct OptCreatorT {
 
 static ManagedStatic<cl::opt<FnT>, OptCreatorT> CallbackFunction;
 
+/// The callbacks by the name of their command line option.
+static ManagedStatic<StringMap<FnT>> CallbacksByName;
+
 Opt::Opt(StringRef Name, FnT CB, StringRef Desc, bool ByDefault) {
   if (ByDefault)
     CallbackFunction->setInitialValue(CB);
   CallbackFunction->getParser().addLiteralOption(Name, CB, Desc);
+  CallbacksByName->try_emplace(Name, CB);
 }
 
 /// Apply callback specified on the command line. Returns true if no callback
@@ -69,6 +74,15 @@ bool llvm::TableGen::Emitter::ApplyCallback(RecordKeeper &Records,
   return false;
 }
 
+bool llvm::TableGen::Emitter::ApplyCallback(RecordKeeper &Records,
+                                            StringRef Name, raw_ostream &OS) {
+  auto It = CallbacksByName->find(Name);
+  if (It == CallbacksByName->end())
+    return true;
+  It->second(Records, OS);
+  return false;
+}
+
 static void printLine(raw_ostream &OS, const Twine &Prefix, char Fill,
                       StringRef Suffix) {
   size_t Pos = (size_t)OS.tell();
@@ -214,6 +214,12 @@ static cl::opt<bool> EnableGISelLoadStoreOptPostLegal(
     cl::desc("Enable GlobalISel's post-legalizer load/store optimization pass"),
     cl::init(false), cl::Hidden);
 
+static cl::opt<bool> EnableGISelFastCombine(
+    "aarch64-gisel-fast-combine",
+    cl::desc("At -O1, only run GlobalISel's -O0 combines and skip the "
+             "post-legalizer combiner and load/store optimizations"),
+    cl::init(false), cl::Hidden);
+
 static cl::opt<bool>
     EnableSinkFold("aarch64-enable-sink-fold",
                    cl::desc("Enable sinking and folding of instruction copies"),
@@ -720,8 +726,15 @@ bool AArch64PassConfig::addIRTranslator() {
   return false;
 }
 
+/// Whether GlobalISel should trade code quality for compile time by running
+/// the reduced combine set it uses at -O0.
+static bool useGISelFastCombine(CodeGenOptLevel OptLevel) {
+  return OptLevel == CodeGenOptLevel::None ||
+         (OptLevel == CodeGenOptLevel::Less && EnableGISelFastCombine);
+}
+
 void AArch64PassConfig::addPreLegalizeMachineIR() {
-  if (getOptLevel() == CodeGenOptLevel::None) {
+  if (useGISelFastCombine(getOptLevel())) {
     addPass(createAArch64O0PreLegalizerCombiner());
     addPass(new Localizer());
   } else {
@@ -739,7 +752,7 @@ bool AArch64PassConfig::addLegalizeMachineIR() {
 
 void AArch64PassConfig::addPreRegBankSelect() {
   bool IsOptNone = getOptLevel() == CodeGenOptLevel::None;
-  if (!IsOptNone) {
+  if (!useGISelFastCombine(getOptLevel())) {
     addPass(createAArch64PostLegalizerCombiner(IsOptNone));
     if (EnableGISelLoadStoreOptPostLegal)
       addPass(new LoadStoreOpt());
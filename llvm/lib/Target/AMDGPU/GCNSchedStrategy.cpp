@@ -26,12 +26,20 @@
 #include "GCNSchedStrategy.h"
 #include "AMDGPUIGroupLP.h"
 #include "SIMachineFunctionInfo.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/CodeGen/RegisterClassInfo.h"
+#include "llvm/Support/TimeProfiler.h"
 
 #define DEBUG_TYPE "machine-scheduler"
 
 using namespace llvm;
 
+STATISTIC(NumRegionsScheduled, "Number of regions scheduled by GCN stages");
+STATISTIC(NumRegionsReverted, "Number of region schedules reverted");
+STATISTIC(NumRealRPReused,
+          "Number of region pressures reused for an unchanged schedule");
+
 static cl::opt<bool> DisableUnclusterHighRP(
     "amdgpu-disable-unclustered-high-rp-reschedule", cl::Hidden,
     cl::desc("Disable unclustered high register pressure "
@@ -669,6 +677,7 @@ void GCNScheduleDAGMILive::computeBlockPressure(unsigned RegionIdx,
 
     if (Regions[CurRegion].second == I) {
       Pressure[CurRegion] = RPTracker.moveMaxPressure();
+      RealPressure[CurRegion].reset();
       if (CurRegion-- == RegionIdx)
         break;
     }
@@ -714,6 +723,7 @@ void GCNScheduleDAGMILive::finalizeSchedule() {
   RegionsWithExcessRP.resize(Regions.size());
   RegionsWithMinOcc.resize(Regions.size());
   RegionsWithIGLPInstrs.resize(Regions.size());
+  RealPressure.resize(Regions.size());
   RescheduleRegions.set();
   RegionsWithHighRP.reset();
   RegionsWithExcessRP.reset();
@@ -723,6 +733,23 @@ void GCNScheduleDAGMILive::finalizeSchedule() {
   runSchedStages();
 }
 
+/// The name of a stage in time traces.
+static StringRef getSchedStageName(GCNSchedStageID StageID) {
+  switch (StageID) {
+  case GCNSchedStageID::OccInitialSchedule:
+    return "OccInitialSchedule";
+  case GCNSchedStageID::UnclusteredHighRPReschedule:
+    return "UnclusteredHighRPReschedule";
+  case GCNSchedStageID::ClusteredLowOccupancyReschedule:
+    return "ClusteredLowOccupancyReschedule";
+  case GCNSchedStageID::PreRARematerialize:
+    return "PreRARematerialize";
+  case GCNSchedStageID::ILPInitialSchedule:
+    return "ILPInitialSchedule";
+  }
+  llvm_unreachable("Unknown SchedStageID.");
+}
+
 void GCNScheduleDAGMILive::runSchedStages() {
   LLVM_DEBUG(dbgs() << "All regions recorded, starting actual scheduling.\n");
 
@@ -731,6 +758,10 @@ void GCNScheduleDAGMILive::runSchedStages() {
 
   GCNSchedStrategy &S = static_cast<GCNSchedStrategy &>(*SchedImpl);
   while (S.advanceStage()) {
+    // Each stage may reschedule every region, so trace them one by one to see
+    // which of them the compile time goes to.
+    TimeTraceScope TimeScope(getSchedStageName(S.getCurrentStage()),
+                             MF.getName());
     auto Stage = createSchedStage(S.getCurrentStage());
     if (!Stage->initGCNSchedStage())
       continue;
@@ -1013,8 +1044,18 @@ void GCNSchedStage::finalizeGCNRegion() {
 }
 
 void GCNSchedStage::checkScheduling() {
-  // Check the results of scheduling.
-  PressureAfter = DAG.getRealRegPressure(RegionIdx);
+  ++NumRegionsScheduled;
+
+  // Check the results of scheduling. Later stages often end up with the same
+  // schedule as before, in which case the pressure computed when the region
+  // was last checked still holds.
+  std::optional<GCNRegPressure> &RealRP = DAG.RealPressure[RegionIdx];
+  if (RealRP && llvm::equal(make_pointer_range(DAG), Unsched)) {
+    ++NumRealRPReused;
+  } else {
+    RealRP = DAG.getRealRegPressure(RegionIdx);
+  }
+  PressureAfter = *RealRP;
   LLVM_DEBUG(dbgs() << "Pressure after scheduling: " << print(PressureAfter));
   LLVM_DEBUG(dbgs() << "Region: " << RegionIdx << ".\n");
 
@@ -1301,6 +1342,9 @@ bool GCNSchedStage::mayCauseSpilling(unsigned WavesAfter) {
 }
 
 void GCNSchedStage::revertScheduling() {
+  ++NumRegionsReverted;
+  // The pressure after scheduling doesn't hold for the original schedule.
+  DAG.RealPressure[RegionIdx].reset();
   DAG.RegionsWithMinOcc[RegionIdx] =
       PressureBefore.getOccupancy(ST) == DAG.MinOccupancy;
   LLVM_DEBUG(dbgs() << "Attempting to revert scheduling.\n");
@@ -1423,6 +1467,10 @@ bool PreRARematStage::sinkTriviallyRematInsts(const GCNSubtarget &ST,
   BitVector NewRescheduleRegions;
   LiveIntervals *LIS = DAG.LIS;
 
+  // Sinking changes the live ranges across regions, even if it is undone.
+  for (std::optional<GCNRegPressure> &RealRP : DAG.RealPressure)
+    RealRP.reset();
+
   NewRegions.resize(DAG.Regions.size());
   NewRescheduleRegions.resize(DAG.Regions.size());
 
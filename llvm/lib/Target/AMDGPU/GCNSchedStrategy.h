@@ -208,6 +208,10 @@ class GCNScheduleDAGMILive final : public ScheduleDAGMILive {
   // Region pressure cache.
   SmallVector<GCNRegPressure, 32> Pressure;
 
+  // Real pressure of the schedule of each region as of the last time it was
+  // checked, if the live ranges haven't changed since.
+  SmallVector<std::optional<GCNRegPressure>, 32> RealPressure;
+
   // Temporary basic block live-in cache.
   DenseMap<const MachineBasicBlock *, GCNRPTracker::LiveRegSet> MBBLiveIns;
 
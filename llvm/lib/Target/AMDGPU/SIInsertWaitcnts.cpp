@@ -2505,13 +2505,16 @@ bool SIInsertWaitcnts::runOnMachineFunction(MachineFunction &MF) {
   for (auto *MBB : ReversePostOrderTraversal<MachineFunction *>(&MF))
     BlockInfos.insert({MBB, BlockInfo()});
 
+  // Instead of sweeping all blocks again, each sweep starts from the first
+  // block that a back edge made dirty, as the blocks before it are clean.
   std::unique_ptr<WaitcntBrackets> Brackets;
-  bool Repeat;
+  auto BIE = BlockInfos.end();
+  auto RestartBII = BlockInfos.begin();
   do {
-    Repeat = false;
+    auto BII = RestartBII;
+    RestartBII = BIE;
 
-    for (auto BII = BlockInfos.begin(), BIE = BlockInfos.end(); BII != BIE;
-         ++BII) {
+    for (; BII != BIE; ++BII) {
       MachineBasicBlock *MBB = BII->first;
       BlockInfo &BI = BII->second;
       if (!BI.Dirty)
@@ -2542,8 +2545,8 @@ bool SIInsertWaitcnts::runOnMachineFunction(MachineFunction &MF) {
           BlockInfo &SuccBI = SuccBII->second;
           if (!SuccBI.Incoming) {
             SuccBI.Dirty = true;
-            if (SuccBII <= BII)
-              Repeat = true;
+            if (SuccBII <= BII && SuccBII < RestartBII)
+              RestartBII = SuccBII;
             if (!MoveBracketsToSucc) {
               MoveBracketsToSucc = &SuccBI;
             } else {
@@ -2551,15 +2554,15 @@ bool SIInsertWaitcnts::runOnMachineFunction(MachineFunction &MF) {
             }
           } else if (SuccBI.Incoming->merge(*Brackets)) {
             SuccBI.Dirty = true;
-            if (SuccBII <= BII)
-              Repeat = true;
+            if (SuccBII <= BII && SuccBII < RestartBII)
+              RestartBII = SuccBII;
           }
         }
         if (MoveBracketsToSucc)
           MoveBracketsToSucc->Incoming = std::move(Brackets);
       }
     }
-  } while (Repeat);
+  } while (RestartBII != BIE);
 
   if (ST->hasScalarStores()) {
     SmallVector<MachineBasicBlock *, 4> EndPgmBlocks;
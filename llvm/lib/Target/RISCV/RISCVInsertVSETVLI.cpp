@@ -40,6 +40,7 @@ using namespace llvm;
 
 STATISTIC(NumInsertedVSETVL, "Number of VSETVL inst inserted");
 STATISTIC(NumCoalescedVSETVL, "Number of VSETVL inst coalesced");
+STATISTIC(NumPREVSETVL, "Number of VSETVL inst moved into a predecessor");
 
 namespace {
 
@@ -1541,14 +1542,22 @@ void RISCVInsertVSETVLI::doPRE(MachineBasicBlock &MBB) {
   // we need to prove the value is available at the point we're going
   // to insert the vsetvli at.
   if (AvailableInfo.hasAVLReg()) {
-    SlotIndex SI = AvailableInfo.getAVLVNInfo()->def;
-    // This is an inline dominance check which covers the case of
-    // UnavailablePred being the preheader of a loop.
-    if (LIS->getMBBFromIndex(SI) != UnavailablePred)
-      return;
-    if (!UnavailablePred->terminators().empty() &&
-        SI >= LIS->getInstructionIndex(*UnavailablePred->getFirstTerminator()))
-      return;
+    const VNInfo *AVLVNI = AvailableInfo.getAVLVNInfo();
+    SlotIndex SI = AVLVNI->def;
+    if (LIS->getMBBFromIndex(SI) == UnavailablePred) {
+      // This is an inline dominance check which covers the case of
+      // UnavailablePred being the preheader of a loop.
+      if (!UnavailablePred->terminators().empty() &&
+          SI >= LIS->getInstructionIndex(
+                    *UnavailablePred->getFirstTerminator()))
+        return;
+    } else {
+      // Otherwise, the value must be live out of UnavailablePred, e.g.
+      // because the AVL of a loop is computed before its preheader.
+      const LiveInterval &LI = LIS->getInterval(AvailableInfo.getAVLReg());
+      if (LI.getVNInfoBefore(LIS->getMBBEndIdx(UnavailablePred)) != AVLVNI)
+        return;
+    }
   }
 
   // Model the effect of changing the input state of the block MBB to
@@ -1594,6 +1603,7 @@ void RISCVInsertVSETVLI::doPRE(MachineBasicBlock &MBB) {
   // Note there's an implicit assumption here that terminators never use
   // or modify VL or VTYPE.  Also, fallthrough will return end().
   auto InsertPt = UnavailablePred->getFirstInstrTerminator();
+  ++NumPREVSETVL;
   insertVSETVLI(*UnavailablePred, InsertPt,
                 UnavailablePred->findDebugLoc(InsertPt),
                 AvailableInfo, OldExit);
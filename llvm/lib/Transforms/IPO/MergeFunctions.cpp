@@ -177,6 +177,7 @@ class FunctionNode {
 public:
   // Note the hash is recalculated potentially multiple times, but it is cheap.
   FunctionNode(Function *F) : F(F), Hash(StructuralHash(*F)) {}
+  FunctionNode(Function *F, IRHash Hash) : F(F), Hash(Hash) {}
 
   Function *getFunc() const { return F; }
   IRHash getHash() const { return Hash; }
@@ -298,6 +299,12 @@ private:
   // dangling iterators into FnTree. The invariant that preserves this is that
   // there is exactly one mapping F -> FN for each FunctionNode FN in FnTree.
   DenseMap<AssertingVH<Function>, FnTreeType::iterator> FNodesInTree;
+
+  /// The hashes computed by runOnModule() for the functions of the first
+  /// worklist, so that insert() does not compute them again. An entry is
+  /// dropped as soon as it is used, its function may have changed or its
+  /// function is erased.
+  DenseMap<AssertingVH<Function>, IRHash> PrefilterHashes;
 };
 } // end anonymous namespace
 
@@ -436,6 +443,7 @@ bool MergeFunctions::runOnModule(Module &M) {
     if ((I != S && std::prev(I)->first == I->first) ||
         (std::next(I) != IE && std::next(I)->first == I->first) ) {
       Deferred.push_back(WeakTrackingVH(I->second));
+      PrefilterHashes[I->second] = I->first;
     }
   }
 
@@ -462,6 +470,7 @@ bool MergeFunctions::runOnModule(Module &M) {
 
   FnTree.clear();
   FNodesInTree.clear();
+  PrefilterHashes.clear();
   GlobalNumbers.clear();
   Used.clear();
 
@@ -806,6 +815,7 @@ void MergeFunctions::writeThunk(Function *F, Function *G) {
     copyMetadataIfPresent(G, NewG, "kcfi_type");
     removeUsers(G);
     G->replaceAllUsesWith(NewG);
+    PrefilterHashes.erase(G);
     G->eraseFromParent();
   }
 
@@ -842,6 +852,7 @@ void MergeFunctions::writeAlias(Function *F, Function *G) {
 
   removeUsers(G);
   G->replaceAllUsesWith(GA);
+  PrefilterHashes.erase(G);
   G->eraseFromParent();
 
   LLVM_DEBUG(dbgs() << "writeAlias: " << GA->getName() << '\n');
@@ -926,6 +937,7 @@ void MergeFunctions::mergeTwoFunctions(Function *F, Function *G) {
     // stop here and delete G. There's no need for a thunk. (See note on
     // MergeFunctionsPDI above).
     if (G->isDiscardableIfUnused() && G->use_empty() && !MergeFunctionsPDI) {
+      PrefilterHashes.erase(G);
       G->eraseFromParent();
       ++NumFunctionsMerged;
       return;
@@ -978,8 +990,13 @@ static bool isFuncOrderCorrect(const Function *F, const Function *G) {
 // Insert a ComparableFunction into the FnTree, or merge it away if equal to one
 // that was already inserted.
 bool MergeFunctions::insert(Function *NewFunction) {
+  auto HashIt = PrefilterHashes.find(NewFunction);
   std::pair<FnTreeType::iterator, bool> Result =
-      FnTree.insert(FunctionNode(NewFunction));
+      HashIt == PrefilterHashes.end()
+          ? FnTree.insert(FunctionNode(NewFunction))
+          : FnTree.insert(FunctionNode(NewFunction, HashIt->second));
+  if (HashIt != PrefilterHashes.end())
+    PrefilterHashes.erase(HashIt);
 
   if (Result.second) {
     assert(FNodesInTree.count(NewFunction) == 0);
@@ -1010,6 +1027,8 @@ bool MergeFunctions::insert(Function *NewFunction) {
 // Remove a function from FnTree. If it was already in FnTree, add
 // it to Deferred so that we'll look at it in the next round.
 void MergeFunctions::remove(Function *F) {
+  // F is about to change, so a hash computed before is stale.
+  PrefilterHashes.erase(F);
   auto I = FNodesInTree.find(F);
   if (I != FNodesInTree.end()) {
     LLVM_DEBUG(dbgs() << "Deferred " << F->getName() << ".\n");
@@ -0,0 +1,589 @@
+//===- ParallelFunctionOptimizer.cpp - Optimize functions in parallel -----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Every partition is copied with CloneModule and handed to its thread as
+// bitcode, which the thread reads into a context of its own, like the
+// parallel code generation of LTO does. The optimized partition comes back as
+// bitcode too, and is read into the context of the original module. Its
+// function bodies are then remapped to the globals, types and metadata of the
+// original module and spliced into the original functions.
+//
+// The cache of optimized functions works on partitions of a single function.
+// The partition module only keeps the globals the function refers to, so the
+// bitcode of the same function is the same in all modules that define it, and
+// the hash of that bitcode and of the pipeline key is the key of the action
+// cache entry that refers to the bitcode of the optimized partition.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Transforms/IPO/ParallelFunctionOptimizer.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/CAS/ActionCache.h"
+#include "llvm/CAS/ObjectStore.h"
+#include "llvm/IR/DebugProgramInstruction.h"
+#include "llvm/IR/DerivedTypes.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/GlobalAlias.h"
+#include "llvm/IR/GlobalIFunc.h"
+#include "llvm/IR/GlobalVariable.h"
+#include "llvm/IR/InstIterator.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Metadata.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Transforms/Utils/Cloning.h"
+#include "llvm/Transforms/Utils/ValueMapper.h"
+
+using namespace llvm;
+
+#define DEBUG_TYPE "parallel-function-optimizer"
+
+STATISTIC(NumCacheHits, "Number of functions reused from the cache");
+STATISTIC(NumCacheMisses, "Number of functions optimized and cached");
+
+/// Named metadata of a partition module that lists the distinct metadata
+/// nodes the partition shares with the original module. The bitcode round
+/// trip copies distinct nodes, so they are matched up by their position in
+/// this list.
+static const char *const AnchorsName = "llvm.parallel.anchors";
+
+namespace {
+
+/// The function definitions of a partition.
+struct Partition {
+  SmallVector<Function *, 0> Functions;
+  /// The distinct metadata nodes reachable from the functions.
+  SmallVector<MDNode *, 0> Anchors;
+  uint64_t Size = 0;
+};
+
+/// Maps the types of a partition module read into the context of the
+/// original module to the types of the original module. The bitcode reader
+/// gives the named struct types of the partition new names, made unique with
+/// a numeric suffix.
+class PartitionTypeMapper : public ValueMapTypeRemapper {
+public:
+  Type *remapType(Type *SrcTy) override;
+
+private:
+  Type *computeType(Type *Ty);
+  Type *remapNamedStruct(StructType *ST);
+
+  DenseMap<Type *, Type *> MappedTypes;
+};
+
+} // end anonymous namespace
+
+Type *PartitionTypeMapper::remapType(Type *SrcTy) {
+  if (Type *Mapped = MappedTypes.lookup(SrcTy))
+    return Mapped;
+  Type *Result = computeType(SrcTy);
+  MappedTypes[SrcTy] = Result;
+  return Result;
+}
+
+Type *PartitionTypeMapper::computeType(Type *Ty) {
+  if (auto *ST = dyn_cast<StructType>(Ty); ST && !ST->isLiteral())
+    return remapNamedStruct(ST);
+
+  SmallVector<Type *, 4> Elts;
+  bool Changed = false;
+  for (Type *Sub : Ty->subtypes()) {
+    Elts.push_back(remapType(Sub));
+    Changed |= Elts.back() != Sub;
+  }
+  if (!Changed)
+    return Ty;
+  switch (Ty->getTypeID()) {
+  case Type::ArrayTyID:
+    return ArrayType::get(Elts[0], cast<ArrayType>(Ty)->getNumElements());
+  case Type::FixedVectorTyID:
+  case Type::ScalableVectorTyID:
+    return VectorType::get(Elts[0], cast<VectorType>(Ty)->getElementCount());
+  case Type::FunctionTyID:
+    return FunctionType::get(Elts[0], ArrayRef(Elts).drop_front(),
+                             cast<FunctionType>(Ty)->isVarArg());
+  case Type::StructTyID:
+    return StructType::get(Ty->getContext(), Elts,
+                           cast<StructType>(Ty)->isPacked());
+  default:
+    return Ty;
+  }
+}
+
+Type *PartitionTypeMapper::remapNamedStruct(StructType *ST) {
+  auto [Name, Suffix] = ST->getName().rsplit('.');
+  if (Suffix.empty() || !all_of(Suffix, isDigit))
+    return ST;
+  StructType *Orig = StructType::getTypeByName(ST->getContext(), Name);
+  if (!Orig || Orig->isOpaque() != ST->isOpaque())
+    return ST;
+  if (ST->isOpaque())
+    return Orig;
+  if (Orig->isPacked() != ST->isPacked() ||
+      Orig->getNumElements() != ST->getNumElements())
+    return ST;
+  for (auto [Elt, OrigElt] : zip(ST->elements(), Orig->elements()))
+    if (remapType(Elt) != OrigElt)
+      return ST;
+  return Orig;
+}
+
+/// Return whether the functions of \p M can be matched up with their copies
+/// in a partition module.
+static bool canPartition(const Module &M) {
+  // Globals are matched up by name.
+  for (const GlobalValue &GV : M.global_values())
+    if (!GV.hasName())
+      return false;
+  // Resolvers must be defined in the same module as their ifunc.
+  if (!M.ifunc_empty())
+    return false;
+  // Block addresses would refer to blocks of a different function.
+  for (const Function &F : M)
+    for (const BasicBlock &BB : F)
+      if (BB.hasAddressTaken())
+        return false;
+  return true;
+}
+
+/// Split the function definitions of \p M into up to \p N partitions of about
+/// the same number of instructions.
+static SmallVector<Partition, 0> partitionFunctions(Module &M, unsigned N) {
+  SmallVector<std::pair<uint64_t, Function *>, 0> Defs;
+  for (Function &F : M)
+    if (!F.isDeclaration())
+      Defs.emplace_back(F.getInstructionCount(), &F);
+
+  // Put the largest functions first, each into the smallest partition.
+  llvm::stable_sort(Defs, [](const auto &A, const auto &B) {
+    return A.first > B.first;
+  });
+  SmallVector<Partition, 0> Partitions(std::min<size_t>(N, Defs.size()));
+  for (auto [Size, F] : Defs) {
+    Partition &P = *min_element(Partitions, [](const auto &A, const auto &B) {
+      return A.Size < B.Size;
+    });
+    P.Functions.push_back(F);
+    P.Size += Size + 1;
+  }
+  return Partitions;
+}
+
+/// Collect the distinct metadata nodes reachable from the functions of \p P.
+static void collectAnchors(Partition &P) {
+  SmallPtrSet<const MDNode *, 32> Visited;
+  SmallVector<MDNode *, 32> Worklist;
+  auto Visit = [&](const Metadata *MD) {
+    if (auto *N = dyn_cast_or_null<MDNode>(MD))
+      if (Visited.insert(N).second)
+        Worklist.push_back(const_cast<MDNode *>(N));
+  };
+
+  SmallVector<std::pair<unsigned, MDNode *>, 8> MDs;
+  for (Function *F : P.Functions) {
+    MDs.clear();
+    F->getAllMetadata(MDs);
+    for (const auto &[Kind, N] : MDs)
+      Visit(N);
+    for (Instruction &I : instructions(F)) {
+      I.getAllMetadata(MDs);
+      for (const auto &[Kind, N] : MDs)
+        Visit(N);
+      for (const Use &Op : I.operands())
+        if (auto *MAV = dyn_cast<MetadataAsValue>(Op.get()))
+          Visit(MAV->getMetadata());
+      for (DbgRecord &DR : I.getDbgRecordRange()) {
+        Visit(DR.getDebugLoc().getAsMDNode());
+        if (auto *DLR = dyn_cast<DbgLabelRecord>(&DR)) {
+          Visit(DLR->getRawLabel());
+          continue;
+        }
+        auto &DVR = cast<DbgVariableRecord>(DR);
+        Visit(DVR.getRawLocation());
+        Visit(DVR.getRawVariable());
+        Visit(DVR.getRawExpression());
+        if (DVR.isDbgAssign()) {
+          Visit(DVR.getRawAssignID());
+          Visit(DVR.getRawAddressExpression());
+        }
+      }
+    }
+  }
+
+  while (!Worklist.empty()) {
+    MDNode *N = Worklist.pop_back_val();
+    if (N->isDistinct())
+      P.Anchors.push_back(N);
+    for (const MDOperand &Op : N->operands())
+      Visit(Op.get());
+  }
+}
+
+/// Collect the global variables the functions of \p P refer to, directly or
+/// through the initializers of other global variables.
+static SmallPtrSet<const GlobalValue *, 32>
+collectReferencedVariables(const Partition &P) {
+  SmallPtrSet<const GlobalValue *, 32> Variables;
+  SmallPtrSet<const Constant *, 32> Visited;
+  SmallVector<const Constant *, 32> Worklist;
+  auto Visit = [&](const Value *V) {
+    if (auto *C = dyn_cast<Constant>(V))
+      if (Visited.insert(C).second)
+        Worklist.push_back(C);
+  };
+  for (Function *F : P.Functions)
+    for (Instruction &I : instructions(F))
+      for (const Use &Op : I.operands())
+        Visit(Op.get());
+
+  while (!Worklist.empty()) {
+    const Constant *C = Worklist.pop_back_val();
+    if (auto *Var = dyn_cast<GlobalVariable>(C)) {
+      Variables.insert(Var);
+      if (Var->hasInitializer())
+        Visit(Var->getInitializer());
+    } else if (!isa<GlobalValue>(C)) {
+      for (const Use &Op : C->operands())
+        Visit(Op.get());
+    }
+  }
+  return Variables;
+}
+
+/// Copy the functions of \p P, declarations of the other functions, and the
+/// global variables of \p M into a new module and return its bitcode.
+///
+/// If \p ForCache, only the global variables the functions refer to are
+/// copied, unused declarations are dropped, and the module has no name, so
+/// that the bitcode does not depend on the rest of \p M.
+static SmallString<0> writePartition(Module &M, const Partition &P,
+                                     bool ForCache = false) {
+  SmallPtrSet<const GlobalValue *, 32> InPartition(P.Functions.begin(),
+                                                   P.Functions.end());
+  SmallPtrSet<const GlobalValue *, 32> Variables;
+  if (ForCache)
+    Variables = collectReferencedVariables(P);
+  NamedMDNode *Anchors = M.getOrInsertNamedMetadata(AnchorsName);
+  for (MDNode *N : P.Anchors)
+    Anchors->addOperand(N);
+  ValueToValueMapTy VMap;
+  std::unique_ptr<Module> MPart =
+      CloneModule(M, VMap, [&](const GlobalValue *GV) {
+        if (InPartition.contains(GV))
+          return true;
+        return isa<GlobalVariable>(GV) && (!ForCache || Variables.contains(GV));
+      });
+  M.eraseNamedMetadata(Anchors);
+
+  if (ForCache) {
+    for (GlobalValue &GV : make_early_inc_range(MPart->global_values()))
+      if (GV.isDeclaration() && GV.use_empty())
+        GV.eraseFromParent();
+    MPart->setModuleIdentifier("");
+    MPart->setSourceFileName("");
+  }
+
+  SmallString<0> BC;
+  raw_svector_ostream BCOS(BC);
+  WriteBitcodeToFile(*MPart, BCOS);
+  return BC;
+}
+
+static std::unique_ptr<Module> readPartition(StringRef BC, LLVMContext &Ctx) {
+  Expected<std::unique_ptr<Module>> MOrErr =
+      parseBitcodeFile(MemoryBufferRef(BC, "partition"), Ctx);
+  if (!MOrErr)
+    report_fatal_error(Twine("failed to read partition: ") +
+                       toString(MOrErr.takeError()));
+  return std::move(*MOrErr);
+}
+
+/// Read the partition in \p BC into a fresh context, optimize it and return
+/// its bitcode.
+static SmallString<0>
+optimizePartition(StringRef BC, bool DiscardValueNames,
+                  function_ref<void(Module &)> OptimizePartition) {
+  LLVMContext Ctx;
+  Ctx.setDiscardValueNames(DiscardValueNames);
+  std::unique_ptr<Module> MPart = readPartition(BC, Ctx);
+  OptimizePartition(*MPart);
+
+  SmallString<0> Result;
+  raw_svector_ostream ResultOS(Result);
+  WriteBitcodeToFile(*MPart, ResultOS);
+  return Result;
+}
+
+/// Create a global in \p M like \p Src of a partition module. Its initializer,
+/// aliasee or resolver, and metadata are still those of \p Src.
+static GlobalValue *createGlobal(Module &M, GlobalValue &Src,
+                                 ValueMapTypeRemapper &TypeMapper) {
+  Type *Ty = TypeMapper.remapType(Src.getValueType());
+  GlobalValue *GV;
+  if (auto *SrcVar = dyn_cast<GlobalVariable>(&Src)) {
+    auto *Var = new GlobalVariable(M, Ty, SrcVar->isConstant(),
+                                   Src.getLinkage(), nullptr, "", nullptr,
+                                   Src.getThreadLocalMode(),
+                                   Src.getAddressSpace());
+    Var->copyAttributesFrom(SrcVar);
+    GV = Var;
+  } else if (auto *SrcF = dyn_cast<Function>(&Src)) {
+    Function *F = Function::Create(cast<FunctionType>(Ty), Src.getLinkage(),
+                                   Src.getAddressSpace(), "", &M);
+    F->copyAttributesFrom(SrcF);
+    GV = F;
+  } else if (auto *SrcGA = dyn_cast<GlobalAlias>(&Src)) {
+    auto *GA = GlobalAlias::create(Ty, Src.getAddressSpace(), Src.getLinkage(),
+                                   "", nullptr, &M);
+    GA->copyAttributesFrom(SrcGA);
+    GV = GA;
+  } else {
+    auto *GI = GlobalIFunc::create(Ty, Src.getAddressSpace(), Src.getLinkage(),
+                                   "", nullptr, &M);
+    GI->copyAttributesFrom(cast<GlobalIFunc>(&Src));
+    GV = GI;
+  }
+
+  if (auto *GO = dyn_cast<GlobalObject>(GV)) {
+    auto &SrcGO = cast<GlobalObject>(Src);
+    if (const Comdat *SrcC = SrcGO.getComdat()) {
+      Comdat *C = M.getOrInsertComdat(SrcC->getName());
+      C->setSelectionKind(SrcC->getSelectionKind());
+      GO->setComdat(C);
+    } else {
+      GO->setComdat(nullptr);
+    }
+    GO->copyMetadata(&SrcGO, 0);
+  }
+
+  // A local that has the name of a new non-local is renamed instead.
+  GlobalValue *Conflict = M.getNamedValue(Src.getName());
+  if (Conflict && !Src.hasLocalLinkage()) {
+    assert(Conflict->hasLocalLinkage() && "should have been reused");
+    GV->takeName(Conflict);
+    Conflict->setName(Src.getName());
+  } else {
+    GV->setName(Src.getName());
+  }
+  return GV;
+}
+
+/// Replace the body of \p Dst with that of \p Src, which has already been
+/// remapped to \p Dst's module.
+static void replaceBody(Function &Dst, Function &Src) {
+  if (Dst.isDeclaration())
+    Dst.setLinkage(Src.getLinkage());
+  for (BasicBlock &BB : Dst)
+    BB.dropAllReferences();
+  while (!Dst.empty())
+    Dst.begin()->eraseFromParent();
+  Dst.splice(Dst.end(), &Src);
+
+  Dst.setAttributes(Src.getAttributes());
+  if (Src.hasPersonalityFn() || Dst.hasPersonalityFn())
+    Dst.setPersonalityFn(Src.hasPersonalityFn() ? Src.getPersonalityFn()
+                                                : nullptr);
+  Dst.clearMetadata();
+  Dst.copyMetadata(&Src, 0);
+}
+
+/// Move the optimized functions of the partition \p P, whose bitcode is in
+/// \p BC, and any globals the partition added, into \p M. \p OriginalGlobals
+/// maps the names of the globals of \p M before partitioning to the globals.
+static void mergePartition(Module &M, StringRef BC, const Partition &P,
+                           const StringMap<GlobalValue *> &OriginalGlobals) {
+  std::unique_ptr<Module> MPart = readPartition(BC, M.getContext());
+  MPart->setIsNewDbgInfoFormat(M.IsNewDbgInfoFormat);
+
+  SmallPtrSet<const Function *, 32> InPartition(P.Functions.begin(),
+                                                P.Functions.end());
+  ValueToValueMapTy VM;
+  PartitionTypeMapper TypeMapper;
+  SmallVector<std::pair<GlobalValue *, GlobalValue *>, 0> NewGlobals;
+  SmallVector<std::pair<GlobalVariable *, GlobalVariable *>, 0> Initializers;
+  SmallVector<std::pair<Function *, Function *>, 0> Bodies;
+  for (GlobalValue &Src : MPart->global_values()) {
+    GlobalValue *GV = OriginalGlobals.lookup(Src.getName());
+    // Non-local globals the partition added may have been added by an earlier
+    // partition too.
+    if (!GV && !Src.hasLocalLinkage())
+      if (GlobalValue *Existing = M.getNamedValue(Src.getName()))
+        if (!Existing->hasLocalLinkage())
+          GV = Existing;
+    if (!GV) {
+      GV = createGlobal(M, Src, TypeMapper);
+      NewGlobals.emplace_back(&Src, GV);
+    }
+    VM[&Src] = GV;
+
+    if (auto *SrcF = dyn_cast<Function>(&Src)) {
+      auto *F = dyn_cast<Function>(GV);
+      if (F && !SrcF->isDeclaration() &&
+          (InPartition.contains(F) || F->isDeclaration()) &&
+          TypeMapper.remapType(SrcF->getFunctionType()) ==
+              F->getFunctionType())
+        Bodies.emplace_back(SrcF, F);
+    } else if (auto *SrcVar = dyn_cast<GlobalVariable>(&Src)) {
+      auto *Var = dyn_cast<GlobalVariable>(GV);
+      if (Var && SrcVar->hasInitializer() && !Var->hasInitializer())
+        Initializers.emplace_back(SrcVar, Var);
+    }
+  }
+
+  if (NamedMDNode *Anchors = MPart->getNamedMetadata(AnchorsName)) {
+    assert(Anchors->getNumOperands() == P.Anchors.size() &&
+           "partition anchors changed");
+    for (auto [Src, N] : zip(Anchors->operands(), P.Anchors))
+      VM.MD()[Src].reset(N);
+  }
+
+  ValueMapper Mapper(VM, RF_IgnoreMissingLocals | RF_ReuseAndMutateDistinctMDs,
+                     &TypeMapper);
+  for (auto [Src, GV] : NewGlobals) {
+    if (auto *F = dyn_cast<Function>(GV))
+      Mapper.remapFunction(*F);
+    else if (auto *Var = dyn_cast<GlobalVariable>(GV))
+      Mapper.remapGlobalObjectMetadata(*Var);
+    else if (auto *GA = dyn_cast<GlobalAlias>(GV))
+      GA->setAliasee(Mapper.mapConstant(*cast<GlobalAlias>(Src)->getAliasee()));
+    else
+      cast<GlobalIFunc>(GV)->setResolver(
+          Mapper.mapConstant(*cast<GlobalIFunc>(Src)->getResolver()));
+  }
+  for (auto [SrcVar, Var] : Initializers) {
+    if (Var->isDeclaration())
+      Var->setLinkage(SrcVar->getLinkage());
+    Var->setInitializer(Mapper.mapConstant(*SrcVar->getInitializer()));
+  }
+  for (auto [SrcF, F] : Bodies) {
+    for (auto [SrcArg, Arg] : zip(SrcF->args(), F->args()))
+      VM[&SrcArg] = &Arg;
+    Mapper.remapFunction(*SrcF);
+    replaceBody(*F, *SrcF);
+  }
+}
+
+void llvm::optimizeFunctionsInParallel(
+    Module &M, unsigned NumPartitions,
+    function_ref<void(Module &)> OptimizePartition) {
+  SmallVector<Partition, 0> Partitions;
+  if (NumPartitions > 1 && canPartition(M))
+    Partitions = partitionFunctions(M, NumPartitions);
+  if (Partitions.size() < 2) {
+    OptimizePartition(M);
+    return;
+  }
+
+  StringMap<GlobalValue *> OriginalGlobals;
+  for (GlobalValue &GV : M.global_values())
+    OriginalGlobals[GV.getName()] = &GV;
+
+  // The partitions are copied on this thread, while nothing else uses M's
+  // context, and every thread reads its partition into a context of its own.
+  SmallVector<SmallString<0>, 0> Results(Partitions.size());
+  bool DiscardValueNames = M.getContext().shouldDiscardValueNames();
+  {
+    DefaultThreadPool Pool(heavyweight_hardware_concurrency(Partitions.size()));
+    for (auto [I, P] : enumerate(Partitions)) {
+      collectAnchors(P);
+      Pool.async([&, I = I, BC = writePartition(M, P)] {
+        Results[I] =
+            optimizePartition(BC, DiscardValueNames, OptimizePartition);
+      });
+    }
+    Pool.wait();
+  }
+
+  // Merge in a fixed order, so that the names of new globals do not depend on
+  // the order in which the threads finish.
+  for (auto [Result, P] : zip(Results, Partitions))
+    mergePartition(M, Result, P, OriginalGlobals);
+}
+
+void llvm::optimizeFunctionsWithCache(
+    Module &M, FunctionPipelineCache &Cache, unsigned NumThreads,
+    function_ref<void(Module &)> OptimizePartition) {
+  if (!canPartition(M)) {
+    OptimizePartition(M);
+    return;
+  }
+
+  SmallVector<Partition, 0> Partitions;
+  StringMap<GlobalValue *> OriginalGlobals;
+  for (GlobalValue &GV : M.global_values()) {
+    OriginalGlobals[GV.getName()] = &GV;
+    if (auto *F = dyn_cast<Function>(&GV); F && !F->isDeclaration())
+      Partitions.emplace_back().Functions.push_back(F);
+  }
+
+  cas::CASID PipelineID = cas::ObjectStore::computeID({}, Cache.PipelineKey);
+  SmallVector<SmallString<0>, 0> Results(Partitions.size());
+  SmallVector<std::pair<size_t, cas::CASID>, 0> Misses;
+  bool DiscardValueNames = M.getContext().shouldDiscardValueNames();
+  {
+    DefaultThreadPool Pool(heavyweight_hardware_concurrency(NumThreads));
+    for (auto [I, P] : enumerate(Partitions)) {
+      collectAnchors(P);
+      SmallString<0> BC = writePartition(M, P, /*ForCache=*/true);
+      cas::CASID Key = cas::ObjectStore::computeID({PipelineID}, BC);
+      // A result that cannot be loaded is computed again.
+      if (std::optional<cas::CASID> ResultID = Cache.Actions.get(Key)) {
+        Expected<std::optional<cas::ObjectHandle>> Result =
+            Cache.Objects.load(*ResultID);
+        if (Result && *Result) {
+          Results[I] = (*Result)->getData();
+          ++NumCacheHits;
+          continue;
+        }
+        consumeError(Result.takeError());
+      }
+      ++NumCacheMisses;
+      Misses.emplace_back(I, Key);
+      Pool.async([&, I = I, BC = std::move(BC)] {
+        Results[I] =
+            optimizePartition(BC, DiscardValueNames, OptimizePartition);
+      });
+    }
+    Pool.wait();
+  }
+
+  // Failing to cache a result only costs its reuse.
+  for (auto [I, Key] : Misses) {
+    Expected<cas::CASID> ResultID = Cache.Objects.store(Results[I]);
+    if (!ResultID) {
+      consumeError(ResultID.takeError());
+      continue;
+    }
+    consumeError(Cache.Actions.put(Key, *ResultID));
+  }
+
+  for (auto [Result, P] : zip(Results, Partitions))
+    mergePartition(M, Result, P, OriginalGlobals);
+}
+
+PreservedAnalyses
+ParallelFunctionOptimizerPass::run(Module &M, ModuleAnalysisManager &) {
+  if (Cache)
+    optimizeFunctionsWithCache(M, *Cache, NumPartitions, OptimizePartition);
+  else
+    optimizeFunctionsInParallel(M, NumPartitions, OptimizePartition);
+  return PreservedAnalyses::none();
+}
@@ -89,6 +89,7 @@
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/GlobPattern.h"
 #include "llvm/Support/MathExtras.h"
+#include "llvm/Support/TimeProfiler.h"
 #include "llvm/TargetParser/Triple.h"
 #include "llvm/Transforms/IPO.h"
 #include "llvm/Transforms/IPO/FunctionAttrs.h"
@@ -725,6 +726,11 @@ struct DevirtIndex {
 
   MapVector<VTableSlotSummary, VTableSlotInfo> CallSlots;
 
+  // The representative summary of each vtable that was looked up, or null if
+  // the vtable prevents devirtualization. A vtable is usually compatible with
+  // many type identifiers and is visited once per slot of each of them.
+  DenseMap<ValueInfo, const GlobalVarSummary *> VTableSummaries;
+
   PatternList FunctionsToSkip;
 
   DevirtIndex(
@@ -736,6 +742,8 @@ struct DevirtIndex {
     FunctionsToSkip.init(SkipFunctionNames);
   }
 
+  const GlobalVarSummary *findVTableSummary(ValueInfo VTableVI);
+
   bool tryFindVirtualCallTargets(std::vector<ValueInfo> &TargetsForSlot,
                                  const TypeIdCompatibleVtableInfo TIdInfo,
                                  uint64_t ByteOffset);
@@ -1098,47 +1106,56 @@ bool DevirtModule::tryFindVirtualCallTargets(
   return !TargetsForSlot.empty();
 }
 
+const GlobalVarSummary *DevirtIndex::findVTableSummary(ValueInfo VTableVI) {
+  auto [It, Inserted] = VTableSummaries.try_emplace(VTableVI, nullptr);
+  if (!Inserted)
+    return It->second;
+
+  // Find a representative copy of the vtable initializer.
+  // We can have multiple available_externally, linkonce_odr and weak_odr
+  // vtable initializers. We can also have multiple external vtable
+  // initializers in the case of comdats, which we cannot check here.
+  // The linker should give an error in this case.
+  //
+  // Also, handle the case of same-named local Vtables with the same path
+  // and therefore the same GUID. This can happen if there isn't enough
+  // distinguishing path when compiling the source file. In that case we
+  // conservatively give up early.
+  const GlobalVarSummary *VS = nullptr;
+  bool LocalFound = false;
+  for (const auto &S : VTableVI.getSummaryList()) {
+    if (GlobalValue::isLocalLinkage(S->linkage())) {
+      if (LocalFound)
+        return nullptr;
+      LocalFound = true;
+    }
+    auto *CurVS = cast<GlobalVarSummary>(S->getBaseObject());
+    if (!CurVS->vTableFuncs().empty() ||
+        // Previously clang did not attach the necessary type metadata to
+        // available_externally vtables, in which case there would not
+        // be any vtable functions listed in the summary and we need
+        // to treat this case conservatively (in case the bitcode is old).
+        // However, we will also not have any vtable functions in the
+        // case of a pure virtual base class. In that case we do want
+        // to set VS to avoid treating it conservatively.
+        !GlobalValue::isAvailableExternallyLinkage(S->linkage())) {
+      VS = CurVS;
+      // We cannot perform whole program devirtualization analysis on a vtable
+      // with public LTO visibility.
+      if (VS->getVCallVisibility() == GlobalObject::VCallVisibilityPublic)
+        return nullptr;
+    }
+  }
+  // There will be no VS if all copies are available_externally having no
+  // type metadata. In that case we can't safely perform WPD.
+  return It->second = VS;
+}
+
 bool DevirtIndex::tryFindVirtualCallTargets(
     std::vector<ValueInfo> &TargetsForSlot,
     const TypeIdCompatibleVtableInfo TIdInfo, uint64_t ByteOffset) {
   for (const TypeIdOffsetVtableInfo &P : TIdInfo) {
-    // Find a representative copy of the vtable initializer.
-    // We can have multiple available_externally, linkonce_odr and weak_odr
-    // vtable initializers. We can also have multiple external vtable
-    // initializers in the case of comdats, which we cannot check here.
-    // The linker should give an error in this case.
-    //
-    // Also, handle the case of same-named local Vtables with the same path
-    // and therefore the same GUID. This can happen if there isn't enough
-    // distinguishing path when compiling the source file. In that case we
-    // conservatively return false early.
-    const GlobalVarSummary *VS = nullptr;
-    bool LocalFound = false;
-    for (const auto &S : P.VTableVI.getSummaryList()) {
-      if (GlobalValue::isLocalLinkage(S->linkage())) {
-        if (LocalFound)
-          return false;
-        LocalFound = true;
-      }
-      auto *CurVS = cast<GlobalVarSummary>(S->getBaseObject());
-      if (!CurVS->vTableFuncs().empty() ||
-          // Previously clang did not attach the necessary type metadata to
-          // available_externally vtables, in which case there would not
-          // be any vtable functions listed in the summary and we need
-          // to treat this case conservatively (in case the bitcode is old).
-          // However, we will also not have any vtable functions in the
-          // case of a pure virtual base class. In that case we do want
-          // to set VS to avoid treating it conservatively.
-          !GlobalValue::isAvailableExternallyLinkage(S->linkage())) {
-        VS = CurVS;
-        // We cannot perform whole program devirtualization analysis on a vtable
-        // with public LTO visibility.
-        if (VS->getVCallVisibility() == GlobalObject::VCallVisibilityPublic)
-          return false;
-      }
-    }
-    // There will be no VS if all copies are available_externally having no
-    // type metadata. In that case we can't safely perform WPD.
+    const GlobalVarSummary *VS = findVTableSummary(P.VTableVI);
     if (!VS)
       return false;
     if (!VS->isLive())
@@ -2441,6 +2458,7 @@ void DevirtIndex::run() {
   if (ExportSummary.typeIdCompatibleVtableMap().empty())
     return;
 
+  TimeTraceScope TimeScope("Whole program devirtualization on index");
   DenseMap<GlobalValue::GUID, std::vector<StringRef>> NameByGUID;
   for (const auto &P : ExportSummary.typeIdCompatibleVtableMap()) {
     NameByGUID[GlobalValue::getGUID(P.first)].push_back(P.first);
@@ -2454,6 +2472,13 @@ void DevirtIndex::run() {
   }
 
   // Collect information from summary about which calls to try to devirtualize.
+  // Only the GUIDs of type identifiers with compatible vtables are of interest.
+  auto NamesFor = [&](GlobalValue::GUID GUID) -> ArrayRef<StringRef> {
+    auto I = NameByGUID.find(GUID);
+    if (I == NameByGUID.end())
+      return {};
+    return I->second;
+  };
   for (auto &P : ExportSummary) {
     for (auto &S : P.second.SummaryList) {
       auto *FS = dyn_cast<FunctionSummary>(S.get());
@@ -2461,18 +2486,18 @@ void DevirtIndex::run() {
         continue;
       // FIXME: Only add live functions.
       for (FunctionSummary::VFuncId VF : FS->type_test_assume_vcalls()) {
-        for (StringRef Name : NameByGUID[VF.GUID]) {
+        for (StringRef Name : NamesFor(VF.GUID)) {
           CallSlots[{Name, VF.Offset}].CSInfo.addSummaryTypeTestAssumeUser(FS);
         }
       }
       for (FunctionSummary::VFuncId VF : FS->type_checked_load_vcalls()) {
-        for (StringRef Name : NameByGUID[VF.GUID]) {
+        for (StringRef Name : NamesFor(VF.GUID)) {
           CallSlots[{Name, VF.Offset}].CSInfo.addSummaryTypeCheckedLoadUser(FS);
         }
       }
       for (const FunctionSummary::ConstVCall &VC :
            FS->type_test_assume_const_vcalls()) {
-        for (StringRef Name : NameByGUID[VC.VFunc.GUID]) {
+        for (StringRef Name : NamesFor(VC.VFunc.GUID)) {
           CallSlots[{Name, VC.VFunc.Offset}]
               .ConstCSInfo[VC.Args]
               .addSummaryTypeTestAssumeUser(FS);
@@ -2480,7 +2505,7 @@ void DevirtIndex::run() {
       }
       for (const FunctionSummary::ConstVCall &VC :
            FS->type_checked_load_const_vcalls()) {
-        for (StringRef Name : NameByGUID[VC.VFunc.GUID]) {
+        for (StringRef Name : NamesFor(VC.VFunc.GUID)) {
           CallSlots[{Name, VC.VFunc.Offset}]
               .ConstCSInfo[VC.Args]
               .addSummaryTypeCheckedLoadUser(FS);
@@ -2489,6 +2514,7 @@ void DevirtIndex::run() {
     }
   }
 
+  TimeTraceScope DevirtScope("Devirtualize virtual call slots");
   std::set<ValueInfo> DevirtTargets;
   // For each (type, offset) pair:
   for (auto &S : CallSlots) {
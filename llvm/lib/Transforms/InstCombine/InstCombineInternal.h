@@ -29,6 +29,7 @@
 #include "llvm/Transforms/InstCombine/InstCombiner.h"
 #include "llvm/Transforms/Utils/Local.h"
 #include <cassert>
+#include <chrono>
 
 #define DEBUG_TYPE "instcombine"
 #include "llvm/Transforms/Utils/InstructionWorklist.h"
@@ -56,6 +57,23 @@ class ProfileSummaryInfo;
 class TargetLibraryInfo;
 class User;
 
+/// What InstCombine did on a function, collected for the optimization remark
+/// that reports it.
+struct InstCombineRunStats {
+  struct VisitorStats {
+    unsigned Visits = 0;
+    unsigned Combined = 0;
+    std::chrono::steady_clock::duration Time{};
+  };
+
+  /// Whether to measure the time spent in every visitor.
+  bool TimeVisitors = false;
+  /// The number of instructions combined in every iteration.
+  SmallVector<unsigned, 4> CombinedPerIteration;
+  /// The work done by the visitor of every opcode.
+  SmallDenseMap<unsigned, VisitorStats, 16> Visitors;
+};
+
 class LLVM_LIBRARY_VISIBILITY InstCombinerImpl final
     : public InstCombiner,
       public InstVisitor<InstCombinerImpl, Instruction *> {
@@ -80,6 +98,9 @@ public:
   /// \returns true if the IR is changed.
   bool run();
 
+  /// If set, run() records its work here.
+  InstCombineRunStats *RunStats = nullptr;
+
   // Visitation implementation - Implement instruction combining for different
   // instruction types.  The semantics are as follows:
   // Return Value:
@@ -91,6 +91,7 @@
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/DebugCounter.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/HotPathTrace.h"
 #include "llvm/Support/KnownBits.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Transforms/InstCombine/InstCombine.h"
@@ -118,6 +119,8 @@ STATISTIC(NumTwoIterations, "Number of functions with two iterations");
 STATISTIC(NumThreeIterations, "Number of functions with three iterations");
 STATISTIC(NumFourOrMoreIterations,
           "Number of functions with four or more iterations");
+STATISTIC(NumSkippedUnchanged,
+          "Number of functions skipped as unchanged since their fixpoint");
 
 STATISTIC(NumCombined , "Number of insts combined");
 STATISTIC(NumConstProp, "Number of constant folds");
@@ -151,6 +154,16 @@ MaxArraySize("instcombine-maxarray-size", cl::init(1024),
 static cl::opt<unsigned> ShouldLowerDbgDeclare("instcombine-lower-dbg-declare",
                                                cl::Hidden, cl::init(true));
 
+static cl::opt<bool> SkipUnchangedFunctions(
+    "instcombine-skip-unchanged", cl::Hidden, cl::init(false),
+    cl::desc("Skip functions that InstCombine left at a fixpoint and that "
+             "have not changed since, as detected by their structural hash"));
+
+static cl::opt<bool> TimeVisitors(
+    "instcombine-time-visitors", cl::Hidden, cl::init(false),
+    cl::desc("Report the time spent in every visitor in the instcombine "
+             "analysis remarks"));
+
 std::optional<Instruction *>
 InstCombiner::targetInstCombineIntrinsic(IntrinsicInst &II) {
   // Handle target specific intrinsics
@@ -5163,7 +5176,23 @@ bool InstCombinerImpl::run() {
     LLVM_DEBUG(raw_string_ostream SS(OrigI); I->print(SS););
     LLVM_DEBUG(dbgs() << "IC: Visiting: " << OrigI << '\n');
 
-    if (Instruction *Result = visit(*I)) {
+    LLVM_HOT_PATH_TRACE_SCOPE("InstCombineVisit", I->getOpcode());
+    unsigned Opcode = I->getOpcode();
+    std::chrono::steady_clock::time_point VisitStart;
+    if (LLVM_UNLIKELY(RunStats && RunStats->TimeVisitors))
+      VisitStart = std::chrono::steady_clock::now();
+    Instruction *Result = visit(*I);
+    if (LLVM_UNLIKELY(RunStats)) {
+      auto &VS = RunStats->Visitors[Opcode];
+      ++VS.Visits;
+      if (RunStats->TimeVisitors)
+        VS.Time += std::chrono::steady_clock::now() - VisitStart;
+      if (Result) {
+        ++VS.Combined;
+        ++RunStats->CombinedPerIteration.back();
+      }
+    }
+    if (Result) {
       ++NumCombined;
       // Should we replace the old instruction with a new one?
       if (Result != I) {
@@ -5432,12 +5461,63 @@ void InstCombiner::computeBackEdges() {
   ComputedBackEdges = true;
 }
 
+/// Report the iterations InstCombine needed on \p F, the instructions it
+/// combined in each of them, and the work done by every visitor.
+static void emitRunRemarks(Function &F, OptimizationRemarkEmitter &ORE,
+                           const InstCombineRunStats &Stats,
+                           bool ReachedFixpoint) {
+  ORE.emit([&]() {
+    OptimizationRemarkAnalysis R(DEBUG_TYPE, "Iterations", &F);
+    R << "ran "
+      << ore::NV("Iterations", unsigned(Stats.CombinedPerIteration.size()))
+      << " iterations"
+      << (ReachedFixpoint ? " to a fixpoint" : " without reaching a fixpoint")
+      << "; instructions combined per iteration:";
+    for (unsigned Combined : Stats.CombinedPerIteration)
+      R << " " << ore::NV("Combined", Combined);
+    return R;
+  });
+
+  if (Stats.Visitors.empty())
+    return;
+  ORE.emit([&]() {
+    using VisitorEntry =
+        std::pair<unsigned, InstCombineRunStats::VisitorStats>;
+    SmallVector<VisitorEntry, 16> Visitors(Stats.Visitors.begin(),
+                                           Stats.Visitors.end());
+    // Most expensive first. Without timing, that is the most visited.
+    llvm::sort(Visitors, [](const VisitorEntry &L, const VisitorEntry &R) {
+      return std::make_tuple(L.second.Time, L.second.Visits, R.first) >
+             std::make_tuple(R.second.Time, R.second.Visits, L.first);
+    });
+
+    OptimizationRemarkAnalysis R(DEBUG_TYPE, "Visitors", &F);
+    R << "visitors:";
+    for (const auto &[Opcode, VS] : Visitors) {
+      R << " " << ore::NV("Opcode", Instruction::getOpcodeName(Opcode)) << " ("
+        << ore::NV("Visits", VS.Visits) << " visits, "
+        << ore::NV("Combined", VS.Combined) << " combined";
+      if (Stats.TimeVisitors)
+        R << ", "
+          << ore::NV("Microseconds",
+                     uint64_t(std::chrono::duration_cast<
+                                  std::chrono::microseconds>(VS.Time)
+                                  .count()))
+          << "us";
+      R << ")";
+    }
+    return R;
+  });
+}
+
+/// \returns true if the IR is changed. \p ReachedFixpoint is set to whether
+/// the last iteration made no change.
 static bool combineInstructionsOverFunction(
     Function &F, InstructionWorklist &Worklist, AliasAnalysis *AA,
     AssumptionCache &AC, TargetLibraryInfo &TLI, TargetTransformInfo &TTI,
     DominatorTree &DT, OptimizationRemarkEmitter &ORE, BlockFrequencyInfo *BFI,
     BranchProbabilityInfo *BPI, ProfileSummaryInfo *PSI,
-    const InstCombineOptions &Opts) {
+    const InstCombineOptions &Opts, bool &ReachedFixpoint) {
   auto &DL = F.getDataLayout();
 
   /// Builder - This is an IRBuilder that automatically inserts new
@@ -5458,7 +5538,13 @@ static bool combineInstructionsOverFunction(
   if (ShouldLowerDbgDeclare)
     MadeIRChange = LowerDbgDeclare(F);
 
+  // Collecting the statistics for the remarks costs a hash lookup per visit.
+  InstCombineRunStats Stats;
+  bool CollectStats = ORE.allowExtraAnalysis(DEBUG_TYPE);
+  Stats.TimeVisitors = TimeVisitors;
+
   // Iterate while there is work to do.
+  ReachedFixpoint = false;
   unsigned Iteration = 0;
   while (true) {
     ++Iteration;
@@ -5477,10 +5563,16 @@ static bool combineInstructionsOverFunction(
     InstCombinerImpl IC(Worklist, Builder, F.hasMinSize(), AA, AC, TLI, TTI, DT,
                         ORE, BFI, BPI, PSI, DL, RPOT);
     IC.MaxArraySizeForCombine = MaxArraySize;
+    if (CollectStats) {
+      IC.RunStats = &Stats;
+      Stats.CombinedPerIteration.push_back(0);
+    }
     bool MadeChangeInThisIteration = IC.prepareWorklist(F);
     MadeChangeInThisIteration |= IC.run();
-    if (!MadeChangeInThisIteration)
+    if (!MadeChangeInThisIteration) {
+      ReachedFixpoint = true;
       break;
+    }
 
     MadeIRChange = true;
     if (Iteration > Opts.MaxIterations) {
@@ -5501,9 +5593,14 @@ static bool combineInstructionsOverFunction(
   else
     ++NumFourOrMoreIterations;
 
+  if (CollectStats)
+    emitRunRemarks(F, ORE, Stats, ReachedFixpoint);
+
   return MadeIRChange;
 }
 
+AnalysisKey InstCombineFixpointAnalysis::Key;
+
 InstCombinePass::InstCombinePass(InstCombineOptions Opts) : Options(Opts) {}
 
 void InstCombinePass::printPipeline(
@@ -5518,6 +5615,19 @@ void InstCombinePass::printPipeline(
 
 PreservedAnalyses InstCombinePass::run(Function &F,
                                        FunctionAnalysisManager &AM) {
+  // A function left at a fixpoint by an earlier run has nothing to combine
+  // until it changes.
+  InstCombineFixpointAnalysis::Result *Fixpoint = nullptr;
+  std::optional<IRHash> Hash;
+  if (SkipUnchangedFunctions) {
+    Fixpoint = &AM.getResult<InstCombineFixpointAnalysis>(F);
+    Hash = StructuralHash(F, /*DetailedHash=*/true);
+    if (Fixpoint->FixpointHash == Hash) {
+      ++NumSkippedUnchanged;
+      return PreservedAnalyses::all();
+    }
+  }
+
   auto &AC = AM.getResult<AssumptionAnalysis>(F);
   auto &DT = AM.getResult<DominatorTreeAnalysis>(F);
   auto &TLI = AM.getResult<TargetLibraryAnalysis>(F);
@@ -5532,8 +5642,17 @@ PreservedAnalyses InstCombinePass::run(Function &F,
       &AM.getResult<BlockFrequencyAnalysis>(F) : nullptr;
   auto *BPI = AM.getCachedResult<BranchProbabilityAnalysis>(F);
 
-  if (!combineInstructionsOverFunction(F, Worklist, AA, AC, TLI, TTI, DT, ORE,
-                                       BFI, BPI, PSI, Options))
+  bool ReachedFixpoint;
+  bool Changed = combineInstructionsOverFunction(
+      F, Worklist, AA, AC, TLI, TTI, DT, ORE, BFI, BPI, PSI, Options,
+      ReachedFixpoint);
+  if (Fixpoint) {
+    if (Changed && ReachedFixpoint)
+      Hash = StructuralHash(F, /*DetailedHash=*/true);
+    Fixpoint->FixpointHash = ReachedFixpoint ? Hash : std::nullopt;
+  }
+
+  if (!Changed)
     // No changes, all analyses are preserved.
     return PreservedAnalyses::all();
 
@@ -5583,8 +5702,10 @@ bool InstructionCombiningPass::runOnFunction(Function &F) {
           getAnalysisIfAvailable<BranchProbabilityInfoWrapperPass>())
     BPI = &WrapperPass->getBPI();
 
+  bool ReachedFixpoint;
   return combineInstructionsOverFunction(F, Worklist, AA, AC, TLI, TTI, DT, ORE,
-                                         BFI, BPI, PSI, InstCombineOptions());
+                                         BFI, BPI, PSI, InstCombineOptions(),
+                                         ReachedFixpoint);
 }
 
 char InstructionCombiningPass::ID = 0;
@@ -199,6 +199,15 @@ static cl::opt<unsigned> SampledInstrBurstDuration(
              "'sampled-instr-period' to a prime number."),
     cl::init(200));
 
+static cl::opt<unsigned> CounterShards(
+    "instrprof-counter-shards",
+    cl::desc("Give the counters of each function this many copies, a power of "
+             "two, and have each thread update the copy picked by a hash of "
+             "its identity. This avoids cache line contention between threads "
+             "on hot counters. The runtime adds the copies up before writing "
+             "a profile. Only supported on ELF targets."),
+    cl::init(0));
+
 using LoadStorePair = std::pair<Instruction *, Instruction *>;
 
 static uint64_t getIntModuleFlagOrZero(const Module &M, StringRef Flag) {
@@ -258,6 +267,13 @@ private:
   /// If runtime relocation is enabled, this maps functions to the load
   /// instruction that produces the profile relocation bias.
   DenseMap<const Function *, LoadInst *> FunctionToProfileBiasMap;
+  /// If counters are sharded, this maps functions to the index of the shard
+  /// that the running thread updates, and the counters updated by functions
+  /// to the start of that shard.
+  DenseMap<const Function *, Instruction *> FunctionToShardIndexMap;
+  DenseMap<std::pair<const Function *, GlobalVariable *>, Instruction *>
+      FunctionToShardBaseMap;
+  GlobalVariable *ShardAnchor = nullptr;
   std::vector<GlobalValue *> CompilerUsedVars;
   std::vector<GlobalValue *> UsedVars;
   std::vector<GlobalVariable *> ReferencedNames;
@@ -285,6 +301,9 @@ private:
   /// Returns true if profile counter update register promotion is enabled.
   bool isCounterPromotionEnabled() const;
 
+  /// Returns true if counters are sharded between threads.
+  bool isCounterShardingEnabled() const;
+
   /// Return true if profile sampling is enabled.
   bool isSamplingEnabled() const;
 
@@ -319,6 +338,12 @@ private:
   /// acts on.
   Value *getCounterAddress(InstrProfCntrInstBase *I);
 
+  /// Compute the address of the counter value that this profiling instruction
+  /// acts on in the shard of the running thread. The address is computed in
+  /// the entry block, so that it dominates all uses of promoted counters.
+  Value *getShardedCounterAddress(InstrProfCntrInstBase *I,
+                                  GlobalVariable *Counters);
+
   /// Lower the incremental instructions under profile sampling predicates.
   void doSampling(Instruction *I);
 
@@ -843,6 +868,17 @@ bool InstrLowerer::isRuntimeCounterRelocationEnabled() const {
   return TT.isOSFuchsia();
 }
 
+bool InstrLowerer::isCounterShardingEnabled() const {
+  // The runtime finds the number of shards through a weak reference, and the
+  // thread's shard through initial-exec TLS.
+  if (!TT.isOSBinFormatELF() || CounterShards <= 1)
+    return false;
+  // Correlated profiles and the continuous mode expect counters to be laid
+  // out exactly as in the profile.
+  return !isRuntimeCounterRelocationEnabled() && !DebugInfoCorrelate &&
+         ProfileCorrelate == InstrProfCorrelator::NONE;
+}
+
 bool InstrLowerer::isSamplingEnabled() const {
   if (SampledInstr.getNumOccurrences() > 0)
     return SampledInstr;
@@ -922,6 +958,9 @@ bool InstrLowerer::lower() {
   if (!IsCS && isSamplingEnabled())
     createProfileSamplingVar(M);
 
+  if (isCounterShardingEnabled() && !isPowerOf2_32(CounterShards))
+    report_fatal_error("instrprof-counter-shards must be a power of two");
+
   bool ContainsProfiling = containsProfilingIntrinsics(M);
   GlobalVariable *CoverageNamesVar =
       M.getNamedGlobal(getCoverageUnusedNamesVarName());
@@ -1104,6 +1143,10 @@ Value *InstrLowerer::getCounterAddress(InstrProfCntrInstBase *I) {
   if (isa<InstrProfTimestampInst>(I))
     Counters->setAlignment(Align(8));
 
+  // Timestamps are written by the runtime, which only knows the first shard.
+  if (isCounterShardingEnabled() && isa<InstrProfIncrementInst>(I))
+    return getShardedCounterAddress(I, Counters);
+
   auto *Addr = Builder.CreateConstInBoundsGEP2_32(
       Counters->getValueType(), Counters, 0, I->getIndex()->getZExtValue());
 
@@ -1125,6 +1168,48 @@ Value *InstrLowerer::getCounterAddress(InstrProfCntrInstBase *I) {
   return Builder.CreateIntToPtr(Add, Addr->getType());
 }
 
+Value *InstrLowerer::getShardedCounterAddress(InstrProfCntrInstBase *I,
+                                              GlobalVariable *Counters) {
+  Type *Int64Ty = Type::getInt64Ty(M.getContext());
+  Function *Fn = I->getFunction();
+  Instruction *&ShardBase = FunctionToShardBaseMap[{Fn, Counters}];
+  if (!ShardBase) {
+    Instruction *&ShardIndex = FunctionToShardIndexMap[Fn];
+    if (!ShardIndex) {
+      // Each thread has its own copy of a TLS variable, so a hash of its
+      // address tells threads apart without any runtime registration.
+      // Threads' TLS blocks are usually a stack size apart, so take the top
+      // bits of a multiplicative hash rather than the low bits.
+      if (!ShardAnchor)
+        ShardAnchor = new GlobalVariable(
+            M, Type::getInt8Ty(M.getContext()), false,
+            GlobalValue::InternalLinkage,
+            Constant::getNullValue(Type::getInt8Ty(M.getContext())),
+            "__profc_shard_anchor", nullptr,
+            GlobalVariable::InitialExecTLSModel);
+      IRBuilder<> EntryBuilder(&Fn->getEntryBlock().front());
+      auto *AnchorAddr = EntryBuilder.CreatePtrToInt(
+          EntryBuilder.CreateThreadLocalAddress(ShardAnchor), Int64Ty);
+      auto *Hash = EntryBuilder.CreateMul(
+          AnchorAddr, ConstantInt::get(Int64Ty, 0x9E3779B97F4A7C15ULL));
+      ShardIndex = cast<Instruction>(EntryBuilder.CreateLShr(
+          Hash, 64 - Log2_32(CounterShards), "profc_shard"));
+    }
+    uint64_t NumCounters = I->getNumCounters()->getZExtValue();
+    uint64_t ShardSize =
+        alignTo(NumCounters, INSTR_PROF_COUNTER_SHARD_ALIGNMENT);
+    IRBuilder<> ShardBuilder(ShardIndex->getNextNode());
+    ShardBase = cast<Instruction>(ShardBuilder.CreateInBoundsGEP(
+        Int64Ty, Counters, ShardBuilder.CreateMul(ShardIndex,
+                                                  ShardBuilder.getInt64(
+                                                      ShardSize))));
+  }
+
+  IRBuilder<> Builder(ShardBase->getNextNode());
+  return Builder.CreateConstInBoundsGEP1_64(Int64Ty, ShardBase,
+                                            I->getIndex()->getZExtValue());
+}
+
 Value *InstrLowerer::getBitmapAddress(InstrProfMCDCTVBitmapUpdate *I) {
   auto *Bitmaps = getOrCreateRegionBitmaps(I);
   if (!isRuntimeCounterRelocationEnabled())
@@ -1653,6 +1738,16 @@ InstrLowerer::createRegionCounters(InstrProfCntrInstBase *Inc, StringRef Name,
                             ConstantArray::get(CounterArrTy, InitialValues),
                             Name);
     GV->setAlignment(Align(1));
+  } else if (isCounterShardingEnabled()) {
+    // Give each shard whole cache lines. The profile data only describes the
+    // first shard, which the runtime adds the others to before writing.
+    uint64_t ShardSize =
+        alignTo(NumCounters, INSTR_PROF_COUNTER_SHARD_ALIGNMENT);
+    auto *CounterTy =
+        ArrayType::get(Type::getInt64Ty(Ctx), ShardSize * CounterShards);
+    GV = new GlobalVariable(M, CounterTy, false, Linkage,
+                            Constant::getNullValue(CounterTy), Name);
+    GV->setAlignment(Align(8 * INSTR_PROF_COUNTER_SHARD_ALIGNMENT));
   } else {
     auto *CounterTy = ArrayType::get(Type::getInt64Ty(Ctx), NumCounters);
     GV = new GlobalVariable(M, CounterTy, false, Linkage,
@@ -1862,6 +1957,27 @@ void InstrLowerer::createDataVariable(InstrProfCntrInstBase *Inc) {
 
   // Mark the data variable as used so that it isn't stripped out.
   CompilerUsedVars.push_back(Data);
+
+  // Tell the runtime how many shards the counters of this function have. The
+  // record shares the comdat of the data variable, so that whichever copy of
+  // the data the linker keeps, the record kept with it describes its counters.
+  if (isCounterShardingEnabled() && !isa<InstrProfCoverInst>(Inc)) {
+    Type *ShardsTypes[] = {IntPtrTy, IntPtrTy};
+    auto *ShardsTy = StructType::get(Ctx, ShardsTypes);
+    auto *Shards = new GlobalVariable(
+        M, ShardsTy, true, GlobalValue::PrivateLinkage, nullptr,
+        getVarName(Inc, getInstrProfCounterShardsVarPrefix(), Renamed));
+    Constant *ShardsVals[] = {
+        ConstantExpr::getSub(ConstantExpr::getPtrToInt(Data, IntPtrTy),
+                             ConstantExpr::getPtrToInt(Shards, IntPtrTy)),
+        ConstantInt::get(IntPtrTy, CounterShards)};
+    Shards->setInitializer(ConstantStruct::get(ShardsTy, ShardsVals));
+    Shards->setSection(getInstrProfCounterShardsSectionName());
+    Shards->setAlignment(M.getDataLayout().getABITypeAlign(IntPtrTy));
+    maybeSetComdat(Shards, Fn, CntsVarName);
+    CompilerUsedVars.push_back(Shards);
+  }
+
   // Now that the linkage set by the FE has been passed to the data and counter
   // variables, reset Name variable's linkage and visibility to private so that
   // it can be removed later by the compiler.
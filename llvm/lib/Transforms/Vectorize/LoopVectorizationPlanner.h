@@ -27,6 +27,7 @@
 #include "VPlan.h"
 #include "llvm/ADT/SmallSet.h"
 #include "llvm/Support/InstructionCost.h"
+#include <chrono>
 
 namespace llvm {
 
@@ -380,6 +381,9 @@ class LoopVectorizationPlanner {
   /// Profitable vector factors.
   SmallVector<VectorizationFactor, 8> ProfitableVFs;
 
+  /// The time plan() took to build the VPlans, reported by computeBestVF().
+  std::chrono::microseconds PlanTime{};
+
   /// A builder used to construct the current plan.
   VPBuilder Builder;
 
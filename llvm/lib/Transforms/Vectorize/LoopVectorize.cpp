@@ -70,6 +70,7 @@
 #include "llvm/ADT/Hashing.h"
 #include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/ScopeExit.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/Statistic.h"
@@ -143,6 +144,7 @@
 #include "llvm/Transforms/Vectorize/LoopVectorizationLegality.h"
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cstdint>
 #include <functional>
 #include <iterator>
@@ -173,11 +175,20 @@ const char LLVMLoopVectorizeFollowupEpilogue[] =
 STATISTIC(LoopsVectorized, "Number of loops vectorized");
 STATISTIC(LoopsAnalyzed, "Number of loops analyzed for vectorization");
 STATISTIC(LoopsEpilogueVectorized, "Number of epilogues vectorized");
+STATISTIC(NumInstructionCostHits,
+          "Number of instruction costs reused by the cost model");
+STATISTIC(NumPrunedVFs, "Number of vectorization factors not costed");
 
 static cl::opt<bool> EnableEpilogueVectorization(
     "enable-epilogue-vectorization", cl::init(true), cl::Hidden,
     cl::desc("Enable vectorization of epilogue loops."));
 
+static cl::opt<unsigned> VFPruneThreshold(
+    "vectorizer-vf-prune-threshold", cl::init(0), cl::Hidden,
+    cl::desc("Stop computing the cost of wider fixed or scalable "
+             "vectorization factors after this many of them in a row were not "
+             "more profitable than the best one so far (0 means never)."));
+
 static cl::opt<unsigned> EpilogueVectorizationForceVF(
     "epilogue-vectorization-force-VF", cl::init(1), cl::Hidden,
     cl::desc("When epilogue vectorization is enabled, and a value greater than "
@@ -1496,8 +1507,15 @@ public:
     CallWideningDecisions.clear();
     Uniforms.clear();
     Scalars.clear();
+    InstructionCosts.clear();
+    CacheInstructionCosts = false;
   }
 
+  /// Remember the costs getInstructionCost() returns from now on. Must only
+  /// be called once all decisions for the candidate VFs have been taken, as
+  /// the costs depend on them.
+  void cacheInstructionCosts() { CacheInstructionCosts = true; }
+
   /// Returns the expected execution cost. The unit of the cost does
   /// not matter because we use the 'cost' units to compare different
   /// vector widths. The cost that is returned is *not* normalized by
@@ -1619,6 +1637,17 @@ private:
   /// vectorization factor. The entries are VF-ScalarCostTy pairs.
   DenseMap<ElementCount, ScalarCostsTy> InstsToScalarize;
 
+  /// The costs of instructions for a given VF returned by
+  /// getInstructionCost() since cacheInstructionCosts() was called. They are
+  /// shared by the legacy and VPlan-based cost models and all VFs the planner
+  /// considers.
+  DenseMap<std::pair<Instruction *, ElementCount>, InstructionCost>
+      InstructionCosts;
+  bool CacheInstructionCosts = false;
+
+  /// Computes the cost getInstructionCost() returns.
+  InstructionCost computeInstructionCost(Instruction *I, ElementCount VF);
+
   /// Holds the instructions known to be uniform after vectorization.
   /// The data is collected per VF.
   DenseMap<ElementCount, SmallPtrSet<Instruction *, 4>> Uniforms;
@@ -6335,6 +6364,22 @@ void LoopVectorizationCostModel::setVectorizedCallDecision(ElementCount VF) {
 InstructionCost
 LoopVectorizationCostModel::getInstructionCost(Instruction *I,
                                                ElementCount VF) {
+  if (!CacheInstructionCosts)
+    return computeInstructionCost(I, VF);
+  auto [It, Inserted] = InstructionCosts.try_emplace({I, VF});
+  if (!Inserted) {
+    ++NumInstructionCostHits;
+    return It->second;
+  }
+  // The computation may add entries, so do not keep the iterator around.
+  InstructionCost Cost = computeInstructionCost(I, VF);
+  InstructionCosts[{I, VF}] = Cost;
+  return Cost;
+}
+
+InstructionCost
+LoopVectorizationCostModel::computeInstructionCost(Instruction *I,
+                                                   ElementCount VF) {
   // If we know that this instruction will remain uniform, check the cost of
   // the scalar version.
   if (isUniformAfterVectorization(I, VF))
@@ -7025,6 +7070,11 @@ LoopVectorizationPlanner::planInVPlanNativePath(ElementCount UserVF) {
 
 void LoopVectorizationPlanner::plan(ElementCount UserVF, unsigned UserIC) {
   assert(OrigLoop->isInnermost() && "Inner loop expected.");
+  auto PlanStart = std::chrono::steady_clock::now();
+  auto RecordPlanTime = make_scope_exit([&] {
+    PlanTime = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - PlanStart);
+  });
   CM.collectValuesToIgnore();
   CM.collectElementTypesForWidening();
 
@@ -7064,6 +7114,7 @@ void LoopVectorizationPlanner::plan(ElementCount UserVF, unsigned UserIC) {
       CM.collectInLoopReductions();
       if (CM.selectUserVectorizationFactor(UserVF)) {
         LLVM_DEBUG(dbgs() << "LV: Using user VF " << UserVF << ".\n");
+        CM.cacheInstructionCosts();
         buildVPlansWithVPRecipes(UserVF, UserVF);
         LLVM_DEBUG(printPlans(dbgs()));
         return;
@@ -7092,6 +7143,7 @@ void LoopVectorizationPlanner::plan(ElementCount UserVF, unsigned UserIC) {
     if (VF.isVector())
       CM.collectInstsToScalarize(VF);
   }
+  CM.cacheInstructionCosts();
 
   buildVPlansWithVPRecipes(ElementCount::getFixed(1), MaxFactors.FixedVF);
   buildVPlansWithVPRecipes(ElementCount::getScalable(1), MaxFactors.ScalableVF);
@@ -7361,6 +7413,14 @@ VectorizationFactor LoopVectorizationPlanner::computeBestVF() {
     BestFactor.Cost = InstructionCost::getMax();
   }
 
+  // The number of fixed and scalable VFs in a row that were not more
+  // profitable than the best one so far. The VFs are visited from narrow to
+  // wide, and once the wider ones keep losing, the even wider ones are
+  // assumed to lose as well.
+  unsigned NumLosingVFs[2] = {0, 0};
+  unsigned NumCostedVFs = 0;
+  unsigned NumPrunedLoopVFs = 0;
+  auto SearchStart = std::chrono::steady_clock::now();
   for (auto &P : VPlans) {
     for (ElementCount VF : P->vectorFactors()) {
       if (VF.isScalar())
@@ -7372,11 +7432,23 @@ VectorizationFactor LoopVectorizationPlanner::computeBestVF() {
             << " because it will not generate any vector instructions.\n");
         continue;
       }
+      unsigned &NumLosing = NumLosingVFs[VF.isScalable()];
+      if (VFPruneThreshold && NumLosing >= VFPruneThreshold) {
+        LLVM_DEBUG(dbgs() << "LV: Not considering vector loop of width " << VF
+                          << " because narrower ones were not profitable.\n");
+        ++NumPrunedLoopVFs;
+        continue;
+      }
 
       InstructionCost Cost = cost(*P, VF);
+      ++NumCostedVFs;
       VectorizationFactor CurrentFactor(VF, Cost, ScalarCost);
-      if (isMoreProfitable(CurrentFactor, BestFactor))
+      if (isMoreProfitable(CurrentFactor, BestFactor)) {
         BestFactor = CurrentFactor;
+        NumLosing = 0;
+      } else {
+        ++NumLosing;
+      }
 
       // If profitable add it to ProfitableVF list.
       if (isMoreProfitable(CurrentFactor, ScalarFactor))
@@ -7384,12 +7456,30 @@ VectorizationFactor LoopVectorizationPlanner::computeBestVF() {
     }
   }
 
+  NumPrunedVFs += NumPrunedLoopVFs;
+  auto SearchTime = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - SearchStart);
+  ORE->emit([&]() {
+    using namespace ore;
+    return OptimizationRemarkAnalysis(LV_NAME, "VFSearchTime",
+                                      OrigLoop->getStartLoc(),
+                                      OrigLoop->getHeader())
+           << "built " << NV("NumVPlans", VPlans.size()) << " VPlans in "
+           << NV("PlanTimeUS", uint64_t(PlanTime.count()))
+           << " us and computed the costs of "
+           << NV("NumCostedVFs", NumCostedVFs) << " VFs in "
+           << NV("CostTimeUS", uint64_t(SearchTime.count())) << " us, "
+           << NV("NumPrunedVFs", NumPrunedLoopVFs) << " VFs pruned";
+  });
+
 #ifndef NDEBUG
   // Select the optimal vectorization factor according to the legacy cost-model.
   // This is now only used to verify the decisions by the new VPlan-based
   // cost-model and will be retired once the VPlan-based cost-model is
-  // stabilized.
-  VectorizationFactor LegacyVF = selectVectorizationFactor();
+  // stabilized. It is not comparable if VFs were pruned.
+  VectorizationFactor LegacyVF = NumPrunedLoopVFs
+                                     ? BestFactor
+                                     : selectVectorizationFactor();
   VPlan &BestPlan = getPlanFor(BestFactor.Width);
 
   // Pre-compute the cost and use it to check if BestPlan contains any
@@ -85,6 +85,7 @@
 #include "llvm/Support/InstructionCost.h"
 #include "llvm/Support/KnownBits.h"
 #include "llvm/Support/MathExtras.h"
+#include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Transforms/Utils/InjectTLIMappings.h"
 #include "llvm/Transforms/Utils/Local.h"
@@ -109,6 +110,11 @@ using namespace slpvectorizer;
 #define DEBUG_TYPE "SLP"
 
 STATISTIC(NumVectorInstructions, "Number of vector instructions generated");
+STATISTIC(NumTreesBuilt, "Number of vectorization trees built");
+STATISTIC(NumStoreChainsTried,
+          "Number of store chains tried as vectorization seeds");
+STATISTIC(NumScheduleRegionLimitHits,
+          "Number of times the scheduling region size limit was exceeded");
 
 DEBUG_COUNTER(VectorizedGraphs, "slp-vectorized",
               "Controls which SLP graphs should be vectorized.");
@@ -6441,6 +6447,7 @@ void BoUpSLP::buildTree(ArrayRef<Value *> Roots,
   UserIgnoreList = &UserIgnoreLst;
   if (!allSameType(Roots))
     return;
+  ++NumTreesBuilt;
   buildTree_rec(Roots, 0, EdgeInfo());
 }
 
@@ -6448,6 +6455,7 @@ void BoUpSLP::buildTree(ArrayRef<Value *> Roots) {
   deleteTree();
   if (!allSameType(Roots))
     return;
+  ++NumTreesBuilt;
   buildTree_rec(Roots, 0, EdgeInfo());
 }
 
@@ -16111,6 +16119,7 @@ bool BoUpSLP::BlockScheduling::extendSchedulingRegion(
          &*DownIter != I) {
     if (++ScheduleRegionSize > ScheduleRegionSizeLimit) {
       LLVM_DEBUG(dbgs() << "SLP:  exceeded schedule region size limit\n");
+      ++NumScheduleRegionLimitHits;
       return false;
     }
 
@@ -17360,6 +17369,12 @@ SLPVectorizerPass::vectorizeStoreChain(ArrayRef<Value *> Chain, BoUpSLP &R,
   }
   if (R.isLoadCombineCandidate(Chain))
     return true;
+  // Each seed gets its own entry in -ftime-trace output, to find the chains
+  // that dominate the compile time of huge blocks.
+  TimeTraceScope TimeScope("SLPVectorizeStoreChain", [&]() {
+    return (Twine(VF) + " stores at offset " + Twine(Idx)).str();
+  });
+  ++NumStoreChainsTried;
   R.buildTree(Chain);
   // Check if tree tiny and store itself or its value is not vectorized.
   if (R.isTreeTinyAndNotFullyVectorizable()) {
@@ -17933,6 +17948,9 @@ bool SLPVectorizerPass::tryToVectorizeList(ArrayRef<Value *> VL, BoUpSLP &R,
       LLVM_DEBUG(dbgs() << "SLP: Analyzing " << ActualVF << " operations "
                         << "\n");
 
+      TimeTraceScope TimeScope("SLPVectorizeList", [&]() {
+        return (Twine(ActualVF) + " operations").str();
+      });
       R.buildTree(Ops);
       if (R.isTreeTinyAndNotFullyVectorizable())
         continue;
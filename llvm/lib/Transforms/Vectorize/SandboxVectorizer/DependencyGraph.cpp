@@ -50,19 +50,23 @@ MemDGNodeIntervalBuilder::make(const Interval<Instruction> &Instrs,
                              cast<MemDGNode>(DAG.getNode(MemBotI)));
 }
 
-Interval<Instruction> DependencyGraph::extend(ArrayRef<Instruction *> Instrs) {
-  if (Instrs.empty())
-    return {};
+void DependencyGraph::createNewNodes(const Interval<Instruction> &NewSection) {
   // TODO: For now create a chain of dependencies.
-  Interval<Instruction> Interval(Instrs);
-  auto *TopI = Interval.top();
-  auto *BotI = Interval.bottom();
-  DGNode *LastN = getOrCreateNode(TopI);
-  MemDGNode *LastMemN = dyn_cast<MemDGNode>(LastN);
-  for (Instruction *I = TopI->getNextNode(), *E = BotI->getNextNode(); I != E;
-       I = I->getNextNode()) {
+  // Find the closest mem node above the new section, if any.
+  MemDGNode *LastMemN = nullptr;
+  for (Instruction *I = NewSection.top()->getPrevNode();
+       I != nullptr && DAGInterval.contains(I); I = I->getPrevNode())
+    if (auto *MemN = dyn_cast<MemDGNode>(getNode(I))) {
+      LastMemN = MemN;
+      break;
+    }
+  MemDGNode *PrevMemN = LastMemN;
+  for (Instruction *I = NewSection.top(),
+                   *E = NewSection.bottom()->getNextNode();
+       I != E; I = I->getNextNode()) {
     auto *N = getOrCreateNode(I);
-    N->addMemPred(LastMemN);
+    if (LastMemN != nullptr)
+      N->addMemPred(LastMemN);
     // Build the Mem node chain.
     if (auto *MemN = dyn_cast<MemDGNode>(N)) {
       MemN->setPrevNode(LastMemN);
@@ -70,9 +74,39 @@ Interval<Instruction> DependencyGraph::extend(ArrayRef<Instruction *> Instrs) {
         LastMemN->setNextNode(MemN);
       LastMemN = MemN;
     }
-    LastN = N;
   }
-  return Interval;
+  if (LastMemN == PrevMemN)
+    return;
+  // The existing nodes below the new section, down to and including the first
+  // mem node, now depend on its last mem node.
+  for (Instruction *I = NewSection.bottom()->getNextNode();
+       I != nullptr && DAGInterval.contains(I); I = I->getNextNode()) {
+    auto *N = getNode(I);
+    N->addMemPred(LastMemN);
+    if (auto *MemN = dyn_cast<MemDGNode>(N)) {
+      MemN->setPrevNode(LastMemN);
+      LastMemN->setNextNode(MemN);
+      break;
+    }
+  }
+}
+
+Interval<Instruction> DependencyGraph::extend(ArrayRef<Instruction *> Instrs) {
+  if (Instrs.empty())
+    return {};
+  Interval<Instruction> InstrsInterval(Instrs);
+  Interval<Instruction> NewInterval =
+      DAGInterval.getUnionInterval(InstrsInterval);
+  // Only the sections above and below the current DAG need new nodes. Each
+  // one gets connected to the DAG built so far.
+  for (const Interval<Instruction> &NewSection : NewInterval - DAGInterval) {
+    if (NewSection.empty())
+      continue;
+    createNewNodes(NewSection);
+    DAGInterval = DAGInterval.getUnionInterval(NewSection);
+  }
+  assert(DAGInterval == NewInterval && "Expected the DAG to span Instrs!");
+  return InstrsInterval;
 }
 
 #ifndef NDEBUG
@@ -248,7 +248,11 @@ getDWARFLinkerType(opt::InputArgList &Args) {
                                    inconvertibleErrorCode());
   }
 
+#ifdef DSYMUTIL_DEFAULT_PARALLEL_LINKER
+  return DsymutilDWARFLinkerType::Parallel;
+#else
   return DsymutilDWARFLinkerType::Classic;
+#endif
 }
 
 static Expected<ReproducerMode> getReproducerMode(opt::InputArgList &Args) {
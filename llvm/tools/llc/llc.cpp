@@ -50,6 +50,7 @@
 #include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/WithColor.h"
+#include "llvm/Support/raw_iovec_ostream.h"
 #include "llvm/Target/TargetLoweringObjectFile.h"
 #include "llvm/Target/TargetMachine.h"
 #include "llvm/TargetParser/Host.h"
@@ -684,6 +685,12 @@ static int compileModule(char **argv, LLVMContext &Context) {
       BOS = std::make_unique<raw_svector_ostream>(Buffer);
       OS = BOS.get();
     }
+    // Let the object writer pass section contents to the kernel directly.
+    std::unique_ptr<raw_iovec_ostream> IOS;
+    if (!BOS && codegen::getFileType() == CodeGenFileType::ObjectFile) {
+      IOS = std::make_unique<raw_iovec_ostream>(Out->os());
+      OS = IOS.get();
+    }
 
     const char *argv0 = argv[0];
     LLVMTargetMachine &LLVMTM = static_cast<LLVMTargetMachine &>(*Target);
@@ -41,6 +41,8 @@
 
 #include "CoverageExporterLcov.h"
 #include "CoverageReport.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 
 using namespace llvm;
 
@@ -198,11 +200,33 @@ void renderFile(raw_ostream &OS, const coverage::CoverageMapping &Coverage,
 void renderFiles(raw_ostream &OS, const coverage::CoverageMapping &Coverage,
                  ArrayRef<std::string> SourceFiles,
                  ArrayRef<FileCoverageSummary> FileReports,
-                 bool ExportSummaryOnly, bool SkipFunctions,
-                 bool SkipBranches) {
+                 const CoverageViewOptions &Options) {
+  ThreadPoolStrategy S = hardware_concurrency(Options.NumThreads);
+  if (Options.NumThreads == 0) {
+    // If NumThreads is not specified, create one thread for each input, up to
+    // the number of hardware cores.
+    S = heavyweight_hardware_concurrency(SourceFiles.size());
+    S.Limit = true;
+  }
+  DefaultThreadPool Pool(S);
+
+  // Render each file to a buffer of its own, and write the buffers out in
+  // order as soon as they are done rather than once all files are.
+  std::vector<std::string> Buffers(SourceFiles.size());
+  std::vector<std::shared_future<void>> Rendered;
   for (unsigned I = 0, E = SourceFiles.size(); I < E; ++I)
-    renderFile(OS, Coverage, SourceFiles[I], FileReports[I], ExportSummaryOnly,
-               SkipFunctions, SkipBranches);
+    Rendered.push_back(Pool.async([&, I] {
+      raw_string_ostream FileOS(Buffers[I]);
+      renderFile(FileOS, Coverage, SourceFiles[I], FileReports[I],
+                 Options.ExportSummaryOnly, Options.SkipFunctions,
+                 Options.SkipBranches);
+    }));
+
+  for (unsigned I = 0, E = SourceFiles.size(); I < E; ++I) {
+    Rendered[I].wait();
+    OS << Buffers[I];
+    Buffers[I] = std::string();
+  }
 }
 
 } // end anonymous namespace
@@ -220,6 +244,5 @@ void CoverageExporterLcov::renderRoot(ArrayRef<std::string> SourceFiles) {
   FileCoverageSummary Totals = FileCoverageSummary("Totals");
   auto FileReports = CoverageReport::prepareFileReports(Coverage, Totals,
                                                         SourceFiles, Options);
-  renderFiles(OS, Coverage, SourceFiles, FileReports, Options.ExportSummaryOnly,
-              Options.SkipFunctions, Options.SkipBranches);
+  renderFiles(OS, Coverage, SourceFiles, FileReports, Options);
 }
@@ -54,6 +54,17 @@ public:
     RunnableConfiguration &operator=(RunnableConfiguration &&) = delete;
     RunnableConfiguration &operator=(const RunnableConfiguration &) = delete;
 
+    // Returns the contents of the assembled object file, or an empty buffer
+    // if the benchmark phase stops before the snippet is assembled.
+    StringRef getObjectFileData() const {
+      const object::ObjectFile *Obj = ObjectFile.getBinary();
+      return Obj ? Obj->getData() : StringRef();
+    }
+
+    // Gives up the configuration without running it, e.g. to reuse the
+    // measurements of another configuration that assembled to the same code.
+    Benchmark takeBenchmarkResult() && { return std::move(BenchmarkResult); }
+
   private:
     RunnableConfiguration() = default;
 
@@ -79,6 +79,13 @@ public:
         : P(P_), Begin(P ? ProgressMeter<ClockType>::ClockType::now()
                          : TimePointType()) {}
 
+    // Accounts for a step that is known to have taken `Elapsed` time, for
+    // steps that are not measured on their own, e.g. because they ran
+    // concurrently with other steps.
+    inline ProgressMeterStep(ProgressMeter *P_, DurationType Elapsed)
+        : P(P_), Begin(P ? ProgressMeter<ClockType>::ClockType::now() - Elapsed
+                         : TimePointType()) {}
+
     inline ~ProgressMeterStep() {
       if (!P)
         return;
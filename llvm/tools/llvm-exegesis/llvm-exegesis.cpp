@@ -27,6 +27,7 @@
 #include "lib/TargetSelect.h"
 #include "lib/ValidationEvent.h"
 #include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/MC/MCInstBuilder.h"
 #include "llvm/MC/MCObjectFileInfo.h"
@@ -43,8 +44,11 @@
 #include "llvm/Support/Path.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/TargetParser/Host.h"
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <string>
 
 namespace llvm {
@@ -274,6 +278,14 @@ static cl::opt<int> BenchmarkProcessCPU(
     cl::desc("The CPU number that the benchmarking process should executon on"),
     cl::cat(BenchmarkOptions), cl::init(-1));
 
+static cl::list<int> BenchmarkProcessCPUs(
+    "benchmark-process-cpus",
+    cl::desc("A list of CPUs to benchmark on concurrently, one benchmarking "
+             "process per CPU at a time. Snippets that assemble to the same "
+             "code are only measured once. Requires the subprocess execution "
+             "mode"),
+    cl::CommaSeparated, cl::cat(BenchmarkOptions));
+
 static ExitOnError ExitOnErr("llvm-exegesis error: ");
 
 // Helper function that logs the error(s) and exits.
@@ -386,6 +398,174 @@ generateSnippets(const LLVMState &State, unsigned Opcode,
   return Benchmarks;
 }
 
+// Aggregates the results of all the repetitions of a configuration into the
+// first one, and writes it out.
+static void writeAggregatedResult(const LLVMState &State,
+                                  MutableArrayRef<Benchmark> AllResults,
+                                  raw_ostream &Ostr) {
+  Benchmark &Result = AllResults.front();
+
+  // If any of our measurements failed, pretend they all have failed.
+  if (AllResults.size() > 1 &&
+      any_of(AllResults, [](const Benchmark &R) {
+        return R.Measurements.empty();
+      }))
+    Result.Measurements.clear();
+
+  std::unique_ptr<ResultAggregator> ResultAgg =
+      ResultAggregator::CreateAggregator(RepetitionMode);
+  ResultAgg->AggregateResults(Result,
+                              ArrayRef<Benchmark>(AllResults).drop_front());
+
+  // With dummy counters, measurements are rather meaningless,
+  // so drop them altogether.
+  if (UseDummyPerfCounters)
+    Result.Measurements.clear();
+
+  ExitOnFileError(BenchmarkFile, Result.writeYamlTo(State, Ostr));
+}
+
+// Returns whether two snippets with the same object file also run in the same
+// context. The instructions, the register initial values and the loop register
+// are encoded in the object file, but the memory setup and the load address
+// are only applied when the snippet is executed.
+static bool haveSameExecutionContext(const BenchmarkKey &A,
+                                     const BenchmarkKey &B) {
+  auto SameAPInt = [](const APInt &X, const APInt &Y) {
+    return X.getBitWidth() == Y.getBitWidth() && X == Y;
+  };
+  if (A.Config != B.Config || A.SnippetAddress != B.SnippetAddress ||
+      A.LoopRegister != B.LoopRegister ||
+      A.RegisterInitialValues.size() != B.RegisterInitialValues.size() ||
+      A.MemoryMappings.size() != B.MemoryMappings.size() ||
+      A.MemoryValues.size() != B.MemoryValues.size())
+    return false;
+  for (const auto &[X, Y] :
+       zip_equal(A.RegisterInitialValues, B.RegisterInitialValues))
+    if (X.Register != Y.Register || !SameAPInt(X.Value, Y.Value))
+      return false;
+  for (const auto &[X, Y] : zip_equal(A.MemoryMappings, B.MemoryMappings))
+    if (X.Address != Y.Address || X.MemoryValueName != Y.MemoryValueName)
+      return false;
+  for (const auto &[Name, X] : A.MemoryValues) {
+    auto It = B.MemoryValues.find(Name);
+    if (It == B.MemoryValues.end())
+      return false;
+    const MemoryValue &Y = It->second;
+    if (X.SizeBytes != Y.SizeBytes || X.Index != Y.Index ||
+        !SameAPInt(X.Value, Y.Value))
+      return false;
+  }
+  return true;
+}
+
+// Runs the configurations on the CPUs of --benchmark-process-cpus. The
+// configurations are assembled in batches on the main thread, then one worker
+// per CPU runs the snippets of the batch in benchmarking processes pinned to
+// that CPU. Snippets of a batch that assemble to the same object file and run
+// in the same context are only measured once. Results are written in the order
+// of the configurations.
+static void runBenchmarkConfigurationsInParallel(
+    const LLVMState &State, ArrayRef<BenchmarkCode> Configurations,
+    ArrayRef<std::unique_ptr<const SnippetRepetitor>> Repetitors,
+    ArrayRef<unsigned> MinInstructionCounts, const BenchmarkRunner &Runner,
+    ProgressMeter<> *Meter, raw_ostream &Ostr) {
+  struct Job {
+    std::optional<BenchmarkRunner::RunnableConfiguration> RC;
+    // An earlier job of the same batch with identical code, if any.
+    std::optional<size_t> DuplicateOf;
+    std::optional<Benchmark> Result;
+    // Errors that are not caused by the snippet itself.
+    std::optional<std::string> FrameworkError;
+  };
+
+  const size_t RunsPerConfiguration =
+      Repetitors.size() * MinInstructionCounts.size();
+  // Give the workers a few configurations each per batch, so that a slow
+  // snippet does not leave the other CPUs idle for long.
+  const size_t ConfigurationsPerBatch = 4 * BenchmarkProcessCPUs.size();
+  DefaultThreadPool Pool(hardware_concurrency(BenchmarkProcessCPUs.size()));
+
+  for (size_t Begin = 0; Begin < Configurations.size();
+       Begin += ConfigurationsPerBatch) {
+    ArrayRef<BenchmarkCode> Batch = Configurations.slice(
+        Begin, std::min(ConfigurationsPerBatch, Configurations.size() - Begin));
+    const auto BatchBegin = std::chrono::steady_clock::now();
+
+    std::vector<Job> Jobs(Batch.size() * RunsPerConfiguration);
+    // The measured jobs of the batch, with the keys of their configurations.
+    StringMap<SmallVector<std::pair<size_t, const BenchmarkKey *>, 1>>
+        JobsByObjectFile;
+    size_t NumJobs = 0;
+    for (const BenchmarkCode &Conf : Batch) {
+      for (const std::unique_ptr<const SnippetRepetitor> &Repetitor :
+           Repetitors) {
+        for (unsigned IterationRepetitions : MinInstructionCounts) {
+          Job &J = Jobs[NumJobs];
+          J.RC.emplace(ExitOnErr(Runner.getRunnableConfiguration(
+              Conf, IterationRepetitions, LoopBodySize, *Repetitor)));
+          StringRef ObjectFile = J.RC->getObjectFileData();
+          if (!ObjectFile.empty()) {
+            auto &Measured = JobsByObjectFile[ObjectFile];
+            auto It = find_if(Measured, [&](const auto &Other) {
+              return haveSameExecutionContext(Conf.Key, *Other.second);
+            });
+            if (It != Measured.end())
+              J.DuplicateOf = It->first;
+            else
+              Measured.emplace_back(NumJobs, &Conf.Key);
+          }
+          ++NumJobs;
+        }
+      }
+    }
+
+    std::atomic<size_t> NextJob = 0;
+    for (int CPU : BenchmarkProcessCPUs) {
+      Pool.async([&, CPU] {
+        for (size_t I = NextJob++; I < Jobs.size(); I = NextJob++) {
+          Job &J = Jobs[I];
+          if (J.DuplicateOf)
+            continue;
+          auto [Err, BenchmarkResult] =
+              Runner.runConfiguration(std::move(*J.RC), std::nullopt, CPU);
+          if (Err) {
+            if (Err.isA<SnippetExecutionFailure>())
+              BenchmarkResult.Error = toString(std::move(Err));
+            else
+              J.FrameworkError = toString(std::move(Err));
+          }
+          J.Result.emplace(std::move(BenchmarkResult));
+        }
+      });
+    }
+    Pool.wait();
+
+    const auto BatchEnd = std::chrono::steady_clock::now();
+    for (Job &J : Jobs) {
+      if (J.FrameworkError)
+        ExitWithError(*J.FrameworkError);
+      if (J.DuplicateOf) {
+        const Benchmark &Measured = *Jobs[*J.DuplicateOf].Result;
+        Benchmark Result = std::move(*J.RC).takeBenchmarkResult();
+        Result.Measurements = Measured.Measurements;
+        Result.Error = Measured.Error;
+        J.Result.emplace(std::move(Result));
+      }
+    }
+
+    for (size_t C = 0; C != Batch.size(); ++C) {
+      ProgressMeter<>::ProgressMeterStep MeterStep(
+          Meter, (BatchEnd - BatchBegin) / Batch.size());
+      SmallVector<Benchmark, 2> AllResults;
+      for (size_t R = 0; R != RunsPerConfiguration; ++R)
+        AllResults.push_back(
+            std::move(*Jobs[C * RunsPerConfiguration + R].Result));
+      writeAggregatedResult(State, AllResults, Ostr);
+    }
+  }
+}
+
 static void runBenchmarkConfigurations(
     const LLVMState &State, ArrayRef<BenchmarkCode> Configurations,
     ArrayRef<std::unique_ptr<const SnippetRepetitor>> Repetitors,
@@ -411,6 +591,13 @@ static void runBenchmarkConfigurations(
       RepetitionMode == Benchmark::MiddleHalfLoop)
     MinInstructionCounts.push_back(MinInstructions * 2);
 
+  if (!BenchmarkProcessCPUs.empty()) {
+    runBenchmarkConfigurationsInParallel(State, Configurations, Repetitors,
+                                         MinInstructionCounts, Runner,
+                                         Meter ? &*Meter : nullptr, Ostr);
+    return;
+  }
+
   for (const BenchmarkCode &Conf : Configurations) {
     ProgressMeter<>::ProgressMeterStep MeterStep(Meter ? &*Meter : nullptr);
     SmallVector<Benchmark, 2> AllResults;
@@ -441,26 +628,7 @@ static void runBenchmarkConfigurations(
       }
     }
 
-    Benchmark &Result = AllResults.front();
-
-    // If any of our measurements failed, pretend they all have failed.
-    if (AllResults.size() > 1 &&
-        any_of(AllResults, [](const Benchmark &R) {
-          return R.Measurements.empty();
-        }))
-      Result.Measurements.clear();
-
-    std::unique_ptr<ResultAggregator> ResultAgg =
-        ResultAggregator::CreateAggregator(RepetitionMode);
-    ResultAgg->AggregateResults(Result,
-                                ArrayRef<Benchmark>(AllResults).drop_front());
-
-    // With dummy counters, measurements are rather meaningless,
-    // so drop them altogether.
-    if (UseDummyPerfCounters)
-      Result.Measurements.clear();
-
-    ExitOnFileError(BenchmarkFile, Result.writeYamlTo(State, Ostr));
+    writeAggregatedResult(State, AllResults, Ostr);
   }
 }
 
@@ -498,6 +666,18 @@ void benchmarkMain() {
     ExitWithError("Dummy perf counters are not supported in the subprocess "
                   "execution mode.");
 
+  if (!BenchmarkProcessCPUs.empty()) {
+    if (ExecutionMode != BenchmarkRunner::ExecutionModeE::SubProcess)
+      ExitWithError("--benchmark-process-cpus requires the subprocess "
+                    "execution mode.");
+    if (BenchmarkProcessCPU != -1)
+      ExitWithError("--benchmark-process-cpu and --benchmark-process-cpus "
+                    "are mutually exclusive.");
+    if (DumpObjectToDisk.getNumOccurrences())
+      ExitWithError("--dump-object-to-disk is not supported with "
+                    "--benchmark-process-cpus.");
+  }
+
   const std::unique_ptr<BenchmarkRunner> Runner =
       ExitOnErr(State.getExegesisTarget().createBenchmarkRunner(
           BenchmarkMode, State, BenchmarkPhaseSelector, ExecutionMode,
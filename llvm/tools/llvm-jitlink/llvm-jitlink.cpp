@@ -54,6 +54,7 @@
 #include "llvm/Object/ObjectFile.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/InitLLVM.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
@@ -258,7 +259,8 @@ static cl::opt<bool>
 
 static cl::opt<bool> UseSharedMemory(
     "use-shared-memory",
-    cl::desc("Use shared memory to transfer generated code and data"),
+    cl::desc("Use shared memory to transfer generated code and data (default "
+             "on for -oop-executor where supported)"),
     cl::init(false), cl::cat(JITLinkCategory));
 
 static cl::opt<std::string>
@@ -807,8 +809,16 @@ static Expected<std::unique_ptr<ExecutorProcessControl>> launchExecutor() {
   close(ToExecutor[ReadEnd]);
   close(FromExecutor[WriteEnd]);
 
+  // The forked executor runs on this host, so map its memory into this
+  // process by default rather than copying code and data through the pipe.
+  bool UseSharedMemoryForExecutor = UseSharedMemory;
+#if !defined(__ANDROID__)
+  if (!UseSharedMemory.getNumOccurrences())
+    UseSharedMemoryForExecutor = true;
+#endif
+
   auto S = SimpleRemoteEPC::Setup();
-  if (UseSharedMemory)
+  if (UseSharedMemoryForExecutor)
     S.CreateMemoryManager = createSharedMemoryManager;
 
   return SimpleRemoteEPC::Create<FDSimpleRemoteEPCTransport>(
@@ -2339,6 +2349,22 @@ struct JITLinkTimers {
   Timer LoadObjectsTimer{"load", "time to load/add object files", JITLinkTG};
   Timer LinkTimer{"link", "time to link object files", JITLinkTG};
   Timer RunTimer{"run", "time to execute jitlink'd code", JITLinkTG};
+
+  JITLinkTimers() { setLinkPhaseTimesEnabled(true); }
+
+  void print(raw_ostream &OS) {
+    JITLinkTG.printAll(OS);
+
+    // The JITLink phases may run on several threads, so report their time
+    // summed over all threads.
+    auto Times = getLinkPhaseTimes();
+    auto Seconds = [](std::chrono::nanoseconds D) {
+      return std::chrono::duration<double>(D).count();
+    };
+    OS << "JITLink phase times (summed over all threads):\n"
+       << format("  %10.4f  build link graphs\n", Seconds(Times.BuildGraph))
+       << format("  %10.4f  apply fixups\n", Seconds(Times.ApplyFixups));
+  }
 };
 } // namespace
 
@@ -2391,7 +2417,7 @@ int main(int argc, char *argv[]) {
 
   if (!EntryPoint) {
     if (Timers)
-      Timers->JITLinkTG.printAll(errs());
+      Timers->print(errs());
     reportLLVMJITLinkError(EntryPoint.takeError());
     exit(1);
   }
@@ -2415,7 +2441,7 @@ int main(int argc, char *argv[]) {
   S.reset();
 
   if (Timers)
-    Timers->JITLinkTG.printAll(errs());
+    Timers->print(errs());
 
   // If the executing code set a test result override then use that.
   if (UseTestResultOverride)
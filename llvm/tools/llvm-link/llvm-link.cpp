@@ -26,6 +26,7 @@
 #include "llvm/Linker/Linker.h"
 #include "llvm/Object/Archive.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Compression.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/InitLLVM.h"
 #include "llvm/Support/Path.h"
@@ -99,6 +100,14 @@ static cl::opt<bool> OutputAssembly("S",
                                     cl::desc("Write output as LLVM assembly"),
                                     cl::Hidden, cl::cat(LinkCategory));
 
+static cl::opt<DebugCompressionType> CompressBitcode(
+    "compress-bitcode", cl::init(DebugCompressionType::None),
+    cl::desc("Write the output as a compressed bitcode container"),
+    cl::values(clEnumValN(DebugCompressionType::None, "none", "No compression"),
+               clEnumValN(DebugCompressionType::Zlib, "zlib", "Use zlib"),
+               clEnumValN(DebugCompressionType::Zstd, "zstd", "Use zstd")),
+    cl::cat(LinkCategory));
+
 static cl::opt<bool> Verbose("v",
                              cl::desc("Print information about actions taken"),
                              cl::cat(LinkCategory));
@@ -555,7 +564,19 @@ int main(int argc, char **argv) {
     Composite->print(Out.os(), nullptr, PreserveAssemblyUseListOrder);
   } else if (Force || !CheckBitcodeOutputToConsole(Out.os())) {
     SetFormat(UseNewDbgInfoFormat && WriteNewDbgInfoFormatToBitcode);
-    WriteBitcodeToFile(*Composite, Out.os(), PreserveBitcodeUseListOrder);
+    if (CompressBitcode == DebugCompressionType::None) {
+      WriteBitcodeToFile(*Composite, Out.os(), PreserveBitcodeUseListOrder);
+    } else {
+      compression::Format F = compression::formatFor(CompressBitcode);
+      if (const char *Reason = compression::getReasonIfUnsupported(F)) {
+        WithColor::error() << "--compress-bitcode: " << Reason << '\n';
+        return 1;
+      }
+      SmallString<0> Buffer;
+      raw_svector_ostream OS(Buffer);
+      WriteBitcodeToFile(*Composite, OS, PreserveBitcodeUseListOrder);
+      writeCompressedBitcode(Buffer, F, Out.os());
+    }
   }
 
   // Declare success.
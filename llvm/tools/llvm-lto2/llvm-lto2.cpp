@@ -56,6 +56,11 @@ static cl::opt<std::string> OutputFilename("o", cl::Required,
 static cl::opt<std::string> CacheDir("cache-dir", cl::desc("Cache Directory"),
                                      cl::value_desc("directory"));
 
+static cl::opt<bool>
+    PrintCacheStats("print-cache-stats",
+                    cl::desc("Print the hits, misses and bytes transferred "
+                             "by the cache to stderr"));
+
 static cl::opt<std::string> OptPipeline("opt-pipeline",
                                         cl::desc("Optimizer Pipeline"),
                                         cl::value_desc("pipeline"));
@@ -451,11 +456,15 @@ static int run(int argc, char **argv) {
   };
 
   FileCache Cache;
+  FileCacheStats CacheStats;
   if (!CacheDir.empty())
-    Cache = check(localCache("ThinLTO", "Thin", CacheDir, AddBuffer),
+    Cache = check(localCache("ThinLTO", "Thin", CacheDir, AddBuffer,
+                             PrintCacheStats ? &CacheStats : nullptr),
                   "failed to create cache");
 
   check(Lto.run(AddStream, Cache), "LTO::run failed");
+  if (PrintCacheStats && Cache)
+    CacheStats.print(errs());
   return static_cast<int>(HasErrors);
 }
 
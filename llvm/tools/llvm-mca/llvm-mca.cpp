@@ -55,8 +55,10 @@
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/InitLLVM.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/WithColor.h"
 #include "llvm/TargetParser/Host.h"
@@ -140,6 +142,15 @@ static cl::opt<unsigned>
                 cl::desc("Number of cycles to assume for a call instruction"),
                 cl::cat(ToolOptions), cl::init(100U));
 
+static cl::opt<unsigned>
+    NumThreads("num-threads",
+               cl::desc("Number of threads used to simulate independent code "
+                        "regions in parallel (0 = all available threads)"),
+               cl::cat(ToolOptions), cl::init(1));
+
+static cl::alias NumThreadsA("j", cl::desc("Alias for --num-threads"),
+                             cl::aliasopt(NumThreads), cl::cat(ToolOptions));
+
 enum class SkipType { NONE, LACK_SCHED, PARSE_FAILURE, ANY_FAILURE };
 
 static cl::opt<enum SkipType> SkipUnsupportedInstructions(
@@ -294,6 +305,23 @@ const Target *getTarget(const char *ProgName) {
   return TheTarget;
 }
 
+/// Everything that the simulation of a code region and the printing of its
+/// report refer to. Regions are set up in order, but may then be simulated in
+/// parallel, so all of this has to live until the report has been printed.
+struct RegionSimulation {
+  std::unique_ptr<mca::InstrBuilder> IB;
+  std::unique_ptr<mca::CodeEmitter> CE;
+  DenseMap<const MCInst *, SmallVector<mca::Instrument *>> InstToInstruments;
+  SmallVector<std::unique_ptr<mca::Instruction>> LoweredSequence;
+  std::unique_ptr<mca::CircularSourceMgr> S;
+  std::unique_ptr<mca::CustomBehaviour> CB;
+  std::unique_ptr<mca::Context> MCA;
+  std::unique_ptr<mca::Pipeline> P;
+  std::unique_ptr<mca::PipelinePrinter> Printer;
+  // Set if the simulation failed.
+  std::optional<std::string> ErrorMessage;
+};
+
 ErrorOr<std::unique_ptr<ToolOutputFile>> getOutputStream() {
   if (OutputFilename == "")
     OutputFilename = "-";
@@ -336,17 +364,6 @@ static void processViewOptions(bool IsOutOfOrder) {
     processOptionImpl(PrintRetireStats, Default);
 }
 
-// Returns true on success.
-static bool runPipeline(mca::Pipeline &P) {
-  // Handle pipeline errors here.
-  Expected<unsigned> Cycles = P.run();
-  if (!Cycles) {
-    WithColor::error() << toString(Cycles.takeError());
-    return false;
-  }
-  return true;
-}
-
 int main(int argc, char **argv) {
   InitLLVM X(argc, argv);
 
@@ -572,12 +589,6 @@ int main(int argc, char **argv) {
     IPP = std::make_unique<mca::InstrPostProcess>(*STI, *MCII);
   }
 
-  // Create an instruction builder.
-  mca::InstrBuilder IB(*STI, *MCII, *MRI, MCIA.get(), *IM, CallLatency);
-
-  // Create a context to control ownership of the pipeline hardware.
-  mca::Context MCA(*MRI, *STI);
-
   mca::PipelineOptions PO(MicroOpQueue, DecoderThroughput, DispatchWidth,
                           RegisterFileSize, LoadQueueSize, StoreQueueSize,
                           AssumeNoAlias, EnableBottleneckAnalysis);
@@ -593,23 +604,63 @@ int main(int argc, char **argv) {
       *STI, *MRI, mc::InitMCTargetOptionsFromFlags()));
   assert(MAB && "Unable to create asm backend!");
 
+  // Regions are lowered and their views are set up one at a time, but the
+  // simulations of up to this many regions then run in parallel before their
+  // reports are printed in order.
+  parallel::strategy = hardware_concurrency(NumThreads);
+  const unsigned BatchSize =
+      NumThreads == 1 ? 1 : parallel::strategy.compute_thread_count() * 8;
+  std::vector<std::unique_ptr<RegionSimulation>> Batch;
+
   json::Object JSONOutput;
+  auto SimulateAndPrintBatch = [&]() {
+    parallelFor(0, Batch.size(), [&](size_t I) {
+      Expected<unsigned> Cycles = Batch[I]->P->run();
+      if (!Cycles)
+        Batch[I]->ErrorMessage = toString(Cycles.takeError());
+    });
+
+    // Handle pipeline errors here, stopping at the first region that failed.
+    for (std::unique_ptr<RegionSimulation> &RS : Batch) {
+      if (RS->ErrorMessage) {
+        WithColor::error() << *RS->ErrorMessage;
+        Batch.clear();
+        return false;
+      }
+      if (PrintJson) {
+        RS->Printer->printReport(JSONOutput);
+      } else {
+        RS->Printer->printReport(TOF->os());
+      }
+    }
+    Batch.clear();
+    return true;
+  };
+
   int NonEmptyRegions = 0;
   for (const std::unique_ptr<mca::AnalysisRegion> &Region : Regions) {
     // Skip empty code regions.
     if (Region->empty())
       continue;
 
-    IB.clear();
+    auto RS = std::make_unique<RegionSimulation>();
+
+    // Create an instruction builder. Each region gets its own, as the
+    // instruction descriptors it creates have to stay alive until the region
+    // has been simulated.
+    RS->IB = std::make_unique<mca::InstrBuilder>(*STI, *MCII, *MRI, MCIA.get(),
+                                                 *IM, CallLatency);
+    mca::InstrBuilder &IB = *RS->IB;
 
     // Lower the MCInst sequence into an mca::Instruction sequence.
     ArrayRef<MCInst> Insts = Region->getInstructions();
-    mca::CodeEmitter CE(*STI, *MAB, *MCE, Insts);
+    RS->CE = std::make_unique<mca::CodeEmitter>(*STI, *MAB, *MCE, Insts);
+    mca::CodeEmitter &CE = *RS->CE;
 
     IPP->resetState();
 
-    DenseMap<const MCInst *, SmallVector<mca::Instrument *>> InstToInstruments;
-    SmallVector<std::unique_ptr<mca::Instruction>> LoweredSequence;
+    auto &InstToInstruments = RS->InstToInstruments;
+    auto &LoweredSequence = RS->LoweredSequence;
     SmallPtrSet<const MCInst *, 16> DroppedInsts;
     for (const MCInst &MCI : Insts) {
       SMLoc Loc = MCI.getLoc();
@@ -646,6 +697,7 @@ int main(int argc, char **argv) {
           DroppedInsts.insert(&MCI);
           continue;
         }
+        SimulateAndPrintBatch();
         return 1;
       }
 
@@ -661,16 +713,19 @@ int main(int argc, char **argv) {
       continue;
     NonEmptyRegions++;
 
-    mca::CircularSourceMgr S(LoweredSequence,
-                             PrintInstructionTables ? 1 : Iterations);
+    RS->S = std::make_unique<mca::CircularSourceMgr>(
+        LoweredSequence, PrintInstructionTables ? 1 : Iterations);
+    mca::CircularSourceMgr &S = *RS->S;
 
     if (PrintInstructionTables) {
       //  Create a pipeline, stages, and a printer.
-      auto P = std::make_unique<mca::Pipeline>();
-      P->appendStage(std::make_unique<mca::EntryStage>(S));
-      P->appendStage(std::make_unique<mca::InstructionTables>(SM));
+      RS->P = std::make_unique<mca::Pipeline>();
+      RS->P->appendStage(std::make_unique<mca::EntryStage>(S));
+      RS->P->appendStage(std::make_unique<mca::InstructionTables>(SM));
 
-      mca::PipelinePrinter Printer(*P, *Region, RegionIdx, *STI, PO);
+      RS->Printer = std::make_unique<mca::PipelinePrinter>(*RS->P, *Region,
+                                                           RegionIdx, *STI, PO);
+      mca::PipelinePrinter &Printer = *RS->Printer;
       if (PrintJson) {
         Printer.addView(
             std::make_unique<mca::InstructionView>(*STI, *IP, Insts));
@@ -685,15 +740,10 @@ int main(int argc, char **argv) {
       Printer.addView(
           std::make_unique<mca::ResourcePressureView>(*STI, *IP, Insts));
 
-      if (!runPipeline(*P))
+      Batch.push_back(std::move(RS));
+      if (Batch.size() >= BatchSize && !SimulateAndPrintBatch())
         return 1;
 
-      if (PrintJson) {
-        Printer.printReport(JSONOutput);
-      } else {
-        Printer.printReport(TOF->os());
-      }
-
       ++RegionIdx;
       continue;
     }
@@ -704,19 +754,23 @@ int main(int argc, char **argv) {
     // the source code (but it can depend on the list of
     // mca::Instruction or any objects that can be reconstructed
     // from the target information).
-    std::unique_ptr<mca::CustomBehaviour> CB;
     if (!DisableCustomBehaviour)
-      CB = std::unique_ptr<mca::CustomBehaviour>(
+      RS->CB = std::unique_ptr<mca::CustomBehaviour>(
           TheTarget->createCustomBehaviour(*STI, S, *MCII));
-    if (!CB)
+    if (!RS->CB)
       // If the target doesn't have its own CB implemented (or the -disable-cb
       // flag is set) then we use the base class (which does nothing).
-      CB = std::make_unique<mca::CustomBehaviour>(*STI, S, *MCII);
+      RS->CB = std::make_unique<mca::CustomBehaviour>(*STI, S, *MCII);
+    mca::CustomBehaviour &CB = *RS->CB;
 
-    // Create a basic pipeline simulating an out-of-order backend.
-    auto P = MCA.createDefaultPipeline(PO, S, *CB);
+    // Create a context to control ownership of the pipeline hardware, and a
+    // basic pipeline simulating an out-of-order backend.
+    RS->MCA = std::make_unique<mca::Context>(*MRI, *STI);
+    RS->P = RS->MCA->createDefaultPipeline(PO, S, CB);
 
-    mca::PipelinePrinter Printer(*P, *Region, RegionIdx, *STI, PO);
+    RS->Printer = std::make_unique<mca::PipelinePrinter>(*RS->P, *Region,
+                                                         RegionIdx, *STI, PO);
+    mca::PipelinePrinter &Printer = *RS->Printer;
 
     // Targets can define their own custom Views that exist within their
     // /lib/Target/ directory so that the View can utilize their CustomBehaviour
@@ -728,7 +782,7 @@ int main(int argc, char **argv) {
     // /tools/llvm-mca/Views/ instead.
     if (!DisableCustomBehaviour) {
       std::vector<std::unique_ptr<mca::View>> CBViews =
-          CB->getStartViews(*IP, Insts);
+          CB.getStartViews(*IP, Insts);
       for (auto &CBView : CBViews)
         Printer.addView(std::move(CBView));
     }
@@ -760,11 +814,11 @@ int main(int argc, char **argv) {
           ShowBarriers, *IM, InstToInstruments));
 
     // Fetch custom Views that are to be placed after the InstructionInfoView.
-    // Refer to the comment paired with the CB->getStartViews(*IP, Insts); line
+    // Refer to the comment paired with the CB.getStartViews(*IP, Insts); line
     // for more info.
     if (!DisableCustomBehaviour) {
       std::vector<std::unique_ptr<mca::View>> CBViews =
-          CB->getPostInstrInfoViews(*IP, Insts);
+          CB.getPostInstrInfoViews(*IP, Insts);
       for (auto &CBView : CBViews)
         Printer.addView(std::move(CBView));
     }
@@ -794,27 +848,25 @@ int main(int argc, char **argv) {
     }
 
     // Fetch custom Views that are to be placed after all other Views.
-    // Refer to the comment paired with the CB->getStartViews(*IP, Insts); line
+    // Refer to the comment paired with the CB.getStartViews(*IP, Insts); line
     // for more info.
     if (!DisableCustomBehaviour) {
       std::vector<std::unique_ptr<mca::View>> CBViews =
-          CB->getEndViews(*IP, Insts);
+          CB.getEndViews(*IP, Insts);
       for (auto &CBView : CBViews)
         Printer.addView(std::move(CBView));
     }
 
-    if (!runPipeline(*P))
+    Batch.push_back(std::move(RS));
+    if (Batch.size() >= BatchSize && !SimulateAndPrintBatch())
       return 1;
 
-    if (PrintJson) {
-      Printer.printReport(JSONOutput);
-    } else {
-      Printer.printReport(TOF->os());
-    }
-
     ++RegionIdx;
   }
 
+  if (!SimulateAndPrintBatch())
+    return 1;
+
   if (NonEmptyRegions == 0) {
     WithColor::error() << "no assembly instructions found.\n";
     return 1;
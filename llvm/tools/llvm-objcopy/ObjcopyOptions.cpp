@@ -1229,6 +1229,13 @@ objcopy::parseObjcopyOptions(ArrayRef<const char *> RawArgsArr,
                              "cannot specify --extract-partition together with "
                              "--extract-main-partition");
 
+  DC.OnlyUpdatesSections =
+      !Config.UpdateSection.empty() &&
+      llvm::all_of(InputArgs, [](const opt::Arg *Arg) {
+        return Arg->getOption().matches(OBJCOPY_INPUT) ||
+               Arg->getOption().matches(OBJCOPY_update_section);
+      });
+
   DC.CopyConfigs.push_back(std::move(ConfigMgr));
   return std::move(DC);
 }
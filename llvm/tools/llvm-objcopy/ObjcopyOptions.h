@@ -21,6 +21,9 @@ namespace objcopy {
 struct DriverConfig {
   SmallVector<ConfigManager, 1> CopyConfigs;
   BumpPtrAllocator Alloc;
+  // Set when the only edits requested are --update-section, which may then be
+  // applied without rewriting the object.
+  bool OnlyUpdatesSections = false;
 };
 
 // ParseObjcopyOptions returns the config and sets the input arguments. If a
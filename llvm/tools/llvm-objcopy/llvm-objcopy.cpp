@@ -132,10 +132,91 @@ static Error executeObjcopyOnRawBinary(ConfigManager &ConfigMgr,
   llvm_unreachable("unsupported output format");
 }
 
+/// Apply the --update-section edits of Config by writing the new contents over
+/// the old ones in a copy of the input file, rather than rewriting the whole
+/// object. This is only done for ELF files where every updated section has
+/// contents of the same size as its new data, so that the layout of the file
+/// doesn't change. Returns false if the edits can't be applied this way.
+static Expected<bool> updateSectionsInPlace(const CommonConfig &Config,
+                                            Binary &Bin) {
+  auto *Obj = dyn_cast<ELFObjectFileBase>(&Bin);
+  if (!Obj || Config.InputFilename == "-" || Config.OutputFilename == "-" ||
+      Config.OutputFilename == "/dev/null")
+    return false;
+
+  SmallVector<std::pair<uint64_t, const NewSectionInfo *>, 4> Patches;
+  for (const NewSectionInfo &NewSection : Config.UpdateSection) {
+    // Like the full rewrite, update the first section with the given name.
+    std::optional<ELFSectionRef> Found;
+    for (const SectionRef &Sec : Obj->sections()) {
+      Expected<StringRef> NameOrErr = Sec.getName();
+      if (!NameOrErr) {
+        consumeError(NameOrErr.takeError());
+        return false;
+      }
+      if (*NameOrErr == NewSection.SectionName) {
+        Found = ELFSectionRef(Sec);
+        break;
+      }
+    }
+    if (!Found || Found->getType() == ELF::SHT_NULL ||
+        Found->getType() == ELF::SHT_NOBITS ||
+        Found->getSize() != NewSection.SectionData->getBufferSize() ||
+        Found->getOffset() + Found->getSize() > Obj->getData().size())
+      return false;
+    Patches.push_back({Found->getOffset(), &NewSection});
+  }
+
+  auto WritePatches = [&](int FD) -> Error {
+    raw_fd_ostream OS(FD, /*shouldClose=*/false);
+    for (const auto &[Offset, NewSection] : Patches) {
+      OS.seek(Offset);
+      OS << NewSection->SectionData->getBuffer();
+    }
+    OS.flush();
+    if (OS.has_error()) {
+      std::error_code EC = OS.error();
+      OS.clear_error();
+      return errorCodeToError(EC);
+    }
+    return Error::success();
+  };
+
+  // Copy the input to a new temporary file, so that the copy can be a clone
+  // where the file system supports it, then patch it and move it in place.
+  // This is also done when the input is the output, so that the output is
+  // replaced atomically and other hard links to the input are left alone.
+  SmallString<128> TempPath;
+  sys::fs::createUniquePath(Config.OutputFilename + ".temp-objcopy-%%%%%%",
+                            TempPath, /*MakeAbsolute=*/false);
+  // If the copy fails, or keeps the permissions of a read-only input, leave
+  // the file to the full rewrite, which reports errors as usual.
+  if (sys::fs::copy_file(Config.InputFilename, TempPath)) {
+    sys::fs::remove(TempPath);
+    return false;
+  }
+  int FD;
+  if (sys::fs::openFileForReadWrite(TempPath, FD, sys::fs::CD_OpenExisting,
+                                    sys::fs::OF_None)) {
+    sys::fs::remove(TempPath);
+    return false;
+  }
+  Error E = WritePatches(FD);
+  sys::Process::SafelyCloseFileDescriptor(FD);
+  if (!E)
+    E = errorCodeToError(sys::fs::rename(TempPath, Config.OutputFilename));
+  if (E) {
+    sys::fs::remove(TempPath);
+    return createFileError(Config.OutputFilename, std::move(E));
+  }
+  return true;
+}
+
 /// The function executeObjcopy does the higher level dispatch based on the type
 /// of input (raw binary, archive or single object file) and takes care of the
 /// format-agnostic modifications, i.e. preserving dates.
-static Error executeObjcopy(ConfigManager &ConfigMgr) {
+static Error executeObjcopy(ConfigManager &ConfigMgr,
+                            bool OnlyUpdatesSections) {
   CommonConfig &Config = ConfigMgr.Common;
 
   Expected<FilePermissionsApplier> PermsApplierOrErr =
@@ -179,11 +260,20 @@ static Error executeObjcopy(ConfigManager &ConfigMgr) {
       if (Error E = executeObjcopyOnArchive(ConfigMgr, *Ar))
         return E;
     } else {
+      bool UpdatedInPlace = false;
+      if (OnlyUpdatesSections) {
+        Expected<bool> UpdatedOrErr =
+            updateSectionsInPlace(Config, *BinaryHolder.getBinary());
+        if (!UpdatedOrErr)
+          return UpdatedOrErr.takeError();
+        UpdatedInPlace = *UpdatedOrErr;
+      }
       // Handle llvm::object::Binary.
-      ObjcopyFunc = [&](raw_ostream &OutFile) -> Error {
-        return executeObjcopyOnBinary(ConfigMgr, *BinaryHolder.getBinary(),
-                                      OutFile);
-      };
+      if (!UpdatedInPlace)
+        ObjcopyFunc = [&](raw_ostream &OutFile) -> Error {
+          return executeObjcopyOnBinary(ConfigMgr, *BinaryHolder.getBinary(),
+                                        OutFile);
+        };
     }
   }
 
@@ -248,7 +338,8 @@ int llvm_objcopy_main(int argc, char **argv, const llvm::ToolContext &) {
     return 1;
   }
   for (ConfigManager &ConfigMgr : DriverConfig->CopyConfigs) {
-    if (Error E = executeObjcopy(ConfigMgr)) {
+    if (Error E =
+            executeObjcopy(ConfigMgr, DriverConfig->OnlyUpdatesSections)) {
       logAllUnhandledErrors(std::move(E), WithColor::error(errs(), ToolName));
       return 1;
     }
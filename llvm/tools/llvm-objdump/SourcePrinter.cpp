@@ -425,7 +425,7 @@ void SourcePrinter::printSourceLine(formatted_raw_ostream &OS,
     printLines(OS, LineInfo, Delimiter, LVP);
   if (PrintSource)
     printSources(OS, LineInfo, ObjectFilename, Delimiter, LVP);
-  OldLineInfo = LineInfo;
+  OldLineInfo = std::move(LineInfo);
 }
 
 void SourcePrinter::printLines(formatted_raw_ostream &OS,
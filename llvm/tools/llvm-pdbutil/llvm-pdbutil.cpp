@@ -35,9 +35,10 @@
 #include "llvm/DebugInfo/CodeView/DebugChecksumsSubsection.h"
 #include "llvm/DebugInfo/CodeView/DebugInlineeLinesSubsection.h"
 #include "llvm/DebugInfo/CodeView/DebugLinesSubsection.h"
+#include "llvm/DebugInfo/CodeView/GlobalTypeTableBuilder.h"
 #include "llvm/DebugInfo/CodeView/LazyRandomTypeCollection.h"
-#include "llvm/DebugInfo/CodeView/MergingTypeTableBuilder.h"
 #include "llvm/DebugInfo/CodeView/StringsAndChecksums.h"
+#include "llvm/DebugInfo/CodeView/TypeHashing.h"
 #include "llvm/DebugInfo/CodeView/TypeStreamMerger.h"
 #include "llvm/DebugInfo/MSF/MSFBuilder.h"
 #include "llvm/DebugInfo/MSF/MappedBlockStream.h"
@@ -83,6 +84,7 @@
 #include "llvm/Support/InitLLVM.h"
 #include "llvm/Support/LineIterator.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/PrettyStackTrace.h"
 #include "llvm/Support/Process.h"
@@ -1318,26 +1320,49 @@ static void dumpPretty(StringRef Path) {
 }
 
 static void mergePdbs() {
+  struct MergeInput {
+    std::unique_ptr<IPDBSession> Session;
+    TpiStream *Tpi = nullptr;
+    TpiStream *Ipi = nullptr;
+    std::vector<GloballyHashedType> TypeHashes;
+    std::vector<GloballyHashedType> IdHashes;
+  };
+  std::vector<MergeInput> Inputs(opts::merge::InputFilenames.size());
+  for (auto [Path, Input] : zip(opts::merge::InputFilenames, Inputs)) {
+    auto &File = loadPDB(Path, Input.Session);
+    if (File.hasPDBTpiStream())
+      Input.Tpi = &ExitOnErr(File.getPDBTpiStream());
+    if (File.hasPDBIpiStream())
+      Input.Ipi = &ExitOnErr(File.getPDBIpiStream());
+  }
+
+  // Computing the global hashes is the expensive part of merging and only
+  // depends on the input itself, so hash all inputs in parallel.
+  parallelFor(0, Inputs.size(), [&](size_t I) {
+    MergeInput &Input = Inputs[I];
+    if (Input.Tpi)
+      Input.TypeHashes = GloballyHashedType::hashTypes(Input.Tpi->typeArray());
+    if (Input.Ipi)
+      Input.IdHashes =
+          GloballyHashedType::hashIds(Input.Ipi->typeArray(), Input.TypeHashes);
+  });
+
   BumpPtrAllocator Allocator;
-  MergingTypeTableBuilder MergedTpi(Allocator);
-  MergingTypeTableBuilder MergedIpi(Allocator);
+  GlobalTypeTableBuilder MergedTpi(Allocator);
+  GlobalTypeTableBuilder MergedIpi(Allocator);
 
   // Create a Tpi and Ipi type table with all types from all input files.
-  for (const auto &Path : opts::merge::InputFilenames) {
-    std::unique_ptr<IPDBSession> Session;
-    auto &File = loadPDB(Path, Session);
+  for (MergeInput &Input : Inputs) {
     SmallVector<TypeIndex, 128> TypeMap;
     SmallVector<TypeIndex, 128> IdMap;
-    if (File.hasPDBTpiStream()) {
-      auto &Tpi = ExitOnErr(File.getPDBTpiStream());
-      ExitOnErr(
-          codeview::mergeTypeRecords(MergedTpi, TypeMap, Tpi.typeArray()));
-    }
-    if (File.hasPDBIpiStream()) {
-      auto &Ipi = ExitOnErr(File.getPDBIpiStream());
-      ExitOnErr(codeview::mergeIdRecords(MergedIpi, TypeMap, IdMap,
-                                         Ipi.typeArray()));
-    }
+    std::optional<PCHMergerInfo> PCHInfo;
+    if (Input.Tpi)
+      ExitOnErr(codeview::mergeTypeRecords(MergedTpi, TypeMap,
+                                           Input.Tpi->typeArray(),
+                                           Input.TypeHashes, PCHInfo));
+    if (Input.Ipi)
+      ExitOnErr(codeview::mergeIdRecords(
+          MergedIpi, TypeMap, IdMap, Input.Ipi->typeArray(), Input.IdHashes));
   }
 
   // Then write the PDB.
@@ -1038,6 +1038,9 @@ static void mergeInstrProfile(const WeightedFileVector &Inputs,
                    Contexts[End - 1].get());
         Pool.wait();
       }
+      // The merged contexts handed over their errors and records; free them
+      // before the next round so that peak memory shrinks as merging goes on.
+      Contexts.truncate(Mid);
       End = Mid;
       Mid /= 2;
     } while (Mid > 0);
@@ -33,6 +33,7 @@
 #include "llvm/MC/TargetRegistry.h"
 #include "llvm/Passes/PassBuilder.h"
 #include "llvm/Support/MemoryBufferRef.h"
+#include "llvm/Support/SHA1.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Support/ToolOutputFile.h"
@@ -63,6 +64,39 @@ static cl::opt<bool> TmpFilesAsBitcode(
     cl::desc("Always write temporary files as bitcode instead of textual IR"),
     cl::init(false), cl::cat(LLVMReduceOptions));
 
+static cl::opt<bool> CacheTestResults(
+    "cache-test-results",
+    cl::desc("Do not run the interesting-ness test again for a test case that "
+             "has already been tested"),
+    cl::init(false), cl::cat(LLVMReduceOptions));
+
+namespace {
+/// Forwards everything written to it to another stream and hashes it on the
+/// way, so that a test case is hashed without being written twice.
+class HashingForwardStream : public raw_ostream {
+  raw_ostream &OS;
+  SHA1 Hasher;
+  uint64_t Pos = 0;
+
+  void write_impl(const char *Ptr, size_t Size) override {
+    Hasher.update(StringRef(Ptr, Size));
+    OS.write(Ptr, Size);
+    Pos += Size;
+  }
+
+  uint64_t current_pos() const override { return Pos; }
+
+public:
+  explicit HashingForwardStream(raw_ostream &OS) : OS(OS) {}
+  ~HashingForwardStream() override { flush(); }
+
+  std::array<uint8_t, 20> result() {
+    flush();
+    return Hasher.result();
+  }
+};
+} // namespace
+
 static void cloneFrameInfo(
     MachineFrameInfo &DstMFI, const MachineFrameInfo &SrcMFI,
     const DenseMap<MachineBasicBlock *, MachineBasicBlock *> &Src2DstMBB) {
@@ -495,7 +529,13 @@ bool ReducerWorkItem::isReduced(const TestRunner &Test) const {
 
   ToolOutputFile Out(CurrentFilepath, FD);
 
-  writeOutput(Out.os(), UseBitcode);
+  std::array<uint8_t, 20> Hash;
+  {
+    HashingForwardStream HashingOS(Out.os());
+    writeOutput(HashingOS, UseBitcode);
+    Hash = HashingOS.result();
+  }
+  StringRef HashStr(reinterpret_cast<const char *>(Hash.data()), Hash.size());
 
   Out.os().close();
   if (Out.os().has_error()) {
@@ -505,8 +545,15 @@ bool ReducerWorkItem::isReduced(const TestRunner &Test) const {
     exit(1);
   }
 
+  if (CacheTestResults)
+    if (std::optional<bool> Interesting = Test.lookupResult(HashStr))
+      return *Interesting;
+
   // Current Chunks aren't interesting
-  return Test.run(CurrentFilepath);
+  bool Interesting = Test.run(CurrentFilepath);
+  if (CacheTestResults)
+    Test.addResult(HashStr, Interesting);
+  return Interesting;
 }
 
 std::unique_ptr<ReducerWorkItem>
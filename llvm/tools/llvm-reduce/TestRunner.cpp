@@ -55,6 +55,19 @@ int TestRunner::run(StringRef Filename) const {
   return !Result;
 }
 
+std::optional<bool> TestRunner::lookupResult(StringRef Hash) const {
+  std::lock_guard<std::mutex> Lock(ResultsMutex);
+  auto I = Results.find(Hash);
+  if (I == Results.end())
+    return std::nullopt;
+  return I->second;
+}
+
+void TestRunner::addResult(StringRef Hash, bool Interesting) const {
+  std::lock_guard<std::mutex> Lock(ResultsMutex);
+  Results[Hash] = Interesting;
+}
+
 void TestRunner::writeOutput(StringRef Message) {
   std::error_code EC;
   raw_fd_ostream Out(OutputFilename, EC,
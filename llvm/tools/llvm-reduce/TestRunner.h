@@ -10,12 +10,15 @@
 #define LLVM_TOOLS_LLVM_REDUCE_TESTRUNNER_H
 
 #include "ReducerWorkItem.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/IR/Module.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Program.h"
 #include "llvm/Target/TargetMachine.h"
+#include <mutex>
+#include <optional>
 #include <vector>
 
 namespace llvm {
@@ -34,6 +37,14 @@ public:
   /// @returns 0 if test was successful, 1 if otherwise
   int run(StringRef Filename) const;
 
+  /// Returns the result of the interesting-ness test for a test case whose
+  /// contents hash to \p Hash, if such a test case has been tested before.
+  /// The test is assumed to be deterministic.
+  std::optional<bool> lookupResult(StringRef Hash) const;
+
+  /// Records the result of the interesting-ness test for \p Hash.
+  void addResult(StringRef Hash, bool Interesting) const;
+
   /// Returns the most reduced version of the original testcase
   ReducerWorkItem &getProgram() const { return *Program; }
 
@@ -61,6 +72,11 @@ private:
   StringRef OutputFilename;
   const bool InputIsBitcode;
   bool EmitBitcode;
+
+  /// Results of the interesting-ness test by test case hash. Chunks are
+  /// checked from several threads with -j, hence the mutex.
+  mutable std::mutex ResultsMutex;
+  mutable StringMap<bool> Results;
 };
 
 } // namespace llvm
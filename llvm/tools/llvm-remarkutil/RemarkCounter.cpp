@@ -12,7 +12,9 @@
 
 #include "RemarkCounter.h"
 #include "RemarkUtilRegistry.h"
+#include "llvm/ADT/Sequence.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Regex.h"
 
 using namespace llvm;
@@ -23,7 +25,19 @@ static cl::SubCommand CountSub("count",
                                "Collect remarks based on specified criteria.");
 
 INPUT_FORMAT_COMMAND_LINE_OPTIONS(CountSub)
-INPUT_OUTPUT_COMMAND_LINE_OPTIONS(CountSub)
+
+static cl::list<std::string>
+    InputFileNames(cl::Positional, cl::desc("<input files>"),
+                   cl::sub(CountSub));
+static cl::opt<std::string> OutputFileName("o", cl::init("-"),
+                                           cl::desc("Output"),
+                                           cl::value_desc("filename"),
+                                           cl::sub(CountSub));
+static cl::opt<unsigned>
+    NumThreads("j", cl::init(0),
+               cl::desc("Number of threads used to parse the input files "
+                        "(0 = use all available threads)"),
+               cl::value_desc("N"), cl::sub(CountSub));
 
 static cl::list<std::string>
     Keys("args", cl::desc("Specify remark argument/s to count by."),
@@ -139,6 +153,30 @@ bool Filters::filterRemark(const Remark &Remark) {
   return true;
 }
 
+Expected<ArgumentCounter> ArgumentCounter::createArgumentCounter(
+    GroupBy Group, ArrayRef<FilterMatcher> Arguments,
+    ArrayRef<StringRef> Buffers, Filters &Filter) {
+  ArgumentCounter AC;
+  AC.Group = Group;
+  for (auto &Arg : Arguments) {
+    if (Arg.IsRegex) {
+      if (auto E = checkRegex(Arg.FilterRE))
+        return std::move(E);
+    }
+  }
+  std::vector<ArgumentCounter> PerBuffer(Buffers.size());
+  if (auto E = parallelForEachError(
+          seq<size_t>(0, Buffers.size()), [&](size_t I) {
+            return PerBuffer[I].getAllMatchingArgumentsInRemark(
+                Buffers[I], Arguments, Filter);
+          }))
+    return std::move(E);
+  for (const ArgumentCounter &BufferAC : PerBuffer)
+    for (auto [Key, _] : BufferAC.ArgumentSetIdxMap)
+      AC.ArgumentSetIdxMap.insert({Key, AC.ArgumentSetIdxMap.size()});
+  return AC;
+}
+
 Error ArgumentCounter::getAllMatchingArgumentsInRemark(
     StringRef Buffer, ArrayRef<FilterMatcher> Arguments, Filters &Filter) {
   auto MaybeParser = createRemarkParser(InputFormat, Buffer);
@@ -197,6 +235,19 @@ void ArgumentCounter::collect(const Remark &Remark) {
   }
 }
 
+void ArgumentCounter::merge(const ArgumentCounter &Other) {
+  assert(Other.ArgumentSetIdxMap.size() == ArgumentSetIdxMap.size() &&
+         "Merging counters of different arguments");
+  for (const auto &[GroupVal, OtherRow] : Other.CountByKeysMap) {
+    auto &Row =
+        CountByKeysMap
+            .insert({GroupVal, SmallVector<unsigned, 4>(OtherRow.size())})
+            .first->second;
+    for (auto [Count, OtherCount] : zip_equal(Row, OtherRow))
+      Count += OtherCount;
+  }
+}
+
 void RemarkCounter::collect(const Remark &Remark) {
   std::optional<std::string> Key = getGroupByKey(Remark);
   if (!Key.has_value())
@@ -206,6 +257,11 @@ void RemarkCounter::collect(const Remark &Remark) {
     Iter.first->second += 1;
 }
 
+void RemarkCounter::merge(const RemarkCounter &Other) {
+  for (const auto &[Key, Count] : Other.CountedByRemarksMap)
+    CountedByRemarksMap[Key] += Count;
+}
+
 Error ArgumentCounter::print(StringRef OutputFileName) {
   auto MaybeOF =
       getOutputFileWithFlags(OutputFileName, sys::fs::OF_TextWithCRLF);
@@ -277,7 +333,9 @@ Expected<Filters> getRemarkFilter() {
                                      std::move(RemarkArgFilter), RemarkType);
 }
 
-Error useCollectRemark(StringRef Buffer, Counter &Counter, Filters &Filter) {
+/// Collect the remarks of \p Buffer that pass \p Filter into \p Counter.
+static Error collectRemarksFromBuffer(StringRef Buffer, Counter &Counter,
+                                      Filters &Filter) {
   // Create Parser.
   auto MaybeParser = createRemarkParser(InputFormat, Buffer);
   if (!MaybeParser)
@@ -290,8 +348,6 @@ Error useCollectRemark(StringRef Buffer, Counter &Counter, Filters &Filter) {
       Counter.collect(Remark);
   }
 
-  if (auto E = Counter.print(OutputFileName))
-    return E;
   auto E = MaybeRemark.takeError();
   if (!E.isA<EndOfFileError>())
     return E;
@@ -299,19 +355,50 @@ Error useCollectRemark(StringRef Buffer, Counter &Counter, Filters &Filter) {
   return Error::success();
 }
 
+/// Count the remarks of all the \p Buffers into \p Total and print the
+/// result. Each buffer is parsed in parallel into its own counter, and the
+/// counters are merged in the order of the buffers. The counts are printed even
+/// if some of the buffers fail to parse.
+template <typename CounterTy>
+static Error useCollectRemark(ArrayRef<StringRef> Buffers, CounterTy &Total,
+                              Filters &Filter) {
+  std::vector<CounterTy> PerBuffer(Buffers.size(), Total);
+  Error E = parallelForEachError(
+      seq<size_t>(0, Buffers.size()), [&](size_t I) -> Error {
+        if (auto Err =
+                collectRemarksFromBuffer(Buffers[I], PerBuffer[I], Filter))
+          return createFileError(InputFileNames[I], std::move(Err));
+        return Error::success();
+      });
+  for (const CounterTy &Counter : PerBuffer)
+    Total.merge(Counter);
+
+  if (auto PrintE = Total.print(OutputFileName))
+    return joinErrors(std::move(E), std::move(PrintE));
+  return E;
+}
+
 static Error collectRemarks() {
-  // Create a parser for the user-specified input format.
-  auto MaybeBuf = getInputMemoryBuffer(InputFileName);
-  if (!MaybeBuf)
-    return MaybeBuf.takeError();
-  StringRef Buffer = (*MaybeBuf)->getBuffer();
+  parallel::strategy = hardware_concurrency(NumThreads);
+  // Read from the standard input if no file is given.
+  if (InputFileNames.empty())
+    InputFileNames.push_back("-");
+  SmallVector<std::unique_ptr<MemoryBuffer>, 1> Files;
+  SmallVector<StringRef, 1> Buffers;
+  for (const std::string &InputFileName : InputFileNames) {
+    auto MaybeBuf = getInputMemoryBuffer(InputFileName);
+    if (!MaybeBuf)
+      return MaybeBuf.takeError();
+    Buffers.push_back((*MaybeBuf)->getBuffer());
+    Files.push_back(std::move(*MaybeBuf));
+  }
   auto MaybeFilter = getRemarkFilter();
   if (!MaybeFilter)
     return MaybeFilter.takeError();
   auto &Filter = *MaybeFilter;
   if (CountByOpt == CountBy::REMARK) {
     RemarkCounter RC(GroupByOpt);
-    if (auto E = useCollectRemark(Buffer, RC, Filter))
+    if (auto E = useCollectRemark(Buffers, RC, Filter))
       return E;
   } else if (CountByOpt == CountBy::ARGUMENT) {
     SmallVector<FilterMatcher, 4> ArgumentsVector;
@@ -325,10 +412,10 @@ static Error collectRemarks() {
       ArgumentsVector.push_back({".*", true});
 
     Expected<ArgumentCounter> AC = ArgumentCounter::createArgumentCounter(
-        GroupByOpt, ArgumentsVector, Buffer, Filter);
+        GroupByOpt, ArgumentsVector, Buffers, Filter);
     if (!AC)
       return AC.takeError();
-    if (auto E = useCollectRemark(Buffer, *AC, Filter))
+    if (auto E = useCollectRemark(Buffers, *AC, Filter))
       return E;
   }
   return Error::success();
@@ -155,26 +155,19 @@ struct ArgumentCounter : Counter {
   /// Create an argument counter. If the provided \p Arguments represent a regex
   /// vector then we need to check that the provided regular expressions are
   /// valid if not we return an Error.
+  /// The arguments are collected from all the remark files in \p Buffers, in
+  /// parallel, and numbered in the order of the files.
   static Expected<ArgumentCounter>
   createArgumentCounter(GroupBy Group, ArrayRef<FilterMatcher> Arguments,
-                        StringRef Buffer, Filters &Filter) {
-    ArgumentCounter AC;
-    AC.Group = Group;
-    for (auto &Arg : Arguments) {
-      if (Arg.IsRegex) {
-        if (auto E = checkRegex(Arg.FilterRE))
-          return std::move(E);
-      }
-    }
-    if (auto E = AC.getAllMatchingArgumentsInRemark(Buffer, Arguments, Filter))
-      return std::move(E);
-    return AC;
-  }
+                        ArrayRef<StringRef> Buffers, Filters &Filter);
 
   /// Update the internal count map based on the remark integer arguments that
   /// correspond the the user specified argument keys to collect for.
   void collect(const Remark &) override;
 
+  /// Add the counts of \p Other, which was created with the same arguments.
+  void merge(const ArgumentCounter &Other);
+
   /// Print a CSV table consisting of an index which is specified by \p
   /// `Group` and can be a function name, source file name or function name
   /// with the full source path and columns of user specified remark arguments
@@ -203,6 +196,9 @@ struct RemarkCounter : Counter {
   /// seeing \p Remark.
   void collect(const Remark &) override;
 
+  /// Add the counts of \p Other to this counter.
+  void merge(const RemarkCounter &Other);
+
   /// Print a CSV table consisting of an index which is specified by \p
   /// `Group` and can be a function name, source file name or function name
   /// with the full source path and a counts column corresponding to the count
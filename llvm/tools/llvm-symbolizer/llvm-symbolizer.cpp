@@ -15,6 +15,9 @@
 //===----------------------------------------------------------------------===//
 
 #include "Opts.inc"
+#include "llvm/ADT/FunctionExtras.h"
+#include "llvm/ADT/Hashing.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Config/config.h"
@@ -37,12 +40,14 @@
 #include "llvm/Support/LLVMDriver.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/StringSaver.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/WithColor.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <cstdio>
 #include <cstring>
 #include <iostream>
+#include <mutex>
 #include <string>
 
 using namespace llvm;
@@ -108,6 +113,19 @@ static void print(const Request &Request, Expected<T> &ResOrErr,
     Printer.print(Request, T());
 }
 
+/// The printing of the result of one input line. Printing is deferred so that
+/// the inputs of a batch can be symbolized concurrently and printed in order.
+using DeferredPrint = unique_function<void(DIPrinter &Printer)>;
+
+template <typename T>
+static DeferredPrint deferPrint(const Request &Request, Expected<T> ResOrErr) {
+  return [ModuleName = Request.ModuleName.str(), Address = Request.Address,
+          Symbol = Request.Symbol.str(),
+          ResOrErr = std::move(ResOrErr)](DIPrinter &Printer) mutable {
+    print({ModuleName, Address, Symbol}, ResOrErr, Printer);
+  };
+}
+
 enum class OutputStyle { LLVM, GNU, JSON };
 
 enum class Command {
@@ -118,15 +136,17 @@ enum class Command {
 
 static void enableDebuginfod(LLVMSymbolizer &Symbolizer,
                              const opt::ArgList &Args) {
-  static bool IsEnabled = false;
-  if (IsEnabled)
+  static std::mutex M;
+  static SmallPtrSet<LLVMSymbolizer *, 8> EnabledSymbolizers;
+  std::lock_guard<std::mutex> Lock(M);
+  if (!EnabledSymbolizers.insert(&Symbolizer).second)
     return;
-  IsEnabled = true;
   // Look up symbols using the debuginfod client.
   Symbolizer.setBuildIDFetcher(std::make_unique<DebuginfodFetcher>(
       Args.getAllArgValues(OPT_debug_file_directory_EQ)));
-  // The HTTPClient must be initialized for use by the debuginfod client.
-  HTTPClient::initialize();
+  // The HTTPClient must be initialized once for use by the debuginfod client.
+  if (EnabledSymbolizers.size() == 1)
+    HTTPClient::initialize();
 }
 
 static StringRef getSpaceDelimitedWord(StringRef &Source) {
@@ -274,31 +294,32 @@ static Error parseCommand(StringRef BinaryName, bool IsAddr2Line,
 }
 
 template <typename T>
-void executeCommand(StringRef ModuleName, const T &ModuleSpec, Command Cmd,
-                    StringRef Symbol, uint64_t Offset, uint64_t AdjustVMA,
-                    bool ShouldInline, OutputStyle Style,
-                    LLVMSymbolizer &Symbolizer, DIPrinter &Printer) {
+DeferredPrint executeCommand(StringRef ModuleName, const T &ModuleSpec,
+                             Command Cmd, StringRef Symbol, uint64_t Offset,
+                             uint64_t AdjustVMA, bool ShouldInline,
+                             OutputStyle Style, LLVMSymbolizer &Symbolizer) {
   uint64_t AdjustedOffset = Offset - AdjustVMA;
   object::SectionedAddress Address = {AdjustedOffset,
                                       object::SectionedAddress::UndefSection};
   Request SymRequest = {
       ModuleName, Symbol.empty() ? std::make_optional(Offset) : std::nullopt,
       Symbol};
+  DeferredPrint Result;
   if (Cmd == Command::Data) {
     Expected<DIGlobal> ResOrErr = Symbolizer.symbolizeData(ModuleSpec, Address);
-    print(SymRequest, ResOrErr, Printer);
+    Result = deferPrint(SymRequest, std::move(ResOrErr));
   } else if (Cmd == Command::Frame) {
     Expected<std::vector<DILocal>> ResOrErr =
         Symbolizer.symbolizeFrame(ModuleSpec, Address);
-    print(SymRequest, ResOrErr, Printer);
+    Result = deferPrint(SymRequest, std::move(ResOrErr));
   } else if (!Symbol.empty()) {
     Expected<std::vector<DILineInfo>> ResOrErr =
         Symbolizer.findSymbol(ModuleSpec, Symbol, Offset);
-    print(SymRequest, ResOrErr, Printer);
+    Result = deferPrint(SymRequest, std::move(ResOrErr));
   } else if (ShouldInline) {
     Expected<DIInliningInfo> ResOrErr =
         Symbolizer.symbolizeInlinedCode(ModuleSpec, Address);
-    print(SymRequest, ResOrErr, Printer);
+    Result = deferPrint(SymRequest, std::move(ResOrErr));
   } else if (Style == OutputStyle::GNU) {
     // With PrintFunctions == FunctionNameKind::LinkageName (default)
     // and UseSymbolTable == true (also default), Symbolizer.symbolizeCode()
@@ -313,13 +334,14 @@ void executeCommand(StringRef ModuleName, const T &ModuleSpec, Command Cmd,
             ? Expected<DILineInfo>(ResOrErr.takeError())
             : ((ResOrErr->getNumberOfFrames() == 0) ? DILineInfo()
                                                     : ResOrErr->getFrame(0));
-    print(SymRequest, Res0OrErr, Printer);
+    Result = deferPrint(SymRequest, std::move(Res0OrErr));
   } else {
     Expected<DILineInfo> ResOrErr =
         Symbolizer.symbolizeCode(ModuleSpec, Address);
-    print(SymRequest, ResOrErr, Printer);
+    Result = deferPrint(SymRequest, std::move(ResOrErr));
   }
   Symbolizer.pruneCache();
+  return Result;
 }
 
 static void printUnknownLineInfo(std::string ModuleName, DIPrinter &Printer) {
@@ -327,11 +349,11 @@ static void printUnknownLineInfo(std::string ModuleName, DIPrinter &Printer) {
   Printer.print(SymRequest, DILineInfo());
 }
 
-static void symbolizeInput(const opt::InputArgList &Args,
-                           object::BuildIDRef IncomingBuildID,
-                           uint64_t AdjustVMA, bool IsAddr2Line,
-                           OutputStyle Style, StringRef InputString,
-                           LLVMSymbolizer &Symbolizer, DIPrinter &Printer) {
+static DeferredPrint symbolizeInput(const opt::InputArgList &Args,
+                                    object::BuildIDRef IncomingBuildID,
+                                    uint64_t AdjustVMA, bool IsAddr2Line,
+                                    OutputStyle Style, StringRef InputString,
+                                    LLVMSymbolizer &Symbolizer) {
   Command Cmd;
   std::string ModuleName;
   object::BuildID BuildID(IncomingBuildID.begin(), IncomingBuildID.end());
@@ -341,18 +363,18 @@ static void symbolizeInput(const opt::InputArgList &Args,
   // An empty input string may be used to check if the process is alive and
   // responding to input. Do not emit a message on stderr in this case but
   // respond on stdout.
-  if (InputString.empty()) {
-    printUnknownLineInfo(ModuleName, Printer);
-    return;
-  }
+  if (InputString.empty())
+    return [](DIPrinter &Printer) { printUnknownLineInfo("", Printer); };
   if (Error E = parseCommand(Args.getLastArgValue(OPT_obj_EQ), IsAddr2Line,
                              StringRef(InputString), Cmd, ModuleName, BuildID,
                              Symbol, Offset)) {
-    handleAllErrors(std::move(E), [&](const StringError &EI) {
-      printError(EI, InputString);
-      printUnknownLineInfo(ModuleName, Printer);
-    });
-    return;
+    return [E = std::move(E), InputString = InputString.str(),
+            ModuleName](DIPrinter &Printer) mutable {
+      handleAllErrors(std::move(E), [&](const StringError &EI) {
+        printError(EI, InputString);
+        printUnknownLineInfo(ModuleName, Printer);
+      });
+    };
   }
   bool ShouldInline = Args.hasFlag(OPT_inlines, OPT_no_inlines, !IsAddr2Line);
   if (!BuildID.empty()) {
@@ -360,12 +382,54 @@ static void symbolizeInput(const opt::InputArgList &Args,
     if (!Args.hasArg(OPT_no_debuginfod))
       enableDebuginfod(Symbolizer, Args);
     std::string BuildIDStr = toHex(BuildID);
-    executeCommand(BuildIDStr, BuildID, Cmd, Symbol, Offset, AdjustVMA,
-                   ShouldInline, Style, Symbolizer, Printer);
-  } else {
-    executeCommand(ModuleName, ModuleName, Cmd, Symbol, Offset, AdjustVMA,
-                   ShouldInline, Style, Symbolizer, Printer);
+    return executeCommand(BuildIDStr, BuildID, Cmd, Symbol, Offset, AdjustVMA,
+                          ShouldInline, Style, Symbolizer);
   }
+  return executeCommand(ModuleName, ModuleName, Cmd, Symbol, Offset, AdjustVMA,
+                        ShouldInline, Style, Symbolizer);
+}
+
+/// Symbolize Inputs with one symbolizer per thread, and print the results in
+/// input order. The inputs of a module all go to the same symbolizer, so that
+/// each module is loaded and cached by a single thread.
+static void symbolizeBatch(const opt::InputArgList &Args,
+                           object::BuildIDRef BuildID, uint64_t AdjustVMA,
+                           bool IsAddr2Line, OutputStyle Style,
+                           ArrayRef<std::string> Inputs,
+                           ArrayRef<LLVMSymbolizer *> Symbolizers,
+                           DIPrinter &Printer) {
+  std::vector<std::vector<size_t>> Shards(Symbolizers.size());
+  for (size_t I = 0; I != Inputs.size(); ++I) {
+    Command Cmd;
+    std::string ModuleName;
+    object::BuildID InputBuildID(BuildID.begin(), BuildID.end());
+    StringRef Symbol;
+    uint64_t Offset = 0;
+    size_t Shard = 0;
+    if (Error E = parseCommand(Args.getLastArgValue(OPT_obj_EQ), IsAddr2Line,
+                               Inputs[I], Cmd, ModuleName, InputBuildID, Symbol,
+                               Offset))
+      consumeError(std::move(E));
+    else
+      Shard = hash_combine(ModuleName, hash_combine_range(InputBuildID.begin(),
+                                                          InputBuildID.end())) %
+              Shards.size();
+    Shards[Shard].push_back(I);
+  }
+
+  std::vector<DeferredPrint> Results(Inputs.size());
+  DefaultThreadPool Pool(hardware_concurrency(Symbolizers.size()));
+  for (size_t Shard = 0; Shard != Shards.size(); ++Shard)
+    if (!Shards[Shard].empty())
+      Pool.async([&, Shard]() {
+        for (size_t I : Shards[Shard])
+          Results[I] = symbolizeInput(Args, BuildID, AdjustVMA, IsAddr2Line,
+                                      Style, Inputs[I], *Symbolizers[Shard]);
+      });
+  Pool.wait();
+
+  for (DeferredPrint &Result : Results)
+    Result(Printer);
 }
 
 static void printHelp(StringRef ToolName, const SymbolizerOptTable &Tbl,
@@ -533,6 +597,18 @@ int llvm_symbolizer_main(int argc, char **argv, const llvm::ToolContext &) {
   if (Args.hasFlag(OPT_debuginfod, OPT_no_debuginfod, canUseDebuginfod()))
     enableDebuginfod(Symbolizer, Args);
 
+  // Each thread has its own symbolizer, and so its own binary cache.
+  unsigned NumThreads;
+  parseIntArg(Args, OPT_threads_EQ, NumThreads);
+  std::vector<std::unique_ptr<LLVMSymbolizer>> ThreadSymbolizers;
+  std::vector<LLVMSymbolizer *> Symbolizers = {&Symbolizer};
+  for (unsigned I = 1; I < NumThreads; ++I) {
+    ThreadSymbolizers.push_back(std::make_unique<LLVMSymbolizer>(Opts));
+    if (Args.hasFlag(OPT_debuginfod, OPT_no_debuginfod, canUseDebuginfod()))
+      enableDebuginfod(*ThreadSymbolizers.back(), Args);
+    Symbolizers.push_back(ThreadSymbolizers.back().get());
+  }
+
   if (Args.hasArg(OPT_filter_markup)) {
     filterMarkup(Args, Symbolizer);
     return 0;
@@ -581,20 +657,32 @@ int llvm_symbolizer_main(int argc, char **argv, const llvm::ToolContext &) {
     const int kMaxInputStringLength = 1024;
     char InputString[kMaxInputStringLength];
 
+    std::vector<std::string> Batch;
     while (fgets(InputString, sizeof(InputString), stdin)) {
       // Strip newline characters.
       std::string StrippedInputString(InputString);
       llvm::erase_if(StrippedInputString,
                      [](char c) { return c == '\r' || c == '\n'; });
+      if (Symbolizers.size() > 1) {
+        Batch.push_back(std::move(StrippedInputString));
+        continue;
+      }
       symbolizeInput(Args, BuildID, AdjustVMA, IsAddr2Line, Style,
-                     StrippedInputString, Symbolizer, *Printer);
+                     StrippedInputString, Symbolizer)(*Printer);
       outs().flush();
     }
+    if (!Batch.empty())
+      symbolizeBatch(Args, BuildID, AdjustVMA, IsAddr2Line, Style, Batch,
+                     Symbolizers, *Printer);
   } else {
     Printer->listBegin();
-    for (StringRef Address : InputAddresses)
-      symbolizeInput(Args, BuildID, AdjustVMA, IsAddr2Line, Style, Address,
-                     Symbolizer, *Printer);
+    if (Symbolizers.size() > 1)
+      symbolizeBatch(Args, BuildID, AdjustVMA, IsAddr2Line, Style,
+                     InputAddresses, Symbolizers, *Printer);
+    else
+      for (StringRef Address : InputAddresses)
+        symbolizeInput(Args, BuildID, AdjustVMA, IsAddr2Line, Style, Address,
+                       Symbolizer)(*Printer);
     Printer->listEnd();
   }
 
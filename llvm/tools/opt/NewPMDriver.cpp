@@ -13,12 +13,16 @@
 //===----------------------------------------------------------------------===//
 
 #include "NewPMDriver.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Analysis/AliasAnalysis.h"
 #include "llvm/Analysis/CGSCCPassManager.h"
 #include "llvm/Analysis/TargetLibraryInfo.h"
 #include "llvm/Bitcode/BitcodeWriterPass.h"
+#include "llvm/CAS/ActionCache.h"
+#include "llvm/CAS/ObjectStore.h"
 #include "llvm/Config/llvm-config.h"
 #include "llvm/IR/Dominators.h"
 #include "llvm/IR/LLVMContext.h"
@@ -26,14 +30,18 @@
 #include "llvm/IR/PassManager.h"
 #include "llvm/IR/Verifier.h"
 #include "llvm/IRPrinter/IRPrintingPasses.h"
+#include "llvm/MC/TargetRegistry.h"
 #include "llvm/Passes/PassBuilder.h"
 #include "llvm/Passes/PassPlugin.h"
 #include "llvm/Passes/StandardInstrumentations.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/StringSaver.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/VirtualFileSystem.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Target/TargetMachine.h"
+#include "llvm/Transforms/IPO/ParallelFunctionOptimizer.h"
 #include "llvm/Transforms/IPO/ThinLTOBitcodeWriter.h"
 #include "llvm/Transforms/Instrumentation/AddressSanitizer.h"
 #include "llvm/Transforms/Scalar/LoopPassManager.h"
@@ -89,6 +97,29 @@ static cl::opt<std::string>
                         "pipeline for handling managed aliasing queries"),
                cl::Hidden, cl::init("default"));
 
+static cl::opt<std::string> ParallelFunctionPipeline(
+    "parallel-function-passes",
+    cl::desc("A textual description of a function pass pipeline to run on "
+             "several threads after the -passes pipeline"),
+    cl::Hidden);
+static cl::opt<unsigned> ParallelFunctionPartitions(
+    "parallel-function-partitions",
+    cl::desc("The number of partitions to split the functions into for "
+             "-parallel-function-passes (default: the number of hardware "
+             "threads)"),
+    cl::Hidden, cl::init(0));
+static cl::opt<std::string> FunctionPipelineCachePath(
+    "function-pipeline-cache",
+    cl::desc("A directory in which -parallel-function-passes caches the "
+             "functions it optimized, to reuse them in later runs"),
+    cl::Hidden);
+
+static cl::opt<bool> TrackAnalysisInvalidation(
+    "track-analysis-invalidation",
+    cl::desc("Print how often every analysis was computed, reused and "
+             "invalidated, and how often it had to be recomputed"),
+    cl::Hidden);
+
 /// {{@ These options accept textual pipeline descriptions which will be
 /// inserted into default pipelines at the respective extension points
 static cl::opt<std::string> PeepholeEPPipeline(
@@ -333,6 +364,47 @@ static void registerEPCallbacks(PassBuilder &PB) {
   llvm::PassPluginLibraryInfo get##Ext##PluginInfo();
 #include "llvm/Support/Extension.def"
 
+// Appends the options given on the command line to the key of the function
+// pipeline cache. Any of them, e.g. -vector-library or a pass's cl::opt, may
+// change the result of the pipeline, so only the positional input and the
+// options that cannot change the optimized functions are left out.
+static void addCommandLineToKey(raw_ostream &OS,
+                                ArrayRef<const char *> CommandLine) {
+  static constexpr StringLiteral Ignored[] = {
+      "o", "thin-link-bitcode-file", "pass-remarks-output",
+      "function-pipeline-cache", "parallel-function-partitions"};
+  BumpPtrAllocator Alloc;
+  StringSaver Saver(Alloc);
+  SmallVector<const char *, 0> Args;
+  // Like the parser, look at the options in response files.
+  if (CommandLine.empty() ||
+      !cl::expandResponseFiles(CommandLine.size(), CommandLine.data(),
+                               /*EnvVar=*/nullptr, Saver, Args))
+    return;
+  StringMap<cl::Option *> &Options = cl::getRegisteredOptions();
+  for (size_t I = 0; I < Args.size(); ++I) {
+    StringRef Arg = Args[I];
+    if (Arg == "--")
+      break;
+    if (!Arg.consume_front("-"))
+      continue;
+    Arg.consume_front("-");
+    StringRef Name = Arg.split('=').first;
+    cl::Option *O = Options.lookup(Name);
+    // The value of an option like -o is the next argument.
+    bool HasNextValue = O && Name.size() == Arg.size() &&
+                        O->getValueExpectedFlag() == cl::ValueRequired &&
+                        I + 1 < Args.size();
+    if (is_contained(Ignored, Name)) {
+      I += HasNextValue;
+      continue;
+    }
+    OS << ";-" << Arg;
+    if (HasNextValue)
+      OS << ' ' << Args[++I];
+  }
+}
+
 bool llvm::runPassPipeline(
     StringRef Arg0, Module &M, TargetMachine *TM, TargetLibraryInfoImpl *TLII,
     ToolOutputFile *Out, ToolOutputFile *ThinLTOLinkOut,
@@ -342,7 +414,7 @@ bool llvm::runPassPipeline(
     OutputKind OK, VerifierKind VK, bool ShouldPreserveAssemblyUseListOrder,
     bool ShouldPreserveBitcodeUseListOrder, bool EmitSummaryIndex,
     bool EmitModuleHash, bool EnableDebugify, bool VerifyDIPreserve,
-    bool UnifiedLTO) {
+    bool UnifiedLTO, ArrayRef<const char *> CommandLine) {
   auto FS = vfs::getRealFileSystem();
   std::optional<PGOOptions> P;
   switch (PGOKindFlag) {
@@ -398,11 +470,20 @@ bool llvm::runPassPipeline(
   if (TM)
     TM->setPGOOption(P);
 
+  // Declared first as the analysis managers use it until destroyed.
+  AnalysisInvalidationTracker InvalidationTracker;
   LoopAnalysisManager LAM;
   FunctionAnalysisManager FAM;
   CGSCCAnalysisManager CGAM;
   ModuleAnalysisManager MAM;
 
+  if (TrackAnalysisInvalidation) {
+    LAM.setInvalidationTracker(&InvalidationTracker);
+    FAM.setInvalidationTracker(&InvalidationTracker);
+    CGAM.setInvalidationTracker(&InvalidationTracker);
+    MAM.setInvalidationTracker(&InvalidationTracker);
+  }
+
   PassInstrumentationCallbacks PIC;
   PrintPassOptions PrintPassOpts;
   PrintPassOpts.Verbose = DebugPM == DebugLogging::Verbose;
@@ -481,6 +562,80 @@ bool llvm::runPassPipeline(
     }
   }
 
+  std::unique_ptr<cas::ObjectStore> CacheObjects;
+  std::unique_ptr<cas::ActionCache> CacheActions;
+  std::optional<FunctionPipelineCache> PipelineCache;
+  if (!ParallelFunctionPipeline.empty()) {
+    // Check the pipeline here, every thread parses it again.
+    FunctionPassManager FPM;
+    if (auto Err = PB.parsePassPipeline(FPM, ParallelFunctionPipeline)) {
+      errs() << Arg0 << ": " << toString(std::move(Err)) << "\n";
+      return false;
+    }
+    unsigned NumPartitions = ParallelFunctionPartitions;
+    if (!NumPartitions)
+      NumPartitions = hardware_concurrency().compute_thread_count();
+    if (!FunctionPipelineCachePath.empty()) {
+      Error Err = cas::ObjectStore::open(FunctionPipelineCachePath)
+                      .moveInto(CacheObjects);
+      if (!Err)
+        Err = cas::ActionCache::open(FunctionPipelineCachePath)
+                  .moveInto(CacheActions);
+      if (Err) {
+        errs() << Arg0 << ": " << toString(std::move(Err)) << "\n";
+        return false;
+      }
+      // Everything besides the function that the pipeline's result depends on.
+      std::string Key;
+      raw_string_ostream KeyOS(Key);
+      KeyOS << "version=" << LLVM_VERSION_STRING
+            << ";passes=" << ParallelFunctionPipeline << ";aa=" << AAPipeline;
+      if (TM)
+        KeyOS << ";cpu=" << TM->getTargetCPU()
+              << ";features=" << TM->getTargetFeatureString()
+              << ";opt-level=" << int(TM->getOptLevel());
+      // The library functions the passes may assume, e.g. all of them are
+      // unavailable with -disable-simplify-libcalls.
+      TargetLibraryInfo TLI(*TLII);
+      KeyOS << ";libfuncs=";
+      for (unsigned F = 0; F != NumLibFuncs; ++F)
+        KeyOS << TLI.getName(LibFunc(F)) << ',';
+      addCommandLineToKey(KeyOS, CommandLine);
+      PipelineCache.emplace(
+          FunctionPipelineCache{*CacheObjects, *CacheActions, Key});
+    }
+    MPM.addPass(ParallelFunctionOptimizerPass(NumPartitions, [=](Module &M) {
+      // Target machines, pass builders and analysis managers cannot be shared
+      // between threads.
+      std::unique_ptr<TargetMachine> PartTM;
+      if (TM)
+        PartTM.reset(TM->getTarget().createTargetMachine(
+            TM->getTargetTriple().str(), TM->getTargetCPU(),
+            TM->getTargetFeatureString(), TM->Options,
+            TM->getRelocationModel(), TM->getCodeModel(), TM->getOptLevel()));
+      PassBuilder PartPB(PartTM.get(), PTO);
+      LoopAnalysisManager PartLAM;
+      FunctionAnalysisManager PartFAM;
+      CGSCCAnalysisManager PartCGAM;
+      ModuleAnalysisManager PartMAM;
+      AAManager AA;
+      cantFail(PartPB.parseAAPipeline(AA, AAPipeline));
+      PartFAM.registerPass([&] { return std::move(AA); });
+      PartFAM.registerPass([&] { return TargetLibraryAnalysis(*TLII); });
+      PartPB.registerModuleAnalyses(PartMAM);
+      PartPB.registerCGSCCAnalyses(PartCGAM);
+      PartPB.registerFunctionAnalyses(PartFAM);
+      PartPB.registerLoopAnalyses(PartLAM);
+      PartPB.crossRegisterProxies(PartLAM, PartFAM, PartCGAM, PartMAM);
+
+      FunctionPassManager PartFPM;
+      cantFail(PartPB.parsePassPipeline(PartFPM, ParallelFunctionPipeline));
+      ModulePassManager PartMPM;
+      PartMPM.addPass(createModuleToFunctionPassAdaptor(std::move(PartFPM)));
+      PartMPM.run(M, PartMAM);
+    }, PipelineCache ? &*PipelineCache : nullptr));
+  }
+
   if (VK != VerifierKind::None)
     MPM.addPass(VerifierPass());
   if (EnableDebugify)
@@ -540,6 +695,9 @@ bool llvm::runPassPipeline(
   // Now that we have all of the passes ready, run them.
   MPM.run(M, MAM);
 
+  if (TrackAnalysisInvalidation)
+    InvalidationTracker.print(errs());
+
   // Declare success.
   if (OK != OK_NoOutput) {
     Out->keep();
@@ -42,6 +42,7 @@
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/HotPathTrace.h"
 #include "llvm/Support/InitLLVM.h"
 #include "llvm/Support/PluginLoader.h"
 #include "llvm/Support/SourceMgr.h"
@@ -247,6 +248,12 @@ static cl::opt<std::string>
                   cl::desc("Specify time trace file destination"),
                   cl::value_desc("filename"));
 
+static cl::opt<std::string> HotPathTraceFile(
+    "hot-path-trace-file",
+    cl::desc("Record the events of the hot path tracer and write them to the "
+             "given file. Requires LLVM_ENABLE_HOT_PATH_TRACE"),
+    cl::value_desc("filename"), cl::Hidden);
+
 static cl::opt<bool> RemarksWithHotness(
     "pass-remarks-with-hotness",
     cl::desc("With PGO, include profile count in optimization remarks"),
@@ -299,8 +306,15 @@ struct TimeTracerRAII {
   TimeTracerRAII(StringRef ProgramName) {
     if (TimeTrace)
       timeTraceProfilerInitialize(TimeTraceGranularity, ProgramName);
+    if (!HotPathTraceFile.empty())
+      hotPathTraceEnable();
   }
   ~TimeTracerRAII() {
+    if (!HotPathTraceFile.empty()) {
+      hotPathTraceDisable();
+      if (Error E = hotPathTraceWrite(HotPathTraceFile))
+        errs() << toString(std::move(E)) << "\n";
+    }
     if (TimeTrace) {
       if (auto E = timeTraceProfilerWrite(TimeTraceFile, OutputFilename)) {
         handleAllErrors(std::move(E), [&](const StringError &SE) {
@@ -741,7 +755,8 @@ extern "C" int optMain(
                RemarksFile.get(), Pipeline, PluginList, PassBuilderCallbacks,
                OK, VK, PreserveAssemblyUseListOrder,
                PreserveBitcodeUseListOrder, EmitSummaryIndex, EmitModuleHash,
-               EnableDebugify, VerifyDebugInfoPreserve, UnifiedLTO)
+               EnableDebugify, VerifyDebugInfoPreserve, UnifiedLTO,
+               ArrayRef<const char *>(argv, argc))
                ? 0
                : 1;
   }
@@ -0,0 +1,101 @@
+//===- ConcurrentStringMapTest.cpp ----------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/ConcurrentStringMap.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/Parallel.h"
+#include "gtest/gtest.h"
+#include <atomic>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+namespace {
+
+TEST(ConcurrentStringMapTest, InsertAndFind) {
+  ConcurrentStringMap<unsigned> Map(10);
+
+  // PerThreadBumpPtrAllocator should be accessed from threads created by
+  // ThreadPoolExecutor. Use TaskGroup to run on ThreadPoolExecutor threads.
+  parallel::TaskGroup TG;
+  TG.spawn([&]() {
+    EXPECT_TRUE(Map.empty());
+    EXPECT_EQ(nullptr, Map.find("a"));
+
+    std::string Key = "a";
+    auto [Entry, Inserted] = Map.insert(Key);
+    EXPECT_TRUE(Inserted);
+    EXPECT_EQ(0u, Entry->getValue());
+    Entry->getValue() = 1;
+    // The key is copied into the entry.
+    Key = "b";
+    EXPECT_EQ("a", Entry->getKey());
+
+    EXPECT_FALSE(Map.insert("a").second);
+    EXPECT_EQ(Entry, Map.find("a"));
+    EXPECT_FALSE(Map.contains("b"));
+    Map["b"] = 2;
+    EXPECT_EQ(2u, Map.find("b")->getValue());
+    EXPECT_EQ(1u, Map["a"]);
+    EXPECT_EQ(2u, Map.size());
+  });
+}
+
+TEST(ConcurrentStringMapTest, ParallelInsert) {
+  const size_t NumElements = 20000;
+  using MapTy = ConcurrentStringMap<std::atomic<unsigned>>;
+  MapTy Map(100);
+
+  // Every element is inserted by several tasks; all of them must get the same
+  // entry.
+  std::vector<std::atomic<MapTy::EntryTy *>> Entries(NumElements);
+  parallelFor(0, 4 * NumElements, [&](size_t I) {
+    size_t Element = I % NumElements;
+    std::string Key = formatv("{0}", Element);
+    auto *Entry = Map.insert(Key).first;
+    EXPECT_EQ(Key, Entry->getKey());
+    Entry->getValue().fetch_add(1);
+    decltype(Entry) Expected = nullptr;
+    if (!Entries[Element].compare_exchange_strong(Expected, Entry))
+      EXPECT_EQ(Expected, Entry);
+  });
+
+  EXPECT_EQ(NumElements, Map.size());
+  for (size_t I = 0; I != NumElements; ++I) {
+    auto *Entry = Map.find(formatv("{0}", I).str());
+    ASSERT_NE(nullptr, Entry);
+    EXPECT_EQ(Entries[I].load(), Entry);
+    EXPECT_EQ(4u, Entry->getValue().load());
+  }
+}
+
+TEST(ConcurrentStringMapTest, StringPool) {
+  ConcurrentStringPool Pool;
+  parallel::TaskGroup TG;
+  TG.spawn([&]() {
+    std::string A = "foo";
+    StringRef S = Pool.save(A);
+    EXPECT_EQ("foo", S);
+    EXPECT_NE(A.data(), S.data());
+    EXPECT_EQ(S.data(), Pool.save("foo").data());
+    EXPECT_EQ(S.data(), Pool.lookup("foo")->data());
+    EXPECT_EQ(std::nullopt, Pool.lookup("bar"));
+  });
+  TG.sync();
+
+  std::vector<StringRef> Saved(1000);
+  parallelFor(0, Saved.size(), [&](size_t I) {
+    Saved[I] = Pool.save(formatv("str{0}", I % 100).str());
+  });
+  EXPECT_EQ(101u, Pool.size());
+  for (size_t I = 0; I != Saved.size(); ++I)
+    EXPECT_EQ(Saved[I % 100].data(), Saved[I].data());
+}
+
+} // namespace
@@ -0,0 +1,171 @@
+//===- llvm/unittest/ADT/FlatHashMapTest.cpp - FlatHashMap unit tests -----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/FlatHashMap.h"
+#include "llvm/ADT/StringRef.h"
+#include "gtest/gtest.h"
+#include <map>
+#include <memory>
+#include <string>
+
+using namespace llvm;
+
+namespace {
+
+TEST(FlatHashMapTest, EmptyMap) {
+  FlatHashMap<int, int> M;
+  EXPECT_TRUE(M.empty());
+  EXPECT_EQ(0u, M.size());
+  EXPECT_EQ(0u, M.getMemorySize());
+  EXPECT_TRUE(M.begin() == M.end());
+  EXPECT_FALSE(M.contains(0));
+  EXPECT_EQ(0u, M.count(0));
+  EXPECT_TRUE(M.find(0) == M.end());
+  EXPECT_EQ(0, M.lookup(0));
+  EXPECT_FALSE(M.erase(0));
+}
+
+TEST(FlatHashMapTest, InsertFindErase) {
+  FlatHashMap<int, int> M;
+  auto [I, Inserted] = M.insert({1, 10});
+  EXPECT_TRUE(Inserted);
+  EXPECT_EQ(1, I->first);
+  EXPECT_EQ(10, I->second);
+  EXPECT_FALSE(M.insert({1, 20}).second);
+  EXPECT_EQ(10, M.at(1));
+  EXPECT_EQ(1u, M.size());
+
+  M[2] = 20;
+  EXPECT_EQ(20, M.lookup(2));
+  EXPECT_FALSE(M.insert_or_assign(2, 30).second);
+  EXPECT_EQ(30, M.lookup(2));
+  EXPECT_TRUE(M.try_emplace(3, 40).second);
+  EXPECT_EQ(3u, M.size());
+
+  EXPECT_TRUE(M.erase(1));
+  EXPECT_FALSE(M.erase(1));
+  EXPECT_FALSE(M.contains(1));
+  M.erase(M.find(2));
+  EXPECT_EQ(1u, M.size());
+  EXPECT_EQ(40, M.lookup(3));
+}
+
+// Compare against std::map while growing, erasing and reinserting.
+TEST(FlatHashMapTest, MatchesStdMap) {
+  FlatHashMap<uint64_t, uint64_t> M;
+  std::map<uint64_t, uint64_t> Ref;
+  uint64_t State = 1;
+  for (unsigned I = 0; I != 20000; ++I) {
+    State = State * 6364136223846793005 + 1442695040888963407;
+    uint64_t Key = (State >> 33) % 4096;
+    if (State & (1 << 20)) {
+      EXPECT_EQ(Ref.erase(Key) != 0, M.erase(Key));
+    } else {
+      M[Key] = I;
+      Ref[Key] = I;
+    }
+    ASSERT_EQ(Ref.size(), M.size());
+  }
+  for (auto &[K, V] : Ref)
+    EXPECT_EQ(V, M.lookup(K));
+  unsigned NumVisited = 0;
+  for (auto &[K, V] : M) {
+    EXPECT_EQ(Ref[K], V);
+    ++NumVisited;
+  }
+  EXPECT_EQ(Ref.size(), NumVisited);
+}
+
+// Insert/erase churn at a stable size must not grow the table.
+TEST(FlatHashMapTest, NoGrowthUnderChurn) {
+  FlatHashMap<unsigned, unsigned> M;
+  for (unsigned I = 0; I != 1000; ++I)
+    M[I] = I;
+  size_t NumBuckets = M.getNumBuckets();
+  for (unsigned I = 1000; I != 100000; ++I) {
+    EXPECT_TRUE(M.erase(I - 1000));
+    M[I] = I;
+  }
+  EXPECT_EQ(1000u, M.size());
+  EXPECT_EQ(NumBuckets, M.getNumBuckets());
+  for (unsigned I = 99000; I != 100000; ++I)
+    EXPECT_EQ(I, M.lookup(I));
+}
+
+TEST(FlatHashMapTest, Reserve) {
+  FlatHashMap<int, int> M(100);
+  size_t MemorySize = M.getMemorySize();
+  EXPECT_LE(100u, M.getNumBuckets() - M.getNumBuckets() / 8);
+  for (int I = 0; I != 100; ++I)
+    M[I] = I;
+  EXPECT_EQ(MemorySize, M.getMemorySize());
+}
+
+TEST(FlatHashMapTest, Clear) {
+  FlatHashMap<int, std::string> M;
+  for (int I = 0; I != 10; ++I)
+    M[I] = std::to_string(I);
+  M.clear();
+  EXPECT_TRUE(M.empty());
+  EXPECT_TRUE(M.begin() == M.end());
+  M[1] = "one";
+  EXPECT_EQ("one", M.lookup(1));
+}
+
+TEST(FlatHashMapTest, CopyAndMove) {
+  FlatHashMap<int, std::string> M;
+  for (int I = 0; I != 100; ++I)
+    M[I] = std::to_string(I);
+
+  FlatHashMap<int, std::string> Copy(M);
+  EXPECT_EQ(M, Copy);
+  Copy[0] = "zero";
+  EXPECT_NE(M, Copy);
+
+  FlatHashMap<int, std::string> Moved(std::move(Copy));
+  EXPECT_TRUE(Copy.empty());
+  EXPECT_EQ("zero", Moved.lookup(0));
+
+  Copy = M;
+  EXPECT_EQ(M, Copy);
+  Moved = std::move(Copy);
+  EXPECT_EQ(M, Moved);
+
+  Moved.swap(Copy);
+  EXPECT_TRUE(Moved.empty());
+  EXPECT_EQ(M, Copy);
+}
+
+TEST(FlatHashMapTest, MoveOnlyValues) {
+  FlatHashMap<int, std::unique_ptr<int>> M;
+  for (int I = 0; I != 100; ++I)
+    M.try_emplace(I, std::make_unique<int>(I));
+  for (int I = 0; I != 100; I += 2)
+    M.erase(I);
+  for (int I = 1; I < 100; I += 2)
+    EXPECT_EQ(I, *M.find(I)->second);
+}
+
+TEST(FlatHashMapTest, StringRefKeys) {
+  FlatHashMap<StringRef, int> M = {{"a", 1}, {"b", 2}};
+  std::string Key = "a";
+  EXPECT_EQ(1, M.lookup(Key));
+  EXPECT_EQ(2u, M.size());
+  EXPECT_TRUE(M.find_as(StringRef("b")) != M.end());
+}
+
+TEST(FlatHashMapTest, ConstIterator) {
+  FlatHashMap<int, int> M = {{1, 2}};
+  const auto &CM = M;
+  FlatHashMap<int, int>::const_iterator I = M.begin();
+  EXPECT_TRUE(I == CM.begin());
+  EXPECT_TRUE(CM.find(1) == I);
+  EXPECT_EQ(2, I->second);
+}
+
+} // namespace
@@ -164,4 +164,20 @@ TEST_F(ImmutableSetTest, IterLongSetTest) {
   ASSERT_EQ(6, i);
 }
 
+TEST_F(ImmutableSetTest, CanonicalizeTest) {
+  ImmutableSet<int>::Factory f;
+  ImmutableSet<int> S = f.getEmptySet();
+
+  // Equal sets share their root, whatever order they were built in.
+  for (int i = 0; i < 100; ++i) {
+    ImmutableSet<int> S2 = f.add(f.add(f.add(S, i), i + 1), i + 2);
+    ImmutableSet<int> S3 = f.add(f.add(f.add(S, i + 2), i), i + 1);
+    ImmutableSet<int> S4 = f.remove(f.add(S3, i + 3), i + 3);
+    EXPECT_EQ(S2.getRootWithoutRetain(), S3.getRootWithoutRetain());
+    EXPECT_EQ(S2.getRootWithoutRetain(), S4.getRootWithoutRetain());
+    EXPECT_TRUE(S4.contains(i + 1));
+    // The trees are freed here and have to be dropped from the cache.
+  }
+}
+
 }
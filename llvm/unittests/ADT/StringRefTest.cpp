@@ -566,6 +566,40 @@ TEST(StringRefTest, Count) {
   EXPECT_EQ(2U, ComplexAbba.count("abba"));
 }
 
+// Compare against std::string_view on strings long enough for the vectorized
+// paths, with matches at every offset relative to the 16-byte blocks.
+TEST(StringRefTest, LongStringSearch) {
+  std::string Text;
+  uint64_t State = 1;
+  for (unsigned I = 0; I != 4000; ++I) {
+    State = State * 6364136223846793005 + 1442695040888963407;
+    Text += "abcd\n "[(State >> 33) % 6];
+  }
+  // More than 255 blocks of matches, to overflow the 8-bit counters.
+  Text += std::string(5000, '\n');
+  StringRef Str(Text);
+  std::string_view View(Text);
+
+  for (char C : {'a', '\n', ' ', 'z'})
+    EXPECT_EQ(size_t(llvm::count(Text, C)), Str.count(C));
+
+  for (StringRef Needle : {"ab", "d\n", "abc", "cab", "dd\n a", "aaaa", "zz",
+                           "\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n"}) {
+    for (size_t From : {0, 1, 7, 15, 16, 17, 3999, 4000, 8999, 9000, 9001}) {
+      EXPECT_EQ(View.find(Needle, From), Str.find(Needle, From))
+          << Needle << " from " << From;
+    }
+    EXPECT_EQ(StringRef::npos, Str.substr(0, 4000).find("z" + Needle.str()));
+  }
+
+  for (StringRef Chars : {"d", "\nd", "cd\n", "c d\n", "zy", "bcd\n "}) {
+    for (size_t From : {0, 5, 16, 100, 8999, 9000, 9001}) {
+      EXPECT_EQ(View.find_first_of(Chars, From), Str.find_first_of(Chars, From))
+          << Chars << " from " << From;
+    }
+  }
+}
+
 TEST(StringRefTest, EditDistance) {
   StringRef Hello("hello");
   EXPECT_EQ(2U, Hello.edit_distance("hill"));
@@ -11,13 +11,16 @@
 #include "llvm/Analysis/AssumptionCache.h"
 #include "llvm/Analysis/BasicAliasAnalysis.h"
 #include "llvm/Analysis/TargetLibraryInfo.h"
+#include "llvm/Analysis/TargetTransformInfo.h"
 #include "llvm/AsmParser/Parser.h"
 #include "llvm/IR/Constants.h"
+#include "llvm/IR/Dominators.h"
 #include "llvm/IR/InstIterator.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/Module.h"
+#include "llvm/IR/PassInstrumentation.h"
 #include "llvm/InitializePasses.h"
 #include "llvm/Support/SourceMgr.h"
 #include "gtest/gtest.h"
@@ -296,6 +299,58 @@ TEST_F(AliasAnalysisTest, BatchAAPhiAssumption) {
   EXPECT_EQ(AliasResult::MayAlias, BatchAA.alias(ANextLoc, BNextLoc));
 }
 
+TEST_F(AliasAnalysisTest, QueryCacheInvalidation) {
+  LLVMContext C;
+  SMDiagnostic Err;
+  std::unique_ptr<Module> M = parseAssemblyString(R"(
+    define void @f(ptr %p) {
+      %q = getelementptr i8, ptr %p, i64 1
+      ret void
+    }
+  )", Err, C);
+
+  Function *F = M->getFunction("f");
+  MemoryLocation PLoc(F->getArg(0), LocationSize::precise(1));
+  MemoryLocation QLoc(getInstructionByName(*F, "q"), LocationSize::precise(1));
+
+  FunctionAnalysisManager FAM;
+  FAM.registerPass([] {
+    AAManager AA;
+    AA.registerFunctionAnalysis<BasicAA>();
+    return AA;
+  });
+  FAM.registerPass([] { return AAQueryCacheAnalysis(); });
+  FAM.registerPass([] { return AssumptionAnalysis(); });
+  FAM.registerPass([] { return BasicAA(); });
+  FAM.registerPass([] { return DominatorTreeAnalysis(); });
+  FAM.registerPass([] { return PassInstrumentationAnalysis(); });
+  FAM.registerPass([] { return TargetIRAnalysis(); });
+  FAM.registerPass([] { return TargetLibraryAnalysis(); });
+
+  BatchAAResults &BatchAA =
+      FAM.getResult<AAQueryCacheAnalysis>(*F).getBatchAA();
+  EXPECT_EQ(AliasResult::NoAlias, BatchAA.alias(PLoc, QLoc));
+
+  // The cache survives passes that do not change the function.
+  FAM.invalidate(*F, PreservedAnalyses::all());
+  auto *Cache = FAM.getCachedResult<AAQueryCacheAnalysis>(*F);
+  ASSERT_TRUE(Cache);
+  EXPECT_EQ(&Cache->getBatchAA(), &BatchAA);
+
+  // Preserving the CFG does not preserve the cache.
+  PreservedAnalyses PA;
+  PA.preserveSet<CFGAnalyses>();
+  FAM.invalidate(*F, PA);
+  EXPECT_FALSE(FAM.getCachedResult<AAQueryCacheAnalysis>(*F));
+
+  // Neither does preserving it, if the AA results are invalidated.
+  FAM.getResult<AAQueryCacheAnalysis>(*F);
+  PA = PreservedAnalyses::none();
+  PA.preserve<AAQueryCacheAnalysis>();
+  FAM.invalidate(*F, PA);
+  EXPECT_FALSE(FAM.getCachedResult<AAQueryCacheAnalysis>(*F));
+}
+
 // Check that two aliased GEPs with non-constant offsets are correctly
 // analyzed and their relative offset can be requested from AA.
 TEST_F(AliasAnalysisTest, PartialAliasOffset) {
@@ -1546,6 +1546,75 @@ TEST_F(MemorySSATest, TestLoadClobber) {
   EXPECT_EQ(Load2Clobber, Load1Access);
 }
 
+TEST_F(MemorySSATest, TestBatchedClobberQueries) {
+  SMDiagnostic E;
+  auto LocalM = parseAssemblyString("define void @test(ptr %p, i1 %c) {\n"
+                                    "entry:\n"
+                                    "  %p1 = getelementptr i32, ptr %p, i64 1\n"
+                                    "  %p2 = getelementptr i32, ptr %p, i64 2\n"
+                                    "  store i32 0, ptr %p\n"
+                                    "  store i32 1, ptr %p1\n"
+                                    "  store i32 2, ptr %p2\n"
+                                    "  br i1 %c, label %then, label %exit\n"
+                                    "then:\n"
+                                    "  store i32 3, ptr %p1\n"
+                                    "  br label %exit\n"
+                                    "exit:\n"
+                                    "  store i32 4, ptr %p2\n"
+                                    "  store i32 5, ptr %p2\n"
+                                    "  fence seq_cst\n"
+                                    "  store i32 6, ptr %p2\n"
+                                    "  ret void\n"
+                                    "}\n",
+                                    E, C);
+  ASSERT_TRUE(LocalM);
+  F = LocalM->getFunction("test");
+  ASSERT_TRUE(F);
+  setupAnalyses();
+  MemorySSA &MSSA = *Analyses->MSSA;
+  MemorySSAWalker *Walker = Analyses->Walker;
+
+  // Query every location from every def and phi, starting with the latest
+  // ones, so that the walks of later queries run into earlier ones.
+  SmallVector<MemoryLocation> Locs;
+  SmallVector<MemoryAccess *> Starts;
+  for (BasicBlock &BB : *F) {
+    if (MemoryPhi *Phi = MSSA.getMemoryAccess(&BB))
+      Starts.push_back(Phi);
+    for (Instruction &I : BB) {
+      if (auto *SI = dyn_cast<StoreInst>(&I))
+        Locs.push_back(MemoryLocation::get(SI));
+      if (auto *Def = dyn_cast_or_null<MemoryDef>(MSSA.getMemoryAccess(&I)))
+        Starts.push_back(Def);
+    }
+  }
+  std::reverse(Starts.begin(), Starts.end());
+  SmallVector<MemoryAccessPair> Queries;
+  for (MemoryAccess *Start : Starts)
+    for (const MemoryLocation &Loc : Locs)
+      Queries.emplace_back(Start, Loc);
+
+  SmallVector<MemoryAccess *> Results;
+  Walker->getClobberingMemoryAccesses(Queries, Results);
+  ASSERT_EQ(Results.size(), Queries.size());
+  for (unsigned I = 0; I != Queries.size(); ++I)
+    EXPECT_EQ(Results[I], Walker->getClobberingMemoryAccess(
+                              Queries[I].first, Queries[I].second))
+        << "query " << I;
+
+  // The store of 2 clobbers %p2 across the phi, and the fence clobbers
+  // everything.
+  Instruction *Store2 = &*std::next(F->getEntryBlock().begin(), 4);
+  Instruction *Fence = &*std::next(F->back().begin(), 2);
+  Instruction *Store6 = Fence->getNextNode();
+  SmallVector<MemoryAccessPair> PhiQueries = {
+      {MSSA.getMemoryAccess(&F->back()), Locs[2]},
+      {MSSA.getMemoryAccess(Store6), Locs[0]}};
+  Walker->getClobberingMemoryAccesses(PhiQueries, Results);
+  EXPECT_EQ(Results[0], MSSA.getMemoryAccess(Store2));
+  EXPECT_EQ(Results[1], MSSA.getMemoryAccess(Fence));
+}
+
 // We want to test if the location information are retained
 // when the IsGuaranteedLoopInvariant function handles a
 // memory access referring to a pointer defined in the entry
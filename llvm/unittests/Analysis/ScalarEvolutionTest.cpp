@@ -1280,6 +1280,68 @@ TEST_F(ScalarEvolutionsTest, SCEVAddNUW) {
   });
 }
 
+TEST_F(ScalarEvolutionsTest, SCEVUniquing) {
+  LLVMContext C;
+  SMDiagnostic Err;
+  std::unique_ptr<Module> M = parseAssemblyString(
+      "define void @foo(i32 %x, i32 %y, ptr %p) { "
+      "entry: "
+      "  br label %loop "
+      "loop: "
+      "  %iv = phi i32 [ 0, %entry ], [ %iv.next, %loop ] "
+      "  %iv.next = add i32 %iv, 1 "
+      "  %cond = icmp slt i32 %iv.next, %x "
+      "  br i1 %cond, label %loop, label %exit "
+      "exit: "
+      "  ret void "
+      "} ",
+      Err, C);
+
+  ASSERT_TRUE(M && "Could not parse module?");
+  ASSERT_TRUE(!verifyModule(*M) && "Must have been well formed!");
+
+  runWithSE(*M, "foo", [](Function &F, LoopInfo &LI, ScalarEvolution &SE) {
+    const SCEV *X = SE.getSCEV(getArgByName(F, "x"));
+    const SCEV *Y = SE.getSCEV(getArgByName(F, "y"));
+    const SCEV *P = SE.getSCEV(getArgByName(F, "p"));
+    const Loop *L = *LI.begin();
+    Type *I64 = Type::getInt64Ty(F.getContext());
+    Type *I16 = Type::getInt16Ty(F.getContext());
+
+    auto BuildAll = [&] {
+      return SmallVector<const SCEV *>{
+          SE.getConstant(X->getType(), 42),
+          SE.getVScale(I64),
+          SE.getPtrToIntExpr(P, I64),
+          SE.getTruncateExpr(X, I16),
+          SE.getZeroExtendExpr(X, I64),
+          SE.getSignExtendExpr(X, I64),
+          SE.getAddExpr(X, Y),
+          SE.getMulExpr(X, Y),
+          SE.getUDivExpr(X, Y),
+          SE.getAddRecExpr(X, Y, L, SCEV::FlagAnyWrap),
+          SE.getSMaxExpr(X, Y),
+          SE.getUMinExpr(X, Y, /*Sequential=*/true),
+          SE.getUnknown(getArgByName(F, "y"))};
+    };
+    SmallVector<const SCEV *> First = BuildAll();
+
+    // Grow the uniquing set, so that the expressions above are rehashed.
+    for (unsigned I = 0; I != 1000; ++I)
+      SE.getAddExpr(X, SE.getConstant(X->getType(), I));
+
+    SmallVector<const SCEV *> Second = BuildAll();
+    for (unsigned I = 0; I != First.size(); ++I)
+      EXPECT_EQ(First[I], Second[I]) << *First[I];
+
+    // Expressions that differ only in their type or loop are distinct.
+    EXPECT_NE(SE.getZeroExtendExpr(X, I64),
+              SE.getZeroExtendExpr(X, Type::getInt128Ty(F.getContext())));
+    EXPECT_NE(SE.getZeroExtendExpr(X, I64), SE.getSignExtendExpr(X, I64));
+    EXPECT_NE(SE.getSMaxExpr(X, Y), SE.getUMaxExpr(X, Y));
+  });
+}
+
 TEST_F(ScalarEvolutionsTest, SCEVgetRanges) {
   LLVMContext C;
   SMDiagnostic Err;
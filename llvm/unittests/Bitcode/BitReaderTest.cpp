@@ -12,12 +12,15 @@
 #include "llvm/AsmParser/Parser.h"
 #include "llvm/Bitcode/BitcodeReader.h"
 #include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/Bitstream/BitCodeEnums.h"
 #include "llvm/IR/Constants.h"
 #include "llvm/IR/InstrTypes.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Verifier.h"
+#include "llvm/Support/Compression.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/Endian.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/SourceMgr.h"
@@ -433,4 +436,65 @@ TEST(BitReaderTest, AccessMetadataTypeInfo) {
             "!{0, i32}}}}");
 }
 
+TEST(BitReaderTest, CompressedBitcode) {
+  if (!compression::zlib::isAvailable())
+    GTEST_SKIP();
+
+  SmallString<1024> Bitcode;
+  LLVMContext Context;
+  writeModuleToBuffer(parseAssembly(Context, "define void @f() {\n"
+                                             "  unreachable\n"
+                                             "}\n"),
+                      Bitcode);
+
+  SmallString<1024> Compressed;
+  raw_svector_ostream OS(Compressed);
+  writeCompressedBitcode(Bitcode, compression::Format::Zlib, OS);
+  auto *Start = reinterpret_cast<const unsigned char *>(Compressed.begin());
+  auto *End = reinterpret_cast<const unsigned char *>(Compressed.end());
+  EXPECT_TRUE(isCompressedBitcode(Start, End));
+  EXPECT_FALSE(isBitcode(Start, End));
+
+  Expected<std::unique_ptr<MemoryBuffer>> BufferOrErr =
+      decompressBitcode(MemoryBufferRef(Compressed.str(), "test"));
+  ASSERT_FALSE(errorToBool(BufferOrErr.takeError()));
+  EXPECT_EQ((*BufferOrErr)->getBuffer(), Bitcode.str());
+
+  // Truncating the container leaves an invalid compressed stream.
+  Compressed.resize(Compressed.size() - 1);
+  EXPECT_TRUE(errorToBool(
+      decompressBitcode(MemoryBufferRef(Compressed.str(), "test"))
+          .takeError()));
+}
+
+TEST(BitReaderTest, CompressedBitcodeSize) {
+  if (!compression::zlib::isAvailable())
+    GTEST_SKIP();
+
+  SmallString<1024> Bitcode;
+  LLVMContext Context;
+  writeModuleToBuffer(parseAssembly(Context, "define void @f() {\n"
+                                             "  unreachable\n"
+                                             "}\n"),
+                      Bitcode);
+
+  SmallString<1024> Compressed;
+  raw_svector_ostream OS(Compressed);
+  writeCompressedBitcode(Bitcode, compression::Format::Zlib, OS);
+  auto DecompressWithSize = [&](uint64_t Size) {
+    SmallString<1024> Copy = Compressed;
+    support::endian::write64le(&Copy[CBH_SizeField], Size);
+    return errorToBool(
+        decompressBitcode(MemoryBufferRef(Copy.str(), "test")).takeError());
+  };
+
+  EXPECT_FALSE(DecompressWithSize(Bitcode.size()));
+  // The bitcode does not fit in the buffer.
+  EXPECT_TRUE(DecompressWithSize(Bitcode.size() - 1));
+  // The bitcode does not fill the buffer.
+  EXPECT_TRUE(DecompressWithSize(Bitcode.size() + 1));
+  // No zlib stream of this size expands that much, so nothing is allocated.
+  EXPECT_TRUE(DecompressWithSize(uint64_t(1) << 62));
+}
+
 } // end namespace
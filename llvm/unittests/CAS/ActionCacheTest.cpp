@@ -0,0 +1,47 @@
+//===- ActionCacheTest.cpp ------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/CAS/ActionCache.h"
+#include "llvm/CAS/ObjectStore.h"
+#include "llvm/Testing/Support/Error.h"
+#include "llvm/Testing/Support/SupportHelpers.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::cas;
+using llvm::unittest::TempDir;
+
+namespace {
+
+TEST(ActionCacheTest, PutAndGet) {
+  TempDir Dir("cache", /*Unique=*/true);
+  CASID Key = ObjectStore::computeID({}, "clang -c a.c");
+  CASID Result = ObjectStore::computeID({}, "a.o");
+  CASID OtherResult = ObjectStore::computeID({}, "b.o");
+  {
+    std::unique_ptr<ActionCache> Cache;
+    ASSERT_THAT_ERROR(
+        ActionCache::open(Dir.path("cache"), 1 << 20).moveInto(Cache),
+        Succeeded());
+    EXPECT_EQ(std::nullopt, Cache->get(Key));
+    EXPECT_THAT_ERROR(Cache->put(Key, Result), Succeeded());
+    EXPECT_EQ(Result, Cache->get(Key));
+    // Recording the same result again is fine, a different one is not.
+    EXPECT_THAT_ERROR(Cache->put(Key, Result), Succeeded());
+    EXPECT_THAT_ERROR(Cache->put(Key, OtherResult), Failed());
+    EXPECT_EQ(Result, Cache->get(Key));
+  }
+
+  std::unique_ptr<ActionCache> Cache;
+  ASSERT_THAT_ERROR(ActionCache::open(Dir.path("cache")).moveInto(Cache),
+                    Succeeded());
+  EXPECT_EQ(Result, Cache->get(Key));
+  EXPECT_EQ(std::nullopt, Cache->get(Result));
+}
+
+} // namespace
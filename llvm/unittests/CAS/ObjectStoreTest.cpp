@@ -0,0 +1,143 @@
+//===- ObjectStoreTest.cpp ------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/CAS/ObjectStore.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Testing/Support/Error.h"
+#include "llvm/Testing/Support/SupportHelpers.h"
+#include "gtest/gtest.h"
+#include <thread>
+
+using namespace llvm;
+using namespace llvm::cas;
+using llvm::unittest::TempDir;
+
+namespace {
+
+std::unique_ptr<ObjectStore> openStore(const TempDir &Dir) {
+  std::unique_ptr<ObjectStore> CAS;
+  EXPECT_THAT_ERROR(ObjectStore::open(Dir.path("cas"), 16 << 20).moveInto(CAS),
+                    Succeeded());
+  return CAS;
+}
+
+TEST(ObjectStoreTest, StoreAndLoad) {
+  TempDir Dir("cas", /*Unique=*/true);
+  std::unique_ptr<ObjectStore> CAS = openStore(Dir);
+  ASSERT_TRUE(CAS);
+
+  CASID Blob;
+  ASSERT_THAT_ERROR(CAS->store("blob").moveInto(Blob), Succeeded());
+  EXPECT_EQ(ObjectStore::computeID({}, "blob"), Blob);
+  EXPECT_NE(ObjectStore::computeID({}, "blob2"), Blob);
+
+  std::optional<ObjectHandle> Object;
+  ASSERT_THAT_ERROR(CAS->load(Blob).moveInto(Object), Succeeded());
+  ASSERT_TRUE(Object);
+  EXPECT_EQ("blob", Object->getData());
+  EXPECT_EQ('\0', Object->getData().end()[0]);
+  EXPECT_EQ(0u, Object->getNumRefs());
+  EXPECT_EQ("blob", Object->getMemoryBuffer()->getBuffer());
+
+  // Storing the same content again does not take up space.
+  uint64_t Size = CAS->getStorageSize();
+  CASID Again;
+  ASSERT_THAT_ERROR(CAS->store("blob").moveInto(Again), Succeeded());
+  EXPECT_EQ(Blob, Again);
+  EXPECT_EQ(Size, CAS->getStorageSize());
+
+  CASID Empty;
+  ASSERT_THAT_ERROR(CAS->store("").moveInto(Empty), Succeeded());
+  ASSERT_THAT_ERROR(CAS->load(Empty).moveInto(Object), Succeeded());
+  ASSERT_TRUE(Object);
+  EXPECT_EQ("", Object->getData());
+
+  ASSERT_THAT_ERROR(CAS->load(ObjectStore::computeID({}, "missing"))
+                        .moveInto(Object),
+                    Succeeded());
+  EXPECT_FALSE(Object);
+  EXPECT_FALSE(CAS->contains(ObjectStore::computeID({}, "missing")));
+}
+
+TEST(ObjectStoreTest, Refs) {
+  TempDir Dir("cas", /*Unique=*/true);
+  std::unique_ptr<ObjectStore> CAS = openStore(Dir);
+  ASSERT_TRUE(CAS);
+
+  CASID A, B, Node;
+  ASSERT_THAT_ERROR(CAS->store("a").moveInto(A), Succeeded());
+  ASSERT_THAT_ERROR(CAS->store("b").moveInto(B), Succeeded());
+  ASSERT_THAT_ERROR(CAS->store({A, B}, "node").moveInto(Node), Succeeded());
+  // The references are part of the identity.
+  EXPECT_NE(ObjectStore::computeID({B, A}, "node"), Node);
+  EXPECT_NE(ObjectStore::computeID({}, "node"), Node);
+
+  std::optional<ObjectHandle> Object;
+  ASSERT_THAT_ERROR(CAS->load(Node).moveInto(Object), Succeeded());
+  ASSERT_TRUE(Object);
+  EXPECT_EQ("node", Object->getData());
+  ASSERT_EQ(2u, Object->getNumRefs());
+  EXPECT_EQ(A, Object->getRef(0));
+  EXPECT_EQ(B, Object->getRef(1));
+}
+
+TEST(ObjectStoreTest, Persistence) {
+  TempDir Dir("cas", /*Unique=*/true);
+  CASID ID;
+  {
+    std::unique_ptr<ObjectStore> CAS = openStore(Dir);
+    ASSERT_TRUE(CAS);
+    ASSERT_THAT_ERROR(CAS->store(std::string(100000, 'x')).moveInto(ID),
+                      Succeeded());
+  }
+  std::unique_ptr<ObjectStore> CAS = openStore(Dir);
+  ASSERT_TRUE(CAS);
+  std::optional<ObjectHandle> Object;
+  ASSERT_THAT_ERROR(CAS->load(ID).moveInto(Object), Succeeded());
+  ASSERT_TRUE(Object);
+  EXPECT_EQ(std::string(100000, 'x'), Object->getData());
+}
+
+// Stores opened separately behave like stores in different processes.
+TEST(ObjectStoreTest, ConcurrentStores) {
+  TempDir Dir("cas", /*Unique=*/true);
+  std::unique_ptr<ObjectStore> Stores[] = {openStore(Dir), openStore(Dir)};
+  ASSERT_TRUE(Stores[0] && Stores[1]);
+
+  const unsigned NumObjects = 1000;
+  std::vector<std::thread> Threads;
+  for (unsigned T = 0; T != 4; ++T)
+    Threads.emplace_back([&, T] {
+      ObjectStore &CAS = *Stores[T % 2];
+      for (unsigned I = 0; I != NumObjects; ++I)
+        ASSERT_THAT_EXPECTED(CAS.store(std::to_string(I)), Succeeded());
+    });
+  for (std::thread &T : Threads)
+    T.join();
+
+  for (unsigned I = 0; I != NumObjects; ++I) {
+    CASID ID = ObjectStore::computeID({}, std::to_string(I));
+    for (auto &CAS : Stores) {
+      std::optional<ObjectHandle> Object;
+      ASSERT_THAT_ERROR(CAS->load(ID).moveInto(Object), Succeeded());
+      ASSERT_TRUE(Object);
+      EXPECT_EQ(std::to_string(I), Object->getData());
+    }
+  }
+}
+
+TEST(ObjectStoreTest, CASIDString) {
+  CASID ID = ObjectStore::computeID({}, "blob");
+  std::string Str = ID.toString();
+  EXPECT_EQ(2 * CASID::NumBytes, Str.size());
+  EXPECT_THAT_EXPECTED(CASID::parse(Str), HasValue(ID));
+  EXPECT_THAT_EXPECTED(CASID::parse("00"), Failed());
+  EXPECT_THAT_EXPECTED(CASID::parse(std::string(64, 'g')), Failed());
+}
+
+} // namespace
@@ -0,0 +1,165 @@
+//===- OnDiskTrieHashMapTest.cpp ------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/CAS/OnDiskTrieHashMap.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Testing/Support/Error.h"
+#include "llvm/Testing/Support/SupportHelpers.h"
+#include "gtest/gtest.h"
+#include <array>
+#include <thread>
+
+using namespace llvm;
+using namespace llvm::cas;
+using llvm::unittest::TempDir;
+
+namespace {
+
+using HashT = std::array<uint8_t, 8>;
+
+// Hashes that share their first bits, so that they collide in the root and
+// need several levels of subtries.
+HashT getHash(uint64_t I) {
+  HashT Hash;
+  support::endian::write64be(Hash.data(), I);
+  return Hash;
+}
+
+void setValue(MutableArrayRef<char> Value, uint64_t V) {
+  support::endian::write64le(Value.data(), V);
+}
+
+uint64_t getValue(const OnDiskTrieHashMap::Record &R) {
+  return support::endian::read64le(R.Value.data());
+}
+
+TEST(OnDiskTrieHashMapTest, InsertAndFind) {
+  TempDir Dir("trie", /*Unique=*/true);
+  std::optional<OnDiskTrieHashMap> Trie;
+  ASSERT_THAT_ERROR(OnDiskTrieHashMap::create(Dir.path("trie"), 8, 8, 1 << 20,
+                                              /*RootBits=*/4,
+                                              /*SubtrieBits=*/2)
+                        .moveInto(Trie),
+                    Succeeded());
+
+  for (uint64_t I = 0; I != 1000; ++I) {
+    std::optional<std::pair<OnDiskTrieHashMap::Record, bool>> Inserted;
+    ASSERT_THAT_ERROR(
+        Trie->insertLazy(getHash(I), [&](MutableArrayRef<char> Value) {
+              setValue(Value, I * 10);
+            }).moveInto(Inserted),
+        Succeeded());
+    EXPECT_TRUE(Inserted->second);
+    EXPECT_EQ(ArrayRef<uint8_t>(getHash(I)), Inserted->first.Hash);
+  }
+
+  for (uint64_t I = 0; I != 1000; ++I) {
+    std::optional<OnDiskTrieHashMap::Record> R = Trie->find(getHash(I));
+    ASSERT_TRUE(R);
+    EXPECT_EQ(I * 10, getValue(*R));
+
+    std::optional<std::pair<OnDiskTrieHashMap::Record, bool>> Inserted;
+    ASSERT_THAT_ERROR(
+        Trie->insertLazy(getHash(I), [&](MutableArrayRef<char>) {
+              ADD_FAILURE() << "existing record constructed again";
+            }).moveInto(Inserted),
+        Succeeded());
+    EXPECT_FALSE(Inserted->second);
+    EXPECT_EQ(R->Offset, Inserted->first.Offset);
+
+    OnDiskTrieHashMap::Record ByOffset;
+    ASSERT_THAT_ERROR(Trie->getRecord(R->Offset).moveInto(ByOffset),
+                      Succeeded());
+    EXPECT_EQ(I * 10, getValue(ByOffset));
+  }
+  EXPECT_FALSE(Trie->find(getHash(1000)));
+  EXPECT_FALSE(Trie->find(getHash(uint64_t(1) << 63)));
+}
+
+TEST(OnDiskTrieHashMapTest, Reopen) {
+  TempDir Dir("trie", /*Unique=*/true);
+  {
+    std::optional<OnDiskTrieHashMap> Trie;
+    ASSERT_THAT_ERROR(OnDiskTrieHashMap::create(Dir.path("trie"), 8, 8, 1 << 20)
+                          .moveInto(Trie),
+                      Succeeded());
+    ASSERT_THAT_EXPECTED(
+        Trie->insertLazy(getHash(1),
+                         [](MutableArrayRef<char> V) { setValue(V, 7); }),
+        Succeeded());
+  }
+
+  // The file keeps its capacity and trie parameters.
+  std::optional<OnDiskTrieHashMap> Trie;
+  ASSERT_THAT_ERROR(OnDiskTrieHashMap::create(Dir.path("trie"), 8, 8, 1 << 10,
+                                              /*RootBits=*/3)
+                        .moveInto(Trie),
+                    Succeeded());
+  EXPECT_EQ(uint64_t(1) << 20, Trie->getArena().capacity());
+  std::optional<OnDiskTrieHashMap::Record> R = Trie->find(getHash(1));
+  ASSERT_TRUE(R);
+  EXPECT_EQ(7u, getValue(*R));
+
+  EXPECT_THAT_EXPECTED(
+      OnDiskTrieHashMap::create(Dir.path("trie"), 8, 16, 1 << 20), Failed());
+}
+
+TEST(OnDiskTrieHashMapTest, Full) {
+  TempDir Dir("trie", /*Unique=*/true);
+  std::optional<OnDiskTrieHashMap> Trie;
+  ASSERT_THAT_ERROR(OnDiskTrieHashMap::create(Dir.path("trie"), 8, 8, 4096,
+                                              /*RootBits=*/4)
+                        .moveInto(Trie),
+                    Succeeded());
+  Error Err = Error::success();
+  for (uint64_t I = 0; !Err && I != 1000; ++I)
+    Err = Trie->insertLazy(getHash(I), [](MutableArrayRef<char>) {})
+              .takeError();
+  EXPECT_THAT_ERROR(std::move(Err), Failed());
+  // Records inserted before the file filled up are still there.
+  EXPECT_TRUE(Trie->find(getHash(0)));
+}
+
+// Two maps of the same file behave like two processes sharing it.
+TEST(OnDiskTrieHashMapTest, ConcurrentMappings) {
+  TempDir Dir("trie", /*Unique=*/true);
+  std::optional<OnDiskTrieHashMap> Tries[2];
+  for (auto &Trie : Tries)
+    ASSERT_THAT_ERROR(OnDiskTrieHashMap::create(Dir.path("trie"), 8, 8,
+                                                16 << 20, /*RootBits=*/6,
+                                                /*SubtrieBits=*/2)
+                          .moveInto(Trie),
+                      Succeeded());
+
+  const uint64_t NumHashes = 10000;
+  std::vector<std::thread> Threads;
+  for (unsigned T = 0; T != 4; ++T)
+    Threads.emplace_back([&, T] {
+      OnDiskTrieHashMap &Trie = *Tries[T % 2];
+      for (uint64_t I = 0; I != NumHashes; ++I) {
+        // Spread the bits so that the threads collide in every subtrie.
+        uint64_t H = I * 0x9E3779B97F4A7C15;
+        auto Inserted = Trie.insertLazy(
+            getHash(H), [&](MutableArrayRef<char> V) { setValue(V, H); });
+        ASSERT_THAT_EXPECTED(Inserted, Succeeded());
+        EXPECT_EQ(H, getValue(Inserted->first));
+      }
+    });
+  for (std::thread &T : Threads)
+    T.join();
+
+  for (uint64_t I = 0; I != NumHashes; ++I) {
+    uint64_t H = I * 0x9E3779B97F4A7C15;
+    std::optional<OnDiskTrieHashMap::Record> R0 = Tries[0]->find(getHash(H));
+    std::optional<OnDiskTrieHashMap::Record> R1 = Tries[1]->find(getHash(H));
+    ASSERT_TRUE(R0 && R1);
+    EXPECT_EQ(R0->Offset, R1->Offset);
+  }
+}
+
+} // namespace
@@ -89,6 +89,33 @@ TEST(OutlinedHashTreeRecordTest, Serialize) {
   EXPECT_EQ(TreeDump1, TreeDump2);
 }
 
+TEST(OutlinedHashTreeRecordTest, SerializeSharedPrefixes) {
+  OutlinedHashTreeRecord HashTreeRecord1;
+  HashTreeRecord1.HashTree->insert({{1, 2, 3}, 1});
+  HashTreeRecord1.HashTree->insert({{1, 2, 4}, 2});
+  HashTreeRecord1.HashTree->insert({{1, 2}, 3});
+  HashTreeRecord1.HashTree->insert({{5, 2, 3}, 4});
+
+  SmallVector<char> Out;
+  raw_svector_ostream OS(Out);
+  HashTreeRecord1.serialize(OS);
+
+  OutlinedHashTreeRecord HashTreeRecord2;
+  const uint8_t *Data = reinterpret_cast<const uint8_t *>(Out.data());
+  HashTreeRecord2.deserialize(Data);
+
+  // The whole buffer is consumed and all sequences are found again.
+  EXPECT_EQ(reinterpret_cast<const uint8_t *>(Out.data() + Out.size()), Data);
+  const OutlinedHashTree *Tree = HashTreeRecord2.HashTree.get();
+  EXPECT_EQ(Tree->size(), 8u);
+  EXPECT_EQ(Tree->size(/*GetTerminalCountOnly=*/true), 4u);
+  EXPECT_EQ(Tree->find({1, 2, 3}), 1u);
+  EXPECT_EQ(Tree->find({1, 2, 4}), 2u);
+  EXPECT_EQ(Tree->find({1, 2}), 3u);
+  EXPECT_EQ(Tree->find({5, 2, 3}), 4u);
+  EXPECT_EQ(Tree->find({1}), std::nullopt);
+}
+
 TEST(OutlinedHashTreeRecordTest, SerializeYAML) {
   OutlinedHashTreeRecord HashTreeRecord1;
   HashTreeRecord1.HashTree->insert({{1, 2}, 4});
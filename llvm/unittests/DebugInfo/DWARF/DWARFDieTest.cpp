@@ -12,6 +12,7 @@
 #include "llvm/ObjectYAML/DWARFEmitter.h"
 #include "llvm/Testing/Support/Error.h"
 #include "gtest/gtest.h"
+#include <thread>
 
 using namespace llvm;
 using namespace llvm::dwarf;
@@ -704,4 +705,170 @@ TEST(DWARFDie, getNameFromTypeUnit) {
   ASSERT_STREQ(Die.getName(DINameKind::ShortName), "STRUCT");
 }
 
+TEST(DWARFDie, ConcurrentExtraction) {
+  const char *yamldata = R"(
+  debug_abbrev:
+    - Table:
+        - Code:            0x1
+          Tag:             DW_TAG_compile_unit
+          Children:        DW_CHILDREN_yes
+        - Code:            0x2
+          Tag:             DW_TAG_subprogram
+          Children:        DW_CHILDREN_no
+          Attributes:
+            - Attribute:       DW_AT_name
+              Form:            DW_FORM_string
+  debug_info:
+    - Version:         5
+      UnitType:        DW_UT_compile
+      Entries:
+        - AbbrCode:        0x1
+        - AbbrCode:        0x2
+          Values:
+            - CStr:        "f"
+        - AbbrCode:        0x2
+          Values:
+            - CStr:        "g"
+        - AbbrCode:        0x0
+    - Version:         5
+      UnitType:        DW_UT_compile
+      Entries:
+        - AbbrCode:        0x1
+        - AbbrCode:        0x2
+          Values:
+            - CStr:        "f"
+        - AbbrCode:        0x2
+          Values:
+            - CStr:        "g"
+        - AbbrCode:        0x0
+    - Version:         5
+      UnitType:        DW_UT_compile
+      Entries:
+        - AbbrCode:        0x1
+        - AbbrCode:        0x2
+          Values:
+            - CStr:        "f"
+        - AbbrCode:        0x2
+          Values:
+            - CStr:        "g"
+        - AbbrCode:        0x0
+    - Version:         5
+      UnitType:        DW_UT_compile
+      Entries:
+        - AbbrCode:        0x1
+        - AbbrCode:        0x2
+          Values:
+            - CStr:        "f"
+        - AbbrCode:        0x2
+          Values:
+            - CStr:        "g"
+        - AbbrCode:        0x0
+  )";
+
+  Expected<StringMap<std::unique_ptr<MemoryBuffer>>> Sections =
+      DWARFYAML::emitDebugSections(StringRef(yamldata),
+                                   /*IsLittleEndian=*/true,
+                                   /*Is64BitAddrSize=*/true);
+  ASSERT_THAT_EXPECTED(Sections, Succeeded());
+  std::unique_ptr<DWARFContext> Ctx = DWARFContext::create(
+      *Sections, 8, /*isLittleEndian=*/true, WithColor::defaultErrorHandler,
+      WithColor::defaultWarningHandler, /*ThreadSafe=*/true);
+  ASSERT_EQ(Ctx->getNumCompileUnits(), 4U);
+
+  // Every thread extracts the DIEs of every unit, so that the threads race to
+  // extract each of them.
+  constexpr unsigned NumThreads = 8;
+  std::vector<unsigned> NumDIEs(NumThreads);
+  std::vector<std::thread> Threads;
+  for (unsigned I = 0; I != NumThreads; ++I)
+    Threads.emplace_back([&, I]() {
+      for (const auto &CU : Ctx->compile_units())
+        NumDIEs[I] += CU->getNumDIEs();
+    });
+  for (auto &T : Threads)
+    T.join();
+
+  for (unsigned N : NumDIEs)
+    EXPECT_EQ(N, 16U);
+  for (const auto &CU : Ctx->compile_units()) {
+    DWARFDie F = CU->getUnitDIE(/*ExtractUnitDIEOnly=*/false).getFirstChild();
+    ASSERT_TRUE(F.isValid());
+    EXPECT_STREQ(F.getName(DINameKind::ShortName), "f");
+    EXPECT_STREQ(F.getSibling().getName(DINameKind::ShortName), "g");
+  }
+}
+
+TEST(DWARFDie, ConcurrentUnitDIEAndExtraction) {
+  const char *yamldata = R"(
+  debug_abbrev:
+    - Table:
+        - Code:            0x1
+          Tag:             DW_TAG_compile_unit
+          Children:        DW_CHILDREN_yes
+          Attributes:
+            - Attribute:       DW_AT_name
+              Form:            DW_FORM_string
+        - Code:            0x2
+          Tag:             DW_TAG_subprogram
+          Children:        DW_CHILDREN_no
+          Attributes:
+            - Attribute:       DW_AT_name
+              Form:            DW_FORM_string
+  debug_info:
+    - Version:         5
+      UnitType:        DW_UT_compile
+      Entries:
+        - AbbrCode:        0x1
+          Values:
+            - CStr:        "unit"
+        - AbbrCode:        0x2
+          Values:
+            - CStr:        "f"
+        - AbbrCode:        0x2
+          Values:
+            - CStr:        "g"
+        - AbbrCode:        0x2
+          Values:
+            - CStr:        "h"
+        - AbbrCode:        0x0
+  )";
+
+  Expected<StringMap<std::unique_ptr<MemoryBuffer>>> Sections =
+      DWARFYAML::emitDebugSections(StringRef(yamldata),
+                                   /*IsLittleEndian=*/true,
+                                   /*Is64BitAddrSize=*/true);
+  ASSERT_THAT_EXPECTED(Sections, Succeeded());
+
+  // One thread holds on to the unit DIE while the other one extracts all of
+  // the DIEs, as the symbolizer does when a line table lookup races with a
+  // subprogram lookup. The unit DIE must stay valid. Use fresh contexts so
+  // that the extraction races many times.
+  for (unsigned Round = 0; Round != 64; ++Round) {
+    std::unique_ptr<DWARFContext> Ctx = DWARFContext::create(
+        *Sections, 8, /*isLittleEndian=*/true, WithColor::defaultErrorHandler,
+        WithColor::defaultWarningHandler, /*ThreadSafe=*/true);
+    DWARFUnit *CU = Ctx->getCompileUnitForOffset(0);
+    ASSERT_TRUE(CU);
+
+    const char *UnitName = nullptr;
+    const char *FirstName = nullptr;
+    std::thread UnitDIEThread([&]() {
+      DWARFDie UnitDIE = CU->getUnitDIE(/*ExtractUnitDIEOnly=*/true);
+      for (unsigned I = 0; I != 16; ++I)
+        UnitName = UnitDIE.getName(DINameKind::ShortName);
+    });
+    std::thread ExtractionThread([&]() {
+      FirstName = CU->getUnitDIE(/*ExtractUnitDIEOnly=*/false)
+                      .getFirstChild()
+                      .getName(DINameKind::ShortName);
+    });
+    UnitDIEThread.join();
+    ExtractionThread.join();
+
+    EXPECT_STREQ(UnitName, "unit");
+    EXPECT_STREQ(FirstName, "f");
+    EXPECT_EQ(CU->getNumDIEs(), 5U);
+  }
+}
+
 } // end anonymous namespace
@@ -173,4 +173,85 @@ TEST(MapperJITLinkMemoryManagerTest, Coalescing) {
   EXPECT_THAT_ERROR(std::move(Err4), Succeeded());
 }
 
+TEST(MapperJITLinkMemoryManagerTest, MemoryStats) {
+  auto Mapper = cantFail(InProcessMemoryMapper::Create());
+  size_t PageSize = Mapper->getPageSize();
+  size_t Granularity = 16 * 1024 * 1024;
+  auto MemMgr = std::make_unique<MapperJITLinkMemoryManager>(Granularity,
+                                                             std::move(Mapper));
+
+  auto Stats = MemMgr->getMemoryStats();
+  EXPECT_EQ(Stats.ReservedBytes, 0U);
+  EXPECT_EQ(Stats.NumFreeRanges, 0U);
+
+  std::vector<JITLinkMemoryManager::FinalizedAlloc> FAs;
+  for (unsigned I = 0; I != 3; ++I) {
+    auto SSA = jitlink::SimpleSegmentAlloc::Create(
+        *MemMgr, nullptr, {{MemProt::Read, {1024, Align(1)}}});
+    ASSERT_THAT_EXPECTED(SSA, Succeeded());
+    auto FA = SSA->finalize();
+    ASSERT_THAT_EXPECTED(FA, Succeeded());
+    FAs.push_back(std::move(*FA));
+  }
+
+  // Each allocation is padded to a page.
+  Stats = MemMgr->getMemoryStats();
+  EXPECT_EQ(Stats.ReservedBytes, Granularity);
+  EXPECT_EQ(Stats.AllocatedBytes, 3 * PageSize);
+  EXPECT_EQ(Stats.FreeBytes, Granularity - 3 * PageSize);
+  EXPECT_EQ(Stats.NumFreeRanges, 1U);
+  EXPECT_EQ(Stats.LargestFreeRange, Stats.FreeBytes);
+
+  // Freeing the middle allocation leaves a hole.
+  EXPECT_THAT_ERROR(MemMgr->deallocate(std::move(FAs[1])), Succeeded());
+  Stats = MemMgr->getMemoryStats();
+  EXPECT_EQ(Stats.AllocatedBytes, 2 * PageSize);
+  EXPECT_EQ(Stats.FreeBytes, Granularity - 2 * PageSize);
+  EXPECT_EQ(Stats.NumFreeRanges, 2U);
+  EXPECT_EQ(Stats.LargestFreeRange, Granularity - 3 * PageSize);
+
+  EXPECT_THAT_ERROR(MemMgr->deallocate(std::move(FAs[0])), Succeeded());
+  EXPECT_THAT_ERROR(MemMgr->deallocate(std::move(FAs[2])), Succeeded());
+  Stats = MemMgr->getMemoryStats();
+  EXPECT_EQ(Stats.AllocatedBytes, 0U);
+  EXPECT_EQ(Stats.NumFreeRanges, 1U);
+  EXPECT_EQ(Stats.LargestFreeRange, Granularity);
+}
+
+TEST(MapperJITLinkMemoryManagerTest, DualMapped) {
+  auto Mapper = DualMappedMemoryMapper::Create(/*UseHugePages=*/true);
+  if (!Mapper) {
+    consumeError(Mapper.takeError());
+    GTEST_SKIP();
+  }
+  auto MemMgr = std::make_unique<MapperJITLinkMemoryManager>(
+      16 * 1024 * 1024, std::move(*Mapper));
+
+  StringRef Hello = "hello";
+  auto SSA = jitlink::SimpleSegmentAlloc::Create(
+      *MemMgr, nullptr, {{MemProt::Read, {Hello.size(), Align(1)}}});
+  ASSERT_THAT_EXPECTED(SSA, Succeeded());
+
+  // The content is written through a different view than the one at the
+  // executor address.
+  auto SegInfo = SSA->getSegInfo(MemProt::Read);
+  EXPECT_NE(SegInfo.WorkingMem.data(), SegInfo.Addr.toPtr<char *>());
+  memcpy(SegInfo.WorkingMem.data(), Hello.data(), Hello.size());
+
+  auto FA = SSA->finalize();
+  ASSERT_THAT_EXPECTED(FA, Succeeded());
+  EXPECT_EQ(Hello, StringRef(SegInfo.Addr.toPtr<const char *>(), Hello.size()));
+
+  EXPECT_THAT_ERROR(MemMgr->deallocate(std::move(*FA)), Succeeded());
+
+  // Freed memory is reused.
+  auto SSA2 = jitlink::SimpleSegmentAlloc::Create(
+      *MemMgr, nullptr, {{MemProt::Read, {Hello.size(), Align(1)}}});
+  ASSERT_THAT_EXPECTED(SSA2, Succeeded());
+  EXPECT_EQ(SSA2->getSegInfo(MemProt::Read).Addr, SegInfo.Addr);
+  auto FA2 = SSA2->finalize();
+  ASSERT_THAT_EXPECTED(FA2, Succeeded());
+  EXPECT_THAT_ERROR(MemMgr->deallocate(std::move(*FA2)), Succeeded());
+}
+
 } // namespace
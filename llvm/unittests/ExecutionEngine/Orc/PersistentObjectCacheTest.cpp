@@ -0,0 +1,128 @@
+//===- PersistentObjectCacheTest.cpp - Unit tests for the object cache ----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/PersistentObjectCache.h"
+#include "OrcTestCommon.h"
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/IRReader/IRReader.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Testing/Support/Error.h"
+#include "llvm/Testing/Support/SupportHelpers.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::orc;
+
+namespace {
+
+const char TestModule[] = R"(
+  define i32 @answer() {
+  entry:
+    ret i32 42
+  }
+)";
+
+// Creates a JIT caching objects in CacheDir, runs TestModule in it and
+// returns the statistics of the cache.
+void runCachedModule(StringRef CacheDir, uint64_t &Hits, uint64_t &Misses) {
+  auto JTMB = JITTargetMachineBuilder::detectHost();
+  if (!JTMB) {
+    consumeError(JTMB.takeError());
+    GTEST_SKIP();
+  }
+
+  auto J = LLJITBuilder()
+               .setJITTargetMachineBuilder(std::move(*JTMB))
+               .setObjectCacheDirectory(CacheDir.str())
+               .create();
+  if (!J) {
+    consumeError(J.takeError());
+    GTEST_SKIP();
+  }
+
+  auto Ctx = std::make_unique<LLVMContext>();
+  SMDiagnostic Diag;
+  auto M = parseIR(MemoryBufferRef(TestModule, "test"), Diag, *Ctx);
+  ASSERT_TRUE(M) << Diag.getMessage();
+  ASSERT_THAT_ERROR(
+      (*J)->addIRModule(ThreadSafeModule(std::move(M), std::move(Ctx))),
+      Succeeded());
+
+  auto Answer = (*J)->lookup("answer");
+  ASSERT_THAT_EXPECTED(Answer, Succeeded());
+  EXPECT_EQ(Answer->toPtr<int (*)()>()(), 42);
+
+  auto *Cache = static_cast<PersistentObjectCache *>((*J)->getObjectCache());
+  ASSERT_NE(Cache, nullptr);
+  Hits = Cache->getStats().Hits;
+  Misses = Cache->getStats().Misses;
+}
+
+TEST(PersistentObjectCacheTest, ReusesObjectsAcrossJITInstances) {
+  OrcNativeTarget::initialize();
+
+  unittest::TempDir CacheDir("orc-object-cache", /*Unique=*/true);
+
+  uint64_t Hits = 0, Misses = 0;
+  runCachedModule(CacheDir.path(), Hits, Misses);
+  if (IsSkipped())
+    return;
+  EXPECT_EQ(Hits, 0U);
+  EXPECT_EQ(Misses, 1U);
+
+  // A second JIT compiling the same module for the same target loads the
+  // object that the first one wrote.
+  runCachedModule(CacheDir.path(), Hits, Misses);
+  EXPECT_EQ(Hits, 1U);
+  EXPECT_EQ(Misses, 0U);
+}
+
+TEST(PersistentObjectCacheTest, TargetKeyIncludesOptLevel) {
+  JITTargetMachineBuilder JTMB((Triple("x86_64-unknown-linux-gnu")));
+  JTMB.setCodeGenOptLevel(CodeGenOptLevel::None);
+  std::string NoneKey = PersistentObjectCache::getTargetKey(JTMB);
+  JTMB.setCodeGenOptLevel(CodeGenOptLevel::Aggressive);
+  EXPECT_NE(NoneKey, PersistentObjectCache::getTargetKey(JTMB));
+}
+
+TEST(PersistentObjectCacheTest, TargetKeyIncludesTargetOptions) {
+  JITTargetMachineBuilder JTMB((Triple("x86_64-unknown-linux-gnu")));
+  std::string DefaultKey = PersistentObjectCache::getTargetKey(JTMB);
+
+  auto KeyWith = [&](function_ref<void(TargetOptions &)> Set) {
+    JITTargetMachineBuilder Changed = JTMB;
+    Set(Changed.getOptions());
+    return PersistentObjectCache::getTargetKey(Changed);
+  };
+  EXPECT_NE(DefaultKey, KeyWith([](TargetOptions &Options) {
+              Options.FloatABIType = FloatABI::Hard;
+            }));
+  EXPECT_NE(DefaultKey, KeyWith([](TargetOptions &Options) {
+              Options.EmulatedTLS = !Options.EmulatedTLS;
+            }));
+  EXPECT_NE(DefaultKey, KeyWith([](TargetOptions &Options) {
+              Options.FunctionSections = true;
+            }));
+  EXPECT_NE(DefaultKey, KeyWith([](TargetOptions &Options) {
+              Options.DataSections = true;
+            }));
+  EXPECT_NE(DefaultKey, KeyWith([](TargetOptions &Options) {
+              Options.ExceptionModel = ExceptionHandling::DwarfCFI;
+            }));
+  EXPECT_NE(DefaultKey, KeyWith([](TargetOptions &Options) {
+              Options.AllowFPOpFusion = FPOpFusion::Fast;
+            }));
+  EXPECT_NE(DefaultKey, KeyWith([](TargetOptions &Options) {
+              Options.UnsafeFPMath = true;
+            }));
+  EXPECT_NE(DefaultKey, KeyWith([](TargetOptions &Options) {
+              Options.NoNaNsFPMath = true;
+            }));
+}
+
+} // namespace
@@ -0,0 +1,100 @@
+//===- ProfileGuidedSpeculationTest.cpp - Unit tests for speculation ------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/ProfileGuidedSpeculation.h"
+#include "OrcTestCommon.h"
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/IRReader/IRReader.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::orc;
+
+namespace {
+
+const char TestModule[] = R"(
+  define i32 @hot() {
+  entry:
+    ret i32 1
+  }
+
+  define i32 @warm() {
+  entry:
+    ret i32 2
+  }
+)";
+
+class ProfileGuidedSpeculationTest : public testing::Test {
+protected:
+  void SetUp() override {
+    OrcNativeTarget::initialize();
+
+    auto JTMB = JITTargetMachineBuilder::detectHost();
+    if (!JTMB) {
+      consumeError(JTMB.takeError());
+      GTEST_SKIP();
+    }
+
+    auto LJ = LLLazyJITBuilder()
+                  .setJITTargetMachineBuilder(std::move(*JTMB))
+                  .create();
+    if (!LJ) {
+      consumeError(LJ.takeError());
+      GTEST_SKIP();
+    }
+    J = std::move(*LJ);
+  }
+
+  void addTestModule() {
+    auto Ctx = std::make_unique<LLVMContext>();
+    SMDiagnostic Diag;
+    auto M = parseIR(MemoryBufferRef(TestModule, "test"), Diag, *Ctx);
+    ASSERT_TRUE(M) << Diag.getMessage();
+    ASSERT_THAT_ERROR(
+        J->addLazyIRModule(ThreadSafeModule(std::move(M), std::move(Ctx))),
+        Succeeded());
+  }
+
+  std::unique_ptr<LLLazyJIT> J;
+};
+
+TEST_F(ProfileGuidedSpeculationTest, CompilesProfiledFunctions) {
+  auto S = ProfileGuidedSpeculator::Create(*J, {});
+  addTestModule();
+
+  S->speculate(J->getMainJITDylib(),
+               {{"warm", 10}, {"hot", 100}, {"not_in_jit", 1000}});
+  S->waitForCompletion();
+  EXPECT_EQ(S->getNumSpeculated(), 2U);
+  EXPECT_GT(S->getEmittedBytes(), 0U);
+
+  auto Hot = J->lookup("hot");
+  ASSERT_THAT_EXPECTED(Hot, Succeeded());
+  EXPECT_EQ(Hot->toPtr<int (*)()>()(), 1);
+}
+
+TEST_F(ProfileGuidedSpeculationTest, StopsAtMemoryBudget) {
+  ProfileGuidedSpeculator::Config C;
+  C.MemoryBudget = 1;
+  C.MaxInFlight = 1;
+  auto S = ProfileGuidedSpeculator::Create(*J, C);
+  addTestModule();
+
+  // Only the hottest function is compiled before the budget is exceeded.
+  S->speculate(J->getMainJITDylib(), {{"warm", 10}, {"hot", 100}});
+  S->waitForCompletion();
+  EXPECT_EQ(S->getNumSpeculated(), 1U);
+
+  auto Warm = J->lookup("warm");
+  ASSERT_THAT_EXPECTED(Warm, Succeeded());
+  EXPECT_EQ(Warm->toPtr<int (*)()>()(), 2);
+}
+
+} // namespace
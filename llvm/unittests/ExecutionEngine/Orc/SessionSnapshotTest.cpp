@@ -0,0 +1,204 @@
+//===------- SessionSnapshotTest.cpp - Unit tests for session snapshots ---===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/SessionSnapshot.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ExecutionEngine/JITLink/JITLinkMemoryManager.h"
+#include "llvm/ExecutionEngine/JITLink/x86_64.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::jitlink;
+using namespace llvm::orc;
+
+namespace {
+
+const char BlockContentBytes[16] = {0x01, 0x02, 0x03, 0x04};
+
+/// Returns a graph with a data block holding a pointer to _Y at _X.
+std::unique_ptr<LinkGraph> makeGraph() {
+  auto G = std::make_unique<LinkGraph>("foo", Triple("x86_64-apple-darwin"), 8,
+                                       llvm::endianness::little,
+                                       x86_64::getEdgeKindName);
+  auto &Data = G->createSection("__data", MemProt::Read | MemProt::Write);
+  auto &B = G->createContentBlock(Data, ArrayRef<char>(BlockContentBytes),
+                                  ExecutorAddr(0x1000), 8, 0);
+  G->addDefinedSymbol(B, 0, "_X", 8, Linkage::Strong, Scope::Default, false,
+                      false);
+  auto &Y = G->addDefinedSymbol(B, 8, "_Y", 8, Linkage::Weak, Scope::Hidden,
+                                false, false);
+  B.addEdge(x86_64::Pointer64, 0, Y, 0);
+  return G;
+}
+
+TEST(SessionSnapshotTest, LinkGraphRoundTrip) {
+  auto G = makeGraph();
+  auto &Text = G->createSection("__text", MemProt::Read | MemProt::Exec);
+  auto &ZF = G->createZeroFillBlock(Text, 32, ExecutorAddr(0x2000), 16, 4);
+  G->addAnonymousSymbol(ZF, 4, 28, true, true);
+  auto &Ext = G->addExternalSymbol("_ext", 0, true);
+  ZF.addEdge(x86_64::BranchPCRel32, 8, Ext, -4);
+  G->addAbsoluteSymbol("_abs", ExecutorAddr(0x42), 0, Linkage::Strong,
+                       Scope::Local, true);
+
+  std::string Buffer;
+  raw_string_ostream OS(Buffer);
+  ASSERT_THAT_ERROR(writeLinkGraph(*G, OS), Succeeded());
+
+  auto G2 = readLinkGraph(arrayRefFromStringRef(Buffer));
+  ASSERT_THAT_EXPECTED(G2, Succeeded());
+  auto &R = **G2;
+
+  EXPECT_EQ(R.getName(), "foo");
+  EXPECT_EQ(R.getTargetTriple().str(), "x86_64-apple-darwin");
+  EXPECT_EQ(R.sections_size(), 2U);
+
+  auto *RData = R.findSectionByName("__data");
+  ASSERT_NE(RData, nullptr);
+  EXPECT_EQ(RData->getMemProt(), MemProt::Read | MemProt::Write);
+  ASSERT_EQ(RData->blocks_size(), 1U);
+  auto &RB = **RData->blocks().begin();
+  EXPECT_EQ(RB.getAddress(), ExecutorAddr(0x1000));
+  EXPECT_EQ(RB.getContent(), ArrayRef<char>(BlockContentBytes));
+  ASSERT_EQ(RB.edges_size(), 1U);
+  auto &E = *RB.edges().begin();
+  EXPECT_EQ(E.getKind(), x86_64::Pointer64);
+  EXPECT_EQ(E.getTarget().getName(), "_Y");
+  EXPECT_EQ(E.getTarget().getLinkage(), Linkage::Weak);
+  EXPECT_EQ(E.getTarget().getScope(), Scope::Hidden);
+
+  auto *RText = R.findSectionByName("__text");
+  ASSERT_NE(RText, nullptr);
+  ASSERT_EQ(RText->blocks_size(), 1U);
+  auto &RZF = **RText->blocks().begin();
+  EXPECT_TRUE(RZF.isZeroFill());
+  EXPECT_EQ(RZF.getSize(), 32U);
+  EXPECT_EQ(RZF.getAlignment(), 16U);
+  EXPECT_EQ(RZF.getAlignmentOffset(), 4U);
+  ASSERT_EQ(RZF.edges_size(), 1U);
+  EXPECT_EQ(RZF.edges().begin()->getAddend(), -4);
+  EXPECT_EQ(RZF.edges().begin()->getTarget().getName(), "_ext");
+  EXPECT_TRUE(RZF.edges().begin()->getTarget().isWeaklyReferenced());
+
+  size_t NumAnonymous = 0;
+  for (auto *Sym : RText->symbols()) {
+    EXPECT_FALSE(Sym->hasName());
+    EXPECT_TRUE(Sym->isCallable());
+    ++NumAnonymous;
+  }
+  EXPECT_EQ(NumAnonymous, 1U);
+
+  ASSERT_EQ(R.absolute_symbols().begin() != R.absolute_symbols().end(), true);
+  EXPECT_EQ((*R.absolute_symbols().begin())->getAddress(), ExecutorAddr(0x42));
+}
+
+TEST(SessionSnapshotTest, RejectsMalformedInput) {
+  auto G = makeGraph();
+  std::string Buffer;
+  raw_string_ostream OS(Buffer);
+  ASSERT_THAT_ERROR(writeLinkGraph(*G, OS), Succeeded());
+
+  Buffer.pop_back();
+  EXPECT_THAT_EXPECTED(readLinkGraph(arrayRefFromStringRef(Buffer)), Failed());
+
+  ExecutionSession ES{std::make_unique<UnsupportedExecutorProcessControl>()};
+  ObjectLinkingLayer L(ES, std::make_unique<InProcessMemoryManager>(4096));
+  EXPECT_THAT_ERROR(SessionSnapshotPlugin::restore(
+                        L, MemoryBufferRef("not a snapshot", "test")),
+                    Failed());
+  cantFail(ES.endSession());
+}
+
+TEST(SessionSnapshotTest, RejectsInconsistentGraphs) {
+  auto RoundTrip = [](LinkGraph &G) {
+    std::string Buffer;
+    raw_string_ostream OS(Buffer);
+    cantFail(writeLinkGraph(G, OS));
+    return readLinkGraph(arrayRefFromStringRef(Buffer)).takeError();
+  };
+
+  // The fixup of the edge would write past the end of the block.
+  auto G = makeGraph();
+  auto &B = **G->sections().begin()->blocks().begin();
+  B.addEdge(x86_64::Pointer64, 12, **G->defined_symbols().begin(), 0);
+  EXPECT_THAT_ERROR(RoundTrip(*G), Failed());
+
+  // The symbol extends past the end of its block.
+  G = makeGraph();
+  G->addDefinedSymbol(**G->sections().begin()->blocks().begin(), 8, "_Z", 16,
+                      Linkage::Strong, Scope::Default, false, false);
+  EXPECT_THAT_ERROR(RoundTrip(*G), Failed());
+
+  // Two global symbols have the same name.
+  G = makeGraph();
+  G->addDefinedSymbol(**G->sections().begin()->blocks().begin(), 4, "_X", 4,
+                      Linkage::Strong, Scope::Default, false, false);
+  EXPECT_THAT_ERROR(RoundTrip(*G), Failed());
+
+  // Local symbols may share a name.
+  G = makeGraph();
+  auto &LocalB = **G->sections().begin()->blocks().begin();
+  G->addDefinedSymbol(LocalB, 0, "_L", 4, Linkage::Strong, Scope::Local, false,
+                      false);
+  G->addDefinedSymbol(LocalB, 4, "_L", 4, Linkage::Strong, Scope::Local, false,
+                      false);
+  EXPECT_THAT_ERROR(RoundTrip(*G), Succeeded());
+}
+
+TEST(SessionSnapshotTest, SaveAndRestore) {
+  std::string Snapshot;
+  {
+    ExecutionSession ES{std::make_unique<UnsupportedExecutorProcessControl>()};
+    auto &JD = ES.createBareJITDylib("main");
+    ObjectLinkingLayer L(ES, std::make_unique<InProcessMemoryManager>(4096));
+    auto Plugin = std::make_unique<SessionSnapshotPlugin>();
+    auto &P = *Plugin;
+    L.addPlugin(std::move(Plugin));
+
+    ASSERT_THAT_ERROR(L.add(JD, makeGraph()), Succeeded());
+    ASSERT_THAT_EXPECTED(ES.lookup(&JD, "_X"), Succeeded());
+    EXPECT_EQ(P.getNumRecordedGraphs(), 1U);
+
+    raw_string_ostream OS(Snapshot);
+    EXPECT_THAT_ERROR(P.save(OS), Succeeded());
+    cantFail(ES.endSession());
+  }
+
+  ExecutionSession ES{std::make_unique<UnsupportedExecutorProcessControl>()};
+  auto &JD = ES.createBareJITDylib("main");
+  ObjectLinkingLayer L(ES, std::make_unique<InProcessMemoryManager>(4096));
+  ASSERT_THAT_ERROR(
+      SessionSnapshotPlugin::restore(L, MemoryBufferRef(Snapshot, "snapshot")),
+      Succeeded());
+
+  auto X = ES.lookup(&JD, "_X");
+  ASSERT_THAT_EXPECTED(X, Succeeded());
+
+  // The pointer at _X is fixed up for the new address of _Y, which is eight
+  // bytes further in the same block.
+  uint64_t Pointer = support::endian::read64le(X->getAddress().toPtr<void *>());
+  EXPECT_EQ(Pointer, (X->getAddress() + 8).getValue());
+  EXPECT_EQ(X->getAddress().toPtr<const char *>()[8], 0);
+
+  // Graphs of JITDylibs that the callback skips are not added.
+  ExecutionSession ES2{std::make_unique<UnsupportedExecutorProcessControl>()};
+  auto &JD2 = ES2.createBareJITDylib("main");
+  ObjectLinkingLayer L2(ES2, std::make_unique<InProcessMemoryManager>(4096));
+  EXPECT_THAT_ERROR(
+      SessionSnapshotPlugin::restore(L2, MemoryBufferRef(Snapshot, "snapshot"),
+                                     [](StringRef) { return nullptr; }),
+      Succeeded());
+  EXPECT_THAT_EXPECTED(ES2.lookup(&JD2, "_X"), Failed());
+
+  cantFail(ES2.endSession());
+  cantFail(ES.endSession());
+}
+
+} // namespace
@@ -10,6 +10,7 @@
 #include "llvm/Config/llvm-config.h" // for LLVM_ENABLE_THREADS
 #include "gtest/gtest.h"
 
+#include <atomic>
 #include <future>
 
 using namespace llvm;
@@ -33,4 +34,27 @@ TEST(DynamicThreadPoolDispatchTest, GenericNamedTask) {
   EXPECT_TRUE(F.get());
   D->shutdown();
 }
+
+TEST(WorkStealingDispatchTest, GenericNamedTask) {
+  auto D = std::make_unique<WorkStealingTaskDispatcher>(2);
+  std::promise<bool> P;
+  auto F = P.get_future();
+  D->dispatch(makeGenericNamedTask(
+      [P = std::move(P)]() mutable { P.set_value(true); }));
+  EXPECT_TRUE(F.get());
+  D->shutdown();
+}
+
+TEST(WorkStealingDispatchTest, ShutdownWaitsForNestedTasks) {
+  auto D = std::make_unique<WorkStealingTaskDispatcher>(4);
+  std::atomic<size_t> Count{0};
+  for (size_t I = 0; I != 16; ++I)
+    D->dispatch(makeGenericNamedTask([&]() {
+      // Tasks dispatched from a worker go to its own queue.
+      for (size_t J = 0; J != 16; ++J)
+        D->dispatch(makeGenericNamedTask([&]() { ++Count; }));
+    }));
+  D->shutdown();
+  EXPECT_EQ(Count, 256U);
+}
 #endif
@@ -0,0 +1,90 @@
+//===- TieredCompileLayerTest.cpp - Unit tests for tiered compilation -----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/TieredCompileLayer.h"
+#include "OrcTestCommon.h"
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/IRReader/IRReader.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::orc;
+
+namespace {
+
+const char TestModule[] = R"(
+  define i32 @add_one(i32 %x) {
+  entry:
+    %r = add i32 %x, 1
+    ret i32 %r
+  }
+
+  define i32 @add_two(i32 %x) {
+  entry:
+    %y = call i32 @add_one(i32 %x)
+    %r = call i32 @add_one(i32 %y)
+    ret i32 %r
+  }
+)";
+
+TEST(TieredCompileLayerTest, RecompilesHotFunctions) {
+  OrcNativeTarget::initialize();
+
+  auto JTMB = JITTargetMachineBuilder::detectHost();
+  if (!JTMB) {
+    consumeError(JTMB.takeError());
+    GTEST_SKIP();
+  }
+
+  // Indirect stubs are only available on some hosts.
+  const Triple &TT = JTMB->getTargetTriple();
+  if (TT.getArch() != Triple::x86_64 && TT.getArch() != Triple::aarch64)
+    GTEST_SKIP();
+  auto BuildISM = createLocalIndirectStubsManagerBuilder(TT);
+
+  auto J = LLJITBuilder().setJITTargetMachineBuilder(std::move(*JTMB)).create();
+  if (!J) {
+    consumeError(J.takeError());
+    GTEST_SKIP();
+  }
+
+  TieredCompileLayer Tiered((*J)->getExecutionSession(),
+                            (*J)->getIRCompileLayer(),
+                            (*J)->getIRCompileLayer(), std::move(BuildISM));
+  Tiered.setHotCallThreshold(3);
+
+  auto Ctx = std::make_unique<LLVMContext>();
+  SMDiagnostic Diag;
+  auto M = parseIR(MemoryBufferRef(TestModule, "test"), Diag, *Ctx);
+  ASSERT_TRUE(M) << Diag.getMessage();
+  M->setDataLayout((*J)->getDataLayout());
+  ASSERT_THAT_ERROR(Tiered.add((*J)->getMainJITDylib(),
+                               ThreadSafeModule(std::move(M), std::move(Ctx))),
+                    Succeeded());
+
+  auto AddTwo = (*J)->lookup("add_two");
+  ASSERT_THAT_EXPECTED(AddTwo, Succeeded());
+  auto *AddTwoPtr = AddTwo->toPtr<int (*)(int)>();
+
+  // The calls from add_two to add_one go through the stub of add_one, so it
+  // becomes hot before add_two does.
+  EXPECT_EQ(AddTwoPtr(0), 2);
+  JITDylib *ImplD =
+      (*J)->getExecutionSession().getJITDylibByName("main.tiered");
+  ASSERT_NE(ImplD, nullptr);
+  EXPECT_EQ(AddTwoPtr(1), 3);
+  EXPECT_THAT_EXPECTED((*J)->lookup(*ImplD, "add_one.tier1"), Succeeded());
+
+  EXPECT_EQ(AddTwoPtr(2), 4);
+  EXPECT_EQ(AddTwoPtr(3), 5);
+  EXPECT_THAT_EXPECTED((*J)->lookup(*ImplD, "add_two.tier1"), Succeeded());
+}
+
+} // namespace
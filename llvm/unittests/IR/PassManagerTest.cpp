@@ -808,6 +808,67 @@ TEST_F(PassManagerTest, IndirectAnalysisInvalidation) {
   EXPECT_EQ(3 * 4 * 3, FunctionCount);
 }
 
+TEST_F(PassManagerTest, InvalidationTracking) {
+  AnalysisInvalidationTracker Tracker;
+  FunctionAnalysisManager FAM;
+  FAM.setInvalidationTracker(&Tracker);
+  int FunctionAnalysisRuns = 0;
+  FAM.registerPass([&] { return TestFunctionAnalysis(FunctionAnalysisRuns); });
+  FAM.registerPass([&] { return PassInstrumentationAnalysis(); });
+  ModuleAnalysisManager MAM;
+  int ModuleAnalysisRuns = 0;
+  MAM.registerPass([&] { return TestModuleAnalysis(ModuleAnalysisRuns); });
+
+  int FunctionPassRunCount = 0, AnalyzedInstrCount = 0,
+      AnalyzedFunctionCount = 0;
+  FunctionPassManager FPM;
+  // Compute the analysis, ...
+  FPM.addPass(TestFunctionPass(FunctionPassRunCount, AnalyzedInstrCount,
+                               AnalyzedFunctionCount, MAM));
+  // ... reuse it and preserve it across a change, ...
+  FPM.addPass(LambdaPass([](Function &F, FunctionAnalysisManager &AM) {
+    (void)AM.getResult<TestFunctionAnalysis>(F);
+    PreservedAnalyses PA;
+    PA.preserve<TestFunctionAnalysis>();
+    return PA;
+  }));
+  // ... invalidate it, ...
+  FPM.addPass(TestInvalidationFunctionPass("f"));
+  // ... and compute it again only to invalidate it without using it.
+  FPM.addPass(TestFunctionPass(FunctionPassRunCount, AnalyzedInstrCount,
+                               AnalyzedFunctionCount, MAM));
+  FPM.addPass(TestInvalidationFunctionPass("f"));
+  FPM.run(*M->getFunction("f"), FAM);
+  EXPECT_EQ(2, FunctionAnalysisRuns);
+
+  std::string Report;
+  raw_string_ostream OS(Report);
+  Tracker.print(OS);
+  // Computed twice, one cache hit, kept once, invalidated twice, recomputed
+  // once and one result was never reused.
+  EXPECT_NE(std::string::npos,
+            Report.find("         2        1        1         2        1"
+                        "        1  "))
+      << Report;
+  EXPECT_NE(std::string::npos, Report.find("TestFunctionAnalysis")) << Report;
+  EXPECT_EQ(std::string::npos, Report.find("PassInstrumentationAnalysis"))
+      << Report;
+
+  // Results deleted along with their IR unit are neither invalidated nor
+  // recomputed.
+  Tracker.reset();
+  (void)FAM.getResult<TestFunctionAnalysis>(*M->getFunction("g"));
+  FAM.clear(*M->getFunction("g"), "g");
+  (void)FAM.getResult<TestFunctionAnalysis>(*M->getFunction("g"));
+  Report.clear();
+  Tracker.print(OS);
+  EXPECT_NE(std::string::npos,
+            Report.find("         2        0        0         0        0"
+                        "        0  "))
+      << Report;
+  FAM.setInvalidationTracker(nullptr);
+}
+
 // Run SimplifyCFGPass that makes CFG changes and reports PreservedAnalyses
 // without CFGAnalyses. So the CFGChecker does not complain.
 TEST_F(PassManagerTest, FunctionPassCFGChecker) {
@@ -361,4 +361,41 @@ TEST_F(LinkModuleTest, RemangleIntrinsics) {
   ASSERT_EQ(F->getNumUses(), (unsigned)2);
 }
 
+TEST_F(LinkModuleTest, SourceConstantArrays) {
+  LLVMContext C;
+  SMDiagnostic Err;
+
+  // Destroying the source module frees the arrays that use its globals, such
+  // as the initializers of @vt and @llvm.used. The linker must not look at
+  // them afterwards when it drops the constant arrays the link made dead.
+  const char *DstStr = "@x = global i32 0\n"
+                       "@llvm.used = appending global [1 x ptr] [ptr @x]\n";
+  const char *SrcStr = "@vt = constant [2 x ptr] [ptr @f, ptr @g]\n"
+                       "@fp = global [1 x ptr] [ptr @f]\n"
+                       "@llvm.used = appending global [1 x ptr] [ptr @vt]\n"
+                       "define void @f() {\n"
+                       "  ret void\n"
+                       "}\n"
+                       "define void @g() {\n"
+                       "  ret void\n"
+                       "}\n";
+
+  std::unique_ptr<Module> Dst = parseAssemblyString(DstStr, Err, C);
+  ASSERT_TRUE(Dst);
+  std::unique_ptr<Module> Src = parseAssemblyString(SrcStr, Err, C);
+  ASSERT_TRUE(Src);
+
+  Ctx.setDiagnosticHandlerCallBack(expectNoDiags);
+  ASSERT_FALSE(Linker::linkModules(*Dst, std::move(Src)));
+
+  GlobalVariable *VT = Dst->getNamedGlobal("vt");
+  ASSERT_TRUE(VT);
+  auto *VTInit = cast<ConstantArray>(VT->getInitializer());
+  EXPECT_EQ(Dst->getFunction("f"), VTInit->getOperand(0));
+  EXPECT_EQ(Dst->getFunction("g"), VTInit->getOperand(1));
+  GlobalVariable *Used = Dst->getNamedGlobal("llvm.used");
+  ASSERT_TRUE(Used);
+  EXPECT_EQ(2u, cast<ConstantArray>(Used->getInitializer())->getNumOperands());
+}
+
 } // end anonymous namespace
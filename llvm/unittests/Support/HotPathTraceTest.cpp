@@ -0,0 +1,116 @@
+//===- unittests/HotPathTraceTest.cpp - HotPathTrace tests ----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// Compile the tracing macros in regardless of the build configuration.
+#undef LLVM_ENABLE_HOT_PATH_TRACE
+#define LLVM_ENABLE_HOT_PATH_TRACE 1
+
+#include "llvm/Support/HotPathTrace.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+#include <map>
+#include <thread>
+
+using namespace llvm;
+
+namespace {
+
+// Write the trace and return its events, other than metadata events.
+std::vector<json::Object> writeEvents() {
+  std::string S;
+  raw_string_ostream OS(S);
+  hotPathTraceWrite(OS, "test");
+  Expected<json::Value> Trace = json::parse(S);
+  EXPECT_TRUE(bool(Trace));
+  std::vector<json::Object> Events;
+  if (!Trace)
+    return Events;
+  for (json::Value &E : *Trace->getAsObject()->getArray("traceEvents"))
+    if (E.getAsObject()->getString("ph") != "M")
+      Events.push_back(std::move(*E.getAsObject()));
+  return Events;
+}
+
+class HotPathTraceTest : public testing::Test {
+protected:
+  void TearDown() override {
+    hotPathTraceDisable();
+    hotPathTraceClear();
+  }
+};
+
+TEST_F(HotPathTraceTest, Disabled) {
+  { LLVM_HOT_PATH_TRACE_SCOPE("scope", 0); }
+  LLVM_HOT_PATH_TRACE_INSTANT("instant", 0);
+  EXPECT_TRUE(writeEvents().empty());
+}
+
+TEST_F(HotPathTraceTest, ScopeAndInstant) {
+  hotPathTraceEnable();
+  {
+    LLVM_HOT_PATH_TRACE_SCOPE("scope", 42);
+    LLVM_HOT_PATH_TRACE_INSTANT("instant", 7);
+    // Make sure the scope has a non-zero duration.
+    uint64_t Begin = hotPathTraceNow();
+    while (hotPathTraceNow() == Begin)
+      ;
+  }
+  hotPathTraceDisable();
+  LLVM_HOT_PATH_TRACE_INSTANT("ignored", 0);
+
+  std::vector<json::Object> Events = writeEvents();
+  ASSERT_EQ(2u, Events.size());
+  EXPECT_EQ("instant", Events[0].getString("name"));
+  EXPECT_EQ("i", Events[0].getString("ph"));
+  EXPECT_EQ(7, Events[0].getObject("args")->getInteger("arg"));
+  EXPECT_EQ("scope", Events[1].getString("name"));
+  EXPECT_EQ("X", Events[1].getString("ph"));
+  EXPECT_EQ(42, Events[1].getObject("args")->getInteger("arg"));
+  EXPECT_GT(*Events[1].getNumber("dur"), 0);
+  EXPECT_LE(*Events[1].getNumber("ts"), *Events[0].getNumber("ts"));
+}
+
+// A full buffer keeps the newest records.
+TEST_F(HotPathTraceTest, RingBuffer) {
+  // A thread that has not traced yet, so that it gets a buffer of this size.
+  std::thread([] {
+    hotPathTraceEnable(/*RecordsPerThread=*/5);
+    for (unsigned I = 0; I != 20; ++I)
+      LLVM_HOT_PATH_TRACE_INSTANT("instant", I);
+  }).join();
+
+  std::vector<json::Object> Events = writeEvents();
+  ASSERT_EQ(8u, Events.size());
+  for (unsigned I = 0; I != 8; ++I)
+    EXPECT_EQ(12 + I, Events[I].getObject("args")->getInteger("arg"));
+
+  hotPathTraceClear();
+  EXPECT_TRUE(writeEvents().empty());
+}
+
+TEST_F(HotPathTraceTest, Threads) {
+  hotPathTraceEnable();
+  std::vector<std::thread> Threads;
+  for (unsigned I = 0; I != 4; ++I)
+    Threads.emplace_back([I] {
+      for (unsigned J = 0; J != 100; ++J)
+        LLVM_HOT_PATH_TRACE_INSTANT("instant", I);
+    });
+  for (std::thread &T : Threads)
+    T.join();
+
+  std::vector<json::Object> Events = writeEvents();
+  ASSERT_EQ(400u, Events.size());
+  std::map<int64_t, unsigned> NumPerTid;
+  for (json::Object &E : Events)
+    ++NumPerTid[*E.getInteger("tid")];
+  EXPECT_EQ(4u, NumPerTid.size());
+}
+
+} // namespace
@@ -436,6 +436,35 @@ TEST_F(MemoryBufferTest, mmapVolatileNoNull) {
   EXPECT_TRUE(MB->getBuffer().starts_with("01234567"));
 }
 
+TEST_F(MemoryBufferTest, getFiles) {
+  SmallVector<SmallString<64>, 8> Paths;
+  SmallVector<FileRemover, 8> Cleanup;
+  for (unsigned I = 0; I != 8; ++I) {
+    int FD;
+    SmallString<64> &TestPath = Paths.emplace_back();
+    ASSERT_NO_ERROR(sys::fs::createTemporaryFile("MemoryBufferTest_getFiles",
+                                                 "temp", FD, TestPath));
+    Cleanup.emplace_back(TestPath);
+    raw_fd_ostream OF(FD, true);
+    OF << "file " << I;
+  }
+
+  SmallVector<StringRef, 9> Filenames(Paths.begin(), Paths.end());
+  Filenames.insert(Filenames.begin() + 4, "MemoryBufferTest_getFiles_missing");
+  auto Results = MemoryBuffer::getFiles(Filenames);
+  ASSERT_EQ(9u, Results.size());
+  for (unsigned I = 0; I != 9; ++I) {
+    if (I == 4) {
+      EXPECT_EQ(std::errc::no_such_file_or_directory, Results[I].getError());
+      continue;
+    }
+    ASSERT_NO_ERROR(Results[I].getError());
+    EXPECT_EQ(Filenames[I], (*Results[I])->getBufferIdentifier());
+    EXPECT_EQ("file " + std::to_string(I < 4 ? I : I - 1),
+              (*Results[I])->getBuffer());
+  }
+}
+
 // Test that SmallVector without a null terminator gets one.
 TEST(SmallVectorMemoryBufferTest, WithoutNullTerminatorRequiresNullTerminator) {
   SmallString<0> Data("some data");
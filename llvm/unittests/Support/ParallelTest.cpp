@@ -98,7 +98,7 @@ TEST(Parallel, ForEachError) {
 TEST(Parallel, NestedTaskGroup) {
   // This test checks:
   // 1. Root TaskGroup is in Parallel mode.
-  // 2. Nested TaskGroup is not in Parallel mode.
+  // 2. Nested TaskGroup is in Parallel mode as well.
   parallel::TaskGroup tg;
 
   tg.spawn([&]() {
@@ -107,15 +107,17 @@ TEST(Parallel, NestedTaskGroup) {
 
   tg.spawn([&]() {
     parallel::TaskGroup nestedTG;
-    EXPECT_FALSE(nestedTG.isParallel());
+    EXPECT_TRUE(nestedTG.isParallel() ||
+                (parallel::strategy.ThreadsRequested == 1));
 
     nestedTG.spawn([&]() {
       // Check that root TaskGroup is in Parallel mode.
       EXPECT_TRUE(tg.isParallel() ||
                   (parallel::strategy.ThreadsRequested == 1));
 
-      // Check that nested TaskGroup is not in Parallel mode.
-      EXPECT_FALSE(nestedTG.isParallel());
+      // Check that nested TaskGroup is in Parallel mode.
+      EXPECT_TRUE(nestedTG.isParallel() ||
+                  (parallel::strategy.ThreadsRequested == 1));
     });
   });
 }
@@ -134,9 +136,10 @@ TEST(Parallel, ParallelNestedTaskGroup) {
         EXPECT_TRUE(tg.isParallel() ||
                     (parallel::strategy.ThreadsRequested == 1));
 
-        // Check that nested TaskGroup is not in Parallel mode.
+        // Check that nested TaskGroup is in Parallel mode.
         parallel::TaskGroup nestedTG;
-        EXPECT_FALSE(nestedTG.isParallel());
+        EXPECT_TRUE(nestedTG.isParallel() ||
+                    (parallel::strategy.ThreadsRequested == 1));
         ++Count;
 
         nestedTG.spawn([&]() {
@@ -144,8 +147,9 @@ TEST(Parallel, ParallelNestedTaskGroup) {
           EXPECT_TRUE(tg.isParallel() ||
                       (parallel::strategy.ThreadsRequested == 1));
 
-          // Check that nested TaskGroup is not in Parallel mode.
-          EXPECT_FALSE(nestedTG.isParallel());
+          // Check that nested TaskGroup is in Parallel mode.
+          EXPECT_TRUE(nestedTG.isParallel() ||
+                      (parallel::strategy.ThreadsRequested == 1));
           ++Count;
         });
       });
@@ -164,6 +168,34 @@ TEST(Parallel, ParallelNestedTaskGroup) {
   }
   EXPECT_EQ(Count, 12ul);
 }
+
+TEST(Parallel, NestedParallelFor) {
+  // Nested loops on worker threads run in parallel and must neither deadlock
+  // nor lose iterations.
+  std::atomic<size_t> Count{0};
+  parallelFor(0, 64, [&](size_t) {
+    parallelFor(0, 64, [&](size_t) {
+      parallelFor(0, 16, [&](size_t) { ++Count; });
+    });
+  });
+  EXPECT_EQ(Count, 64ul * 64 * 16);
+}
+
+TEST(Parallel, TaskPriority) {
+  std::atomic<size_t> Count{0};
+  {
+    parallel::TaskGroup tg;
+    for (size_t I = 0; I != 100; ++I)
+      tg.spawn([&] { ++Count; }, I % 2 ? parallel::TaskPriority::High
+                                       : parallel::TaskPriority::Normal);
+    tg.spawn([&] {
+      parallel::TaskGroup nestedTG;
+      for (size_t I = 0; I != 100; ++I)
+        nestedTG.spawn([&] { ++Count; }, parallel::TaskPriority::High);
+    });
+  }
+  EXPECT_EQ(Count, 200ul);
+}
 #endif
 
 #endif
@@ -0,0 +1,149 @@
+//===- llvm/unittest/Support/SlabPoolAllocatorTest.cpp --------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/SlabPoolAllocator.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/ThreadPool.h"
+#include "gtest/gtest.h"
+#include <cstring>
+#include <vector>
+
+using namespace llvm;
+
+namespace {
+
+TEST(SlabPoolAllocatorTest, ReusesFreedBlocks) {
+  SlabPoolAllocator Alloc;
+  void *A = Alloc.Allocate(24, 8);
+  Alloc.Deallocate(A, 24, 8);
+  // Sizes in the same class share a free list.
+  void *B = Alloc.Allocate(32, 16);
+  EXPECT_EQ(A, B);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(B) % SlabPoolAllocator::BlockAlign);
+  Alloc.Deallocate(B, 32, 16);
+
+  SlabPoolStats Stats = Alloc.getStats();
+  EXPECT_EQ(1u, Stats.NumSlabs);
+  EXPECT_EQ(0u, Stats.InUseBytes);
+}
+
+TEST(SlabPoolAllocatorTest, Stats) {
+  SlabPoolAllocator Alloc(4096, 256);
+  std::vector<void *> Ptrs;
+  for (unsigned I = 0; I != 1000; ++I)
+    Ptrs.push_back(Alloc.Allocate(48, 8));
+  SlabPoolStats Stats = Alloc.getStats();
+  EXPECT_EQ(1000u * 48, Stats.InUseBytes);
+  EXPECT_EQ(Stats.NumSlabs * 4096, Stats.SlabBytes);
+  EXPECT_LE(Stats.InUseBytes + Stats.FreeBytes, Stats.SlabBytes);
+
+  for (unsigned I = 0; I != 1000; I += 2)
+    Alloc.Deallocate(Ptrs[I], 48, 8);
+  Stats = Alloc.getStats();
+  EXPECT_EQ(500u * 48, Stats.InUseBytes);
+  EXPECT_GE(Stats.FreeBytes, 500u * 48);
+
+  // Requests above the pooled size or alignment bypass the slabs.
+  void *Large = Alloc.Allocate(1000, 8);
+  void *Aligned = Alloc.Allocate(16, 64);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(Aligned) % 64);
+  Stats = Alloc.getStats();
+  EXPECT_EQ(2u, Stats.NumLargeAllocations);
+  EXPECT_EQ(1016u, Stats.LargeBytes);
+  Alloc.Deallocate(Large, 1000, 8);
+  Alloc.Deallocate(Aligned, 16, 64);
+  EXPECT_EQ(0u, Alloc.getStats().LargeBytes);
+}
+
+struct TestListener : SlabPoolListener {
+  unsigned NumSlabs = 0;
+  unsigned NumLarge = 0;
+  unsigned NumReleased = 0;
+  size_t InUseAtRelease = 0;
+
+  void slabAllocated(size_t Size) override { ++NumSlabs; }
+  void largeAllocated(size_t Size) override { ++NumLarge; }
+  void largeDeallocated(size_t Size) override { --NumLarge; }
+  void released(const SlabPoolStats &Stats) override {
+    ++NumReleased;
+    InUseAtRelease = Stats.InUseBytes;
+  }
+};
+
+TEST(SlabPoolAllocatorTest, ListenerAndReset) {
+  TestListener L;
+  {
+    SlabPoolAllocator Alloc(1024, 128);
+    Alloc.setListener(&L);
+    for (unsigned I = 0; I != 100; ++I)
+      Alloc.Allocate<uint64_t>(4);
+    Alloc.Allocate(4096, 8);
+    EXPECT_EQ(4u, L.NumSlabs);
+    EXPECT_EQ(1u, L.NumLarge);
+
+    // Reset releases everything, including live blocks.
+    Alloc.Reset();
+    EXPECT_EQ(1u, L.NumReleased);
+    EXPECT_EQ(3200u, L.InUseAtRelease);
+    EXPECT_EQ(0u, Alloc.getTotalMemory());
+
+    void *P = Alloc.Allocate(8, 8);
+    std::memset(P, 0, 8);
+    EXPECT_EQ(5u, L.NumSlabs);
+  }
+  EXPECT_EQ(2u, L.NumReleased);
+  EXPECT_EQ(16u, L.InUseAtRelease);
+}
+
+#if LLVM_ENABLE_THREADS
+TEST(SlabPoolAllocatorTest, ConcurrentUse) {
+  SlabPoolAllocator Alloc;
+  constexpr unsigned NumTasks = 8;
+  constexpr unsigned NumAllocs = 10000;
+  std::vector<std::vector<void *>> Ptrs(NumTasks);
+  {
+    DefaultThreadPool Pool(hardware_concurrency(4));
+    for (unsigned T = 0; T != NumTasks; ++T) {
+      Pool.async([&, T] {
+        for (unsigned I = 0; I != NumAllocs; ++I) {
+          size_t Size = 8 + (I % 8) * 16;
+          auto *P = static_cast<unsigned *>(Alloc.Allocate(Size, 8));
+          *P = T;
+          Ptrs[T].push_back(P);
+          if (I % 3 == 0) {
+            Alloc.Deallocate(Ptrs[T].back(), Size, 8);
+            Ptrs[T].pop_back();
+          }
+        }
+      });
+    }
+  }
+  // Blocks must not have been handed out twice.
+  for (unsigned T = 0; T != NumTasks; ++T)
+    for (void *P : Ptrs[T])
+      EXPECT_EQ(T, *static_cast<unsigned *>(P));
+
+  // Free the blocks of one thread from other threads.
+  {
+    DefaultThreadPool Pool(hardware_concurrency(4));
+    for (unsigned T = 0; T != NumTasks; ++T) {
+      Pool.async([&, T] {
+        for (unsigned I = 0, J = 0; I != NumAllocs; ++I) {
+          if (I % 3 == 0)
+            continue;
+          size_t Size = 8 + (I % 8) * 16;
+          Alloc.Deallocate(Ptrs[T][J++], Size, 8);
+        }
+      });
+    }
+  }
+  EXPECT_EQ(0u, Alloc.getStats().InUseBytes);
+}
+#endif
+
+} // namespace
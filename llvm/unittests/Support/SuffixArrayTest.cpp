@@ -0,0 +1,80 @@
+//===- unittests/Support/SuffixArrayTest.cpp - suffix array tests ---------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/SuffixArray.h"
+#include "llvm/ADT/STLExtras.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+using namespace llvm;
+
+namespace {
+
+using Repeat = std::pair<unsigned, std::vector<unsigned>>;
+
+template <typename T> std::vector<Repeat> getRepeats(T &Substrings) {
+  std::vector<Repeat> Repeats;
+  for (auto It = Substrings.begin(); It != Substrings.end(); ++It) {
+    std::vector<unsigned> Starts((*It).StartIndices.begin(),
+                                 (*It).StartIndices.end());
+    llvm::sort(Starts);
+    Repeats.push_back({(*It).Length, std::move(Starts)});
+  }
+  llvm::sort(Repeats);
+  return Repeats;
+}
+
+TEST(SuffixArrayTest, TestSuffixesAndLCPs) {
+  // "banana" followed by a unique terminator, which sorts last.
+  std::vector<unsigned> Data = {2, 1, 3, 1, 3, 1, 100};
+  SuffixArray SA(Data);
+  EXPECT_EQ(SA.getSuffixes(), ArrayRef<unsigned>({1, 3, 5, 0, 2, 4, 6}));
+  EXPECT_EQ(SA.getLCPs(), ArrayRef<unsigned>({0, 3, 1, 0, 0, 2, 0}));
+}
+
+TEST(SuffixArrayTest, TestSubstringRepeats) {
+  std::vector<unsigned> Data = {1, 2, 100, 1, 2, 101, 1,
+                                2, 3, 103, 1, 2, 3,   104};
+  SuffixArray SA(Data);
+  std::vector<Repeat> Expected = {
+      {2, {0, 3, 6, 10}}, {2, {7, 11}}, {3, {6, 10}}};
+  EXPECT_EQ(getRepeats(SA), Expected);
+}
+
+TEST(SuffixArrayTest, TestNoRepeats) {
+  std::vector<unsigned> Empty;
+  SuffixArray EmptySA(Empty);
+  EXPECT_TRUE(EmptySA.begin() == EmptySA.end());
+
+  std::vector<unsigned> Data = {1, 2, 3, 1, 4};
+  SuffixArray SA(Data);
+  EXPECT_TRUE(SA.begin() == SA.end());
+}
+
+// The suffix array finds the same repeated substrings as a suffix tree with
+// leaf descendants.
+TEST(SuffixArrayTest, TestMatchesSuffixTree) {
+  uint64_t State = 1;
+  for (unsigned Round = 0; Round != 50; ++Round) {
+    std::vector<unsigned> Data;
+    unsigned Len = 1 + Round * 7;
+    unsigned Alphabet = 1 + Round % 4;
+    for (unsigned I = 0; I != Len; ++I) {
+      State = State * 6364136223846793005 + 1442695040888963407;
+      Data.push_back((State >> 33) % Alphabet);
+    }
+    Data.push_back(1000);
+    SuffixTree ST(Data, /*OutlinerLeafDescendants=*/true);
+    SuffixArray SA(Data);
+    EXPECT_EQ(getRepeats(SA), getRepeats(ST)) << "round " << Round;
+  }
+}
+
+} // namespace
@@ -242,6 +242,26 @@ TYPED_TEST(ThreadPoolTest, PoolDestruction) {
   ASSERT_EQ(5, checked_in);
 }
 
+TYPED_TEST(ThreadPoolTest, AsyncOnNode) {
+  CHECK_UNSUPPORTED();
+  // Node hints are only a preference, all tasks must run whether or not the
+  // workers are pinned and the node exists.
+  ThreadPoolStrategy S = hardware_concurrency(2);
+  S.PinToNUMANode = true;
+  DefaultThreadPool Pool(S);
+  ThreadPoolTaskGroup Group(Pool);
+  std::atomic_int checked_in{0};
+  for (unsigned I = 0; I < 8; ++I) {
+    Pool.asyncOnNode(I, [&checked_in] { ++checked_in; });
+    Group.asyncOnNode(I, [&checked_in] { ++checked_in; });
+  }
+  auto F = Pool.asyncOnNode(0, [] { return 1; });
+  Group.wait();
+  Pool.wait();
+  ASSERT_EQ(16, checked_in);
+  ASSERT_EQ(1, F.get());
+}
+
 // Check running tasks in different groups.
 TYPED_TEST(ThreadPoolTest, Groups) {
   CHECK_UNSUPPORTED();
@@ -58,6 +58,37 @@ TEST(Threading, NumPhysicalCoresUnsupported) {
   ASSERT_EQ(Num, -1);
 }
 
+TEST(Threading, ThreadPoolStrategyNUMA) {
+  std::optional<ThreadPoolStrategy> S = get_threadpool_strategy("4:numa");
+  ASSERT_TRUE(S);
+  EXPECT_EQ(S->ThreadsRequested, 4u);
+  EXPECT_TRUE(S->PinToNUMANode);
+
+  S = get_threadpool_strategy("all:numa");
+  ASSERT_TRUE(S);
+  EXPECT_EQ(S->ThreadsRequested, 0u);
+  EXPECT_TRUE(S->PinToNUMANode);
+
+  S = get_threadpool_strategy(":numa", heavyweight_hardware_concurrency());
+  ASSERT_TRUE(S);
+  EXPECT_FALSE(S->UseHyperThreads);
+  EXPECT_TRUE(S->PinToNUMANode);
+
+  S = get_threadpool_strategy("4");
+  ASSERT_TRUE(S);
+  EXPECT_FALSE(S->PinToNUMANode);
+  EXPECT_FALSE(S->compute_numa_node(0));
+
+  EXPECT_FALSE(get_threadpool_strategy("numa"));
+
+  // Threads are distributed round-robin over the nodes.
+  S->PinToNUMANode = true;
+  if (get_cpus() > 1)
+    EXPECT_EQ(S->compute_numa_node(get_cpus() + 1), 1u);
+  else
+    EXPECT_FALSE(S->compute_numa_node(1));
+}
+
 #if LLVM_ENABLE_THREADS
 
 class Notification {
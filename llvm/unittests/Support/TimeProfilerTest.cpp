@@ -6,7 +6,7 @@
 //
 //===----------------------------------------------------------------------===//
 // These are bare-minimum 'smoke' tests of the time profiler. Not tested:
-//  - multi-threading
+//  - multi-threading, other than tracing of parallel tasks
 //  - 'Total' entries
 //  - elision of short or ill-formed entries
 //  - detail callback
@@ -15,6 +15,8 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Support/TimeProfiler.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/Parallel.h"
 #include "gtest/gtest.h"
 
 using namespace llvm;
@@ -65,6 +67,21 @@ TEST(TimeProfiler, Async_Begin_End_Smoke) {
   ASSERT_TRUE(json.find(R"("detail":"detail")") != std::string::npos);
 }
 
+TEST(TimeProfiler, Parallel_Tasks) {
+  setupProfiler();
+
+  parallel::traceTasks = true;
+  parallelFor(0, 4, [](size_t) { TimeTraceScope scope("work"); });
+  parallel::traceTasks = false;
+
+  std::string json = teardownProfiler();
+  ASSERT_TRUE(json.find(R"("name":"work")") != std::string::npos);
+#if LLVM_ENABLE_THREADS
+  if (parallel::strategy.ThreadsRequested != 1)
+    ASSERT_TRUE(json.find(R"("name":"Parallel task")") != std::string::npos);
+#endif
+}
+
 TEST(TimeProfiler, Begin_End_Disabled) {
   // Nothing should be observable here. The test is really just making sure
   // we've not got a stray nullptr deref.
@@ -0,0 +1,97 @@
+//===- llvm/unittest/Support/raw_iovec_ostream_test.cpp -------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/raw_iovec_ostream.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "gtest/gtest.h"
+#include <string>
+
+using namespace llvm;
+
+namespace {
+
+class raw_iovec_ostreamTest : public testing::Test {
+protected:
+  void SetUp() override {
+    ASSERT_FALSE(sys::fs::createTemporaryFile("raw_iovec_ostream", "bin", FD,
+                                              Path));
+  }
+
+  void TearDown() override { sys::fs::remove(Path); }
+
+  std::string readBack() {
+    auto MB = MemoryBuffer::getFile(Path);
+    EXPECT_TRUE(bool(MB));
+    return MB ? (*MB)->getBuffer().str() : "";
+  }
+
+  SmallString<64> Path;
+  int FD;
+};
+
+TEST_F(raw_iovec_ostreamTest, Mixed) {
+  std::string Expected;
+  std::string Stable(1000, 'x');
+  {
+    raw_fd_ostream FOS(FD, /*shouldClose=*/true);
+    FOS << "head:";
+    raw_iovec_ostream OS(FOS);
+    EXPECT_TRUE(isa<raw_iovec_ostream>(static_cast<raw_ostream &>(OS)));
+    EXPECT_EQ(5u, OS.tell());
+    for (unsigned I = 0; I != 3000; ++I) {
+      OS << I << ',';
+      Expected += std::to_string(I) + ',';
+      if (I % 100 == 0) {
+        OS.writeStable(Stable);
+        Expected += Stable;
+      }
+    }
+    std::string Large(200000, 'y');
+    OS << Large;
+    Expected += Large;
+    EXPECT_EQ(5 + Expected.size(), OS.tell());
+  }
+  EXPECT_EQ("head:" + Expected, readBack());
+}
+
+TEST_F(raw_iovec_ostreamTest, ManyFragments) {
+  // More stable fragments than a single flush takes.
+  SmallVector<std::string, 0> Pieces;
+  for (unsigned I = 0; I != 3000; ++I)
+    Pieces.emplace_back(raw_iovec_ostream::MinStableSize, 'a' + I % 26);
+  std::string Expected;
+  {
+    raw_fd_ostream FOS(FD, /*shouldClose=*/true);
+    raw_iovec_ostream OS(FOS);
+    for (const std::string &P : Pieces) {
+      OS.writeStable(P);
+      Expected += P;
+    }
+    OS.flushPending();
+    EXPECT_EQ(Expected.size(), FOS.tell());
+  }
+  EXPECT_EQ(Expected, readBack());
+}
+
+TEST_F(raw_iovec_ostreamTest, Pwrite) {
+  std::string Stable(512, 's');
+  {
+    raw_fd_ostream FOS(FD, /*shouldClose=*/true);
+    raw_iovec_ostream OS(FOS);
+    OS << "0000";
+    OS.writeStable(Stable);
+    OS << "tail";
+    OS.pwrite("abcd", 4, 0);
+    OS << "!";
+  }
+  EXPECT_EQ("abcd" + Stable + "tail!", readBack());
+}
+
+} // namespace
@@ -0,0 +1,300 @@
+//===- ParallelFunctionOptimizerTest.cpp ----------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Transforms/IPO/ParallelFunctionOptimizer.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/CAS/ActionCache.h"
+#include "llvm/CAS/ObjectStore.h"
+#include "llvm/IR/DebugInfoMetadata.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/InstIterator.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/PatternMatch.h"
+#include "llvm/IR/Verifier.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Testing/Support/Error.h"
+#include "llvm/Testing/Support/SupportHelpers.h"
+#include "gtest/gtest.h"
+#include <atomic>
+#include <mutex>
+
+using namespace llvm;
+using namespace llvm::PatternMatch;
+
+namespace {
+
+class ParallelFunctionOptimizerTest : public testing::Test {
+protected:
+  void parseModule(const char *IR) {
+    SMDiagnostic Err;
+    M = parseAssemblyString(IR, Err, Ctx);
+    if (!M)
+      Err.print("ParallelFunctionOptimizerTest", errs());
+    ASSERT_TRUE(M);
+  }
+
+  LLVMContext Ctx;
+  std::unique_ptr<Module> M;
+};
+
+/// Replace "add X, 0" with X in every function definition of \p M.
+void foldAddZero(Module &M) {
+  for (Function &F : M)
+    for (Instruction &I : make_early_inc_range(instructions(F)))
+      if (Value *X; match(&I, m_Add(m_Value(X), m_Zero()))) {
+        I.replaceAllUsesWith(X);
+        I.eraseFromParent();
+      }
+}
+
+TEST_F(ParallelFunctionOptimizerTest, MovesBodiesBack) {
+  parseModule(R"(
+    %struct.S = type { i32, i32 }
+
+    @g = internal global i32 0
+
+    define internal i32 @callee(i32 %x) {
+      %y = add i32 %x, 0
+      ret i32 %y
+    }
+
+    define i32 @f1(i32 %x) {
+      %a = call i32 @callee(i32 %x)
+      %b = load i32, ptr @g
+      %c = add i32 %a, %b
+      ret i32 %c
+    }
+
+    define i32 @f2(ptr %p) {
+      %q = getelementptr %struct.S, ptr %p, i32 0, i32 1
+      %v = load i32, ptr %q
+      %w = add i32 %v, 0
+      ret i32 %w
+    }
+
+    define void @f3() {
+      store i32 1, ptr @g
+      ret void
+    }
+  )");
+  Function *Callee = M->getFunction("callee");
+  Function *F1 = M->getFunction("f1");
+  Function *F2 = M->getFunction("f2");
+  GlobalVariable *G = M->getNamedGlobal("g");
+
+  std::mutex Mutex;
+  StringMap<unsigned> Definitions;
+  std::atomic<unsigned> NumPartitions = 0;
+  optimizeFunctionsInParallel(*M, 3, [&](Module &MPart) {
+    EXPECT_NE(&MPart.getContext(), &Ctx);
+    ++NumPartitions;
+    {
+      std::lock_guard<std::mutex> Lock(Mutex);
+      for (Function &F : MPart)
+        if (!F.isDeclaration())
+          ++Definitions[F.getName()];
+    }
+    foldAddZero(MPart);
+    // Add a call to a new function and a new global to @f1.
+    if (Function *F = MPart.getFunction("f1"); F && !F->isDeclaration()) {
+      LLVMContext &PartCtx = MPart.getContext();
+      FunctionCallee NewF = MPart.getOrInsertFunction(
+          "new_decl", Type::getVoidTy(PartCtx), PointerType::get(PartCtx, 0));
+      auto *NewG = new GlobalVariable(
+          MPart, Type::getInt32Ty(PartCtx), true, GlobalValue::PrivateLinkage,
+          ConstantInt::get(Type::getInt32Ty(PartCtx), 42), "new_global");
+      IRBuilder<> B(&F->getEntryBlock().front());
+      B.CreateCall(NewF, {NewG});
+    }
+  });
+
+  EXPECT_EQ(NumPartitions, 3u);
+  EXPECT_EQ(Definitions.size(), 4u);
+  for (const auto &Entry : Definitions)
+    EXPECT_EQ(Entry.second, 1u) << Entry.first().str();
+
+  EXPECT_FALSE(verifyModule(*M, &errs()));
+  EXPECT_EQ(M->getFunction("callee"), Callee);
+  EXPECT_TRUE(Callee->hasInternalLinkage());
+  EXPECT_EQ(M->getNamedGlobal("g"), G);
+
+  // The add of zero is gone, and the bodies refer to the original globals.
+  EXPECT_TRUE(isa<ReturnInst>(Callee->getEntryBlock().front()));
+  for (Function &F : *M)
+    for (Instruction &I : instructions(F))
+      EXPECT_FALSE(match(&I, m_Add(m_Value(), m_Zero())));
+  SmallVector<Function *> Callees;
+  for (Instruction &I : instructions(F1))
+    if (auto *CB = dyn_cast<CallBase>(&I))
+      Callees.push_back(CB->getCalledFunction());
+  ASSERT_EQ(Callees.size(), 2u);
+  EXPECT_EQ(Callees[0], M->getFunction("new_decl"));
+  EXPECT_TRUE(Callees[0]->isDeclaration());
+  EXPECT_EQ(Callees[1], Callee);
+  EXPECT_TRUE(G->hasNUsesOrMore(2));
+  GlobalVariable *NewG = M->getNamedGlobal("new_global");
+  ASSERT_TRUE(NewG);
+  EXPECT_TRUE(NewG->hasPrivateLinkage());
+  EXPECT_EQ(NewG->getInitializer(),
+            ConstantInt::get(Type::getInt32Ty(Ctx), 42));
+
+  // Types are those of the original module.
+  auto *GEP = cast<GetElementPtrInst>(&F2->getEntryBlock().front());
+  EXPECT_EQ(GEP->getSourceElementType(),
+            StructType::getTypeByName(Ctx, "struct.S"));
+}
+
+TEST_F(ParallelFunctionOptimizerTest, KeepsDebugInfo) {
+  parseModule(R"(
+    define void @f() !dbg !5 {
+      ret void, !dbg !8
+    }
+
+    define void @g() !dbg !9 {
+      ret void, !dbg !10
+    }
+
+    !llvm.dbg.cu = !{!0}
+    !llvm.module.flags = !{!3, !4}
+
+    !0 = distinct !DICompileUnit(language: DW_LANG_C99, file: !1,
+                                 producer: "clang", isOptimized: true,
+                                 runtimeVersion: 0, emissionKind: FullDebug)
+    !1 = !DIFile(filename: "t.c", directory: "/")
+    !3 = !{i32 2, !"Debug Info Version", i32 3}
+    !4 = !{i32 2, !"Dwarf Version", i32 5}
+    !5 = distinct !DISubprogram(name: "f", scope: !1, file: !1, line: 1,
+                                type: !6, scopeLine: 1,
+                                spFlags: DISPFlagDefinition, unit: !0)
+    !6 = !DISubroutineType(types: !7)
+    !7 = !{null}
+    !8 = !DILocation(line: 1, column: 1, scope: !5)
+    !9 = distinct !DISubprogram(name: "g", scope: !1, file: !1, line: 2,
+                                type: !6, scopeLine: 2,
+                                spFlags: DISPFlagDefinition, unit: !0)
+    !10 = !DILocation(line: 2, column: 1, scope: !9)
+  )");
+  DISubprogram *SPF = M->getFunction("f")->getSubprogram();
+  DISubprogram *SPG = M->getFunction("g")->getSubprogram();
+
+  optimizeFunctionsInParallel(*M, 2, [](Module &) {});
+
+  bool BrokenDebugInfo = false;
+  EXPECT_FALSE(verifyModule(*M, &errs(), &BrokenDebugInfo));
+  EXPECT_FALSE(BrokenDebugInfo);
+  EXPECT_EQ(M->getFunction("f")->getSubprogram(), SPF);
+  EXPECT_EQ(M->getFunction("g")->getSubprogram(), SPG);
+  const Instruction &Ret = M->getFunction("f")->getEntryBlock().front();
+  EXPECT_EQ(Ret.getDebugLoc()->getScope(), SPF);
+}
+
+TEST_F(ParallelFunctionOptimizerTest, FallsBackToModule) {
+  parseModule(R"(
+    @p = global ptr blockaddress(@f, %bb)
+
+    define void @f() {
+      br label %bb
+    bb:
+      ret void
+    }
+
+    define void @g() {
+      ret void
+    }
+  )");
+  unsigned NumCalls = 0;
+  optimizeFunctionsInParallel(*M, 2, [&](Module &MPart) {
+    EXPECT_EQ(&MPart, M.get());
+    ++NumCalls;
+  });
+  EXPECT_EQ(NumCalls, 1u);
+}
+
+TEST_F(ParallelFunctionOptimizerTest, CachesFunctions) {
+  unittest::TempDir Dir("pipeline-cache", /*Unique=*/true);
+  std::unique_ptr<cas::ObjectStore> Objects;
+  ASSERT_THAT_ERROR(
+      cas::ObjectStore::open(Dir.path("cas"), 1 << 20).moveInto(Objects),
+      Succeeded());
+  std::unique_ptr<cas::ActionCache> Actions;
+  ASSERT_THAT_ERROR(
+      cas::ActionCache::open(Dir.path("cas"), 1 << 20).moveInto(Actions),
+      Succeeded());
+  FunctionPipelineCache Cache{*Objects, *Actions, "fold-add-zero"};
+
+  // Two modules define the same inline function, next to different code.
+  const char *Inline = R"(
+    define linkonce_odr i32 @inl(i32 %x) {
+      %y = add i32 %x, 0
+      %z = load i32, ptr @c
+      %r = add i32 %y, %z
+      ret i32 %r
+    }
+  )";
+  std::string IR1 = std::string(R"(
+    @c = linkonce_odr constant i32 1
+    @unrelated = global i32 0
+    declare void @other()
+    define i32 @f1(i32 %x) {
+      %r = call i32 @inl(i32 %x)
+      ret i32 %r
+    }
+  )") + Inline;
+  std::string IR2 = std::string(R"(
+    @c = linkonce_odr constant i32 1
+    define i32 @f2(i32 %x) {
+      %a = add i32 %x, 0
+      %r = call i32 @inl(i32 %a)
+      ret i32 %r
+    }
+  )") + Inline;
+
+  std::mutex Mutex;
+  StringMap<unsigned> Optimized;
+  auto OptimizeAndCount = [&](Module &MPart) {
+    {
+      std::lock_guard<std::mutex> Lock(Mutex);
+      for (Function &F : MPart)
+        if (!F.isDeclaration())
+          ++Optimized[F.getName()];
+    }
+    foldAddZero(MPart);
+  };
+  auto CheckFolded = [&] {
+    EXPECT_FALSE(verifyModule(*M, &errs()));
+    for (Function &F : *M)
+      for (Instruction &I : instructions(F))
+        EXPECT_FALSE(match(&I, m_Add(m_Value(), m_Zero())));
+  };
+
+  parseModule(IR1.c_str());
+  optimizeFunctionsWithCache(*M, Cache, 2, OptimizeAndCount);
+  CheckFolded();
+  EXPECT_EQ(Optimized.lookup("inl"), 1u);
+  EXPECT_EQ(Optimized.lookup("f1"), 1u);
+  EXPECT_TRUE(M->getNamedGlobal("unrelated"));
+
+  parseModule(IR2.c_str());
+  optimizeFunctionsWithCache(*M, Cache, 2, OptimizeAndCount);
+  CheckFolded();
+  // @inl came from the cache.
+  EXPECT_EQ(Optimized.lookup("inl"), 1u);
+  EXPECT_EQ(Optimized.lookup("f2"), 1u);
+  auto *Load = cast<LoadInst>(&M->getFunction("inl")->getEntryBlock().front());
+  EXPECT_EQ(Load->getPointerOperand(), M->getNamedGlobal("c"));
+
+  // A different pipeline does not reuse the results.
+  Cache.PipelineKey = "other";
+  parseModule(IR2.c_str());
+  optimizeFunctionsWithCache(*M, Cache, 1, OptimizeAndCount);
+  EXPECT_EQ(Optimized.lookup("inl"), 2u);
+}
+
+} // end anonymous namespace
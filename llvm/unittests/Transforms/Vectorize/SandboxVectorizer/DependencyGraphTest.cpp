@@ -212,3 +212,67 @@ define void @foo(ptr %ptr, i8 %v0, i8 %v1) {
       getPtrVec(sandboxir::MemDGNodeIntervalBuilder::make({Add0, Add0}, DAG)),
       testing::ElementsAre());
 }
+
+TEST_F(DependencyGraphTest, ExtendIncrementally) {
+  parseIR(C, R"IR(
+define void @foo(ptr %ptr, i8 %v0, i8 %v1) {
+  %add0 = add i8 %v0, %v0
+  store i8 %v0, ptr %ptr
+  %add1 = add i8 %v0, %v0
+  store i8 %v1, ptr %ptr
+  %add2 = add i8 %v1, %v1
+  store i8 %v1, ptr %ptr
+  ret void
+}
+)IR");
+  llvm::Function *LLVMF = &*M->getFunction("foo");
+  sandboxir::Context Ctx(C);
+  auto *F = Ctx.createFunction(LLVMF);
+  auto *BB = &*F->begin();
+  auto It = BB->begin();
+  auto *Add0 = cast<sandboxir::BinaryOperator>(&*It++);
+  auto *S0 = cast<sandboxir::StoreInst>(&*It++);
+  auto *Add1 = cast<sandboxir::BinaryOperator>(&*It++);
+  auto *S1 = cast<sandboxir::StoreInst>(&*It++);
+  auto *Add2 = cast<sandboxir::BinaryOperator>(&*It++);
+  auto *S2 = cast<sandboxir::StoreInst>(&*It++);
+  auto *Ret = cast<sandboxir::ReturnInst>(&*It++);
+
+  sandboxir::DependencyGraph DAG;
+  // Start from the middle of the block.
+  auto Span = DAG.extend({Add1, S1});
+  EXPECT_EQ(Span.top(), Add1);
+  EXPECT_EQ(Span.bottom(), S1);
+  EXPECT_EQ(DAG.getNode(S0), nullptr);
+  auto *S1N = cast<sandboxir::MemDGNode>(DAG.getNode(S1));
+  EXPECT_TRUE(DAG.getNode(Add1)->memPreds().empty());
+  EXPECT_TRUE(S1N->memPreds().empty());
+
+  // Extend upwards. The existing nodes now depend on S0.
+  DAG.extend({Add0, S0});
+  auto *S0N = cast<sandboxir::MemDGNode>(DAG.getNode(S0));
+  EXPECT_TRUE(DAG.getNode(Add0)->memPreds().empty());
+  EXPECT_TRUE(S0N->memPreds().empty());
+  EXPECT_THAT(DAG.getNode(Add1)->memPreds(), testing::ElementsAre(S0N));
+  EXPECT_THAT(S1N->memPreds(), testing::ElementsAre(S0N));
+  EXPECT_EQ(S0N->getNextNode(), S1N);
+  EXPECT_EQ(S1N->getPrevNode(), S0N);
+
+  // Extending within the DAG creates no new nodes.
+  DAG.extend({S0, S1});
+  EXPECT_EQ(DAG.getInterval(),
+            sandboxir::Interval<sandboxir::Instruction>(Add0, S1));
+  EXPECT_THAT(S1N->memPreds(), testing::ElementsAre(S0N));
+
+  // Extend downwards, skipping over Add2 which must also be added.
+  DAG.extend({Ret});
+  EXPECT_EQ(DAG.getInterval(),
+            sandboxir::Interval<sandboxir::Instruction>(Add0, Ret));
+  auto *S2N = cast<sandboxir::MemDGNode>(DAG.getNode(S2));
+  EXPECT_THAT(DAG.getNode(Add2)->memPreds(), testing::ElementsAre(S1N));
+  EXPECT_THAT(S2N->memPreds(), testing::ElementsAre(S1N));
+  EXPECT_THAT(DAG.getNode(Ret)->memPreds(), testing::ElementsAre(S2N));
+  EXPECT_EQ(S1N->getNextNode(), S2N);
+  EXPECT_EQ(S2N->getPrevNode(), S1N);
+  EXPECT_EQ(S2N->getNextNode(), nullptr);
+}
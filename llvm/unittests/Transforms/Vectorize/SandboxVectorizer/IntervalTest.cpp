@@ -249,3 +249,49 @@ define void @foo(i8 %v0) {
     EXPECT_THAT(getPtrVec(Intersection), testing::ElementsAre(I1));
   }
 }
+
+TEST_F(IntervalTest, UnionInterval) {
+  parseIR(C, R"IR(
+define void @foo(i8 %v0) {
+  %I0 = add i8 %v0, %v0
+  %I1 = add i8 %v0, %v0
+  %I2 = add i8 %v0, %v0
+  ret void
+}
+)IR");
+  Function &LLVMF = *M->getFunction("foo");
+  sandboxir::Context Ctx(C);
+  auto &F = *Ctx.createFunction(&LLVMF);
+  auto *BB = &*F.begin();
+  auto It = BB->begin();
+  auto *I0 = &*It++;
+  auto *I1 = &*It++;
+  auto *I2 = &*It++;
+  auto *Ret = &*It++;
+
+  {
+    // Check [I0] U []
+    sandboxir::Interval<sandboxir::Instruction> I0I0(I0, I0);
+    sandboxir::Interval<sandboxir::Instruction> Empty;
+    EXPECT_THAT(getPtrVec(I0I0.getUnionInterval(Empty)),
+                testing::ElementsAre(I0));
+    EXPECT_THAT(getPtrVec(Empty.getUnionInterval(I0I0)),
+                testing::ElementsAre(I0));
+  }
+  {
+    // Check [I0,I1] U [I1,I2]
+    sandboxir::Interval<sandboxir::Instruction> I0I1(I0, I1);
+    sandboxir::Interval<sandboxir::Instruction> I1I2(I1, I2);
+    EXPECT_THAT(getPtrVec(I0I1.getUnionInterval(I1I2)),
+                testing::ElementsAre(I0, I1, I2));
+    EXPECT_THAT(getPtrVec(I1I2.getUnionInterval(I0I1)),
+                testing::ElementsAre(I0, I1, I2));
+  }
+  {
+    // Check [I0] U [Ret], which also includes the instructions in between.
+    sandboxir::Interval<sandboxir::Instruction> I0I0(I0, I0);
+    sandboxir::Interval<sandboxir::Instruction> RetRet(Ret, Ret);
+    EXPECT_THAT(getPtrVec(RetRet.getUnionInterval(I0I0)),
+                testing::ElementsAre(I0, I1, I2, Ret));
+  }
+}
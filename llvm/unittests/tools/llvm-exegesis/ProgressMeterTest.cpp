@@ -55,6 +55,20 @@ TEST(ProgressMeterTest, Integration) {
             TempString);
 }
 
+TEST(ProgressMeterTest, StepsWithKnownDuration) {
+  CurrentTimePoint = 0;
+  std::string TempString;
+  raw_string_ostream SS(TempString);
+  ProgressMeter<PreprogrammedClock> m(2, SS);
+  // The first step is accounted for 10 + (5 - 0) seconds, the second one for
+  // 2 + (20 - 6) seconds.
+  { decltype(m)::ProgressMeterStep s(&m, std::chrono::seconds(10)); }
+  { decltype(m)::ProgressMeterStep s(&m, std::chrono::seconds(2)); }
+  ASSERT_EQ("Processing...  50%, ETA 00:15\n"
+            "Processing... 100%, ETA 00:00\n",
+            TempString);
+}
+
 } // namespace
 } // namespace exegesis
 } // namespace llvm
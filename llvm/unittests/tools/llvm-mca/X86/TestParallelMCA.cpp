@@ -0,0 +1,96 @@
+#include "Views/SummaryView.h"
+#include "X86TestBase.h"
+#include "llvm/MCA/CustomBehaviour.h"
+#include "llvm/MCA/InstrBuilder.h"
+#include "llvm/MCA/Pipeline.h"
+#include "llvm/MCA/SourceMgr.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/ThreadPool.h"
+#include <memory>
+
+using namespace llvm;
+using namespace mca;
+
+namespace {
+
+/// The state that llvm-mca keeps for each code region it simulates.
+struct Region {
+  SmallVector<MCInst> MCIs;
+  std::unique_ptr<mca::InstrBuilder> IB;
+  SmallVector<std::unique_ptr<mca::Instruction>> LoweredSequence;
+  std::unique_ptr<mca::CircularSourceMgr> S;
+  std::unique_ptr<mca::CustomBehaviour> CB;
+  std::unique_ptr<mca::Context> MCA;
+  std::unique_ptr<mca::Pipeline> P;
+  std::unique_ptr<SummaryView> SV;
+  bool Succeeded = false;
+};
+
+} // namespace
+
+// Independent regions that are set up in order but simulated concurrently
+// must produce the same reports as regions simulated one at a time.
+TEST_F(X86TestBase, TestParallelRegions) {
+  auto PO = getDefaultPipelineOptions();
+  auto IM = std::make_unique<mca::InstrumentManager>(*STI, *MCII);
+  const SmallVector<mca::Instrument *> Instruments;
+
+  constexpr unsigned Repeats[] = {1, 7, 30, 100, 3, 64, 12, 200};
+  std::vector<std::unique_ptr<Region>> Regions;
+  for (unsigned R : Repeats) {
+    auto Rg = std::make_unique<Region>();
+    getSimpleInsts(Rg->MCIs, R);
+    Rg->IB = std::make_unique<mca::InstrBuilder>(*STI, *MCII, *MRI, MCIA.get(),
+                                                 *IM, /*CallLatency=*/100);
+    for (const MCInst &MCI : Rg->MCIs) {
+      Expected<std::unique_ptr<mca::Instruction>> InstOrErr =
+          Rg->IB->createInstruction(MCI, Instruments);
+      ASSERT_TRUE(bool(InstOrErr));
+      Rg->LoweredSequence.emplace_back(std::move(InstOrErr.get()));
+    }
+    Rg->S = std::make_unique<mca::CircularSourceMgr>(Rg->LoweredSequence,
+                                                     /*Iterations=*/0);
+    Rg->CB = std::make_unique<mca::CustomBehaviour>(*STI, *Rg->S, *MCII);
+    Rg->MCA = std::make_unique<mca::Context>(*MRI, *STI);
+    Rg->P = Rg->MCA->createDefaultPipeline(PO, *Rg->S, *Rg->CB);
+    ASSERT_TRUE(Rg->P);
+    Rg->SV = std::make_unique<SummaryView>(STI->getSchedModel(), Rg->MCIs,
+                                           PO.DispatchWidth);
+    Rg->P->addEventListener(Rg->SV.get());
+    Regions.push_back(std::move(Rg));
+  }
+
+  {
+    DefaultThreadPool Pool(hardware_concurrency(4));
+    for (std::unique_ptr<Region> &Rg : Regions)
+      Pool.async([&Rg] {
+        Expected<unsigned> Cycles = Rg->P->run();
+        Rg->Succeeded = bool(Cycles);
+        consumeError(Cycles.takeError());
+      });
+    Pool.wait();
+  }
+
+  constexpr const char *Fields[] = {"Instructions", "TotalCycles", "TotaluOps",
+                                    "BlockRThroughput"};
+  for (std::unique_ptr<Region> &Rg : Regions) {
+    ASSERT_TRUE(Rg->Succeeded);
+
+    json::Value Result = Rg->SV->toJSON();
+    auto *ResultObj = Result.getAsObject();
+    ASSERT_TRUE(ResultObj);
+
+    json::Object BaselineResult;
+    auto E = runBaselineMCA(BaselineResult, Rg->MCIs);
+    ASSERT_FALSE(bool(E)) << "Failed to run baseline";
+    auto *BaselineObj = BaselineResult.getObject(Rg->SV->getNameAsString());
+    ASSERT_TRUE(BaselineObj) << "Does not contain SummaryView result";
+
+    for (const auto *F : Fields) {
+      auto V = ResultObj->getInteger(F);
+      auto BV = BaselineObj->getInteger(F);
+      ASSERT_TRUE(V && BV);
+      ASSERT_EQ(*BV, *V) << "Value of '" << F << "' does not match";
+    }
+  }
+}
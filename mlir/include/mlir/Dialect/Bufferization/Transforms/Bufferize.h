@@ -36,6 +36,7 @@ struct BufferizationStatistics {
   int64_t numBufferDealloc = 0;
   int64_t numTensorInPlace = 0;
   int64_t numTensorOutOfPlace = 0;
+  int64_t numConflictChecks = 0;
 };
 
 /// A helper type converter class that automatically populates the relevant
@@ -113,6 +113,12 @@ public:
 
   int64_t getStatNumTensorOutOfPlace() const { return statNumTensorOutOfPlace; }
   int64_t getStatNumTensorInPlace() const { return statNumTensorInPlace; }
+  int64_t getStatNumConflictChecks() const { return statNumConflictChecks; }
+
+  /// Record that `numPairs` read/write pairs are checked for RaW conflicts.
+  void addStatNumConflictChecks(int64_t numPairs) {
+    statNumConflictChecks += numPairs;
+  }
 
   /// Return `true` if the given tensor has undefined contents.
   bool hasUndefinedContents(OpOperand *opOperand) const override;
@@ -262,6 +268,7 @@ private:
   // Bufferization statistics.
   int64_t statNumTensorOutOfPlace = 0;
   int64_t statNumTensorInPlace = 0;
+  int64_t statNumConflictChecks = 0;
 
   /// A set of uses of tensors that have undefined contents.
   DenseSet<OpOperand *> undefinedTensorUses;
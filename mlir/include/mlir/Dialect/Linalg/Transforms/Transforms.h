@@ -1206,6 +1206,21 @@ struct BlockPackMatmulOptions {
 using ControlBlockPackMatmulFn =
     std::function<std::optional<BlockPackMatmulOptions>(linalg::LinalgOp)>;
 
+/// Return packing options with minor block factors derived from the "CPU"
+/// device of the target system description closest to `linalgOp`.
+///
+/// The block factors are chosen such that the minor blocks of the LHS, RHS and
+/// result fit together into half of the L1 cache
+/// (`dlti.L1_cache_size_in_bytes`), accounting for the element type of each,
+/// and are multiples of the number of result elements in a vector register
+/// (`dlti.max_vector_op_width`, in bits) if the vector width is described.
+///
+/// Return std::nullopt if the L1 cache size is not described or an operand
+/// does not have an integer or float element type. The result can be used as
+/// a ControlBlockPackMatmulFn.
+std::optional<BlockPackMatmulOptions>
+getTargetBlockPackMatmulOptions(linalg::LinalgOp linalgOp);
+
 /// Pack a matmul operation into blocked 4D layout.
 ///
 /// Relayout a matmul operation into blocked layout with two levels of
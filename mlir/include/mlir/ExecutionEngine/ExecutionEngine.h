@@ -14,6 +14,7 @@
 #define MLIR_EXECUTIONENGINE_EXECUTIONENGINE_H_
 
 #include "mlir/Support/LLVM.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ExecutionEngine/ObjectCache.h"
 #include "llvm/ExecutionEngine/Orc/LLJIT.h"
 #include "llvm/ExecutionEngine/SectionMemoryManager.h"
@@ -22,7 +23,9 @@
 
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <string>
 
 namespace llvm {
 template <typename T>
@@ -40,6 +43,14 @@ class Operation;
 /// A simple object cache following Lang's LLJITWithObjectCache example.
 class SimpleObjectCache : public llvm::ObjectCache {
 public:
+  SimpleObjectCache() = default;
+
+  /// Create a cache that also persists the objects in `cacheDirectory`, so that
+  /// they can be reused across processes. The objects are keyed by a hash of
+  /// the module and of `targetKey`, which should describe the target
+  /// configuration that the objects are compiled for.
+  SimpleObjectCache(StringRef cacheDirectory, StringRef targetKey);
+
   void notifyObjectCompiled(const llvm::Module *m,
                             llvm::MemoryBufferRef objBuffer) override;
   std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module *m) override;
@@ -51,7 +62,24 @@ public:
   bool isEmpty();
 
 private:
+  /// Returns the path of the object for `m` in the cache directory. Code
+  /// generation mutates the module, so this is only called before it starts.
+  std::string getCachedObjectPath(const llvm::Module *m) const;
+
   llvm::StringMap<std::unique_ptr<llvm::MemoryBuffer>> cachedObjects;
+
+  /// The directory the objects are persisted in, or empty if they are only
+  /// kept in memory.
+  std::string cacheDirectory;
+  std::string targetKey;
+
+  /// The paths of the objects of the modules being compiled after a miss in
+  /// the cache directory, computed from the modules before code generation.
+  llvm::DenseMap<const llvm::Module *, std::string> pendingObjectPaths;
+
+  /// Guards `cachedObjects` and `pendingObjectPaths`, as modules may be
+  /// compiled concurrently.
+  std::mutex mutex;
 };
 
 struct ExecutionEngineOptions {
@@ -92,6 +120,22 @@ struct ExecutionEngineOptions {
   /// be dumped to a file via the `dumpToObjectFile` method.
   bool enableObjectDump = false;
 
+  /// If `objectCacheDirectory` is not empty, the objects generated for the
+  /// given module are persisted in this directory and reused by later engines
+  /// that compile the same module for the same target, skipping code
+  /// generation.
+  StringRef objectCacheDirectory;
+
+  /// If `enableLazyCompilation` is set, functions are compiled on demand when
+  /// they are first called instead of compiling the whole module upfront.
+  /// This is incompatible with `enableObjectDump`.
+  bool enableLazyCompilation = false;
+
+  /// If `numCompileThreads` is not zero, code generation happens concurrently
+  /// on this many threads. This is most useful with `enableLazyCompilation`,
+  /// as the module is otherwise compiled as a whole.
+  unsigned numCompileThreads = 0;
+
   /// If enable `enableGDBNotificationListener` is set, the JIT compiler will
   /// notify the llvm's global GDB notification listener.
   bool enableGDBNotificationListener = true;
@@ -476,6 +476,15 @@ public:
   /// Returns if the parser should verify the IR after parsing.
   bool shouldVerifyAfterParse() const { return verifyAfterParse; }
 
+  /// Set whether the textual parser may parse operations that are isolated
+  /// from above, such as functions, in parallel. This only takes effect if
+  /// multi-threading is enabled in the context, and loads all the dialects
+  /// available in the context before parsing.
+  void setParseInParallel(bool enable) { parseInParallel = enable; }
+
+  /// Returns if the textual parser may parse operations in parallel.
+  bool shouldParseInParallel() const { return parseInParallel; }
+
   /// Returns the parsing configurations associated to the bytecode read.
   BytecodeReaderConfig &getBytecodeReaderConfig() const {
     return const_cast<BytecodeReaderConfig &>(bytecodeReaderConfig);
@@ -513,6 +522,7 @@ public:
 private:
   MLIRContext *context;
   bool verifyAfterParse;
+  bool parseInParallel = false;
   DenseMap<StringRef, std::unique_ptr<AsmResourceParser>> resourceParsers;
   FallbackAsmResourceMap *fallbackResourceMap;
   BytecodeReaderConfig bytecodeReaderConfig;
@@ -119,6 +119,14 @@ public:
     return success();
   }
 
+  /// Parse operations that are isolated from above, such as functions, in
+  /// parallel.
+  MlirOptMainConfig &parseInParallel(bool parallel) {
+    parseInParallelFlag = parallel;
+    return *this;
+  }
+  bool shouldParseInParallel() const { return parseInParallelFlag; }
+
   /// List the registered passes and return.
   MlirOptMainConfig &listPasses(bool list) {
     listPassesFlag = list;
@@ -229,6 +237,9 @@ protected:
   /// List the registered passes and return.
   bool listPassesFlag = false;
 
+  /// Parse operations that are isolated from above in parallel.
+  bool parseInParallelFlag = false;
+
   /// Enable running the reproducer.
   bool runReproducerFlag = false;
 
@@ -1263,6 +1263,7 @@ Attribute Parser::parseDistinctAttr(Type type) {
   // Add the distinct attribute to the parser state, if it has not been parsed
   // before. Otherwise, check if the parsed reference attribute matches the one
   // found in the parser state.
+  llvm::sys::SmartScopedLock<true> lock(state.symbols.mutex);
   DenseMap<uint64_t, DistinctAttr> &distinctAttrs =
       state.symbols.distinctAttributes;
   auto it = distinctAttrs.find(*value);
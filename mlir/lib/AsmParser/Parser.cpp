@@ -30,6 +30,7 @@
 #include "mlir/IR/OperationSupport.h"
 #include "mlir/IR/OwningOpRef.h"
 #include "mlir/IR/Region.h"
+#include "mlir/IR/Threading.h"
 #include "mlir/IR/Value.h"
 #include "mlir/IR/Verifier.h"
 #include "mlir/IR/Visitors.h"
@@ -53,6 +54,7 @@
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
@@ -398,6 +400,7 @@ Parser::parseResourceHandle(const OpAsmDialectInterface *dialect,
   SMLoc nameLoc = getToken().getLoc();
   if (failed(parseOptionalKeyword(&name)))
     return emitError("expected identifier key for 'resource' entry");
+  llvm::sys::SmartScopedLock<true> lock(getState().symbols.mutex);
   auto &resources = getState().symbols.dialectResources;
 
   // If this is the first time encountering this handle, ask the dialect to
@@ -523,7 +526,12 @@ namespace {
 /// operations.
 class OperationParser : public Parser {
 public:
-  OperationParser(ParserState &state, ModuleOp topLevelOp);
+  /// Create a parser for operations into `topLevelOp`. If
+  /// `allowParallelParsing` is true and the parser config asks for it,
+  /// operations that are isolated from above are parsed in parallel when the
+  /// parser is finalized.
+  OperationParser(ParserState &state, ModuleOp topLevelOp,
+                  bool allowParallelParsing = true);
   ~OperationParser();
 
   /// After parsing is finished, this function must be called to see if there
@@ -691,6 +699,19 @@ public:
   ParseResult codeCompleteSSAUse();
   ParseResult codeCompleteBlock();
 
+  //===--------------------------------------------------------------------===//
+  // Parallel Parsing
+  //===--------------------------------------------------------------------===//
+
+  /// If the operation at the current token can be parsed in parallel, skip
+  /// over it, insert a placeholder for it and return true. Otherwise, leave
+  /// the parser at the current token and return false.
+  bool deferOperation();
+
+  /// Parse the deferred operations in parallel and replace their placeholders
+  /// with them.
+  ParseResult parseDeferredOperations();
+
 private:
   /// This class represents a definition of a Block.
   struct BlockDefinition {
@@ -735,6 +756,10 @@ private:
     return forwardRefPlaceholders.count(value);
   }
 
+  /// Emit an error for each forward reference that was never defined, and
+  /// return failure if there are any.
+  ParseResult diagnoseUndefinedForwardRefs();
+
   /// This struct represents an isolated SSA name scope. This scope may contain
   /// other nested non-isolated scopes. These scopes are used for operations
   /// that are known to be isolated to allow for reusing names within their
@@ -785,13 +810,30 @@ private:
 
   /// The top level operation that holds all of the parsed operations.
   Operation *topLevelOp;
+
+  /// An operation that is parsed in parallel once the rest of the input has
+  /// been parsed.
+  struct DeferredOperation {
+    /// The start of the operation, and the start of the token following it.
+    const char *begin, *end;
+    /// The operation that holds the place of the operation in its block.
+    Operation *placeholder;
+    /// The default dialects in scope of the operation.
+    SmallVector<StringRef> defaultDialectStack;
+  };
+  std::vector<DeferredOperation> deferredOps;
+
+  /// Whether operations that are isolated from above are deferred to parse
+  /// them in parallel.
+  bool deferIsolatedOps = false;
 };
 } // namespace
 
 MLIR_DECLARE_EXPLICIT_TYPE_ID(OperationParser::DeferredLocInfo *)
 MLIR_DEFINE_EXPLICIT_TYPE_ID(OperationParser::DeferredLocInfo *)
 
-OperationParser::OperationParser(ParserState &state, ModuleOp topLevelOp)
+OperationParser::OperationParser(ParserState &state, ModuleOp topLevelOp,
+                                 bool allowParallelParsing)
     : Parser(state), opBuilder(topLevelOp.getRegion()), topLevelOp(topLevelOp) {
   // The top level operation starts a new name scope.
   pushSSANameScope(/*isIsolated=*/true);
@@ -799,6 +841,16 @@ OperationParser::OperationParser(ParserState &state, ModuleOp topLevelOp)
   // If we are populating the parser state, prepare it for parsing.
   if (state.asmState)
     state.asmState->initialize(topLevelOp);
+
+  // The assembly state and code completion expect the operations to be parsed
+  // in order. The threads that parse in parallel can't load dialects, so load
+  // all of them upfront.
+  deferIsolatedOps = allowParallelParsing &&
+                     state.config.shouldParseInParallel() &&
+                     getContext()->isMultithreadingEnabled() &&
+                     !state.asmState && !state.codeCompleteContext;
+  if (deferIsolatedOps)
+    getContext()->loadAllAvailableDialects();
 }
 
 OperationParser::~OperationParser() {
@@ -821,21 +873,14 @@ OperationParser::~OperationParser() {
 /// After parsing is finished, this function must be called to see if there are
 /// any remaining issues.
 ParseResult OperationParser::finalize() {
+  // Parse the operations that were deferred to parse them in parallel.
+  if (parseDeferredOperations())
+    return failure();
+
   // Check for any forward references that are left.  If we find any, error
   // out.
-  if (!forwardRefPlaceholders.empty()) {
-    SmallVector<const char *, 4> errors;
-    // Iteration over the map isn't deterministic, so sort by source location.
-    for (auto entry : forwardRefPlaceholders)
-      errors.push_back(entry.second.getPointer());
-    llvm::array_pod_sort(errors.begin(), errors.end());
-
-    for (const char *entry : errors) {
-      auto loc = SMLoc::getFromPointer(entry);
-      emitError(loc, "use of undeclared SSA value name");
-    }
+  if (diagnoseUndefinedForwardRefs())
     return failure();
-  }
 
   // Resolve the locations of any deferred operations.
   auto &attributeAliases = state.symbols.attributeAliasDefinitions;
@@ -888,6 +933,23 @@ ParseResult OperationParser::finalize() {
 // SSA Value Handling
 //===----------------------------------------------------------------------===//
 
+ParseResult OperationParser::diagnoseUndefinedForwardRefs() {
+  if (forwardRefPlaceholders.empty())
+    return success();
+
+  SmallVector<const char *, 4> errors;
+  // Iteration over the map isn't deterministic, so sort by source location.
+  for (auto entry : forwardRefPlaceholders)
+    errors.push_back(entry.second.getPointer());
+  llvm::array_pod_sort(errors.begin(), errors.end());
+
+  for (const char *entry : errors) {
+    auto loc = SMLoc::getFromPointer(entry);
+    emitError(loc, "use of undeclared SSA value name");
+  }
+  return failure();
+}
+
 void OperationParser::pushSSANameScope(bool isIsolated) {
   blocksByName.push_back(DenseMap<StringRef, BlockDefinition>());
   forwardRef.push_back(DenseMap<Block *, SMLoc>());
@@ -1169,6 +1231,9 @@ Value OperationParser::createForwardRefPlaceholder(SMLoc loc, Type type) {
 ///  op-result         ::= ssa-id (`:` integer-literal)
 ///
 ParseResult OperationParser::parseOperation() {
+  if (deferIsolatedOps && deferOperation())
+    return success();
+
   auto loc = getToken().getLoc();
   SmallVector<ResultRecord, 1> resultIDs;
   size_t numExpectedResults = 0;
@@ -2462,6 +2527,205 @@ ParseResult OperationParser::codeCompleteBlock() {
   return failure();
 }
 
+//===----------------------------------------------------------------------===//
+// Parallel Parsing
+//===----------------------------------------------------------------------===//
+
+bool OperationParser::deferOperation() {
+  // Resolve the name of the operation starting at `tok` like
+  // `parseCustomOperationName` does.
+  auto lookupOpName =
+      [&](const Token &tok) -> std::optional<RegisteredOperationName> {
+    if (tok.is(Token::string))
+      return RegisteredOperationName::lookup(tok.getStringValue(),
+                                             getContext());
+    if (!tok.is(Token::bare_identifier))
+      return std::nullopt;
+    StringRef name = tok.getSpelling();
+    std::optional<RegisteredOperationName> opName =
+        RegisteredOperationName::lookup(name, getContext());
+    if (!opName && !name.contains('.'))
+      opName = RegisteredOperationName::lookup(
+          (state.defaultDialectStack.back() + "." + name).str(), getContext());
+    return opName;
+  };
+
+  // Only operations that are isolated from above and have neither operands nor
+  // successors can be parsed without the values and blocks around them.
+  // Symbol tables, such as modules, are parsed in place so that the
+  // operations they contain can be deferred instead.
+  Token nameTok = getToken();
+  std::optional<RegisteredOperationName> opName = lookupOpName(nameTok);
+  if (!opName || !opName->hasTrait<OpTrait::IsIsolatedFromAbove>() ||
+      !opName->hasTrait<OpTrait::ZeroOperands>() ||
+      !opName->hasTrait<OpTrait::ZeroSuccessors>() ||
+      opName->hasTrait<OpTrait::SymbolTable>())
+    return false;
+
+  // Skip to the end of the operation without parsing it. Outside of any
+  // brackets, the operation ends at the token that closes the enclosing block,
+  // or at a token that starts a line and can only start something else: the
+  // results of the next operation, a block label, the name of a registered
+  // operation, or the file metadata. Any other token that starts a line, such
+  // as the `attributes` keyword of a function, may continue the operation, so
+  // then the operation is parsed in place instead.
+  const char *begin = nameTok.getLoc().getPointer();
+  const char *end = nullptr;
+  {
+    // Lexer errors are diagnosed when the operation is parsed in place.
+    ScopedDiagnosticHandler silenceLexerErrors(
+        getContext(), [](Diagnostic &) { return success(); });
+    unsigned depth = 0;
+    bool ambiguous = false;
+    while (!end && !ambiguous) {
+      const char *prevEnd = getToken().getLocRange().End.getPointer();
+      consumeToken();
+      Token tok = getToken();
+      const char *tokBegin = tok.getLoc().getPointer();
+      bool startsLine = StringRef(prevEnd, tokBegin - prevEnd).contains('\n');
+      switch (tok.getKind()) {
+      case Token::eof:
+        if (depth == 0)
+          end = tokBegin;
+        break;
+      case Token::l_paren:
+      case Token::l_square:
+      case Token::l_brace:
+        ++depth;
+        break;
+      case Token::r_paren:
+      case Token::r_square:
+      case Token::r_brace:
+        if (depth != 0)
+          --depth;
+        else if (tok.is(Token::r_brace))
+          end = tokBegin;
+        break;
+      case Token::percent_identifier:
+      case Token::caret_identifier:
+      case Token::file_metadata_begin:
+        if (depth == 0 && startsLine)
+          end = tokBegin;
+        break;
+      default:
+        if (depth != 0 || !startsLine)
+          break;
+        if (tok.isAny(Token::bare_identifier, Token::string) &&
+            lookupOpName(tok))
+          end = tokBegin;
+        else
+          ambiguous = true;
+        break;
+      }
+
+      // Parse the operation in place if its end can't be found.
+      if (!end && (tok.isAny(Token::eof, Token::error) ||
+                   (depth == 0 && tok.isAny(Token::r_paren, Token::r_square))))
+        break;
+    }
+  }
+  if (!end) {
+    resetToken(begin);
+    return false;
+  }
+
+  // Hold the place of the operation in its block until it is parsed.
+  Operation *placeholder = Operation::create(
+      getEncodedSourceLocation(nameTok.getLoc()),
+      OperationName("builtin.unrealized_conversion_cast", getContext()),
+      /*resultTypes=*/TypeRange(), /*operands=*/{},
+      /*attributes=*/std::nullopt, /*properties=*/nullptr, /*successors=*/{},
+      /*numRegions=*/0);
+  opBuilder.insert(placeholder);
+  deferredOps.push_back({begin, end, placeholder,
+                         SmallVector<StringRef>(state.defaultDialectStack)});
+  return true;
+}
+
+ParseResult OperationParser::parseDeferredOperations() {
+  if (deferredOps.empty())
+    return success();
+
+  // Parse each operation into a module of its own, with a parser that shares
+  // the symbols of this one, but none of the SSA names. The line table of the
+  // source buffer that the source locations use is built lazily, and was
+  // already built for the locations of the placeholders.
+  struct ParsedOperation {
+    OwningOpRef<ModuleOp> module;
+    std::vector<DeferredLocInfo> deferredLocs;
+  };
+  std::vector<ParsedOperation> parsedOps(deferredOps.size());
+  auto parseDeferredOp = [&](size_t index) -> LogicalResult {
+    const DeferredOperation &deferredOp = deferredOps[index];
+    ParsedOperation &parsedOp = parsedOps[index];
+    parsedOp.module = ModuleOp::create(deferredOp.placeholder->getLoc());
+
+    ParserState opState(state.lex.getSourceMgr(), state.config, state.symbols,
+                        /*asmState=*/nullptr, /*codeCompleteContext=*/nullptr);
+    opState.defaultDialectStack = deferredOp.defaultDialectStack;
+    OperationParser opParser(opState, *parsedOp.module,
+                             /*allowParallelParsing=*/false);
+    opParser.resetToken(deferredOp.begin);
+    if (opParser.parseOperation() || opParser.diagnoseUndefinedForwardRefs())
+      return failure();
+    if (opParser.getToken().getLoc().getPointer() != deferredOp.end) {
+      return opParser.emitError(SMLoc::getFromPointer(deferredOp.begin),
+                                "parallel parsing requires the operation to "
+                                "end at a line break");
+    }
+    parsedOp.deferredLocs = std::move(opParser.deferredLocsReferences);
+    return success();
+  };
+  // Parse all of the operations, even after a failure, so that the diagnostics
+  // don't depend on the scheduling of the threads. They are reported in source
+  // order.
+  std::atomic<bool> anyFailed = false;
+  {
+    ParallelDiagnosticHandler diagHandler(getContext());
+    parallelFor(getContext(), 0, deferredOps.size(), [&](size_t index) {
+      diagHandler.setOrderIDForThread(index);
+      if (failed(parseDeferredOp(index)))
+        anyFailed = true;
+      diagHandler.eraseOrderIDForThread();
+    });
+  }
+  if (anyFailed)
+    return failure();
+
+  auto locID = TypeID::get<DeferredLocInfo *>();
+  for (auto [deferredOp, parsedOp] : llvm::zip_equal(deferredOps, parsedOps)) {
+    // Rebase the location aliases that remain to be resolved onto the ones of
+    // this parser, which resolves them in `finalize`.
+    if (!parsedOp.deferredLocs.empty()) {
+      size_t offset = deferredLocsReferences.size();
+      llvm::append_range(deferredLocsReferences, parsedOp.deferredLocs);
+      auto rebaseLocation = [&](auto &opOrArgument) {
+        auto fwdLoc = dyn_cast<OpaqueLoc>(opOrArgument.getLoc());
+        if (!fwdLoc || fwdLoc.getUnderlyingTypeID() != locID)
+          return;
+        opOrArgument.setLoc(
+            OpaqueLoc::get(fwdLoc.getUnderlyingLocation() + offset, locID,
+                           UnknownLoc::get(getContext())));
+      };
+      parsedOp.module->walk([&](Operation *op) {
+        rebaseLocation(*op);
+        for (Region &region : op->getRegions())
+          for (Block &block : region.getBlocks())
+            for (BlockArgument arg : block.getArguments())
+              rebaseLocation(arg);
+      });
+    }
+
+    // Replace the placeholder with the parsed operation.
+    Block *block = deferredOp.placeholder->getBlock();
+    block->getOperations().splice(Block::iterator(deferredOp.placeholder),
+                                  parsedOp.module->getBody()->getOperations());
+    deferredOp.placeholder->erase();
+  }
+  deferredOps.clear();
+  return success();
+}
+
 //===----------------------------------------------------------------------===//
 // Top-level entity parsing.
 //===----------------------------------------------------------------------===//
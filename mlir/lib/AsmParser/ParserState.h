@@ -14,6 +14,7 @@
 #include "mlir/IR/OpImplementation.h"
 #include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/StringMap.h"
+#include "llvm/Support/Mutex.h"
 
 namespace mlir {
 class OpAsmDialectInterface;
@@ -40,6 +41,10 @@ struct SymbolState {
 
   /// A map from unique integer identifier to DistinctAttr.
   DenseMap<uint64_t, DistinctAttr> distinctAttributes;
+
+  /// Guards the dialect resources and distinct attributes, which operations
+  /// being parsed in parallel may update.
+  llvm::sys::SmartMutex<true> mutex;
 };
 
 //===----------------------------------------------------------------------===//
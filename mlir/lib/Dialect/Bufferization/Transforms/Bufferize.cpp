@@ -314,6 +314,7 @@ struct OneShotBufferizePass
     this->numBufferAlloc = statistics.numBufferAlloc;
     this->numTensorInPlace = statistics.numTensorInPlace;
     this->numTensorOutOfPlace = statistics.numTensorOutOfPlace;
+    this->numConflictChecks = statistics.numConflictChecks;
   }
 
 private:
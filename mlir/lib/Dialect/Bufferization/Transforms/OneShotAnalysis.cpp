@@ -828,6 +828,22 @@ hasReadAfterWriteInterference(const DenseSet<OpOperand *> &usesRead,
   return false;
 }
 
+/// Collect `operand` and the values that alias with it when bufferizing in
+/// place into `roots`. Values whose alias set is already represented by another
+/// root are skipped, so that each alias set is traversed at most once.
+static void getAliasSetRoots(SmallVectorImpl<Value> &roots, OpOperand &operand,
+                             const OneShotAnalysisState &state) {
+  auto addRoot = [&](Value v) {
+    if (llvm::none_of(roots, [&](Value root) {
+          return state.areAliasingBufferizedValues(root, v);
+        }))
+      roots.push_back(v);
+  };
+  addRoot(operand.get());
+  for (AliasingValue alias : state.getAliasingValues(operand))
+    addRoot(alias.value);
+}
+
 // Helper function to iterate on aliases of `root` and capture the writes.
 static void getAliasingInplaceWrites(DenseSet<OpOperand *> &res, Value root,
                                      const OneShotAnalysisState &state) {
@@ -909,16 +925,17 @@ static bool wouldCreateReadAfterWriteInterference(
     OpOperand &operand, const DominanceInfo &domInfo,
     OneShotAnalysisState &state, bool checkConsistencyOnly = false) {
   // Collect reads and writes of all aliases of OpOperand and OpResult.
+  SmallVector<Value> roots;
+  getAliasSetRoots(roots, operand, state);
   DenseSet<OpOperand *> usesRead, usesWrite;
-  getAliasingReads(usesRead, operand.get(), state);
-  getAliasingInplaceWrites(usesWrite, operand.get(), state);
-  for (AliasingValue alias : state.getAliasingValues(operand)) {
-    getAliasingReads(usesRead, alias.value, state);
-    getAliasingInplaceWrites(usesWrite, alias.value, state);
+  for (Value root : roots) {
+    getAliasingReads(usesRead, root, state);
+    getAliasingInplaceWrites(usesWrite, root, state);
   }
   if (!checkConsistencyOnly && state.bufferizesToMemoryWrite(operand))
     usesWrite.insert(&operand);
 
+  state.addStatNumConflictChecks(usesRead.size() * usesWrite.size());
   return hasReadAfterWriteInterference(usesRead, usesWrite, domInfo, state);
 }
 
@@ -945,16 +962,22 @@ static bool
 wouldCreateWriteToNonWritableBuffer(OpOperand &operand,
                                     OneShotAnalysisState &state,
                                     bool checkConsistencyOnly = false) {
+  SmallVector<Value> roots;
+  getAliasSetRoots(roots, operand, state);
+
   bool foundWrite =
       !checkConsistencyOnly && state.bufferizesToMemoryWrite(operand);
 
-  if (!foundWrite) {
-    // Collect writes of all aliases of OpOperand and OpResult.
-    DenseSet<OpOperand *> usesWrite;
-    getAliasingInplaceWrites(usesWrite, operand.get(), state);
-    for (AliasingValue alias : state.getAliasingValues(operand))
-      getAliasingInplaceWrites(usesWrite, alias.value, state);
-    foundWrite = !usesWrite.empty();
+  // Look for a write of any alias of OpOperand and OpResult.
+  for (Value root : roots) {
+    if (foundWrite)
+      break;
+    state.applyOnAliases(root, [&](Value alias) {
+      if (!foundWrite)
+        foundWrite = llvm::any_of(alias.getUses(), [&](OpOperand &use) {
+          return isInplaceMemoryWrite(use, state);
+        });
+    });
   }
 
   if (!foundWrite)
@@ -969,9 +992,8 @@ wouldCreateWriteToNonWritableBuffer(OpOperand &operand,
         annotateNonWritableTensor(v);
     }
   };
-  state.applyOnAliases(operand.get(), checkReadOnly);
-  for (AliasingValue alias : state.getAliasingValues(operand))
-    state.applyOnAliases(alias.value, checkReadOnly);
+  for (Value root : roots)
+    state.applyOnAliases(root, checkReadOnly);
   if (foundReadOnly) {
     LLVM_DEBUG(llvm::dbgs() << "=> NOT WRITABLE\n");
     return true;
@@ -1352,6 +1374,7 @@ LogicalResult bufferization::analyzeOp(Operation *op,
   if (statistics) {
     statistics->numTensorInPlace = state.getStatNumTensorInPlace();
     statistics->numTensorOutOfPlace = state.getStatNumTensorOutOfPlace();
+    statistics->numConflictChecks = state.getStatNumConflictChecks();
   }
 
   bool failedAnalysis = false;
@@ -12,9 +12,12 @@
 #include "mlir/Dialect/Linalg/Transforms/Transforms.h"
 #include "mlir/Dialect/Linalg/Utils/Utils.h"
 #include "mlir/IR/PatternMatch.h"
+#include "mlir/IR/TypeUtilities.h"
+#include "mlir/Interfaces/DataLayoutInterfaces.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/TypeSwitch.h"
+#include "llvm/Support/MathExtras.h"
 
 #include <optional>
 
@@ -213,6 +216,64 @@ linalg::blockPackMatmul(RewriterBase &rewriter, linalg::LinalgOp linalgOp,
   return packedMatmul;
 }
 
+/// Return the integer value of `property` of the "CPU" device in the target
+/// system description closest to `op`, or nullopt if it is not described.
+static std::optional<uint64_t> getCPUProperty(Operation *op,
+                                              StringRef property) {
+  MLIRContext *ctx = op->getContext();
+  std::optional<Attribute> value =
+      DataLayout::closest(op).getDevicePropertyValue(
+          StringAttr::get(ctx, "CPU"), StringAttr::get(ctx, property));
+  auto intAttr = llvm::dyn_cast_if_present<IntegerAttr>(
+      value.value_or(Attribute()));
+  if (!intAttr)
+    return std::nullopt;
+  return intAttr.getValue().getLimitedValue();
+}
+
+std::optional<BlockPackMatmulOptions>
+linalg::getTargetBlockPackMatmulOptions(linalg::LinalgOp linalgOp) {
+  if (linalgOp.getNumDpsInputs() != 2 || linalgOp.getNumDpsInits() != 1)
+    return std::nullopt;
+  // The element sizes of the LHS, RHS and result, which may differ, e.g. for
+  // a matmul that accumulates i8 products into i32.
+  SmallVector<Value, 3> operands = {linalgOp.getDpsInputOperand(0)->get(),
+                                    linalgOp.getDpsInputOperand(1)->get(),
+                                    linalgOp.getDpsInitOperand(0)->get()};
+  uint64_t elementBytes = 0;
+  for (Value operand : operands) {
+    Type type = getElementTypeOrSelf(operand.getType());
+    if (!type.isIntOrFloat())
+      return std::nullopt;
+    elementBytes += llvm::divideCeil(type.getIntOrFloatBitWidth(), CHAR_BIT);
+  }
+  unsigned elementBitWidth =
+      getElementTypeOrSelf(operands.back().getType()).getIntOrFloatBitWidth();
+
+  std::optional<uint64_t> l1Size =
+      getCPUProperty(linalgOp, "dlti.L1_cache_size_in_bytes");
+  if (!l1Size)
+    return std::nullopt;
+
+  // Keep the minor blocks in multiples of whole vectors.
+  uint64_t numLanes = 1;
+  if (std::optional<uint64_t> vectorWidth =
+          getCPUProperty(linalgOp, "dlti.max_vector_op_width"))
+    numLanes = std::max<uint64_t>(*vectorWidth / elementBitWidth, 1);
+
+  // The three square minor blocks of an (mb, nb, kb) step are reused across
+  // the major block loops. Give them half of L1 and leave the rest for the
+  // surrounding data and conflict misses.
+  uint64_t budget = *l1Size / 2;
+  uint64_t block = numLanes;
+  while ((2 * block) * (2 * block) * elementBytes <= budget)
+    block *= 2;
+
+  BlockPackMatmulOptions options;
+  options.blockFactors.assign(3, static_cast<int64_t>(block));
+  return options;
+}
+
 namespace {
 template <typename OpTy>
 struct BlockPackMatmul : public OpRewritePattern<OpTy> {
@@ -285,9 +346,18 @@ struct LinalgBlockPackMatmul
     RewritePatternSet patterns(&getContext());
 
     ControlBlockPackMatmulFn controlFn =
-        [&](linalg::LinalgOp op) -> BlockPackMatmulOptions {
+        [&](linalg::LinalgOp op) -> std::optional<BlockPackMatmulOptions> {
       BlockPackMatmulOptions options;
-      options.blockFactors = SmallVector<int64_t>{*blockFactors};
+      // Without explicit block factors, derive them from the target.
+      if (blockFactors.empty()) {
+        std::optional<BlockPackMatmulOptions> targetOptions =
+            getTargetBlockPackMatmulOptions(op);
+        if (!targetOptions)
+          return std::nullopt;
+        options.blockFactors = targetOptions->blockFactors;
+      } else {
+        options.blockFactors = SmallVector<int64_t>{*blockFactors};
+      }
       options.allowPadding = allowPadding;
       options.mnkPaddedSizesNextMultipleOf =
           SmallVector<int64_t>{*mnkPaddedSizesNextMultipleOf};
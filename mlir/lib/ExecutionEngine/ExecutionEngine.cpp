@@ -16,6 +16,8 @@
 #include "mlir/Support/FileUtilities.h"
 #include "mlir/Target/LLVMIR/Export.h"
 
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/ExecutionEngine/JITEventListener.h"
 #include "llvm/ExecutionEngine/ObjectCache.h"
 #include "llvm/ExecutionEngine/Orc/CompileUtils.h"
@@ -28,6 +30,9 @@
 #include "llvm/MC/TargetRegistry.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA256.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/TargetParser/Host.h"
 #include "llvm/TargetParser/SubtargetFeature.h"
@@ -46,10 +51,15 @@ using llvm::Module;
 using llvm::SectionMemoryManager;
 using llvm::StringError;
 using llvm::Triple;
+using llvm::orc::ConcurrentIRCompiler;
 using llvm::orc::DynamicLibrarySearchGenerator;
 using llvm::orc::ExecutionSession;
 using llvm::orc::IRCompileLayer;
 using llvm::orc::JITTargetMachineBuilder;
+using llvm::orc::LLJIT;
+using llvm::orc::LLJITBuilder;
+using llvm::orc::LLLazyJIT;
+using llvm::orc::LLLazyJITBuilder;
 using llvm::orc::MangleAndInterner;
 using llvm::orc::RTDyldObjectLinkingLayer;
 using llvm::orc::SymbolMap;
@@ -62,22 +72,99 @@ static Error makeStringError(const Twine &message) {
                                        llvm::inconvertibleErrorCode());
 }
 
+SimpleObjectCache::SimpleObjectCache(StringRef cacheDirectory,
+                                     StringRef targetKey)
+    : cacheDirectory(cacheDirectory), targetKey(targetKey) {
+  // A missing directory is reported when the first object is written.
+  (void)llvm::sys::fs::create_directories(cacheDirectory);
+}
+
+std::string SimpleObjectCache::getCachedObjectPath(const Module *m) const {
+  // Hash the bitcode of the module, which is deterministic and cheaper to
+  // produce than its textual form.
+  SmallVector<char, 0> bitcode;
+  llvm::raw_svector_ostream os(bitcode);
+  llvm::WriteBitcodeToFile(*m, os);
+
+  llvm::SHA256 hasher;
+  hasher.update(targetKey);
+  hasher.update(StringRef(bitcode.data(), bitcode.size()));
+  SmallString<256> path(cacheDirectory);
+  llvm::sys::path::append(path,
+                          llvm::toHex(hasher.final(), /*LowerCase=*/true));
+  path += ".o";
+  return std::string(path);
+}
+
 void SimpleObjectCache::notifyObjectCompiled(const Module *m,
                                              MemoryBufferRef objBuffer) {
+  std::string path;
+  if (!cacheDirectory.empty()) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = pendingObjectPaths.find(m);
+    if (it != pendingObjectPaths.end()) {
+      path = std::move(it->second);
+      pendingObjectPaths.erase(it);
+    }
+  }
+  if (!path.empty()) {
+    // Write the object through a temporary file, so that other processes
+    // sharing the directory never see a partially written object.
+    if (Error err = llvm::writeToOutput(path, [&](llvm::raw_ostream &os) {
+          os << objBuffer.getBuffer();
+          return Error::success();
+        })) {
+      LLVM_DEBUG(dbgs() << "Could not write object for "
+                        << m->getModuleIdentifier() << " to " << path << ": "
+                        << err << "\n");
+      llvm::consumeError(std::move(err));
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
   cachedObjects[m->getModuleIdentifier()] = MemoryBuffer::getMemBufferCopy(
       objBuffer.getBuffer(), objBuffer.getBufferIdentifier());
 }
 
 std::unique_ptr<MemoryBuffer> SimpleObjectCache::getObject(const Module *m) {
-  auto i = cachedObjects.find(m->getModuleIdentifier());
-  if (i == cachedObjects.end()) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto i = cachedObjects.find(m->getModuleIdentifier());
+    if (i != cachedObjects.end()) {
+      LLVM_DEBUG(dbgs() << "Object for " << m->getModuleIdentifier()
+                        << " loaded from cache.\n");
+      return MemoryBuffer::getMemBuffer(i->second->getMemBufferRef());
+    }
+  }
+
+  std::unique_ptr<MemoryBuffer> object;
+  std::string path;
+  if (!cacheDirectory.empty()) {
+    path = getCachedObjectPath(m);
+    if (auto buffer = MemoryBuffer::getFile(path)) {
+      LLVM_DEBUG(dbgs() << "Object for " << m->getModuleIdentifier()
+                        << " loaded from " << path << ".\n");
+      object = std::move(*buffer);
+    }
+  }
+  if (!object) {
     LLVM_DEBUG(dbgs() << "No object for " << m->getModuleIdentifier()
                       << " in cache. Compiling.\n");
+    // Remember where to persist the object, as the module is not the same
+    // anymore once it is compiled.
+    if (!path.empty()) {
+      std::lock_guard<std::mutex> lock(mutex);
+      pendingObjectPaths[m] = std::move(path);
+    }
     return nullptr;
   }
-  LLVM_DEBUG(dbgs() << "Object for " << m->getModuleIdentifier()
-                    << " loaded from cache.\n");
-  return MemoryBuffer::getMemBuffer(i->second->getMemBufferRef());
+
+  // Keep the object in memory so that it can be dumped.
+  std::lock_guard<std::mutex> lock(mutex);
+  auto &cachedObject = cachedObjects[m->getModuleIdentifier()];
+  if (!cachedObject)
+    cachedObject = std::move(object);
+  return MemoryBuffer::getMemBuffer(cachedObject->getMemBufferRef());
 }
 
 void SimpleObjectCache::dumpToObjectFile(StringRef outputFilename) {
@@ -96,7 +183,10 @@ void SimpleObjectCache::dumpToObjectFile(StringRef outputFilename) {
   file->keep();
 }
 
-bool SimpleObjectCache::isEmpty() { return cachedObjects.empty(); }
+bool SimpleObjectCache::isEmpty() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return cachedObjects.empty();
+}
 
 void ExecutionEngine::dumpToObjectFile(StringRef filename) {
   if (cache == nullptr) {
@@ -232,12 +322,18 @@ ExecutionEngine::~ExecutionEngine() {
 Expected<std::unique_ptr<ExecutionEngine>>
 ExecutionEngine::create(Operation *m, const ExecutionEngineOptions &options,
                         std::unique_ptr<llvm::TargetMachine> tm) {
+  // The dumped object file holds the whole module, which is never compiled as
+  // a whole when compiling lazily.
+  if (options.enableLazyCompilation && options.enableObjectDump)
+    return makeStringError(
+        "object dumping is not supported with lazy compilation");
+
   auto engine = std::make_unique<ExecutionEngine>(
       options.enableObjectDump, options.enableGDBNotificationListener,
       options.enablePerfNotificationListener);
 
-  // Remember all entry-points if object dumping is enabled.
-  if (options.enableObjectDump) {
+  // Remember all entry-points if there is an object cache to dump.
+  if (options.enableObjectDump || !options.objectCacheDirectory.empty()) {
     for (auto funcOp : m->getRegion(0).getOps<LLVM::LLVMFuncOp>()) {
       StringRef funcName = funcOp.getSymName();
       engine->functionNames.push_back(funcName.str());
@@ -264,6 +360,20 @@ ExecutionEngine::create(Operation *m, const ExecutionEngineOptions &options,
     tm = std::move(tmOrError.get());
   }
 
+  // Persist the objects if requested. The key describes the parts of the
+  // target configuration that are not recorded in the module.
+  llvm::CodeGenOptLevel optLevel =
+      options.jitCodeGenOptLevel.value_or(tm->getOptLevel());
+  if (!options.objectCacheDirectory.empty()) {
+    std::string targetKey =
+        (tm->getTargetTriple().str() + " " + tm->getTargetCPU() + " " +
+         tm->getTargetFeatureString() + " " +
+         Twine(static_cast<int>(optLevel)))
+            .str();
+    engine->cache = std::make_unique<SimpleObjectCache>(
+        options.objectCacheDirectory, targetKey);
+  }
+
   // TODO: Currently, the LLVM module created above has no triple associated
   // with it. Instead, the triple is extracted from the TargetMachine, which is
   // either based on the host defaults or command line arguments when specified
@@ -362,26 +472,57 @@ ExecutionEngine::create(Operation *m, const ExecutionEngineOptions &options,
   // LLJITWithObjectCache example.
   auto compileFunctionCreator = [&](JITTargetMachineBuilder jtmb)
       -> Expected<std::unique_ptr<IRCompileLayer::IRCompiler>> {
+    // Compiling on multiple threads requires a target machine per thread, so
+    // describe the given one with a builder.
+    if (options.numCompileThreads) {
+      JITTargetMachineBuilder concurrentJtmb(tm->getTargetTriple());
+      concurrentJtmb.setCPU(tm->getTargetCPU().str())
+          .setFeatures(tm->getTargetFeatureString())
+          .setOptions(tm->Options)
+          .setRelocationModel(tm->getRelocationModel())
+          .setCodeModel(tm->getCodeModel())
+          .setCodeGenOptLevel(optLevel);
+      return std::make_unique<ConcurrentIRCompiler>(std::move(concurrentJtmb),
+                                                    engine->cache.get());
+    }
     if (options.jitCodeGenOptLevel)
       jtmb.setCodeGenOptLevel(*options.jitCodeGenOptLevel);
     return std::make_unique<TMOwningSimpleCompiler>(std::move(tm),
                                                     engine->cache.get());
   };
 
-  // Create the LLJIT by calling the LLJITBuilder with 2 callbacks.
-  auto jit =
-      cantFail(llvm::orc::LLJITBuilder()
-                   .setCompileFunctionCreator(compileFunctionCreator)
-                   .setObjectLinkingLayerCreator(objectLinkingLayerCreator)
-                   .setDataLayout(dataLayout)
-                   .create());
+  // Create the LLJIT by calling the LLJITBuilder with 2 callbacks. When
+  // compiling lazily, create an LLLazyJIT that compiles each function on
+  // demand instead.
+  auto configureBuilder = [&](auto &builder) {
+    builder.setCompileFunctionCreator(compileFunctionCreator)
+        .setObjectLinkingLayerCreator(objectLinkingLayerCreator)
+        .setDataLayout(dataLayout)
+        .setNumCompileThreads(options.numCompileThreads);
+  };
+  std::unique_ptr<LLJIT> jit;
+  if (options.enableLazyCompilation) {
+    LLLazyJITBuilder builder;
+    configureBuilder(builder);
+    auto lazyJit = builder.create();
+    if (!lazyJit)
+      return lazyJit.takeError();
+    jit = std::move(*lazyJit);
+  } else {
+    LLJITBuilder builder;
+    configureBuilder(builder);
+    jit = cantFail(builder.create());
+  }
 
   // Add a ThreadSafemodule to the engine and return.
   ThreadSafeModule tsm(std::move(llvmModule), std::move(ctx));
   if (options.transformer)
     cantFail(tsm.withModuleDo(
         [&](llvm::Module &module) { return options.transformer(&module); }));
-  cantFail(jit->addIRModule(std::move(tsm)));
+  if (options.enableLazyCompilation)
+    cantFail(static_cast<LLLazyJIT &>(*jit).addLazyIRModule(std::move(tsm)));
+  else
+    cantFail(jit->addIRModule(std::move(tsm)));
   engine->jit = std::move(jit);
 
   // Resolve symbols that are statically linked in the current process.
@@ -800,7 +800,7 @@ void OpToOpPassAdaptor::runOnOperationAsyncImpl(bool verifyPasses) {
   std::vector<std::atomic<bool>> activePMs(asyncExecutors.size());
   std::fill(activePMs.begin(), activePMs.end(), false);
   std::atomic<bool> hasFailure = false;
-  parallelForEach(context, opInfos, [&](OpPMInfo &opInfo) {
+  auto runOpPipeline = [&](OpPMInfo &opInfo) {
     // Find an executor for this operation.
     auto it = llvm::find_if(activePMs, [](std::atomic<bool> &isActive) {
       bool expectedInactive = false;
@@ -818,7 +818,41 @@ void OpToOpPassAdaptor::runOnOperationAsyncImpl(bool verifyPasses) {
 
     // Reset the active bit for this pass manager.
     activePMs[pmIndex].store(false);
-  });
+  };
+
+  // If there are no more operations than threads, they all start right away.
+  llvm::ThreadPoolInterface &threadPool = context->getThreadPool();
+  if (opInfos.size() <= threadPool.getMaxConcurrency()) {
+    parallelForEach(context, opInfos, runOpPipeline);
+  } else {
+    // Otherwise, schedule the largest operations first, sized by the number of
+    // operations they contain. A large operation that starts last would run
+    // alone after the others finished.
+    SmallVector<unsigned> numNestedOps(opInfos.size());
+    for (unsigned i = 0, e = opInfos.size(); i != e; ++i)
+      opInfos[i].op->walk([&](Operation *) { ++numNestedOps[i]; });
+    auto order = llvm::to_vector(llvm::seq<unsigned>(0, opInfos.size()));
+    llvm::stable_sort(order, [&](unsigned lhs, unsigned rhs) {
+      return numNestedOps[lhs] > numNestedOps[rhs];
+    });
+
+    ParallelDiagnosticHandler handler(context);
+    std::atomic<unsigned> curIndex(0);
+    auto processFn = [&] {
+      for (unsigned index = curIndex++; index < order.size();
+           index = curIndex++) {
+        // Order the diagnostics by the position of the operation, not by the
+        // time it was scheduled.
+        handler.setOrderIDForThread(order[index]);
+        runOpPipeline(opInfos[order[index]]);
+        handler.eraseOrderIDForThread();
+      }
+    };
+    llvm::ThreadPoolTaskGroup tasksGroup(threadPool);
+    for (unsigned i = 0, e = threadPool.getMaxConcurrency(); i != e; ++i)
+      tasksGroup.async(processFn);
+    tasksGroup.wait();
+  }
 
   // Signal a failure if any of the executors failed.
   if (hasFailure)
@@ -11,7 +11,10 @@
 #include "mlir/Support/LLVM.h"
 #include "mlir/Support/ThreadLocalCache.h"
 #include "mlir/Support/TypeID.h"
+#include "llvm/Support/MathExtras.h"
 #include "llvm/Support/RWMutex.h"
+#include "llvm/Support/Threading.h"
+#include <algorithm>
 
 using namespace mlir;
 using namespace mlir::detail;
@@ -177,8 +180,10 @@ public:
 private:
   /// Return the shard used for the given hash value.
   Shard &getShard(unsigned hashValue) {
-    // Get a shard number from the provided hashvalue.
-    unsigned shardNum = hashValue & (numShards - 1);
+    // Get a shard number from the high bits of the provided hashvalue. The
+    // instance set of the shard selects buckets from the low bits, which would
+    // otherwise be the same for all of the instances in the shard.
+    unsigned shardNum = (uint64_t(hashValue) * numShards) >> 32;
 
     // Try to acquire an already initialized shard.
     Shard *shard = shards[shardNum].load(std::memory_order_acquire);
@@ -379,8 +384,20 @@ auto StorageUniquer::getParametricStorageTypeImpl(
 /// parametric storage.
 void StorageUniquer::registerParametricStorageTypeImpl(
     TypeID id, function_ref<void(BaseStorage *)> destructorFn) {
+#if LLVM_ENABLE_THREADS != 0
+  // Use enough shards for the threads of a default thread pool to rarely
+  // contend for the same one. The shards are lazily allocated, so the unused
+  // ones only cost a pointer each.
+  static const size_t numShards = [] {
+    size_t numThreads = llvm::hardware_concurrency().compute_thread_count();
+    return std::clamp<size_t>(llvm::PowerOf2Ceil(numThreads * 2), 8, 128);
+  }();
+  impl->parametricUniquers.try_emplace(
+      id, std::make_unique<ParametricStorageUniquer>(destructorFn, numShards));
+#else
   impl->parametricUniquers.try_emplace(
       id, std::make_unique<ParametricStorageUniquer>(destructorFn));
+#endif
 }
 
 /// Implementation for getting an instance of a derived type with default
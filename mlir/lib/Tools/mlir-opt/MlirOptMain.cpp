@@ -123,6 +123,12 @@ struct MlirOptMainConfigCLOptions : public MlirOptMainConfig {
         "list-passes", cl::desc("Print the list of registered passes and exit"),
         cl::location(listPassesFlag), cl::init(false));
 
+    static cl::opt<bool, /*ExternalStorage=*/true> parseInParallel(
+        "parse-in-parallel",
+        cl::desc("Parse operations that are isolated from above, such as "
+                 "functions, in parallel"),
+        cl::location(parseInParallelFlag), cl::init(false));
+
     static cl::opt<bool, /*ExternalStorage=*/true> runReproducer(
         "run-reproducer", cl::desc("Run the pipeline stored in the reproducer"),
         cl::location(runReproducerFlag), cl::init(false));
@@ -366,10 +372,12 @@ performActions(raw_ostream &os,
   applyDefaultTimingManagerCLOptions(tm);
   TimingScope timing = tm.getRootScope();
 
-  // Disable multi-threading when parsing the input file. This removes the
-  // unnecessary/costly context synchronization when parsing.
+  // Disable multi-threading when parsing the input file, unless parsing in
+  // parallel. This removes the unnecessary/costly context synchronization when
+  // parsing.
   bool wasThreadingEnabled = context->isMultithreadingEnabled();
-  context->disableMultithreading();
+  if (!config.shouldParseInParallel())
+    context->disableMultithreading();
 
   // Prepare the parser config, and attach any useful/necessary resource
   // handlers. Unhandled external resources are treated as passthrough, i.e.
@@ -379,6 +387,7 @@ performActions(raw_ostream &os,
   FallbackAsmResourceMap fallbackResourceMap;
   ParserConfig parseConfig(context, /*verifyAfterParse=*/true,
                            &fallbackResourceMap);
+  parseConfig.setParseInParallel(config.shouldParseInParallel());
   if (config.shouldRunReproducer())
     reproOptions.attachResourceParser(parseConfig);
 
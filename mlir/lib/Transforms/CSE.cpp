@@ -33,25 +33,43 @@ namespace mlir {
 using namespace mlir;
 
 namespace {
-struct SimpleOperationInfo : public llvm::DenseMapInfo<Operation *> {
-  static unsigned getHashValue(const Operation *opC) {
-    return OperationEquivalence::computeHash(
-        const_cast<Operation *>(opC),
-        /*hashOperands=*/OperationEquivalence::directHashValue,
-        /*hashResults=*/OperationEquivalence::ignoreHashValue,
-        OperationEquivalence::IgnoreLocations);
+/// An operation along with its structural hash. The hash is computed once when
+/// the operation is visited, instead of every time the known values map is
+/// probed or grown, as hashing attribute-heavy operations is expensive. The
+/// operations in the map are not modified while they are in scope, so the
+/// hash stays valid.
+struct HashedOperation {
+  Operation *op;
+  unsigned hash;
+};
+
+struct SimpleOperationInfo {
+  static HashedOperation getEmptyKey() {
+    return {llvm::DenseMapInfo<Operation *>::getEmptyKey(), 0};
+  }
+  static HashedOperation getTombstoneKey() {
+    return {llvm::DenseMapInfo<Operation *>::getTombstoneKey(), 0};
   }
-  static bool isEqual(const Operation *lhsC, const Operation *rhsC) {
-    auto *lhs = const_cast<Operation *>(lhsC);
-    auto *rhs = const_cast<Operation *>(rhsC);
-    if (lhs == rhs)
+  static HashedOperation getKey(Operation *op) {
+    return {op, OperationEquivalence::computeHash(
+                    op,
+                    /*hashOperands=*/OperationEquivalence::directHashValue,
+                    /*hashResults=*/OperationEquivalence::ignoreHashValue,
+                    OperationEquivalence::IgnoreLocations)};
+  }
+  static unsigned getHashValue(const HashedOperation &key) { return key.hash; }
+  static bool isEqual(const HashedOperation &lhs, const HashedOperation &rhs) {
+    if (lhs.op == rhs.op)
       return true;
-    if (lhs == getTombstoneKey() || lhs == getEmptyKey() ||
-        rhs == getTombstoneKey() || rhs == getEmptyKey())
+    if (lhs.op == getTombstoneKey().op || lhs.op == getEmptyKey().op ||
+        rhs.op == getTombstoneKey().op || rhs.op == getEmptyKey().op)
+      return false;
+    // Equivalent operations have the same hash, so avoid comparing their
+    // structure when the hashes differ.
+    if (lhs.hash != rhs.hash)
       return false;
     return OperationEquivalence::isEquivalentTo(
-        const_cast<Operation *>(lhsC), const_cast<Operation *>(rhsC),
-        OperationEquivalence::IgnoreLocations);
+        lhs.op, rhs.op, OperationEquivalence::IgnoreLocations);
   }
 };
 } // namespace
@@ -73,8 +91,8 @@ private:
   /// Shared implementation of operation elimination and scoped map definitions.
   using AllocatorTy = llvm::RecyclingAllocator<
       llvm::BumpPtrAllocator,
-      llvm::ScopedHashTableVal<Operation *, Operation *>>;
-  using ScopedMapTy = llvm::ScopedHashTable<Operation *, Operation *,
+      llvm::ScopedHashTableVal<HashedOperation, Operation *>>;
+  using ScopedMapTy = llvm::ScopedHashTable<HashedOperation, Operation *,
                                             SimpleOperationInfo, AllocatorTy>;
 
   /// Cache holding MemoryEffects information between two operations. The first
@@ -148,7 +166,8 @@ void CSEDriver::replaceUsesAndDelete(ScopedMapTy &knownValues, Operation *op,
     // When the region does not have SSA dominance, we need to check if we
     // have visited a use before replacing any use.
     auto wasVisited = [&](OpOperand &operand) {
-      return !knownValues.count(operand.getOwner());
+      return !knownValues.count(
+          SimpleOperationInfo::getKey(operand.getOwner()));
     };
     if (auto *rewriteListener =
             dyn_cast_if_present<RewriterBase::Listener>(rewriter.getListener()))
@@ -186,7 +205,7 @@ bool CSEDriver::hasOtherSideEffectingOpInBetween(Operation *fromOp,
   Operation *nextOp = fromOp->getNextNode();
   auto result =
       memEffectsCache.try_emplace(fromOp, std::make_pair(fromOp, nullptr));
-  if (result.second) {
+  if (!result.second) {
     auto memEffectsCachePair = result.first->second;
     if (memEffectsCachePair.second == nullptr) {
       // No MemoryEffects::Write has been detected until the cached operation.
@@ -255,7 +274,8 @@ LogicalResult CSEDriver::simplifyOperation(ScopedMapTy &knownValues,
       return failure();
 
     // Look for an existing definition for the operation.
-    if (auto *existing = knownValues.lookup(op)) {
+    HashedOperation key = SimpleOperationInfo::getKey(op);
+    if (auto *existing = knownValues.lookup(key)) {
       if (existing->getBlock() == op->getBlock() &&
           !hasOtherSideEffectingOpInBetween(existing, op)) {
         // The operation that can be deleted has been reach with no
@@ -265,19 +285,20 @@ LogicalResult CSEDriver::simplifyOperation(ScopedMapTy &knownValues,
         return success();
       }
     }
-    knownValues.insert(op, op);
+    knownValues.insert(key, op);
     return failure();
   }
 
   // Look for an existing definition for the operation.
-  if (auto *existing = knownValues.lookup(op)) {
+  HashedOperation key = SimpleOperationInfo::getKey(op);
+  if (auto *existing = knownValues.lookup(key)) {
     replaceUsesAndDelete(knownValues, op, existing, hasSSADominance);
     ++numCSE;
     return success();
   }
 
   // Otherwise, we add this operation to the known values map.
-  knownValues.insert(op, op);
+  knownValues.insert(key, op);
   return failure();
 }
 
@@ -23,6 +23,7 @@
 #include "llvm/ADT/BitVector.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/ScopeExit.h"
+#include "llvm/ADT/SetVector.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/ScopedPrinter.h"
@@ -235,9 +236,9 @@ void Worklist::clear() {
 }
 
 bool Worklist::empty() const {
-  // Skip all nullptr.
-  return !llvm::any_of(list,
-                       [](Operation *op) { return static_cast<bool>(op); });
+  // The map only contains the ops that were not removed, so there is no need
+  // to skip the nullptr in `list`.
+  return map.empty();
 }
 
 void Worklist::push(Operation *op) {
@@ -275,7 +276,8 @@ void Worklist::remove(Operation *op) {
 void Worklist::reverse() {
   std::reverse(list.begin(), list.end());
   for (size_t i = 0, e = list.size(); i != e; ++i)
-    map[list[i]] = i;
+    if (list[i])
+      map[list[i]] = i;
 }
 
 #ifdef MLIR_GREEDY_REWRITE_RANDOMIZER_SEED
@@ -298,7 +300,8 @@ public:
       op = list[pos];
       list.erase(list.begin() + pos);
       for (int64_t i = pos, e = list.size(); i < e; ++i)
-        map[list[i]] = i;
+        if (list[i])
+          map[list[i]] = i;
       map.erase(op);
     } while (!op);
     return op;
@@ -375,6 +378,12 @@ protected:
   /// `config.strictMode` is GreedyRewriteStrictness::AnyOp.
   llvm::SmallDenseSet<Operation *, 4> strictModeFilteredOps;
 
+#ifndef NDEBUG
+  /// The patterns that were applied in the current iteration, to report the
+  /// patterns that keep applying when the rewrite does not converge.
+  llvm::SetVector<const Pattern *> appliedPatterns;
+#endif
+
 private:
   /// Look over the provided operands for any defining operations that should
   /// be re-added to the worklist. This function should be called when an
@@ -587,6 +596,9 @@ bool GreedyPatternRewriteDriver::processWorklist() {
     function_ref<void(const Pattern &)> onFailure = onFailureCallback;
     auto onSuccessCallback = [&](const Pattern &pattern) {
       LLVM_DEBUG(logResult("success", "pattern applied successfully"));
+#ifndef NDEBUG
+      appliedPatterns.insert(&pattern);
+#endif
       if (config.listener)
         config.listener->notifyPatternEnd(pattern, success());
       return success();
@@ -830,11 +842,26 @@ LogicalResult RegionPatternRewriteDriver::simplify(bool *changed) && {
   do {
     // Check if the iteration limit was reached.
     if (++iteration > config.maxIterations &&
-        config.maxIterations != GreedyRewriteConfig::kNoLimit)
+        config.maxIterations != GreedyRewriteConfig::kNoLimit) {
+      LLVM_DEBUG({
+        llvm::dbgs() << "Greedy rewrite did not converge after "
+                     << config.maxIterations
+                     << " iterations, patterns applied in the last one:\n";
+        for (const Pattern *pattern : appliedPatterns) {
+          llvm::dbgs() << "  " << pattern->getDebugName();
+          if (std::optional<OperationName> rootKind = pattern->getRootKind())
+            llvm::dbgs() << " : '" << *rootKind << "'";
+          llvm::dbgs() << "\n";
+        }
+      });
       break;
+    }
 
     // New iteration: start with an empty worklist.
     worklist.clear();
+#ifndef NDEBUG
+    appliedPatterns.clear();
+#endif
 
     // `OperationFolder` CSE's constant ops (and may move them into parents
     // regions to enable more aggressive CSE'ing).
@@ -25,6 +25,7 @@
 #include "mlir/Target/LLVMIR/Dialect/Builtin/BuiltinToLLVMIRTranslation.h"
 #include "mlir/Target/LLVMIR/Dialect/LLVMIR/LLVMToLLVMIRTranslation.h"
 #include "mlir/Target/LLVMIR/Export.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Support/raw_ostream.h"
 
@@ -114,6 +115,98 @@ TEST(MLIRExecutionEngine, SKIP_WITHOUT_JIT(SubtractFloat)) {
   ASSERT_EQ(result, 42.f);
 }
 
+TEST(MLIRExecutionEngine, SKIP_WITHOUT_JIT(LazyCompilation)) {
+  std::string moduleStr = R"mlir(
+  func.func @foo(%arg0 : i32) -> i32 attributes { llvm.emit_c_interface } {
+    %res = arith.addi %arg0, %arg0 : i32
+    return %res : i32
+  }
+  func.func @bar(%arg0 : i32) -> i32 attributes { llvm.emit_c_interface } {
+    %res = arith.muli %arg0, %arg0 : i32
+    return %res : i32
+  }
+  )mlir";
+  DialectRegistry registry;
+  registerAllDialects(registry);
+  registerBuiltinDialectTranslation(registry);
+  registerLLVMDialectTranslation(registry);
+  MLIRContext context(registry);
+  OwningOpRef<ModuleOp> module =
+      parseSourceString<ModuleOp>(moduleStr, &context);
+  ASSERT_TRUE(!!module);
+  ASSERT_TRUE(succeeded(lowerToLLVMDialect(*module)));
+  ExecutionEngineOptions options;
+  options.enableLazyCompilation = true;
+  options.numCompileThreads = 2;
+  auto jitOrError = ExecutionEngine::create(*module, options);
+  ASSERT_TRUE(!!jitOrError);
+  std::unique_ptr<ExecutionEngine> jit = std::move(jitOrError.get());
+  int result = 0;
+  llvm::Error error =
+      jit->invoke("foo", 42, ExecutionEngine::Result<int>(result));
+  ASSERT_TRUE(!error);
+  ASSERT_EQ(result, 42 + 42);
+  error = jit->invoke("bar", 42, ExecutionEngine::Result<int>(result));
+  ASSERT_TRUE(!error);
+  ASSERT_EQ(result, 42 * 42);
+}
+
+TEST(MLIRExecutionEngine, SKIP_WITHOUT_JIT(PersistentObjectCache)) {
+  std::string moduleStr = R"mlir(
+  func.func @foo(%arg0 : i32) -> i32 attributes { llvm.emit_c_interface } {
+    %res = arith.addi %arg0, %arg0 : i32
+    return %res : i32
+  }
+  )mlir";
+  DialectRegistry registry;
+  registerAllDialects(registry);
+  registerBuiltinDialectTranslation(registry);
+  registerLLVMDialectTranslation(registry);
+  MLIRContext context(registry);
+  OwningOpRef<ModuleOp> module =
+      parseSourceString<ModuleOp>(moduleStr, &context);
+  ASSERT_TRUE(!!module);
+  ASSERT_TRUE(succeeded(lowerToLLVMDialect(*module)));
+
+  SmallString<128> cacheDirectory;
+  ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("mlir-object-cache",
+                                                    cacheDirectory));
+  auto getCachedObjects = [&]() {
+    std::error_code ec;
+    std::vector<std::string> paths;
+    for (llvm::sys::fs::directory_iterator it(cacheDirectory, ec), end;
+         !ec && it != end; it.increment(ec))
+      paths.push_back(it->path());
+    return paths;
+  };
+
+  ExecutionEngineOptions options;
+  options.objectCacheDirectory = cacheDirectory;
+  // The second engine, like one in a new process, loads the object that the
+  // first one compiled. Compiling again would replace the cached object with a
+  // new file.
+  std::optional<llvm::sys::fs::UniqueID> objectID;
+  for (int i = 0; i < 2; ++i) {
+    auto jitOrError = ExecutionEngine::create(*module, options);
+    ASSERT_TRUE(!!jitOrError);
+    std::unique_ptr<ExecutionEngine> jit = std::move(jitOrError.get());
+    int result = 0;
+    llvm::Error error =
+        jit->invoke("foo", 42, ExecutionEngine::Result<int>(result));
+    ASSERT_TRUE(!error);
+    ASSERT_EQ(result, 42 + 42);
+
+    std::vector<std::string> objects = getCachedObjects();
+    ASSERT_EQ(objects.size(), 1u);
+    llvm::sys::fs::UniqueID id;
+    ASSERT_FALSE(llvm::sys::fs::getUniqueID(objects.front(), id));
+    if (objectID)
+      EXPECT_EQ(id, *objectID) << "the second engine compiled the module";
+    objectID = id;
+  }
+  ASSERT_FALSE(llvm::sys::fs::remove_directories(cacheDirectory));
+}
+
 TEST(NativeMemRefJit, SKIP_WITHOUT_JIT(ZeroRankMemref)) {
   OwningMemRef<float, 0> a({});
   a[{}] = 42.;
@@ -61,6 +61,129 @@ TEST(MLIRParser, ParseAtEnd) {
   EXPECT_EQ(block.back().getName().getStringRef(), "test.second");
 }
 
+TEST(MLIRParser, ParseInParallel) {
+  std::string moduleStr = R"mlir(
+module {
+  func.func @first(%arg0: i32) -> i32 {
+    func.return %arg0 : i32 loc(#loc1)
+  }
+  module @nested {
+    "func.func"() <{function_type = () -> (), sym_name = "second"}> ({
+      %0 = llvm.mlir.undef : !llvm.array<2 x f32>
+      func.return
+    }) : () -> () loc(#loc2)
+  }
+  func.func private @third()
+}
+#loc1 = loc("first.mlir":1:2)
+#loc2 = loc("second.mlir":3:4)
+  )mlir";
+
+  DialectRegistry registry;
+  registry.insert<func::FuncDialect, LLVM::LLVMDialect>();
+  MLIRContext context(registry);
+  auto print = [](Operation *op) {
+    std::string str;
+    llvm::raw_string_ostream os(str);
+    op->print(os, OpPrintingFlags().enableDebugInfo());
+    return str;
+  };
+
+  // Check that parsing in parallel produces the same IR as parsing in order.
+  ParserConfig config(&context);
+  OwningOpRef<ModuleOp> expected =
+      parseSourceString<ModuleOp>(moduleStr, config);
+  ASSERT_TRUE(expected);
+  config.setParseInParallel(true);
+  OwningOpRef<ModuleOp> module = parseSourceString<ModuleOp>(moduleStr, config);
+  ASSERT_TRUE(module);
+  EXPECT_EQ(print(*module), print(*expected));
+}
+
+TEST(MLIRParser, ParseInParallelWithoutLineBreak) {
+  std::string moduleStr = R"mlir(
+    func.func @first() {
+    } func.func @second() {
+    }
+  )mlir";
+
+  DialectRegistry registry;
+  registry.insert<func::FuncDialect>();
+  MLIRContext context(registry);
+  std::vector<std::string> diagnostics;
+  ScopedDiagnosticHandler handler(&context, [&](Diagnostic &d) {
+    llvm::raw_string_ostream(diagnostics.emplace_back()) << d;
+  });
+
+  // Check that an operation that doesn't end at a line break is diagnosed.
+  ParserConfig config(&context);
+  config.setParseInParallel(true);
+  EXPECT_FALSE(parseSourceString<ModuleOp>(moduleStr, config));
+  EXPECT_THAT(diagnostics, testing::ElementsAre("parallel parsing requires the "
+                                                "operation to end at a line "
+                                                "break"));
+}
+
+TEST(MLIRParser, ParseInParallelContinuedOnNextLine) {
+  std::string moduleStr = R"mlir(
+    func.func @first()
+        attributes {llvm.emit_c_interface} {
+      func.return
+    }
+    func.func @second() {
+      func.return
+    }
+  )mlir";
+
+  DialectRegistry registry;
+  registry.insert<func::FuncDialect>();
+  MLIRContext context(registry);
+
+  // Check that an operation continued on a line that doesn't start an
+  // operation is parsed in place.
+  ParserConfig config(&context);
+  config.setParseInParallel(true);
+  OwningOpRef<ModuleOp> module = parseSourceString<ModuleOp>(moduleStr, config);
+  ASSERT_TRUE(module);
+  auto funcs = llvm::to_vector(module->getOps<func::FuncOp>());
+  ASSERT_EQ(funcs.size(), 2u);
+  EXPECT_EQ(funcs[0].getSymName(), "first");
+  EXPECT_TRUE(funcs[0]->hasAttr("llvm.emit_c_interface"));
+  EXPECT_EQ(funcs[1].getSymName(), "second");
+}
+
+TEST(MLIRParser, ParseInParallelDiagnosticOrder) {
+  std::string moduleStr = R"mlir(
+    func.func @first() {
+      func.return %undefined : i32
+    }
+    func.func @second(%arg0: i32) {
+      func.return %arg0 : i64
+    }
+    func.func @third() {
+      func.unknown
+    }
+  )mlir";
+
+  DialectRegistry registry;
+  registry.insert<func::FuncDialect>();
+  MLIRContext context(registry);
+  std::vector<std::string> diagnostics;
+  ScopedDiagnosticHandler handler(&context, [&](Diagnostic &d) {
+    llvm::raw_string_ostream(diagnostics.emplace_back()) << d;
+  });
+
+  // Check that the diagnostics of operations parsed in parallel are reported
+  // in source order.
+  ParserConfig config(&context);
+  config.setParseInParallel(true);
+  EXPECT_FALSE(parseSourceString<ModuleOp>(moduleStr, config));
+  ASSERT_EQ(diagnostics.size(), 3u);
+  EXPECT_EQ(diagnostics[0], "use of undeclared SSA value name");
+  EXPECT_THAT(diagnostics[1], testing::HasSubstr("arg0"));
+  EXPECT_THAT(diagnostics[2], testing::HasSubstr("'func.unknown'"));
+}
+
 TEST(MLIRParser, ParseAttr) {
   using namespace testing;
   MLIRContext context;
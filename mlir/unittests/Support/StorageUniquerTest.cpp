@@ -7,7 +7,9 @@
 //===----------------------------------------------------------------------===//
 
 #include "mlir/Support/StorageUniquer.h"
+#include "llvm/Config/llvm-config.h" // for LLVM_ENABLE_THREADS
 #include "gmock/gmock.h"
+#include <thread>
 
 using namespace mlir;
 
@@ -58,3 +60,35 @@ TEST(StorageUniquerTest, NonTrivialDestructor) {
 
   EXPECT_TRUE(wasDestructed);
 }
+
+#if LLVM_ENABLE_THREADS != 0
+TEST(StorageUniquerTest, MultiThreadedUniquing) {
+  struct IntStorage : public SimpleStorage<IntStorage, int> {
+    using Base::Base;
+  };
+
+  StorageUniquer uniquer;
+  uniquer.registerParametricStorageType<IntStorage>();
+
+  // Create the same instances from several threads at once, which spreads
+  // them over all of the uniquer shards and races on each of them.
+  constexpr int numThreads = 8, numInstances = 1000;
+  std::vector<std::vector<IntStorage *>> instances(numThreads);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < numThreads; ++i) {
+    threads.emplace_back([&, i] {
+      for (int j = 0; j < numInstances; ++j)
+        instances[i].push_back(IntStorage::get(uniquer, j));
+    });
+  }
+  for (std::thread &thread : threads)
+    thread.join();
+
+  for (int j = 0; j < numInstances; ++j) {
+    IntStorage *instance = IntStorage::get(uniquer, j);
+    EXPECT_EQ(std::get<0>(instance->key), j);
+    for (int i = 0; i < numThreads; ++i)
+      EXPECT_EQ(instances[i][j], instance);
+  }
+}
+#endif
@@ -51,7 +51,27 @@ struct BumpAllocatorTy final {
     uint64_t End =
         reinterpret_cast<uint64_t>(Data) + __omp_rtl_device_memory_pool.Size;
 
-    uint64_t OldData = atomic::add(Data, Size, atomic::seq_cst);
+    // The lanes of a warp that allocate together share a single bump of the
+    // pool pointer made by the lowest of them, so that they do not serialize
+    // on the same atomic. Each lane gets its chunk at the sum of the sizes of
+    // the lanes below it. The chunks share no data and the bump publishes
+    // nothing, hence the relaxed ordering.
+    uint64_t Offset = 0, Total = 0;
+    LaneMaskTy Active = mapping::activemask();
+    uint32_t Leader = utils::ffs(Active) - 1;
+    uint32_t LaneId = mapping::getThreadIdInWarp();
+    for (LaneMaskTy Lanes = Active; Lanes; Lanes &= Lanes - 1) {
+      uint32_t Lane = utils::ffs(Lanes) - 1;
+      uint64_t LaneSize = shuffle(Active, Size, Lane);
+      if (Lane < LaneId)
+        Offset += LaneSize;
+      Total += LaneSize;
+    }
+
+    uint64_t OldData = 0;
+    if (LaneId == Leader)
+      OldData = atomic::add(Data, Total, atomic::relaxed);
+    OldData = shuffle(Active, OldData, Leader) + Offset;
     if (OldData + Size > End)
       __builtin_trap();
 
@@ -59,6 +79,16 @@ struct BumpAllocatorTy final {
   }
 
   void free(void *) {}
+
+private:
+  /// Return the 64 bit \p Var of thread \p SrcLane in the warp.
+  static uint64_t shuffle(LaneMaskTy Mask, uint64_t Var, uint32_t SrcLane) {
+    uint32_t Lo, Hi;
+    utils::unpack(Var, Lo, Hi);
+    Lo = utils::shuffle(Mask, Lo, SrcLane, mapping::getWarpSize());
+    Hi = utils::shuffle(Mask, Hi, SrcLane, mapping::getWarpSize());
+    return utils::pack(Lo, Hi);
+  }
 };
 
 BumpAllocatorTy BumpAllocator;
@@ -36,6 +36,7 @@
 #include "UtilitiesRTL.h"
 #include "omptarget.h"
 
+#include "llvm/ADT/ScopeExit.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
@@ -1875,6 +1876,7 @@ struct AMDGPUDeviceTy : public GenericDeviceTy, AMDGenericDeviceTy {
         OMPX_DefaultTeamsPerCU("LIBOMPTARGET_AMDGPU_TEAMS_PER_CU", 4),
         OMPX_MaxAsyncCopyBytes("LIBOMPTARGET_AMDGPU_MAX_ASYNC_COPY_BYTES",
                                1 * 1024 * 1024), // 1MB
+        OMPX_StagingChunkBytes("LIBOMPTARGET_AMDGPU_STAGING_CHUNK_BYTES", 0),
         OMPX_InitialNumSignals("LIBOMPTARGET_AMDGPU_NUM_INITIAL_HSA_SIGNALS",
                                64),
         OMPX_StreamBusyWait("LIBOMPTARGET_AMDGPU_STREAM_BUSYWAIT", 2000000),
@@ -2296,6 +2298,110 @@ struct AMDGPUDeviceTy : public GenericDeviceTy, AMDGenericDeviceTy {
     return true;
   }
 
+  /// Copy \p Size bytes between the unpinned host buffer and the device buffer
+  /// synchronously, through two staging buffers from the pinned memory pool.
+  /// The transfer is split into chunks of OMPX_StagingChunkBytes, and the host
+  /// copy of each chunk overlaps the device transfer of the next or previous
+  /// one. Either \p Dst or \p Src is the host buffer, depending on \p ToDevice.
+  Error stagedMemoryCopy(void *Dst, const void *Src, uint64_t Size,
+                         bool ToDevice) {
+    AMDGPUMemoryManagerTy &PinnedMemoryManager =
+        HostDevice.getPinnedMemoryManager();
+    const uint64_t ChunkSize = OMPX_StagingChunkBytes;
+    const uint64_t NumChunks = (Size + ChunkSize - 1) / ChunkSize;
+
+    // Signals start completed so that unused buffers need no special case.
+    void *Buffers[2] = {nullptr, nullptr};
+    AMDGPUSignalTy Signals[2];
+    bool SignalsCreated[2] = {false, false};
+
+    // Wait for the outstanding transfers before releasing the signals and the
+    // staging buffers that have been created so far.
+    auto releaseStaging = [&]() -> Error {
+      Error Err = Plugin::success();
+      for (int I = 0; I < 2; ++I) {
+        if (SignalsCreated[I]) {
+          Err = joinErrors(std::move(Err),
+                           Signals[I].wait(getStreamBusyWaitMicroseconds()));
+          Err = joinErrors(std::move(Err), Signals[I].deinit());
+        }
+        if (Buffers[I])
+          Err = joinErrors(std::move(Err),
+                           PinnedMemoryManager.deallocate(Buffers[I]));
+      }
+      return Err;
+    };
+    // On early returns the error that stopped the copy is the one reported.
+    auto ReleaseOnError =
+        llvm::make_scope_exit([&]() { consumeError(releaseStaging()); });
+
+    for (int I = 0; I < 2; ++I) {
+      if (auto Err = PinnedMemoryManager.allocate(ChunkSize, &Buffers[I]))
+        return Err;
+      if (auto Err = Signals[I].init(/*InitialValue=*/0))
+        return Err;
+      SignalsCreated[I] = true;
+    }
+
+    auto getChunkSize = [&](uint64_t Chunk) {
+      return std::min(ChunkSize, Size - Chunk * ChunkSize);
+    };
+
+    // Start the device transfer of a chunk through its staging buffer.
+    auto startChunk = [&](uint64_t Chunk) -> Error {
+      AMDGPUSignalTy &Signal = Signals[Chunk % 2];
+      void *Buffer = Buffers[Chunk % 2];
+      uint64_t Offset = Chunk * ChunkSize;
+      Signal.reset();
+      Error Err =
+          ToDevice
+              ? hsa_utils::asyncMemCopy(useMultipleSdmaEngines(),
+                                        utils::advancePtr(Dst, Offset), Agent,
+                                        Buffer, Agent, getChunkSize(Chunk), 0,
+                                        nullptr, Signal.get())
+              : hsa_utils::asyncMemCopy(useMultipleSdmaEngines(), Buffer,
+                                        Agent, utils::advancePtr(Src, Offset),
+                                        Agent, getChunkSize(Chunk), 0, nullptr,
+                                        Signal.get());
+      // A transfer that failed to start never completes the signal.
+      if (Err)
+        Signal.signal();
+      return Err;
+    };
+
+    if (ToDevice) {
+      // Fill one buffer while the device reads from the other one.
+      for (uint64_t Chunk = 0; Chunk < NumChunks; ++Chunk) {
+        if (auto Err =
+                Signals[Chunk % 2].wait(getStreamBusyWaitMicroseconds()))
+          return Err;
+        std::memcpy(Buffers[Chunk % 2],
+                    utils::advancePtr(Src, Chunk * ChunkSize),
+                    getChunkSize(Chunk));
+        if (auto Err = startChunk(Chunk))
+          return Err;
+      }
+    } else {
+      // Drain one buffer while the device writes to the other one.
+      if (NumChunks)
+        if (auto Err = startChunk(0))
+          return Err;
+      for (uint64_t Chunk = 0; Chunk < NumChunks; ++Chunk) {
+        if (Chunk + 1 < NumChunks)
+          if (auto Err = startChunk(Chunk + 1))
+            return Err;
+        if (auto Err =
+                Signals[Chunk % 2].wait(getStreamBusyWaitMicroseconds()))
+          return Err;
+        std::memcpy(utils::advancePtr(Dst, Chunk * ChunkSize),
+                    Buffers[Chunk % 2], getChunkSize(Chunk));
+      }
+    }
+
+    ReleaseOnError.release();
+    return releaseStaging();
+  }
+
   /// Submit data to the device (host to device transfer).
   Error dataSubmitImpl(void *TgtPtr, const void *HstPtr, int64_t Size,
                        AsyncInfoWrapperTy &AsyncInfoWrapper) override {
@@ -2316,6 +2422,9 @@ struct AMDGPUDeviceTy : public GenericDeviceTy, AMDGenericDeviceTy {
         if (auto Err = synchronize(AsyncInfoWrapper))
           return Err;
 
+      if (OMPX_StagingChunkBytes > 0)
+        return stagedMemoryCopy(TgtPtr, HstPtr, Size, /*ToDevice=*/true);
+
       hsa_status_t Status;
       Status = hsa_amd_memory_lock(const_cast<void *>(HstPtr), Size, nullptr, 0,
                                    &PinnedPtr);
@@ -2376,6 +2485,9 @@ struct AMDGPUDeviceTy : public GenericDeviceTy, AMDGenericDeviceTy {
         if (auto Err = synchronize(AsyncInfoWrapper))
           return Err;
 
+      if (OMPX_StagingChunkBytes > 0)
+        return stagedMemoryCopy(HstPtr, TgtPtr, Size, /*ToDevice=*/false);
+
       hsa_status_t Status;
       Status = hsa_amd_memory_lock(const_cast<void *>(HstPtr), Size, nullptr, 0,
                                    &PinnedPtr);
@@ -2876,6 +2988,11 @@ private:
   /// transfers, they are synchronous transfers.
   UInt32Envar OMPX_MaxAsyncCopyBytes;
 
+  /// Envar specifying the size in bytes of the chunks in which the synchronous
+  /// transfers of unpinned host buffers are staged through pinned memory. If
+  /// zero, these transfers lock the whole host buffer instead.
+  UInt32Envar OMPX_StagingChunkBytes;
+
   /// Envar controlling the initial number of HSA signals per device. There is
   /// one manager of signals per device managing several pre-allocated signals.
   /// These signals are mainly used by AMDGPU streams. If needed, more signals
@@ -11,6 +11,7 @@
 #ifndef OPENMP_LIBOMPTARGET_PLUGINS_NEXTGEN_COMMON_PLUGININTERFACE_H
 #define OPENMP_LIBOMPTARGET_PLUGINS_NEXTGEN_COMMON_PLUGININTERFACE_H
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <deque>
@@ -816,6 +817,14 @@ struct GenericDeviceTy : public DeviceAllocatorTy {
   virtual Error dataRetrieveImpl(void *HstPtr, const void *TgtPtr, int64_t Size,
                                  AsyncInfoWrapperTy &AsyncInfoWrapper) = 0;
 
+  /// Return the number of bytes submitted to and retrieved from the device
+  /// since the last call, and reset both counts. Transfers are only counted
+  /// while OMP_INFOTYPE_DATA_TRANSFER information is enabled.
+  std::pair<uint64_t, uint64_t> takeTransferredBytes() {
+    return {BytesSubmitted.exchange(0, std::memory_order_relaxed),
+            BytesRetrieved.exchange(0, std::memory_order_relaxed)};
+  }
+
   /// Exchange data between devices (device to device transfer). Calling this
   /// function is only valid if GenericPlugin::isDataExchangable() passing the
   /// two devices returns true.
@@ -1065,6 +1074,11 @@ protected:
   /// Map of host pinned allocations used for optimize device transfers.
   PinnedAllocationMapTy PinnedAllocs;
 
+  /// Number of bytes submitted to and retrieved from the device since the
+  /// last call to takeTransferredBytes().
+  std::atomic<uint64_t> BytesSubmitted = 0;
+  std::atomic<uint64_t> BytesRetrieved = 0;
+
   /// A pointer to an RPC server instance attached to this device if present.
   /// This is used to run the RPC server during task synchronization.
   RPCServerTy *RPCServer;
@@ -532,6 +532,13 @@ Error GenericKernelTy::printLaunchInfo(GenericDeviceTy &GenericDevice,
        "Launching kernel %s with %" PRIu64
        " blocks and %d threads in %s mode\n",
        getName(), NumBlocks, NumThreads, getExecutionModeName());
+  if (getInfoLevel() & OMP_INFOTYPE_DATA_TRANSFER) {
+    auto [Submitted, Retrieved] = GenericDevice.takeTransferredBytes();
+    INFO(OMP_INFOTYPE_DATA_TRANSFER, GenericDevice.getDeviceId(),
+         "Copied %" PRIu64 " bytes to and %" PRIu64
+         " bytes from the device since the previous kernel launch\n",
+         Submitted, Retrieved);
+  }
   return printLaunchInfoDetails(GenericDevice, KernelArgs, NumThreads,
                                 NumBlocks);
 }
@@ -1457,6 +1464,9 @@ Error GenericDeviceTy::dataSubmit(void *TgtPtr, const void *HstPtr,
                                   int64_t Size, __tgt_async_info *AsyncInfo) {
   AsyncInfoWrapperTy AsyncInfoWrapper(*this, AsyncInfo);
 
+  if (getInfoLevel() & OMP_INFOTYPE_DATA_TRANSFER)
+    BytesSubmitted.fetch_add(Size, std::memory_order_relaxed);
+
   auto Err = dataSubmitImpl(TgtPtr, HstPtr, Size, AsyncInfoWrapper);
   AsyncInfoWrapper.finalize(Err);
   return Err;
@@ -1466,6 +1476,9 @@ Error GenericDeviceTy::dataRetrieve(void *HstPtr, const void *TgtPtr,
                                     int64_t Size, __tgt_async_info *AsyncInfo) {
   AsyncInfoWrapperTy AsyncInfoWrapper(*this, AsyncInfo);
 
+  if (getInfoLevel() & OMP_INFOTYPE_DATA_TRANSFER)
+    BytesRetrieved.fetch_add(Size, std::memory_order_relaxed);
+
   auto Err = dataRetrieveImpl(HstPtr, TgtPtr, Size, AsyncInfoWrapper);
   AsyncInfoWrapper.finalize(Err);
   return Err;
@@ -0,0 +1,45 @@
+// RUN: %libomptarget-compile-run-and-check-generic
+// RUN: %libomptarget-compileopt-run-and-check-generic
+
+#include <omp.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Threads of the same warp allocate different sizes at once, and some of them
+// do not allocate at all. Every allocation must be disjoint from the others.
+
+int main() {
+  long unsigned **DP = 0;
+  int Threads = 64;
+  int Teams = 10;
+
+#pragma omp target map(from : DP)
+  DP = (long unsigned **)malloc(sizeof(long unsigned *) * Threads * Teams);
+
+#pragma omp target teams distribute parallel for num_teams(Teams)              \
+    thread_limit(Threads)
+  for (int i = 0; i < Threads * Teams; ++i) {
+    DP[i] = 0;
+    if (i % 3 != 0)
+      DP[i] = (long unsigned *)malloc(sizeof(long unsigned) * (i % 17 + 1));
+  }
+
+#pragma omp target teams distribute parallel for num_teams(Teams)              \
+    thread_limit(Threads)
+  for (int i = 0; i < Threads * Teams; ++i)
+    if (DP[i])
+      for (int j = 0; j < i % 17 + 1; ++j)
+        DP[i][j] = i;
+
+  long unsigned Errors = 0;
+#pragma omp target teams distribute parallel for num_teams(Teams)              \
+    thread_limit(Threads) reduction(+ : Errors)
+  for (int i = 0; i < Threads * Teams; ++i)
+    if (DP[i])
+      for (int j = 0; j < i % 17 + 1; ++j)
+        Errors += DP[i][j] != i;
+
+  // CHECK: Errors: 0
+  printf("Errors: %lu\n", Errors);
+  return 0;
+}
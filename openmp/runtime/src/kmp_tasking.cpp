@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "kmp.h"
+#include "kmp_affinity.h"
 #include "kmp_i18n.h"
 #include "kmp_itt.h"
 #include "kmp_stats.h"
@@ -3225,6 +3226,50 @@ static kmp_task_t *__kmp_remove_my_task(kmp_info_t *thread, kmp_int32 gtid,
   return task;
 }
 
+// __kmp_same_task_domain: returns true if threads a and b are bound to the
+// same socket and NUMA domain, so that stealing between them does not touch
+// remote memory. Threads whose socket is unknown are not close to any thread.
+static inline bool __kmp_same_task_domain(kmp_info_t *a, kmp_info_t *b) {
+#if KMP_AFFINITY_SUPPORTED
+  const int *a_ids = a->th.th_topology_ids.ids;
+  const int *b_ids = b->th.th_topology_ids.ids;
+  return a_ids[KMP_HW_SOCKET] >= 0 &&
+         a_ids[KMP_HW_SOCKET] == b_ids[KMP_HW_SOCKET] &&
+         a_ids[KMP_HW_NUMA] != kmp_hw_thread_t::MULTIPLE_ID &&
+         a_ids[KMP_HW_NUMA] == b_ids[KMP_HW_NUMA];
+#else
+  return false;
+#endif
+}
+
+// __kmp_choose_victim: pick a random thread other than tid to steal from.
+// Up to __kmp_task_steal_local_tries random picks look for a thread in the
+// same domain as thread that has queued tasks before falling back to any
+// thread of the team.
+static kmp_int32 __kmp_choose_victim(kmp_info_t *thread,
+                                     kmp_thread_data_t *threads_data,
+                                     kmp_int32 nthreads, kmp_int32 tid) {
+  kmp_int32 victim_tid;
+#if KMP_AFFINITY_SUPPORTED
+  if (thread->th.th_topology_ids.ids[KMP_HW_SOCKET] >= 0) {
+    for (int i = 0; i < __kmp_task_steal_local_tries; ++i) {
+      victim_tid = __kmp_get_random(thread) % (nthreads - 1);
+      if (victim_tid >= tid)
+        ++victim_tid;
+      kmp_thread_data_t *victim_td = &threads_data[victim_tid];
+      if (TCR_4(victim_td->td.td_deque_ntasks) != 0 &&
+          __kmp_same_task_domain(thread, victim_td->td.td_thr))
+        return victim_tid;
+    }
+  }
+#endif
+  victim_tid = __kmp_get_random(thread) % (nthreads - 1);
+  if (victim_tid >= tid) {
+    ++victim_tid; // Adjusts random distribution to exclude self
+  }
+  return victim_tid;
+}
+
 // __kmp_steal_task: remove a task from another thread's deque
 // Assume that calling thread has already checked existence of
 // task_team thread_data before calling this routine.
@@ -3349,6 +3394,10 @@ static kmp_task_t *__kmp_steal_task(kmp_int32 victim_tid, kmp_int32 gtid,
   __kmp_release_bootstrap_lock(&victim_td->td.td_deque_lock);
 
   KMP_COUNT_BLOCK(TASK_stolen);
+#if KMP_STATS_ENABLED
+  if (__kmp_same_task_domain(__kmp_threads[gtid], victim_thr))
+    KMP_COUNT_BLOCK(TASK_stolen_local);
+#endif
   KA_TRACE(10,
            ("__kmp_steal_task(exit #5): T#%d stole task %p from T#%d: "
             "task_team=%p ntasks=%d head=%u tail=%u\n",
@@ -3429,10 +3478,8 @@ static inline int __kmp_execute_tasks_template(
             // Pick a random thread. Initial plan was to cycle through all the
             // threads, and only return if we tried to steal from every thread,
             // and failed.  Arch says that's not such a great idea.
-            victim_tid = __kmp_get_random(thread) % (nthreads - 1);
-            if (victim_tid >= tid) {
-              ++victim_tid; // Adjusts random distribution to exclude self
-            }
+            victim_tid =
+                __kmp_choose_victim(thread, threads_data, nthreads, tid);
             // Found a potential victim
             other_thread = threads_data[victim_tid].td.td_thr;
             // There is a slight chance that __kmp_enable_tasking() did not wake
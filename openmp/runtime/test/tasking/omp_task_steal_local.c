@@ -0,0 +1,52 @@
+// RUN: %libomp-compile && env KMP_TASK_STEAL_LOCAL=0 %libomp-run
+// RUN: %libomp-compile && env KMP_TASK_STEAL_LOCAL=16 %libomp-run
+// RUN: %libomp-compile && env KMP_TASK_STEAL_LOCAL=16 KMP_AFFINITY=compact \
+// RUN:   %libomp-run
+
+#include <omp.h>
+#include <stdio.h>
+
+/**
+ * Test that every task runs exactly once whether or not thieves prefer
+ * victims in their own socket and NUMA domain. Tasks are created by a single
+ * thread and by the tasks themselves, so that the other threads have to steal
+ * from several deques.
+ */
+
+#define NUM_TASKS 1000
+#define NUM_CHILDREN 4
+
+static int counts[NUM_TASKS * (NUM_CHILDREN + 1)];
+
+int main() {
+  int i, errors = 0;
+
+#pragma omp parallel
+#pragma omp single
+  for (i = 0; i < NUM_TASKS; ++i) {
+#pragma omp task firstprivate(i)
+    {
+      int j;
+#pragma omp atomic
+      counts[i]++;
+      for (j = 0; j < NUM_CHILDREN; ++j) {
+#pragma omp task firstprivate(i, j)
+        {
+#pragma omp atomic
+          counts[NUM_TASKS + i * NUM_CHILDREN + j]++;
+        }
+      }
+    }
+  }
+
+  for (i = 0; i < NUM_TASKS * (NUM_CHILDREN + 1); ++i) {
+    if (counts[i] != 1) {
+      fprintf(stderr, "task %d ran %d times\n", i, counts[i]);
+      ++errors;
+    }
+  }
+  if (errors)
+    return 1;
+  printf("passed\n");
+  return 0;
+}
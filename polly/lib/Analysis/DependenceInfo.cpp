@@ -26,7 +26,9 @@
 #include "polly/Support/GICHelper.h"
 #include "polly/Support/ISLTools.h"
 #include "llvm/ADT/Sequence.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/TimeProfiler.h"
 #include "isl/aff.h"
 #include "isl/ctx.h"
 #include "isl/flow.h"
@@ -42,6 +44,11 @@ using namespace llvm;
 #include "polly/Support/PollyDebug.h"
 #define DEBUG_TYPE "polly-dependence"
 
+STATISTIC(DependencesComputedOut,
+          "Number of dependence analyses that exceeded the computeout");
+STATISTIC(MemoryBasedFallbacks, "Number of dependence analyses that fell back "
+                                "to memory-based dependences");
+
 static cl::opt<int> OptComputeOut(
     "polly-dependences-computeout",
     cl::desc("Bound the dependence analysis by a maximal amount of "
@@ -69,6 +76,12 @@ static cl::opt<enum AnalysisType> OptAnalysisType(
                           "Overapproximation of dependences")),
     cl::Hidden, cl::init(VALUE_BASED_ANALYSIS), cl::cat(PollyCategory));
 
+static cl::opt<bool> OptMemoryBasedFallback(
+    "polly-dependences-memory-based-fallback",
+    cl::desc("If the value-based analysis exceeds the computeout, compute the "
+             "cheaper memory-based dependences instead of none"),
+    cl::Hidden, cl::init(false), cl::cat(PollyCategory));
+
 static cl::opt<Dependences::AnalysisLevel> OptAnalysisLevel(
     "polly-dependences-analysis-level",
     cl::desc("The level of dependence analysis"),
@@ -308,12 +321,122 @@ static __isl_give isl_union_flow *buildFlow(__isl_keep isl_union_map *Snk,
   return Flow;
 }
 
+/// Compute the dependences of kind @p Type between the accesses @p Read,
+/// @p MustWrite and @p MayWrite under @p Schedule. On return, @p StrictWAW
+/// holds the write-after-write dependences that do not flow through a read.
+static void computeFlowDependences(
+    AnalysisType Type, __isl_keep isl_union_map *Read,
+    __isl_keep isl_union_map *MustWrite, __isl_keep isl_union_map *MayWrite,
+    __isl_keep isl_schedule *Schedule, isl_union_map *&RAW,
+    isl_union_map *&WAW, isl_union_map *&WAR, isl_union_map *&StrictWAW) {
+  isl_union_map *Write = isl_union_map_union(isl_union_map_copy(MustWrite),
+                                             isl_union_map_copy(MayWrite));
+
+  // We are interested in detecting reductions that do not have intermediate
+  // computations that are captured by other statements.
+  //
+  // Example:
+  // void f(int *A, int *B) {
+  //     for(int i = 0; i <= 100; i++) {
+  //
+  //            *-WAR (S0[i] -> S0[i + 1] 0 <= i <= 100)------------*
+  //            |                                                   |
+  //            *-WAW (S0[i] -> S0[i + 1] 0 <= i <= 100)------------*
+  //            |                                                   |
+  //            v                                                   |
+  //     S0:    *A += i; >------------------*-----------------------*
+  //                                        |
+  //         if (i >= 98) {          WAR (S0[i] -> S1[i]) 98 <= i <= 100
+  //                                        |
+  //     S1:        *B = *A; <--------------*
+  //         }
+  //     }
+  // }
+  //
+  // S0[0 <= i <= 100] has a reduction. However, the values in
+  // S0[98 <= i <= 100] is captured in S1[98 <= i <= 100].
+  // Since we allow free reordering on our reduction dependences, we need to
+  // remove all instances of a reduction statement that have data dependences
+  // originating from them.
+  // In the case of the example, we need to remove S0[98 <= i <= 100] from
+  // our reduction dependences.
+  //
+  // When we build up the WAW dependences that are used to detect reductions,
+  // we consider only **Writes that have no intermediate Reads**.
+  //
+  // `isl_union_flow_get_must_dependence` gives us dependences of the form:
+  // (sink <- must_source).
+  //
+  // It *will not give* dependences of the form:
+  // 1. (sink <- ... <- may_source <- ... <- must_source)
+  // 2. (sink <- ... <- must_source <- ... <- must_source)
+  //
+  // For a detailed reference on ISL's flow analysis, see:
+  // "Presburger Formulas and Polyhedral Compilation" - Approximate Dataflow
+  //  Analysis.
+  //
+  // Since we set "Write" as a must-source, "Read" as a may-source, and ask
+  // for must dependences, we get all Writes to Writes that **do not flow
+  // through a Read**.
+  //
+  // ScopInfo::checkForReductions makes sure that if something captures
+  // the reduction variable in the same basic block, then it is rejected
+  // before it is even handed here. This makes sure that there is exactly
+  // one read and one write to a reduction variable in a Statement.
+  // Example:
+  //     void f(int *sum, int A[N], int B[N]) {
+  //       for (int i = 0; i < N; i++) {
+  //         *sum += A[i]; < the store and the load is not tagged as a
+  //         B[i] = *sum;  < reduction-like access due to the overlap.
+  //       }
+  //     }
+
+  isl_union_flow *Flow = buildFlow(Write, Write, Read, nullptr, Schedule);
+  StrictWAW = isl_union_flow_get_must_dependence(Flow);
+  isl_union_flow_free(Flow);
+
+  if (Type == VALUE_BASED_ANALYSIS) {
+    Flow = buildFlow(Read, MustWrite, MayWrite, nullptr, Schedule);
+    RAW = isl_union_flow_get_may_dependence(Flow);
+    isl_union_flow_free(Flow);
+
+    Flow = buildFlow(Write, MustWrite, MayWrite, nullptr, Schedule);
+    WAW = isl_union_flow_get_may_dependence(Flow);
+    isl_union_flow_free(Flow);
+
+    // ISL now supports "kills" in approximate dataflow analysis, we can
+    // specify the MustWrite as kills, Read as source and Write as sink.
+    Flow = buildFlow(Write, nullptr, Read, MustWrite, Schedule);
+    WAR = isl_union_flow_get_may_dependence(Flow);
+    isl_union_flow_free(Flow);
+  } else {
+    Flow = buildFlow(Read, nullptr, Write, nullptr, Schedule);
+    RAW = isl_union_flow_get_may_dependence(Flow);
+    isl_union_flow_free(Flow);
+
+    Flow = buildFlow(Write, nullptr, Read, nullptr, Schedule);
+    WAR = isl_union_flow_get_may_dependence(Flow);
+    isl_union_flow_free(Flow);
+
+    Flow = buildFlow(Write, nullptr, Write, nullptr, Schedule);
+    WAW = isl_union_flow_get_may_dependence(Flow);
+    isl_union_flow_free(Flow);
+  }
+
+  isl_union_map_free(Write);
+
+  RAW = isl_union_map_coalesce(RAW);
+  WAW = isl_union_map_coalesce(WAW);
+  WAR = isl_union_map_coalesce(WAR);
+}
+
 void Dependences::calculateDependences(Scop &S) {
   isl_union_map *Read, *MustWrite, *MayWrite, *ReductionTagMap;
   isl_schedule *Schedule;
   isl_union_set *TaggedStmtDomain;
 
   POLLY_DEBUG(dbgs() << "Scop: \n" << S << "\n");
+  TimeTraceScope TimeScope("PollyDependences", S.getNameStr());
 
   collectInfo(S, Read, MustWrite, MayWrite, ReductionTagMap, TaggedStmtDomain,
               Level);
@@ -367,126 +490,51 @@ void Dependences::calculateDependences(Scop &S) {
               dbgs() << "Schedule: " << Schedule << "\n");
 
   isl_union_map *StrictWAW = nullptr;
+  RAW = WAW = WAR = RED = nullptr;
   {
     IslMaxOperationsGuard MaxOpGuard(IslCtx.get(), OptComputeOut);
-
-    RAW = WAW = WAR = RED = nullptr;
-    isl_union_map *Write = isl_union_map_union(isl_union_map_copy(MustWrite),
-                                               isl_union_map_copy(MayWrite));
-
-    // We are interested in detecting reductions that do not have intermediate
-    // computations that are captured by other statements.
-    //
-    // Example:
-    // void f(int *A, int *B) {
-    //     for(int i = 0; i <= 100; i++) {
-    //
-    //            *-WAR (S0[i] -> S0[i + 1] 0 <= i <= 100)------------*
-    //            |                                                   |
-    //            *-WAW (S0[i] -> S0[i + 1] 0 <= i <= 100)------------*
-    //            |                                                   |
-    //            v                                                   |
-    //     S0:    *A += i; >------------------*-----------------------*
-    //                                        |
-    //         if (i >= 98) {          WAR (S0[i] -> S1[i]) 98 <= i <= 100
-    //                                        |
-    //     S1:        *B = *A; <--------------*
-    //         }
-    //     }
-    // }
-    //
-    // S0[0 <= i <= 100] has a reduction. However, the values in
-    // S0[98 <= i <= 100] is captured in S1[98 <= i <= 100].
-    // Since we allow free reordering on our reduction dependences, we need to
-    // remove all instances of a reduction statement that have data dependences
-    // originating from them.
-    // In the case of the example, we need to remove S0[98 <= i <= 100] from
-    // our reduction dependences.
-    //
-    // When we build up the WAW dependences that are used to detect reductions,
-    // we consider only **Writes that have no intermediate Reads**.
-    //
-    // `isl_union_flow_get_must_dependence` gives us dependences of the form:
-    // (sink <- must_source).
-    //
-    // It *will not give* dependences of the form:
-    // 1. (sink <- ... <- may_source <- ... <- must_source)
-    // 2. (sink <- ... <- must_source <- ... <- must_source)
-    //
-    // For a detailed reference on ISL's flow analysis, see:
-    // "Presburger Formulas and Polyhedral Compilation" - Approximate Dataflow
-    //  Analysis.
-    //
-    // Since we set "Write" as a must-source, "Read" as a may-source, and ask
-    // for must dependences, we get all Writes to Writes that **do not flow
-    // through a Read**.
-    //
-    // ScopInfo::checkForReductions makes sure that if something captures
-    // the reduction variable in the same basic block, then it is rejected
-    // before it is even handed here. This makes sure that there is exactly
-    // one read and one write to a reduction variable in a Statement.
-    // Example:
-    //     void f(int *sum, int A[N], int B[N]) {
-    //       for (int i = 0; i < N; i++) {
-    //         *sum += A[i]; < the store and the load is not tagged as a
-    //         B[i] = *sum;  < reduction-like access due to the overlap.
-    //       }
-    //     }
-
-    isl_union_flow *Flow = buildFlow(Write, Write, Read, nullptr, Schedule);
-    StrictWAW = isl_union_flow_get_must_dependence(Flow);
-    isl_union_flow_free(Flow);
-
-    if (OptAnalysisType == VALUE_BASED_ANALYSIS) {
-      Flow = buildFlow(Read, MustWrite, MayWrite, nullptr, Schedule);
-      RAW = isl_union_flow_get_may_dependence(Flow);
-      isl_union_flow_free(Flow);
-
-      Flow = buildFlow(Write, MustWrite, MayWrite, nullptr, Schedule);
-      WAW = isl_union_flow_get_may_dependence(Flow);
-      isl_union_flow_free(Flow);
-
-      // ISL now supports "kills" in approximate dataflow analysis, we can
-      // specify the MustWrite as kills, Read as source and Write as sink.
-      Flow = buildFlow(Write, nullptr, Read, MustWrite, Schedule);
-      WAR = isl_union_flow_get_may_dependence(Flow);
-      isl_union_flow_free(Flow);
-    } else {
-      Flow = buildFlow(Read, nullptr, Write, nullptr, Schedule);
-      RAW = isl_union_flow_get_may_dependence(Flow);
-      isl_union_flow_free(Flow);
-
-      Flow = buildFlow(Write, nullptr, Read, nullptr, Schedule);
-      WAR = isl_union_flow_get_may_dependence(Flow);
-      isl_union_flow_free(Flow);
-
-      Flow = buildFlow(Write, nullptr, Write, nullptr, Schedule);
-      WAW = isl_union_flow_get_may_dependence(Flow);
-      isl_union_flow_free(Flow);
-    }
-
-    isl_union_map_free(Write);
-    isl_union_map_free(MustWrite);
-    isl_union_map_free(MayWrite);
-    isl_union_map_free(Read);
-    isl_schedule_free(Schedule);
-
-    RAW = isl_union_map_coalesce(RAW);
-    WAW = isl_union_map_coalesce(WAW);
-    WAR = isl_union_map_coalesce(WAR);
-
+    computeFlowDependences(OptAnalysisType, Read, MustWrite, MayWrite, Schedule,
+                           RAW, WAW, WAR, StrictWAW);
     // End of max_operations scope.
   }
 
   if (isl_ctx_last_error(IslCtx.get()) == isl_error_quota) {
+    DependencesComputedOut++;
     isl_union_map_free(RAW);
     isl_union_map_free(WAW);
     isl_union_map_free(WAR);
     isl_union_map_free(StrictWAW);
     RAW = WAW = WAR = StrictWAW = nullptr;
     isl_ctx_reset_error(IslCtx.get());
+
+    // Memory-based dependences over-approximate the value-based ones, so they
+    // are still safe to transform the SCoP with, and do not need to compute
+    // which write was the last one.
+    if (OptMemoryBasedFallback && OptAnalysisType == VALUE_BASED_ANALYSIS) {
+      POLLY_DEBUG(dbgs() << "Falling back to memory-based dependences\n");
+      {
+        IslMaxOperationsGuard MaxOpGuard(IslCtx.get(), OptComputeOut);
+        computeFlowDependences(MEMORY_BASED_ANALYSIS, Read, MustWrite,
+                               MayWrite, Schedule, RAW, WAW, WAR, StrictWAW);
+      }
+      if (isl_ctx_last_error(IslCtx.get()) == isl_error_quota) {
+        isl_union_map_free(RAW);
+        isl_union_map_free(WAW);
+        isl_union_map_free(WAR);
+        isl_union_map_free(StrictWAW);
+        RAW = WAW = WAR = StrictWAW = nullptr;
+        isl_ctx_reset_error(IslCtx.get());
+      } else {
+        MemoryBasedFallbacks++;
+      }
+    }
   }
 
+  isl_union_map_free(MustWrite);
+  isl_union_map_free(MayWrite);
+  isl_union_map_free(Read);
+  isl_schedule_free(Schedule);
+
   // Drop out early, as the remaining computations are only needed for
   // reduction dependences or dependences that are finer than statement
   // level dependences.
@@ -59,6 +59,7 @@
 #include "llvm/Analysis/OptimizationRemarkEmitter.h"
 #include "llvm/InitializePasses.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/TimeProfiler.h"
 #include "isl/options.h"
 
 using namespace llvm;
@@ -201,6 +202,8 @@ static cl::opt<bool> OptimizedScops(
 STATISTIC(ScopsProcessed, "Number of scops processed");
 STATISTIC(ScopsRescheduled, "Number of scops rescheduled");
 STATISTIC(ScopsOptimized, "Number of scops optimized");
+STATISTIC(ScopsComputedOut,
+          "Number of scops whose rescheduling exceeded the computeout");
 
 STATISTIC(NumAffineLoopsOptimized, "Number of affine loops optimized");
 STATISTIC(NumBoxedLoopsOptimized, "Number of boxed loops optimized");
@@ -870,12 +873,15 @@ static void runIslScheduleOptimizer(
     SC = SC.set_coincidence(Validity);
 
     {
+      TimeTraceScope TimeScope("PollyComputeSchedule", S.getNameStr());
       IslMaxOperationsGuard MaxOpGuard(Ctx, ScheduleComputeOut);
       Schedule = SC.compute_schedule();
 
-      if (MaxOpGuard.hasQuotaExceeded())
+      if (MaxOpGuard.hasQuotaExceeded()) {
+        ScopsComputedOut++;
         POLLY_DEBUG(
             dbgs() << "Schedule optimizer calculation exceeds ISL quota\n");
+      }
     }
 
     isl_options_set_on_error(Ctx, OnErrorStatus);